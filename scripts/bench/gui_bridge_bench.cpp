@@ -0,0 +1,365 @@
+// MoonLang Runtime - Headless GUI Bridge Benchmark
+// Copyright (c) 2026 greenteng.com
+//
+// Drives the WebView message bridge (moonrt_gui_bridge.h) without a window
+// system. A stub page encodes messages the way MoonGUI.queue()/sendBinary()
+// do and hands the posted strings to BridgeDispatch(); a stub webview takes
+// the scripts the outbox flushes, parses the onMoonMessage/onMoonBinary calls
+// back out and checks every message arrives intact and in order. Reports
+// messages/sec for each direction, and for native -> page how many scripts
+// the webview had to run.
+//
+//   g++ -std=c++17 -O2 -Isrc/llvm scripts/bench/gui_bridge_bench.cpp
+//       src/llvm/moonrt.cpp src/llvm/moonrt_async.cpp -o gui_bridge_bench
+//       -lpthread -ldl -lz -lssl -lcrypto
+//
+// or configure CMake with -DBUILD_BENCHMARKS=ON and run ctest.
+//
+// Usage: gui_bridge_bench [messages=200000] [producers=4] [frame=64]
+//   frame = messages per MoonGUI.queue() batch      (exit code 0 = pass)
+
+#include "moonrt.h"
+#include "moonrt_gui_bridge.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static const int kWindows = 2;
+static const size_t kBinarySize = 1024;
+
+static long g_errors = 0;
+
+static void error(const char* what, long seq) {
+    if (g_errors++ < 5) fprintf(stderr, "gui_bridge_bench: %s (message %ld)\n", what, seq);
+}
+
+// Every character the encoders escape, plus some UTF-8
+static std::string make_message(int producer, long seq) {
+    char head[64];
+    snprintf(head, sizeof(head), "{\"p\":%d,\"seq\":%ld,\"text\":\"", producer, seq);
+    return std::string(head) + "a\\b\\n\n\tc\r \xE6\x9C\x88 \"quoted\"\"}";
+}
+
+// Producer and sequence number up front, then a pattern derived from them
+static std::string make_binary(int producer, long seq) {
+    std::string bytes(kBinarySize, '\0');
+    bytes[0] = (char)producer;
+    for (int i = 0; i < 4; i++) bytes[1 + i] = (char)(seq >> (8 * i));
+    for (size_t i = 5; i < bytes.size(); i++) bytes[i] = (char)(seq + producer + i * 7);
+    return bytes;
+}
+
+// ============================================================================
+// Page -> native
+// ============================================================================
+
+// What MoonGUI.queue() posts for a frame of messages
+static std::string page_batch(const std::vector<std::string>& frame) {
+    std::string post = "__batch__:";
+    for (size_t i = 0; i < frame.size(); i++) {
+        if (i) post += '\n';
+        for (char c : frame[i]) {
+            if (c == '\\') post += "\\\\";
+            else if (c == '\n') post += "\\n";
+            else post += c;
+        }
+    }
+    return post;
+}
+
+static std::string page_binary(const std::string& bytes) {
+    std::string post = "__bin__:";
+    BridgeAppendBase64(post, (const unsigned char*)bytes.data(), bytes.size());
+    return post;
+}
+
+static long g_nextExpected = 0;
+
+static MoonValue* on_message(MoonValue** args, int argc) {
+    if (argc != 2 || !moon_is_string(args[1])) {
+        error("message handler got a bad payload", g_nextExpected);
+    } else if (make_message(0, g_nextExpected) != args[1]->data.strVal) {
+        error("message changed on the way in", g_nextExpected);
+    }
+    g_nextExpected++;
+    return moon_null();
+}
+
+static MoonValue* on_binary(MoonValue** args, int argc) {
+    size_t len = 0;
+    const char* bytes = argc == 2 ? moon_bytes_view(args[1], &len) : NULL;
+    std::string expected = make_binary(0, g_nextExpected);
+    if (!bytes || len != expected.size() || memcmp(bytes, expected.data(), len) != 0) {
+        error("binary message changed on the way in", g_nextExpected);
+    }
+    g_nextExpected++;
+    return moon_null();
+}
+
+// InvokeHandler as the GTK and Cocoa backends call it (synchronous handlers)
+static void invoke(MoonValue* callback, MoonValue* payload) {
+    MoonValue* args[2] = { moon_int(1), payload };
+    MoonValue* result = moon_call_func(callback, args, 2);
+    if (result) moon_release(result);
+    moon_release(args[0]);
+    moon_release(args[1]);
+}
+
+static void deliver(const std::string& post, MoonValue* messageCb, MoonValue* binaryCb) {
+    BridgeDispatch(post.c_str(), true, true,
+        [&](MoonValue* msg) { invoke(messageCb, msg); },
+        [&](MoonValue* buf) { invoke(binaryCb, buf); });
+}
+
+// Posts are built up front so only dispatch and the handlers are timed
+static double run_inbound(const std::vector<std::string>& posts, long messages,
+                          MoonValue* messageCb, MoonValue* binaryCb) {
+    g_nextExpected = 0;
+    auto start = Clock::now();
+    for (const auto& post : posts) deliver(post, messageCb, binaryCb);
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    if (g_nextExpected != messages) error("messages lost on the way in", g_nextExpected);
+    return elapsed;
+}
+
+// ============================================================================
+// Native -> page
+// ============================================================================
+
+// Reads the onMoonMessage/onMoonBinary calls back out of flushed scripts
+struct StubWebView {
+    long scripts = 0;
+    std::vector<long> nextSeq;      // Per producer
+
+    // The JavaScript string literal starting at s; advances s past it
+    static std::string literal(const char*& s) {
+        std::string out;
+        for (; *s && *s != '"'; s++) {
+            if (*s != '\\' || !s[1]) {
+                out += *s;
+                continue;
+            }
+            s++;
+            out += *s == 'n' ? '\n' : *s == 'r' ? '\r' : *s == 't' ? '\t' : *s;
+        }
+        if (*s) s++;
+        return out;
+    }
+
+    void run_javascript(const std::string& script) {
+        scripts++;
+        // Literals escape '"', so each (" opens the argument of a call
+        const char* base = script.c_str();
+        for (const char* s = base; (s = strstr(s, "(\"")) != NULL; ) {
+            bool isMessage = s - base >= 13 && memcmp(s - 13, "onMoonMessage", 13) == 0;
+            bool isBinary = s - base >= 11 && memcmp(s - 11, "_fromBase64", 11) == 0;
+            s += 2;
+            if (isMessage) {
+                std::string msg = literal(s);
+                int producer = 0;
+                long seq = -1;
+                sscanf(msg.c_str(), "{\"p\":%d,\"seq\":%ld", &producer, &seq);
+                check(producer, seq, make_message(producer, seq) == msg);
+            } else if (isBinary) {
+                MoonValue* buf = BridgeDecodeBase64(literal(s).c_str());
+                size_t len = 0;
+                const char* bytes = moon_bytes_view(buf, &len);
+                int producer = -1;
+                long seq = -1;
+                if (len >= 5) {
+                    producer = (unsigned char)bytes[0];
+                    seq = 0;
+                    for (int i = 0; i < 4; i++) seq |= (long)(unsigned char)bytes[1 + i] << (8 * i);
+                }
+                check(producer, seq, len >= 5 && std::string(bytes, len) == make_binary(producer, seq));
+                moon_release(buf);
+            }
+        }
+    }
+
+    void check(int producer, long seq, bool intact) {
+        if (producer < 0 || producer >= (int)nextSeq.size()) {
+            error("message from an unknown producer", seq);
+            return;
+        }
+        if (!intact) error("message changed on the way out", seq);
+        if (seq != nextSeq[producer]) error("message out of order on the way out", seq);
+        nextSeq[producer] = seq + 1;
+    }
+};
+
+// Stands in for the UI thread's main loop: runs queued idle callbacks
+class StubMainLoop {
+public:
+    void idle_add(std::function<void()> fn) {
+        std::lock_guard<std::mutex> guard(lock);
+        queue.push_back(std::move(fn));
+        wake.notify_one();
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> guard(lock);
+        while (!quit || !queue.empty()) {
+            if (queue.empty()) {
+                wake.wait(guard);
+                continue;
+            }
+            std::function<void()> fn = std::move(queue.front());
+            queue.pop_front();
+            guard.unlock();
+            fn();
+            guard.lock();
+        }
+    }
+
+    void stop() {
+        std::lock_guard<std::mutex> guard(lock);
+        quit = true;
+        wake.notify_one();
+    }
+
+private:
+    std::mutex lock;
+    std::condition_variable wake;
+    std::deque<std::function<void()>> queue;
+    bool quit = false;
+};
+
+static StubWebView g_views[kWindows + 1];    // Indexed by window id
+static StubMainLoop* g_loop;
+static BridgeOutbox g_outbox;
+
+// FlushOutbox/QueueScript as in the GTK backend
+static void flush_outbox() {
+    std::map<int, std::string> pending;
+    g_outbox.take(pending);
+    for (auto& entry : pending) g_views[entry.first].run_javascript(entry.second);
+}
+
+static void queue_script(int winId, const std::string& script) {
+    if (g_outbox.queue(winId, script)) g_loop->idle_add(flush_outbox);
+}
+
+// Producer p posts seq = p, p + producers, ... so window p % kWindows sees
+// each producer's messages in increasing order
+static void producer(int p, int producers, long messages, bool binary, bool outbox) {
+    for (long seq = p, n = 0; seq < messages; seq += producers, n++) {
+        int winId = 1 + p % kWindows;
+        std::string script;
+        if (binary) {
+            std::string bytes = make_binary(p, n);
+            script = BridgeBinaryScript(bytes.data(), bytes.size());
+        } else {
+            script = BridgeMessageScript(make_message(p, n).c_str());
+        }
+        if (outbox) {
+            queue_script(winId, script);
+        } else {
+            // One script per post, each its own trip through the main loop
+            g_loop->idle_add([winId, script]() { g_views[winId].run_javascript(script); });
+        }
+    }
+}
+
+struct OutboundResult {
+    double elapsed;
+    long scripts;
+};
+
+static OutboundResult run_outbound(long messages, int producers, bool binary, bool outbox) {
+    for (auto& view : g_views) {
+        view.scripts = 0;
+        view.nextSeq.assign(producers, 0);
+    }
+    StubMainLoop loop;
+    g_loop = &loop;
+    auto start = Clock::now();
+    std::thread ui([&]() { loop.run(); });
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back(producer, p, producers, messages, binary, outbox);
+    }
+    for (auto& t : threads) t.join();
+    loop.stop();
+    ui.join();
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    OutboundResult result = { elapsed, 0 };
+    long received = 0;
+    for (auto& view : g_views) {
+        result.scripts += view.scripts;
+        for (long n : view.nextSeq) received += n;
+    }
+    if (received != messages) error("messages lost on the way out", received);
+    return result;
+}
+
+static void report(const char* name, long messages, double elapsed) {
+    printf("  %-34s %10.0f msgs/s\n", name, messages / elapsed);
+}
+
+static void report_out(const char* name, long messages, const OutboundResult& r) {
+    printf("  %-34s %10.0f msgs/s  (%ld scripts, %.1f msgs/script)\n",
+           name, messages / r.elapsed, r.scripts, r.scripts ? (double)messages / r.scripts : 0.0);
+}
+
+int main(int argc, char** argv) {
+    long messages = argc > 1 ? atol(argv[1]) : 200000;
+    int producers = argc > 2 ? atoi(argv[2]) : 4;
+    int frame = argc > 3 ? atoi(argv[3]) : 64;
+    if (messages < 1) messages = 1;
+    if (producers < 1) producers = 1;
+    if (producers > 255) producers = 255;
+    if (frame < 1) frame = 1;
+    moon_runtime_init(argc, argv);
+
+    MoonValue* messageCb = moon_func(on_message);
+    MoonValue* binaryCb = moon_func(on_binary);
+    printf("gui_bridge_bench: %ld messages, %d producers, %d per frame\n", messages, producers, frame);
+
+    // Page -> native
+    std::vector<std::string> posts;
+    for (long seq = 0; seq < messages; seq++) posts.push_back(make_message(0, seq));
+    report("page -> native postMessage", messages, run_inbound(posts, messages, messageCb, binaryCb));
+
+    std::vector<std::string> batches, frameMsgs;
+    for (long seq = 0; seq < messages; seq++) {
+        frameMsgs.push_back(make_message(0, seq));
+        if ((long)frameMsgs.size() == frame || seq == messages - 1) {
+            batches.push_back(page_batch(frameMsgs));
+            frameMsgs.clear();
+        }
+    }
+    report("page -> native queue (__batch__)", messages, run_inbound(batches, messages, messageCb, binaryCb));
+
+    long binaries = messages / 16 + 1;
+    std::vector<std::string> binPosts;
+    for (long seq = 0; seq < binaries; seq++) binPosts.push_back(page_binary(make_binary(0, seq)));
+    report("page -> native sendBinary (1 KB)", binaries, run_inbound(binPosts, binaries, messageCb, binaryCb));
+
+    // Native -> page
+    report_out("native -> page, script per post", messages,
+               run_outbound(messages, producers, false, false));
+    report_out("native -> page, outbox", messages,
+               run_outbound(messages, producers, false, true));
+    report_out("native -> page binary (1 KB), outbox", binaries,
+               run_outbound(binaries, producers, true, true));
+
+    moon_release(messageCb);
+    moon_release(binaryCb);
+    if (g_errors) {
+        fprintf(stderr, "gui_bridge_bench: %ld error(s)\n", g_errors);
+        return 1;
+    }
+    return 0;
+}
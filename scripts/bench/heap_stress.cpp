@@ -0,0 +1,168 @@
+// MoonLang Runtime - Static Heap Stress Test
+// Copyright (c) 2026 greenteng.com
+//
+// Host driver for the TLSF static heap (MOON_USE_STATIC_HEAP). Build the
+// runtime for the MCU target, with the static heap, and link it in:
+//
+//   g++ -std=c++17 -O2 -DMOON_TARGET_MCU -DMOON_STATIC_ALLOC -Isrc/llvm
+//       scripts/bench/heap_stress.cpp src/llvm/moonrt.cpp src/llvm/moonrt_async.cpp
+//       -o heap_stress -lpthread
+//
+// or configure CMake with -DBUILD_BENCHMARKS=ON and run ctest.
+//
+// Random moon_alloc / moon_realloc / moon_free calls of random sizes, with
+// every live block filled with a pattern. After each step moon_heap_info()
+// must agree with what the driver holds:
+//   - used + free covers the heap and never changes
+//   - allocCount - freeCount == usedBlocks, and the histogram sums to it
+//   - used <= peak, largestFree <= free, 0 <= fragmentation <= 100
+//   - a request no larger than largestFree never fails
+// and no block's contents may change under it.
+//
+// Usage: heap_stress [steps] [seed]      (exit code 0 = pass)
+
+#include "moonrt_core.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#ifndef MOON_USE_STATIC_HEAP
+#error "heap_stress needs the static heap: build with -DMOON_TARGET_MCU -DMOON_STATIC_ALLOC"
+#endif
+
+struct Block {
+    unsigned char* ptr;
+    size_t size;
+    unsigned char fill;
+};
+
+static uint64_t g_rng;
+
+static uint32_t rnd(uint32_t n) {
+    g_rng = g_rng * 6364136223846793005ull + 1442695040888963407ull;
+    return (uint32_t)(g_rng >> 33) % n;
+}
+
+// Mostly small blocks (values, short strings), some medium, a few large
+static size_t rnd_size(void) {
+    uint32_t r = rnd(100);
+    if (r < 70) return 1 + rnd(64);
+    if (r < 95) return 65 + rnd(960);
+    return 1025 + rnd(MOON_HEAP_SIZE / 8);
+}
+
+// Header and rounding the heap adds to a request, as an upper bound
+static size_t block_cost(size_t size) {
+    return (size + 32 + 7) & ~(size_t)7;
+}
+
+static bool check_block(const Block& b) {
+    for (size_t i = 0; i < b.size; i++) {
+        if (b.ptr[i] != (unsigned char)(b.fill + i)) return false;
+    }
+    return true;
+}
+
+static void fill_block(Block& b, size_t from) {
+    for (size_t i = from; i < b.size; i++) b.ptr[i] = (unsigned char)(b.fill + i);
+}
+
+static long g_step;
+
+static int fail(const char* what, const MoonHeapInfo& info) {
+    fprintf(stderr, "step %ld: %s (used %zu, free %zu, largest %zu, blocks %zu/%zu, allocs %zu, frees %zu)\n",
+            g_step, what, info.used, info.free, info.largestFree, info.usedBlocks, info.freeBlocks,
+            info.allocCount, info.freeCount);
+    return 1;
+}
+
+// The first broken invariant, or NULL
+static const char* check_info(const MoonHeapInfo& info, size_t span) {
+    if (info.used + info.free != span) return "used + free changed";
+    if (info.used > info.peak) return "used above peak";
+    if (info.largestFree > info.free) return "largest free block above free bytes";
+    if (info.fragmentation < 0 || info.fragmentation > 100) return "fragmentation out of range";
+    if (info.allocCount - info.freeCount != info.usedBlocks) return "live count != used blocks";
+    size_t histogram = 0;
+    for (int i = 0; i < MOON_HEAP_HIST_BUCKETS; i++) histogram += info.histogram[i];
+    if (histogram != info.usedBlocks) return "histogram != used blocks";
+    if (info.free > 0 && info.freeBlocks == 0) return "free bytes without free blocks";
+    return NULL;
+}
+
+int main(int argc, char** argv) {
+    long steps = argc > 1 ? atol(argv[1]) : 200000;
+    g_rng = argc > 2 ? strtoull(argv[2], NULL, 10) : 1;
+
+    MoonHeapInfo info;
+    moon_heap_info(&info);
+    size_t span = info.used + info.free;
+    size_t baseline = info.used;
+    std::vector<Block> live;
+    size_t allocs = 0, reallocs = 0, frees = 0, skipped = 0;
+    int worstFragmentation = 0;
+
+    for (g_step = 0; g_step < steps; g_step++) {
+        uint32_t op = live.empty() ? 0 : rnd(10);
+        if (op < 5) {
+            Block b;
+            b.size = rnd_size();
+            b.fill = (unsigned char)rnd(256);
+            if (block_cost(b.size) > info.largestFree) {
+                skipped++;      // Would not fit; free something instead
+                op = 9;
+            } else {
+                b.ptr = (unsigned char*)moon_alloc(b.size);
+                if (!b.ptr) return fail("allocation within largestFree failed", info);
+                for (size_t i = 0; i < b.size; i++) {
+                    if (b.ptr[i] != 0) return fail("moon_alloc block not zeroed", info);
+                }
+                fill_block(b, 0);
+                live.push_back(b);
+                allocs++;
+            }
+        }
+        if (op >= 5 && op < 7) {
+            Block& b = live[rnd((uint32_t)live.size())];
+            if (!check_block(b)) return fail("block contents changed", info);
+            size_t size = rnd_size();
+            if (size <= b.size || block_cost(size) <= info.largestFree) {
+                unsigned char* grown = (unsigned char*)moon_realloc(b.ptr, size);
+                if (!grown) return fail("realloc within largestFree failed", info);
+                b.ptr = grown;
+                size_t kept = size < b.size ? size : b.size;
+                b.size = kept;
+                if (!check_block(b)) return fail("realloc lost contents", info);
+                b.size = size;
+                fill_block(b, kept);
+                reallocs++;
+            }
+        } else if (op >= 7 && !live.empty()) {
+            size_t i = rnd((uint32_t)live.size());
+            if (!check_block(live[i])) return fail("block contents changed", info);
+            moon_free(live[i].ptr, 0);
+            live[i] = live.back();
+            live.pop_back();
+            frees++;
+        }
+
+        moon_heap_info(&info);
+        if (const char* broken = check_info(info, span)) return fail(broken, info);
+        if (info.fragmentation > worstFragmentation) worstFragmentation = info.fragmentation;
+    }
+
+    for (Block& b : live) {
+        if (!check_block(b)) return fail("block contents changed", info);
+        moon_free(b.ptr, 0);
+    }
+    moon_heap_info(&info);
+    if (const char* broken = check_info(info, span)) return fail(broken, info);
+    if (info.used != baseline) return fail("memory left after freeing everything", info);
+
+    printf("heap_stress: %ld steps, %zu allocs, %zu reallocs, %zu frees, %zu skipped; "
+           "peak %zu of %zu bytes, worst fragmentation %d%%\n",
+           steps, allocs, reallocs, frees, skipped, info.peak, info.total, worstFragmentation);
+    return 0;
+}
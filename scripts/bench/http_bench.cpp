@@ -0,0 +1,261 @@
+// MoonLang Runtime - Loopback HTTP Benchmark
+// Copyright (c) 2026 greenteng.com
+//
+// wrk-style load test of http_serve. The server runs in this process with
+// one route (GET /plaintext -> "Hello, World!"). Client threads each drive
+// their share of keep-alive connections: send `pipeline` requests, wait for
+// all the responses, repeat. Reports requests/sec and latency percentiles
+// per round trip.
+//
+//   g++ -std=c++17 -O2 -Isrc/llvm scripts/bench/http_bench.cpp
+//       src/llvm/moonrt.cpp src/llvm/moonrt_async.cpp -o http_bench
+//       -lpthread -ldl -lz -lssl -lcrypto
+//
+// or configure CMake with -DBUILD_BENCHMARKS=ON.
+//
+// Usage: http_bench [seconds=3] [connections=64] [threads=2] [pipeline=1] [port=18453]
+
+#include "moonrt.h"
+#include "moonrt_core.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#error "http_bench uses POSIX sockets for its client threads"
+#endif
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef std::chrono::steady_clock Clock;
+
+static const char kRequest[] = "GET /plaintext HTTP/1.1\r\nHost: localhost\r\n\r\n";
+
+static std::atomic<bool> g_stop{false};
+static std::atomic<bool> g_measuring{false};
+
+struct BenchConn {
+    int fd;
+    std::string in;
+    int pending;                    // Responses still due for this round
+    Clock::time_point sent;
+};
+
+struct ThreadResult {
+    long responses = 0;
+    long errors = 0;
+    std::vector<double> latencies;  // Microseconds per round trip
+};
+
+static MoonValue* plaintext(MoonValue** args, int argc) {
+    (void)args;
+    (void)argc;
+    return moon_string("Hello, World!");
+}
+
+static int connect_loopback(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((unsigned short)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+static bool send_round(BenchConn& c, int pipeline) {
+    std::string batch;
+    for (int i = 0; i < pipeline; i++) batch += kRequest;
+    size_t off = 0;
+    while (off < batch.size()) {
+        ssize_t n = send(c.fd, batch.data() + off, batch.size() - off, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        off += (size_t)n;
+    }
+    c.pending = pipeline;
+    c.sent = Clock::now();
+    return true;
+}
+
+// Take every complete response off the front of c.in; -1 on a malformed one
+static int take_responses(BenchConn& c) {
+    int done = 0;
+    for (;;) {
+        size_t headEnd = c.in.find("\r\n\r\n");
+        if (headEnd == std::string::npos) return done;
+        if (c.in.compare(0, 12, "HTTP/1.1 200") != 0) return -1;
+        size_t length = 0;
+        for (size_t p = c.in.find("\r\n"); p < headEnd; p = c.in.find("\r\n", p + 2)) {
+            if (strncasecmp(c.in.c_str() + p + 2, "content-length:", 15) == 0) {
+                length = strtoul(c.in.c_str() + p + 17, NULL, 10);
+                break;
+            }
+        }
+        size_t total = headEnd + 4 + length;
+        if (c.in.size() < total) return done;
+        c.in.erase(0, total);
+        done++;
+    }
+}
+
+static void client(int port, int connections, int pipeline, ThreadResult* result) {
+    std::vector<BenchConn> conns;
+    for (int i = 0; i < connections; i++) {
+        BenchConn c;
+        c.fd = connect_loopback(port);
+        if (c.fd < 0) {
+            result->errors++;
+            continue;
+        }
+        c.pending = 0;
+        conns.push_back(c);
+    }
+    for (auto& c : conns) {
+        if (!send_round(c, pipeline)) result->errors++;
+    }
+
+    std::vector<struct pollfd> pfds(conns.size());
+    char buf[16384];
+    while (!g_stop.load(std::memory_order_relaxed) && !conns.empty()) {
+        for (size_t i = 0; i < conns.size(); i++) {
+            pfds[i].fd = conns[i].fd;
+            pfds[i].events = POLLIN;
+            pfds[i].revents = 0;
+        }
+        if (poll(pfds.data(), (nfds_t)pfds.size(), 100) <= 0) continue;
+        for (size_t i = 0; i < conns.size(); i++) {
+            if (!pfds[i].revents) continue;
+            BenchConn& c = conns[i];
+            ssize_t n = recv(c.fd, buf, sizeof(buf), 0);
+            if (n <= 0) {
+                result->errors++;
+                close(c.fd);
+                c.fd = -1;
+                continue;
+            }
+            c.in.append(buf, (size_t)n);
+            int got = take_responses(c);
+            if (got < 0) {
+                result->errors++;
+                close(c.fd);
+                c.fd = -1;
+                continue;
+            }
+            c.pending -= got;
+            if (c.pending > 0) continue;
+            if (g_measuring.load(std::memory_order_relaxed)) {
+                result->responses += pipeline;
+                result->latencies.push_back(
+                    std::chrono::duration<double, std::micro>(Clock::now() - c.sent).count());
+            }
+            if (!send_round(c, pipeline)) {
+                result->errors++;
+                close(c.fd);
+                c.fd = -1;
+            }
+        }
+        conns.erase(std::remove_if(conns.begin(), conns.end(),
+                                   [](const BenchConn& c) { return c.fd < 0; }), conns.end());
+        pfds.resize(conns.size());
+    }
+    for (auto& c : conns) close(c.fd);
+}
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? atof(argv[1]) : 3.0;
+    int connections = argc > 2 ? atoi(argv[2]) : 64;
+    int threads = argc > 3 ? atoi(argv[3]) : 2;
+    int pipeline = argc > 4 ? atoi(argv[4]) : 1;
+    int port = argc > 5 ? atoi(argv[5]) : 18453;
+    if (threads < 1) threads = 1;
+    if (pipeline < 1) pipeline = 1;
+    if (connections < threads) connections = threads;
+    moon_runtime_init(argc, argv);
+
+    MoonValue* server = moon_http_server();
+    MoonValue* method = moon_string("GET");
+    MoonValue* path = moon_string("/plaintext");
+    MoonValue* handler = moon_func(plaintext);
+    moon_http_route(server, method, path, handler);
+    moon_release(method);
+    moon_release(path);
+    moon_release(handler);
+
+    MoonValue* portVal = moon_int(port);
+    std::atomic<bool> served{true};
+    std::thread serverThread([&]() {
+        MoonValue* ok = moon_http_serve(server, portVal, NULL);
+        served = moon_is_truthy(ok);
+        moon_release(ok);
+    });
+
+    // Wait for the listener before starting the clients
+    int probe = -1;
+    for (int i = 0; i < 200 && probe < 0 && served; i++) {
+        probe = connect_loopback(port);
+        if (probe < 0) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (probe < 0) {
+        fprintf(stderr, "http_bench: server did not come up on port %d\n", port);
+        _exit(1);
+    }
+    close(probe);
+
+    std::vector<ThreadResult> results(threads);
+    std::vector<std::thread> clients;
+    for (int i = 0; i < threads; i++) {
+        int share = connections / threads + (i < connections % threads ? 1 : 0);
+        clients.emplace_back(client, port, share, pipeline, &results[i]);
+    }
+
+    // Short warm-up, then measure
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    g_measuring = true;
+    auto start = Clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    g_measuring = false;
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    g_stop = true;
+    for (auto& t : clients) t.join();
+
+    moon_http_stop(server);
+    serverThread.join();
+
+    long responses = 0, errors = 0;
+    std::vector<double> latencies;
+    for (auto& r : results) {
+        responses += r.responses;
+        errors += r.errors;
+        latencies.insert(latencies.end(), r.latencies.begin(), r.latencies.end());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto pct = [&](double p) {
+        return latencies.empty() ? 0.0 : latencies[(size_t)(p * (latencies.size() - 1))];
+    };
+
+    printf("http_bench: %d connections, %d threads, pipeline %d, %.1f s\n",
+           connections, threads, pipeline, elapsed);
+    printf("  requests/sec: %.0f  (%ld responses, %ld errors)\n", responses / elapsed, responses, errors);
+    printf("  latency us:   p50 %.0f  p90 %.0f  p99 %.0f  max %.0f\n",
+           pct(0.50), pct(0.90), pct(0.99), latencies.empty() ? 0.0 : latencies.back());
+    return errors == 0 ? 0 : 1;
+}
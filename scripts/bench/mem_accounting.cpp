@@ -0,0 +1,161 @@
+// MoonLang Runtime - Allocation Accounting Check
+// Copyright (c) 2026 greenteng.com
+//
+// Host driver for the per-kind allocation counters (moon_mem_kind_stats).
+// Link it against the desktop runtime:
+//
+//   g++ -std=c++17 -O2 -Isrc/llvm scripts/bench/mem_accounting.cpp
+//       src/llvm/moonrt.cpp src/llvm/moonrt_async.cpp src/llvm/moonrt_http_client.cpp
+//       src/llvm/moonrt_tls.cpp -o mem_accounting -lpthread -ldl -lz -lssl -lcrypto
+//
+// or configure CMake with -DBUILD_BENCHMARKS=ON and run ctest.
+//
+// Runs runtime paths that convert values with moon_to_string / moon_strdup
+// and release the result themselves: JSON encode/decode, tcp_send/tcp_sendv
+// over a socket pair, udp_send/udp_send_batch and a refused http_request with
+// headers and a JSON body. After a warm-up round, every kind's live bytes and
+// block count must be back where they started once a round has finished; a
+// buffer handed back with free() instead of moon_free() stays counted.
+//
+// Usage: mem_accounting [rounds]      (exit code 0 = pass)
+
+#include "moonrt_core.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#error "mem_accounting uses a POSIX socket pair"
+#endif
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+static void drain(int fd) {
+    char buf[4096];
+    while (recv(fd, buf, sizeof(buf), MSG_DONTWAIT) > 0) {
+    }
+}
+
+// moon_list_append and moon_dict_set take their own references
+static void append(MoonValue* list, MoonValue* val) {
+    moon_release(moon_list_append(list, val));
+    moon_release(val);
+}
+
+static void set(MoonValue* dict, const char* key, MoonValue* val) {
+    MoonValue* k = moon_string(key);
+    moon_dict_set(dict, k, val);
+    moon_release(k);
+    moon_release(val);
+}
+
+static MoonValue* sample_dict(int i) {
+    MoonValue* dict = moon_dict_new();
+    MoonValue* list = moon_list_new();
+    for (int j = 0; j < 40; j++) {
+        append(list, moon_int(i * 100 + j));
+        append(list, moon_string("quoted \"text\" with a \\ and\ttab"));
+        append(list, moon_float(j + 0.5));
+        append(list, moon_bool(j & 1));
+    }
+    set(dict, "items", list);
+    set(dict, "id", moon_int(i));
+    set(dict, "none", moon_null());
+    return dict;
+}
+
+static void run_round(int i, int pair[2], MoonValue* udp) {
+    // JSON: nested containers grow the encoder's buffers; a long escaped
+    // string grows the decoder's
+    MoonValue* dict = sample_dict(i);
+    MoonValue* text = moon_json_encode(dict);
+    MoonValue* back = moon_json_decode(text);
+    moon_release(back);
+    moon_release(text);
+    std::string escaped = "\"";
+    for (int j = 0; j < 200; j++) escaped += "a\\nb\\\"";
+    escaped += "\"";
+    MoonValue* src = moon_string(escaped.c_str());
+    moon_release(moon_json_decode(src));
+    moon_release(src);
+
+    // Non-string payloads go through moon_to_string
+    MoonValue* sock = moon_int(pair[0]);
+    MoonValue* num = moon_int(123456789 + i);
+    moon_release(moon_tcp_send(sock, num));
+    MoonValue* parts = moon_list_new();
+    for (int j = 0; j < 70; j++) append(parts, moon_int(j));
+    moon_release(moon_tcp_sendv(sock, parts));
+    drain(pair[1]);
+
+    MoonValue* host = moon_string("127.0.0.1");
+    MoonValue* port = moon_int(9);
+    moon_release(moon_udp_send(udp, host, port, num));
+    MoonValue* gso = moon_bool(false);
+    moon_release(moon_udp_send_batch(udp, host, port, parts, gso));
+    moon_release(gso);
+
+    // Refused connection: the request head and the JSON body are still built
+    MoonValue* options = moon_dict_new();
+    MoonValue* headers = moon_dict_new();
+    set(headers, "X-Round", moon_int(i));
+    set(headers, "X-Flag", moon_bool(true));
+    set(options, "headers", headers);
+    set(options, "body", dict);
+    MoonValue* method = moon_string("post");
+    MoonValue* url = moon_string("http://127.0.0.1:1/");
+    moon_release(moon_http_request(method, url, options));
+
+    moon_release(url);
+    moon_release(method);
+    moon_release(options);
+    moon_release(port);
+    moon_release(host);
+    moon_release(parts);
+    moon_release(num);
+    moon_release(sock);
+}
+
+int main(int argc, char** argv) {
+    int rounds = argc > 1 ? atoi(argv[1]) : 200;
+
+    moon_runtime_init(argc, argv);
+
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) {
+        perror("socketpair");
+        return 1;
+    }
+    MoonValue* udp = moon_udp_socket();
+
+    // Warm-up: lazily built caches (small-int strings, pools) settle first
+    run_round(0, pair, udp);
+
+    MoonMemKindStats before[MOON_MEM_KIND_COUNT];
+    moon_mem_kind_stats(before);
+    for (int i = 1; i <= rounds; i++) run_round(i, pair, udp);
+    MoonMemKindStats after[MOON_MEM_KIND_COUNT];
+    moon_mem_kind_stats(after);
+
+    int failures = 0;
+    for (int k = 0; k < MOON_MEM_KIND_COUNT; k++) {
+        bool ok = after[k].live == before[k].live && after[k].count == before[k].count;
+        printf("  %-15s live %8lld -> %8lld  blocks %6lld -> %6lld  allocs +%lld%s\n",
+               moon_mem_kind_name((MoonMemKind)k),
+               (long long)before[k].live, (long long)after[k].live,
+               (long long)before[k].count, (long long)after[k].count,
+               (long long)(after[k].allocs - before[k].allocs), ok ? "" : "  LEAK");
+        if (!ok) failures++;
+    }
+
+    moon_udp_close(udp);
+    moon_release(udp);
+    close(pair[0]);
+    close(pair[1]);
+
+    printf("mem_accounting: %d rounds, %s\n", rounds, failures ? "FAIL" : "ok");
+    return failures ? 1 : 0;
+}
@@ -188,6 +188,18 @@ set TLS_FLAGS=/DMOON_HAS_TLS
 set "TLS_LIBS=%OPENSSL_DIR%\lib\libssl.lib %OPENSSL_DIR%\lib\libcrypto.lib"
 goto :tls_done
 
+echo Compiling moonrt_http_client.cpp...
+cl /c /O2 /EHsc /std:c++17 /utf-8 /DNDEBUG /DUNICODE /D_UNICODE ^
+   /I"src\llvm" ^
+   src\llvm\moonrt_http_client.cpp /Fo"src\llvm\moonrt_http_client.obj"
+if %errorlevel% neq 0 goto :error
+
+echo Compiling moonrt_websocket.cpp...
+cl /c /O2 /EHsc /std:c++17 /utf-8 /DNDEBUG /DUNICODE /D_UNICODE ^
+   /I"src\llvm" ^
+   src\llvm\moonrt_websocket.cpp /Fo"src\llvm\moonrt_websocket.obj"
+if %errorlevel% neq 0 goto :error
+
 :compile_tls_stub
 echo Compiling moonrt_tls.cpp (stub)...
 cl /c /O2 /EHsc /std:c++17 /utf-8 /DNDEBUG /DUNICODE /D_UNICODE ^
@@ -217,7 +229,7 @@ if %errorlevel% neq 0 goto :error
 
 REM Create runtime library
 echo Creating moonrt.lib...
-set RT_OBJS=src\llvm\moonrt.obj src\llvm\moonrt_async.obj src\llvm\moonrt_channel.obj src\llvm\moonrt_gui.obj src\llvm\moonrt_regex.obj src\llvm\moonrt_tls.obj src\llvm\moonrt_ffi.obj src\llvm\moonrt_ffi_parser.obj src\llvm\moonrt_ffi_callback.obj
+set RT_OBJS=src\llvm\moonrt.obj src\llvm\moonrt_async.obj src\llvm\moonrt_channel.obj src\llvm\moonrt_gui.obj src\llvm\moonrt_regex.obj src\llvm\moonrt_tls.obj src\llvm\moonrt_http_client.obj src\llvm\moonrt_websocket.obj src\llvm\moonrt_ffi.obj src\llvm\moonrt_ffi_parser.obj src\llvm\moonrt_ffi_callback.obj
 set RT_LIBS=
 if %USE_PCRE2%==1 (
     set "RT_LIBS=%RT_LIBS% %PCRE2_DIR%\build\pcre2.lib"
@@ -297,9 +309,12 @@ echo   moonrt_builtin.cpp - Built-in functions
 echo   moonrt_io.cpp      - File I/O
 echo   moonrt_json.cpp    - JSON support
 echo   moonrt_network.cpp - Network support
+echo   moonrt_http.cpp    - HTTP/1.1 server
 echo   moonrt_dll.cpp     - DLL loading
 echo   moonrt_regex.cpp   - Regex (PCRE2=%USE_PCRE2%)
 echo   moonrt_tls.cpp     - TLS/SSL (OpenSSL=%USE_OPENSSL%)
+echo   moonrt_http_client.cpp - HTTP client
+echo   moonrt_websocket.cpp - WebSocket server/client
 echo.
 
 endlocal
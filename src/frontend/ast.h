@@ -1,17 +1,55 @@
 #ifndef AST_H
 #define AST_H
 
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <new>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
-#include <memory>
 #include <variant>
 
 // Forward declarations
 struct Expression;
 struct Statement;
 
-using ExprPtr = std::shared_ptr<Expression>;
-using StmtPtr = std::shared_ptr<Statement>;
+// Nodes live in the AstArena owned by the Program; pointers are non-owning
+using ExprPtr = Expression*;
+using StmtPtr = Statement*;
+
+// ==================== Symbols ====================
+
+// Names are interned once at parse time so later passes can key their
+// tables by a small integer instead of re-hashing strings
+using Symbol = uint32_t;
+constexpr Symbol NO_SYMBOL = UINT32_MAX;
+
+class SymbolTable {
+public:
+    Symbol intern(std::string_view name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        Symbol sym = (Symbol)names.size();
+        names.emplace_back(name);
+        ids.emplace(names.back(), sym);
+        return sym;
+    }
+    
+    // NO_SYMBOL if the name never appeared in the program
+    Symbol find(std::string_view name) const {
+        auto it = ids.find(name);
+        return it != ids.end() ? it->second : NO_SYMBOL;
+    }
+    
+    const std::string& name(Symbol sym) const { return names[sym]; }
+    size_t size() const { return names.size(); }
+    
+private:
+    std::deque<std::string> names;  // Stable storage, indexed by Symbol
+    std::unordered_map<std::string_view, Symbol> ids;
+};
 
 // ==================== Expressions ====================
 
@@ -35,16 +73,18 @@ struct NullLiteral {};
 
 struct Identifier {
     std::string name;
+    Symbol sym = NO_SYMBOL;
 };
 
+// Operators are views of static spellings ("+", "and", ...)
 struct BinaryExpr {
-    std::string op;
+    std::string_view op;
     ExprPtr left;
     ExprPtr right;
 };
 
 struct UnaryExpr {
-    std::string op;
+    std::string_view op;
     ExprPtr operand;
 };
 
@@ -92,6 +132,7 @@ struct LambdaExpr {
 struct NewExpr {
     std::string className;
     std::vector<ExprPtr> arguments;
+    Symbol classSym = NO_SYMBOL;
 };
 
 struct SelfExpr {};
@@ -176,6 +217,7 @@ struct FuncDecl {
     std::vector<Parameter> params;
     std::vector<StmtPtr> body;
     bool isExported = false;  // Whether the function is exported for DLL/SO
+    Symbol sym = NO_SYMBOL;
 };
 
 struct ReturnStmt {
@@ -218,6 +260,8 @@ struct ClassDecl {
     std::string name;
     std::string parentName;  // Empty means no inheritance
     std::vector<MethodDecl> methods;
+    Symbol sym = NO_SYMBOL;
+    Symbol parentSym = NO_SYMBOL;
 };
 
 // Import statement
@@ -278,10 +322,72 @@ struct Statement {
     Statement(T&& v, int l = 0) : value(std::forward<T>(v)), line(l) {}
 };
 
+// ==================== Arena ====================
+
+// Bump allocator for AST nodes. Nodes are constructed in fixed-size chunks
+// and never freed individually; the whole tree is destroyed with the arena.
+class AstArena {
+public:
+    AstArena() = default;
+    AstArena(const AstArena&) = delete;
+    AstArena& operator=(const AstArena&) = delete;
+    
+    template<typename T>
+    ExprPtr expr(T&& node, int line) { return exprs.create(std::forward<T>(node), line); }
+    
+    template<typename T>
+    StmtPtr stmt(T&& node, int line) { return stmts.create(std::forward<T>(node), line); }
+    
+    size_t nodeCount() const { return exprs.count() + stmts.count(); }
+    size_t bytesReserved() const { return exprs.bytesReserved() + stmts.bytesReserved(); }
+    
+private:
+    template<typename N>
+    class Pool {
+    public:
+        static constexpr size_t CHUNK = 256;
+        
+        Pool() = default;
+        Pool(const Pool&) = delete;
+        Pool& operator=(const Pool&) = delete;
+        
+        ~Pool() {
+            for (size_t c = 0; c < chunks.size(); c++) {
+                size_t n = (c + 1 == chunks.size()) ? used : CHUNK;
+                for (size_t i = 0; i < n; i++) chunks[c][i].~N();
+                ::operator delete(chunks[c]);
+            }
+        }
+        
+        template<typename... Args>
+        N* create(Args&&... args) {
+            if (used == CHUNK) {
+                chunks.push_back(static_cast<N*>(::operator new(sizeof(N) * CHUNK)));
+                used = 0;
+            }
+            N* node = new (chunks.back() + used) N(std::forward<Args>(args)...);
+            used++;
+            return node;
+        }
+        
+        size_t count() const { return chunks.empty() ? 0 : (chunks.size() - 1) * CHUNK + used; }
+        size_t bytesReserved() const { return chunks.size() * CHUNK * sizeof(N); }
+        
+    private:
+        std::vector<N*> chunks;
+        size_t used = CHUNK;
+    };
+    
+    Pool<Expression> exprs;
+    Pool<Statement> stmts;
+};
+
 // ==================== Program ====================
 
 struct Program {
     std::vector<StmtPtr> statements;
+    std::unique_ptr<AstArena> arena;       // Owns every node reachable from statements
+    std::unique_ptr<SymbolTable> symbols;  // Names interned by the parser
 };
 
 #endif // AST_H
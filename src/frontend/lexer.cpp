@@ -1,8 +1,91 @@
 #include "lexer.h"
-#include <cctype>
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 
-Lexer::Lexer(const std::string& source) : source(source), aliasMap(nullptr) {}
+// ============================================================================
+// Character Classes
+// ============================================================================
+
+enum : uint8_t {
+    CC_SPACE = 1,      // ' ', '\t', '\r'
+    CC_DIGIT = 2,      // 0-9
+    CC_HEX = 4,        // 0-9, a-f, A-F
+    CC_IDENT = 8,      // Identifier start: a-z, A-Z, '_', UTF-8 lead/continuation bytes
+    CC_IDENT_REST = 16 // Identifier continuation: CC_IDENT plus digits
+};
+
+struct CharClassTable {
+    uint8_t bits[256];
+    CharClassTable() : bits() {
+        bits[(unsigned char)' '] = bits[(unsigned char)'\t'] = bits[(unsigned char)'\r'] = CC_SPACE;
+        for (int c = '0'; c <= '9'; c++) bits[c] = CC_DIGIT | CC_HEX | CC_IDENT_REST;
+        for (int c = 'a'; c <= 'z'; c++) bits[c] = CC_IDENT | CC_IDENT_REST;
+        for (int c = 'A'; c <= 'Z'; c++) bits[c] = CC_IDENT | CC_IDENT_REST;
+        for (int c = 'a'; c <= 'f'; c++) bits[c] |= CC_HEX;
+        for (int c = 'A'; c <= 'F'; c++) bits[c] |= CC_HEX;
+        bits[(unsigned char)'_'] = CC_IDENT | CC_IDENT_REST;
+        for (int c = 0x80; c < 0x100; c++) bits[c] = CC_IDENT | CC_IDENT_REST;
+    }
+};
+
+static const CharClassTable charClass;
+
+static inline bool hasClass(char c, uint8_t cls) {
+    return (charClass.bits[(unsigned char)c] & cls) != 0;
+}
+
+// Operators that an alias may stand for
+static const struct { const char* op; TokenType type; } aliasOperators[] = {
+    {"+", TokenType::TK_PLUS}, {"-", TokenType::TK_MINUS}, {"*", TokenType::TK_STAR},
+    {"/", TokenType::TK_SLASH}, {"%", TokenType::TK_PERCENT}, {"**", TokenType::TK_POWER},
+    {"=", TokenType::TK_ASSIGN}, {"==", TokenType::TK_EQ}, {"!=", TokenType::TK_NE},
+    {"<", TokenType::TK_LT}, {">", TokenType::TK_GT}, {"<=", TokenType::TK_LE},
+    {">=", TokenType::TK_GE}, {"(", TokenType::TK_LPAREN}, {")", TokenType::TK_RPAREN},
+    {"[", TokenType::TK_LBRACKET}, {"]", TokenType::TK_RBRACKET}, {"{", TokenType::TK_LBRACE},
+    {"}", TokenType::TK_RBRACE}, {",", TokenType::TK_COMMA}, {":", TokenType::TK_COLON},
+    {".", TokenType::TK_DOT}, {"&", TokenType::TK_BIT_AND}, {"|", TokenType::TK_BIT_OR},
+    {"^", TokenType::TK_BIT_XOR}, {"~", TokenType::TK_BIT_NOT}, {"<<", TokenType::TK_LSHIFT},
+    {">>", TokenType::TK_RSHIFT},
+};
+
+Lexer::Lexer(std::string_view source) : source(source), aliasMap(nullptr) {}
+
+void Lexer::setAliasMap(const AliasMap* map) {
+    aliasMap = (map && map->isLoaded()) ? map : nullptr;
+    
+    // Index operator aliases by first byte so tokenize() only compares
+    // the few aliases that can start at the current character
+    operatorAliases.clear();
+    if (aliasMap) {
+        for (const auto& [alias, op] : aliasMap->getOperatorAliases()) {
+            if (alias.empty()) continue;
+            for (const auto& known : aliasOperators) {
+                if (op == known.op) {
+                    operatorAliases.push_back({alias, known.op, known.type});
+                    break;
+                }
+            }
+        }
+    }
+    std::sort(operatorAliases.begin(), operatorAliases.end(),
+              [](const OperatorAlias& a, const OperatorAlias& b) {
+                  unsigned char ca = (unsigned char)a.text[0], cb = (unsigned char)b.text[0];
+                  if (ca != cb) return ca < cb;
+                  return a.text.size() > b.text.size();
+              });
+    size_t i = 0;
+    for (int c = 0; c < 256; c++) {
+        aliasIndex[c] = (uint32_t)i;
+        while (i < operatorAliases.size() && (unsigned char)operatorAliases[i].text[0] == c) i++;
+    }
+    aliasIndex[256] = (uint32_t)i;
+}
+
+std::string_view Lexer::keepText(std::string text) {
+    ownedText.push_back(std::move(text));
+    return ownedText.back();
+}
 
 // ============================================================================
 // UTF-8 Support
@@ -25,101 +108,35 @@ std::string Lexer::readUtf8Char() {
     return result;
 }
 
-// Try to read an operator alias (for multi-byte UTF-8 operators like Chinese)
-bool Lexer::tryReadOperatorAlias(std::vector<Token>& tokens) {
-    if (!aliasMap || !aliasMap->isLoaded()) return false;
-    
-    const auto& opAliases = aliasMap->getOperatorAliases();
-    if (opAliases.empty()) return false;
-    
-    // Check current position for UTF-8 operator aliases
-    // Try to match the longest possible alias first
-    size_t maxLen = 0;
-    std::string matchedAlias;
-    std::string mappedOp;
-    
-    for (const auto& [alias, op] : opAliases) {
-        if (alias.length() > maxLen && 
-            pos + alias.length() <= source.length() &&
-            source.substr(pos, alias.length()) == alias) {
-            maxLen = alias.length();
-            matchedAlias = alias;
-            mappedOp = op;
+// Find an operator alias at the current position (longest or shortest match)
+const Lexer::OperatorAlias* Lexer::matchOperatorAlias(bool longest) const {
+    unsigned char c = static_cast<unsigned char>(source[pos]);
+    const OperatorAlias* match = nullptr;
+    for (uint32_t i = aliasIndex[c]; i < aliasIndex[c + 1]; i++) {
+        const OperatorAlias& alias = operatorAliases[i];
+        if (source.compare(pos, alias.text.size(), alias.text) == 0) {
+            match = &alias;
+            if (longest) break;
         }
     }
+    return match;
+}
+
+// Try to read an operator alias (for multi-byte UTF-8 operators like Chinese)
+bool Lexer::tryReadOperatorAlias(std::vector<Token>& tokens) {
+    if (operatorAliases.empty()) return false;
     
-    if (maxLen == 0) return false;
+    const OperatorAlias* match = matchOperatorAlias(true);
+    if (!match) return false;
     
     int startCol = column;
     
     // Advance past the alias
-    for (size_t i = 0; i < maxLen; i++) {
+    for (size_t i = 0; i < match->text.size(); i++) {
         advance();
     }
     
-    // Map the operator to its token type
-    // Single character operators
-    if (mappedOp == "+") {
-        tokens.push_back(Token(TokenType::TK_PLUS, "+", line, startCol));
-    } else if (mappedOp == "-") {
-        tokens.push_back(Token(TokenType::TK_MINUS, "-", line, startCol));
-    } else if (mappedOp == "*") {
-        tokens.push_back(Token(TokenType::TK_STAR, "*", line, startCol));
-    } else if (mappedOp == "/") {
-        tokens.push_back(Token(TokenType::TK_SLASH, "/", line, startCol));
-    } else if (mappedOp == "%") {
-        tokens.push_back(Token(TokenType::TK_PERCENT, "%", line, startCol));
-    } else if (mappedOp == "**") {
-        tokens.push_back(Token(TokenType::TK_POWER, "**", line, startCol));
-    } else if (mappedOp == "=") {
-        tokens.push_back(Token(TokenType::TK_ASSIGN, "=", line, startCol));
-    } else if (mappedOp == "==") {
-        tokens.push_back(Token(TokenType::TK_EQ, "==", line, startCol));
-    } else if (mappedOp == "!=") {
-        tokens.push_back(Token(TokenType::TK_NE, "!=", line, startCol));
-    } else if (mappedOp == "<") {
-        tokens.push_back(Token(TokenType::TK_LT, "<", line, startCol));
-    } else if (mappedOp == ">") {
-        tokens.push_back(Token(TokenType::TK_GT, ">", line, startCol));
-    } else if (mappedOp == "<=") {
-        tokens.push_back(Token(TokenType::TK_LE, "<=", line, startCol));
-    } else if (mappedOp == ">=") {
-        tokens.push_back(Token(TokenType::TK_GE, ">=", line, startCol));
-    } else if (mappedOp == "(") {
-        tokens.push_back(Token(TokenType::TK_LPAREN, "(", line, startCol));
-    } else if (mappedOp == ")") {
-        tokens.push_back(Token(TokenType::TK_RPAREN, ")", line, startCol));
-    } else if (mappedOp == "[") {
-        tokens.push_back(Token(TokenType::TK_LBRACKET, "[", line, startCol));
-    } else if (mappedOp == "]") {
-        tokens.push_back(Token(TokenType::TK_RBRACKET, "]", line, startCol));
-    } else if (mappedOp == "{") {
-        tokens.push_back(Token(TokenType::TK_LBRACE, "{", line, startCol));
-    } else if (mappedOp == "}") {
-        tokens.push_back(Token(TokenType::TK_RBRACE, "}", line, startCol));
-    } else if (mappedOp == ",") {
-        tokens.push_back(Token(TokenType::TK_COMMA, ",", line, startCol));
-    } else if (mappedOp == ":") {
-        tokens.push_back(Token(TokenType::TK_COLON, ":", line, startCol));
-    } else if (mappedOp == ".") {
-        tokens.push_back(Token(TokenType::TK_DOT, ".", line, startCol));
-    } else if (mappedOp == "&") {
-        tokens.push_back(Token(TokenType::TK_BIT_AND, "&", line, startCol));
-    } else if (mappedOp == "|") {
-        tokens.push_back(Token(TokenType::TK_BIT_OR, "|", line, startCol));
-    } else if (mappedOp == "^") {
-        tokens.push_back(Token(TokenType::TK_BIT_XOR, "^", line, startCol));
-    } else if (mappedOp == "~") {
-        tokens.push_back(Token(TokenType::TK_BIT_NOT, "~", line, startCol));
-    } else if (mappedOp == "<<") {
-        tokens.push_back(Token(TokenType::TK_LSHIFT, "<<", line, startCol));
-    } else if (mappedOp == ">>") {
-        tokens.push_back(Token(TokenType::TK_RSHIFT, ">>", line, startCol));
-    } else {
-        // Unknown operator, return false
-        return false;
-    }
-    
+    tokens.push_back(Token(match->type, match->op, line, startCol));
     return true;
 }
 
@@ -146,16 +163,19 @@ void Lexer::advance() {
 }
 
 void Lexer::skipWhitespace() {
-    while (current() == ' ' || current() == '\t' || current() == '\r') {
-        advance();
+    while (pos < source.length() && hasClass(source[pos], CC_SPACE)) {
+        pos++;
+        column++;
     }
 }
 
 void Lexer::skipComment() {
     if (current() == '#') {
-        while (current() != '\n' && current() != '\0') {
-            advance();
+        size_t start = pos;
+        while (pos < source.length() && source[pos] != '\n' && source[pos] != '\0') {
+            pos++;
         }
+        column += (int)(pos - start);
     }
 }
 
@@ -166,32 +186,24 @@ Token Lexer::readMultiLineString(char quote) {
     // Skip opening """ or '''
     advance(); advance(); advance();
     
-    std::string str;
+    size_t start = pos;
     while (current() != '\0') {
         if (current() == quote && peek(1) == quote && peek(2) == quote) {
+            std::string_view str = source.substr(start, pos - start);
             advance(); advance(); advance();
             return Token(TokenType::TK_STRING, str, startLine, startCol);
         }
-        // Handle newlines - track line numbers
-        if (current() == '\n') {
-            str += '\n';
-            line++;
-            column = 0;
-        } else {
-            str += current();
-        }
-        advance();
+        advance();  // Tracks line numbers across newlines
     }
     throw LexerError("Unterminated multi-line string", startLine, startCol);
 }
 
-Token Lexer::makeToken(TokenType type, const std::string& value) {
+Token Lexer::makeToken(TokenType type, std::string_view value) {
     return Token(type, value, line, column);
 }
 
 Token Lexer::readNumber() {
     int startCol = column;
-    std::string num;
     bool isFloat = false;
     
     // Check for hex (0x), binary (0b), or octal (0o) prefix
@@ -200,7 +212,7 @@ Token Lexer::readNumber() {
         advance(); // skip '0'
         advance(); // skip 'x'
         int64_t value = 0;
-        while (std::isxdigit(current())) {
+        while (hasClass(current(), CC_HEX)) {
             char c = current();
             int digit;
             if (c >= '0' && c <= '9') digit = c - '0';
@@ -209,7 +221,7 @@ Token Lexer::readNumber() {
             value = value * 16 + digit;
             advance();
         }
-        return Token(TokenType::TK_INTEGER, std::to_string(value), line, startCol);
+        return Token(TokenType::TK_INTEGER, keepText(std::to_string(value)), line, startCol);
     }
     
     if (current() == '0' && (peek() == 'b' || peek() == 'B')) {
@@ -221,7 +233,7 @@ Token Lexer::readNumber() {
             value = value * 2 + (current() - '0');
             advance();
         }
-        return Token(TokenType::TK_INTEGER, std::to_string(value), line, startCol);
+        return Token(TokenType::TK_INTEGER, keepText(std::to_string(value)), line, startCol);
     }
     
     if (current() == '0' && (peek() == 'o' || peek() == 'O')) {
@@ -233,26 +245,26 @@ Token Lexer::readNumber() {
             value = value * 8 + (current() - '0');
             advance();
         }
-        return Token(TokenType::TK_INTEGER, std::to_string(value), line, startCol);
+        return Token(TokenType::TK_INTEGER, keepText(std::to_string(value)), line, startCol);
     }
     
     // Regular decimal number
-    while (std::isdigit(current())) {
-        num += current();
-        advance();
+    size_t start = pos;
+    while (hasClass(current(), CC_DIGIT)) {
+        pos++;
     }
     
-    if (current() == '.' && std::isdigit(peek())) {
+    if (current() == '.' && hasClass(peek(), CC_DIGIT)) {
         isFloat = true;
-        num += current();
-        advance();
-        while (std::isdigit(current())) {
-            num += current();
-            advance();
+        pos++;
+        while (hasClass(current(), CC_DIGIT)) {
+            pos++;
         }
     }
+    column += (int)(pos - start);
     
-    return Token(isFloat ? TokenType::TK_FLOAT : TokenType::TK_INTEGER, num, line, startCol);
+    return Token(isFloat ? TokenType::TK_FLOAT : TokenType::TK_INTEGER,
+                 source.substr(start, pos - start), line, startCol);
 }
 
 Token Lexer::readString() {
@@ -260,23 +272,43 @@ Token Lexer::readString() {
     char quote = current();
     advance(); // skip opening quote
     
-    std::string str;
-    while (current() != quote && current() != '\0') {
-        if (current() == '\\') {
-            advance();
-            switch (current()) {
-                case 'n': str += '\n'; break;
-                case 't': str += '\t'; break;
-                case 'r': str += '\r'; break;
-                case '\\': str += '\\'; break;
-                case '"': str += '"'; break;
-                case '\'': str += '\''; break;
-                default: str += current(); break;
-            }
+    // Strings without escapes are returned as a view of the source
+    size_t start = pos;
+    while (pos < source.length()) {
+        char c = source[pos];
+        if (c == quote || c == '\\' || c == '\0') break;
+        if (c == '\n') {
+            line++;
+            column = 1;
         } else {
-            str += current();
+            column++;
         }
-        advance();
+        pos++;
+    }
+    
+    std::string_view value;
+    if (current() == '\\') {
+        std::string str(source.substr(start, pos - start));
+        while (current() != quote && current() != '\0') {
+            if (current() == '\\') {
+                advance();
+                switch (current()) {
+                    case 'n': str += '\n'; break;
+                    case 't': str += '\t'; break;
+                    case 'r': str += '\r'; break;
+                    case '\\': str += '\\'; break;
+                    case '"': str += '"'; break;
+                    case '\'': str += '\''; break;
+                    default: str += current(); break;
+                }
+            } else {
+                str += current();
+            }
+            advance();
+        }
+        value = keepText(std::move(str));
+    } else {
+        value = source.substr(start, pos - start);
     }
     
     if (current() != quote) {
@@ -284,89 +316,83 @@ Token Lexer::readString() {
     }
     advance(); // skip closing quote
     
-    return Token(TokenType::TK_STRING, str, line, startCol);
+    return Token(TokenType::TK_STRING, value, line, startCol);
 }
 
 Token Lexer::readIdentifier() {
     int startCol = column;
-    std::string id;
+    size_t start = pos;
     
     // Support UTF-8 multi-byte characters (e.g., Chinese identifiers)
     while (pos < source.length()) {
-        unsigned char c = static_cast<unsigned char>(current());
+        unsigned char c = static_cast<unsigned char>(source[pos]);
         
         // ASCII alphanumeric or underscore
-        if (std::isalnum(c) || c == '_') {
-            id += current();
-            advance();
+        if (c < 0x80) {
+            if (!hasClass(c, CC_IDENT_REST)) break;
+            pos++;
+            column++;
+            continue;
         }
+        
         // UTF-8 multi-byte character start
-        else if ((c & 0x80) != 0) {
-            // First, read the UTF-8 character to see what it is
-            int len = getUtf8CharLength(c);
-            std::string utf8Char;
-            for (int i = 0; i < len && pos + i < source.length(); i++) {
-                utf8Char += source[pos + i];
-            }
+        int len = getUtf8CharLength(c);
+        
+        // Check if this is a punctuation-type operator alias (parentheses, brackets, colon, etc.)
+        // These should break identifier reading, but word-type operators (e.g. mul, add) should not
+        if (!operatorAliases.empty()) {
+            const OperatorAlias* alias = matchOperatorAlias(false);
             
-            // Check if this is a punctuation-type operator alias (parentheses, brackets, colon, etc.)
-            // These should break identifier reading, but word-type operators (e.g. mul, add) should not
-            if (aliasMap && aliasMap->isLoaded()) {
-                std::string mappedOp;
-                for (const auto& [alias, op] : aliasMap->getOperatorAliases()) {
-                    if (pos + alias.length() <= source.length() &&
-                        source.substr(pos, alias.length()) == alias) {
-                        mappedOp = op;
-                        break;
-                    }
+            // Only break for punctuation-type operators: ( ) [ ] { } : , .
+            // These are unlikely to be part of a valid identifier
+            if (alias && alias->op.size() == 1 && strchr("()[]{}:,.", alias->op[0])) {
+                // But first check if this could be part of a keyword alias
+                size_t charLen = std::min((size_t)len, source.length() - pos);
+                std::string potentialKeyword(source.substr(start, pos - start + charLen));
+                if (!aliasMap->isKeywordAliasPrefix(potentialKeyword)) {
+                    break;  // Stop reading identifier for punctuation operators
                 }
-                
-                // Only break for punctuation-type operators: ( ) [ ] { } : , .
-                // These are unlikely to be part of a valid identifier
-                if (!mappedOp.empty() && 
-                    (mappedOp == "(" || mappedOp == ")" || mappedOp == "[" || mappedOp == "]" ||
-                     mappedOp == "{" || mappedOp == "}" || mappedOp == ":" || mappedOp == "," || mappedOp == ".")) {
-                    // But first check if this could be part of a keyword alias
-                    std::string potentialKeyword = id + utf8Char;
-                    if (!aliasMap->isKeywordAliasPrefix(potentialKeyword)) {
-                        break;  // Stop reading identifier for punctuation operators
-                    }
-                }
-                // For word-type operators like mul, add, sub, etc., continue reading as identifier
-                // They will be handled separately when they appear with spaces around them
-            }
-            
-            // Add UTF-8 character to identifier
-            for (int i = 0; i < len && pos < source.length(); i++) {
-                id += source[pos];
-                pos++;
             }
-            column++;  // Count UTF-8 char as single column
-        }
-        else {
-            break;
+            // For word-type operators like mul, add, sub, etc., continue reading as identifier
+            // They will be handled separately when they appear with spaces around them
         }
+        
+        // Add UTF-8 character to identifier
+        pos = std::min(pos + len, source.length());
+        column++;  // Count UTF-8 char as single column
     }
     
-    // Apply keyword alias mapping if available
-    std::string mappedId = id;
-    if (aliasMap && aliasMap->isLoaded()) {
-        mappedId = aliasMap->mapKeyword(id);
+    std::string_view id = source.substr(start, pos - start);
+    
+    // Fast path: no alias configuration
+    if (!aliasMap) {
+        auto it = keywords.find(id);
+        if (it != keywords.end()) {
+            return Token(it->second, it->first, line, startCol);
+        }
+        return Token(TokenType::TK_IDENTIFIER, id, line, startCol);
     }
     
+    // Apply keyword alias mapping
+    std::string idStr(id);
+    std::string mappedId = aliasMap->mapKeyword(idStr);
+    
     // Check if it's a standard keyword
     auto it = keywords.find(mappedId);
     if (it != keywords.end()) {
-        return Token(it->second, mappedId, line, startCol);
+        return Token(it->second, it->first, line, startCol);
     }
     
     // Also map builtin function names for identifier tokens
     // (builtin mapping is primarily handled at codegen, but we can store mapped name)
-    if (aliasMap && aliasMap->isLoaded() && aliasMap->hasBuiltinAlias(id)) {
-        mappedId = aliasMap->mapBuiltin(id);
+    if (aliasMap->hasBuiltinAlias(idStr)) {
+        mappedId = aliasMap->mapBuiltin(idStr);
     }
     
-    return Token(TokenType::TK_IDENTIFIER, mappedId, line, startCol);
+    if (mappedId == id) {
+        return Token(TokenType::TK_IDENTIFIER, id, line, startCol);
+    }
+    return Token(TokenType::TK_IDENTIFIER, keepText(std::move(mappedId)), line, startCol);
 }
 
 std::vector<Token> Lexer::tokenize() {
@@ -401,7 +427,7 @@ std::vector<Token> Lexer::tokenize() {
         }
         
         // Number
-        if (std::isdigit(current())) {
+        if (hasClass(current(), CC_DIGIT)) {
             tokens.push_back(readNumber());
             continue;
         }
@@ -420,8 +446,7 @@ std::vector<Token> Lexer::tokenize() {
         
         // Identifier and keyword (supports UTF-8 multi-byte characters)
         // Check for ASCII alpha, underscore, or UTF-8 start byte
-        unsigned char c = static_cast<unsigned char>(current());
-        if (std::isalpha(c) || c == '_' || (c & 0x80) != 0) {
+        if (hasClass(current(), CC_IDENT)) {
             tokens.push_back(readIdentifier());
             continue;
         }
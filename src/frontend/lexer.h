@@ -3,8 +3,11 @@
 
 #include "token.h"
 #include "alias_loader.h"
+#include <cstdint>
+#include <deque>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <stdexcept>
 
 class LexerError : public std::runtime_error {
@@ -16,14 +19,15 @@ public:
 
 class Lexer {
 public:
-    explicit Lexer(const std::string& source);
+    // The source is not copied; it must outlive the lexer and its tokens
+    explicit Lexer(std::string_view source);
     std::vector<Token> tokenize();
     
     // Set alias map for keyword/operator aliasing (e.g., Chinese keywords)
-    void setAliasMap(const AliasMap* map) { aliasMap = map; }
+    void setAliasMap(const AliasMap* map);
     
 private:
-    std::string source;
+    std::string_view source;
     size_t pos = 0;
     int line = 1;
     int column = 1;
@@ -31,6 +35,18 @@ private:
     // Alias map for custom keyword/operator mappings
     const AliasMap* aliasMap = nullptr;
     
+    // Operator aliases grouped by first byte, longest first within a group
+    struct OperatorAlias {
+        std::string_view text;
+        std::string_view op;
+        TokenType type;
+    };
+    std::vector<OperatorAlias> operatorAliases;
+    uint32_t aliasIndex[257] = {};
+    
+    // Text of tokens that differs from the source (escapes, mapped aliases)
+    std::deque<std::string> ownedText;
+    
     char current() const;
     char peek(int offset = 1) const;
     void advance();
@@ -41,11 +57,13 @@ private:
     Token readNumber();
     Token readString();
     Token readIdentifier();
-    Token makeToken(TokenType type, const std::string& value = "");
+    Token makeToken(TokenType type, std::string_view value = {});
+    std::string_view keepText(std::string text);
     
     // UTF-8 support
     std::string readUtf8Char();                  // Read a complete UTF-8 character
     bool tryReadOperatorAlias(std::vector<Token>& tokens);  // Try to read an operator alias
+    const OperatorAlias* matchOperatorAlias(bool longest) const;
 };
 
 #endif // LEXER_H
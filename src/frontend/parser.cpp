@@ -1,13 +1,36 @@
 #include "parser.h"
 #include <sstream>
 
-Parser::Parser(const std::vector<Token>& tokens) : tokens(tokens) {}
+Parser::Parser(const std::vector<Token>& tokens)
+    : tokens(tokens), arena(new AstArena()), symbols(new SymbolTable()) {}
 
-Token& Parser::peek() {
+// Static spelling of an operator token, stored in BinaryExpr/UnaryExpr::op
+static std::string_view operatorText(TokenType type) {
+    switch (type) {
+        case TokenType::TK_PLUS: return "+";
+        case TokenType::TK_MINUS: return "-";
+        case TokenType::TK_STAR: return "*";
+        case TokenType::TK_SLASH: return "/";
+        case TokenType::TK_PERCENT: return "%";
+        case TokenType::TK_EQ: return "==";
+        case TokenType::TK_NE: return "!=";
+        case TokenType::TK_LT: return "<";
+        case TokenType::TK_LE: return "<=";
+        case TokenType::TK_GT: return ">";
+        case TokenType::TK_GE: return ">=";
+        case TokenType::TK_LSHIFT: return "<<";
+        case TokenType::TK_RSHIFT: return ">>";
+        case TokenType::TK_NOT: return "not";
+        case TokenType::TK_BIT_NOT: return "~";
+        default: return "";
+    }
+}
+
+const Token& Parser::peek() {
     return tokens[current];
 }
 
-Token& Parser::previous() {
+const Token& Parser::previous() {
     return tokens[current - 1];
 }
 
@@ -38,12 +61,12 @@ bool Parser::match(std::initializer_list<TokenType> types) {
     return false;
 }
 
-Token& Parser::advance() {
+const Token& Parser::advance() {
     if (!isAtEnd()) current++;
     return previous();
 }
 
-Token& Parser::consume(TokenType type, const std::string& message) {
+const Token& Parser::consume(TokenType type, const std::string& message) {
     if (check(type)) return advance();
     throw ParseError(message, peek().line, peek().column);
 }
@@ -103,6 +126,8 @@ Program Parser::parse() {
         skipNewlines();
     }
     
+    program.arena = std::move(arena);
+    program.symbols = std::move(symbols);
     return program;
 }
 
@@ -130,12 +155,12 @@ StmtPtr Parser::parseStatement() {
     if (match(TokenType::TK_BREAK)) {
         int line = previous().line;
         expectNewlineOrEnd();
-        return std::make_shared<Statement>(BreakStmt{}, line);
+        return arena->stmt(BreakStmt{}, line);
     }
     if (match(TokenType::TK_CONTINUE)) {
         int line = previous().line;
         expectNewlineOrEnd();
-        return std::make_shared<Statement>(ContinueStmt{}, line);
+        return arena->stmt(ContinueStmt{}, line);
     }
     if (check(TokenType::TK_MOON)) return parseMoonStatement();
     if (check(TokenType::TK_GLOBAL)) return parseGlobalStatement();
@@ -192,7 +217,7 @@ StmtPtr Parser::parseIfStatement() {
     }
     expectNewlineOrEnd();
     
-    return std::make_shared<Statement>(IfStmt{condition, thenBranch, elifBranches, elseBranch}, line);
+    return arena->stmt(IfStmt{condition, thenBranch, elifBranches, elseBranch}, line);
 }
 
 StmtPtr Parser::parseWhileStatement() {
@@ -213,7 +238,7 @@ StmtPtr Parser::parseWhileStatement() {
     }
     expectNewlineOrEnd();
     
-    return std::make_shared<Statement>(WhileStmt{condition, body}, line);
+    return arena->stmt(WhileStmt{condition, body}, line);
 }
 
 StmtPtr Parser::parseForStatement() {
@@ -221,7 +246,7 @@ StmtPtr Parser::parseForStatement() {
     consume(TokenType::TK_FOR, "Expected 'for'");
     
     Token varToken = consume(TokenType::TK_IDENTIFIER, "Expected variable name");
-    std::string varName = varToken.value;
+    std::string varName(varToken.value);
     
     if (match(TokenType::TK_IN)) {
         // for x in list:
@@ -237,7 +262,7 @@ StmtPtr Parser::parseForStatement() {
             consume(TokenType::TK_END, "Expected 'end' after for statement");
         }
         expectNewlineOrEnd();
-        return std::make_shared<Statement>(ForInStmt{varName, iterable, body}, line);
+        return arena->stmt(ForInStmt{varName, iterable, body}, line);
     } else if (match(TokenType::TK_ASSIGN)) {
         // for i = 1 to 10:
         ExprPtr start = parseExpression();
@@ -254,7 +279,7 @@ StmtPtr Parser::parseForStatement() {
             consume(TokenType::TK_END, "Expected 'end' after for statement");
         }
         expectNewlineOrEnd();
-        return std::make_shared<Statement>(ForRangeStmt{varName, start, endExpr, body}, line);
+        return arena->stmt(ForRangeStmt{varName, start, endExpr, body}, line);
     }
     
     throw ParseError("Expected 'in' or '=' in for statement", peek().line, peek().column);
@@ -284,7 +309,7 @@ StmtPtr Parser::parseFuncDeclaration(bool isExported) {
             } else if (hadDefault) {
                 throw ParseError("Non-default parameter cannot follow default parameter", param.line, param.column);
             }
-            params.push_back(Parameter{param.value, defaultVal});
+            params.push_back(Parameter{std::string(param.value), defaultVal});
         } while (match(TokenType::TK_COMMA));
     }
     consume(TokenType::TK_RPAREN, "Expected ')' after parameters");
@@ -301,8 +326,8 @@ StmtPtr Parser::parseFuncDeclaration(bool isExported) {
     }
     expectNewlineOrEnd();
     
-    FuncDecl funcDecl{nameToken.value, params, body, isExported};
-    return std::make_shared<Statement>(funcDecl, line);
+    FuncDecl funcDecl{std::string(nameToken.value), params, body, isExported, symbols->intern(nameToken.value)};
+    return arena->stmt(funcDecl, line);
 }
 
 StmtPtr Parser::parseReturnStatement() {
@@ -315,7 +340,7 @@ StmtPtr Parser::parseReturnStatement() {
     }
     expectNewlineOrEnd();
     
-    return std::make_shared<Statement>(ReturnStmt{value}, line);
+    return arena->stmt(ReturnStmt{value}, line);
 }
 
 StmtPtr Parser::parseTryStatement() {
@@ -345,7 +370,7 @@ StmtPtr Parser::parseTryStatement() {
     }
     expectNewlineOrEnd();
     
-    return std::make_shared<Statement>(TryStmt{tryBody, errorVar.value, catchBody}, line);
+    return arena->stmt(TryStmt{tryBody, std::string(errorVar.value), catchBody}, line);
 }
 
 StmtPtr Parser::parseThrowStatement() {
@@ -355,7 +380,7 @@ StmtPtr Parser::parseThrowStatement() {
     ExprPtr value = parseExpression();
     expectNewlineOrEnd();
     
-    return std::make_shared<Statement>(ThrowStmt{value}, line);
+    return arena->stmt(ThrowStmt{value}, line);
 }
 
 StmtPtr Parser::parseClassDeclaration() {
@@ -363,7 +388,7 @@ StmtPtr Parser::parseClassDeclaration() {
     consume(TokenType::TK_CLASS, "Expected 'class'");
     
     Token nameToken = consume(TokenType::TK_IDENTIFIER, "Expected class name");
-    std::string className = nameToken.value;
+    std::string className(nameToken.value);
     std::string parentName = "";
     
     // Check inheritance
@@ -403,7 +428,7 @@ StmtPtr Parser::parseClassDeclaration() {
                     } else if (hadDefault) {
                         throw ParseError("Non-default parameter cannot follow default parameter", param.line, param.column);
                     }
-                    params.push_back(Parameter{param.value, defaultVal});
+                    params.push_back(Parameter{std::string(param.value), defaultVal});
                 } while (match(TokenType::TK_COMMA));
             }
             consume(TokenType::TK_RPAREN, "Expected ')' after parameters");
@@ -420,7 +445,7 @@ StmtPtr Parser::parseClassDeclaration() {
             }
             skipNewlines();
             
-            methods.push_back(MethodDecl{methodName.value, params, body, isStatic});
+            methods.push_back(MethodDecl{std::string(methodName.value), params, body, isStatic});
         } else {
             skipNewlines();
             if (check(TokenType::TK_END) || check(TokenType::TK_RBRACE)) break;
@@ -435,7 +460,8 @@ StmtPtr Parser::parseClassDeclaration() {
     }
     expectNewlineOrEnd();
     
-    return std::make_shared<Statement>(ClassDecl{className, parentName, methods}, line);
+    return arena->stmt(ClassDecl{className, parentName, methods, symbols->intern(className),
+                                 parentName.empty() ? NO_SYMBOL : symbols->intern(parentName)}, line);
 }
 
 StmtPtr Parser::parseImportStatement() {
@@ -509,7 +535,7 @@ StmtPtr Parser::parseImportStatement() {
     }
     
     expectNewlineOrEnd();
-    return std::make_shared<Statement>(stmt, line);
+    return arena->stmt(stmt, line);
 }
 
 StmtPtr Parser::parseSwitchStatement() {
@@ -560,7 +586,7 @@ StmtPtr Parser::parseSwitchStatement() {
     consume(TokenType::TK_END, "Expected 'end' after switch statement");
     expectNewlineOrEnd();
     
-    return std::make_shared<Statement>(SwitchStmt{value, cases, defaultBody}, line);
+    return arena->stmt(SwitchStmt{value, cases, defaultBody}, line);
 }
 
 std::vector<StmtPtr> Parser::parseTryBlock() {
@@ -586,17 +612,17 @@ StmtPtr Parser::parseMoonStatement() {
     if (std::holds_alternative<CallExpr>(expr->value)) {
         // Direct function call: moon myFunc(args)
         expectNewlineOrEnd();
-        return std::make_shared<Statement>(MoonStmt{expr}, line);
+        return arena->stmt(MoonStmt{expr}, line);
     }
     else if (std::holds_alternative<LambdaExpr>(expr->value)) {
         // Lambda expression: moon (() => doSomething())
         // Auto-wrap in a call expression (IIFE)
-        auto callExpr = std::make_shared<Expression>(
+        auto callExpr = arena->expr(
             CallExpr{expr, {}},  // Call lambda with no args
             line
         );
         expectNewlineOrEnd();
-        return std::make_shared<Statement>(MoonStmt{callExpr}, line);
+        return arena->stmt(MoonStmt{callExpr}, line);
     }
     else {
         throw ParseError("'moon' must be followed by a function call or lambda expression", line, 0);
@@ -610,17 +636,17 @@ StmtPtr Parser::parseGlobalStatement() {
     std::vector<std::string> names;
     
     // Parse first variable name
-    Token& first = consume(TokenType::TK_IDENTIFIER, "Expected variable name after 'global'");
-    names.push_back(first.value);
+    const Token& first = consume(TokenType::TK_IDENTIFIER, "Expected variable name after 'global'");
+    names.push_back(std::string(first.value));
     
     // Parse additional variable names separated by commas
     while (match(TokenType::TK_COMMA)) {
-        Token& name = consume(TokenType::TK_IDENTIFIER, "Expected variable name after ','");
-        names.push_back(name.value);
+        const Token& name = consume(TokenType::TK_IDENTIFIER, "Expected variable name after ','");
+        names.push_back(std::string(name.value));
     }
     
     expectNewlineOrEnd();
-    return std::make_shared<Statement>(GlobalStmt{names}, line);
+    return arena->stmt(GlobalStmt{names}, line);
 }
 
 StmtPtr Parser::parseExpressionStatement() {
@@ -631,11 +657,11 @@ StmtPtr Parser::parseExpressionStatement() {
     if (match(TokenType::TK_ASSIGN)) {
         ExprPtr value = parseExpression();
         expectNewlineOrEnd();
-        return std::make_shared<Statement>(AssignStmt{expr, value}, line);
+        return arena->stmt(AssignStmt{expr, value}, line);
     }
     
     // Check for compound assignment operators (+=, -=, *=, /=, %=)
-    std::string compoundOp;
+    std::string_view compoundOp;
     if (match(TokenType::TK_PLUS_EQ)) {
         compoundOp = "+";
     } else if (match(TokenType::TK_MINUS_EQ)) {
@@ -651,20 +677,20 @@ StmtPtr Parser::parseExpressionStatement() {
     if (!compoundOp.empty()) {
         // Convert x += y to x = x + y
         ExprPtr value = parseExpression();
-        ExprPtr binExpr = std::make_shared<Expression>(BinaryExpr{compoundOp, expr, value}, line);
+        ExprPtr binExpr = arena->expr(BinaryExpr{compoundOp, expr, value}, line);
         expectNewlineOrEnd();
-        return std::make_shared<Statement>(AssignStmt{expr, binExpr}, line);
+        return arena->stmt(AssignStmt{expr, binExpr}, line);
     }
     
     // Check if it's channel send: ch <- value
     if (match(TokenType::TK_CHAN_ARROW)) {
         ExprPtr value = parseExpression();
         expectNewlineOrEnd();
-        return std::make_shared<Statement>(ChanSendStmt{expr, value}, line);
+        return arena->stmt(ChanSendStmt{expr, value}, line);
     }
     
     expectNewlineOrEnd();
-    return std::make_shared<Statement>(ExpressionStmt{expr}, line);
+    return arena->stmt(ExpressionStmt{expr}, line);
 }
 
 std::vector<StmtPtr> Parser::parseBlock() {
@@ -692,7 +718,7 @@ ExprPtr Parser::parseOr() {
     while (match(TokenType::TK_OR)) {
         int line = previous().line;
         ExprPtr right = parseAnd();
-        left = std::make_shared<Expression>(BinaryExpr{"or", left, right}, line);
+        left = arena->expr(BinaryExpr{"or", left, right}, line);
     }
     
     return left;
@@ -704,7 +730,7 @@ ExprPtr Parser::parseAnd() {
     while (match(TokenType::TK_AND)) {
         int line = previous().line;
         ExprPtr right = parseBitOr();
-        left = std::make_shared<Expression>(BinaryExpr{"and", left, right}, line);
+        left = arena->expr(BinaryExpr{"and", left, right}, line);
     }
     
     return left;
@@ -716,7 +742,7 @@ ExprPtr Parser::parseBitOr() {
     while (match(TokenType::TK_BIT_OR)) {
         int line = previous().line;
         ExprPtr right = parseBitXor();
-        left = std::make_shared<Expression>(BinaryExpr{"|", left, right}, line);
+        left = arena->expr(BinaryExpr{"|", left, right}, line);
     }
     
     return left;
@@ -728,7 +754,7 @@ ExprPtr Parser::parseBitXor() {
     while (match(TokenType::TK_BIT_XOR)) {
         int line = previous().line;
         ExprPtr right = parseBitAnd();
-        left = std::make_shared<Expression>(BinaryExpr{"^", left, right}, line);
+        left = arena->expr(BinaryExpr{"^", left, right}, line);
     }
     
     return left;
@@ -740,7 +766,7 @@ ExprPtr Parser::parseBitAnd() {
     while (match(TokenType::TK_BIT_AND)) {
         int line = previous().line;
         ExprPtr right = parseEquality();
-        left = std::make_shared<Expression>(BinaryExpr{"&", left, right}, line);
+        left = arena->expr(BinaryExpr{"&", left, right}, line);
     }
     
     return left;
@@ -750,10 +776,10 @@ ExprPtr Parser::parseEquality() {
     ExprPtr left = parseComparison();
     
     while (match({TokenType::TK_EQ, TokenType::TK_NE})) {
-        std::string op = previous().value;
+        std::string_view op = operatorText(previous().type);
         int line = previous().line;
         ExprPtr right = parseComparison();
-        left = std::make_shared<Expression>(BinaryExpr{op, left, right}, line);
+        left = arena->expr(BinaryExpr{op, left, right}, line);
     }
     
     return left;
@@ -763,10 +789,10 @@ ExprPtr Parser::parseComparison() {
     ExprPtr left = parseShift();
     
     while (match({TokenType::TK_LT, TokenType::TK_LE, TokenType::TK_GT, TokenType::TK_GE})) {
-        std::string op = previous().value;
+        std::string_view op = operatorText(previous().type);
         int line = previous().line;
         ExprPtr right = parseShift();
-        left = std::make_shared<Expression>(BinaryExpr{op, left, right}, line);
+        left = arena->expr(BinaryExpr{op, left, right}, line);
     }
     
     return left;
@@ -776,10 +802,10 @@ ExprPtr Parser::parseShift() {
     ExprPtr left = parseTerm();
     
     while (match({TokenType::TK_LSHIFT, TokenType::TK_RSHIFT})) {
-        std::string op = previous().value;
+        std::string_view op = operatorText(previous().type);
         int line = previous().line;
         ExprPtr right = parseTerm();
-        left = std::make_shared<Expression>(BinaryExpr{op, left, right}, line);
+        left = arena->expr(BinaryExpr{op, left, right}, line);
     }
     
     return left;
@@ -789,10 +815,10 @@ ExprPtr Parser::parseTerm() {
     ExprPtr left = parseFactor();
     
     while (match({TokenType::TK_PLUS, TokenType::TK_MINUS})) {
-        std::string op = previous().value;
+        std::string_view op = operatorText(previous().type);
         int line = previous().line;
         ExprPtr right = parseFactor();
-        left = std::make_shared<Expression>(BinaryExpr{op, left, right}, line);
+        left = arena->expr(BinaryExpr{op, left, right}, line);
     }
     
     return left;
@@ -802,10 +828,10 @@ ExprPtr Parser::parseFactor() {
     ExprPtr left = parsePower();
     
     while (match({TokenType::TK_STAR, TokenType::TK_SLASH, TokenType::TK_PERCENT})) {
-        std::string op = previous().value;
+        std::string_view op = operatorText(previous().type);
         int line = previous().line;
         ExprPtr right = parsePower();
-        left = std::make_shared<Expression>(BinaryExpr{op, left, right}, line);
+        left = arena->expr(BinaryExpr{op, left, right}, line);
     }
     
     return left;
@@ -818,7 +844,7 @@ ExprPtr Parser::parsePower() {
     if (match(TokenType::TK_POWER)) {
         int line = previous().line;
         ExprPtr right = parsePower();  // Right-associative
-        left = std::make_shared<Expression>(BinaryExpr{"**", left, right}, line);
+        left = arena->expr(BinaryExpr{"**", left, right}, line);
     }
     
     return left;
@@ -826,17 +852,17 @@ ExprPtr Parser::parsePower() {
 
 ExprPtr Parser::parseUnary() {
     if (match({TokenType::TK_MINUS, TokenType::TK_NOT, TokenType::TK_BIT_NOT})) {
-        std::string op = previous().value;
+        std::string_view op = operatorText(previous().type);
         int line = previous().line;
         ExprPtr operand = parseUnary();
-        return std::make_shared<Expression>(UnaryExpr{op, operand}, line);
+        return arena->expr(UnaryExpr{op, operand}, line);
     }
     
     // Channel receive: <- ch
     if (match(TokenType::TK_CHAN_ARROW)) {
         int line = previous().line;
         ExprPtr channel = parseUnary();
-        return std::make_shared<Expression>(ChanRecvExpr{channel}, line);
+        return arena->expr(ChanRecvExpr{channel}, line);
     }
     
     return parsePostfix();
@@ -856,18 +882,18 @@ ExprPtr Parser::parsePostfix() {
                 } while (match(TokenType::TK_COMMA));
             }
             consume(TokenType::TK_RPAREN, "Expected ')' after arguments");
-            expr = std::make_shared<Expression>(CallExpr{expr, args}, line);
+            expr = arena->expr(CallExpr{expr, args}, line);
         } else if (match(TokenType::TK_LBRACKET)) {
             // Index access
             int line = previous().line;
             ExprPtr index = parseExpression();
             consume(TokenType::TK_RBRACKET, "Expected ']' after index");
-            expr = std::make_shared<Expression>(IndexExpr{expr, index}, line);
+            expr = arena->expr(IndexExpr{expr, index}, line);
         } else if (match(TokenType::TK_DOT)) {
             // Member access
             int line = previous().line;
             Token member = consume(TokenType::TK_IDENTIFIER, "Expected member name after '.'");
-            expr = std::make_shared<Expression>(MemberExpr{expr, member.value}, line);
+            expr = arena->expr(MemberExpr{expr, std::string(member.value)}, line);
         } else {
             break;
         }
@@ -880,32 +906,32 @@ ExprPtr Parser::parsePrimary() {
     int line = peek().line;
     
     if (match(TokenType::TK_INTEGER)) {
-        return std::make_shared<Expression>(IntegerLiteral{std::stoll(previous().value)}, line);
+        return arena->expr(IntegerLiteral{std::stoll(std::string(previous().value))}, line);
     }
     
     if (match(TokenType::TK_FLOAT)) {
-        return std::make_shared<Expression>(FloatLiteral{std::stod(previous().value)}, line);
+        return arena->expr(FloatLiteral{std::stod(std::string(previous().value))}, line);
     }
     
     if (match(TokenType::TK_STRING)) {
-        return std::make_shared<Expression>(StringLiteral{previous().value}, line);
+        return arena->expr(StringLiteral{std::string(previous().value)}, line);
     }
     
     if (match(TokenType::TK_TRUE)) {
-        return std::make_shared<Expression>(BoolLiteral{true}, line);
+        return arena->expr(BoolLiteral{true}, line);
     }
     
     if (match(TokenType::TK_FALSE)) {
-        return std::make_shared<Expression>(BoolLiteral{false}, line);
+        return arena->expr(BoolLiteral{false}, line);
     }
     
     if (match(TokenType::TK_NULL)) {
-        return std::make_shared<Expression>(NullLiteral{}, line);
+        return arena->expr(NullLiteral{}, line);
     }
     
     // self keyword
     if (match(TokenType::TK_SELF)) {
-        return std::make_shared<Expression>(SelfExpr{}, line);
+        return arena->expr(SelfExpr{}, line);
     }
     
     // super.method(args) call
@@ -922,7 +948,7 @@ ExprPtr Parser::parsePrimary() {
         }
         consume(TokenType::TK_RPAREN, "Expected ')' after arguments");
         
-        return std::make_shared<Expression>(SuperExpr{methodToken.value, args}, line);
+        return arena->expr(SuperExpr{std::string(methodToken.value), args}, line);
     }
     
     // new ClassName(args) instantiation
@@ -938,11 +964,11 @@ ExprPtr Parser::parsePrimary() {
         }
         consume(TokenType::TK_RPAREN, "Expected ')' after arguments");
         
-        return std::make_shared<Expression>(NewExpr{classToken.value, args}, line);
+        return arena->expr(NewExpr{std::string(classToken.value), args, symbols->intern(classToken.value)}, line);
     }
     
     if (match(TokenType::TK_IDENTIFIER)) {
-        return std::make_shared<Expression>(Identifier{previous().value}, line);
+        return arena->expr(Identifier{std::string(previous().value), symbols->intern(previous().value)}, line);
     }
     
     if (match(TokenType::TK_LPAREN)) {
@@ -970,7 +996,7 @@ ExprPtr Parser::parsePrimary() {
                     lambda.body = nullptr;
                     lambda.blockBody = blockBody;
                     lambda.hasBlockBody = true;
-                    return std::make_shared<Expression>(lambda, line);
+                    return arena->expr(lambda, line);
                 } else if (check(TokenType::TK_COLON)) {
                     // () =>: ... end
                     advance();  // consume ':'
@@ -981,11 +1007,11 @@ ExprPtr Parser::parsePrimary() {
                     lambda.body = nullptr;
                     lambda.blockBody = blockBody;
                     lambda.hasBlockBody = true;
-                    return std::make_shared<Expression>(lambda, line);
+                    return arena->expr(lambda, line);
                 } else {
                     // () => expr (single expression)
                     ExprPtr body = parseExpression();
-                    return std::make_shared<Expression>(LambdaExpr{params, body}, line);
+                    return arena->expr(LambdaExpr{params, body}, line);
                 }
             }
             // Not a lambda, rollback
@@ -993,11 +1019,10 @@ ExprPtr Parser::parsePrimary() {
             isLambda = false;
         } else if (check(TokenType::TK_IDENTIFIER)) {
             // Could be (x) => expr or (x, y) => expr or (x=1) => expr
-            std::string paramName = peek().value;
+            std::string paramName(peek().value);
             advance();
             
             // Check for default value
-            ExprPtr defaultVal = nullptr;
             if (check(TokenType::TK_ASSIGN)) {
                 advance();
                 // We need to be careful here - parse a simple expression (not full expression)
@@ -1032,7 +1057,7 @@ ExprPtr Parser::parsePrimary() {
                             lambda.body = nullptr;
                             lambda.blockBody = blockBody;
                             lambda.hasBlockBody = true;
-                            return std::make_shared<Expression>(lambda, line);
+                            return arena->expr(lambda, line);
                         } else if (check(TokenType::TK_COLON)) {
                             // (x, y) =>: ... end
                             advance();  // consume ':'
@@ -1043,11 +1068,11 @@ ExprPtr Parser::parsePrimary() {
                             lambda.body = nullptr;
                             lambda.blockBody = blockBody;
                             lambda.hasBlockBody = true;
-                            return std::make_shared<Expression>(lambda, line);
+                            return arena->expr(lambda, line);
                         } else {
                             // (x, y) => expr (single expression)
                             ExprPtr body = parseExpression();
-                            return std::make_shared<Expression>(LambdaExpr{params, body}, line);
+                            return arena->expr(LambdaExpr{params, body}, line);
                         }
                     }
                 }
@@ -1075,7 +1100,7 @@ ExprPtr Parser::parsePrimary() {
         return parseDict();
     }
     
-    throw ParseError("Unexpected token: " + peek().value, peek().line, peek().column);
+    throw ParseError("Unexpected token: " + std::string(peek().value), peek().line, peek().column);
 }
 
 ExprPtr Parser::parseList() {
@@ -1096,7 +1121,7 @@ ExprPtr Parser::parseList() {
     skipNewlines();
     consume(TokenType::TK_RBRACKET, "Expected ']' after list");
     
-    return std::make_shared<Expression>(ListExpr{elements}, line);
+    return arena->expr(ListExpr{elements}, line);
 }
 
 ExprPtr Parser::parseDict() {
@@ -1113,9 +1138,9 @@ ExprPtr Parser::parseDict() {
             
             // Key can be string or identifier
             if (match(TokenType::TK_STRING)) {
-                key = std::make_shared<Expression>(StringLiteral{previous().value}, previous().line);
+                key = arena->expr(StringLiteral{std::string(previous().value)}, previous().line);
             } else if (match(TokenType::TK_IDENTIFIER)) {
-                key = std::make_shared<Expression>(StringLiteral{previous().value}, previous().line);
+                key = arena->expr(StringLiteral{std::string(previous().value)}, previous().line);
             } else {
                 throw ParseError("Expected string or identifier as dictionary key", peek().line, peek().column);
             }
@@ -1131,5 +1156,5 @@ ExprPtr Parser::parseDict() {
     skipNewlines();
     consume(TokenType::TK_RBRACE, "Expected '}' after dictionary");
     
-    return std::make_shared<Expression>(DictExpr{entries}, line);
+    return arena->expr(DictExpr{entries}, line);
 }
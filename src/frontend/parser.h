@@ -26,19 +26,21 @@ public:
     Program parse();
     
 private:
-    std::vector<Token> tokens;
+    const std::vector<Token>& tokens;     // Must outlive the parser
     size_t current = 0;
+    std::unique_ptr<AstArena> arena;      // Handed to the Program by parse()
+    std::unique_ptr<SymbolTable> symbols;
     BlockStyle blockStyle = BlockStyle::UNKNOWN;  // Track consistent block style
     
     // Utility methods
-    Token& peek();
-    Token& previous();
+    const Token& peek();
+    const Token& previous();
     bool isAtEnd();
     bool check(TokenType type);
     bool match(TokenType type);
     bool match(std::initializer_list<TokenType> types);
-    Token& advance();
-    Token& consume(TokenType type, const std::string& message);
+    const Token& advance();
+    const Token& consume(TokenType type, const std::string& message);
     void skipNewlines();
     void expectNewlineOrEnd();
     bool expectBlockStart(const std::string& context);  // Returns true if braces, false if colon
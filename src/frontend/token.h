@@ -2,6 +2,7 @@
 #define TOKEN_H
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 // All tokens use TK_ prefix to avoid conflicts with Windows SDK macros
@@ -107,17 +108,19 @@ enum class TokenType {
     TK_INVALID
 };
 
+// Token text is a view into the source or into storage owned by the Lexer,
+// so tokens must not outlive the Lexer (or the source) that produced them
 struct Token {
     TokenType type;
-    std::string value;
+    std::string_view value;
     int line;
     int column;
     
-    Token(TokenType t = TokenType::TK_INVALID, const std::string& v = "", int l = 0, int c = 0)
+    Token(TokenType t = TokenType::TK_INVALID, std::string_view v = {}, int l = 0, int c = 0)
         : type(t), value(v), line(l), column(c) {}
 };
 
-inline std::unordered_map<std::string, TokenType> keywords = {
+inline std::unordered_map<std::string_view, TokenType> keywords = {
     {"if", TokenType::TK_IF},
     {"elif", TokenType::TK_ELIF},
     {"else", TokenType::TK_ELSE},
@@ -29,6 +29,7 @@
 #include "llvm/IR/GlobalVariable.h"
 #include "llvm/IR/Verifier.h"
 #include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/raw_ostream.h"
@@ -49,6 +50,12 @@
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Support/CodeGen.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include "llvm/Support/MemoryBuffer.h"
 
 // ============================================================================
 // Undef Windows Macros that Conflict with MoonLang Enums
@@ -100,6 +107,7 @@
 
 #include "llvm_codegen.h"
 #include "moonrt.h"
+#include "moonrt_ffi.h"
 #include "version.h"
 
 // ============================================================================
@@ -123,6 +131,7 @@
 
 #ifndef _WIN32
 #include <unistd.h>  // for readlink on Linux
+#include <sys/stat.h>  // for the per-user cache directory checks
 #endif
 
 using namespace llvm;
@@ -137,7 +146,10 @@ using namespace llvm;
 // Initialization: Constructor, types, runtime function declarations, helpers
 #include "llvm_codegen_init.cpp"
 
-// Emission: compile(), emitIR(), emitBitcode(), emitObject(), emitExecutable(), emitSharedLibrary()
+// Refcount elision: RefcountElisionPass, run ahead of the LLVM pipeline
+#include "llvm_codegen_refcount.cpp"
+
+// Emission: compile(), emitIR(), emitBitcode(), emitObject(), emitObjectImage(), emitExecutable(), emitSharedLibrary()
 #include "llvm_codegen_emit.cpp"
 
 // Statements: generateStatement() and all statement type handlers
@@ -151,3 +163,12 @@ using namespace llvm;
 
 // Optimization: Native type tracking, optimized loops, native functions
 #include "llvm_codegen_opt.cpp"
+
+// FFI: compile-time ffi_cdef parsing, ABI lowering, direct C calls
+#include "llvm_codegen_ffi.cpp"
+
+// Assets: deflate and the embedded resource section
+#include "llvm_codegen_assets.cpp"
+
+// JIT: runJIT() for in-process execution
+#include "llvm_codegen_jit.cpp"
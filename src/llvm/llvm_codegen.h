@@ -10,6 +10,7 @@
 #include <string>
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 
@@ -44,6 +45,26 @@ struct VersionInfo {
     std::string productVersion = "1.0.0.0"; // Product version
 };
 
+// Reference-count calls before and after RefcountElisionPass (moonc --stats)
+struct RefcountStats {
+    unsigned retainsBefore = 0;
+    unsigned releasesBefore = 0;
+    unsigned retainsAfter = 0;
+    unsigned releasesAfter = 0;
+    unsigned borrowedParams = 0;  // Parameters the callee no longer retains
+};
+
+// Optimized object code plus the link requirements found while compiling it.
+// A long-running compiler keeps these to relink a program without regenerating it.
+struct ObjectImage {
+    std::string bytes;
+    bool usesGUI = false;
+    bool usesNetwork = false;
+    bool usesTLS = false;
+    std::vector<std::pair<std::string, int>> exportedFunctions;
+    RefcountStats refcounts;
+};
+
 // ============================================================================
 // Native Type Tracking for Performance Optimization
 // ============================================================================
@@ -65,6 +86,58 @@ struct TypedValue {
         : value(v), type(t), nativePtr(np) {}
 };
 
+// ============================================================================
+// Compile-time FFI Declarations (ffi_cdef with a literal declaration string)
+// ============================================================================
+
+struct FFICType {
+    enum Kind { Void, Int, Float, Double, Ptr, CStr, Struct };
+    Kind kind = Int;
+    int bits = 32;            // Int: width in bits
+    bool isSigned = true;     // Int: signedness
+    std::string structName;   // Struct: typedef name in ffiStructs
+};
+
+struct FFICField {
+    std::string name;
+    FFICType type;
+    uint64_t count = 1;       // Fixed array length (1 for scalars)
+    uint64_t offset = 0;      // Byte offset in the struct
+};
+
+struct FFICStruct {
+    std::vector<FFICField> fields;
+    uint64_t size = 0;
+    uint64_t align = 1;
+    llvm::StructType* llvmType = nullptr;
+};
+
+// How one C parameter (or the return value) is passed at the LLVM level
+struct FFIPassing {
+    enum Mode {
+        Direct,     // Scalar in its natural LLVM type
+        Coerce,     // Struct reinterpreted as one or more register-sized parts
+        Byval,      // Struct copied onto the stack by the callee's ABI (byval)
+        Indirect,   // Struct passed as a pointer to a caller-owned copy
+        Sret        // Struct returned through a hidden pointer argument
+    };
+    Mode mode = Direct;
+    std::vector<llvm::Type*> parts;   // Coerce: LLVM types of the parts
+};
+
+struct FFICFunction {
+    std::string name;
+    FFICType ret;
+    std::vector<FFICType> params;
+    bool varArgs = false;
+
+    // ABI lowering, computed once per declaration
+    FFIPassing retPassing;
+    std::vector<FFIPassing> paramPassing;
+    llvm::FunctionType* llvmType = nullptr;
+    llvm::GlobalVariable* slot = nullptr;   // Resolved function pointer
+};
+
 // ============================================================================
 // LLVM Code Generator
 // ============================================================================
@@ -85,6 +158,25 @@ public:
                         const std::string& iconPath = "", const VersionInfo& versionInfo = VersionInfo());
     bool emitSharedLibrary(const std::string& filename, const std::string& runtimeLib = "");
     
+    // Optimize and generate object code into memory
+    bool emitObjectImage(ObjectImage& image);
+    // Emit and link from a prebuilt image instead of the compiled module (image must outlive the call)
+    void useObjectImage(const ObjectImage* image);
+    
+    // Run the program in-process with ORC (moonc --jit); the whole program is compiled up front.
+    // With objectCachePath its object is saved there, and when that file already exists it is
+    // run without compile(). With lazy, each function is compiled on its first call instead
+    // (no object cache). Returns the exit code, or -1.
+    int runJIT(const std::vector<std::string>& args, const std::string& objectCachePath = "",
+               bool lazy = false);
+    // Path, size and modification time of the shared runtime the JIT binds to; empty when
+    // it uses the runtime linked into moonc. Part of the --jit-cache key.
+    static std::string jitRuntimeIdentity();
+    // Per-user cache directory <cache root>/moonc/<name> for the JIT and asset caches,
+    // created 0700. Empty when it cannot be created, or is not a directory owned by this
+    // user and closed to everyone else (what is loaded from it is trusted as is).
+    static std::string userCacheDir(const std::string& name);
+    
     // Shared library mode
     void setSharedLibraryMode(bool enabled) { buildingSharedLib = enabled; }
     bool isSharedLibraryMode() const { return buildingSharedLib; }
@@ -101,12 +193,18 @@ public:
     // Alias map for builtin function name mapping
     void setAliasMap(const AliasMap* map) { aliasMap = map; }
     
+    // Embed a file in the output; read back with asset_read() or moon:// URLs
+    void addAsset(const std::string& path, const std::string& content);
+    
     // Get list of exported functions (for header generation)
     const std::vector<std::pair<std::string, int>>& getExportedFunctions() const { return exportedFunctions; }
     
     // Get the generated LLVM IR as string
     std::string getIR() const;
     
+    // Optimizer statistics of the last emitObjectImage()/runJIT()
+    const RefcountStats& getRefcountStats() const { return refcountStats; }
+    
     // Error handling
     bool hasError() const { return !errorMessage.empty(); }
     const std::string& getError() const { return errorMessage; }
@@ -125,18 +223,32 @@ private:
     // Symbol tables
     std::map<std::string, llvm::Value*> namedValues;          // Local variables (MoonValue**)
     std::map<std::string, llvm::GlobalVariable*> globalVars;  // Global variables
-    std::map<std::string, llvm::Function*> functions;
+    const SymbolTable* symbols = nullptr;                     // Interned names of the program being compiled
+    std::unordered_map<Symbol, llvm::Function*> functions;
     std::map<std::string, llvm::Function*> wrapperFunctions;  // Wrapper functions for default param support
-    std::map<std::string, size_t> functionParamCounts;        // Track parameter count for each function
+    std::unordered_map<Symbol, size_t> functionParamCounts;   // Track parameter count for each function
     std::map<std::string, llvm::Function*> nativeFunctions;   // Native i64 versions of numeric functions
-    std::map<std::string, llvm::GlobalVariable*> classDefinitions;
+    std::unordered_map<Symbol, llvm::GlobalVariable*> classDefinitions;
     std::set<std::string> declaredGlobals;                    // Variables declared with 'global' keyword
     
     // Native type tracking for optimization
     std::map<std::string, NativeType> variableTypes;          // Track variable types
     std::map<std::string, llvm::Value*> nativeIntVars;        // Native i64 variables
     std::map<std::string, llvm::Value*> nativeFloatVars;      // Native double variables
-    
+
+    // Immortal literal values, one global per distinct constant
+    std::map<int64_t, llvm::GlobalVariable*> intConstants;
+    std::map<uint64_t, llvm::GlobalVariable*> floatConstants;  // Keyed by bit pattern
+    std::map<std::string, llvm::GlobalVariable*> stringConstants;
+
+    // Bundled files for the embedded asset section (normalized path -> bytes)
+    std::map<std::string, std::string> assets;
+
+    // C declarations from literal ffi_cdef strings
+    std::map<std::string, FFICStruct> ffiStructs;             // typedef struct name -> layout
+    std::map<std::string, FFICType> ffiTypedefs;              // typedef name -> type
+    std::map<std::string, FFICFunction> ffiFunctions;         // C function name -> signature
+
     // Current function being generated
     llvm::Function* currentFunction;
     llvm::Function* mainFunction;  // The main entry point
@@ -163,6 +275,8 @@ private:
     // Shared library mode
     bool buildingSharedLib = false;  // True when building DLL/SO
     std::vector<std::pair<std::string, int>> exportedFunctions;  // (name, param_count) pairs
+    const ObjectImage* prebuiltObject = nullptr;  // Set by useObjectImage()
+    RefcountStats refcountStats;
     
     // Cross-compilation settings
     std::string customTargetTriple;   // Custom target triple (e.g., "arm-none-eabi")
@@ -219,7 +333,7 @@ private:
     llvm::Value* generateBoolLiteral(bool value);
     llvm::Value* generateNullLiteral();
     llvm::Value* generateIdentifier(const std::string& name);
-    llvm::Value* generateBinaryExpr(const BinaryExpr& expr);
+    llvm::Value* generateBinaryExpr(const BinaryExpr& expr, bool temporary = false);
     llvm::Value* generateUnaryExpr(const UnaryExpr& expr);
     llvm::Value* generateCallExpr(const CallExpr& expr);
     llvm::Value* generateIndexExpr(const IndexExpr& expr);
@@ -231,6 +345,20 @@ private:
     llvm::Value* generateSelfExpr();
     llvm::Value* generateSuperExpr(const SuperExpr& expr);
     
+    // ========== Literal Constants ==========
+    
+    llvm::Constant* intConstant(int64_t value);
+    llvm::Constant* floatConstant(double value);
+    llvm::Constant* stringConstant(const std::string& value);
+    llvm::Constant* literalConstant(const ExprPtr& expr);  // nullptr unless a number/string literal
+    
+    // ========== Stack Temporaries ==========
+    
+    llvm::Value* temporarySlot(int type = -1);  // Uninitialized unless a MoonType is given
+    llvm::Value* temporaryInt(llvm::Value* nativeVal);
+    llvm::Value* temporaryFloat(llvm::Value* nativeVal);
+    llvm::Value* generateOperand(const ExprPtr& expr);
+    
     // ========== Built-in Function Handling ==========
     
     llvm::Value* generateBuiltinCall(const std::string& name, const std::vector<ExprPtr>& args);
@@ -307,6 +435,42 @@ private:
     bool isPureNumericFunction(const FuncDecl& stmt);
     void generateNativeFunction(const FuncDecl& stmt);
     llvm::Value* generateNativeFunctionCall(const std::string& funcName, const std::vector<ExprPtr>& args);
+
+    // ========== FFI Direct Calls ==========
+
+    // Parse C declarations at compile time; registers structs, typedefs and functions
+    bool parseFFIDeclarations(const std::string& source, std::vector<std::string>& declared,
+                              bool& hasTypes);
+
+    // Register top-level literal ffi_cdef declarations before code generation
+    void scanFFIDeclarations(const std::vector<StmtPtr>& stmts);
+
+    // Compute size/alignment and the ABI passing of a declared function
+    void getFFITypeLayout(const FFICType& type, uint64_t& size, uint64_t& align);
+    llvm::Type* getFFILLVMType(const FFICType& type);
+    bool lowerFFIFunction(FFICFunction& fn);
+
+    // ffi_cdef(decls, lib?) and calls to declared C functions
+    llvm::Value* generateFFICdef(const std::vector<ExprPtr>& args);
+    TypedValue generateFFICall(const FFICFunction& fn, const std::vector<ExprPtr>& args, bool wantNative);
+
+    // Inline unboxing of a MoonValue* (tag check with runtime fallback)
+    llvm::Value* ffiUnboxInt(llvm::Value* moonVal);
+    llvm::Value* ffiUnboxFloat(llvm::Value* moonVal);
+    llvm::Value* ffiUnboxPtr(llvm::Value* moonVal);
+    llvm::Value* ffiScalarArg(const FFICType& t, const ExprPtr& expr, std::vector<llvm::Value*>& toRelease);
+
+    // ffi_get/ffi_set/ffi_field/ffi_field_get/ffi_field_set on a struct whose
+    // layout is known at compile time; value is nullptr when not foldable
+    const FFICField* findFFIField(const ExprPtr& typeArg, const ExprPtr& fieldArg);
+    const FFICField* foldableFFIField(const std::string& name, const std::vector<ExprPtr>& args);
+    NativeType inferFFIFieldType(const std::string& name, const std::vector<ExprPtr>& args);
+    TypedValue generateFFIFieldAccess(const std::string& name, const std::vector<ExprPtr>& args, bool wantNative);
+
+    // ========== Embedded Assets ==========
+
+    // Pack added assets into a read-only section and register it at startup
+    void emitAssetSection();
 };
 
 #endif // LLVM_CODEGEN_H
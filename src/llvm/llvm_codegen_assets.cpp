@@ -0,0 +1,483 @@
+// ============================================================================
+// Embedded Asset Module
+// ============================================================================
+// Files bundled by moonc are packed into one read-only section of the output
+// (".moonres", or __TEXT,__moonres on Mach-O) and registered with the runtime
+// from main(). Text assets are deflate-compressed here; formats that are
+// already compressed, and files that do not shrink, are stored as-is so the
+// runtime can hand them out without copying. Compressed bodies are cached by
+// content hash in a per-user cache directory so rebuilds skip the deflate
+// pass; a cached body is only embedded after it inflates back to the content.
+//
+// The section layout is documented in moonrt_assets.cpp.
+//
+// IMPORTANT: This file should be included by llvm_codegen.cpp, not compiled
+// separately.
+// ============================================================================
+
+#include <algorithm>
+#include <cctype>
+#include <queue>
+
+#define ASSET_STORED   0
+#define ASSET_DEFLATE  1
+
+// ============================================================================
+// Deflate (RFC 1951)
+// ============================================================================
+
+struct DeflateBitWriter {
+    std::string data;
+    uint32_t bitBuf = 0;
+    int bitCount = 0;
+
+    void put(uint32_t value, int count) {
+        bitBuf |= value << bitCount;
+        bitCount += count;
+        while (bitCount >= 8) {
+            data.push_back((char)(bitBuf & 0xFF));
+            bitBuf >>= 8;
+            bitCount -= 8;
+        }
+    }
+
+    void flush() {
+        if (bitCount > 0) data.push_back((char)(bitBuf & 0xFF));
+        bitBuf = 0;
+        bitCount = 0;
+    }
+};
+
+struct DeflateToken {
+    uint16_t value;     // Literal byte, or match length when dist != 0
+    uint16_t dist;
+};
+
+static const uint16_t kDeflateLengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t kDeflateLengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const uint16_t kDeflateDistBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577 };
+static const uint8_t kDeflateDistExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+static int deflateLengthCode(int length) {
+    return (int)(std::upper_bound(kDeflateLengthBase, kDeflateLengthBase + 29, length) - kDeflateLengthBase) - 1;
+}
+
+static int deflateDistCode(int dist) {
+    return (int)(std::upper_bound(kDeflateDistBase, kDeflateDistBase + 30, dist) - kDeflateDistBase) - 1;
+}
+
+// Huffman code lengths limited to maxBits. When the optimal tree is too deep
+// the frequencies are halved and the tree rebuilt, which flattens it.
+static std::vector<uint8_t> deflateCodeLengths(std::vector<uint32_t> freq, int maxBits) {
+    size_t n = freq.size();
+
+    // The inflater needs at least two codes to form a complete tree
+    int used = 0;
+    for (uint32_t f : freq) if (f) used++;
+    for (size_t i = 0; used < 2 && i < n; i++) {
+        if (!freq[i]) { freq[i] = 1; used++; }
+    }
+
+    for (;;) {
+        std::vector<uint64_t> weight;
+        std::vector<int> parent;
+        std::vector<int> leafSymbol;
+        typedef std::pair<uint64_t, int> HeapItem;
+        std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>> heap;
+
+        for (size_t i = 0; i < n; i++) {
+            if (!freq[i]) continue;
+            heap.push(HeapItem(freq[i], (int)weight.size()));
+            weight.push_back(freq[i]);
+            parent.push_back(-1);
+            leafSymbol.push_back((int)i);
+        }
+        size_t leaves = weight.size();
+        while (heap.size() > 1) {
+            HeapItem a = heap.top(); heap.pop();
+            HeapItem b = heap.top(); heap.pop();
+            int node = (int)weight.size();
+            weight.push_back(a.first + b.first);
+            parent.push_back(-1);
+            parent[a.second] = node;
+            parent[b.second] = node;
+            heap.push(HeapItem(a.first + b.first, node));
+        }
+
+        // Parents are always created after their children
+        std::vector<int> depth(weight.size(), 0);
+        int maxDepth = 0;
+        for (int i = (int)weight.size() - 2; i >= 0; i--) {
+            depth[i] = depth[parent[i]] + 1;
+            if ((size_t)i < leaves && depth[i] > maxDepth) maxDepth = depth[i];
+        }
+
+        if (maxDepth <= maxBits) {
+            std::vector<uint8_t> lengths(n, 0);
+            for (size_t i = 0; i < leaves; i++) lengths[leafSymbol[i]] = (uint8_t)depth[i];
+            return lengths;
+        }
+        for (uint32_t& f : freq) if (f) f = (f + 1) / 2;
+    }
+}
+
+// Canonical codes, bit-reversed because deflate streams are LSB-first
+static std::vector<uint16_t> deflateCanonicalCodes(const std::vector<uint8_t>& lengths) {
+    uint16_t count[16] = {0};
+    uint16_t next[16] = {0};
+    for (uint8_t len : lengths) if (len) count[len]++;
+    uint16_t code = 0;
+    for (int bits = 1; bits < 16; bits++) {
+        code = (uint16_t)((code + count[bits - 1]) << 1);
+        next[bits] = code;
+    }
+
+    std::vector<uint16_t> codes(lengths.size(), 0);
+    for (size_t i = 0; i < lengths.size(); i++) {
+        int len = lengths[i];
+        if (!len) continue;
+        uint16_t c = next[len]++;
+        uint16_t reversed = 0;
+        for (int b = 0; b < len; b++) {
+            reversed = (uint16_t)((reversed << 1) | (c & 1));
+            c >>= 1;
+        }
+        codes[i] = reversed;
+    }
+    return codes;
+}
+
+// LZ77 with hash chains and one-step lazy matching
+static std::vector<DeflateToken> deflateTokenize(const uint8_t* in, size_t len) {
+    const int kWindow = 32768;
+    const int kHashBits = 15;
+    const int kMaxChain = 128;
+    const int kMaxMatch = 258;
+
+    std::vector<DeflateToken> tokens;
+    tokens.reserve(len / 2 + 16);
+    std::vector<int32_t> head(1 << kHashBits, -1);
+    std::vector<int32_t> prev(kWindow, -1);
+
+    auto hashAt = [&](size_t pos) -> uint32_t {
+        uint32_t v = (uint32_t)in[pos] | ((uint32_t)in[pos + 1] << 8) | ((uint32_t)in[pos + 2] << 16);
+        return (v * 2654435761u) >> (32 - kHashBits);
+    };
+    auto insert = [&](size_t pos) {
+        if (pos + 3 > len) return;
+        uint32_t h = hashAt(pos);
+        prev[pos & (kWindow - 1)] = head[h];
+        head[h] = (int32_t)pos;
+    };
+    auto findMatch = [&](size_t pos, int& bestDist) -> int {
+        if (pos + 3 > len) return 0;
+        int maxLen = (int)std::min<size_t>(kMaxMatch, len - pos);
+        int bestLen = 0;
+        int32_t cand = head[hashAt(pos)];
+        for (int chain = 0; cand >= 0 && chain < kMaxChain; chain++) {
+            size_t dist = pos - (size_t)cand;
+            if (dist == 0 || dist > (size_t)kWindow) break;
+            if (in[cand + bestLen] == in[pos + bestLen]) {
+                int l = 0;
+                while (l < maxLen && in[cand + l] == in[pos + l]) l++;
+                if (l > bestLen) {
+                    bestLen = l;
+                    bestDist = (int)dist;
+                    if (l == maxLen) break;
+                }
+            }
+            int32_t next = prev[cand & (kWindow - 1)];
+            if (next >= cand) break;    // Slot was reused by a newer position
+            cand = next;
+        }
+        return bestLen >= 3 ? bestLen : 0;
+    };
+
+    size_t pos = 0;
+    while (pos < len) {
+        int dist = 0;
+        int matchLen = findMatch(pos, dist);
+        if (matchLen && matchLen < 32 && pos + 1 < len) {
+            // Prefer a literal when the next position starts a longer match
+            insert(pos);
+            int nextDist = 0;
+            int nextLen = findMatch(pos + 1, nextDist);
+            if (nextLen > matchLen) {
+                tokens.push_back({in[pos], 0});
+                pos++;
+                insert(pos);
+                matchLen = nextLen;
+                dist = nextDist;
+            }
+            for (int i = 1; i < matchLen; i++) insert(pos + i);
+        } else if (matchLen) {
+            for (int i = 0; i < matchLen; i++) insert(pos + i);
+        } else {
+            insert(pos);
+            tokens.push_back({in[pos], 0});
+            pos++;
+            continue;
+        }
+        tokens.push_back({(uint16_t)matchLen, (uint16_t)dist});
+        pos += matchLen;
+    }
+    return tokens;
+}
+
+static void deflateWriteBlock(DeflateBitWriter& out, const DeflateToken* tokens, size_t count, bool last) {
+    static const uint8_t order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+    std::vector<uint32_t> litFreq(286, 0), distFreq(30, 0);
+    for (size_t i = 0; i < count; i++) {
+        if (tokens[i].dist) {
+            litFreq[257 + deflateLengthCode(tokens[i].value)]++;
+            distFreq[deflateDistCode(tokens[i].dist)]++;
+        } else {
+            litFreq[tokens[i].value]++;
+        }
+    }
+    litFreq[256] = 1;
+
+    std::vector<uint8_t> litLen = deflateCodeLengths(litFreq, 15);
+    std::vector<uint8_t> distLen = deflateCodeLengths(distFreq, 15);
+    std::vector<uint16_t> litCode = deflateCanonicalCodes(litLen);
+    std::vector<uint16_t> distCode = deflateCanonicalCodes(distLen);
+
+    int nlit = 286, ndist = 30;
+    while (nlit > 257 && !litLen[nlit - 1]) nlit--;
+    while (ndist > 1 && !distLen[ndist - 1]) ndist--;
+
+    // Run-length encode both length tables as one sequence (symbols 16/17/18)
+    std::vector<uint8_t> all(litLen.begin(), litLen.begin() + nlit);
+    all.insert(all.end(), distLen.begin(), distLen.begin() + ndist);
+    std::vector<std::pair<uint8_t, uint8_t>> rle;     // (symbol, extra bits value)
+    for (size_t i = 0; i < all.size();) {
+        uint8_t len = all[i];
+        size_t run = 1;
+        while (i + run < all.size() && all[i + run] == len) run++;
+        if (len == 0 && run >= 3) {
+            size_t n = std::min<size_t>(run, 138);
+            if (n >= 11) rle.push_back({18, (uint8_t)(n - 11)});
+            else rle.push_back({17, (uint8_t)(n - 3)});
+            i += n;
+        } else if (len != 0 && run >= 4) {
+            rle.push_back({len, 0});
+            size_t n = std::min<size_t>(run - 1, 6);
+            rle.push_back({16, (uint8_t)(n - 3)});
+            i += 1 + n;
+        } else {
+            rle.push_back({len, 0});
+            i++;
+        }
+    }
+
+    std::vector<uint32_t> clFreq(19, 0);
+    for (auto& r : rle) clFreq[r.first]++;
+    std::vector<uint8_t> clLen = deflateCodeLengths(clFreq, 7);
+    std::vector<uint16_t> clCode = deflateCanonicalCodes(clLen);
+    int nclen = 19;
+    while (nclen > 4 && !clLen[order[nclen - 1]]) nclen--;
+
+    out.put(last ? 1 : 0, 1);
+    out.put(2, 2);
+    out.put((uint32_t)(nlit - 257), 5);
+    out.put((uint32_t)(ndist - 1), 5);
+    out.put((uint32_t)(nclen - 4), 4);
+    for (int i = 0; i < nclen; i++) out.put(clLen[order[i]], 3);
+    for (auto& r : rle) {
+        out.put(clCode[r.first], clLen[r.first]);
+        if (r.first == 16) out.put(r.second, 2);
+        else if (r.first == 17) out.put(r.second, 3);
+        else if (r.first == 18) out.put(r.second, 7);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const DeflateToken& t = tokens[i];
+        if (!t.dist) {
+            out.put(litCode[t.value], litLen[t.value]);
+            continue;
+        }
+        int lc = deflateLengthCode(t.value);
+        out.put(litCode[257 + lc], litLen[257 + lc]);
+        out.put((uint32_t)(t.value - kDeflateLengthBase[lc]), kDeflateLengthExtra[lc]);
+        int dc = deflateDistCode(t.dist);
+        out.put(distCode[dc], distLen[dc]);
+        out.put((uint32_t)(t.dist - kDeflateDistBase[dc]), kDeflateDistExtra[dc]);
+    }
+    out.put(litCode[256], litLen[256]);
+}
+
+static std::string deflateCompress(const std::string& input) {
+    const size_t kBlockTokens = 1 << 16;
+    std::vector<DeflateToken> tokens = deflateTokenize((const uint8_t*)input.data(), input.size());
+    DeflateBitWriter out;
+    size_t pos = 0;
+    do {
+        size_t count = std::min(kBlockTokens, tokens.size() - pos);
+        deflateWriteBlock(out, tokens.data() + pos, count, pos + count == tokens.size());
+        pos += count;
+    } while (pos < tokens.size());
+    out.flush();
+    return out.data;
+}
+
+// ============================================================================
+// Compression Cache
+// ============================================================================
+
+static std::string assetContentHash(const std::string& content) {
+    uint64_t fnv = 1469598103934665603ULL;
+    uint64_t mix = 0x9E3779B97F4A7C15ULL;
+    for (unsigned char c : content) {
+        fnv = (fnv ^ c) * 1099511628211ULL;
+        mix = (mix ^ c) * 0xFF51AFD7ED558CCDULL;
+        mix ^= mix >> 29;
+    }
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%016llx%016llx-%llx", (unsigned long long)fnv,
+             (unsigned long long)mix, (unsigned long long)content.size());
+    return buf;
+}
+
+static bool assetIsPrecompressed(const std::string& key) {
+    static const char* exts[] = {
+        ".png", ".jpg", ".jpeg", ".gif", ".webp", ".ico", ".woff", ".woff2",
+        ".mp3", ".mp4", ".ogg", ".webm", ".zip", ".gz", ".7z", nullptr };
+    for (int i = 0; exts[i]; i++) {
+        size_t n = strlen(exts[i]);
+        if (key.size() >= n && key.compare(key.size() - n, n, exts[i]) == 0) return true;
+    }
+    return false;
+}
+
+// Returns the packed body and sets method; tiny and precompressed files are stored
+static std::string packAsset(const std::string& key, const std::string& content, uint32_t& method) {
+    namespace fs = std::filesystem;
+    method = ASSET_STORED;
+    if (content.size() < 64 || assetIsPrecompressed(key)) return content;
+
+    std::error_code ec;
+    std::string cacheDir = LLVMCodeGen::userCacheDir("assets-v1");
+    fs::path cacheFile = cacheDir.empty() ? fs::path() : fs::path(cacheDir) / assetContentHash(content);
+
+    std::string packed;
+    bool cached = false;
+    if (!cacheFile.empty()) {
+        std::ifstream in(cacheFile, std::ios::binary);
+        if (in) {
+            std::stringstream ss;
+            ss << in.rdbuf();
+            packed = ss.str();
+            // A hash collision or a damaged entry must not end up in the executable
+            std::string check(content.size(), '\0');
+            cached = !packed.empty() &&
+                     moon_asset_inflate((const uint8_t*)packed.data(), packed.size(),
+                                        (uint8_t*)&check[0], check.size()) &&
+                     check == content;
+        }
+    }
+    if (!cached) {
+        packed = deflateCompress(content);
+        if (!cacheFile.empty()) {
+            // Write then rename so concurrent builds never see a partial entry
+            fs::path tmp = cacheFile;
+            tmp += ".tmp" + std::to_string((unsigned long long)(uintptr_t)&packed);
+            {
+                std::ofstream out(tmp, std::ios::binary);
+                if (out) out.write(packed.data(), (std::streamsize)packed.size());
+            }
+            fs::rename(tmp, cacheFile, ec);
+            if (ec) fs::remove(tmp, ec);
+        }
+    }
+
+    if (packed.empty() || packed.size() >= content.size()) return content;
+    method = ASSET_DEFLATE;
+    return packed;
+}
+
+// ============================================================================
+// Section Emission
+// ============================================================================
+
+void LLVMCodeGen::addAsset(const std::string& path, const std::string& content) {
+    // Same normalization the runtime applies on lookup
+    std::string key;
+    size_t start = 0;
+    while (start < path.size() && (path[start] == '/' || path[start] == '\\')) start++;
+    if (path.compare(start, 2, "./") == 0 || path.compare(start, 2, ".\\") == 0) start += 2;
+    for (size_t i = start; i < path.size(); i++) {
+        char c = path[i];
+        key += c == '\\' ? '/' : (char)tolower((unsigned char)c);
+    }
+    if (!key.empty()) assets[key] = content;
+}
+
+static void appendLE(std::string& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) out.push_back((char)((value >> (i * 8)) & 0xFF));
+}
+
+void LLVMCodeGen::emitAssetSection() {
+    if (assets.empty()) return;
+
+    // Index, then names, then bodies (std::map keeps names sorted for lookup)
+    std::string names;
+    std::vector<std::string> bodies;
+    std::vector<uint32_t> methods;
+    for (const auto& asset : assets) {
+        uint32_t method;
+        bodies.push_back(packAsset(asset.first, asset.second, method));
+        methods.push_back(method);
+        names += asset.first;
+    }
+
+    uint64_t indexSize = 16 + 32 * (uint64_t)assets.size();
+    uint64_t nameOffset = indexSize;
+    uint64_t dataOffset = (indexSize + names.size() + 7) & ~7ULL;
+
+    std::string blob = "MOONRES1";
+    appendLE(blob, assets.size(), 4);
+    appendLE(blob, 0, 4);
+    size_t i = 0;
+    for (const auto& asset : assets) {
+        appendLE(blob, nameOffset, 4);
+        appendLE(blob, asset.first.size(), 4);
+        appendLE(blob, dataOffset, 8);
+        appendLE(blob, bodies[i].size(), 4);
+        appendLE(blob, asset.second.size(), 4);
+        appendLE(blob, methods[i], 4);
+        appendLE(blob, 0, 4);
+        nameOffset += asset.first.size();
+        dataOffset += bodies[i].size();
+        i++;
+    }
+    blob += names;
+    blob.resize((blob.size() + 7) & ~(size_t)7, '\0');
+    for (const auto& body : bodies) blob += body;
+
+    Constant* data = ConstantDataArray::get(*context,
+        ArrayRef<uint8_t>((const uint8_t*)blob.data(), blob.size()));
+    auto* section = new GlobalVariable(*module, data->getType(), true,
+                                       GlobalValue::PrivateLinkage, data, "moon_assets");
+    section->setAlignment(Align(8));
+    if (resolveTargetTriple(customTargetTriple).isOSBinFormatMachO()) {
+        section->setSection("__TEXT,__moonres");
+    } else {
+        section->setSection(".moonres");
+    }
+
+    auto* i8PtrTy = PointerType::get(Type::getInt8Ty(*context), 0);
+    builder->CreateCall(getRuntimeFunction("moon_assets_register"), {
+        ConstantExpr::getPointerCast(section, i8PtrTy),
+        ConstantInt::get(Type::getInt64Ty(*context), blob.size())
+    });
+}
@@ -62,6 +62,8 @@ bool LLVMCodeGen::isBuiltinFunction(const std::string& name) {
         "copy_file", "move_file", "remove_file", "remove_dir",
         // String encryption
         "decrypt_string",
+        // Embedded assets
+        "asset_read",
         // JSON
         "json_encode", "json_decode", "format",
         // Regular expressions
@@ -82,6 +84,8 @@ bool LLVMCodeGen::isBuiltinFunction(const std::string& name) {
         // String operations
         "substring", "split", "join", "replace", "trim", "to_upper", "to_lower",
         "starts_with", "ends_with", "repeat", "chr", "ord", "bytes_to_string", "ws_parse_frame_native", "ws_create_frame_native",
+        // Buffers (zero-copy byte views)
+        "buffer_from_ptr", "buffer_from_str", "buffer_slice", "buffer_ptr", "buffer_to_str",
         "capitalize", "title", "ltrim", "rtrim", "find",
         "is_alpha", "is_digit", "is_alnum", "is_space", "is_lower", "is_upper",
         "pad_left", "pad_right",
@@ -102,16 +106,29 @@ bool LLVMCodeGen::isBuiltinFunction(const std::string& name) {
         "start_of_day", "end_of_day", "start_of_month", "end_of_month",
         // Network
         "tcp_connect", "tcp_listen", "tcp_accept", "tcp_send", "tcp_recv", "tcp_close",
+        "tcp_listen_group", "tcp_accept_batch", "tcp_send_file",
+        "tcp_reader", "tls_reader", "recv_exact", "recv_until", "reader_close",
         "tcp_set_nonblocking", "tcp_has_data", "tcp_select", "tcp_accept_nonblocking", "tcp_recv_nonblocking",
         "iocp_register", "iocp_wait",
+        "poller_new", "poller_add", "poller_mod", "poller_del", "poller_wait", "poller_close",
         "udp_socket", "udp_bind", "udp_send", "udp_recv", "udp_close",
+        "udp_send_batch", "udp_recv_batch", "tcp_sendv",
+        "dns_resolve", "dns_config", "dns_clear",
+        "http_server", "http_route", "http_serve", "http_stop", "http_server_stats",
+        "http_get", "http_post", "http_request", "http_read", "http_close",
+        "ws_connect", "ws_upgrade", "ws_recv", "ws_send", "ws_ping", "ws_close", "ws_broadcast", "ws_info",
         // TLS/SSL
         "tls_connect", "tls_listen", "tls_accept", "tls_send", "tls_recv", "tls_recv_all", "tls_close",
         "tls_set_verify", "tls_set_hostname", "tls_get_peer_cert", "tls_get_cipher", "tls_get_version",
         "tls_load_cert", "tls_load_key", "tls_load_ca", "tls_cert_info",
         "tls_wrap_client", "tls_wrap_server", "tls_init", "tls_cleanup",
+        "tls_pool_config", "tls_pool_get", "tls_pool_put", "tls_pool_clear", "tls_pool_stats",
         // DLL
         "dll_load", "dll_close", "dll_func",
+        // FFI
+        "ffi_cdef", "ffi_new", "ffi_free", "ffi_sizeof", "ffi_offsetof", "ffi_get", "ffi_set",
+        "ffi_field", "ffi_field_get", "ffi_field_set", "ffi_read_array",
+        "ffi_callback_type", "ffi_callback", "ffi_callback_free",
         "dll_call_int", "dll_call_double", "dll_call_str", "dll_call_void",
         "alloc_str", "free_str", "ptr_to_str",
         // Memory read/write
@@ -136,7 +153,8 @@ bool LLVMCodeGen::isBuiltinFunction(const std::string& name) {
         "gui_load_html", "gui_load_url", "gui_show", "gui_set_title",
         "gui_set_size", "gui_set_position", "gui_close",
         "gui_minimize", "gui_maximize", "gui_restore",
-        "gui_on_message", "gui_on_close", "gui_eval", "gui_post_message", "gui_expose"
+        "gui_on_message", "gui_on_close", "gui_eval", "gui_post_message", "gui_expose",
+        "gui_post_binary", "gui_on_binary", "gui_async_handlers"
     };
     return builtins.count(mappedName) > 0;
 }
@@ -174,6 +192,18 @@ Value* LLVMCodeGen::generateBuiltinCall(const std::string& name, const std::vect
         return generateNullLiteral();
     }
     
+    // C declarations (literal strings are lowered at compile time)
+    if (funcName == "ffi_cdef") {
+        return generateFFICdef(args);
+    }
+    
+    // Struct fields with a layout known at compile time become direct loads/stores
+    if (funcName == "ffi_get" || funcName == "ffi_set" || funcName == "ffi_field" ||
+        funcName == "ffi_field_get" || funcName == "ffi_field_set") {
+        TypedValue folded = generateFFIFieldAccess(funcName, args, false);
+        if (folded.value) return folded.value;
+    }
+    
     // Type conversion
     if (funcName == "str") {
         Value* arg = generateExpression(args[0]);
@@ -281,6 +311,8 @@ Value* LLVMCodeGen::generateBuiltinCall(const std::string& name, const std::vect
         {"remove_dir", "moon_remove_dir"},
         // String encryption
         {"decrypt_string", "moon_decrypt_string"},
+        // Embedded assets
+        {"asset_read", "moon_asset_read"},
         // JSON
         {"json_encode", "moon_json_encode"},
         {"json_decode", "moon_json_decode"},
@@ -350,6 +382,11 @@ Value* LLVMCodeGen::generateBuiltinCall(const std::string& name, const std::vect
         {"chr", "moon_chr"},
         {"ord", "moon_ord"},
         {"bytes_to_string", "moon_bytes_to_string"},
+        {"buffer_from_ptr", "moon_buffer_from_ptr"},
+        {"buffer_from_str", "moon_buffer_from_str"},
+        {"buffer_slice", "moon_buffer_slice"},
+        {"buffer_ptr", "moon_buffer_ptr"},
+        {"buffer_to_str", "moon_buffer_to_str"},
         {"ws_parse_frame_native", "moon_ws_parse_frame"},
         {"ws_create_frame_native", "moon_ws_create_frame"},
         {"capitalize", "moon_str_capitalize"},
@@ -412,6 +449,14 @@ Value* LLVMCodeGen::generateBuiltinCall(const std::string& name, const std::vect
         {"tcp_connect", "moon_tcp_connect"},
         {"tcp_listen", "moon_tcp_listen"},
         {"tcp_accept", "moon_tcp_accept"},
+        {"tcp_listen_group", "moon_tcp_listen_group"},
+        {"tcp_accept_batch", "moon_tcp_accept_batch"},
+        {"tcp_send_file", "moon_tcp_send_file"},
+        {"tcp_reader", "moon_tcp_reader"},
+        {"tls_reader", "moon_tls_reader"},
+        {"recv_exact", "moon_recv_exact"},
+        {"recv_until", "moon_recv_until"},
+        {"reader_close", "moon_reader_close"},
         {"tcp_send", "moon_tcp_send"},
         {"tcp_recv", "moon_tcp_recv"},
         {"tcp_close", "moon_tcp_close"},
@@ -424,11 +469,41 @@ Value* LLVMCodeGen::generateBuiltinCall(const std::string& name, const std::vect
         // IOCP (Windows high-concurrency)
         {"iocp_register", "moon_iocp_register"},
         {"iocp_wait", "moon_iocp_wait"},
+        {"poller_new", "moon_poller_new"},
+        {"poller_add", "moon_poller_add"},
+        {"poller_mod", "moon_poller_mod"},
+        {"poller_del", "moon_poller_del"},
+        {"poller_wait", "moon_poller_wait"},
+        {"poller_close", "moon_poller_close"},
         {"udp_socket", "moon_udp_socket"},
         {"udp_bind", "moon_udp_bind"},
         {"udp_send", "moon_udp_send"},
         {"udp_recv", "moon_udp_recv"},
         {"udp_close", "moon_udp_close"},
+        {"udp_send_batch", "moon_udp_send_batch"},
+        {"udp_recv_batch", "moon_udp_recv_batch"},
+        {"tcp_sendv", "moon_tcp_sendv"},
+        {"dns_resolve", "moon_dns_resolve"},
+        {"dns_config", "moon_dns_config"},
+        {"dns_clear", "moon_dns_clear"},
+        {"http_server", "moon_http_server"},
+        {"http_route", "moon_http_route"},
+        {"http_serve", "moon_http_serve"},
+        {"http_stop", "moon_http_stop"},
+        {"http_server_stats", "moon_http_server_stats"},
+        {"http_get", "moon_http_get"},
+        {"http_post", "moon_http_post"},
+        {"http_request", "moon_http_request"},
+        {"http_read", "moon_http_read"},
+        {"http_close", "moon_http_close"},
+        {"ws_connect", "moon_ws_connect"},
+        {"ws_upgrade", "moon_ws_upgrade"},
+        {"ws_recv", "moon_ws_recv"},
+        {"ws_send", "moon_ws_send"},
+        {"ws_ping", "moon_ws_ping"},
+        {"ws_close", "moon_ws_close"},
+        {"ws_broadcast", "moon_ws_broadcast"},
+        {"ws_info", "moon_ws_info"},
         // TLS/SSL
         {"tls_connect", "moon_tls_connect"},
         {"tls_listen", "moon_tls_listen"},
@@ -448,10 +523,29 @@ Value* LLVMCodeGen::generateBuiltinCall(const std::string& name, const std::vect
         {"tls_wrap_client", "moon_tls_wrap_client"},
         {"tls_wrap_server", "moon_tls_wrap_server"},
         {"tls_init", "moon_tls_init"},
+        {"tls_pool_config", "moon_tls_pool_config"},
+        {"tls_pool_get", "moon_tls_pool_get"},
+        {"tls_pool_put", "moon_tls_pool_put"},
+        {"tls_pool_clear", "moon_tls_pool_clear"},
+        {"tls_pool_stats", "moon_tls_pool_stats"},
         // DLL
         {"dll_load", "moon_dll_load"},
         {"dll_close", "moon_dll_close"},
         {"dll_func", "moon_dll_func"},
+        // FFI
+        {"ffi_new", "moon_ffi_new"},
+        {"ffi_free", "moon_ffi_free"},
+        {"ffi_sizeof", "moon_ffi_sizeof"},
+        {"ffi_offsetof", "moon_ffi_offsetof"},
+        {"ffi_get", "moon_ffi_get"},
+        {"ffi_set", "moon_ffi_set"},
+        {"ffi_field", "moon_ffi_field"},
+        {"ffi_field_get", "moon_ffi_field_get"},
+        {"ffi_field_set", "moon_ffi_field_set"},
+        {"ffi_read_array", "moon_ffi_read_array"},
+        {"ffi_callback_type", "moon_ffi_callback_type"},
+        {"ffi_callback", "moon_ffi_callback_create"},
+        {"ffi_callback_free", "moon_ffi_callback_free"},
         {"alloc_str", "moon_alloc_str"},
         {"free_str", "moon_free_str"},
         {"ptr_to_str", "moon_ptr_to_str"},
@@ -594,6 +688,39 @@ Value* LLVMCodeGen::generateBuiltinCall(const std::string& name, const std::vect
         return result;
     }
     
+    // Calls whose trailing arguments are optional (padded with null):
+    // tcp_listen(port, options), tcp_accept_batch(server, max), tcp_recv(sock, max),
+    // recv_until(reader, delim, max), ...
+    static const std::map<std::string, size_t> optionalArgCalls = {
+        {"tcp_listen", 2}, {"tcp_listen_group", 2}, {"tcp_accept_batch", 2},
+        {"tcp_recv", 2}, {"tls_recv", 2}, {"recv_until", 3},
+        {"udp_send_batch", 5}, {"udp_recv_batch", 3},
+        {"http_serve", 3}, {"http_get", 2}, {"http_post", 3}, {"http_request", 3},
+        {"http_read", 2},
+        {"poller_add", 4}, {"poller_mod", 4}, {"poller_wait", 3},
+        {"ws_connect", 2}, {"ws_upgrade", 2}, {"ws_recv", 2}, {"ws_send", 3},
+        {"ws_ping", 2}, {"ws_close", 3}, {"ws_broadcast", 3},
+        {"buffer_from_ptr", 3}, {"buffer_slice", 3},
+    };
+    auto optIt = optionalArgCalls.find(funcName);
+    if (optIt != optionalArgCalls.end() && !args.empty() && args.size() < optIt->second) {
+        std::vector<Value*> argVals;
+        for (const auto& arg : args) {
+            argVals.push_back(generateExpression(arg));
+        }
+        while (argVals.size() < optIt->second) {
+            argVals.push_back(generateNullLiteral());
+        }
+        
+        Value* result = builder->CreateCall(getRuntimeFunction(funcMap[funcName]), argVals);
+        
+        for (auto& val : argVals) {
+            builder->CreateCall(getRuntimeFunction("moon_release"), {val});
+        }
+        
+        return result;
+    }
+    
     if (funcMap.count(funcName)) {
         std::string rtFunc = funcMap[funcName];
         std::vector<Value*> argVals;
@@ -770,12 +897,15 @@ Value* LLVMCodeGen::generateBuiltinCall(const std::string& name, const std::vect
     }
     
     // Network functions - set flag for network libraries
-    if (name.substr(0, 4) == "tcp_" || name.substr(0, 4) == "udp_") {
+    if (name.substr(0, 4) == "tcp_" || name.substr(0, 4) == "udp_" || name.substr(0, 4) == "dns_" ||
+        name.substr(0, 5) == "http_" || name.substr(0, 3) == "ws_" ||
+        name.substr(0, 7) == "poller_") {
         usesNetwork = true;
     }
     
     // TLS functions - set flag for crypto libraries (crypt32.lib on Windows)
-    if (name.substr(0, 4) == "tls_") {
+    if (name.substr(0, 4) == "tls_" || name == "http_get" || name == "http_post" ||
+        name == "http_request" || name == "ws_connect") {
         usesTLS = true;
         usesNetwork = true;  // TLS also needs ws2_32.lib
     }
@@ -1010,6 +1140,36 @@ Value* LLVMCodeGen::generateBuiltinCall(const std::string& name, const std::vect
         return generateNullLiteral();
     }
     
+    // gui_post_binary(winId, data) - 2 args
+    if (funcName == "gui_post_binary" && args.size() == 2) {
+        Value* winId = generateExpression(args[0]);
+        Value* data = generateExpression(args[1]);
+        builder->CreateCall(getRuntimeFunction("moon_gui_post_binary_win"), {winId, data});
+        builder->CreateCall(getRuntimeFunction("moon_release"), {winId});
+        builder->CreateCall(getRuntimeFunction("moon_release"), {data});
+        return generateNullLiteral();
+    }
+    
+    // gui_on_binary(winId, callback) - 2 args
+    if (funcName == "gui_on_binary" && args.size() == 2) {
+        Value* winId = generateExpression(args[0]);
+        Value* callback = generateExpression(args[1]);
+        builder->CreateCall(getRuntimeFunction("moon_gui_on_binary_win"), {winId, callback});
+        builder->CreateCall(getRuntimeFunction("moon_release"), {winId});
+        // Don't release callback - it's stored
+        return generateNullLiteral();
+    }
+    
+    // gui_async_handlers(winId, enabled) - 2 args
+    if (funcName == "gui_async_handlers" && args.size() == 2) {
+        Value* winId = generateExpression(args[0]);
+        Value* enabled = generateExpression(args[1]);
+        builder->CreateCall(getRuntimeFunction("moon_gui_async_handlers_win"), {winId, enabled});
+        builder->CreateCall(getRuntimeFunction("moon_release"), {winId});
+        builder->CreateCall(getRuntimeFunction("moon_release"), {enabled});
+        return generateNullLiteral();
+    }
+    
     // gui_minimize(winId) - 1 arg
     if (funcName == "gui_minimize" && args.size() == 1) {
         Value* winId = generateExpression(args[0]);
@@ -136,12 +136,70 @@ static std::string findRuntimeLib() {
     return "";
 }
 
+// Find a shared build of the runtime (for the JIT); empty when there is none
+static std::string findRuntimeSharedLib() {
+    namespace fs = std::filesystem;
+    std::string exeDir = getExeDirectory();
+#ifdef _WIN32
+    const char* name = "moonrt.dll";
+#elif defined(__APPLE__)
+    const char* name = "libmoonrt.dylib";
+#else
+    const char* name = "libmoonrt.so";
+#endif
+    for (const std::string& dir : {exeDir, exeDir + "/lib"}) {
+        std::string path = dir + "/" + name;
+        if (fs::exists(path)) {
+            return path;
+        }
+    }
+    return "";
+}
+
+std::string LLVMCodeGen::userCacheDir(const std::string& name) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+#ifdef _WIN32
+    const char* local = getenv("LOCALAPPDATA");
+    if (!local || !*local) return "";
+    fs::path dir = fs::path(local) / "moonc" / name;
+    fs::create_directories(dir, ec);
+    return fs::is_directory(dir, ec) ? dir.string() : "";
+#else
+    // $XDG_CACHE_HOME (only when absolute), else ~/.cache
+    fs::path base;
+    const char* xdg = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+    if (xdg && xdg[0] == '/') {
+        base = xdg;
+    } else if (home && *home) {
+        base = fs::path(home) / ".cache";
+    } else {
+        return "";
+    }
+    fs::create_directories(base, ec);
+    fs::path root = base / "moonc";
+    fs::path dir = root / name;
+    for (const fs::path& level : {root, dir}) {
+        if (mkdir(level.c_str(), 0700) != 0 && errno != EEXIST) return "";
+        // lstat, so a symlink planted in place of the directory is refused
+        struct stat st;
+        if (lstat(level.c_str(), &st) != 0 || !S_ISDIR(st.st_mode) || st.st_uid != geteuid()) {
+            return "";
+        }
+        if ((st.st_mode & 077) != 0 && chmod(level.c_str(), 0700) != 0) return "";
+    }
+    return dir.string();
+#endif
+}
+
 // ============================================================================
 // Main Compilation
 // ============================================================================
 
 bool LLVMCodeGen::compile(const Program& program, const std::string& moduleName) {
     module->setModuleIdentifier(moduleName);
+    symbols = program.symbols.get();
     
     // =====================================================
     // Pass 1: Forward declare all top-level functions
@@ -169,10 +227,14 @@ bool LLVMCodeGen::compile(const Program& program, const std::string& moduleName)
                 exportedFunctions.push_back({funcDecl->name, (int)funcDecl->params.size()});
             }
             
-            functions[funcDecl->name] = func;
+            functions[funcDecl->sym] = func;
         }
     }
     
+    // C functions declared by top-level literal ffi_cdef calls
+    scanFFIDeclarations(program.statements);
+    if (hasError()) return false;
+    
     // =====================================================
     // Pass 2: Create entry point(s) and generate all code
     // =====================================================
@@ -205,6 +267,7 @@ bool LLVMCodeGen::compile(const Program& program, const std::string& moduleName)
         Value* zeroInt = ConstantInt::get(Type::getInt32Ty(*context), 0);
         Value* nullPtr = ConstantPointerNull::get(PointerType::get(PointerType::get(Type::getInt8Ty(*context), 0), 0));
         builder->CreateCall(getRuntimeFunction("moon_runtime_init"), {zeroInt, nullPtr});
+        emitAssetSection();
         
         currentFunction = initFunc;
         mainFunction = initFunc;
@@ -290,6 +353,7 @@ bool LLVMCodeGen::compile(const Program& program, const std::string& moduleName)
         
         // Initialize runtime
         builder->CreateCall(getRuntimeFunction("moon_runtime_init"), {argc, argv});
+        emitAssetSection();
         
         currentFunction = mainFunc;
         mainFunction = mainFunc;  // Save reference to main function
@@ -349,7 +413,69 @@ bool LLVMCodeGen::emitBitcode(const std::string& filename) {
     return true;
 }
 
+// IR optimization pipeline shared by object emission and the JIT
+static void addOptimizationPasses(legacy::PassManager& pass) {
+    // Memory optimization - promote stack allocations to registers
+    pass.add(createPromoteMemoryToRegisterPass());
+    
+    // Scalar optimizations (first pass)
+    pass.add(createInstructionCombiningPass());
+    pass.add(createReassociatePass());
+    pass.add(createGVNPass());
+    pass.add(createCFGSimplificationPass());
+    
+    // Tail call elimination for recursive functions
+    pass.add(createTailCallEliminationPass());
+    
+    // Loop optimizations (available in legacy pass manager)
+    pass.add(createLICMPass());                 // Loop-invariant code motion
+    pass.add(createLoopUnrollPass());           // Unroll loops for better pipelining
+    
+    // Scalar optimizations (second pass)
+    pass.add(createInstructionCombiningPass());
+    pass.add(createGVNPass());
+    
+    // Dead code elimination
+    pass.add(createDeadCodeEliminationPass());
+    
+    // Final cleanup
+    pass.add(createInstructionCombiningPass());
+    pass.add(createCFGSimplificationPass());
+}
+
 bool LLVMCodeGen::emitObject(const std::string& filename) {
+    ObjectImage generated;
+    const ObjectImage* image = prebuiltObject;
+    if (!image) {
+        if (!emitObjectImage(generated)) {
+            return false;
+        }
+        image = &generated;
+    }
+    
+    std::error_code ec;
+    raw_fd_ostream dest(filename, ec, sys::fs::OF_None);
+    if (ec) {
+        setError("Cannot open file: " + filename);
+        return false;
+    }
+    dest.write(image->bytes.data(), image->bytes.size());
+    dest.flush();
+    return true;
+}
+
+void LLVMCodeGen::useObjectImage(const ObjectImage* image) {
+    prebuiltObject = image;
+    if (image) {
+        usesGUI = image->usesGUI;
+        usesNetwork = image->usesNetwork;
+        usesTLS = image->usesTLS;
+        exportedFunctions = image->exportedFunctions;
+        refcountStats = image->refcounts;
+    }
+}
+
+bool LLVMCodeGen::emitObjectImage(ObjectImage& image) {
     // Determine target triple
     std::string targetTriple;
     if (!customTargetTriple.empty()) {
@@ -397,42 +523,13 @@ bool LLVMCodeGen::emitObject(const std::string& filename) {
     
     module->setDataLayout(targetMachine->createDataLayout());
     
-    std::error_code ec;
-    raw_fd_ostream dest(filename, ec, sys::fs::OF_None);
-    if (ec) {
-        setError("Cannot open file: " + filename);
-        return false;
-    }
+    SmallVector<char, 0> buffer;
+    raw_svector_ostream dest(buffer);
     
-    // Add aggressive optimization passes for O3 level
+    // Add aggressive optimization passes for O3 level, after MoonLang's own refcount elision
     legacy::PassManager pass;
-    
-    // Memory optimization - promote stack allocations to registers
-    pass.add(createPromoteMemoryToRegisterPass());
-    
-    // Scalar optimizations (first pass)
-    pass.add(createInstructionCombiningPass());
-    pass.add(createReassociatePass());
-    pass.add(createGVNPass());
-    pass.add(createCFGSimplificationPass());
-    
-    // Tail call elimination for recursive functions
-    pass.add(createTailCallEliminationPass());
-    
-    // Loop optimizations (available in legacy pass manager)
-    pass.add(createLICMPass());                 // Loop-invariant code motion
-    pass.add(createLoopUnrollPass());           // Unroll loops for better pipelining
-    
-    // Scalar optimizations (second pass)
-    pass.add(createInstructionCombiningPass());
-    pass.add(createGVNPass());
-    
-    // Dead code elimination
-    pass.add(createDeadCodeEliminationPass());
-    
-    // Final cleanup
-    pass.add(createInstructionCombiningPass());
-    pass.add(createCFGSimplificationPass());
+    pass.add(new RefcountElisionPass(&refcountStats, exportedFunctionSymbols(exportedFunctions)));
+    addOptimizationPasses(pass);
     
     auto fileType = CodeGenFileType::ObjectFile;
     
@@ -442,8 +539,13 @@ bool LLVMCodeGen::emitObject(const std::string& filename) {
     }
     
     pass.run(*module);
-    dest.flush();
     
+    image.bytes.assign(buffer.data(), buffer.size());
+    image.usesGUI = usesGUI;
+    image.usesNetwork = usesNetwork;
+    image.usesTLS = usesTLS;
+    image.exportedFunctions = exportedFunctions;
+    image.refcounts = refcountStats;
     return true;
 }
 
@@ -79,19 +79,166 @@ Value* LLVMCodeGen::generateExpression(const ExprPtr& expr) {
     }, expr->value);
 }
 
+// ============================================================================
+// Literal Constants
+// ============================================================================
+// Number and string literals are emitted once as MoonValue globals with the
+// immortal refcount (INT32_MAX), which moon_retain/moon_release skip, so using a
+// literal costs its address instead of an allocation. MoonValue is { i32 type,
+// i32 refcount, 8-byte payload }; a string's characters follow a MoonStrHeader
+// in a second global, laid out like the runtime's own strings.
+
+static GlobalVariable* createLiteralGlobal(Module& module, Constant* init, const std::string& name) {
+    auto* global = new GlobalVariable(module, init->getType(), true, GlobalValue::PrivateLinkage, init, name);
+    global->setUnnamedAddr(GlobalValue::UnnamedAddr::Global);
+    global->setAlignment(Align(8));
+    return global;
+}
+
+Constant* LLVMCodeGen::intConstant(int64_t value) {
+    GlobalVariable*& global = intConstants[value];
+    if (!global) {
+        Type* i32Ty = Type::getInt32Ty(*context);
+        global = createLiteralGlobal(*module, ConstantStruct::getAnon({
+            ConstantInt::get(i32Ty, MOON_INT),
+            ConstantInt::get(i32Ty, INT32_MAX),
+            ConstantInt::get(Type::getInt64Ty(*context), value)}), "moon.int");
+    }
+    return global;
+}
+
+Constant* LLVMCodeGen::floatConstant(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    GlobalVariable*& global = floatConstants[bits];
+    if (!global) {
+        Type* i32Ty = Type::getInt32Ty(*context);
+        global = createLiteralGlobal(*module, ConstantStruct::getAnon({
+            ConstantInt::get(i32Ty, MOON_FLOAT),
+            ConstantInt::get(i32Ty, INT32_MAX),
+            ConstantFP::get(Type::getDoubleTy(*context), value)}), "moon.float");
+    }
+    return global;
+}
+
+Constant* LLVMCodeGen::stringConstant(const std::string& value) {
+    GlobalVariable*& global = stringConstants[value];
+    if (global) return global;
+
+    Type* i8Ty = Type::getInt8Ty(*context);
+    Type* i32Ty = Type::getInt32Ty(*context);
+    Type* i64Ty = Type::getInt64Ty(*context);
+    bool is64Bit = resolveTargetTriple(customTargetTriple).isArch64Bit();
+    Type* sizeTy = is64Bit ? i64Ty : i32Ty;
+
+    // FNV-1a, as hash_string_with_len()
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : value) {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+
+    Constant* header = ConstantStruct::getAnon({
+        ConstantInt::get(i64Ty, MOON_STR_MAGIC),
+        ConstantInt::get(sizeTy, value.size()),  // capacity
+        ConstantInt::get(sizeTy, value.size()),  // length
+        ConstantInt::get(i32Ty, hash),
+        ConstantInt::get(i8Ty, 1)});             // hashValid
+    Constant* chars = ConstantDataArray::getString(*context, value);
+    GlobalVariable* storage = createLiteralGlobal(*module, ConstantStruct::getAnon({header, chars}), "moon.str.data");
+    Constant* strVal = ConstantExpr::getInBoundsGetElementPtr(storage->getValueType(), storage,
+        ArrayRef<Constant*>{ConstantInt::get(i32Ty, 0), ConstantInt::get(i32Ty, 1), ConstantInt::get(i32Ty, 0)});
+
+    std::vector<Constant*> fields = {ConstantInt::get(i32Ty, MOON_STRING), ConstantInt::get(i32Ty, INT32_MAX), strVal};
+    if (!is64Bit) fields.push_back(ConstantInt::get(i32Ty, 0));  // Rest of the 8-byte payload
+    global = createLiteralGlobal(*module, ConstantStruct::getAnon(fields), "moon.str");
+    return global;
+}
+
+Constant* LLVMCodeGen::literalConstant(const ExprPtr& expr) {
+    if (auto* lit = std::get_if<IntegerLiteral>(&expr->value)) return intConstant(lit->value);
+    if (auto* lit = std::get_if<FloatLiteral>(&expr->value)) return floatConstant(lit->value);
+    if (auto* lit = std::get_if<::StringLiteral>(&expr->value)) return stringConstant(lit->value);
+
+    // Negative numbers are parsed as a negated literal
+    auto* unary = std::get_if<UnaryExpr>(&expr->value);
+    if (unary && unary->op == "-") {
+        if (auto* lit = std::get_if<IntegerLiteral>(&unary->operand->value)) return intConstant(-lit->value);
+        if (auto* lit = std::get_if<FloatLiteral>(&unary->operand->value)) return floatConstant(-lit->value);
+    }
+    return nullptr;
+}
+
+// ============================================================================
+// Stack Temporaries
+// ============================================================================
+// A value passed only to a runtime call that reads it and keeps no reference
+// (arithmetic, comparisons, truthiness, indexing) dies within the statement, so
+// when it is a number it is built in a MoonValue-sized slot of the current
+// function instead of the pool. Slots carry the immortal refcount, which makes
+// the release after the call a no-op. Each expression site gets its own slot in
+// the entry block, so a loop reuses it on every iteration.
+
+// A slot in the entry block; with a type, its header is written there once as well
+Value* LLVMCodeGen::temporarySlot(int type) {
+    Function* func = builder->GetInsertBlock()->getParent();
+    IRBuilder<> entry(&func->getEntryBlock(), func->getEntryBlock().begin());
+    Type* i32Ty = Type::getInt32Ty(*context);
+    StructType* valueTy = StructType::get(*context, {i32Ty, i32Ty, Type::getInt64Ty(*context)});
+    AllocaInst* slot = entry.CreateAlloca(valueTy, nullptr, "moon.tmp");
+    slot->setAlignment(Align(8));
+    if (type >= 0) {
+        entry.CreateStore(ConstantInt::get(i32Ty, type), entry.CreateStructGEP(valueTy, slot, 0));
+        entry.CreateStore(ConstantInt::get(i32Ty, INT32_MAX), entry.CreateStructGEP(valueTy, slot, 1));
+    }
+    return slot;
+}
+
+Value* LLVMCodeGen::temporaryInt(Value* nativeVal) {
+    if (auto* constant = dyn_cast<ConstantInt>(nativeVal)) return intConstant(constant->getSExtValue());
+    Value* slot = temporarySlot(MOON_INT);
+    builder->CreateStore(nativeVal, builder->CreateConstInBoundsGEP1_32(Type::getInt64Ty(*context), slot, 1));
+    return slot;
+}
+
+Value* LLVMCodeGen::temporaryFloat(Value* nativeVal) {
+    if (auto* constant = dyn_cast<ConstantFP>(nativeVal)) return floatConstant(constant->getValueAPF().convertToDouble());
+    Value* slot = temporarySlot(MOON_FLOAT);
+    builder->CreateStore(nativeVal, builder->CreateConstInBoundsGEP1_32(Type::getDoubleTy(*context), slot, 1));
+    return slot;
+}
+
+// generateExpression() for a value the caller only reads during one runtime call
+Value* LLVMCodeGen::generateOperand(const ExprPtr& expr) {
+    if (auto* binary = std::get_if<BinaryExpr>(&expr->value)) {
+        return generateBinaryExpr(*binary, true);
+    }
+    // Native variables are boxed into a temporary instead of the pool (see generateIdentifier)
+    auto* id = std::get_if<Identifier>(&expr->value);
+    if (id && !(inClosure && currentClosureCaptures.count(id->name))) {
+        auto typeIt = variableTypes.find(id->name);
+        if (typeIt != variableTypes.end()) {
+            if (typeIt->second == NativeType::NativeInt && nativeIntVars.count(id->name)) {
+                return temporaryInt(loadNativeInt(id->name));
+            }
+            if (typeIt->second == NativeType::NativeFloat && nativeFloatVars.count(id->name)) {
+                return temporaryFloat(loadNativeFloat(id->name));
+            }
+        }
+    }
+    return generateExpression(expr);
+}
+
 Value* LLVMCodeGen::generateIntegerLiteral(int64_t value) {
-    Value* intVal = ConstantInt::get(Type::getInt64Ty(*context), value);
-    return builder->CreateCall(getRuntimeFunction("moon_int"), {intVal});
+    return intConstant(value);
 }
 
 Value* LLVMCodeGen::generateFloatLiteral(double value) {
-    Value* floatVal = ConstantFP::get(Type::getDoubleTy(*context), value);
-    return builder->CreateCall(getRuntimeFunction("moon_float"), {floatVal});
+    return floatConstant(value);
 }
 
 Value* LLVMCodeGen::generateStringLiteral(const std::string& value) {
-    Value* strPtr = createGlobalString(value);
-    return builder->CreateCall(getRuntimeFunction("moon_string"), {strPtr});
+    return stringConstant(value);
 }
 
 Value* LLVMCodeGen::generateBoolLiteral(bool value) {
@@ -127,7 +274,8 @@ Value* LLVMCodeGen::generateIdentifier(const std::string& name) {
     return loadVariable(name);
 }
 
-Value* LLVMCodeGen::generateBinaryExpr(const BinaryExpr& expr) {
+// temporary: the result is only read by the caller's next runtime call (generateOperand)
+Value* LLVMCodeGen::generateBinaryExpr(const BinaryExpr& expr, bool temporary) {
     // Try native optimization for numeric operations
     NativeType leftType = inferExpressionType(expr.left);
     NativeType rightType = inferExpressionType(expr.right);
@@ -137,15 +285,16 @@ Value* LLVMCodeGen::generateBinaryExpr(const BinaryExpr& expr) {
         if ((leftType == NativeType::NativeInt || leftType == NativeType::NativeFloat) &&
             (rightType == NativeType::NativeInt || rightType == NativeType::NativeFloat)) {
             
-            NativeType resultType = inferExpressionType(std::make_shared<Expression>(Expression{expr, 0}));
+            Expression wrapped(expr, 0);
+            NativeType resultType = inferExpressionType(&wrapped);
             TypedValue result = generateNativeBinaryExpr(expr, resultType);
             
             // Box the result if it's native
             if (result.type == NativeType::NativeInt) {
-                return boxNativeInt(result.value);
+                return temporary ? temporaryInt(result.value) : boxNativeInt(result.value);
             }
             if (result.type == NativeType::NativeFloat) {
-                return boxNativeFloat(result.value);
+                return temporary ? temporaryFloat(result.value) : boxNativeFloat(result.value);
             }
             if (result.type == NativeType::NativeBool) {
                 // Convert native i1 bool to MoonValue* bool
@@ -156,9 +305,11 @@ Value* LLVMCodeGen::generateBinaryExpr(const BinaryExpr& expr) {
         }
     }
     
-    // Fall back to dynamic operations
-    Value* left = generateExpression(expr.left);
-    Value* right = generateExpression(expr.right);
+    // Fall back to dynamic operations. Only and/or return an operand; every other
+    // operator just reads them, so they can be temporaries.
+    bool logical = expr.op == "and" || expr.op == "&&" || expr.op == "or" || expr.op == "||";
+    Value* left = logical ? generateExpression(expr.left) : generateOperand(expr.left);
+    Value* right = logical ? generateExpression(expr.right) : generateOperand(expr.right);
     
     std::string funcName;
     if (expr.op == "+") funcName = "moon_add";
@@ -181,11 +332,17 @@ Value* LLVMCodeGen::generateBinaryExpr(const BinaryExpr& expr) {
     else if (expr.op == "<<") funcName = "moon_lshift";
     else if (expr.op == ">>") funcName = "moon_rshift";
     else {
-        setError("Unknown binary operator: " + expr.op);
+        setError("Unknown binary operator: " + std::string(expr.op));
         return generateNullLiteral();
     }
     
-    Value* result = builder->CreateCall(getRuntimeFunction(funcName), {left, right});
+    Value* result;
+    bool arithmetic = expr.op == "+" || expr.op == "-" || expr.op == "*" || expr.op == "/" || expr.op == "%";
+    if (temporary && arithmetic) {
+        result = builder->CreateCall(getRuntimeFunction(funcName + "_at"), {temporarySlot(), left, right});
+    } else {
+        result = builder->CreateCall(getRuntimeFunction(funcName), {left, right});
+    }
     
     // Release operands
     builder->CreateCall(getRuntimeFunction("moon_release"), {left});
@@ -195,7 +352,7 @@ Value* LLVMCodeGen::generateBinaryExpr(const BinaryExpr& expr) {
 }
 
 Value* LLVMCodeGen::generateUnaryExpr(const UnaryExpr& expr) {
-    Value* operand = generateExpression(expr.operand);
+    Value* operand = generateOperand(expr.operand);
     
     Value* result;
     if (expr.op == "-") {
@@ -208,7 +365,7 @@ Value* LLVMCodeGen::generateUnaryExpr(const UnaryExpr& expr) {
         result = builder->CreateCall(getRuntimeFunction("moon_bit_not"), {operand});
     }
     else {
-        setError("Unknown unary operator: " + expr.op);
+        setError("Unknown unary operator: " + std::string(expr.op));
         return operand;
     }
     
@@ -219,8 +376,15 @@ Value* LLVMCodeGen::generateUnaryExpr(const UnaryExpr& expr) {
 Value* LLVMCodeGen::generateCallExpr(const CallExpr& expr) {
     // Get function name
     std::string funcName;
+    Symbol funcSym = NO_SYMBOL;
     if (auto* id = std::get_if<Identifier>(&expr.callee->value)) {
         funcName = id->name;
+        funcSym = id->sym;
+    }
+    
+    // C function declared with a literal ffi_cdef: direct native call
+    if (!funcName.empty() && ffiFunctions.count(funcName)) {
+        return generateFFICall(ffiFunctions[funcName], expr.arguments, false).value;
     }
     
     // Check if it's a built-in function
@@ -229,9 +393,11 @@ Value* LLVMCodeGen::generateCallExpr(const CallExpr& expr) {
     }
     
     // Check if it's a user-defined function
-    if (!funcName.empty() && functions.count(funcName)) {
+    auto funcIt = functions.find(funcSym);
+    if (funcIt != functions.end()) {
         size_t argCount = expr.arguments.size();
-        size_t paramCount = functionParamCounts.count(funcName) ? functionParamCounts[funcName] : 0;
+        auto countIt = functionParamCounts.find(funcSym);
+        size_t paramCount = countIt != functionParamCounts.end() ? countIt->second : 0;
         
         // If all arguments are provided, we can potentially use native version
         if (argCount == paramCount && nativeFunctions.count(funcName)) {
@@ -245,7 +411,7 @@ Value* LLVMCodeGen::generateCallExpr(const CallExpr& expr) {
             for (const auto& arg : expr.arguments) {
                 args.push_back(generateExpression(arg));
             }
-            return builder->CreateCall(functions[funcName], args);
+            return builder->CreateCall(funcIt->second, args);
         }
         
         // Fewer arguments provided - use wrapper function which handles defaults
@@ -283,9 +449,12 @@ Value* LLVMCodeGen::generateCallExpr(const CallExpr& expr) {
     if (auto* member = std::get_if<MemberExpr>(&expr.callee->value)) {
         // Check if this is a static method call on a class (ClassName.method())
         std::string className;
+        GlobalVariable* classGlobal = nullptr;
         if (auto* id = std::get_if<Identifier>(&member->object->value)) {
-            if (classDefinitions.count(id->name)) {
+            auto classIt = classDefinitions.find(id->sym);
+            if (classIt != classDefinitions.end()) {
                 className = id->name;
+                classGlobal = classIt->second;
             }
         }
         
@@ -311,7 +480,7 @@ Value* LLVMCodeGen::generateCallExpr(const CallExpr& expr) {
             // Call the static method via the class object
             Value* klassPtr = builder->CreateLoad(
                 PointerType::get(Type::getInt8Ty(*context), 0),
-                classDefinitions[className]
+                classGlobal
             );
             Value* methodName = createGlobalString(member->member);
             result = builder->CreateCall(getRuntimeFunction("moon_class_call_static_method"),
@@ -422,7 +591,7 @@ Value* LLVMCodeGen::generateIndexExpr(const IndexExpr& expr) {
     }
     
     // Standard path: generate index as MoonValue*
-    Value* index = generateExpression(expr.index);
+    Value* index = generateOperand(expr.index);
     
     // Use list_get for both lists and dicts (runtime handles it)
     Value* result = builder->CreateCall(getRuntimeFunction("moon_list_get"), {obj, index});
@@ -444,6 +613,20 @@ Value* LLVMCodeGen::generateMemberExpr(const MemberExpr& expr) {
 }
 
 Value* LLVMCodeGen::generateListExpr(const ListExpr& expr) {
+    // All elements literal: the list shares a static item array until it is modified
+    std::vector<Constant*> items;
+    for (const auto& elem : expr.elements) {
+        Constant* item = literalConstant(elem);
+        if (!item) break;
+        items.push_back(item);
+    }
+    if (!items.empty() && items.size() == expr.elements.size()) {
+        Constant* array = createLiteralGlobal(*module,
+            ConstantArray::get(ArrayType::get(moonValuePtrType, items.size()), items), "moon.list");
+        Value* count = ConstantInt::get(Type::getInt32Ty(*context), items.size());
+        return builder->CreateCall(getRuntimeFunction("moon_list_const"), {array, count});
+    }
+
     Value* list = builder->CreateCall(getRuntimeFunction("moon_list_new"), {});
     
     for (const auto& elem : expr.elements) {
@@ -456,6 +639,26 @@ Value* LLVMCodeGen::generateListExpr(const ListExpr& expr) {
 }
 
 Value* LLVMCodeGen::generateDictExpr(const DictExpr& expr) {
+    // All keys and values literal: the runtime builds the table once and each evaluation
+    // shares it until modified
+    std::vector<Constant*> keys, values;
+    for (const auto& entry : expr.entries) {
+        Constant* key = literalConstant(entry.key);
+        Constant* val = key ? literalConstant(entry.value) : nullptr;
+        if (!val) break;
+        keys.push_back(key);
+        values.push_back(val);
+    }
+    if (!keys.empty() && keys.size() == expr.entries.size()) {
+        ArrayType* arrayTy = ArrayType::get(moonValuePtrType, keys.size());
+        Constant* keyArray = createLiteralGlobal(*module, ConstantArray::get(arrayTy, keys), "moon.dict.keys");
+        Constant* valueArray = createLiteralGlobal(*module, ConstantArray::get(arrayTy, values), "moon.dict.values");
+        auto* table = new GlobalVariable(*module, moonValuePtrType, false, GlobalValue::InternalLinkage,
+                                         Constant::getNullValue(moonValuePtrType), "moon.dict");
+        Value* count = ConstantInt::get(Type::getInt32Ty(*context), keys.size());
+        return builder->CreateCall(getRuntimeFunction("moon_dict_const"), {table, keyArray, valueArray, count});
+    }
+
     Value* dict = builder->CreateCall(getRuntimeFunction("moon_dict_new"), {});
     
     for (const auto& entry : expr.entries) {
@@ -658,14 +861,15 @@ Value* LLVMCodeGen::generateLambdaExpr(const LambdaExpr& expr) {
 
 Value* LLVMCodeGen::generateNewExpr(const NewExpr& expr) {
     // Get class
-    if (!classDefinitions.count(expr.className)) {
+    auto classIt = classDefinitions.find(expr.classSym);
+    if (classIt == classDefinitions.end()) {
         setError("Unknown class: " + expr.className);
         return generateNullLiteral();
     }
     
     Value* klassPtr = builder->CreateLoad(
         PointerType::get(Type::getInt8Ty(*context), 0),
-        classDefinitions[expr.className]
+        classIt->second
     );
     
     Value* obj = builder->CreateCall(getRuntimeFunction("moon_object_new"), {klassPtr});
@@ -785,7 +989,7 @@ void LLVMCodeGen::collectFreeVars(const ExprPtr& expr,
                               nativeFloatVars.count(arg.name) > 0 ||
                               currentClosureCaptures.count(arg.name) > 0;
             
-            if (functions.find(arg.name) == functions.end() && isLocalVar) {
+            if (functions.find(arg.sym) == functions.end() && isLocalVar) {
                 freeVars.insert(arg.name);
             }
         }
@@ -0,0 +1,1349 @@
+// ============================================================================
+// FFI Direct Call Module
+// ============================================================================
+// Compile-time lowering of ffi_cdef declarations. When the declaration string
+// is a literal, the C prototypes are parsed here and every call to a declared
+// function becomes a direct LLVM call with the exact C signature: integers and
+// pointers in integer registers, float/double in FP registers, small structs
+// by value following the target ABI, and variadic tails. Arguments are unboxed
+// inline (tag check with a runtime fallback) or taken straight from native
+// expressions, so no argument array or per-call marshalling is involved.
+//
+// IMPORTANT: This file should be included by llvm_codegen.cpp, not compiled
+// separately.
+// ============================================================================
+
+// ============================================================================
+// Target Helpers
+// ============================================================================
+
+// Size and alignment of a C type under natural alignment rules
+static void ffiLayoutOf(const std::map<std::string, FFICStruct>& structs, const FFICType& type,
+                        int ptrBytes, uint64_t& size, uint64_t& align) {
+    switch (type.kind) {
+        case FFICType::Void:   size = 0; align = 1; break;
+        case FFICType::Int:    size = type.bits / 8; align = size; break;
+        case FFICType::Float:  size = 4; align = 4; break;
+        case FFICType::Double: size = 8; align = 8; break;
+        case FFICType::Ptr:
+        case FFICType::CStr:   size = ptrBytes; align = ptrBytes; break;
+        case FFICType::Struct: {
+            auto it = structs.find(type.structName);
+            if (it == structs.end()) { size = 0; align = 1; break; }
+            size = it->second.size;
+            align = it->second.align;
+            break;
+        }
+    }
+}
+
+static void ffiLayoutStruct(const std::map<std::string, FFICStruct>& structs, FFICStruct& st, int ptrBytes) {
+    uint64_t offset = 0;
+    uint64_t maxAlign = 1;
+    for (auto& field : st.fields) {
+        uint64_t size, align;
+        ffiLayoutOf(structs, field.type, ptrBytes, size, align);
+        offset = (offset + align - 1) / align * align;
+        field.offset = offset;
+        offset += size * field.count;
+        if (align > maxAlign) maxAlign = align;
+    }
+    st.align = maxAlign;
+    st.size = (offset + maxAlign - 1) / maxAlign * maxAlign;
+}
+
+// Flatten a type into its scalar leaves (offset, kind) for ABI classification
+static void ffiFlatten(const std::map<std::string, FFICStruct>& structs, const FFICType& type,
+                       uint64_t base, int ptrBytes, std::vector<std::pair<uint64_t, FFICType::Kind>>& out) {
+    if (type.kind != FFICType::Struct) {
+        out.push_back({base, type.kind});
+        return;
+    }
+    auto it = structs.find(type.structName);
+    if (it == structs.end()) return;
+    for (const auto& field : it->second.fields) {
+        uint64_t size, align;
+        ffiLayoutOf(structs, field.type, ptrBytes, size, align);
+        for (uint64_t i = 0; i < field.count; i++) {
+            ffiFlatten(structs, field.type, base + field.offset + i * size, ptrBytes, out);
+        }
+    }
+}
+
+// ============================================================================
+// C Declaration Parser
+// ============================================================================
+// Accepts the subset of C that describes a binary interface:
+//   typedef struct [Tag] { fields } Name [, *PName];
+//   typedef <type> Name;   typedef <ret> (*Name)(<params>);
+//   [extern] <ret> name(<params> [, ...]);
+// Qualifiers, calling-convention keywords and __attribute__/__declspec are
+// skipped; variable declarations are ignored like the runtime parser does.
+
+struct FFIToken {
+    enum Kind { End, Ident, Number, Punct } kind;
+    std::string text;
+};
+
+static std::vector<FFIToken> ffiTokenize(const std::string& src) {
+    std::vector<FFIToken> toks;
+    size_t i = 0, n = src.size();
+    while (i < n) {
+        unsigned char c = (unsigned char)src[i];
+        if (isspace(c)) { i++; continue; }
+        if (c == '/' && i + 1 < n && src[i + 1] == '/') {
+            while (i < n && src[i] != '\n') i++;
+            continue;
+        }
+        if (c == '/' && i + 1 < n && src[i + 1] == '*') {
+            size_t end = src.find("*/", i + 2);
+            i = (end == std::string::npos) ? n : end + 2;
+            continue;
+        }
+        if (c == '#') {  // Preprocessor lines carry nothing we can use
+            while (i < n && src[i] != '\n') i++;
+            continue;
+        }
+        if (isalpha(c) || c == '_') {
+            size_t start = i;
+            while (i < n && (isalnum((unsigned char)src[i]) || src[i] == '_')) i++;
+            toks.push_back({FFIToken::Ident, src.substr(start, i - start)});
+            continue;
+        }
+        if (isdigit(c)) {
+            size_t start = i;
+            while (i < n && isalnum((unsigned char)src[i])) i++;
+            toks.push_back({FFIToken::Number, src.substr(start, i - start)});
+            continue;
+        }
+        if (src.compare(i, 3, "...") == 0) {
+            toks.push_back({FFIToken::Punct, "..."});
+            i += 3;
+            continue;
+        }
+        toks.push_back({FFIToken::Punct, std::string(1, (char)c)});
+        i++;
+    }
+    toks.push_back({FFIToken::End, ""});
+    return toks;
+}
+
+class FFIDeclParser {
+public:
+    FFIDeclParser(const std::string& source, std::map<std::string, FFICStruct>& structs,
+                  std::map<std::string, FFICType>& typedefs, bool windows, int ptrBits)
+        : toks(ffiTokenize(source)), structs(structs), typedefs(typedefs),
+          windows(windows), ptrBits(ptrBits) {}
+
+    bool parse(std::vector<FFICFunction>& functions, std::vector<std::string>& newTypes) {
+        while (peek().kind != FFIToken::End) {
+            if (!parseDeclaration(functions, newTypes)) return false;
+        }
+        return true;
+    }
+
+    const std::string& error() const { return err; }
+
+private:
+    std::vector<FFIToken> toks;
+    size_t pos = 0;
+    std::string err;
+    std::map<std::string, FFICStruct>& structs;
+    std::map<std::string, FFICType>& typedefs;
+    bool windows;
+    int ptrBits;
+
+    const FFIToken& peek(size_t ahead = 0) const {
+        size_t k = pos + ahead;
+        return toks[k < toks.size() ? k : toks.size() - 1];
+    }
+    bool isPunct(const char* p, size_t ahead = 0) const {
+        return peek(ahead).kind == FFIToken::Punct && peek(ahead).text == p;
+    }
+    bool isWord(const char* w, size_t ahead = 0) const {
+        return peek(ahead).kind == FFIToken::Ident && peek(ahead).text == w;
+    }
+    bool accept(const char* p) {
+        if (!isPunct(p)) return false;
+        pos++;
+        return true;
+    }
+    bool fail(const std::string& msg) {
+        if (err.empty()) err = msg;
+        return false;
+    }
+    bool expect(const char* p) {
+        if (accept(p)) return true;
+        return fail(std::string("expected '") + p + "' near '" + peek().text + "'");
+    }
+
+    FFICType ptrType() const {
+        FFICType t;
+        t.kind = FFICType::Ptr;
+        t.bits = ptrBits;
+        t.isSigned = false;
+        return t;
+    }
+    FFICType intType(int bits, bool isSigned) const {
+        FFICType t;
+        t.kind = FFICType::Int;
+        t.bits = bits;
+        t.isSigned = isSigned;
+        return t;
+    }
+
+    void skipParens() {
+        if (!isPunct("(")) return;
+        int depth = 0;
+        do {
+            if (isPunct("(")) depth++;
+            else if (isPunct(")")) depth--;
+            pos++;
+        } while (depth > 0 && peek().kind != FFIToken::End);
+    }
+
+    // Qualifiers, storage classes, calling conventions and attributes
+    void skipNoise() {
+        static const std::set<std::string> noise = {
+            "const", "volatile", "restrict", "__restrict", "__restrict__", "extern",
+            "static", "inline", "__inline", "__extension__", "__cdecl", "__stdcall",
+            "__fastcall", "__vectorcall", "WINAPI", "WINAPIV", "APIENTRY", "CDECL"
+        };
+        while (peek().kind == FFIToken::Ident) {
+            const std::string& w = peek().text;
+            if (noise.count(w)) {
+                pos++;
+            } else if (w == "__declspec" || w == "__attribute__" || w == "__asm__" || w == "__asm") {
+                pos++;
+                skipParens();
+            } else {
+                return;
+            }
+        }
+    }
+
+    // Fixed-width and platform names that need no typedef
+    bool builtinNamedType(const std::string& w, FFICType& t) const {
+        static const std::map<std::string, std::pair<int, bool>> fixed = {
+            {"int8_t", {8, true}}, {"uint8_t", {8, false}},
+            {"int16_t", {16, true}}, {"uint16_t", {16, false}},
+            {"int32_t", {32, true}}, {"uint32_t", {32, false}},
+            {"int64_t", {64, true}}, {"uint64_t", {64, false}},
+            {"off_t", {64, true}}, {"BYTE", {8, false}}, {"WORD", {16, false}},
+            {"DWORD", {32, false}}, {"UINT", {32, false}}, {"INT", {32, true}},
+            {"BOOL", {32, true}}, {"LONG", {32, true}}, {"ULONG", {32, false}},
+            {"ULONGLONG", {64, false}}, {"LONGLONG", {64, true}}
+        };
+        auto it = fixed.find(w);
+        if (it != fixed.end()) { t = intType(it->second.first, it->second.second); return true; }
+        if (w == "size_t" || w == "uintptr_t") { t = intType(ptrBits, false); return true; }
+        if (w == "ssize_t" || w == "intptr_t" || w == "ptrdiff_t") { t = intType(ptrBits, true); return true; }
+        if (w == "wchar_t") { t = windows ? intType(16, false) : intType(32, true); return true; }
+        if (w == "HANDLE" || w == "HWND" || w == "HMODULE" || w == "HINSTANCE" ||
+            w == "LPVOID" || w == "PVOID" || w == "LPCWSTR" || w == "LPWSTR") {
+            t = ptrType();
+            return true;
+        }
+        if (w == "LPCSTR" || w == "LPSTR" || w == "PCSTR") {
+            t = ptrType();
+            t.kind = FFICType::CStr;
+            return true;
+        }
+        return false;
+    }
+
+    // Declaration specifiers (no pointer declarators). isChar is set for the
+    // char keyword so that char* can become a C string.
+    bool parseSpecifiers(FFICType& out, bool& isChar) {
+        int longs = 0;
+        bool sawUnsigned = false, sawSigned = false, sawShort = false, sawChar = false;
+        bool sawInt = false, sawFloat = false, sawDouble = false, sawVoid = false, sawBool = false;
+        bool named = false;
+        FFICType t;
+
+        for (;;) {
+            skipNoise();
+            if (peek().kind != FFIToken::Ident) break;
+            const std::string w = peek().text;
+            bool keyword = sawUnsigned || sawSigned || sawShort || sawChar || sawInt ||
+                           sawFloat || sawDouble || sawVoid || sawBool || longs > 0;
+
+            if (w == "unsigned") sawUnsigned = true;
+            else if (w == "signed") sawSigned = true;
+            else if (w == "short") sawShort = true;
+            else if (w == "long") longs++;
+            else if (w == "char") sawChar = true;
+            else if (w == "int") sawInt = true;
+            else if (w == "float") sawFloat = true;
+            else if (w == "double") sawDouble = true;
+            else if (w == "void") sawVoid = true;
+            else if (w == "_Bool" || w == "bool") sawBool = true;
+            else if (w == "struct" || w == "union" || w == "enum") {
+                if (keyword || named) return fail("unexpected '" + w + "'");
+                pos++;
+                if (peek().kind != FFIToken::Ident) return fail("expected a name after '" + w + "'");
+                std::string tag = peek().text;
+                pos++;
+                if (w == "enum") {
+                    t = intType(32, true);
+                } else {
+                    auto td = typedefs.find("struct " + tag);
+                    if (td != typedefs.end()) {
+                        t = td->second;
+                    } else {
+                        // Unknown tags are opaque: usable behind a pointer only
+                        t = FFICType();
+                        t.kind = FFICType::Struct;
+                        t.structName = structs.count(tag) ? tag : "";
+                    }
+                }
+                named = true;
+                break;
+            }
+            else if (!keyword && !named) {
+                auto td = typedefs.find(w);
+                if (td != typedefs.end()) {
+                    t = td->second;
+                } else if (structs.count(w)) {
+                    t = FFICType();
+                    t.kind = FFICType::Struct;
+                    t.structName = w;
+                } else if (!builtinNamedType(w, t)) {
+                    break;
+                }
+                named = true;
+                pos++;
+                break;
+            }
+            else break;
+            pos++;
+        }
+
+        isChar = sawChar && !named;
+        if (named) {
+            out = t;
+            return true;
+        }
+        if (!(sawUnsigned || sawSigned || sawShort || sawChar || sawInt || sawFloat ||
+              sawDouble || sawVoid || sawBool || longs > 0)) {
+            return fail("unknown type '" + peek().text + "'");
+        }
+        if (sawVoid) {
+            t = FFICType();
+            t.kind = FFICType::Void;
+        } else if (sawFloat) {
+            t = FFICType();
+            t.kind = FFICType::Float;
+        } else if (sawDouble) {
+            if (longs > 0) return fail("long double is not supported");
+            t = FFICType();
+            t.kind = FFICType::Double;
+        } else if (sawBool) {
+            t = intType(8, false);
+        } else if (sawChar) {
+            t = intType(8, !sawUnsigned);
+        } else if (sawShort) {
+            t = intType(16, !sawUnsigned);
+        } else if (longs >= 2) {
+            t = intType(64, !sawUnsigned);
+        } else if (longs == 1) {
+            t = intType(windows ? 32 : ptrBits, !sawUnsigned);  // LLP64 vs LP64
+        } else {
+            t = intType(32, !sawUnsigned);
+        }
+        out = t;
+        return true;
+    }
+
+    FFICType parsePointers(const FFICType& base, bool isChar) {
+        int stars = 0;
+        for (;;) {
+            skipNoise();
+            if (!accept("*")) break;
+            stars++;
+        }
+        if (stars == 0) return base;
+        FFICType t = ptrType();
+        if (stars == 1 && isChar) t.kind = FFICType::CStr;
+        return t;
+    }
+
+    bool parseType(FFICType& out) {
+        bool isChar = false;
+        if (!parseSpecifiers(out, isChar)) return false;
+        out = parsePointers(out, isChar);
+        return true;
+    }
+
+    bool checkByValue(const FFICType& t, const std::string& what) {
+        if (t.kind == FFICType::Struct && (t.structName.empty() || !structs.count(t.structName))) {
+            return fail(what + " uses an incomplete struct type by value");
+        }
+        return true;
+    }
+
+    bool parseParam(FFICType& t) {
+        if (!parseType(t)) return false;
+        skipNoise();
+        if (isPunct("(")) {
+            // Function pointer: ret (*name)(params)
+            skipParens();
+            skipNoise();
+            skipParens();
+            t = ptrType();
+            return true;
+        }
+        if (peek().kind == FFIToken::Ident) pos++;  // Parameter name
+        while (accept("[")) {
+            while (!isPunct("]") && peek().kind != FFIToken::End) pos++;
+            if (!expect("]")) return false;
+            t = ptrType();  // Arrays decay to pointers
+        }
+        return true;
+    }
+
+    bool parseStructBody(FFICStruct& st) {
+        if (!expect("{")) return false;
+        while (!accept("}")) {
+            if (peek().kind == FFIToken::End) return fail("unterminated struct");
+            FFICType base;
+            bool isChar = false;
+            if (!parseSpecifiers(base, isChar)) return false;
+            for (;;) {
+                FFICField field;
+                field.type = parsePointers(base, isChar);
+                skipNoise();
+                if (peek().kind != FFIToken::Ident) return fail("expected a field name near '" + peek().text + "'");
+                field.name = peek().text;
+                pos++;
+                while (accept("[")) {
+                    if (peek().kind != FFIToken::Number) return fail("expected an array size for field '" + field.name + "'");
+                    field.count *= strtoull(peek().text.c_str(), nullptr, 0);
+                    pos++;
+                    if (!expect("]")) return false;
+                }
+                if (field.type.kind == FFICType::Void) return fail("field '" + field.name + "' has type void");
+                if (!checkByValue(field.type, "field '" + field.name + "'")) return false;
+                st.fields.push_back(field);
+                if (!accept(",")) break;
+            }
+            if (!expect(";")) return false;
+        }
+        ffiLayoutStruct(structs, st, ptrBits / 8);
+        return true;
+    }
+
+    bool parseTypedef(std::vector<std::string>& newTypes) {
+        skipNoise();
+        if (isWord("struct") && (isPunct("{", 1) || (peek(1).kind == FFIToken::Ident && isPunct("{", 2)))) {
+            pos++;
+            std::string tag;
+            if (peek().kind == FFIToken::Ident) {
+                tag = peek().text;
+                pos++;
+            }
+            FFICStruct st;
+            if (!parseStructBody(st)) return false;
+
+            skipNoise();
+            std::string name = tag;
+            if (peek().kind == FFIToken::Ident) {
+                name = peek().text;
+                pos++;
+            }
+            if (name.empty()) return fail("typedef struct needs a name");
+
+            structs[name] = st;
+            newTypes.push_back(name);
+            FFICType structType;
+            structType.kind = FFICType::Struct;
+            structType.structName = name;
+            if (!tag.empty()) typedefs["struct " + tag] = structType;
+
+            // Further declarators: typedef struct {...} Point, *PPoint;
+            while (accept(",")) {
+                FFICType t = parsePointers(structType, false);
+                if (peek().kind != FFIToken::Ident) return fail("expected a typedef name");
+                typedefs[peek().text] = t;
+                pos++;
+            }
+            return expect(";");
+        }
+
+        FFICType t;
+        if (!parseType(t)) return false;
+        skipNoise();
+        std::string name;
+        if (accept("(")) {
+            // Function pointer typedef: ret (*Name)(params)
+            skipNoise();
+            accept("*");
+            skipNoise();
+            if (peek().kind != FFIToken::Ident) return fail("expected a typedef name");
+            name = peek().text;
+            pos++;
+            if (!expect(")")) return false;
+            skipParens();
+            t = ptrType();
+            newTypes.push_back(name);
+        } else {
+            if (peek().kind != FFIToken::Ident) return fail("expected a typedef name near '" + peek().text + "'");
+            name = peek().text;
+            pos++;
+        }
+        typedefs[name] = t;
+        return expect(";");
+    }
+
+    bool parseDeclaration(std::vector<FFICFunction>& functions, std::vector<std::string>& newTypes) {
+        if (accept(";")) return true;
+        skipNoise();
+        if (isWord("typedef")) {
+            pos++;
+            return parseTypedef(newTypes);
+        }
+
+        FFICFunction fn;
+        if (!parseType(fn.ret)) return false;
+        skipNoise();
+        if (peek().kind != FFIToken::Ident) return fail("expected a function name near '" + peek().text + "'");
+        fn.name = peek().text;
+        pos++;
+        skipNoise();
+
+        if (!accept("(")) {
+            // Variable declaration: nothing to call, skip it
+            while (!isPunct(";") && peek().kind != FFIToken::End) pos++;
+            accept(";");
+            return true;
+        }
+
+        if (isWord("void") && isPunct(")", 1)) pos++;
+        while (!isPunct(")")) {
+            if (accept("...")) {
+                fn.varArgs = true;
+                break;
+            }
+            FFICType param;
+            if (!parseParam(param)) return false;
+            if (param.kind == FFICType::Void) return fail("parameter of type void in '" + fn.name + "'");
+            if (!checkByValue(param, "parameter of '" + fn.name + "'")) return false;
+            fn.params.push_back(param);
+            if (!accept(",")) break;
+        }
+        if (!expect(")")) return false;
+        skipNoise();
+        if (!checkByValue(fn.ret, "return value of '" + fn.name + "'")) return false;
+        if (!expect(";")) return false;
+
+        functions.push_back(fn);
+        return true;
+    }
+};
+
+// ============================================================================
+// Declaration Registration
+// ============================================================================
+
+bool LLVMCodeGen::parseFFIDeclarations(const std::string& source, std::vector<std::string>& declared,
+                                       bool& hasTypes) {
+    Triple triple = resolveTargetTriple(customTargetTriple);
+    FFIDeclParser parser(source, ffiStructs, ffiTypedefs, triple.isOSWindows(),
+                         triple.isArch64Bit() ? 64 : 32);
+
+    std::vector<FFICFunction> parsed;
+    std::vector<std::string> newTypes;
+    if (!parser.parse(parsed, newTypes)) {
+        setError("ffi_cdef: " + parser.error());
+        return false;
+    }
+    hasTypes = !newTypes.empty();
+
+    Type* i8PtrTy = PointerType::get(Type::getInt8Ty(*context), 0);
+    for (auto& fn : parsed) {
+        if (!lowerFFIFunction(fn)) return false;
+
+        // One slot per C name, shared by every declaration of it
+        auto it = ffiFunctions.find(fn.name);
+        if (it != ffiFunctions.end()) {
+            fn.slot = it->second.slot;
+        } else {
+            fn.slot = new GlobalVariable(*module, i8PtrTy, false, GlobalValue::InternalLinkage,
+                                         ConstantPointerNull::get(cast<PointerType>(i8PtrTy)),
+                                         "ffi." + fn.name);
+        }
+        ffiFunctions[fn.name] = fn;
+        declared.push_back(fn.name);
+    }
+    return true;
+}
+
+void LLVMCodeGen::scanFFIDeclarations(const std::vector<StmtPtr>& stmts) {
+    // Top-level declarations are registered up front so functions defined
+    // earlier in the file can call them directly as well
+    for (const auto& stmt : stmts) {
+        const ExprPtr* expr = nullptr;
+        if (auto* es = std::get_if<ExpressionStmt>(&stmt->value)) expr = &es->expression;
+        else if (auto* as = std::get_if<AssignStmt>(&stmt->value)) expr = &as->value;
+        if (!expr || !*expr) continue;
+
+        auto* call = std::get_if<CallExpr>(&(*expr)->value);
+        if (!call || call->arguments.empty()) continue;
+        auto* id = std::get_if<Identifier>(&call->callee->value);
+        if (!id || id->name != "ffi_cdef") continue;
+        auto* lit = std::get_if<::StringLiteral>(&call->arguments[0]->value);
+        if (!lit) continue;
+
+        currentLine = stmt->line;
+        std::vector<std::string> declared;
+        bool hasTypes = false;
+        if (!parseFFIDeclarations(lit->value, declared, hasTypes)) return;
+    }
+}
+
+void LLVMCodeGen::getFFITypeLayout(const FFICType& type, uint64_t& size, uint64_t& align) {
+    int ptrBytes = resolveTargetTriple(customTargetTriple).isArch64Bit() ? 8 : 4;
+    ffiLayoutOf(ffiStructs, type, ptrBytes, size, align);
+}
+
+Type* LLVMCodeGen::getFFILLVMType(const FFICType& type) {
+    switch (type.kind) {
+        case FFICType::Void:   return Type::getVoidTy(*context);
+        case FFICType::Int:    return Type::getIntNTy(*context, type.bits);
+        case FFICType::Float:  return Type::getFloatTy(*context);
+        case FFICType::Double: return Type::getDoubleTy(*context);
+        case FFICType::Ptr:
+        case FFICType::CStr:   return PointerType::get(Type::getInt8Ty(*context), 0);
+        case FFICType::Struct: {
+            FFICStruct& st = ffiStructs[type.structName];
+            if (!st.llvmType) {
+                std::vector<Type*> fields;
+                for (const auto& field : st.fields) {
+                    Type* ft = getFFILLVMType(field.type);
+                    fields.push_back(field.count == 1 ? ft : ArrayType::get(ft, field.count));
+                }
+                st.llvmType = StructType::create(*context, fields, "ffi." + type.structName);
+            }
+            return st.llvmType;
+        }
+    }
+    return Type::getVoidTy(*context);
+}
+
+// ============================================================================
+// ABI Lowering
+// ============================================================================
+// Scalars map one-to-one onto LLVM types and the backend applies the calling
+// convention. Structs by value need the front-end half of the ABI, mirroring
+// what a C compiler emits:
+//   x86-64 SysV: <= 16 bytes split into eightbytes (SSE if all-FP, else
+//                INTEGER) passed as separate registers, larger ones byval;
+//                returned in rax/rdx/xmm0/xmm1 or through sret.
+//   Win64:       1/2/4/8-byte structs as integers, others by reference;
+//                returned in rax or through sret.
+//   AArch64:     HFAs (1-4 floats or doubles) in FP registers, other
+//                structs <= 16 bytes in x registers, larger by reference;
+//                returned likewise or through sret (x8).
+
+bool LLVMCodeGen::lowerFFIFunction(FFICFunction& fn) {
+    Triple triple = resolveTargetTriple(customTargetTriple);
+    bool sysv = triple.getArch() == Triple::x86_64 && !triple.isOSWindows();
+    bool win64 = triple.getArch() == Triple::x86_64 && triple.isOSWindows();
+    bool arm64 = triple.getArch() == Triple::aarch64;
+    int ptrBytes = triple.isArch64Bit() ? 8 : 4;
+
+    Type* i64Ty = Type::getInt64Ty(*context);
+    Type* floatTy = Type::getFloatTy(*context);
+    Type* doubleTy = Type::getDoubleTy(*context);
+    Type* ptrTy = PointerType::get(Type::getInt8Ty(*context), 0);
+
+    auto classify = [&](const FFICType& type, bool isReturn, FFIPassing& out) -> bool {
+        uint64_t size, align;
+        ffiLayoutOf(ffiStructs, type, ptrBytes, size, align);
+        std::vector<std::pair<uint64_t, FFICType::Kind>> scalars;
+        ffiFlatten(ffiStructs, type, 0, ptrBytes, scalars);
+        out.parts.clear();
+
+        if (sysv) {
+            if (size == 0 || size > 16) {
+                out.mode = isReturn ? FFIPassing::Sret : FFIPassing::Byval;
+                return true;
+            }
+            for (uint64_t off = 0; off < size; off += 8) {
+                int ints = 0, floats = 0, doubles = 0;
+                for (const auto& s : scalars) {
+                    if (s.first < off || s.first >= off + 8) continue;
+                    if (s.second == FFICType::Float) floats++;
+                    else if (s.second == FFICType::Double) doubles++;
+                    else ints++;
+                }
+                if (ints == 0 && doubles == 1 && floats == 0) out.parts.push_back(doubleTy);
+                else if (ints == 0 && doubles == 0 && floats == 1) out.parts.push_back(floatTy);
+                else if (ints == 0 && doubles == 0 && floats == 2) out.parts.push_back(FixedVectorType::get(floatTy, 2));
+                else out.parts.push_back(i64Ty);
+            }
+            out.mode = FFIPassing::Coerce;
+            return true;
+        }
+        if (win64) {
+            if (size == 1 || size == 2 || size == 4 || size == 8) {
+                out.mode = FFIPassing::Coerce;
+                out.parts.push_back(Type::getIntNTy(*context, (unsigned)size * 8));
+            } else {
+                out.mode = isReturn ? FFIPassing::Sret : FFIPassing::Indirect;
+            }
+            return true;
+        }
+        if (arm64) {
+            bool hfa = !scalars.empty() && scalars.size() <= 4;
+            for (const auto& s : scalars) {
+                if (s.second != scalars[0].second ||
+                    (s.second != FFICType::Float && s.second != FFICType::Double)) {
+                    hfa = false;
+                }
+            }
+            if (hfa) {
+                Type* elem = scalars[0].second == FFICType::Float ? floatTy : doubleTy;
+                out.mode = FFIPassing::Coerce;
+                if (isReturn) out.parts.assign(scalars.size(), elem);
+                else out.parts.push_back(ArrayType::get(elem, scalars.size()));
+            } else if (size > 0 && size <= 16) {
+                out.mode = FFIPassing::Coerce;
+                out.parts.push_back(size <= 8 ? i64Ty : (Type*)ArrayType::get(i64Ty, 2));
+            } else {
+                out.mode = isReturn ? FFIPassing::Sret : FFIPassing::Indirect;
+            }
+            return true;
+        }
+        setError("ffi_cdef: passing structs by value to '" + fn.name +
+                 "' is not supported on " + triple.str());
+        return false;
+    };
+
+    std::vector<Type*> llvmParams;
+    Type* retTy;
+    int intRegs = 0, sseRegs = 0;  // SysV register budget (6 integer, 8 SSE)
+
+    fn.retPassing = FFIPassing();
+    if (fn.ret.kind == FFICType::Struct) {
+        if (!classify(fn.ret, true, fn.retPassing)) return false;
+        if (fn.retPassing.mode == FFIPassing::Sret) {
+            llvmParams.push_back(ptrTy);
+            intRegs++;
+            retTy = Type::getVoidTy(*context);
+        } else if (fn.retPassing.parts.size() == 1) {
+            retTy = fn.retPassing.parts[0];
+        } else {
+            retTy = StructType::get(*context, fn.retPassing.parts);
+        }
+    } else {
+        retTy = getFFILLVMType(fn.ret);
+    }
+
+    fn.paramPassing.clear();
+    for (const auto& param : fn.params) {
+        FFIPassing passing;
+        if (param.kind == FFICType::Struct) {
+            if (!classify(param, false, passing)) return false;
+            if (sysv && passing.mode == FFIPassing::Coerce) {
+                int needInt = 0, needSse = 0;
+                for (Type* part : passing.parts) {
+                    if (part->isIntegerTy()) needInt++;
+                    else needSse++;
+                }
+                if (intRegs + needInt > 6 || sseRegs + needSse > 8) {
+                    // Not enough registers left for the whole struct: it goes to memory
+                    passing.mode = FFIPassing::Byval;
+                    passing.parts.clear();
+                } else {
+                    intRegs += needInt;
+                    sseRegs += needSse;
+                }
+            }
+            if (passing.mode == FFIPassing::Coerce) {
+                for (Type* part : passing.parts) llvmParams.push_back(part);
+            } else {
+                llvmParams.push_back(ptrTy);
+            }
+        } else {
+            if (param.kind == FFICType::Float || param.kind == FFICType::Double) sseRegs++;
+            else intRegs++;
+            llvmParams.push_back(getFFILLVMType(param));
+        }
+        fn.paramPassing.push_back(passing);
+    }
+
+    fn.llvmType = FunctionType::get(retTy, llvmParams, fn.varArgs);
+    return true;
+}
+
+// ============================================================================
+// Inline Unboxing
+// ============================================================================
+// MoonValue is { i32 type, i32 refcount, 8-byte payload }. The common case is
+// read straight from the payload; anything else goes through the runtime
+// conversion so the semantics match moon_to_int / moon_to_float.
+
+Value* LLVMCodeGen::ffiUnboxInt(Value* moonVal) {
+    Function* func = builder->GetInsertBlock()->getParent();
+    Type* i8Ty = Type::getInt8Ty(*context);
+    Type* i32Ty = Type::getInt32Ty(*context);
+    Type* i64Ty = Type::getInt64Ty(*context);
+
+    BasicBlock* fastBB = BasicBlock::Create(*context, "ffi.int", func);
+    BasicBlock* slowBB = BasicBlock::Create(*context, "ffi.int.conv", func);
+    BasicBlock* doneBB = BasicBlock::Create(*context, "ffi.int.done", func);
+
+    Value* tag = builder->CreateLoad(i32Ty, moonVal);
+    builder->CreateCondBr(builder->CreateICmpEQ(tag, ConstantInt::get(i32Ty, MOON_INT)), fastBB, slowBB);
+
+    builder->SetInsertPoint(fastBB);
+    Value* fast = builder->CreateLoad(i64Ty, builder->CreateConstGEP1_64(i8Ty, moonVal, 8));
+    builder->CreateBr(doneBB);
+
+    builder->SetInsertPoint(slowBB);
+    Value* slow = builder->CreateCall(getRuntimeFunction("moon_to_int"), {moonVal});
+    builder->CreateBr(doneBB);
+
+    builder->SetInsertPoint(doneBB);
+    PHINode* phi = builder->CreatePHI(i64Ty, 2);
+    phi->addIncoming(fast, fastBB);
+    phi->addIncoming(slow, slowBB);
+    return phi;
+}
+
+Value* LLVMCodeGen::ffiUnboxFloat(Value* moonVal) {
+    Function* func = builder->GetInsertBlock()->getParent();
+    Type* i8Ty = Type::getInt8Ty(*context);
+    Type* i32Ty = Type::getInt32Ty(*context);
+    Type* doubleTy = Type::getDoubleTy(*context);
+
+    BasicBlock* fastBB = BasicBlock::Create(*context, "ffi.float", func);
+    BasicBlock* slowBB = BasicBlock::Create(*context, "ffi.float.conv", func);
+    BasicBlock* doneBB = BasicBlock::Create(*context, "ffi.float.done", func);
+
+    Value* tag = builder->CreateLoad(i32Ty, moonVal);
+    builder->CreateCondBr(builder->CreateICmpEQ(tag, ConstantInt::get(i32Ty, MOON_FLOAT)), fastBB, slowBB);
+
+    builder->SetInsertPoint(fastBB);
+    Value* fast = builder->CreateLoad(doubleTy, builder->CreateConstGEP1_64(i8Ty, moonVal, 8));
+    builder->CreateBr(doneBB);
+
+    builder->SetInsertPoint(slowBB);
+    Value* slow = builder->CreateCall(getRuntimeFunction("moon_to_float"), {moonVal});
+    builder->CreateBr(doneBB);
+
+    builder->SetInsertPoint(doneBB);
+    PHINode* phi = builder->CreatePHI(doubleTy, 2);
+    phi->addIncoming(fast, fastBB);
+    phi->addIncoming(slow, slowBB);
+    return phi;
+}
+
+Value* LLVMCodeGen::ffiUnboxPtr(Value* moonVal) {
+    // Strings pass their character data, integers are addresses
+    Function* func = builder->GetInsertBlock()->getParent();
+    Type* i8Ty = Type::getInt8Ty(*context);
+    Type* i32Ty = Type::getInt32Ty(*context);
+    Type* ptrTy = PointerType::get(i8Ty, 0);
+
+    BasicBlock* fastBB = BasicBlock::Create(*context, "ffi.ptr", func);
+    BasicBlock* slowBB = BasicBlock::Create(*context, "ffi.ptr.conv", func);
+    BasicBlock* doneBB = BasicBlock::Create(*context, "ffi.ptr.done", func);
+
+    Value* tag = builder->CreateLoad(i32Ty, moonVal);
+    Value* direct = builder->CreateOr(
+        builder->CreateICmpEQ(tag, ConstantInt::get(i32Ty, MOON_STRING)),
+        builder->CreateICmpEQ(tag, ConstantInt::get(i32Ty, MOON_INT)));
+    builder->CreateCondBr(direct, fastBB, slowBB);
+
+    builder->SetInsertPoint(fastBB);
+    Value* fast = builder->CreateLoad(ptrTy, builder->CreateConstGEP1_64(i8Ty, moonVal, 8));
+    builder->CreateBr(doneBB);
+
+    builder->SetInsertPoint(slowBB);
+    Value* slow = builder->CreateIntToPtr(
+        builder->CreateCall(getRuntimeFunction("moon_to_int"), {moonVal}), ptrTy);
+    builder->CreateBr(doneBB);
+
+    builder->SetInsertPoint(doneBB);
+    PHINode* phi = builder->CreatePHI(ptrTy, 2);
+    phi->addIncoming(fast, fastBB);
+    phi->addIncoming(slow, slowBB);
+    return phi;
+}
+
+// ============================================================================
+// Argument Conversion
+// ============================================================================
+
+// Convert one argument expression to the C scalar type; boxed temporaries
+// are appended to toRelease for the caller to drop after use
+Value* LLVMCodeGen::ffiScalarArg(const FFICType& t, const ExprPtr& expr, std::vector<Value*>& toRelease) {
+    Type* i64Ty = Type::getInt64Ty(*context);
+    Type* ptrTy = PointerType::get(Type::getInt8Ty(*context), 0);
+
+    // Convert an already-native value to the C scalar type
+    auto castNative = [&](const TypedValue& tv) -> Value* {
+        Value* v = tv.value;
+        if (t.kind == FFICType::Float || t.kind == FFICType::Double) {
+            Type* fpTy = getFFILLVMType(t);
+            if (tv.type == NativeType::NativeInt) return builder->CreateSIToFP(v, fpTy);
+            if (tv.type == NativeType::NativeBool) return builder->CreateUIToFP(v, fpTy);
+            return builder->CreateFPCast(v, fpTy);
+        }
+        if (tv.type == NativeType::NativeFloat) {
+            v = (t.kind == FFICType::Int && !t.isSigned) ? builder->CreateFPToUI(v, i64Ty)
+                                                         : builder->CreateFPToSI(v, i64Ty);
+        } else if (tv.type == NativeType::NativeBool) {
+            v = builder->CreateZExt(v, i64Ty);
+        }
+        if (t.kind == FFICType::Int) {
+            return builder->CreateTrunc(v, Type::getIntNTy(*context, t.bits));
+        }
+        return builder->CreateIntToPtr(v, ptrTy);  // Pointer from an integer address
+    };
+
+    if (t.kind == FFICType::CStr || t.kind == FFICType::Ptr) {
+        if (auto* str = std::get_if<::StringLiteral>(&expr->value)) {
+            return createGlobalString(str->value);  // No boxing for literal strings
+        }
+    }
+    Value* dyn;
+    if (inferExpressionType(expr) != NativeType::Dynamic) {
+        TypedValue tv = generateNativeExpression(expr);
+        if (tv.type != NativeType::Dynamic) return castNative(tv);
+        dyn = tv.value;
+    } else {
+        dyn = generateExpression(expr);
+    }
+    toRelease.push_back(dyn);
+    switch (t.kind) {
+        case FFICType::Int:
+            return builder->CreateTrunc(ffiUnboxInt(dyn), Type::getIntNTy(*context, t.bits));
+        case FFICType::Float:
+            return builder->CreateFPTrunc(ffiUnboxFloat(dyn), Type::getFloatTy(*context));
+        case FFICType::Double:
+            return ffiUnboxFloat(dyn);
+        default:
+            return ffiUnboxPtr(dyn);
+    }
+}
+
+// ============================================================================
+// ffi_cdef(declarations, lib?)
+// ============================================================================
+
+Value* LLVMCodeGen::generateFFICdef(const std::vector<ExprPtr>& args) {
+    if (args.empty()) {
+        setError("ffi_cdef expects a declaration string");
+        return generateNullLiteral();
+    }
+
+    auto* lit = std::get_if<::StringLiteral>(&args[0]->value);
+    if (!lit) {
+        // Declarations only known at run time: the runtime parser registers
+        // the structs; functions stay reachable through dll_func/dll_call_*
+        Value* decls = generateExpression(args[0]);
+        Value* result = builder->CreateCall(getRuntimeFunction("moon_ffi_cdef"), {decls});
+        builder->CreateCall(getRuntimeFunction("moon_release"), {decls});
+        return result;
+    }
+
+    std::vector<std::string> declared;
+    bool hasTypes = false;
+    if (!parseFFIDeclarations(lit->value, declared, hasTypes)) {
+        return generateNullLiteral();
+    }
+
+    // Struct and callback types are also registered at run time, for
+    // ffi_new/ffi_get and ffi_callback by name
+    if (hasTypes) {
+        Value* decls = generateStringLiteral(lit->value);
+        Value* registered = builder->CreateCall(getRuntimeFunction("moon_ffi_cdef"), {decls});
+        builder->CreateCall(getRuntimeFunction("moon_release"), {registered});
+        builder->CreateCall(getRuntimeFunction("moon_release"), {decls});
+    }
+
+    // Bind every declared function from the library, or from the process
+    Value* lib = args.size() > 1 ? generateExpression(args[1])
+                                 : ConstantPointerNull::get(cast<PointerType>(moonValuePtrType));
+    Type* ptrTy = PointerType::get(Type::getInt8Ty(*context), 0);
+    Value* allBound = ConstantInt::getTrue(*context);
+    for (const auto& name : declared) {
+        Value* fp = builder->CreateCall(getRuntimeFunction("moon_ffi_bind"),
+            {ffiFunctions[name].slot, lib, createGlobalString(name)});
+        allBound = builder->CreateAnd(allBound,
+            builder->CreateICmpNE(fp, ConstantPointerNull::get(cast<PointerType>(ptrTy))));
+    }
+    if (args.size() > 1) {
+        builder->CreateCall(getRuntimeFunction("moon_release"), {lib});
+    }
+
+    return builder->CreateCall(getRuntimeFunction("moon_bool"), {allBound});
+}
+
+// ============================================================================
+// Direct Call Emission
+// ============================================================================
+
+TypedValue LLVMCodeGen::generateFFICall(const FFICFunction& fn, const std::vector<ExprPtr>& args,
+                                        bool wantNative) {
+    if (args.size() < fn.params.size() || (args.size() > fn.params.size() && !fn.varArgs)) {
+        setError("C function '" + fn.name + "' expects " + std::to_string(fn.params.size()) +
+                 " argument(s), got " + std::to_string(args.size()));
+        return TypedValue(generateNullLiteral(), NativeType::Dynamic);
+    }
+
+    Function* func = builder->GetInsertBlock()->getParent();
+    Type* i8Ty = Type::getInt8Ty(*context);
+    Type* i64Ty = Type::getInt64Ty(*context);
+    Type* doubleTy = Type::getDoubleTy(*context);
+    Type* ptrTy = PointerType::get(i8Ty, 0);
+
+    // Scratch memory for struct copies lives in the entry block so calls
+    // inside loops do not grow the stack
+    auto entryBuffer = [&](uint64_t bytes) -> Value* {
+        IRBuilder<> entry(&func->getEntryBlock(), func->getEntryBlock().begin());
+        AllocaInst* buf = entry.CreateAlloca(ArrayType::get(i8Ty, bytes < 16 ? 16 : bytes));
+        buf->setAlignment(Align(16));
+        return buf;
+    };
+
+    std::vector<Value*> toRelease;
+
+    auto scalarArg = [&](const FFICType& t, const ExprPtr& expr) -> Value* {
+        return ffiScalarArg(t, expr, toRelease);
+    };
+
+    // Variadic arguments get the C default promotions from their static type:
+    // floats as double, strings as char*, everything else as a 64-bit integer
+    auto variadicArg = [&](const ExprPtr& expr) -> Value* {
+        if (auto* str = std::get_if<::StringLiteral>(&expr->value)) {
+            return createGlobalString(str->value);
+        }
+        FFICType t;
+        t.kind = FFICType::Int;
+        t.bits = 64;
+        NativeType nt = inferExpressionType(expr);
+        if (nt == NativeType::NativeFloat || std::get_if<FloatLiteral>(&expr->value)) {
+            t.kind = FFICType::Double;
+        } else if (auto* call = std::get_if<CallExpr>(&expr->value)) {
+            if (auto* id = std::get_if<Identifier>(&call->callee->value)) {
+                if (id->name == "float") t.kind = FFICType::Double;
+                else if (id->name == "str") t.kind = FFICType::CStr;
+                else if (ffiFunctions.count(id->name)) {
+                    FFICType::Kind rk = ffiFunctions[id->name].ret.kind;
+                    if (rk == FFICType::Float || rk == FFICType::Double) t.kind = FFICType::Double;
+                    else if (rk == FFICType::CStr) t.kind = FFICType::CStr;
+                }
+            }
+        }
+        if (t.kind == FFICType::Int && nt == NativeType::Dynamic) {
+            // Unknown type: the payload carries an integer or a string pointer
+            Value* dyn = generateExpression(expr);
+            toRelease.push_back(dyn);
+            return builder->CreatePtrToInt(ffiUnboxPtr(dyn), i64Ty);
+        }
+        return scalarArg(t, expr);
+    };
+
+    // ========== Arguments ==========
+
+    std::vector<Value*> callArgs;
+    std::vector<std::pair<unsigned, Attribute>> paramAttrs;
+    Value* sretBuf = nullptr;
+    uint64_t retSize = 0, retAlign = 1;
+
+    if (fn.ret.kind == FFICType::Struct) {
+        getFFITypeLayout(fn.ret, retSize, retAlign);
+        sretBuf = entryBuffer(retSize);
+        if (fn.retPassing.mode == FFIPassing::Sret) {
+            paramAttrs.push_back({(unsigned)callArgs.size(),
+                Attribute::getWithStructRetType(*context, getFFILLVMType(fn.ret))});
+            callArgs.push_back(sretBuf);
+        }
+    }
+
+    for (size_t i = 0; i < fn.params.size(); i++) {
+        const FFICType& t = fn.params[i];
+        const FFIPassing& passing = fn.paramPassing[i];
+
+        if (t.kind != FFICType::Struct) {
+            if (t.kind == FFICType::Int && t.bits < 32) {
+                paramAttrs.push_back({(unsigned)callArgs.size(),
+                    Attribute::get(*context, t.isSigned ? Attribute::SExt : Attribute::ZExt)});
+            }
+            callArgs.push_back(scalarArg(t, args[i]));
+            continue;
+        }
+
+        // Structs are passed from a pointer to their memory (ffi_new, C APIs)
+        FFICType ptrType;
+        ptrType.kind = FFICType::Ptr;
+        Value* src = scalarArg(ptrType, args[i]);
+        uint64_t size, align;
+        getFFITypeLayout(t, size, align);
+
+        if (passing.mode == FFIPassing::Byval) {
+            paramAttrs.push_back({(unsigned)callArgs.size(),
+                Attribute::getWithByValType(*context, getFFILLVMType(t))});
+            paramAttrs.push_back({(unsigned)callArgs.size(),
+                Attribute::getWithAlignment(*context, Align(align < 8 ? 8 : align))});
+            callArgs.push_back(src);
+        } else {
+            Value* buf = entryBuffer(size);
+            builder->CreateMemCpy(buf, MaybeAlign(16), src, MaybeAlign(1), size);
+            if (passing.mode == FFIPassing::Indirect) {
+                callArgs.push_back(buf);
+            } else {
+                for (size_t p = 0; p < passing.parts.size(); p++) {
+                    callArgs.push_back(builder->CreateLoad(passing.parts[p],
+                        builder->CreateConstGEP1_64(i8Ty, buf, p * 8)));
+                }
+            }
+        }
+    }
+
+    for (size_t i = fn.params.size(); i < args.size(); i++) {
+        callArgs.push_back(variadicArg(args[i]));
+    }
+
+    // ========== Call ==========
+
+    // Slot is filled by ffi_cdef; an empty slot resolves from the process once
+    Value* fp = builder->CreateLoad(ptrTy, fn.slot);
+    BasicBlock* loadBB = builder->GetInsertBlock();
+    BasicBlock* bindBB = BasicBlock::Create(*context, "ffi.bind", func);
+    BasicBlock* callBB = BasicBlock::Create(*context, "ffi.call", func);
+    MDBuilder md(*context);
+    builder->CreateCondBr(builder->CreateICmpEQ(fp, ConstantPointerNull::get(cast<PointerType>(ptrTy))),
+                          bindBB, callBB, md.createBranchWeights(1, 1000));
+
+    builder->SetInsertPoint(bindBB);
+    Value* bound = builder->CreateCall(getRuntimeFunction("moon_ffi_resolve"),
+        {fn.slot, createGlobalString(fn.name)});
+    builder->CreateBr(callBB);
+
+    builder->SetInsertPoint(callBB);
+    PHINode* target = builder->CreatePHI(ptrTy, 2);
+    target->addIncoming(fp, loadBB);
+    target->addIncoming(bound, bindBB);
+
+    CallInst* call = builder->CreateCall(fn.llvmType, target, callArgs);
+    for (const auto& attr : paramAttrs) {
+        call->addParamAttr(attr.first, attr.second);
+    }
+    if (fn.ret.kind == FFICType::Int && fn.ret.bits < 32) {
+        call->addRetAttr(fn.ret.isSigned ? Attribute::SExt : Attribute::ZExt);
+    }
+
+    for (Value* val : toRelease) {
+        builder->CreateCall(getRuntimeFunction("moon_release"), {val});
+    }
+
+    // ========== Result ==========
+
+    switch (fn.ret.kind) {
+        case FFICType::Void:
+            return TypedValue(generateNullLiteral(), NativeType::Dynamic);
+
+        case FFICType::Int: {
+            Value* v = fn.ret.isSigned ? builder->CreateSExtOrTrunc(call, i64Ty)
+                                       : builder->CreateZExtOrTrunc(call, i64Ty);
+            if (wantNative) return TypedValue(v, NativeType::NativeInt);
+            return TypedValue(boxNativeInt(v), NativeType::Dynamic);
+        }
+
+        case FFICType::Float:
+        case FFICType::Double: {
+            Value* v = builder->CreateFPCast(call, doubleTy);
+            if (wantNative) return TypedValue(v, NativeType::NativeFloat);
+            return TypedValue(boxNativeFloat(v), NativeType::Dynamic);
+        }
+
+        case FFICType::Ptr: {
+            Value* v = builder->CreatePtrToInt(call, i64Ty);
+            if (wantNative) return TypedValue(v, NativeType::NativeInt);
+            return TypedValue(boxNativeInt(v), NativeType::Dynamic);
+        }
+
+        case FFICType::CStr: {
+            // NULL becomes null, anything else is copied into a string
+            BasicBlock* strBB = BasicBlock::Create(*context, "ffi.str", func);
+            BasicBlock* nullBB = BasicBlock::Create(*context, "ffi.str.null", func);
+            BasicBlock* doneBB = BasicBlock::Create(*context, "ffi.str.done", func);
+            builder->CreateCondBr(builder->CreateIsNull(call), nullBB, strBB);
+
+            builder->SetInsertPoint(strBB);
+            Value* str = builder->CreateCall(getRuntimeFunction("moon_string"), {call});
+            builder->CreateBr(doneBB);
+
+            builder->SetInsertPoint(nullBB);
+            Value* null = generateNullLiteral();
+            builder->CreateBr(doneBB);
+
+            builder->SetInsertPoint(doneBB);
+            PHINode* phi = builder->CreatePHI(moonValuePtrType, 2);
+            phi->addIncoming(str, strBB);
+            phi->addIncoming(null, nullBB);
+            return TypedValue(phi, NativeType::Dynamic);
+        }
+
+        case FFICType::Struct: {
+            // Returned structs are handed out as a heap copy (free with ffi_free)
+            if (fn.retPassing.mode != FFIPassing::Sret) {
+                builder->CreateStore(call, sretBuf);
+            }
+            Value* copy = builder->CreateCall(getRuntimeFunction("malloc"),
+                {ConstantInt::get(i64Ty, retSize)});
+            builder->CreateMemCpy(copy, MaybeAlign(1), sretBuf, MaybeAlign(16), retSize);
+            Value* v = builder->CreatePtrToInt(copy, i64Ty);
+            if (wantNative) return TypedValue(v, NativeType::NativeInt);
+            return TypedValue(boxNativeInt(v), NativeType::Dynamic);
+        }
+    }
+
+    return TypedValue(generateNullLiteral(), NativeType::Dynamic);
+}
+
+// ============================================================================
+// Struct Field Access
+// ============================================================================
+// With literal type and field names of a struct declared through a literal
+// ffi_cdef, the offset and C type are known here: ffi_get/ffi_set become a
+// typed load/store at a fixed offset and ffi_field a constant accessor. Other
+// forms go through the runtime. Folded accesses do not check for NULL.
+
+// Runtime kind of a field, as packed into ffi_field handles
+static FFITypeKind ffiRuntimeKind(const FFICField& field) {
+    if (field.count > 1) return FFI_ARRAY;
+    const FFICType& t = field.type;
+    switch (t.kind) {
+        case FFICType::Int:
+            switch (t.bits) {
+                case 8:  return t.isSigned ? FFI_INT8 : FFI_UINT8;
+                case 16: return t.isSigned ? FFI_INT16 : FFI_UINT16;
+                case 32: return t.isSigned ? FFI_INT32 : FFI_UINT32;
+                default: return t.isSigned ? FFI_INT64 : FFI_UINT64;
+            }
+        case FFICType::Float:  return FFI_FLOAT;
+        case FFICType::Double: return FFI_DOUBLE;
+        case FFICType::CStr:   return FFI_CSTR;
+        case FFICType::Struct: return FFI_STRUCT;
+        default:               return FFI_PTR;
+    }
+}
+
+const FFICField* LLVMCodeGen::findFFIField(const ExprPtr& typeArg, const ExprPtr& fieldArg) {
+    auto* typeLit = std::get_if<::StringLiteral>(&typeArg->value);
+    auto* fieldLit = std::get_if<::StringLiteral>(&fieldArg->value);
+    if (!typeLit || !fieldLit) return nullptr;
+
+    // Struct typedef names, then aliases such as "struct Tag"
+    auto st = ffiStructs.find(typeLit->value);
+    if (st == ffiStructs.end()) {
+        auto td = ffiTypedefs.find(typeLit->value);
+        if (td == ffiTypedefs.end() || td->second.kind != FFICType::Struct) return nullptr;
+        st = ffiStructs.find(td->second.structName);
+        if (st == ffiStructs.end()) return nullptr;
+    }
+
+    for (const auto& field : st->second.fields) {
+        if (field.name == fieldLit->value) return &field;
+    }
+    return nullptr;
+}
+
+const FFICField* LLVMCodeGen::foldableFFIField(const std::string& name, const std::vector<ExprPtr>& args) {
+    if (name == "ffi_field") {
+        return args.size() == 2 ? findFFIField(args[0], args[1]) : nullptr;
+    }
+
+    const FFICField* field = nullptr;
+    if ((name == "ffi_get" && args.size() == 3) || (name == "ffi_set" && args.size() == 4)) {
+        field = findFFIField(args[1], args[2]);
+    } else if ((name == "ffi_field_get" && args.size() == 2) || (name == "ffi_field_set" && args.size() == 3)) {
+        // Accessor written inline: ffi_field_get(p, ffi_field("T", "f"))
+        auto* call = std::get_if<CallExpr>(&args[1]->value);
+        auto* id = call ? std::get_if<Identifier>(&call->callee->value) : nullptr;
+        if (!id || id->name != "ffi_field" || call->arguments.size() != 2) return nullptr;
+        field = findFFIField(call->arguments[0], call->arguments[1]);
+    }
+    if (!field) return nullptr;
+
+    // C strings are copied by the runtime; nested structs and arrays are
+    // read as their address and cannot be assigned
+    bool scalar = field->count == 1 && field->type.kind != FFICType::Struct;
+    if (scalar && field->type.kind == FFICType::CStr) return nullptr;
+    bool isSet = (name == "ffi_set" || name == "ffi_field_set");
+    return (isSet && !scalar) ? nullptr : field;
+}
+
+NativeType LLVMCodeGen::inferFFIFieldType(const std::string& name, const std::vector<ExprPtr>& args) {
+    if (name == "ffi_set" || name == "ffi_field_set") return NativeType::Dynamic;
+    const FFICField* field = foldableFFIField(name, args);
+    if (!field) return NativeType::Dynamic;
+    if (name != "ffi_field" && field->count == 1 &&
+        (field->type.kind == FFICType::Float || field->type.kind == FFICType::Double)) {
+        return NativeType::NativeFloat;
+    }
+    return NativeType::NativeInt;
+}
+
+TypedValue LLVMCodeGen::generateFFIFieldAccess(const std::string& name, const std::vector<ExprPtr>& args,
+                                               bool wantNative) {
+    const FFICField* field = foldableFFIField(name, args);
+    if (!field) return TypedValue(nullptr, NativeType::Dynamic);
+
+    Type* i8Ty = Type::getInt8Ty(*context);
+    Type* i64Ty = Type::getInt64Ty(*context);
+
+    if (name == "ffi_field") {
+        Value* handle = ConstantInt::get(i64Ty, FFI_FIELD_HANDLE(ffiRuntimeKind(*field), field->offset));
+        if (wantNative) return TypedValue(handle, NativeType::NativeInt);
+        return TypedValue(boxNativeInt(handle), NativeType::Dynamic);
+    }
+
+    std::vector<Value*> toRelease;
+    FFICType ptrType;
+    ptrType.kind = FFICType::Ptr;
+    Value* base = ffiScalarArg(ptrType, args[0], toRelease);
+    Value* addr = builder->CreateConstGEP1_64(i8Ty, base, field->offset);
+
+    TypedValue result(nullptr, NativeType::Dynamic);
+    if (name == "ffi_set" || name == "ffi_field_set") {
+        Value* val = ffiScalarArg(field->type, args.back(), toRelease);
+        builder->CreateStore(val, addr);
+        result = TypedValue(generateNullLiteral(), NativeType::Dynamic);
+    } else if (field->count > 1 || field->type.kind == FFICType::Struct) {
+        result = TypedValue(builder->CreatePtrToInt(addr, i64Ty), NativeType::NativeInt);
+    } else {
+        Value* val = builder->CreateLoad(getFFILLVMType(field->type), addr);
+        switch (field->type.kind) {
+            case FFICType::Int:
+                val = field->type.isSigned ? builder->CreateSExtOrTrunc(val, i64Ty)
+                                           : builder->CreateZExtOrTrunc(val, i64Ty);
+                result = TypedValue(val, NativeType::NativeInt);
+                break;
+            case FFICType::Float:
+            case FFICType::Double:
+                result = TypedValue(builder->CreateFPCast(val, Type::getDoubleTy(*context)),
+                                    NativeType::NativeFloat);
+                break;
+            default:
+                result = TypedValue(builder->CreatePtrToInt(val, i64Ty), NativeType::NativeInt);
+                break;
+        }
+    }
+
+    for (Value* val : toRelease) {
+        builder->CreateCall(getRuntimeFunction("moon_release"), {val});
+    }
+
+    if (wantNative || result.type == NativeType::Dynamic) return result;
+    if (result.type == NativeType::NativeFloat) {
+        return TypedValue(boxNativeFloat(result.value), NativeType::Dynamic);
+    }
+    return TypedValue(boxNativeInt(result.value), NativeType::Dynamic);
+}
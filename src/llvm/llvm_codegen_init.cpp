@@ -41,6 +41,20 @@ LLVMCodeGen::LLVMCodeGen()
 
 LLVMCodeGen::~LLVMCodeGen() = default;
 
+// ============================================================================
+// Target Helpers
+// ============================================================================
+
+// The triple code is generated for; the module only gets it when the object is emitted
+static Triple resolveTargetTriple(const std::string& customTriple) {
+    if (!customTriple.empty()) return Triple(customTriple);
+#ifdef _WIN32
+    return Triple("x86_64-pc-windows-msvc");
+#else
+    return Triple(sys::getDefaultTargetTriple());
+#endif
+}
+
 // ============================================================================
 // Type Initialization
 // ============================================================================
@@ -87,6 +101,8 @@ void LLVMCodeGen::declareRuntimeFunctions() {
     module->getOrInsertFunction("moon_string", FunctionType::get(valPtrTy, {i8PtrTy}, false));
     module->getOrInsertFunction("moon_list_new", FunctionType::get(valPtrTy, {}, false));
     module->getOrInsertFunction("moon_dict_new", FunctionType::get(valPtrTy, {}, false));
+    module->getOrInsertFunction("moon_list_const", FunctionType::get(valPtrTy, {valPtrPtrTy, i32Ty}, false));
+    module->getOrInsertFunction("moon_dict_const", FunctionType::get(valPtrTy, {valPtrPtrTy, valPtrPtrTy, valPtrPtrTy, i32Ty}, false));
     
     // Reference counting
     module->getOrInsertFunction("moon_retain", FunctionType::get(voidTy, {valPtrTy}, false));
@@ -111,11 +127,17 @@ void LLVMCodeGen::declareRuntimeFunctions() {
     
     // Arithmetic
     module->getOrInsertFunction("moon_add", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_add_assign", FunctionType::get(valPtrTy, {valPtrPtrTy, valPtrTy, valPtrTy}, false));
     module->getOrInsertFunction("moon_sub", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
     module->getOrInsertFunction("moon_mul", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
     module->getOrInsertFunction("moon_div", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
     module->getOrInsertFunction("moon_mod", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
     module->getOrInsertFunction("moon_neg", FunctionType::get(valPtrTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_add_at", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_sub_at", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_mul_at", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_div_at", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_mod_at", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
     
     // Comparison
     module->getOrInsertFunction("moon_eq", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
@@ -159,6 +181,11 @@ void LLVMCodeGen::declareRuntimeFunctions() {
     module->getOrInsertFunction("moon_chr", FunctionType::get(valPtrTy, {valPtrTy}, false));
     module->getOrInsertFunction("moon_ord", FunctionType::get(valPtrTy, {valPtrTy}, false));
     module->getOrInsertFunction("moon_bytes_to_string", FunctionType::get(valPtrTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_buffer_from_ptr", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_buffer_from_str", FunctionType::get(valPtrTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_buffer_slice", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_buffer_ptr", FunctionType::get(valPtrTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_buffer_to_str", FunctionType::get(valPtrTy, {valPtrTy}, false));
     module->getOrInsertFunction("moon_ws_parse_frame", FunctionType::get(valPtrTy, {valPtrTy}, false));
     module->getOrInsertFunction("moon_ws_create_frame", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
     
@@ -227,6 +254,9 @@ void LLVMCodeGen::declareRuntimeFunctions() {
     // String encryption
     module->getOrInsertFunction("moon_decrypt_string", FunctionType::get(valPtrTy, {valPtrTy}, false));
     
+    // Embedded assets
+    module->getOrInsertFunction("moon_asset_read", FunctionType::get(valPtrTy, {valPtrTy}, false));
+    
     // JSON
     module->getOrInsertFunction("moon_json_encode", FunctionType::get(valPtrTy, {valPtrTy}, false));
     module->getOrInsertFunction("moon_json_decode", FunctionType::get(valPtrTy, {valPtrTy}, false));
@@ -384,10 +414,18 @@ void LLVMCodeGen::declareRuntimeFunctions() {
     
     // Network functions
     module->getOrInsertFunction("moon_tcp_connect", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
-    module->getOrInsertFunction("moon_tcp_listen", FunctionType::get(valPtrTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_tcp_listen", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_tcp_listen_group", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
     module->getOrInsertFunction("moon_tcp_accept", FunctionType::get(valPtrTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_tcp_accept_batch", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
     module->getOrInsertFunction("moon_tcp_send", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
-    module->getOrInsertFunction("moon_tcp_recv", FunctionType::get(valPtrTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_tcp_recv", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_tcp_send_file", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_tcp_sendv", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_tcp_reader", FunctionType::get(valPtrTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_recv_exact", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_recv_until", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_reader_close", FunctionType::get(voidTy, {valPtrTy}, false));
     module->getOrInsertFunction("moon_tcp_close", FunctionType::get(voidTy, {valPtrTy}, false));
     // Async I/O
     module->getOrInsertFunction("moon_tcp_set_nonblocking", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
@@ -398,11 +436,43 @@ void LLVMCodeGen::declareRuntimeFunctions() {
     // IOCP high-concurrency functions (Windows)
     module->getOrInsertFunction("moon_iocp_register", FunctionType::get(valPtrTy, {valPtrTy}, false));
     module->getOrInsertFunction("moon_iocp_wait", FunctionType::get(valPtrTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_poller_new", FunctionType::get(valPtrTy, {}, false));
+    module->getOrInsertFunction("moon_poller_add", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_poller_mod", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_poller_del", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_poller_wait", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_poller_close", FunctionType::get(voidTy, {valPtrTy}, false));
     module->getOrInsertFunction("moon_udp_socket", FunctionType::get(valPtrTy, {}, false));
     module->getOrInsertFunction("moon_udp_bind", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
     module->getOrInsertFunction("moon_udp_send", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy, valPtrTy}, false));
     module->getOrInsertFunction("moon_udp_recv", FunctionType::get(valPtrTy, {valPtrTy}, false));
     module->getOrInsertFunction("moon_udp_close", FunctionType::get(voidTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_udp_send_batch", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_udp_recv_batch", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_dns_resolve", FunctionType::get(valPtrTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_dns_config", FunctionType::get(voidTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_dns_clear", FunctionType::get(voidTy, {}, false));
+    // HTTP server
+    module->getOrInsertFunction("moon_http_server", FunctionType::get(valPtrTy, {}, false));
+    module->getOrInsertFunction("moon_http_route", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_http_serve", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_http_stop", FunctionType::get(voidTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_http_server_stats", FunctionType::get(valPtrTy, {valPtrTy}, false));
+    // HTTP client
+    module->getOrInsertFunction("moon_http_get", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_http_post", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_http_request", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_http_read", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_http_close", FunctionType::get(voidTy, {valPtrTy}, false));
+    // WebSocket
+    module->getOrInsertFunction("moon_ws_connect", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_ws_upgrade", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_ws_recv", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_ws_send", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_ws_ping", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_ws_close", FunctionType::get(voidTy, {valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_ws_broadcast", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_ws_info", FunctionType::get(valPtrTy, {valPtrTy}, false));
     
     // DLL functions
     module->getOrInsertFunction("moon_dll_load", FunctionType::get(valPtrTy, {valPtrTy}, false));
@@ -416,6 +486,27 @@ void LLVMCodeGen::declareRuntimeFunctions() {
     module->getOrInsertFunction("moon_free_str", FunctionType::get(voidTy, {valPtrTy}, false));
     module->getOrInsertFunction("moon_ptr_to_str", FunctionType::get(valPtrTy, {valPtrTy}, false));
     
+    // FFI: cdef registration and direct-call slot binding
+    module->getOrInsertFunction("moon_ffi_cdef", FunctionType::get(valPtrTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_ffi_bind", FunctionType::get(i8PtrTy, {PointerType::get(i8PtrTy, 0), valPtrTy, i8PtrTy}, false));
+    module->getOrInsertFunction("moon_ffi_resolve", FunctionType::get(i8PtrTy, {PointerType::get(i8PtrTy, 0), i8PtrTy}, false));
+    module->getOrInsertFunction("malloc", FunctionType::get(i8PtrTy, {i64Ty}, false));
+    
+    // FFI: struct instances, field access and callbacks
+    module->getOrInsertFunction("moon_ffi_new", FunctionType::get(valPtrTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_ffi_free", FunctionType::get(voidTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_ffi_sizeof", FunctionType::get(valPtrTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_ffi_offsetof", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_ffi_get", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_ffi_set", FunctionType::get(voidTy, {valPtrTy, valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_ffi_field", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_ffi_field_get", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_ffi_field_set", FunctionType::get(voidTy, {valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_ffi_read_array", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_ffi_callback_type", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_ffi_callback_create", FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_ffi_callback_free", FunctionType::get(voidTy, {valPtrTy}, false));
+    
     // Memory read/write functions (cross-platform)
     module->getOrInsertFunction("moon_read_ptr", FunctionType::get(valPtrTy, {valPtrTy}, false));
     module->getOrInsertFunction("moon_read_int32", FunctionType::get(valPtrTy, {valPtrTy}, false));
@@ -443,6 +534,7 @@ void LLVMCodeGen::declareRuntimeFunctions() {
     // Runtime init/cleanup
     module->getOrInsertFunction("moon_runtime_init", FunctionType::get(voidTy, {i32Ty, PointerType::get(i8PtrTy, 0)}, false));
     module->getOrInsertFunction("moon_runtime_cleanup", FunctionType::get(voidTy, {}, false));
+    module->getOrInsertFunction("moon_assets_register", FunctionType::get(voidTy, {i8PtrTy, i64Ty}, false));
     
     // Exception handling (setjmp/longjmp based)
     // jmp_buf is passed as a pointer to i8 (opaque)
@@ -596,6 +688,12 @@ void LLVMCodeGen::declareRuntimeFunctions() {
         FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
     module->getOrInsertFunction("moon_gui_post_message_win",
         FunctionType::get(voidTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_gui_post_binary_win",
+        FunctionType::get(voidTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_gui_on_binary_win",
+        FunctionType::get(voidTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_gui_async_handlers_win",
+        FunctionType::get(voidTy, {valPtrTy, valPtrTy}, false));
     
     // gui_expose - register function callable from JS
     module->getOrInsertFunction("moon_gui_expose",
@@ -697,6 +795,8 @@ void LLVMCodeGen::declareRuntimeFunctions() {
     module->getOrInsertFunction("moon_tls_send",
         FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
     module->getOrInsertFunction("moon_tls_recv",
+        FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_tls_reader",
         FunctionType::get(valPtrTy, {valPtrTy}, false));
     module->getOrInsertFunction("moon_tls_recv_all",
         FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
@@ -731,6 +831,18 @@ void LLVMCodeGen::declareRuntimeFunctions() {
     module->getOrInsertFunction("moon_tls_wrap_server",
         FunctionType::get(valPtrTy, {valPtrTy, valPtrTy, valPtrTy}, false));
     
+    // Keep-alive connection pool
+    module->getOrInsertFunction("moon_tls_pool_config",
+        FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_tls_pool_get",
+        FunctionType::get(valPtrTy, {valPtrTy, valPtrTy}, false));
+    module->getOrInsertFunction("moon_tls_pool_put",
+        FunctionType::get(valPtrTy, {valPtrTy}, false));
+    module->getOrInsertFunction("moon_tls_pool_clear",
+        FunctionType::get(voidTy, {}, false));
+    module->getOrInsertFunction("moon_tls_pool_stats",
+        FunctionType::get(valPtrTy, {}, false));
+    
     // TLS initialization/cleanup
     module->getOrInsertFunction("moon_tls_init",
         FunctionType::get(voidTy, {}, false));
@@ -783,8 +895,9 @@ Value* LLVMCodeGen::loadVariable(const std::string& name) {
     }
     
     // Check class definitions - return class object for static method calls
-    if (classDefinitions.count(name)) {
-        GlobalVariable* classGlobal = classDefinitions[name];
+    auto classIt = symbols ? classDefinitions.find(symbols->find(name)) : classDefinitions.end();
+    if (classIt != classDefinitions.end()) {
+        GlobalVariable* classGlobal = classIt->second;
         Value* classVal = builder->CreateLoad(
             PointerType::get(Type::getInt8Ty(*context), 0),
             classGlobal
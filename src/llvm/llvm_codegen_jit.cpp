@@ -0,0 +1,173 @@
+// MoonLang LLVM Code Generator - JIT Module
+// In-process execution for moonc --jit using ORC LLJIT
+// Copyright (c) 2026 greenteng.com
+
+// Note: This file is included by llvm_codegen.cpp and should not be compiled separately.
+
+// ============================================================================
+// Object Cache
+// ============================================================================
+
+// Saves the object the JIT compiles for a whole program, for moonc --jit-cache.
+// Lookups are done by the caller (a cached file is loaded without compiling).
+class JITObjectWriter : public ObjectCache {
+public:
+    explicit JITObjectWriter(const std::string& path) : path(path) {}
+
+    void notifyObjectCompiled(const Module*, MemoryBufferRef object) override {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        fs::create_directories(fs::path(path).parent_path(), ec);
+
+        // Write under a unique name and rename, so a concurrent run never loads half a file
+        std::string temp = path + "." + std::to_string((uintptr_t)this) + ".tmp";
+        {
+            std::ofstream out(temp, std::ios::binary);
+            if (!out) return;
+            out.write(object.getBufferStart(), object.getBufferSize());
+        }
+        fs::rename(temp, path, ec);
+        if (ec) fs::remove(temp, ec);
+    }
+
+    std::unique_ptr<MemoryBuffer> getObject(const Module*) override {
+        return nullptr;
+    }
+
+private:
+    std::string path;
+};
+
+// ============================================================================
+// JIT Execution
+// ============================================================================
+
+std::string LLVMCodeGen::jitRuntimeIdentity() {
+    namespace fs = std::filesystem;
+    std::string runtimeLib = findRuntimeSharedLib();
+    if (runtimeLib.empty()) return "";
+    std::error_code ec;
+    std::string identity = fs::absolute(runtimeLib, ec).string();
+    auto size = fs::file_size(runtimeLib, ec);
+    if (!ec) identity += "\n" + std::to_string(size);
+    auto modified = fs::last_write_time(runtimeLib, ec);
+    if (!ec) identity += "\n" + std::to_string(modified.time_since_epoch().count());
+    return identity;
+}
+
+int LLVMCodeGen::runJIT(const std::vector<std::string>& args, const std::string& objectCachePath,
+                        bool lazy) {
+    using namespace llvm::orc;
+    namespace fs = std::filesystem;
+
+    auto fail = [this](Error err) {
+        setError("JIT: " + toString(std::move(err)));
+        return -1;
+    };
+
+    auto jtmb = JITTargetMachineBuilder::detectHost();
+    if (!jtmb) return fail(jtmb.takeError());
+    jtmb->setCodeGenOptLevel(CodeGenOptLevel::Aggressive);
+
+    bool cachedObject = !objectCachePath.empty() && fs::exists(objectCachePath);
+    JITObjectWriter objectWriter(objectCachePath);
+    std::unique_ptr<LLJIT> jit;
+    LLLazyJIT* lazyJit = nullptr;
+
+    if (lazy && objectCachePath.empty()) {
+        // Lazy (--jit-lazy): each function is optimized and compiled the first time it is called
+        auto built = LLLazyJITBuilder().setJITTargetMachineBuilder(std::move(*jtmb)).create();
+        if (!built) return fail(built.takeError());
+        lazyJit = built->get();
+        jit = std::move(*built);
+    } else {
+        // Eager: the whole program becomes one object, saved for the next run with a cache.
+        // Moon modules have no static constructors, so no platform symbols (__dso_handle)
+        // are injected that would collide when the saved object is loaded again.
+        ObjectCache* cache = objectCachePath.empty() ? nullptr : &objectWriter;
+        auto built = LLJITBuilder()
+            .setJITTargetMachineBuilder(std::move(*jtmb))
+            .setPlatformSetUp(setUpInactivePlatform)
+            .setCompileFunctionCreator([cache](JITTargetMachineBuilder builder)
+                    -> Expected<std::unique_ptr<IRCompileLayer::IRCompiler>> {
+                auto targetMachine = builder.createTargetMachine();
+                if (!targetMachine) return targetMachine.takeError();
+                return std::make_unique<TMOwningSimpleCompiler>(std::move(*targetMachine), cache);
+            })
+            .create();
+        if (!built) return fail(built.takeError());
+        jit = std::move(*built);
+    }
+
+    // Runtime symbols: a shared runtime next to the compiler if there is one, otherwise the
+    // runtime linked into the compiler itself (exported for this purpose)
+    JITDylib& dylib = jit->getMainJITDylib();
+    char globalPrefix = jit->getDataLayout().getGlobalPrefix();
+    std::string runtimeLib = findRuntimeSharedLib();
+    if (!runtimeLib.empty()) {
+        auto generator = DynamicLibrarySearchGenerator::Load(runtimeLib.c_str(), globalPrefix);
+        if (!generator) return fail(generator.takeError());
+        dylib.addGenerator(std::move(*generator));
+    }
+    auto processSymbols = DynamicLibrarySearchGenerator::GetForCurrentProcess(globalPrefix);
+    if (!processSymbols) return fail(processSymbols.takeError());
+    dylib.addGenerator(std::move(*processSymbols));
+
+    if (cachedObject) {
+        auto object = MemoryBuffer::getFile(objectCachePath);
+        if (!object) {
+            setError("Cannot read cached object: " + objectCachePath);
+            return -1;
+        }
+        if (Error err = jit->addObjectFile(std::move(*object))) return fail(std::move(err));
+    } else {
+        module->setDataLayout(jit->getDataLayout());
+#if LLVM_VERSION_MAJOR >= 21
+        module->setTargetTriple(jit->getTargetTriple());
+#else
+        module->setTargetTriple(jit->getTargetTriple().str());
+#endif
+
+        // Borrowing parameters needs every call site, so refcount elision sees the whole
+        // module before a lazy JIT splits it up
+        legacy::PassManager elision;
+        elision.add(new RefcountElisionPass(&refcountStats, {}));
+        elision.run(*module);
+
+        // Same IR pipeline as emitObject(), run on each module the JIT compiles
+        jit->getIRTransformLayer().setTransform(
+            [](ThreadSafeModule tsm, const MaterializationResponsibility&) -> Expected<ThreadSafeModule> {
+                tsm.withModuleDo([](Module& m) {
+                    legacy::PassManager pass;
+                    addOptimizationPasses(pass);
+                    pass.run(m);
+                });
+                return std::move(tsm);
+            });
+
+        // The JIT takes over the module and its context; this code generator is spent afterwards
+        builder.reset();
+        ThreadSafeModule tsm(std::move(module), std::move(context));
+        Error err = lazyJit ? lazyJit->addLazyIRModule(std::move(tsm)) : jit->addIRModule(std::move(tsm));
+        if (err) return fail(std::move(err));
+    }
+
+    if (Error err = jit->initialize(dylib)) return fail(std::move(err));
+    auto mainSymbol = jit->lookup("main");
+    if (!mainSymbol) return fail(mainSymbol.takeError());
+    auto* entry = mainSymbol->toPtr<int (*)(int, char**)>();
+
+    std::vector<char*> argv;
+    for (const auto& arg : args) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+    int exitCode = entry((int)args.size(), argv.data());
+
+    if (Error err = jit->deinitialize(dylib)) consumeError(std::move(err));
+
+    // Runtime threads and exit handlers may still call into JIT code, so the code stays
+    // mapped until the process exits
+    (void)jit.release();
+    return exitCode;
+}
@@ -53,6 +53,23 @@ NativeType LLVMCodeGen::inferExpressionType(const ExprPtr& expr) {
                 // Native functions return int64
                 return NativeType::NativeInt;
             }
+            // C functions with a numeric or pointer return
+            auto ffi = ffiFunctions.find(id->name);
+            if (ffi != ffiFunctions.end()) {
+                switch (ffi->second.ret.kind) {
+                    case FFICType::Int:
+                    case FFICType::Ptr:
+                        return NativeType::NativeInt;
+                    case FFICType::Float:
+                    case FFICType::Double:
+                        return NativeType::NativeFloat;
+                    default:
+                        break;
+                }
+            }
+            // Struct field reads folded to a typed load
+            NativeType fieldType = inferFFIFieldType(id->name, call->arguments);
+            if (fieldType != NativeType::Dynamic) return fieldType;
         }
     }
     
@@ -151,6 +168,13 @@ TypedValue LLVMCodeGen::generateNativeExpression(const ExprPtr& expr) {
     // Call expression - check if it's a native function
     if (auto* call = std::get_if<CallExpr>(&expr->value)) {
         if (auto* id = std::get_if<Identifier>(&call->callee->value)) {
+            if (ffiFunctions.count(id->name) && exprType != NativeType::Dynamic) {
+                return generateFFICall(ffiFunctions[id->name], call->arguments, true);
+            }
+            if (exprType != NativeType::Dynamic) {
+                TypedValue folded = generateFFIFieldAccess(id->name, call->arguments, true);
+                if (folded.value) return folded;
+            }
             if (nativeFunctions.count(id->name)) {
                 // Call native function directly
                 Function* nativeFunc = nativeFunctions[id->name];
@@ -225,8 +249,8 @@ TypedValue LLVMCodeGen::generateNativeBinaryExpr(const BinaryExpr& expr, NativeT
             
             // Overflow path: call moon_add which will return BigInt
             builder->SetInsertPoint(overflowBB);
-            Value* boxedA = boxNativeInt(left.value);
-            Value* boxedB = boxNativeInt(right.value);
+            Value* boxedA = temporaryInt(left.value);
+            Value* boxedB = temporaryInt(right.value);
             Value* bigintResult = builder->CreateCall(getRuntimeFunction("moon_add"), {boxedA, boxedB}, "bigintadd");
             builder->CreateBr(mergeBB);
             BasicBlock* overflowEndBB = builder->GetInsertBlock();
@@ -267,8 +291,8 @@ TypedValue LLVMCodeGen::generateNativeBinaryExpr(const BinaryExpr& expr, NativeT
             
             // Overflow path: call moon_sub which will return BigInt
             builder->SetInsertPoint(overflowBB);
-            Value* boxedA = boxNativeInt(left.value);
-            Value* boxedB = boxNativeInt(right.value);
+            Value* boxedA = temporaryInt(left.value);
+            Value* boxedB = temporaryInt(right.value);
             Value* bigintResult = builder->CreateCall(getRuntimeFunction("moon_sub"), {boxedA, boxedB}, "bigintsub");
             builder->CreateBr(mergeBB);
             BasicBlock* overflowEndBB = builder->GetInsertBlock();
@@ -307,8 +331,8 @@ TypedValue LLVMCodeGen::generateNativeBinaryExpr(const BinaryExpr& expr, NativeT
             
             // Overflow path: call moon_mul which will return BigInt
             builder->SetInsertPoint(overflowBB);
-            Value* boxedA = boxNativeInt(left.value);
-            Value* boxedB = boxNativeInt(right.value);
+            Value* boxedA = temporaryInt(left.value);
+            Value* boxedB = temporaryInt(right.value);
             Value* bigintResult = builder->CreateCall(getRuntimeFunction("moon_mul"), {boxedA, boxedB}, "bigintmul");
             builder->CreateBr(mergeBB);
             BasicBlock* overflowEndBB = builder->GetInsertBlock();
@@ -460,15 +484,15 @@ TypedValue LLVMCodeGen::generateNativeBinaryExpr(const BinaryExpr& expr, NativeT
     Value* rightVal = right.value;
     
     if (left.type == NativeType::NativeInt) {
-        leftVal = boxNativeInt(left.value);
+        leftVal = temporaryInt(left.value);
     } else if (left.type == NativeType::NativeFloat) {
-        leftVal = boxNativeFloat(left.value);
+        leftVal = temporaryFloat(left.value);
     }
     
     if (right.type == NativeType::NativeInt) {
-        rightVal = boxNativeInt(right.value);
+        rightVal = temporaryInt(right.value);
     } else if (right.type == NativeType::NativeFloat) {
-        rightVal = boxNativeFloat(right.value);
+        rightVal = temporaryFloat(right.value);
     }
     
     // Use dynamic operation
@@ -489,24 +513,19 @@ TypedValue LLVMCodeGen::generateNativeBinaryExpr(const BinaryExpr& expr, NativeT
         return TypedValue(generateNullLiteral(), NativeType::Dynamic);
     }
     
+    // The boxed operands are temporaries, so there is nothing to release
     Value* result = builder->CreateCall(getRuntimeFunction(funcName), {leftVal, rightVal});
-    
-    // Release boxed values if we created them
-    if (left.type == NativeType::NativeInt || left.type == NativeType::NativeFloat) {
-        builder->CreateCall(getRuntimeFunction("moon_release"), {leftVal});
-    }
-    if (right.type == NativeType::NativeInt || right.type == NativeType::NativeFloat) {
-        builder->CreateCall(getRuntimeFunction("moon_release"), {rightVal});
-    }
-    
     return TypedValue(result, NativeType::Dynamic);
 }
 
 Value* LLVMCodeGen::boxNativeInt(Value* nativeVal) {
+    // Constant-folded values box to a literal constant
+    if (auto* constant = dyn_cast<ConstantInt>(nativeVal)) return intConstant(constant->getSExtValue());
     return builder->CreateCall(getRuntimeFunction("moon_int"), {nativeVal});
 }
 
 Value* LLVMCodeGen::boxNativeFloat(Value* nativeVal) {
+    if (auto* constant = dyn_cast<ConstantFP>(nativeVal)) return floatConstant(constant->getValueAPF().convertToDouble());
     return builder->CreateCall(getRuntimeFunction("moon_float"), {nativeVal});
 }
 
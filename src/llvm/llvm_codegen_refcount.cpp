@@ -0,0 +1,251 @@
+// MoonLang LLVM Code Generator - Refcount Elision Module
+// Removes moon_retain/moon_release calls that MoonLang's ownership rules make redundant
+// Copyright (c) 2026 greenteng.com
+
+// Note: This file is included by llvm_codegen.cpp and should not be compiled separately.
+
+// ============================================================================
+// Refcount Elision Pass
+// ============================================================================
+//
+// loadVariable() retains every value it reads and expressions release their operands right
+// after use, so `a + b` on locals costs two retain/release pairs around moon_add. The runtime
+// calls are opaque to LLVM, so this pass removes them using what the code generator knows:
+//
+// - A local slot is an alloca whose address is only loaded from and stored to. Each store
+//   gives the slot one reference, held until the next store or the release at scope exit.
+// - A retain and a later release of values loaded from the same slot, with no store to the
+//   slot in between, cancel: the slot's reference keeps the value alive meanwhile. A release
+//   followed by a retain of the same slot value cancels as well (the release is sunk onto it).
+// - A parameter the callee never reassigns is borrowed: the entry retain and the release at
+//   each return are dropped. Direct calls pass a reference the caller holds across the call;
+//   other call sites (the moon_wrap_* entry used by moon_call_func) retain around the call.
+//
+// Values loaded from globals are left alone, since async tasks run on worker threads and may
+// store to a global at any time. The pass runs before mem2reg, while locals are still allocas.
+
+class RefcountElisionPass : public ModulePass {
+public:
+    static char ID;
+
+    // externalFunctions: functions called from outside the module (exported from a DLL/SO)
+    RefcountElisionPass(RefcountStats* stats, std::set<std::string> externalFunctions)
+        : ModulePass(ID), stats(stats), externalFunctions(std::move(externalFunctions)) {}
+
+    StringRef getPassName() const override { return "MoonLang refcount elision"; }
+
+    bool runOnModule(Module& m) override {
+        retainFn = m.getFunction("moon_retain");
+        releaseFn = m.getFunction("moon_release");
+        if (!retainFn || !releaseFn) return false;
+
+        RefcountStats counts;
+        counts.retainsBefore = countCalls(retainFn);
+        counts.releasesBefore = countCalls(releaseFn);
+
+        // Borrowing looks at call sites, so it runs before pairs are removed from callers
+        bool changed = false;
+        for (Function& func : m) {
+            if (!func.isDeclaration()) changed |= borrowParameters(func, counts);
+        }
+        for (Function& func : m) {
+            if (!func.isDeclaration()) changed |= removeRedundantPairs(func);
+        }
+
+        counts.retainsAfter = countCalls(retainFn);
+        counts.releasesAfter = countCalls(releaseFn);
+        if (stats) *stats = counts;
+        return changed;
+    }
+
+private:
+    RefcountStats* stats;
+    std::set<std::string> externalFunctions;
+    Function* retainFn = nullptr;
+    Function* releaseFn = nullptr;
+
+    static unsigned countCalls(Function* fn) {
+        unsigned count = 0;
+        for (User* user : fn->users()) {
+            if (isa<CallInst>(user)) count++;
+        }
+        return count;
+    }
+
+    bool isCallTo(const Instruction* inst, const Function* fn, const Value* arg = nullptr) const {
+        auto* call = dyn_cast<CallInst>(inst);
+        return call && call->getCalledFunction() == fn && (!arg || call->getArgOperand(0) == arg);
+    }
+
+    // A single MoonValue* whose address is never passed on or stored
+    static bool isLocalSlot(const AllocaInst* slot) {
+        if (slot->isArrayAllocation() || !slot->getAllocatedType()->isPointerTy()) return false;
+        for (const User* user : slot->users()) {
+            if (isa<LoadInst>(user)) continue;
+            auto* store = dyn_cast<StoreInst>(user);
+            if (!store || store->getValueOperand() == slot) return false;
+        }
+        return true;
+    }
+
+    // Values that retain/release ignore: null, the moon_null() singleton, literal
+    // constants (the only constant globals used as MoonValues) and stack temporaries
+    // (the only allocas used as MoonValues)
+    bool isImmortal(const Value* value) const {
+        if (isa<ConstantPointerNull>(value) || isa<AllocaInst>(value)) return true;
+        auto* global = dyn_cast<GlobalVariable>(value);
+        if (global && global->isConstant()) return true;
+        auto* call = dyn_cast<CallInst>(value);
+        return call && call->getCalledFunction() && call->getCalledFunction()->getName() == "moon_null";
+    }
+
+    // True when the caller owns a reference to value for the whole call: it is a fresh
+    // expression result or was retained for the call, and is not released before it
+    bool callerHoldsReference(CallInst* call, Value* value) const {
+        if (isImmortal(value)) return true;
+        for (Instruction* inst = call->getPrevNode(); inst; inst = inst->getPrevNode()) {
+            if (inst == value) return isa<CallInst>(inst);
+            if (isCallTo(inst, releaseFn, value)) return false;
+            if (isCallTo(inst, retainFn, value)) return true;
+        }
+        return false;
+    }
+
+    bool borrowParameters(Function& func, RefcountStats& counts) {
+        if (externalFunctions.count(func.getName().str())) return false;
+
+        // Every use must be a direct call, so that each call site can be checked
+        std::vector<CallInst*> callSites;
+        for (User* user : func.users()) {
+            auto* call = dyn_cast<CallInst>(user);
+            if (!call || call->getCalledOperand() != &func) return false;
+            callSites.push_back(call);
+        }
+
+        bool changed = false;
+        BasicBlock* entry = &func.getEntryBlock();
+        for (Argument& arg : func.args()) {
+            // Code generated for a parameter: store to its slot and retain, both in the entry block
+            if (!arg.getType()->isPointerTy() || !arg.hasNUses(2)) continue;
+            StoreInst* init = nullptr;
+            CallInst* entryRetain = nullptr;
+            for (User* user : arg.users()) {
+                auto* inst = cast<Instruction>(user);
+                if (inst->getParent() != entry) continue;
+                if (auto* store = dyn_cast<StoreInst>(inst)) {
+                    if (store->getValueOperand() == &arg) init = store;
+                } else if (isCallTo(inst, retainFn, &arg)) {
+                    entryRetain = cast<CallInst>(inst);
+                }
+            }
+            if (!init || !entryRetain) continue;
+
+            // The slot must never be reassigned
+            auto* slot = dyn_cast<AllocaInst>(init->getPointerOperand());
+            if (!slot || !isLocalSlot(slot)) continue;
+            std::vector<CallInst*> exitReleases;
+            bool reassigned = false;
+            for (User* user : slot->users()) {
+                if (user != init && isa<StoreInst>(user)) reassigned = true;
+                // Scope exit: a load whose only use is the release
+                auto* load = dyn_cast<LoadInst>(user);
+                if (load && load->hasOneUse() && isCallTo(cast<Instruction>(load->user_back()), releaseFn)) {
+                    exitReleases.push_back(cast<CallInst>(load->user_back()));
+                }
+            }
+            if (reassigned) continue;
+
+            for (CallInst* call : callSites) {
+                Value* value = call->getArgOperand(arg.getArgNo());
+                if (callerHoldsReference(call, value)) continue;
+                IRBuilder<> callBuilder(call);
+                callBuilder.CreateCall(retainFn, {value});
+                callBuilder.SetInsertPoint(call->getNextNode());
+                callBuilder.CreateCall(releaseFn, {value});
+            }
+
+            entryRetain->eraseFromParent();
+            for (CallInst* release : exitReleases) {
+                auto* load = cast<LoadInst>(release->getArgOperand(0));
+                release->eraseFromParent();
+                load->eraseFromParent();
+            }
+            counts.borrowedParams++;
+            changed = true;
+        }
+        return changed;
+    }
+
+    bool removeRedundantPairs(Function& func) {
+        std::set<AllocaInst*> slots;
+        for (Instruction& inst : func.getEntryBlock()) {
+            auto* slot = dyn_cast<AllocaInst>(&inst);
+            if (slot && isLocalSlot(slot)) slots.insert(slot);
+        }
+
+        std::vector<Instruction*> dead;
+        for (BasicBlock& block : func) {
+            // A slot value is identified by the slot and the number of stores seen before the
+            // load; an op whose slot was stored to since its load is left alone
+            std::map<AllocaInst*, unsigned> stores;
+            std::map<LoadInst*, unsigned> loadedAfter;
+            std::map<std::pair<AllocaInst*, unsigned>, std::vector<CallInst*>> retains, releases;
+
+            for (Instruction& inst : block) {
+                if (auto* store = dyn_cast<StoreInst>(&inst)) {
+                    auto* slot = dyn_cast<AllocaInst>(store->getPointerOperand());
+                    if (slot && slots.count(slot)) stores[slot]++;
+                    continue;
+                }
+                if (auto* load = dyn_cast<LoadInst>(&inst)) {
+                    auto* slot = dyn_cast<AllocaInst>(load->getPointerOperand());
+                    if (slot && slots.count(slot)) loadedAfter[load] = stores[slot];
+                    continue;
+                }
+                bool isRetain = isCallTo(&inst, retainFn);
+                if (!isRetain && !isCallTo(&inst, releaseFn)) continue;
+
+                auto* call = cast<CallInst>(&inst);
+                Value* value = call->getArgOperand(0);
+                if (isImmortal(value)) {
+                    dead.push_back(call);
+                    continue;
+                }
+                auto* load = dyn_cast<LoadInst>(value);
+                auto it = load ? loadedAfter.find(load) : loadedAfter.end();
+                if (it == loadedAfter.end()) continue;
+                auto* slot = cast<AllocaInst>(load->getPointerOperand());
+                if (stores[slot] != it->second) continue;
+
+                auto key = std::make_pair(slot, it->second);
+                auto& pending = isRetain ? releases[key] : retains[key];
+                if (!pending.empty()) {
+                    dead.push_back(pending.back());
+                    pending.pop_back();
+                    dead.push_back(call);
+                } else {
+                    (isRetain ? retains[key] : releases[key]).push_back(call);
+                }
+            }
+        }
+
+        for (Instruction* inst : dead) {
+            // A moon_null() call only fed the removed op; it has no side effects
+            auto* operand = dyn_cast<CallInst>(cast<CallInst>(inst)->getArgOperand(0));
+            inst->eraseFromParent();
+            if (operand && isImmortal(operand) && operand->use_empty()) operand->eraseFromParent();
+        }
+        return !dead.empty();
+    }
+};
+
+char RefcountElisionPass::ID = 0;
+
+// Symbols of the functions a DLL/SO exports; foreign callers may not keep their arguments alive
+static std::set<std::string> exportedFunctionSymbols(const std::vector<std::pair<std::string, int>>& exports) {
+    std::set<std::string> symbols;
+    for (const auto& exported : exports) {
+        symbols.insert("moon_fn_" + exported.first);
+    }
+    return symbols;
+}
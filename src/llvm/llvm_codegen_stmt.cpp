@@ -292,7 +292,30 @@ void LLVMCodeGen::generateAssignStmt(const AssignStmt& stmt) {
             }
             variableTypes.erase(id->name);
         }
-        
+
+        // x = x + e (also x += e): the result replaces x, so moon_add_assign may append to
+        // x's string in place when the variable holds the only reference
+        auto* binary = std::get_if<BinaryExpr>(&stmt.value->value);
+        auto* self = binary && binary->op == "+" ? std::get_if<Identifier>(&binary->left->value) : nullptr;
+        Value* slot = nullptr;
+        if (self && self->name == id->name && valueType == NativeType::Dynamic &&
+            !(inClosure && currentClosureCaptures.count(id->name))) {
+            if (!declaredGlobals.count(id->name) && namedValues.count(id->name)) {
+                slot = namedValues[id->name];
+            } else if (globalVars.count(id->name)) {
+                slot = globalVars[id->name];
+            }
+        }
+        if (slot) {
+            Value* left = loadVariable(id->name);
+            Value* right = generateOperand(binary->right);
+            Value* val = builder->CreateCall(getRuntimeFunction("moon_add_assign"), {slot, left, right});
+            builder->CreateCall(getRuntimeFunction("moon_release"), {left});
+            builder->CreateCall(getRuntimeFunction("moon_release"), {right});
+            storeVariable(id->name, val);
+            return;
+        }
+
         Value* val = generateExpression(stmt.value);
         if (!val) return;
         storeVariable(id->name, val);
@@ -346,7 +369,7 @@ void LLVMCodeGen::generateAssignStmt(const AssignStmt& stmt) {
 }
 
 void LLVMCodeGen::generateIfStmt(const IfStmt& stmt) {
-    Value* cond = generateExpression(stmt.condition);
+    Value* cond = generateOperand(stmt.condition);
     Value* condBool = builder->CreateCall(getRuntimeFunction("moon_is_truthy"), {cond});
     builder->CreateCall(getRuntimeFunction("moon_release"), {cond});
     
@@ -380,7 +403,7 @@ void LLVMCodeGen::generateIfStmt(const IfStmt& stmt) {
         func->insert(func->end(), elifBBs[i]);
         builder->SetInsertPoint(elifBBs[i]);
         
-        Value* elifCond = generateExpression(stmt.elifBranches[i].first);
+        Value* elifCond = generateOperand(stmt.elifBranches[i].first);
         Value* elifCondBool = builder->CreateCall(getRuntimeFunction("moon_is_truthy"), {elifCond});
         builder->CreateCall(getRuntimeFunction("moon_release"), {elifCond});
         
@@ -512,7 +535,7 @@ void LLVMCodeGen::generateWhileStmt(const WhileStmt& stmt) {
     
     // Condition block
     builder->SetInsertPoint(condBB);
-    Value* cond = generateExpression(stmt.condition);
+    Value* cond = generateOperand(stmt.condition);
     Value* condBool = builder->CreateCall(getRuntimeFunction("moon_is_truthy"), {cond});
     builder->CreateCall(getRuntimeFunction("moon_release"), {cond});
     builder->CreateCondBr(condBool, bodyBB, afterBB);
@@ -539,13 +562,32 @@ void LLVMCodeGen::generateWhileStmt(const WhileStmt& stmt) {
 void LLVMCodeGen::generateForInStmt(const ForInStmt& stmt) {
     Function* func = builder->GetInsertBlock()->getParent();
     
-    // Get the iterable
-    Value* iterable = generateExpression(stmt.iterable);
-    
-    // Get length
-    Value* lenVal = builder->CreateCall(getRuntimeFunction("moon_len"), {iterable});
-    Value* len = builder->CreateCall(getRuntimeFunction("moon_to_int"), {lenVal});
-    builder->CreateCall(getRuntimeFunction("moon_release"), {lenVal});
+    // A list literal being iterated is never seen by the program, so it is not built:
+    // its elements go to a stack array that the loop reads directly
+    Value* iterable = nullptr;
+    Value* elementArray = nullptr;
+    std::vector<Value*> elements;
+    Value* len;
+    auto* literal = std::get_if<ListExpr>(&stmt.iterable->value);
+    if (literal && !literal->elements.empty()) {
+        for (const auto& elem : literal->elements) {
+            elements.push_back(generateExpression(elem));
+        }
+        IRBuilder<> entry(&func->getEntryBlock(), func->getEntryBlock().begin());
+        elementArray = entry.CreateAlloca(ArrayType::get(moonValuePtrType, elements.size()), nullptr, "forelems");
+        for (size_t i = 0; i < elements.size(); i++) {
+            builder->CreateStore(elements[i], builder->CreateConstInBoundsGEP1_32(moonValuePtrType, elementArray, i));
+        }
+        len = ConstantInt::get(Type::getInt64Ty(*context), elements.size());
+    } else {
+        // Get the iterable
+        iterable = generateExpression(stmt.iterable);
+        
+        // Get length
+        Value* lenVal = builder->CreateCall(getRuntimeFunction("moon_len"), {iterable});
+        len = builder->CreateCall(getRuntimeFunction("moon_to_int"), {lenVal});
+        builder->CreateCall(getRuntimeFunction("moon_release"), {lenVal});
+    }
     
     // Create index variable
     Value* indexPtr = builder->CreateAlloca(Type::getInt64Ty(*context), nullptr, "foridx");
@@ -574,10 +616,14 @@ void LLVMCodeGen::generateForInStmt(const ForInStmt& stmt) {
     func->insert(func->end(), bodyBB);
     builder->SetInsertPoint(bodyBB);
     
-    // Get current item
-    Value* idxVal = builder->CreateCall(getRuntimeFunction("moon_int"), {idx});
-    Value* item = builder->CreateCall(getRuntimeFunction("moon_list_get"), {iterable, idxVal});
-    builder->CreateCall(getRuntimeFunction("moon_release"), {idxVal});
+    // Get current item (the boxed index is only read by moon_list_get)
+    Value* item;
+    if (elementArray) {
+        item = builder->CreateLoad(moonValuePtrType, builder->CreateInBoundsGEP(moonValuePtrType, elementArray, idx));
+        builder->CreateCall(getRuntimeFunction("moon_retain"), {item});
+    } else {
+        item = builder->CreateCall(getRuntimeFunction("moon_list_get"), {iterable, temporaryInt(idx)});
+    }
     
     // Store in loop variable
     storeVariable(stmt.variable, item);
@@ -603,7 +649,12 @@ void LLVMCodeGen::generateForInStmt(const ForInStmt& stmt) {
     builder->SetInsertPoint(afterBB);
     
     // Release iterable
-    builder->CreateCall(getRuntimeFunction("moon_release"), {iterable});
+    if (iterable) {
+        builder->CreateCall(getRuntimeFunction("moon_release"), {iterable});
+    }
+    for (Value* element : elements) {
+        builder->CreateCall(getRuntimeFunction("moon_release"), {element});
+    }
     
     // Restore break/continue targets
     currentBreakTarget = savedBreak;
@@ -737,7 +788,7 @@ void LLVMCodeGen::generateFuncDecl(const FuncDecl& stmt) {
     }
     
     // Get the already-declared function from pass 1
-    Function* func = functions[stmt.name];
+    Function* func = functions[stmt.sym];
     if (!func) {
         // Function not pre-declared (e.g., nested function), create it now
         std::vector<Type*> paramTypes;
@@ -759,7 +810,7 @@ void LLVMCodeGen::generateFuncDecl(const FuncDecl& stmt) {
             exportedFunctions.push_back({stmt.name, (int)stmt.params.size()});
         }
         
-        functions[stmt.name] = func;
+        functions[stmt.sym] = func;
     }
     
     // Setup new function
@@ -768,7 +819,7 @@ void LLVMCodeGen::generateFuncDecl(const FuncDecl& stmt) {
     builder->SetInsertPoint(entry);
     
     // Set function param count early for recursive calls
-    functionParamCounts[stmt.name] = stmt.params.size();
+    functionParamCounts[stmt.sym] = stmt.params.size();
     
     // Clear variable tracking for the new function scope
     namedValues.clear();
@@ -910,7 +961,7 @@ void LLVMCodeGen::generateFuncDecl(const FuncDecl& stmt) {
     
     // Store wrapper function reference for calls with fewer arguments
     wrapperFunctions[stmt.name] = wrapperFunc;
-    functionParamCounts[stmt.name] = stmt.params.size();
+    functionParamCounts[stmt.sym] = stmt.params.size();
     
     // Store wrapper function as a variable - either as closure or regular function
     if (!captureList.empty()) {
@@ -1150,10 +1201,11 @@ void LLVMCodeGen::generateClassDecl(const ClassDecl& stmt) {
         parentClassPtr = ConstantPointerNull::get(PointerType::get(Type::getInt8Ty(*context), 0));
     } else {
         // Load parent class from classDefinitions
-        if (classDefinitions.count(stmt.parentName)) {
+        auto parentIt = classDefinitions.find(stmt.parentSym);
+        if (parentIt != classDefinitions.end()) {
             parentClassPtr = builder->CreateLoad(
                 PointerType::get(Type::getInt8Ty(*context), 0),
-                classDefinitions[stmt.parentName]
+                parentIt->second
             );
         } else {
             // Parent class not found - use NULL (will cause runtime error)
@@ -1173,7 +1225,7 @@ void LLVMCodeGen::generateClassDecl(const ClassDecl& stmt) {
         "class_" + stmt.name
     );
     builder->CreateStore(klass, classGlobal);
-    classDefinitions[stmt.name] = classGlobal;
+    classDefinitions[stmt.sym] = classGlobal;
     
     // Generate methods
     // MoonFunc signature: MoonValue* (*)(MoonValue** args, int argc)
@@ -8,6 +8,8 @@
 #include "parser.h"
 #include "alias_loader.h"
 
+#include "llvm/Support/xxhash.h"
+
 #include <iostream>
 #include <iomanip>
 #include <cstdio>
@@ -20,15 +22,31 @@
 #include <set>
 #include <map>
 #include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <list>
+#include <thread>
+#include <unordered_map>
 
 #ifdef _WIN32
 #include <windows.h>
 #else
 #include <unistd.h>
 #include <limits.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+extern char** environ;
 #ifdef __APPLE__
 #include <mach-o/dyld.h>
 #endif
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
 #endif
 
 namespace fs = std::filesystem;
@@ -135,7 +153,10 @@ static bool isValidMoonFile(const std::string& path) {
 
 static std::set<std::string> processedModules;
 static std::map<std::string, std::string> embeddedFiles;
+static std::map<std::string, std::string> bundledAssets;  // Asset key -> bytes for the executable
+static std::set<std::string> sourceDependencies;  // Every file read for the current build (for --watch)
 static std::string compilerDir;  // Directory where moonc.exe is located
+static std::string compilerPath;  // The moonc executable itself
 
 // Get the directory of the compiler executable
 std::string getCompilerDir(const char* argv0) {
@@ -144,6 +165,7 @@ std::string getCompilerDir(const char* argv0) {
 #ifdef _WIN32
     char path[MAX_PATH];
     GetModuleFileNameA(NULL, path, MAX_PATH);
+    compilerPath = path;
     exePath = fs::path(path).parent_path();
 #elif defined(__APPLE__)
     // macOS: use _NSGetExecutablePath
@@ -152,12 +174,15 @@ std::string getCompilerDir(const char* argv0) {
     if (_NSGetExecutablePath(path, &size) == 0) {
         char realPath[PATH_MAX];
         if (realpath(path, realPath) != nullptr) {
+            compilerPath = realPath;
             exePath = fs::path(realPath).parent_path();
         } else {
+            compilerPath = path;
             exePath = fs::path(path).parent_path();
         }
     } else {
         // Fallback
+        compilerPath = argv0;
         exePath = fs::path(argv0).parent_path();
         if (exePath.empty() || !fs::exists(exePath)) {
             exePath = fs::current_path();
@@ -169,9 +194,11 @@ std::string getCompilerDir(const char* argv0) {
     ssize_t len = readlink("/proc/self/exe", path, sizeof(path) - 1);
     if (len != -1) {
         path[len] = '\0';
+        compilerPath = path;
         exePath = fs::path(path).parent_path();
     } else {
         // Fallback to argv0
+        compilerPath = argv0;
         exePath = fs::path(argv0).parent_path();
         if (exePath.empty() || !fs::exists(exePath)) {
             exePath = fs::current_path();
@@ -187,6 +214,7 @@ std::string readFile(const std::string& path) {
     if (!file) {
         throw std::runtime_error("Cannot open file: " + path);
     }
+    sourceDependencies.insert(fs::absolute(path).lexically_normal().string());
     std::stringstream ss;
     ss << file.rdbuf();
     std::string content = ss.str();
@@ -257,73 +285,42 @@ std::string resolveModulePath(const std::string& modulePath, const std::string&
     return modulePath;
 }
 
-std::string escapeString(const std::string& str) {
-    std::string result;
-    result.reserve(str.size() * 2);
-    for (char c : str) {
-        switch (c) {
-            case '\\': result += "\\\\"; break;
-            case '"': result += "\\\""; break;
-            case '\n': result += "\\n"; break;
-            case '\r': result += "\\r"; break;
-            case '\t': result += "\\t"; break;
-            default: result += c; break;
-        }
-    }
-    return result;
-}
-
 // ============================================================================
 // HTML Resource Inlining Support (JS, CSS, Images)
 // ============================================================================
 
-// Get MIME type from file extension
-std::string getMimeType(const std::string& path) {
-    std::string ext = fs::path(path).extension().string();
-    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-    
-    if (ext == ".png") return "image/png";
-    if (ext == ".jpg" || ext == ".jpeg") return "image/jpeg";
-    if (ext == ".gif") return "image/gif";
-    if (ext == ".svg") return "image/svg+xml";
-    if (ext == ".webp") return "image/webp";
-    if (ext == ".ico") return "image/x-icon";
-    if (ext == ".bmp") return "image/bmp";
-    if (ext == ".woff") return "font/woff";
-    if (ext == ".woff2") return "font/woff2";
-    if (ext == ".ttf") return "font/ttf";
-    if (ext == ".eot") return "application/vnd.ms-fontobject";
-    return "application/octet-stream";
-}
-
 // Read binary file
 std::string readBinaryFile(const std::string& path) {
     std::ifstream file(path, std::ios::binary);
     if (!file) return "";
+    sourceDependencies.insert(fs::absolute(path).lexically_normal().string());
     std::stringstream ss;
     ss << file.rdbuf();
     return ss.str();
 }
 
-// Base64 encoding
-static const char base64_chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
-std::string base64Encode(const std::string& data) {
-    std::string result;
-    result.reserve(((data.size() + 2) / 3) * 4);
-    
-    int val = 0, valb = -6;
-    for (unsigned char c : data) {
-        val = (val << 8) + c;
-        valb += 8;
-        while (valb >= 0) {
-            result.push_back(base64_chars[(val >> valb) & 0x3F]);
-            valb -= 6;
-        }
+// Add a file to the executable's asset section and return its key. Keys use
+// the runtime's lookup form: forward slashes, lowercase, no leading "/".
+std::string addBundledAsset(const std::string& path, const std::string& content) {
+    std::string key;
+    size_t start = 0;
+    while (start < path.size() && (path[start] == '/' || path[start] == '\\')) start++;
+    if (path.compare(start, 2, "./") == 0 || path.compare(start, 2, ".\\") == 0) start += 2;
+    for (size_t i = start; i < path.size(); i++) {
+        char c = path[i];
+        key += c == '\\' ? '/' : (char)tolower((unsigned char)c);
     }
-    if (valb > -6) result.push_back(base64_chars[((val << 8) >> (valb + 8)) & 0x3F]);
-    while (result.size() % 4) result.push_back('=');
-    return result;
+    bundledAssets[key] = content;
+    return key;
+}
+
+// Add a file under a content-derived name (dir/<hash><ext>); identical files share one entry
+std::string addHashedAsset(const std::string& dir, const std::string& content, const std::string& ext) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : content) hash = (hash ^ c) * 1099511628211ULL;
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long)hash);
+    return addBundledAsset(dir + "/" + name + ext, content);
 }
 
 // Resolve a relative path from HTML/CSS file
@@ -410,7 +407,7 @@ std::string processCssImports(const std::string& css, const std::string& cssDir,
     return result;
 }
 
-// Inline images in CSS (background-image, etc.) - convert to base64
+// Inline images in CSS (background-image, etc.) - move them to embedded assets
 std::string inlineCssImages(const std::string& css, const std::string& cssDir) {
     std::string result = css;
     
@@ -452,18 +449,16 @@ std::string inlineCssImages(const std::string& css, const std::string& cssDir) {
                 ext == ".svg" || ext == ".webp" || ext == ".ico" || ext == ".bmp" ||
                 ext == ".woff" || ext == ".woff2" || ext == ".ttf" || ext == ".eot") {
                 
-                std::cout << "    Inlining resource: " << url << "\n";
+                std::cout << "    Embedding resource: " << url << "\n";
                 std::string content = readBinaryFile(resolvedPath);
-                std::string base64 = base64Encode(content);
-                std::string mimeType = getMimeType(resolvedPath);
-                std::string dataUrl = "data:" + mimeType + ";base64," + base64;
+                std::string dataUrl = "moon://localhost/" + addHashedAsset("res", content, ext);
                 
                 // Find closing parenthesis
                 size_t closePos = urlEnd;
                 if (quote) closePos++; // Skip closing quote
                 while (closePos < result.size() && result[closePos] != ')') closePos++;
                 
-                // Replace url(...) with url(data:...)
+                // Replace url(...) with url(moon://localhost/res/...)
                 std::string replacement = "url(\"" + dataUrl + "\")";
                 result = result.substr(0, pos) + replacement + result.substr(closePos + 1);
                 pos = pos + replacement.length();
@@ -681,11 +676,11 @@ std::string inlineHtmlImages(const std::string& html, const std::string& htmlDir
         std::string resolvedPath = resolveResourcePath(imgPath, htmlDir);
         
         if (!resolvedPath.empty()) {
-            std::cout << "  Inlining image: " << imgPath << "\n";
+            std::cout << "  Embedding image: " << imgPath << "\n";
             std::string content = readBinaryFile(resolvedPath);
-            std::string base64 = base64Encode(content);
-            std::string mimeType = getMimeType(resolvedPath);
-            std::string dataUrl = "data:" + mimeType + ";base64," + base64;
+            std::string ext = fs::path(resolvedPath).extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+            std::string dataUrl = "moon://localhost/" + addHashedAsset("res", content, ext);
             
             // Replace src value
             std::string newTag = tag.substr(0, srcPos + 1) + dataUrl + tag.substr(pathEnd);
@@ -749,36 +744,6 @@ std::string inlineHtmlResources(const std::string& html, const std::string& html
     return result;
 }
 
-// XOR encrypt a string for embedding - returns hex-encoded encrypted data
-// Format: 8 hex chars for key + hex-encoded XOR'd data
-std::string encryptString(const std::string& str) {
-    // Generate random 4-byte key
-    unsigned char key[4];
-    srand((unsigned int)time(NULL));
-    for (int i = 0; i < 4; i++) {
-        key[i] = (unsigned char)(rand() % 256);
-    }
-    
-    std::string result;
-    result.reserve(8 + str.size() * 2);
-    
-    // First 8 chars: hex-encoded key
-    char hex[3];
-    for (int i = 0; i < 4; i++) {
-        snprintf(hex, sizeof(hex), "%02x", key[i]);
-        result += hex;
-    }
-    
-    // Rest: hex-encoded XOR'd data
-    for (size_t i = 0; i < str.size(); i++) {
-        unsigned char c = (unsigned char)str[i] ^ key[i % 4];
-        snprintf(hex, sizeof(hex), "%02x", c);
-        result += hex;
-    }
-    
-    return result;
-}
-
 std::string embedReadFileCalls(const std::string& source, const std::string& basePath) {
     std::string result = source;
     
@@ -800,8 +765,9 @@ std::string embedReadFileCalls(const std::string& source, const std::string& bas
                     embeddedFiles[resolvedPath] = fileContent;
                 }
                 
-                std::string escaped = escapeString(embeddedFiles[resolvedPath]);
-                std::string replacement = "\"" + escaped + "\"";
+                std::string ext = fs::path(resolvedPath).extension().string();
+                std::string key = addHashedAsset("files", embeddedFiles[resolvedPath], ext);
+                std::string replacement = "asset_read(\"" + key + "\")";
                 
                 size_t endPos = quote2 + 2;
                 result = result.substr(0, start) + replacement + result.substr(endPos);
@@ -817,7 +783,7 @@ std::string embedReadFileCalls(const std::string& source, const std::string& bas
     return result;
 }
 
-// Handle gui_load_html(read_file("...")) pattern - encrypt the HTML content
+// Handle gui_load_html(read_file("...")) pattern - embed the HTML as an asset
 std::string embedGuiLoadHtmlReadFile(const std::string& source, const std::string& basePath) {
     std::string result = source;
     
@@ -833,16 +799,15 @@ std::string embedGuiLoadHtmlReadFile(const std::string& source, const std::strin
             std::string resolvedPath = resolveModulePath(filePath, basePath);
             
             if (fs::exists(resolvedPath)) {
-                std::cout << "  Embedding & encrypting HTML: " << filePath << "\n";
+                std::cout << "  Embedding HTML: " << filePath << "\n";
                 std::string fileContent = readFile(resolvedPath);
                 
-                // Inline external resources (JS, CSS, images) before encryption
+                // Inline external resources (JS, CSS, images) before embedding
                 std::string htmlDir = fs::path(resolvedPath).parent_path().string();
                 fileContent = inlineHtmlResources(fileContent, htmlDir);
                 
-                // Encrypt the content for protection
-                std::string encrypted = encryptString(fileContent);
-                std::string replacement = "gui_load_html(decrypt_string(\"" + encrypted + "\"))";
+                std::string key = addHashedAsset("pages", fileContent, ".html");
+                std::string replacement = "gui_load_html(asset_read(\"" + key + "\"))";
                 
                 // Find the closing )) - pattern is gui_load_html(read_file("path"))
                 size_t endPos = result.find("))", quote2);
@@ -865,19 +830,13 @@ std::string embedGuiLoadHtmlReadFile(const std::string& source, const std::strin
     return result;
 }
 
-// Handle gui_load_html("...") with inline HTML string - encrypt it
+// Handle gui_load_html("...") with inline HTML string - move it to an asset
 std::string embedGuiLoadHtmlInline(const std::string& source, const std::string& basePath) {
     std::string result = source;
     
     size_t pos = 0;
     std::string pattern = "gui_load_html(\"";
     while ((pos = result.find(pattern, pos)) != std::string::npos) {
-        // Skip if already processed (decrypt_string)
-        if (pos >= 14 && result.substr(pos - 14, 14) == "decrypt_string") {
-            pos += pattern.length();
-            continue;
-        }
-        
         size_t start = pos;
         size_t quote1 = pos + pattern.length() - 1;  // Position of opening "
         
@@ -894,7 +853,7 @@ std::string embedGuiLoadHtmlInline(const std::string& source, const std::string&
             // Extract the HTML content (between quotes, including escape sequences)
             std::string htmlContent = result.substr(quote1 + 1, quote2 - quote1 - 1);
             
-            // Unescape the string content for encryption
+            // Unescape the string content
             std::string unescaped;
             for (size_t i = 0; i < htmlContent.size(); i++) {
                 if (htmlContent[i] == '\\' && i + 1 < htmlContent.size()) {
@@ -912,12 +871,10 @@ std::string embedGuiLoadHtmlInline(const std::string& source, const std::string&
                 }
             }
             
-            // Only encrypt if it looks like HTML (contains < or is substantial)
+            // Only embed if it looks like HTML (contains < or is substantial)
             if (unescaped.find('<') != std::string::npos || unescaped.size() > 50) {
-                // HTML encryption (silent)
-                
-                std::string encrypted = encryptString(unescaped);
-                std::string replacement = "gui_load_html(decrypt_string(\"" + encrypted + "\"))";
+                std::string key = addHashedAsset("inline", unescaped, ".html");
+                std::string replacement = "gui_load_html(asset_read(\"" + key + "\"))";
                 
                 // Find the closing )
                 size_t endPos = result.find(')', quote2);
@@ -944,7 +901,7 @@ std::string embedGuiLoadHtmlInline(const std::string& source, const std::string&
 std::string embedGuiLoadHtmlVariable(const std::string& source, const std::string& basePath) {
     std::string result = source;
     
-    // Find gui_load_html( followed by identifier (not a string or decrypt_string)
+    // Find gui_load_html( followed by identifier (not a string or asset_read)
     size_t pos = 0;
     std::string pattern = "gui_load_html(";
     while ((pos = result.find(pattern, pos)) != std::string::npos) {
@@ -955,12 +912,13 @@ std::string embedGuiLoadHtmlVariable(const std::string& source, const std::strin
             argStart++;
         }
         
-        // Skip if it's a string literal or already decrypt_string
+        // Skip if it's a string literal or already asset_read
         if (argStart < result.size() && result[argStart] == '"') {
             pos = argStart;
             continue;
         }
-        if (result.substr(argStart, 14) == "decrypt_string") {
+        if (result.compare(argStart, 10, "asset_read") == 0 ||
+            result.compare(argStart, 14, "decrypt_string") == 0) {
             pos = argStart;
             continue;
         }
@@ -1022,7 +980,7 @@ std::string embedGuiLoadHtmlVariable(const std::string& source, const std::strin
         // Extract string content
         std::string content = result.substr(quote1 + 1, quote2 - quote1 - 1);
         
-        // Only encrypt if it looks like HTML
+        // Only embed if it looks like HTML
         if (content.find('<') == std::string::npos && content.find("html") == std::string::npos) {
             pos = varEnd;
             continue;
@@ -1046,10 +1004,8 @@ std::string embedGuiLoadHtmlVariable(const std::string& source, const std::strin
             }
         }
         
-        // HTML variable encryption (silent)
-        
-        std::string encrypted = encryptString(unescaped);
-        std::string newAssign = varName + (hasSpace ? " = " : "=") + "decrypt_string(\"" + encrypted + "\")";
+        std::string key = addHashedAsset("inline", unescaped, ".html");
+        std::string newAssign = varName + (hasSpace ? " = " : "=") + "asset_read(\"" + key + "\")";
         
         // Replace the assignment
         size_t assignEnd = quote2 + 1;
@@ -1092,9 +1048,8 @@ std::string processLocalUrl(const std::string& source, const std::string& basePa
             }
             
             if (foundInBundle) {
-                // Use the pre-bundled content
-                std::string encrypted = encryptString(bundledContent);
-                std::string replacement = "gui_load_html(decrypt_string(\"" + encrypted + "\"))";
+                // Already in the asset section under its bundle path
+                std::string replacement = "gui_load_html(asset_read(\"" + addBundledAsset(normalizedPath, bundledContent) + "\"))";
                 
                 size_t endPos = quote2 + 2;
                 result = result.substr(0, start) + replacement + result.substr(endPos);
@@ -1108,19 +1063,18 @@ std::string processLocalUrl(const std::string& source, const std::string& basePa
                 
                 if (fs::exists(resolvedPath)) {
                     if (embeddedFiles.find(resolvedPath) == embeddedFiles.end()) {
-                        std::cout << "  Embedding & encrypting HTML: " << filePath << "\n";
+                        std::cout << "  Embedding HTML: " << filePath << "\n";
                         std::string fileContent = readFile(resolvedPath);
                         
-                        // Inline external resources (JS, CSS, images) before encryption
+                        // Inline external resources (JS, CSS, images) before embedding
                         std::string htmlDir = fs::path(resolvedPath).parent_path().string();
                         fileContent = inlineHtmlResources(fileContent, htmlDir);
                         
                         embeddedFiles[resolvedPath] = fileContent;
                     }
                     
-                    // Encrypt the content for protection
-                    std::string encrypted = encryptString(embeddedFiles[resolvedPath]);
-                    std::string replacement = "gui_load_html(decrypt_string(\"" + encrypted + "\"))";
+                    std::string key = addHashedAsset("pages", embeddedFiles[resolvedPath], ".html");
+                    std::string replacement = "gui_load_html(asset_read(\"" + key + "\"))";
                     
                     size_t endPos = quote2 + 2;
                     result = result.substr(0, start) + replacement + result.substr(endPos);
@@ -1230,6 +1184,7 @@ void bundleFolder(const std::string& folderPath, const std::string& basePath, co
                 
                 embeddedFiles[key] = content;
                 embeddedFiles[fullPath] = content;  // Also store with full path
+                addBundledAsset(key, content);      // Served from moon://localhost/<key>
                 
                 // Get file size for display
                 auto fileSize = fs::file_size(entry.path());
@@ -1392,6 +1347,7 @@ std::string bundleImports(const std::string& source, const std::string& basePath
 std::string bundleSource(const std::string& source, const std::string& basePath) {
     processedModules.clear();
     embeddedFiles.clear();
+    bundledAssets.clear();
     bundledFolders.clear();
     
     std::string result = bundleImports(source, basePath);
@@ -1400,11 +1356,11 @@ std::string bundleSource(const std::string& source, const std::string& basePath)
     result = processMoonBundle(result, basePath);
     
     // IMPORTANT: Process gui_load_html(read_file(...)) BEFORE embedReadFileCalls
-    // to ensure HTML content is encrypted, not just escaped
+    // so HTML gets its resources inlined, not just embedded
     result = embedGuiLoadHtmlReadFile(result, basePath);
     result = embedReadFileCalls(result, basePath);
     result = embedGuiLoadUrl(result, basePath);
-    // Finally, encrypt any inline HTML strings in gui_load_html("...")
+    // Finally, move any inline HTML strings in gui_load_html("...") to assets
     result = embedGuiLoadHtmlInline(result, basePath);
     // Also handle gui_load_html(varname) where varname holds HTML
     result = embedGuiLoadHtmlVariable(result, basePath);
@@ -1423,6 +1379,18 @@ void printUsage(const char* program) {
     printf("  --shared              Build shared library (DLL/SO) instead of executable\n");
     printf("  --header <file>       Generate C header file for exported functions\n");
     printf("  --alias [<file>]      Load syntax alias config (default: moon-alias.json)\n");
+    printf("  --bench-frontend[=N]  Lex and parse N times (default 20), report throughput\n");
+    printf("  --stats               Report what the optimizer removed (refcount operations)\n");
+    printf("  --jit                 Run in-process with the LLVM JIT (no object file or linker)\n");
+    printf("  --jit-cache[=<dir>]   With --jit, keep compiled programs on disk for repeated runs\n");
+    printf("  --jit-lazy            With --jit, compile each function on its first call\n");
+    printf("\nRebuild options:\n");
+    printf("  --watch               Rebuild (and rerun with -r) whenever a source file changes\n");
+#ifndef _WIN32
+    printf("  --daemon[=<socket>]   Run a compile server that keeps LLVM and built programs in memory\n");
+    printf("  --connect[=<socket>]  Build through a running compile server\n");
+    printf("                        (MOONC_SOCKET=<socket> does the same when a server is up)\n");
+#endif
     printf("\nEmbedded/Target options:\n");
     printf("  --target <type>       Build target: native (default), embedded, mcu\n");
     printf("  --no-gui              Disable GUI support\n");
@@ -1479,27 +1447,11 @@ void printVersion() {
 }
 
 // ============================================================================
-// Main Entry Point
+// Build Options
 // ============================================================================
 
-int main(int argc, char* argv[]) {
-#ifdef _WIN32
-    SetConsoleOutputCP(CP_UTF8);
-#endif
-
-    // Get compiler directory for stdlib resolution
-    compilerDir = getCompilerDir(argv[0]);
-
-    // Force flush on all outputs
-    std::cout << std::unitbuf;
-    std::cerr << std::unitbuf;
-
-    if (argc < 2) {
-        printUsage(argv[0]);
-        std::cout.flush();
-        return 1;
-    }
-    
+// Command-line options of one build; --daemon parses one per request
+struct CompileOptions {
     std::string inputPath;
     std::string outputPath;
     std::string iconPath;
@@ -1508,6 +1460,12 @@ int main(int argc, char* argv[]) {
     bool bundleModules = true;
     bool runMode = false;  // Run without generating exe
     bool sharedMode = false;  // Build shared library instead of executable
+    int benchFrontend = 0;    // Lexer/parser benchmark iterations (0 = off)
+    bool showStats = false;   // Print optimizer statistics after compiling
+    bool jitMode = false;     // Run in-process with the JIT (implies runMode)
+    bool jitCache = false;    // Keep JIT-compiled programs on disk
+    std::string jitCacheDir;  // "" = ~/.cache/moonc/jit-v1 (per user)
+    bool jitLazy = false;     // Compile JIT functions on first call
     
     // Embedded/target options
     std::string targetType = "native";  // native, embedded, mcu
@@ -1528,7 +1486,15 @@ int main(int argc, char* argv[]) {
     // Version info for compiled exe
     VersionInfo versionInfo;
     
-    // Parse arguments
+    // Rebuild modes
+    bool watchMode = false;    // --watch: rebuild when a source file changes
+    bool daemonMode = false;   // --daemon: serve builds from a Unix socket
+    bool connectMode = false;  // --connect: send this build to a server
+    std::string socketPath;    // Server socket ("" = default)
+};
+
+// Parse the command line; returns -1 when the build should go ahead, else the exit code
+static int parseArguments(int argc, char* argv[], CompileOptions& opts) {
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
         
@@ -1541,110 +1507,141 @@ int main(int argc, char* argv[]) {
             return 0;
         }
         if (arg == "-o" && i + 1 < argc) {
-            outputPath = argv[++i];
+            opts.outputPath = argv[++i];
         }
         else if (arg == "-r" || arg == "--run") {
-            runMode = true;
+            opts.runMode = true;
+        }
+        else if (arg == "--bench-frontend") {
+            opts.benchFrontend = 20;
+        }
+        else if (arg.rfind("--bench-frontend=", 0) == 0) {
+            opts.benchFrontend = std::max(1, atoi(arg.c_str() + 17));
+        }
+        else if (arg == "--jit") {
+            opts.jitMode = true;
+            opts.runMode = true;
+        }
+        else if (arg == "--jit-cache" || arg.rfind("--jit-cache=", 0) == 0) {
+            opts.jitCache = true;
+            if (arg.size() > 11) opts.jitCacheDir = arg.substr(12);
+        }
+        else if (arg == "--jit-lazy") {
+            opts.jitLazy = true;
+        }
+        else if (arg == "--stats") {
+            opts.showStats = true;
+        }
+        else if (arg == "--watch") {
+            opts.watchMode = true;
+        }
+        else if (arg == "--daemon" || arg.rfind("--daemon=", 0) == 0) {
+            opts.daemonMode = true;
+            if (arg.size() > 8) opts.socketPath = arg.substr(9);
+        }
+        else if (arg == "--connect" || arg.rfind("--connect=", 0) == 0) {
+            opts.connectMode = true;
+            if (arg.size() > 9) opts.socketPath = arg.substr(10);
         }
         else if (arg == "--shared") {
-            sharedMode = true;
+            opts.sharedMode = true;
         }
         else if (arg == "--header" && i + 1 < argc) {
-            headerPath = argv[++i];
+            opts.headerPath = argv[++i];
         }
         else if (arg == "--alias" && i + 1 < argc) {
-            aliasPath = argv[++i];
+            opts.aliasPath = argv[++i];
         }
         else if (arg == "--alias") {
             // --alias without path: auto-find moon-alias.json
-            aliasPath = "auto";
+            opts.aliasPath = "auto";
         }
         else if (arg.rfind("--alias=", 0) == 0) {
-            aliasPath = arg.substr(8);
+            opts.aliasPath = arg.substr(8);
         }
         else if (arg == "--icon" && i + 1 < argc) {
-            iconPath = argv[++i];
+            opts.iconPath = argv[++i];
         }
         else if (arg == "--company" && i + 1 < argc) {
-            versionInfo.company = argv[++i];
+            opts.versionInfo.company = argv[++i];
         }
         else if (arg == "--copyright" && i + 1 < argc) {
-            versionInfo.copyright = argv[++i];
+            opts.versionInfo.copyright = argv[++i];
         }
         else if (arg == "--description" && i + 1 < argc) {
-            versionInfo.description = argv[++i];
+            opts.versionInfo.description = argv[++i];
         }
         else if (arg == "--file-version" && i + 1 < argc) {
-            versionInfo.version = argv[++i];
+            opts.versionInfo.version = argv[++i];
         }
         else if (arg == "--product-name" && i + 1 < argc) {
-            versionInfo.productName = argv[++i];
+            opts.versionInfo.productName = argv[++i];
         }
         else if (arg == "--product-version" && i + 1 < argc) {
-            versionInfo.productVersion = argv[++i];
+            opts.versionInfo.productVersion = argv[++i];
         }
         // Embedded/target options
         else if (arg.rfind("--target=", 0) == 0) {
-            targetType = arg.substr(9);
-            if (targetType != "native" && targetType != "embedded" && targetType != "mcu") {
-                std::cerr << "Error: Unknown target type: " << targetType << "\n";
+            opts.targetType = arg.substr(9);
+            if (opts.targetType != "native" && opts.targetType != "embedded" && opts.targetType != "mcu") {
+                std::cerr << "Error: Unknown target type: " << opts.targetType << "\n";
                 std::cerr << "Valid targets: native, embedded, mcu\n";
                 return 1;
             }
         }
         else if (arg == "--target" && i + 1 < argc) {
-            targetType = argv[++i];
-            if (targetType != "native" && targetType != "embedded" && targetType != "mcu") {
-                std::cerr << "Error: Unknown target type: " << targetType << "\n";
+            opts.targetType = argv[++i];
+            if (opts.targetType != "native" && opts.targetType != "embedded" && opts.targetType != "mcu") {
+                std::cerr << "Error: Unknown target type: " << opts.targetType << "\n";
                 std::cerr << "Valid targets: native, embedded, mcu\n";
                 return 1;
             }
         }
         else if (arg == "--no-gui") {
-            noGui = true;
+            opts.noGui = true;
         }
         else if (arg == "--no-network") {
-            noNetwork = true;
+            opts.noNetwork = true;
         }
         else if (arg == "--no-dll") {
-            noDll = true;
+            opts.noDll = true;
         }
         else if (arg == "--no-regex") {
-            noRegex = true;
+            opts.noRegex = true;
         }
         else if (arg == "--no-json") {
-            noJson = true;
+            opts.noJson = true;
         }
         else if (arg == "--no-float") {
-            noFloat = true;
+            opts.noFloat = true;
         }
         else if (arg == "--heap-size" && i + 1 < argc) {
-            heapSize = std::stoul(argv[++i]);
+            opts.heapSize = std::stoul(argv[++i]);
         }
         else if (arg == "--static-alloc") {
-            staticAlloc = true;
+            opts.staticAlloc = true;
         }
         // Cross-compilation options
         else if (arg == "--arch" && i + 1 < argc) {
-            archTriple = argv[++i];
+            opts.archTriple = argv[++i];
         }
         else if (arg.rfind("--arch=", 0) == 0) {
-            archTriple = arg.substr(7);
+            opts.archTriple = arg.substr(7);
         }
         else if (arg == "--cpu" && i + 1 < argc) {
-            targetCpu = argv[++i];
+            opts.targetCpu = argv[++i];
         }
         else if (arg.rfind("--cpu=", 0) == 0) {
-            targetCpu = arg.substr(6);
+            opts.targetCpu = arg.substr(6);
         }
         else if (arg == "--features" && i + 1 < argc) {
-            targetFeatures = argv[++i];
+            opts.targetFeatures = argv[++i];
         }
         else if (arg.rfind("--features=", 0) == 0) {
-            targetFeatures = arg.substr(11);
+            opts.targetFeatures = arg.substr(11);
         }
-        else if (inputPath.empty() && arg[0] != '-') {
-            inputPath = arg;
+        else if (opts.inputPath.empty() && arg[0] != '-') {
+            opts.inputPath = arg;
         }
         else {
             std::cerr << "Unknown option: " << arg << "\n";
@@ -1653,17 +1650,17 @@ int main(int argc, char* argv[]) {
     }
     
     // Apply target presets
-    if (targetType == "mcu") {
-        noGui = true;
-        noNetwork = true;
-        noDll = true;
+    if (opts.targetType == "mcu") {
+        opts.noGui = true;
+        opts.noNetwork = true;
+        opts.noDll = true;
         // noJson and noFloat are optional for MCU
-    } else if (targetType == "embedded") {
-        noGui = true;
+    } else if (opts.targetType == "embedded") {
+        opts.noGui = true;
     }
     
     // Resolve architecture aliases
-    if (!archTriple.empty()) {
+    if (!opts.archTriple.empty()) {
         static const std::map<std::string, std::pair<std::string, std::string>> archAliases = {
             {"arm-cortex-m",  {"thumbv7em-none-eabi", "cortex-m4"}},
             {"arm-cortex-m0", {"thumbv6m-none-eabi", "cortex-m0"}},
@@ -1681,56 +1678,222 @@ int main(int argc, char* argv[]) {
             {"wasm32",        {"wasm32-unknown-unknown", "generic"}},
         };
         
-        auto it = archAliases.find(archTriple);
+        auto it = archAliases.find(opts.archTriple);
         if (it != archAliases.end()) {
-            archTriple = it->second.first;
-            if (targetCpu.empty()) {
-                targetCpu = it->second.second;
+            opts.archTriple = it->second.first;
+            if (opts.targetCpu.empty()) {
+                opts.targetCpu = it->second.second;
             }
         }
     }
     
     // Validate options
-    if (sharedMode && runMode) {
+    if (opts.sharedMode && opts.runMode) {
         std::cerr << "Error: --shared and --run options are mutually exclusive\n";
         return 1;
     }
+    if (opts.daemonMode && (opts.watchMode || opts.connectMode)) {
+        std::cerr << "Error: --daemon cannot be combined with --watch or --connect\n";
+        return 1;
+    }
+    if (opts.jitMode && (opts.watchMode || opts.daemonMode || opts.connectMode)) {
+        std::cerr << "Error: --jit runs the program inside this process and cannot be combined with --watch, --daemon or --connect\n";
+        return 1;
+    }
+    if ((opts.jitCache || opts.jitLazy) && !opts.jitMode) {
+        std::cerr << "Error: --jit-cache and --jit-lazy require --jit\n";
+        return 1;
+    }
+    if (opts.jitCache && opts.jitLazy) {
+        std::cerr << "Error: --jit-lazy cannot be combined with --jit-cache\n";
+        return 1;
+    }
     
-    if (inputPath.empty()) {
+    return -1;
+}
+
+// ============================================================================
+// Build Cache (--daemon, --watch)
+// ============================================================================
+
+// Optimized object code of recent builds, most recently used first. For --run
+// requests the server also keeps the linked program in runDir, so an unchanged
+// script is handed back without compiling or linking.
+class BuildCache {
+public:
+    struct Entry {
+        uint64_t key = 0;
+        ObjectImage image;
+        bool linked = false;  // runExecutablePath(key) holds the linked program
+    };
+    
+    explicit BuildCache(const std::string& runDir = "") : runDir(runDir) {}
+    
+    ~BuildCache() {
+        for (const auto& entry : entries) {
+            if (entry.linked) {
+                std::error_code ec;
+                fs::remove(runExecutablePath(entry.key), ec);
+            }
+        }
+    }
+    
+    Entry* find(uint64_t key) {
+        auto it = index.find(key);
+        if (it == index.end()) {
+            misses++;
+            return nullptr;
+        }
+        hits++;
+        entries.splice(entries.begin(), entries, it->second);
+        return &entries.front();
+    }
+    
+    // Add a build that find() missed; evicts the least recently used builds over the limit
+    Entry* insert(uint64_t key, ObjectImage image) {
+        entries.push_front(Entry{key, std::move(image), false});
+        index[key] = entries.begin();
+        totalBytes += entries.front().image.bytes.size();
+        while (totalBytes > CACHE_LIMIT && entries.size() > 1) {
+            Entry& oldest = entries.back();
+            if (oldest.linked) {
+                std::error_code ec;
+                fs::remove(runExecutablePath(oldest.key), ec);
+            }
+            totalBytes -= oldest.image.bytes.size();
+            index.erase(oldest.key);
+            entries.pop_back();
+        }
+        return &entries.front();
+    }
+    
+    std::string runExecutablePath(uint64_t key) const {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+#ifdef _WIN32
+        return runDir + "/" + name + ".exe";
+#else
+        return runDir + "/" + name;
+#endif
+    }
+    
+    size_t hits = 0;
+    size_t misses = 0;
+    
+private:
+    static constexpr size_t CACHE_LIMIT = 256 * 1024 * 1024;
+    std::list<Entry> entries;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+    size_t totalBytes = 0;
+    std::string runDir;
+};
+
+// Hash everything that feeds a build: entry path, bundled source and assets,
+// alias config and the options that reach code generation or the linker
+static uint64_t computeBuildKey(const CompileOptions& opts, const std::string& source,
+                                const std::string& aliasConfigPath) {
+    std::string parts;
+    auto add = [&parts](const std::string& part) {
+        uint64_t hash = llvm::xxHash64(part);
+        parts.append((const char*)&hash, sizeof(hash));
+    };
+    add(currentSourceFile);
+    add(source);
+    for (const auto& asset : bundledAssets) {
+        add(asset.first);
+        add(asset.second);
+    }
+    add(aliasConfigPath.empty() ? "" : readBinaryFile(aliasConfigPath));
+    add(opts.sharedMode ? "shared" : "executable");
+    add(opts.archTriple);
+    add(opts.targetCpu);
+    add(opts.targetFeatures);
+    add(opts.iconPath.empty() ? "" : readBinaryFile(opts.iconPath));
+    const VersionInfo& info = opts.versionInfo;
+    add(info.company + "\n" + info.description + "\n" + info.copyright + "\n" +
+        info.version + "\n" + info.productName + "\n" + info.productVersion);
+    return llvm::xxHash64(parts);
+}
+
+// Object file for --jit-cache; the key also covers the compiler binary and the shared
+// runtime the JIT binds to, so a rebuilt moonc or libmoonrt never loads objects built
+// against an older one
+static std::string jitCachePath(const CompileOptions& opts, const std::string& source,
+                                const std::string& aliasConfigPath) {
+    std::error_code ec;
+    std::string identity = std::string(MOONLANG_VERSION_STRING) + "\n" + compilerPath;
+    auto size = fs::file_size(compilerPath, ec);
+    if (!ec) identity += "\n" + std::to_string(size);
+    auto modified = fs::last_write_time(compilerPath, ec);
+    if (!ec) identity += "\n" + std::to_string(modified.time_since_epoch().count());
+    identity += "\n" + LLVMCodeGen::jitRuntimeIdentity();
+    
+    uint64_t key = computeBuildKey(opts, source, aliasConfigPath) ^ llvm::xxHash64(identity);
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.o", (unsigned long long)key);
+    
+    // The default is private to this user: a shared directory would let anyone plant an
+    // object that the next run loads and executes
+    fs::path dir = opts.jitCacheDir;
+    if (dir.empty()) {
+        dir = LLVMCodeGen::userCacheDir("jit-v1");
+        if (dir.empty()) return "";
+    }
+    return (dir / name).string();
+}
+
+// ============================================================================
+// Build Pipeline
+// ============================================================================
+
+// --stats: what the optimizer removed from the program
+static void printCompileStats(const LLVMCodeGen& codegen) {
+    const RefcountStats& stats = codegen.getRefcountStats();
+    std::cout << "Optimizer statistics:\n";
+    std::cout << "  moon_retain calls:   " << stats.retainsBefore << " -> " << stats.retainsAfter << "\n";
+    std::cout << "  moon_release calls:  " << stats.releasesBefore << " -> " << stats.releasesAfter << "\n";
+    std::cout << "  borrowed parameters: " << stats.borrowedParams << "\n";
+}
+
+// Build one program: bundle, compile, link, then run it for --run. With a cache,
+// unchanged programs skip code generation; with runPath set, a --run build is
+// left in the cache for the caller to start and its path is stored there.
+static int compileProgram(CompileOptions opts, BuildCache* cache, std::string* runPath) {
+    if (opts.inputPath.empty()) {
         std::cerr << "Error: No input file specified\n";
         return 1;
     }
     
     // Check if input file exists
-    if (!fs::exists(inputPath)) {
+    if (!fs::exists(opts.inputPath)) {
         // Try in scripts/ directory
-        std::string scriptsPath = "scripts/" + inputPath;
+        std::string scriptsPath = "scripts/" + opts.inputPath;
         if (fs::exists(scriptsPath)) {
-            inputPath = scriptsPath;
+            opts.inputPath = scriptsPath;
         } else {
-            std::cerr << "Error: File not found: " << inputPath << "\n";
+            std::cerr << "Error: File not found: " << opts.inputPath << "\n";
             return 1;
         }
     }
     
     // Check file extension - only .moon or .mn files are allowed
-    if (!isValidMoonFile(inputPath)) {
+    if (!isValidMoonFile(opts.inputPath)) {
         std::cerr << "Error: Invalid file type. Only .moon or .mn files are supported.\n";
-        std::cerr << "File: " << inputPath << "\n";
+        std::cerr << "File: " << opts.inputPath << "\n";
         return 1;
     }
     
     // Store for error reporting
-    currentSourceFile = fs::absolute(inputPath).string();
+    currentSourceFile = fs::absolute(opts.inputPath).string();
     
     // Determine output path
-    if (outputPath.empty()) {
-        std::string baseName = fs::path(inputPath).stem().string();
-        if (sharedMode) {
+    if (opts.outputPath.empty()) {
+        std::string baseName = fs::path(opts.inputPath).stem().string();
+        if (opts.sharedMode) {
 #ifdef _WIN32
-            outputPath = baseName + ".dll";
+            opts.outputPath = baseName + ".dll";
 #else
-            outputPath = baseName + ".so";
+            opts.outputPath = baseName + ".so";
 #endif
         } else {
 #ifdef _WIN32
@@ -1738,37 +1901,39 @@ int main(int argc, char* argv[]) {
 #else
             std::string exeExt = "";  // Linux executables don't need extension
 #endif
-            if (runMode) {
+            if (opts.runMode) {
                 // Use a temporary file for run mode
-                outputPath = baseName + "_moonc_temp_" + std::to_string(time(NULL)) + exeExt;
+                opts.outputPath = baseName + "_moonc_temp_" + std::to_string(time(NULL)) + exeExt;
             } else {
-                outputPath = baseName + exeExt;
+                opts.outputPath = baseName + exeExt;
             }
         }
     }
     
     // Auto-find icon.ico if not specified
-    if (iconPath.empty()) {
-        std::string baseDir = fs::path(inputPath).parent_path().string();
+    if (opts.iconPath.empty()) {
+        std::string baseDir = fs::path(opts.inputPath).parent_path().string();
         if (baseDir.empty()) baseDir = ".";
         
         // Check for icon.ico in same directory as input file
         std::string localIcon = baseDir + "/icon.ico";
         if (fs::exists(localIcon)) {
-            iconPath = localIcon;
+            opts.iconPath = localIcon;
         }
     }
     
     try {
+        sourceDependencies.clear();
+        
         // Read source file
-        std::string source = readFile(inputPath);
+        std::string source = readFile(opts.inputPath);
         
         // Store for error reporting context
         currentSource = source;
         
         // Bundle modules if enabled
-        if (bundleModules) {
-            std::string baseDir = fs::path(inputPath).parent_path().string();
+        if (opts.bundleModules) {
+            std::string baseDir = fs::path(opts.inputPath).parent_path().string();
             if (baseDir.empty()) baseDir = ".";
             source = bundleSource(source, baseDir);
             // Update stored source for error context
@@ -1777,12 +1942,13 @@ int main(int argc, char* argv[]) {
         
         // Load alias configuration if specified
         AliasMap aliasMap;
-        if (!aliasPath.empty()) {
-            std::string actualAliasPath = aliasPath;
+        std::string aliasConfigPath;  // Loaded alias file, part of the build key
+        if (!opts.aliasPath.empty()) {
+            std::string actualAliasPath = opts.aliasPath;
             
-            if (aliasPath == "auto") {
+            if (opts.aliasPath == "auto") {
                 // Auto-find moon-alias.json
-                std::string baseDir = fs::path(inputPath).parent_path().string();
+                std::string baseDir = fs::path(opts.inputPath).parent_path().string();
                 if (baseDir.empty()) baseDir = ".";
                 
                 // Search order: source dir, then compiler dir
@@ -1805,41 +1971,96 @@ int main(int argc, char* argv[]) {
                     std::cerr << "Warning: Failed to load alias config: " << aliasMap.getError() << "\n";
                 } else {
                     std::cout << "Using alias config: " << actualAliasPath << "\n";
+                    aliasConfigPath = actualAliasPath;
                 }
-            } else if (aliasPath != "auto") {
-                std::cerr << "Warning: Alias config not found: " << aliasPath << "\n";
+            } else if (opts.aliasPath != "auto") {
+                std::cerr << "Warning: Alias config not found: " << opts.aliasPath << "\n";
             }
         }
         
-        // Lexical analysis
-        Lexer lexer(source);
-        if (aliasMap.isLoaded()) {
-            lexer.setAliasMap(&aliasMap);
+        // Unchanged programs are served from the build cache (--daemon, --watch)
+        uint64_t buildKey = 0;
+        BuildCache::Entry* cached = nullptr;
+        if (cache) {
+            buildKey = computeBuildKey(opts, source, aliasConfigPath);
+            cached = cache->find(buildKey);
+            if (runPath) {
+                opts.outputPath = cache->runExecutablePath(buildKey);
+                if (cached && cached->linked && fs::exists(opts.outputPath)) {
+                    *runPath = opts.outputPath;
+                    return 0;
+                }
+            }
         }
-        std::vector<Token> tokens = lexer.tokenize();
         
-        // Parsing
-        Parser parser(tokens);
-        Program program = parser.parse();
+        // --jit-cache: an object saved by an earlier run of the same program is run as is
+        std::string jitObjectPath;
+        bool jitCached = false;
+        if (opts.jitMode && opts.jitCache) {
+            jitObjectPath = jitCachePath(opts, source, aliasConfigPath);
+            jitCached = !jitObjectPath.empty() && fs::exists(jitObjectPath);
+        }
         
+        Program program;
+        if (!cached && !jitCached) {
+            // Lexical analysis
+            Lexer lexer(source);
+            if (aliasMap.isLoaded()) {
+                lexer.setAliasMap(&aliasMap);
+            }
+            std::vector<Token> tokens = lexer.tokenize();
+            
+            // Parsing
+            Parser parser(tokens);
+            program = parser.parse();
+            
+            // Frontend throughput benchmark: lex and parse the bundled source repeatedly
+            if (opts.benchFrontend > 0) {
+                using Clock = std::chrono::steady_clock;
+                double lexSeconds = 0, parseSeconds = 0;
+                size_t tokenCount = 0;
+                for (int i = 0; i < opts.benchFrontend; i++) {
+                    auto t0 = Clock::now();
+                    Lexer benchLexer(source);
+                    if (aliasMap.isLoaded()) {
+                        benchLexer.setAliasMap(&aliasMap);
+                    }
+                    std::vector<Token> benchTokens = benchLexer.tokenize();
+                    auto t1 = Clock::now();
+                    Parser benchParser(benchTokens);
+                    benchParser.parse();
+                    auto t2 = Clock::now();
+                    lexSeconds += std::chrono::duration<double>(t1 - t0).count();
+                    parseSeconds += std::chrono::duration<double>(t2 - t1).count();
+                    tokenCount = benchTokens.size();
+                }
+                double mb = (double)source.size() * opts.benchFrontend / (1024.0 * 1024.0);
+                double tokens = (double)tokenCount * opts.benchFrontend;
+                printf("Source: %zu bytes, %zu tokens, %d iterations\n", source.size(), tokenCount, opts.benchFrontend);
+                printf("Lexer:  %8.1f MB/s  %8.2f Mtokens/s\n", mb / lexSeconds, tokens / lexSeconds / 1e6);
+                printf("Parser: %8.1f MB/s  %8.2f Mtokens/s\n", mb / parseSeconds, tokens / parseSeconds / 1e6);
+                return 0;
+            }
+        }
+            
         // Code generation
         LLVMCodeGen codegen;
         
         // Enable shared library mode if requested
-        if (sharedMode) {
+        if (opts.sharedMode) {
             codegen.setSharedLibraryMode(true);
         }
         
         // Set cross-compilation target if specified
-        if (!archTriple.empty()) {
-            codegen.setTargetTriple(archTriple);
-            std::cout << "Cross-compiling for: " << archTriple << "\n";
+        if (!opts.archTriple.empty()) {
+            codegen.setTargetTriple(opts.archTriple);
+            std::cout << "Cross-compiling for: " << opts.archTriple << "\n";
         }
-        if (!targetCpu.empty()) {
-            codegen.setTargetCPU(targetCpu);
+        if (!opts.targetCpu.empty()) {
+            codegen.setTargetCPU(opts.targetCpu);
         }
-        if (!targetFeatures.empty()) {
-            codegen.setTargetFeatures(targetFeatures);
+        if (!opts.targetFeatures.empty()) {
+            codegen.setTargetFeatures(opts.targetFeatures);
         }
         
         // Set source file for better error messages
@@ -1850,26 +2071,64 @@ int main(int argc, char* argv[]) {
             codegen.setAliasMap(&aliasMap);
         }
         
-        std::string moduleName = fs::path(inputPath).stem().string();
-        if (!codegen.compile(program, moduleName)) {
-            displayError("Compile Error", codegen.getError(), codegen.getErrorLine(), 1, 
-                        currentSourceFile, currentSource);
-            return 1;
+        // Files embedded by the bundler go into the executable's asset section
+        for (const auto& asset : bundledAssets) {
+            codegen.addAsset(asset.first, asset.second);
+        }
+        
+        std::string moduleName = fs::path(opts.inputPath).stem().string();
+        
+        // In-process run: no object file, no linker
+        if (opts.jitMode) {
+            if (!jitCached && !codegen.compile(program, moduleName)) {
+                displayError("Compile Error", codegen.getError(), codegen.getErrorLine(), 1, 
+                            currentSourceFile, currentSource);
+                return 1;
+            }
+            int exitCode = codegen.runJIT({currentSourceFile}, jitObjectPath, opts.jitLazy);
+            if (exitCode < 0 && codegen.hasError()) {
+                displayError("JIT Error", codegen.getError(), 0, 1, 
+                            currentSourceFile, currentSource);
+                return 1;
+            }
+            if (opts.showStats && !jitCached) printCompileStats(codegen);
+            return exitCode;
         }
         
-        if (sharedMode) {
+        if (cached) {
+            codegen.useObjectImage(&cached->image);
+        } else {
+            if (!codegen.compile(program, moduleName)) {
+                displayError("Compile Error", codegen.getError(), codegen.getErrorLine(), 1, 
+                            currentSourceFile, currentSource);
+                return 1;
+            }
+            if (cache) {
+                ObjectImage image;
+                if (!codegen.emitObjectImage(image)) {
+                    displayError("Link Error", codegen.getError(), 0, 1, 
+                                currentSourceFile, currentSource);
+                    return 1;
+                }
+                cached = cache->insert(buildKey, std::move(image));
+                codegen.useObjectImage(&cached->image);
+            }
+        }
+        
+        if (opts.sharedMode) {
             // Emit shared library
-            if (!codegen.emitSharedLibrary(outputPath, "")) {
+            if (!codegen.emitSharedLibrary(opts.outputPath, "")) {
                 displayError("Link Error", codegen.getError(), 0, 1, 
                             currentSourceFile, currentSource);
                 return 1;
             }
+            if (opts.showStats) printCompileStats(codegen);
             
             // Generate C header file if requested
-            if (!headerPath.empty()) {
-                std::ofstream headerFile(headerPath);
+            if (!opts.headerPath.empty()) {
+                std::ofstream headerFile(opts.headerPath);
                 if (headerFile) {
-                    std::string guardName = fs::path(headerPath).stem().string();
+                    std::string guardName = fs::path(opts.headerPath).stem().string();
                     std::transform(guardName.begin(), guardName.end(), guardName.begin(), ::toupper);
                     guardName += "_H";
                     
@@ -1919,13 +2178,13 @@ int main(int argc, char* argv[]) {
                     headerFile << "#endif\n\n";
                     headerFile << "#endif // " << guardName << "\n";
                     headerFile.close();
-                    std::cout << "Header generated: " << headerPath << "\n";
+                    std::cout << "Header generated: " << opts.headerPath << "\n";
                 } else {
-                    std::cerr << "Warning: Could not create header file: " << headerPath << "\n";
+                    std::cerr << "Warning: Could not create header file: " << opts.headerPath << "\n";
                 }
             }
             
-            std::cout << "Build successful: " << outputPath << "\n";
+            std::cout << "Build successful: " << opts.outputPath << "\n";
             
             // List exported functions
             const auto& exports = codegen.getExportedFunctions();
@@ -1939,20 +2198,28 @@ int main(int argc, char* argv[]) {
             }
         } else {
             // Emit executable
-            if (!codegen.emitExecutable(outputPath, "", iconPath, versionInfo)) {
+            if (!codegen.emitExecutable(opts.outputPath, "", opts.iconPath, opts.versionInfo)) {
                 displayError("Link Error", codegen.getError(), 0, 1, 
                             currentSourceFile, currentSource);
                 return 1;
             }
+            if (opts.showStats) printCompileStats(codegen);
+            
+            if (runPath) {
+                // The caller runs it; the executable stays in the cache
+                cached->linked = true;
+                *runPath = opts.outputPath;
+                return 0;
+            }
             
-            if (runMode) {
+            if (opts.runMode) {
                 // Run the compiled executable
-                std::string absPath = fs::absolute(outputPath).string();
+                std::string absPath = fs::absolute(opts.outputPath).string();
                 int exitCode = system(("\"" + absPath + "\"").c_str());
                 
                 // Delete the temporary executable
                 try {
-                    fs::remove(outputPath);
+                    fs::remove(opts.outputPath);
                 } catch (...) {
                     // Ignore deletion errors
                 }
@@ -1960,7 +2227,7 @@ int main(int argc, char* argv[]) {
                 return exitCode;
             }
             
-            std::cout << "Build successful: " << outputPath << "\n";
+            std::cout << "Build successful: " << opts.outputPath << "\n";
         }
         return 0;
         
@@ -1977,3 +2244,515 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 }
+
+// ============================================================================
+// Watch Mode (--watch)
+// ============================================================================
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void requestStop(int) {
+    stopRequested = 1;
+}
+
+static void installStopHandlers() {
+#ifdef _WIN32
+    signal(SIGINT, requestStop);
+    signal(SIGTERM, requestStop);
+#else
+    // No SA_RESTART, so a blocking accept() or poll() returns and the loop can exit
+    struct sigaction sa = {};
+    sa.sa_handler = requestStop;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+#endif
+}
+
+// Folders pulled in by moon_bundle() and all their subfolders; new files there change the build
+static std::set<std::string> bundledDirectories() {
+    std::set<std::string> dirs;
+    for (const auto& folder : bundledFolders) {
+        std::error_code ec;
+        dirs.insert(fs::path(folder).lexically_normal().string());
+        for (fs::recursive_directory_iterator it(folder, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->is_directory(ec) && !shouldExcludeDir(it->path().string())) {
+                dirs.insert(it->path().lexically_normal().string());
+            }
+        }
+    }
+    return dirs;
+}
+
+// True when a changed path can affect the last build
+static bool isBuildInput(const std::string& path) {
+    if (sourceDependencies.count(path)) return true;
+    for (const auto& folder : bundledFolders) {
+        std::string prefix = fs::path(folder).lexically_normal().string();
+        if (path.size() > prefix.size() && path.compare(0, prefix.size(), prefix) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifdef __linux__
+// Block until a file the last build read changes; false when interrupted
+static bool waitForChange() {
+    int fd = inotify_init1(IN_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Error: inotify is unavailable\n";
+        return false;
+    }
+    
+    std::set<std::string> dirs = bundledDirectories();
+    for (const auto& file : sourceDependencies) {
+        dirs.insert(fs::path(file).parent_path().string());
+    }
+    std::map<int, std::string> watches;
+    for (const auto& dir : dirs) {
+        int wd = inotify_add_watch(fd, dir.c_str(),
+                                   IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO);
+        if (wd >= 0) watches[wd] = dir;
+    }
+    
+    bool changed = false;
+    alignas(struct inotify_event) char buffer[4096];
+    while (!stopRequested) {
+        // After the first change, wait for a quiet spell so a burst of saves is one rebuild
+        struct pollfd pfd = {fd, POLLIN, 0};
+        int ready = poll(&pfd, 1, changed ? 100 : -1);
+        if (ready == 0) break;
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        ssize_t len = read(fd, buffer, sizeof(buffer));
+        for (char* p = buffer; len > 0 && p < buffer + len; ) {
+            auto* event = (struct inotify_event*)p;
+            auto it = watches.find(event->wd);
+            if (event->len > 0 && it != watches.end()) {
+                std::string path = (fs::path(it->second) / event->name).lexically_normal().string();
+                if (isBuildInput(path)) changed = true;
+            }
+            p += sizeof(struct inotify_event) + event->len;
+        }
+    }
+    close(fd);
+    return changed && !stopRequested;
+}
+#else
+// Block until a file the last build read changes; polls modification times
+static bool waitForChange() {
+    auto snapshot = []() {
+        std::map<std::string, fs::file_time_type> times;
+        std::error_code ec;
+        for (const auto& file : sourceDependencies) {
+            times[file] = fs::last_write_time(file, ec);
+        }
+        for (const auto& dir : bundledDirectories()) {
+            times[dir] = fs::last_write_time(dir, ec);
+        }
+        return times;
+    };
+    auto before = snapshot();
+    while (!stopRequested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        if (snapshot() != before) {
+            // Let a burst of saves settle
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            return !stopRequested;
+        }
+    }
+    return false;
+}
+#endif
+
+// Build, then rebuild (and rerun with -r) each time an input changes.
+// Unchanged content is relinked from the cache instead of recompiled.
+static int runWatch(const CompileOptions& opts) {
+    BuildCache cache;
+    installStopHandlers();
+    int result = 0;
+    while (!stopRequested) {
+        auto start = std::chrono::steady_clock::now();
+        size_t hits = cache.hits;
+        result = compileProgram(opts, &cache, nullptr);
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        
+        // A missing entry file is still worth waiting for
+        sourceDependencies.insert(fs::absolute(opts.inputPath).lexically_normal().string());
+        
+        std::cout << "[watch] " << (result == 0 ? "Done" : "Failed") << " in " << ms << " ms"
+                  << (cache.hits > hits ? " (unchanged, not recompiled)" : "")
+                  << "; waiting for changes (Ctrl+C to stop)\n";
+        if (!waitForChange()) break;
+        std::cout << "\n[watch] Change detected, rebuilding...\n";
+    }
+    return result;
+}
+
+// ============================================================================
+// Compile Server (--daemon, --connect)
+// ============================================================================
+//
+// A client sends a u32 count followed by that many strings (u32 length + bytes):
+// its working directory, then its command-line arguments. The server answers
+// with frames of one kind byte and one string: 'o' stdout text, 'e' stderr text,
+// 'r' the executable a --run client should start, and finally 'x' the exit code.
+// Requests are served one at a time; the server changes into each client's
+// directory while building. Both ends only talk to a peer running as the same
+// user, and the client starts 'r' executables directly, never through a shell.
+
+#ifndef _WIN32
+static std::string defaultSocketPath() {
+    const char* runtimeDir = getenv("XDG_RUNTIME_DIR");
+    if (runtimeDir && *runtimeDir) {
+        return std::string(runtimeDir) + "/moonc.sock";
+    }
+    return "/tmp/moonc-" + std::to_string(getuid()) + ".sock";
+}
+
+// True when the process on the other end of fd runs as this user
+static bool peerIsSelf(int fd) {
+#ifdef __linux__
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    return getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) == 0 && cred.uid == getuid();
+#else
+    uid_t uid;
+    gid_t gid;
+    return getpeereid(fd, &uid, &gid) == 0 && uid == getuid();
+#endif
+}
+
+// A server socket is trusted only if this user owns it and it sits in a
+// directory nobody else can swap it out of (ours, or a sticky one like /tmp).
+// Empty result means trusted; otherwise the reason it is not.
+static std::string socketDistrust(const std::string& path) {
+    struct stat st;
+    if (lstat(path.c_str(), &st) != 0) return "";   // Nothing there; connect will fail
+    if (!S_ISSOCK(st.st_mode)) return "not a socket";
+    if (st.st_uid != getuid()) return "owned by another user";
+    
+    std::string dir = fs::path(path).parent_path().string();
+    struct stat dirSt;
+    if (stat(dir.empty() ? "." : dir.c_str(), &dirSt) != 0) return "directory is not accessible";
+    if (dirSt.st_uid != getuid() && dirSt.st_uid != 0) return "directory owned by another user";
+    if ((dirSt.st_mode & (S_IWGRP | S_IWOTH)) && !(dirSt.st_mode & S_ISVTX)) {
+        return "directory is writable by other users";
+    }
+    return "";
+}
+
+static int connectSocket(const std::string& path) {
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) return -1;
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Start an executable without a shell and wait for it; returns its exit code
+static int runExecutable(const std::string& path) {
+    char* args[] = { (char*)path.c_str(), nullptr };
+    pid_t pid;
+    int err = posix_spawn(&pid, path.c_str(), nullptr, nullptr, args, environ);
+    if (err != 0) {
+        std::cerr << "Error: Cannot run " << path << ": " << strerror(err) << "\n";
+        return 1;
+    }
+    int status;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) return 1;
+    }
+    if (WIFEXITED(status)) return WEXITSTATUS(status);
+    if (WIFSIGNALED(status)) return 128 + WTERMSIG(status);
+    return 1;
+}
+
+static bool writeAll(int fd, const void* data, size_t size) {
+    const char* p = (const char*)data;
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+static bool readAll(int fd, void* data, size_t size) {
+    char* p = (char*)data;
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+static bool sendString(int fd, const std::string& text) {
+    uint32_t len = (uint32_t)text.size();
+    return writeAll(fd, &len, sizeof(len)) && writeAll(fd, text.data(), text.size());
+}
+
+static bool recvString(int fd, std::string& text) {
+    uint32_t len;
+    if (!readAll(fd, &len, sizeof(len)) || len > (1u << 30)) return false;
+    text.resize(len);
+    return readAll(fd, &text[0], len);
+}
+
+static bool sendFrame(int fd, char kind, const std::string& text) {
+    return writeAll(fd, &kind, 1) && sendString(fd, text);
+}
+
+static void serveRequest(int client, BuildCache& cache) {
+    uint32_t count;
+    if (!readAll(client, &count, sizeof(count)) || count == 0 || count > 4096) return;
+    std::vector<std::string> args(count);
+    for (auto& arg : args) {
+        if (!recvString(client, arg)) return;
+    }
+    
+    // args[0] is the client's working directory; the rest stand in for argv[1..]
+    std::vector<char*> argv;
+    argv.push_back((char*)"moonc");
+    for (size_t i = 1; i < args.size(); i++) {
+        argv.push_back(&args[i][0]);
+    }
+    
+    std::ostringstream out, err;
+    std::streambuf* savedOut = std::cout.rdbuf(out.rdbuf());
+    std::streambuf* savedErr = std::cerr.rdbuf(err.rdbuf());
+    
+    auto start = std::chrono::steady_clock::now();
+    size_t hits = cache.hits;
+    std::string runPath;
+    CompileOptions opts;
+    int exitCode = parseArguments((int)argv.size(), argv.data(), opts);
+    if (exitCode < 0) {
+        if (opts.watchMode || opts.daemonMode || opts.jitMode) {
+            std::cerr << "Error: --watch, --daemon and --jit cannot be sent to a compile server\n";
+            exitCode = 1;
+        } else if (chdir(args[0].c_str()) != 0) {
+            std::cerr << "Error: Cannot enter directory: " << args[0] << "\n";
+            exitCode = 1;
+        } else {
+            exitCode = compileProgram(opts, &cache, opts.runMode ? &runPath : nullptr);
+        }
+    }
+    
+    std::cout.rdbuf(savedOut);
+    std::cerr.rdbuf(savedErr);
+    
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << (exitCode == 0 ? "[ok] " : "[failed] ") << opts.inputPath << " in " << ms << " ms"
+              << (cache.hits > hits ? " (cached)" : "") << "\n";
+    
+    if (!out.str().empty()) sendFrame(client, 'o', out.str());
+    if (!err.str().empty()) sendFrame(client, 'e', err.str());
+    if (!runPath.empty()) sendFrame(client, 'r', runPath);
+    sendFrame(client, 'x', std::to_string(exitCode));
+}
+
+// Serve builds until SIGINT/SIGTERM; LLVM stays initialized and built programs stay cached
+static int runDaemon(const CompileOptions& opts) {
+    std::string socketPath = opts.socketPath.empty() ? defaultSocketPath() : opts.socketPath;
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Error: Socket path is too long: " << socketPath << "\n";
+        return 1;
+    }
+    memcpy(addr.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    
+    // Never take over (or unlink) a path another user controls
+    std::string distrust = socketDistrust(socketPath);
+    if (!distrust.empty()) {
+        std::cerr << "Error: Refusing socket " << socketPath << ": " << distrust << "\n";
+        return 1;
+    }
+    
+    // Refuse to start twice; clear a socket left behind by a server that died
+    int probe = connectSocket(socketPath);
+    if (probe >= 0) {
+        close(probe);
+        std::cerr << "Error: A compile server is already listening on " << socketPath << "\n";
+        return 1;
+    }
+    unlink(socketPath.c_str());
+    
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    mode_t savedMask = umask(077);  // Only this user may connect
+    bool bound = listenFd >= 0 && bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)) == 0;
+    umask(savedMask);
+    if (!bound || listen(listenFd, 16) != 0) {
+        std::cerr << "Error: Cannot listen on " << socketPath << ": " << strerror(errno) << "\n";
+        if (listenFd >= 0) close(listenFd);
+        return 1;
+    }
+    
+    // Built programs live in a fresh 0700 directory with an unguessable name;
+    // clients run them, so no other user may create or write it
+    std::error_code ec;
+    std::string runTemplate = (fs::temp_directory_path(ec) / "moonc-daemon-XXXXXX").string();
+    std::vector<char> runTemplateBuf(runTemplate.begin(), runTemplate.end());
+    runTemplateBuf.push_back('\0');
+    if (!mkdtemp(runTemplateBuf.data())) {
+        std::cerr << "Error: Cannot create a run directory in " << fs::temp_directory_path(ec).string()
+                  << ": " << strerror(errno) << "\n";
+        close(listenFd);
+        unlink(socketPath.c_str());
+        return 1;
+    }
+    std::string runDir = runTemplateBuf.data();
+    
+    // Initialize LLVM once, before the first request
+    { LLVMCodeGen warmup; }
+    
+    installStopHandlers();
+    std::cout << "Compile server listening on " << socketPath << " (Ctrl+C to stop)\n";
+    
+    size_t hits = 0, misses = 0;
+    {
+        BuildCache cache(runDir);
+        while (!stopRequested) {
+            int client = accept(listenFd, nullptr, nullptr);
+            if (client < 0) continue;
+            if (peerIsSelf(client)) serveRequest(client, cache);
+            close(client);
+        }
+        hits = cache.hits;
+        misses = cache.misses;
+    }
+    
+    close(listenFd);
+    unlink(socketPath.c_str());
+    fs::remove_all(runDir, ec);
+    std::cout << "Compile server stopped (" << hits << " cache hits, " << misses << " misses)\n";
+    return 0;
+}
+
+// Send this build to a running server and relay its output; false when none is listening
+static bool runClient(int argc, char* argv[], const std::string& socketPath, int& exitCode) {
+    std::string distrust = socketDistrust(socketPath);
+    if (!distrust.empty()) {
+        std::cerr << "Warning: Ignoring compile server socket " << socketPath << ": " << distrust << "\n";
+        return false;
+    }
+    int fd = connectSocket(socketPath);
+    if (fd < 0) return false;
+    if (!peerIsSelf(fd)) {
+        close(fd);
+        std::cerr << "Warning: Ignoring compile server on " << socketPath << ": it runs as another user\n";
+        return false;
+    }
+    
+    std::string cwd = fs::current_path().string();
+    uint32_t count = (uint32_t)argc;  // cwd replaces argv[0]
+    bool sent = writeAll(fd, &count, sizeof(count)) && sendString(fd, cwd);
+    for (int i = 1; sent && i < argc; i++) {
+        sent = sendString(fd, argv[i]);
+    }
+    
+    std::string runPath;
+    bool finished = false;
+    char kind;
+    std::string text;
+    while (sent && readAll(fd, &kind, 1) && recvString(fd, text)) {
+        if (kind == 'o') std::cout << text;
+        else if (kind == 'e') std::cerr << text;
+        else if (kind == 'r') runPath = text;
+        else if (kind == 'x') {
+            exitCode = atoi(text.c_str());
+            finished = true;
+            break;
+        }
+    }
+    close(fd);
+    
+    if (!finished) {
+        std::cerr << "Error: Compile server at " << socketPath << " closed the connection\n";
+        exitCode = 1;
+    } else if (exitCode == 0 && !runPath.empty()) {
+        // The server keeps the executable cached; run it here, in the caller's terminal
+        exitCode = runExecutable(runPath);
+    }
+    return true;
+}
+#endif
+
+// ============================================================================
+// Main Entry Point
+// ============================================================================
+
+int main(int argc, char* argv[]) {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+#endif
+
+    // Get compiler directory for stdlib resolution
+    compilerDir = getCompilerDir(argv[0]);
+
+    // Force flush on all outputs
+    std::cout << std::unitbuf;
+    std::cerr << std::unitbuf;
+
+    if (argc < 2) {
+        printUsage(argv[0]);
+        std::cout.flush();
+        return 1;
+    }
+    
+    CompileOptions opts;
+    int exitCode = parseArguments(argc, argv, opts);
+    if (exitCode >= 0) {
+        return exitCode;
+    }
+    
+#ifdef _WIN32
+    if (opts.daemonMode || opts.connectMode) {
+        std::cerr << "Error: --daemon and --connect are not supported on Windows\n";
+        return 1;
+    }
+#else
+    if (opts.daemonMode) {
+        return runDaemon(opts);
+    }
+    
+    // --connect requires a server; MOONC_SOCKET uses one when it is listening
+    const char* envSocket = getenv("MOONC_SOCKET");
+    bool useEnvSocket = envSocket && *envSocket;
+    if ((opts.connectMode || useEnvSocket) && !opts.watchMode && !opts.jitMode && opts.benchFrontend == 0) {
+        std::string socketPath = !opts.socketPath.empty() ? opts.socketPath
+                               : useEnvSocket ? std::string(envSocket) : defaultSocketPath();
+        if (runClient(argc, argv, socketPath, exitCode)) {
+            return exitCode;
+        }
+        if (opts.connectMode) {
+            std::cerr << "Error: No compile server is listening on " << socketPath
+                      << " (start one with: moonc --daemon)\n";
+            return 1;
+        }
+    }
+#endif
+    
+    if (opts.watchMode) {
+        return runWatch(opts);
+    }
+    return compileProgram(opts, nullptr, nullptr);
+}
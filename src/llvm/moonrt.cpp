@@ -14,7 +14,11 @@
 //   moonrt_io.cpp       - File I/O, paths, date/time
 //   moonrt_json.cpp     - JSON encoding/decoding (conditional)
 //   moonrt_network.cpp  - TCP/UDP networking (conditional)
+//   moonrt_http.cpp     - HTTP/1.1 server (conditional, with network)
 //   moonrt_dll.cpp      - DLL/shared library loading (conditional)
+//   moonrt_zlib.cpp     - zlib resolved at run time (compression)
+//   moonrt_uring.cpp    - io_uring engine for coroutine file/socket I/O
+//   moonrt_assets.cpp   - Compressed assets embedded by moonc
 //   moonrt_regex.cpp    - Regular expressions using PCRE2 (conditional)
 //   moonrt_tls.cpp      - TLS/SSL support using OpenSSL (conditional)
 //   moonrt_async.cpp    - Async/await support (separate)
@@ -35,7 +39,11 @@
 #include "moonrt_io.cpp"
 #include "moonrt_json.cpp"
 #include "moonrt_network.cpp"
+#include "moonrt_http.cpp"
 #include "moonrt_dll.cpp"
+#include "moonrt_zlib.cpp"
+#include "moonrt_uring.cpp"
+#include "moonrt_assets.cpp"
 
 // Note: moonrt_regex.cpp, moonrt_async.cpp, moonrt_channel.cpp, moonrt_gui.cpp,
 // and moonrt_tls.cpp are compiled separately to allow for conditional compilation
@@ -29,7 +29,8 @@ typedef enum {
     MOON_OBJECT,
     MOON_CLASS,
     MOON_CLOSURE,   // Closure with captured variables
-    MOON_BIGINT     // Arbitrary precision integer
+    MOON_BIGINT,    // Arbitrary precision integer
+    MOON_BUFFER     // Byte view over memory owned elsewhere (no copy)
 } MoonType;
 
 // Forward declarations
@@ -40,6 +41,7 @@ struct MoonObject;
 struct MoonClass;
 struct MoonClosure;
 struct MoonBigInt;
+struct MoonBuffer;
 
 typedef struct MoonValue MoonValue;
 typedef struct MoonList MoonList;
@@ -48,6 +50,7 @@ typedef struct MoonObject MoonObject;
 typedef struct MoonClass MoonClass;
 typedef struct MoonClosure MoonClosure;
 typedef struct MoonBigInt MoonBigInt;
+typedef struct MoonBuffer MoonBuffer;
 
 // Function pointer type
 typedef MoonValue* (*MoonFunc)(MoonValue** args, int argc);
@@ -82,9 +85,26 @@ struct MoonValue {
         MoonClass* classVal;
         MoonClosure* closureVal;
         MoonBigInt* bigintVal;
+        MoonBuffer* bufferVal;
     } data;
 };
 
+// ============================================================================
+// String Capacity Header (for optimized concatenation)
+// ============================================================================
+// Precedes the characters of every runtime string. The code generator emits
+// string literals with this header, so its layout is shared with moonc.
+
+#define MOON_STR_MAGIC 0x4D4F4F4E53545243ULL  // "MOONSTRC" in hex
+
+typedef struct MoonStrHeader {
+    uint64_t magic;
+    size_t capacity;
+    size_t length;
+    uint32_t cachedHash;  // Cached FNV-1a hash value
+    bool hashValid;       // Whether cachedHash is valid
+} MoonStrHeader;
+
 // ============================================================================
 // List structure
 // ============================================================================
@@ -93,6 +113,20 @@ struct MoonList {
     MoonValue** items;
     int32_t length;
     int32_t capacity;
+    bool shared;        // items belong to a constant literal; copied before the first write
+};
+
+// ============================================================================
+// Buffer structure (bytes shared with a string, a parent buffer or C memory)
+// ============================================================================
+
+struct MoonBuffer {
+    const char* data;            // First byte of the view
+    size_t length;               // Bytes in the view
+    MoonValue* owner;            // Value keeping the bytes alive, or NULL
+    void (*release)(void* base); // Frees C-owned memory with the buffer, or NULL
+    void* base;                  // Argument passed to release
+    bool terminated;             // data[length] is a readable NUL
 };
 
 // ============================================================================
@@ -111,6 +145,7 @@ struct MoonDict {
     MoonDictEntry* entries;
     int32_t length;     // Number of entries
     int32_t capacity;   // Total slots (power of 2)
+    bool shared;        // entries belong to a constant literal; copied before the first write
 };
 
 // ============================================================================
@@ -161,8 +196,13 @@ MoonValue* moon_string(const char* str);
 MoonValue* moon_string_owned(char* str);  // Takes ownership
 MoonValue* moon_list_new(void);
 MoonValue* moon_dict_new(void);
+// Constant literals: the list/dict shares the literal's items until it is modified
+MoonValue* moon_list_const(MoonValue** items, int32_t count);
+MoonValue* moon_dict_const(MoonValue** table, MoonValue** keys, MoonValue** values, int32_t count);
 MoonValue* moon_func(MoonFunc fn);
 MoonValue* moon_call_func(MoonValue* func, MoonValue** args, int argc);
+MoonValue* moon_buffer_new(const char* data, size_t length, MoonValue* owner,
+                           void (*release)(void* base), void* base);
 
 // BigInt support
 MoonValue* moon_bigint_from_int(int64_t val);
@@ -199,6 +239,7 @@ bool moon_is_string(MoonValue* val);
 bool moon_is_list(MoonValue* val);
 bool moon_is_dict(MoonValue* val);
 bool moon_is_object(MoonValue* val);
+bool moon_is_buffer(MoonValue* val);
 bool moon_is_truthy(MoonValue* val);
 
 // ============================================================================
@@ -208,7 +249,8 @@ bool moon_is_truthy(MoonValue* val);
 int64_t moon_to_int(MoonValue* val);
 double moon_to_float(MoonValue* val);
 bool moon_to_bool(MoonValue* val);
-char* moon_to_string(MoonValue* val);  // Caller must free
+char* moon_to_string(MoonValue* val);  // Caller must moon_free() it
+const char* moon_bytes_view(MoonValue* val, size_t* len);  // String/buffer bytes, else NULL
 MoonValue* moon_cast_int(MoonValue* val);
 MoonValue* moon_cast_float(MoonValue* val);
 MoonValue* moon_cast_string(MoonValue* val);
@@ -218,12 +260,20 @@ MoonValue* moon_cast_string(MoonValue* val);
 // ============================================================================
 
 MoonValue* moon_add(MoonValue* a, MoonValue* b);
+MoonValue* moon_add_assign(MoonValue** slot, MoonValue* a, MoonValue* b);
 MoonValue* moon_sub(MoonValue* a, MoonValue* b);
 MoonValue* moon_mul(MoonValue* a, MoonValue* b);
 MoonValue* moon_div(MoonValue* a, MoonValue* b);
 MoonValue* moon_mod(MoonValue* a, MoonValue* b);
 MoonValue* moon_neg(MoonValue* val);
 
+// Into a caller-provided MoonValue (a stack temporary) when the result is a number
+MoonValue* moon_add_at(MoonValue* out, MoonValue* a, MoonValue* b);
+MoonValue* moon_sub_at(MoonValue* out, MoonValue* a, MoonValue* b);
+MoonValue* moon_mul_at(MoonValue* out, MoonValue* a, MoonValue* b);
+MoonValue* moon_div_at(MoonValue* out, MoonValue* a, MoonValue* b);
+MoonValue* moon_mod_at(MoonValue* out, MoonValue* a, MoonValue* b);
+
 // ============================================================================
 // Comparison Operations
 // ============================================================================
@@ -360,6 +410,13 @@ MoonValue* moon_cd(MoonValue* path);
 // String Encryption
 MoonValue* moon_decrypt_string(MoonValue* encrypted);
 
+// Embedded assets (bundled into the executable by moonc)
+void moon_assets_register(const uint8_t* section, uint64_t size);
+const char* moon_asset_data(const char* path, size_t* len);  // NULL if not bundled
+// Inflate a raw deflate stream into exactly outLen bytes (moonc checks cached packed bodies with it)
+bool moon_asset_inflate(const uint8_t* in, size_t inLen, uint8_t* out, size_t outLen);
+MoonValue* moon_asset_read(MoonValue* path);  // Falls back to the file on disk
+
 // JSON
 MoonValue* moon_json_encode(MoonValue* val);
 MoonValue* moon_json_decode(MoonValue* str);
@@ -415,6 +472,11 @@ MoonValue* moon_str_is_upper(MoonValue* str);
 MoonValue* moon_str_pad_left(MoonValue* str, MoonValue* width, MoonValue* fillchar);
 MoonValue* moon_str_pad_right(MoonValue* str, MoonValue* width, MoonValue* fillchar);
 MoonValue* moon_bytes_to_string(MoonValue* list);  // Byte array to string (efficient)
+MoonValue* moon_buffer_from_ptr(MoonValue* ptr, MoonValue* len, MoonValue* release);  // Wrap C memory
+MoonValue* moon_buffer_from_str(MoonValue* str);   // View a string's bytes without copying
+MoonValue* moon_buffer_slice(MoonValue* buf, MoonValue* start, MoonValue* len);  // Sub-view, no copy
+MoonValue* moon_buffer_ptr(MoonValue* buf);        // Address of the first byte
+MoonValue* moon_buffer_to_str(MoonValue* buf);     // Copy into a string
 MoonValue* moon_ws_parse_frame(MoonValue* data);   // WebSocket frame parse (efficient)
 MoonValue* moon_ws_create_frame(MoonValue* data, MoonValue* opcode, MoonValue* mask);  // WebSocket frame create
 
@@ -517,11 +579,21 @@ MoonValue* moon_remove_dir(MoonValue* path);
 // ============================================================================
 
 MoonValue* moon_tcp_connect(MoonValue* host, MoonValue* port);
-MoonValue* moon_tcp_listen(MoonValue* port);
+MoonValue* moon_tcp_listen(MoonValue* port, MoonValue* options);
+MoonValue* moon_tcp_listen_group(MoonValue* port, MoonValue* options);
 MoonValue* moon_tcp_accept(MoonValue* server);
+MoonValue* moon_tcp_accept_batch(MoonValue* server, MoonValue* max);
 MoonValue* moon_tcp_send(MoonValue* socket, MoonValue* data);
-MoonValue* moon_tcp_recv(MoonValue* socket);
+MoonValue* moon_tcp_recv(MoonValue* socket, MoonValue* max);
 void moon_tcp_close(MoonValue* socket);
+MoonValue* moon_tcp_send_file(MoonValue* socket, MoonValue* path);
+MoonValue* moon_tcp_sendv(MoonValue* socket, MoonValue* parts);
+
+// Buffered reader (tcp_reader / tls_reader)
+MoonValue* moon_tcp_reader(MoonValue* socket);
+MoonValue* moon_recv_exact(MoonValue* reader, MoonValue* count);
+MoonValue* moon_recv_until(MoonValue* reader, MoonValue* delim, MoonValue* max);
+void moon_reader_close(MoonValue* reader);
 
 // Async I/O
 MoonValue* moon_tcp_set_nonblocking(MoonValue* socket, MoonValue* nonblocking);
@@ -530,11 +602,50 @@ MoonValue* moon_tcp_select(MoonValue* sockets, MoonValue* timeout_ms, MoonValue*
 MoonValue* moon_tcp_accept_nonblocking(MoonValue* server);
 MoonValue* moon_tcp_recv_nonblocking(MoonValue* socket);
 
+// Persistent poller (epoll / kqueue; interest set survives across waits)
+MoonValue* moon_poller_new(void);
+MoonValue* moon_poller_add(MoonValue* poller, MoonValue* fd, MoonValue* events, MoonValue* data);
+MoonValue* moon_poller_mod(MoonValue* poller, MoonValue* fd, MoonValue* events, MoonValue* data);
+MoonValue* moon_poller_del(MoonValue* poller, MoonValue* fd);
+MoonValue* moon_poller_wait(MoonValue* poller, MoonValue* timeout_ms, MoonValue* max);
+void moon_poller_close(MoonValue* poller);
+
 MoonValue* moon_udp_socket(void);
 MoonValue* moon_udp_bind(MoonValue* socket, MoonValue* port);
 MoonValue* moon_udp_send(MoonValue* socket, MoonValue* host, MoonValue* port, MoonValue* data);
 MoonValue* moon_udp_recv(MoonValue* socket);
 void moon_udp_close(MoonValue* socket);
+MoonValue* moon_udp_send_batch(MoonValue* socket, MoonValue* host, MoonValue* port, MoonValue* packets, MoonValue* gso);
+MoonValue* moon_udp_recv_batch(MoonValue* socket, MoonValue* max_packets, MoonValue* gro);
+
+// DNS (cached getaddrinfo; async inside coroutines)
+MoonValue* moon_dns_resolve(MoonValue* host);
+void moon_dns_config(MoonValue* options);
+void moon_dns_clear(void);
+
+// HTTP/1.1 server (keep-alive, pipelining, handlers run as coroutines)
+MoonValue* moon_http_server(void);
+MoonValue* moon_http_route(MoonValue* server, MoonValue* method, MoonValue* path, MoonValue* handler);
+MoonValue* moon_http_serve(MoonValue* server, MoonValue* port, MoonValue* options);
+void moon_http_stop(MoonValue* server);
+MoonValue* moon_http_server_stats(MoonValue* server);
+
+// HTTP/1.1 client (keep-alive pool, chunked/gzip bodies, streaming)
+MoonValue* moon_http_get(MoonValue* url, MoonValue* options);
+MoonValue* moon_http_post(MoonValue* url, MoonValue* body, MoonValue* options);
+MoonValue* moon_http_request(MoonValue* method, MoonValue* url, MoonValue* options);
+MoonValue* moon_http_read(MoonValue* stream, MoonValue* max);
+void moon_http_close(MoonValue* stream);
+
+// WebSocket (RFC 6455, permessage-deflate, broadcast)
+MoonValue* moon_ws_connect(MoonValue* url, MoonValue* options);
+MoonValue* moon_ws_upgrade(MoonValue* socket, MoonValue* options);
+MoonValue* moon_ws_recv(MoonValue* ws, MoonValue* timeout);
+MoonValue* moon_ws_send(MoonValue* ws, MoonValue* data, MoonValue* binary);
+MoonValue* moon_ws_ping(MoonValue* ws, MoonValue* data);
+void moon_ws_close(MoonValue* ws, MoonValue* code, MoonValue* reason);
+MoonValue* moon_ws_broadcast(MoonValue* conns, MoonValue* data, MoonValue* binary);
+MoonValue* moon_ws_info(MoonValue* ws);
 
 // ============================================================================
 // DLL Functions
@@ -551,6 +662,10 @@ MoonValue* moon_alloc_str(MoonValue* str);
 void moon_free_str(MoonValue* ptr);
 MoonValue* moon_ptr_to_str(MoonValue* ptr);
 
+// Direct C calls (ffi_cdef): resolve a declared function into its call slot
+void* moon_ffi_bind(void** slot, MoonValue* lib, const char* name);
+void* moon_ffi_resolve(void** slot, const char* name);
+
 // Memory read/write (cross-platform)
 MoonValue* moon_read_ptr(MoonValue* addr);
 MoonValue* moon_read_int32(MoonValue* addr);
@@ -832,8 +947,9 @@ MoonValue* moon_tls_connect(MoonValue* host, MoonValue* port);
 MoonValue* moon_tls_listen(MoonValue* port, MoonValue* cert_path, MoonValue* key_path);
 MoonValue* moon_tls_accept(MoonValue* server);
 MoonValue* moon_tls_send(MoonValue* conn, MoonValue* data);
-MoonValue* moon_tls_recv(MoonValue* conn);
+MoonValue* moon_tls_recv(MoonValue* conn, MoonValue* max);
 MoonValue* moon_tls_recv_all(MoonValue* conn, MoonValue* max_size);
+MoonValue* moon_tls_reader(MoonValue* conn);
 void moon_tls_close(MoonValue* conn);
 
 // TLS Configuration Functions
@@ -853,6 +969,13 @@ MoonValue* moon_tls_cert_info(MoonValue* cert);
 MoonValue* moon_tls_wrap_client(MoonValue* socket);
 MoonValue* moon_tls_wrap_server(MoonValue* socket, MoonValue* cert_path, MoonValue* key_path);
 
+// Keep-Alive Connection Pool (shared client context + session resumption)
+MoonValue* moon_tls_pool_config(MoonValue* max_idle, MoonValue* idle_timeout_ms);
+MoonValue* moon_tls_pool_get(MoonValue* host, MoonValue* port);
+MoonValue* moon_tls_pool_put(MoonValue* conn);
+void moon_tls_pool_clear(void);
+MoonValue* moon_tls_pool_stats(void);
+
 // TLS Initialization/Cleanup
 void moon_tls_init(void);
 void moon_tls_cleanup(void);
@@ -0,0 +1,366 @@
+// MoonLang Runtime - Embedded Assets
+// Copyright (c) 2026 greenteng.com
+//
+// Files bundled by moonc (GUI pages, scripts, images, read_file targets)
+// live in a read-only data section of the executable: an index followed by
+// the file bodies, deflate-compressed unless compression did not pay off.
+// A body is decompressed on first access and kept for the life of the
+// process; stored bodies are served straight from the section.
+//
+// Section layout (little-endian):
+//   "MOONRES1" u32 count u32 flags
+//   count x { u32 nameOffset, u32 nameLength, u64 dataOffset,
+//             u32 packedSize, u32 size, u32 method, u32 reserved }
+//   names and bodies; entries are sorted by name
+
+#include "moonrt_core.h"
+
+#define MOON_ASSET_STORED   0
+#define MOON_ASSET_DEFLATE  1
+#define MOON_ASSET_HEADER   16
+#define MOON_ASSET_ENTRY    32
+
+static const uint8_t* g_assetSection = NULL;
+static uint32_t g_assetCount = 0;
+static char* volatile* g_assetCache = NULL;
+
+// ============================================================================
+// Inflate (RFC 1951)
+// ============================================================================
+// Self-contained so bundled resources never depend on a system zlib.
+
+typedef struct {
+    const uint8_t* in;
+    size_t inLen;
+    size_t inPos;
+    uint32_t bitBuf;
+    int bitCount;
+    uint8_t* out;
+    size_t outLen;
+    size_t outPos;
+} AssetInflate;
+
+typedef struct {
+    short count[16];
+    short symbol[288];
+} AssetHuffman;
+
+static int inflate_bits(AssetInflate* s, int need) {
+    uint32_t val = s->bitBuf;
+    while (s->bitCount < need) {
+        if (s->inPos >= s->inLen) return -1;
+        val |= (uint32_t)s->in[s->inPos++] << s->bitCount;
+        s->bitCount += 8;
+    }
+    s->bitBuf = val >> need;
+    s->bitCount -= need;
+    return (int)(val & ((1u << need) - 1));
+}
+
+static int inflate_build(AssetHuffman* h, const uint8_t* lengths, int n) {
+    short offs[16];
+    memset(h->count, 0, sizeof(h->count));
+    for (int i = 0; i < n; i++) h->count[lengths[i]]++;
+    if (h->count[0] == n) return 0;
+
+    int left = 1;
+    for (int len = 1; len < 16; len++) {
+        left <<= 1;
+        left -= h->count[len];
+        if (left < 0) return -1;    // Over-subscribed
+    }
+
+    offs[1] = 0;
+    for (int len = 1; len < 15; len++) offs[len + 1] = offs[len] + h->count[len];
+    for (int i = 0; i < n; i++) {
+        if (lengths[i]) h->symbol[offs[lengths[i]]++] = (short)i;
+    }
+    return left;
+}
+
+static int inflate_decode(AssetInflate* s, const AssetHuffman* h) {
+    int code = 0, first = 0, index = 0;
+    for (int len = 1; len < 16; len++) {
+        int bit = inflate_bits(s, 1);
+        if (bit < 0) return -1;
+        code |= bit;
+        int count = h->count[len];
+        if (code - count < first) return h->symbol[index + (code - first)];
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+static const short kLengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const short kLengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const short kDistBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577 };
+static const short kDistExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+static bool inflate_codes(AssetInflate* s, const AssetHuffman* lencode, const AssetHuffman* distcode) {
+    for (;;) {
+        int sym = inflate_decode(s, lencode);
+        if (sym < 0) return false;
+        if (sym < 256) {
+            if (s->outPos >= s->outLen) return false;
+            s->out[s->outPos++] = (uint8_t)sym;
+        } else if (sym == 256) {
+            return true;
+        } else {
+            sym -= 257;
+            if (sym >= 29) return false;
+            int extra = inflate_bits(s, kLengthExtra[sym]);
+            if (extra < 0) return false;
+            size_t len = (size_t)(kLengthBase[sym] + extra);
+
+            int dsym = inflate_decode(s, distcode);
+            if (dsym < 0 || dsym >= 30) return false;
+            extra = inflate_bits(s, kDistExtra[dsym]);
+            if (extra < 0) return false;
+            size_t dist = (size_t)(kDistBase[dsym] + extra);
+
+            if (dist > s->outPos || len > s->outLen - s->outPos) return false;
+            uint8_t* dst = s->out + s->outPos;
+            const uint8_t* src = dst - dist;
+            for (size_t i = 0; i < len; i++) dst[i] = src[i];     // May overlap
+            s->outPos += len;
+        }
+    }
+}
+
+static bool inflate_stored(AssetInflate* s) {
+    s->bitBuf = 0;
+    s->bitCount = 0;
+    if (s->inPos + 4 > s->inLen) return false;
+    unsigned len = s->in[s->inPos] | (s->in[s->inPos + 1] << 8);
+    unsigned nlen = s->in[s->inPos + 2] | (s->in[s->inPos + 3] << 8);
+    s->inPos += 4;
+    if (len != (~nlen & 0xFFFF)) return false;
+    if (s->inPos + len > s->inLen || len > s->outLen - s->outPos) return false;
+    memcpy(s->out + s->outPos, s->in + s->inPos, len);
+    s->inPos += len;
+    s->outPos += len;
+    return true;
+}
+
+static bool inflate_fixed(AssetInflate* s) {
+    static AssetHuffman lencode, distcode;
+    static bool built = false;
+    if (!built) {
+        uint8_t lengths[288];
+        int i = 0;
+        for (; i < 144; i++) lengths[i] = 8;
+        for (; i < 256; i++) lengths[i] = 9;
+        for (; i < 280; i++) lengths[i] = 7;
+        for (; i < 288; i++) lengths[i] = 8;
+        inflate_build(&lencode, lengths, 288);
+        for (i = 0; i < 30; i++) lengths[i] = 5;
+        inflate_build(&distcode, lengths, 30);
+        built = true;
+    }
+    return inflate_codes(s, &lencode, &distcode);
+}
+
+static bool inflate_dynamic(AssetInflate* s) {
+    static const uint8_t order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+    uint8_t lengths[320];
+    AssetHuffman lencode, distcode;
+
+    int nlen = inflate_bits(s, 5);
+    int ndist = inflate_bits(s, 5);
+    int ncode = inflate_bits(s, 4);
+    if (nlen < 0 || ndist < 0 || ncode < 0) return false;
+    nlen += 257;
+    ndist += 1;
+    ncode += 4;
+    if (nlen > 286 || ndist > 30) return false;
+
+    memset(lengths, 0, 19);
+    for (int i = 0; i < ncode; i++) {
+        int v = inflate_bits(s, 3);
+        if (v < 0) return false;
+        lengths[order[i]] = (uint8_t)v;
+    }
+    if (inflate_build(&lencode, lengths, 19) != 0) return false;
+
+    int index = 0;
+    while (index < nlen + ndist) {
+        int sym = inflate_decode(s, &lencode);
+        if (sym < 0) return false;
+        if (sym < 16) {
+            lengths[index++] = (uint8_t)sym;
+            continue;
+        }
+        int len = 0, repeat;
+        if (sym == 16) {
+            if (index == 0) return false;
+            len = lengths[index - 1];
+            repeat = inflate_bits(s, 2);
+            if (repeat < 0) return false;
+            repeat += 3;
+        } else if (sym == 17) {
+            repeat = inflate_bits(s, 3);
+            if (repeat < 0) return false;
+            repeat += 3;
+        } else {
+            repeat = inflate_bits(s, 7);
+            if (repeat < 0) return false;
+            repeat += 11;
+        }
+        if (index + repeat > nlen + ndist) return false;
+        while (repeat--) lengths[index++] = (uint8_t)len;
+    }
+
+    // Incomplete codes are only allowed for a single length
+    int err = inflate_build(&lencode, lengths, nlen);
+    if (err < 0 || (err > 0 && nlen - lencode.count[0] != 1)) return false;
+    err = inflate_build(&distcode, lengths + nlen, ndist);
+    if (err < 0 || (err > 0 && ndist - distcode.count[0] != 1)) return false;
+
+    return inflate_codes(s, &lencode, &distcode);
+}
+
+static bool asset_inflate(const uint8_t* in, size_t inLen, uint8_t* out, size_t outLen) {
+    AssetInflate s;
+    memset(&s, 0, sizeof(s));
+    s.in = in;
+    s.inLen = inLen;
+    s.out = out;
+    s.outLen = outLen;
+
+    int last;
+    do {
+        last = inflate_bits(&s, 1);
+        int type = inflate_bits(&s, 2);
+        if (last < 0 || type < 0) return false;
+        bool ok = type == 0 ? inflate_stored(&s)
+                : type == 1 ? inflate_fixed(&s)
+                : type == 2 ? inflate_dynamic(&s)
+                : false;
+        if (!ok) return false;
+    } while (!last);
+
+    return s.outPos == outLen;
+}
+
+bool moon_asset_inflate(const uint8_t* in, size_t inLen, uint8_t* out, size_t outLen) {
+    return in && out && asset_inflate(in, inLen, out, outLen);
+}
+
+// ============================================================================
+// Asset Index
+// ============================================================================
+
+static uint32_t asset_u32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint64_t asset_u64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Called from main() when the executable carries a bundled asset section
+void moon_assets_register(const uint8_t* section, uint64_t size) {
+    if (!section || size < MOON_ASSET_HEADER || memcmp(section, "MOONRES1", 8) != 0) return;
+    uint32_t count = asset_u32(section + 8);
+    if (MOON_ASSET_HEADER + (uint64_t)count * MOON_ASSET_ENTRY > size) return;
+
+    g_assetCache = (char* volatile*)calloc(count ? count : 1, sizeof(char*));
+    g_assetSection = section;
+    g_assetCount = count;
+}
+
+// Look up a bundled file; paths match case-insensitively with either slash
+// and an optional leading "/" or "./". Returns NULL when it is not bundled.
+const char* moon_asset_data(const char* path, size_t* len) {
+    if (!g_assetSection || !path) return NULL;
+
+    while (*path == '/' || *path == '\\') path++;
+    if (path[0] == '.' && (path[1] == '/' || path[1] == '\\')) path += 2;
+
+    char key[1024];
+    size_t keyLen = strlen(path);
+    if (keyLen >= sizeof(key)) return NULL;
+    for (size_t i = 0; i < keyLen; i++) {
+        char c = path[i];
+        key[i] = c == '\\' ? '/' : (char)tolower((unsigned char)c);
+    }
+
+    // Binary search over the sorted index
+    int lo = 0, hi = (int)g_assetCount - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        const uint8_t* entry = g_assetSection + MOON_ASSET_HEADER + (size_t)mid * MOON_ASSET_ENTRY;
+        const char* name = (const char*)g_assetSection + asset_u32(entry);
+        size_t nameLen = asset_u32(entry + 4);
+        int cmp = memcmp(key, name, keyLen < nameLen ? keyLen : nameLen);
+        if (cmp == 0) cmp = keyLen < nameLen ? -1 : (keyLen > nameLen ? 1 : 0);
+        if (cmp < 0) {
+            hi = mid - 1;
+        } else if (cmp > 0) {
+            lo = mid + 1;
+        } else {
+            const uint8_t* data = g_assetSection + asset_u64(entry + 8);
+            uint32_t packedSize = asset_u32(entry + 16);
+            uint32_t size = asset_u32(entry + 20);
+            uint32_t method = asset_u32(entry + 24);
+            if (len) *len = size;
+            if (method == MOON_ASSET_STORED) return (const char*)data;
+
+            char* cached = g_assetCache[mid];
+            if (cached) return cached;
+
+            // First use: inflate once; a racing thread's copy is dropped
+            char* body = (char*)malloc(size + 1);
+            if (!body) return NULL;
+            if (!asset_inflate(data, packedSize, (uint8_t*)body, size)) {
+                free(body);
+                return NULL;
+            }
+            body[size] = '\0';
+#ifdef MOON_PLATFORM_WINDOWS
+            cached = (char*)InterlockedCompareExchangePointer((void* volatile*)&g_assetCache[mid], body, NULL);
+#else
+            cached = NULL;
+            if (__atomic_compare_exchange_n(&g_assetCache[mid], &cached, body, false,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                cached = NULL;
+            }
+#endif
+            if (cached) {
+                free(body);
+                return cached;
+            }
+            return body;
+        }
+    }
+    return NULL;
+}
+
+// asset_read(path) - Bundled file contents, or the file on disk when the
+// path was not bundled
+MoonValue* moon_asset_read(MoonValue* path) {
+    if (!moon_is_string(path)) return moon_null();
+
+    size_t len = 0;
+    const char* data = moon_asset_data(path->data.strVal, &len);
+    if (!data) return moon_read_file(path);
+
+    char* content = moon_str_with_capacity(data, len, len + 1);
+    return moon_string_owned(content);
+}
@@ -5,8 +5,10 @@
 // Supports millions of concurrent tasks with minimal memory overhead
 
 // macOS: Must include sys/types.h BEFORE _XOPEN_SOURCE to get BSD types
+// (sys/event.h needs them too)
 #ifdef __APPLE__
 #include <sys/types.h>
+#include <sys/event.h>
 #define _XOPEN_SOURCE 600
 #endif
 
@@ -17,9 +19,9 @@
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
 #include <windows.h>
 #include <process.h>
-#include <malloc.h>  // for _aligned_malloc
 #else
 #include <pthread.h>
 #include <unistd.h>
@@ -28,6 +30,15 @@
 #include <sched.h>
 #include <time.h>
 #include <semaphore.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#elif defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__) || defined(__DragonFly__)
+#include <sys/event.h>
+#endif
 #ifdef __APPLE__
 #include <os/lock.h>  // for os_unfair_lock (macOS spinlock replacement)
 #include <sys/sysctl.h>  // for sysctlbyname to get CPU count
@@ -53,6 +64,7 @@
 #define CORO_QUEUE_SIZE     (1024 * 1024)   // 1M queue capacity
 #define CORO_LOCAL_BATCH    256             // Local queue batch size
 #define CORO_POOL_SIZE      4096            // Pool size for Coroutine struct reuse
+#define CORO_GLOBAL_TICK    61              // Check the global queue first every N picks
 
 // Coroutine configuration - designed for millions of concurrent coroutines
 // No artificial limits - let the OS handle resource management
@@ -90,9 +102,16 @@ typedef struct Coroutine {
     char* stack;
 #endif
     
+    volatile long park;         // PARK_* handshake between moon_coro_park and moon_coro_wake
     struct Coroutine* next;
 } Coroutine;
 
+// Park states. A wake that lands before the coroutine has switched out is
+// remembered (PARK_WOKEN) so the park returns at once instead of sleeping.
+#define PARK_NONE       0
+#define PARK_PARKED     1       // Off its stack; the waker requeues it
+#define PARK_WOKEN      2
+
 // ============================================================================
 // Coroutine Pool (reduces malloc/free pressure)
 // ============================================================================
@@ -299,6 +318,7 @@ static Coroutine* coro_create(MoonFunc func, MoonValue** args, int argc,
     coro->func = func;
     coro->argc = argc;
     coro->next = NULL;
+    coro->park = PARK_NONE;
     
     // Copy and retain args - use inline storage for small arg counts
     if (argc > 0) {
@@ -306,7 +326,7 @@ static Coroutine* coro_create(MoonFunc func, MoonValue** args, int argc,
             // Use inline storage for common case (up to 4 args)
             coro->args = coro->inline_args;
         } else {
-            coro->args = (MoonValue**)malloc(sizeof(MoonValue*) * argc);
+            coro->args = (MoonValue**)moon_alloc_raw(sizeof(MoonValue*) * argc);
             if (!coro->args) {
                 fprintf(stderr, "ERROR: malloc failed for coro args! argc=%d\n", argc);
                 free(coro);
@@ -324,7 +344,7 @@ static Coroutine* coro_create(MoonFunc func, MoonValue** args, int argc,
     // Copy and retain closure captures
     coro->capture_count = capture_count;
     if (capture_count > 0 && captures) {
-        coro->captures = (MoonValue**)malloc(sizeof(MoonValue*) * capture_count);
+        coro->captures = (MoonValue**)moon_alloc_raw(sizeof(MoonValue*) * capture_count);
         for (int i = 0; i < capture_count; i++) {
             coro->captures[i] = captures[i];
             if (captures[i]) moon_retain(captures[i]);
@@ -346,19 +366,20 @@ static Coroutine* coro_create(MoonFunc func, MoonValue** args, int argc,
             }
             // Only free if not using inline storage
             if (coro->args != coro->inline_args) {
-                free(coro->args);
+                moon_free(coro->args, 0);
             }
         }
         if (coro->captures) {
             for (int i = 0; i < capture_count; i++) {
                 if (coro->captures[i]) moon_release(coro->captures[i]);
             }
-            free(coro->captures);
+            moon_free(coro->captures, 0);
         }
         free(coro);
         return NULL;
     }
     coro->main_fiber = NULL;
+    moon_mem_account(MOON_MEM_CORO_STACK, CORO_STACK_SIZE);
 #else
     // macOS doesn't support MAP_STACK, only use it on Linux
 #ifdef __APPLE__
@@ -377,14 +398,14 @@ static Coroutine* coro_create(MoonFunc func, MoonValue** args, int argc,
             }
             // Only free if not using inline storage
             if (coro->args != coro->inline_args) {
-                free(coro->args);
+                moon_free(coro->args, 0);
             }
         }
         if (coro->captures) {
             for (int i = 0; i < capture_count; i++) {
                 if (coro->captures[i]) moon_release(coro->captures[i]);
             }
-            free(coro->captures);
+            moon_free(coro->captures, 0);
         }
         free(coro);
         return NULL;
@@ -396,6 +417,7 @@ static Coroutine* coro_create(MoonFunc func, MoonValue** args, int argc,
     coro->ctx.uc_link = NULL;
     coro->main_ctx = NULL;
     makecontext(&coro->ctx, context_entry, 0);
+    moon_mem_account(MOON_MEM_CORO_STACK, CORO_STACK_SIZE);
 #endif
     
     return coro;
@@ -417,6 +439,7 @@ static void coro_destroy(Coroutine* coro) {
     InterlockedIncrement(&g_coro_destroyed);
     
     if (coro->fiber) {
+        moon_mem_account(MOON_MEM_CORO_STACK, -(int64_t)CORO_STACK_SIZE);
         __try {
             DeleteFiber(coro->fiber);
         } __except(EXCEPTION_EXECUTE_HANDLER) {
@@ -426,7 +449,10 @@ static void coro_destroy(Coroutine* coro) {
     }
 #else
     __sync_add_and_fetch(&g_coro_destroyed, 1);
-    if (coro->stack) munmap(coro->stack, CORO_STACK_SIZE);
+    if (coro->stack) {
+        munmap(coro->stack, CORO_STACK_SIZE);
+        moon_mem_account(MOON_MEM_CORO_STACK, -(int64_t)CORO_STACK_SIZE);
+    }
 #endif
     
     if (coro->args) {
@@ -435,7 +461,7 @@ static void coro_destroy(Coroutine* coro) {
         }
         // Only free if not using inline storage
         if (coro->args != coro->inline_args) {
-            free(coro->args);
+            moon_free(coro->args, 0);
         }
     }
     
@@ -444,7 +470,7 @@ static void coro_destroy(Coroutine* coro) {
         for (int i = 0; i < coro->capture_count; i++) {
             if (coro->captures[i]) moon_release(coro->captures[i]);
         }
-        free(coro->captures);
+        moon_free(coro->captures, 0);
     }
     
     // Clear sensitive fields before pooling
@@ -553,6 +579,51 @@ static Coroutine* steal_work(int worker_id) {
     return queue_pop(&g_sched.global_queue);
 }
 
+// Next coroutine for a worker. Coroutines that yield go back to the local
+// queue, so once it is full the overflow in the global queue would never
+// run; looking there first every CORO_GLOBAL_TICK picks keeps it moving.
+static Coroutine* sched_next(int worker_id, unsigned* tick) {
+    Coroutine* coro = NULL;
+    if (++*tick % CORO_GLOBAL_TICK == 0) coro = queue_pop(&g_sched.global_queue);
+    if (!coro) coro = queue_pop(&g_sched.local_queues[worker_id]);
+    if (!coro) coro = steal_work(worker_id);
+    return coro;
+}
+
+static void sched_signal(void);
+
+static inline bool park_cas(volatile long* park, long expected, long desired) {
+#ifdef _WIN32
+    return InterlockedCompareExchange(park, desired, expected) == expected;
+#else
+    return __sync_bool_compare_and_swap(park, expected, desired);
+#endif
+}
+
+// Queue a coroutine that is ready to run again: on the calling worker's own
+// queue when there is one, else the global queue
+static void sched_requeue(Coroutine* coro) {
+    coro->state = CORO_READY;
+    if (tls_worker_id >= 0 && queue_push(&g_sched.local_queues[tls_worker_id], coro)) return;
+    while (!queue_push(&g_sched.global_queue, coro)) {
+        // Dropping a parked coroutine would lose it for good; wait for room
+#ifdef _WIN32
+        Sleep(1);
+#else
+        usleep(1000);
+#endif
+    }
+    sched_signal();
+}
+
+// A coroutine switched out in moon_coro_park(). Publish it as parked so the
+// waker requeues it, unless the wake already arrived.
+static void sched_parked(Coroutine* coro) {
+    if (park_cas(&coro->park, PARK_NONE, PARK_PARKED)) return;
+    coro->park = PARK_NONE;     // PARK_WOKEN: run it again
+    sched_requeue(coro);
+}
+
 #ifdef _WIN32
 static unsigned __stdcall worker_func(void* param) {
     int id = (int)(intptr_t)param;
@@ -563,9 +634,9 @@ static unsigned __stdcall worker_func(void* param) {
     if (!tls_main_fiber) return 1;
     
     __try {
+        unsigned tick = 0;
         while (g_sched.running) {
-            Coroutine* coro = queue_pop(&g_sched.local_queues[id]);
-            if (!coro) coro = steal_work(id);
+            Coroutine* coro = sched_next(id, &tick);
             
             if (coro) {
                 tls_current = coro;
@@ -584,6 +655,8 @@ static unsigned __stdcall worker_func(void* param) {
                             coro_destroy(coro);
                         }
                     }
+                } else if (coro->state == CORO_WAITING) {
+                    sched_parked(coro);
                 } else {
                     // Unexpected state (RUNNING or WAITING after resume returned)
                     // This indicates a bug - coroutine crashed or has invalid state
@@ -610,9 +683,9 @@ static void* worker_func(void* param) {
     int id = (int)(intptr_t)param;
     tls_worker_id = id;
     
+    unsigned tick = 0;
     while (g_sched.running) {
-        Coroutine* coro = queue_pop(&g_sched.local_queues[id]);
-        if (!coro) coro = steal_work(id);
+        Coroutine* coro = sched_next(id, &tick);
         
         if (coro) {
             tls_current = coro;
@@ -631,6 +704,8 @@ static void* worker_func(void* param) {
                         coro_destroy(coro);
                     }
                 }
+            } else if (coro->state == CORO_WAITING) {
+                sched_parked(coro);
             } else {
                 // Unexpected state (RUNNING or WAITING after resume returned)
                 // This indicates a bug - coroutine crashed or has invalid state
@@ -641,8 +716,21 @@ static void* worker_func(void* param) {
             }
             tls_current = NULL;
         } else {
-            struct timespec ts = {0, 1000000}; // 1ms
+#ifdef __APPLE__
+            struct timespec ts = {0, 1000000}; // 1ms (no unnamed semaphores)
             nanosleep(&ts, NULL);
+#else
+            // Up to 1ms, cut short by sched_signal() when a coroutine is
+            // spawned or woken
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += 1000000;
+            if (ts.tv_nsec >= 1000000000) {
+                ts.tv_sec++;
+                ts.tv_nsec -= 1000000000;
+            }
+            sem_timedwait(&g_sched.work_semaphore, &ts);
+#endif
         }
     }
     
@@ -671,6 +759,14 @@ static void sched_init(void) {
     if (g_sched.num_workers < 1) g_sched.num_workers = 1;
     if (g_sched.num_workers > 256) g_sched.num_workers = 256;
     
+#ifndef _WIN32
+    // A zeroed pthread_spinlock_t is "locked" on glibc x86: must init explicitly
+    if (!g_coro_pool_lock_init) {
+        pthread_spin_init(&g_coro_pool_lock, PTHREAD_PROCESS_PRIVATE);
+        g_coro_pool_lock_init = true;
+    }
+#endif
+
     queue_init(&g_sched.global_queue, CORO_QUEUE_SIZE);
     
     g_sched.local_queues = (CoroQueue*)malloc(sizeof(CoroQueue) * g_sched.num_workers);
@@ -903,6 +999,596 @@ void moon_yield(void) {
     }
 }
 
+bool moon_in_coroutine(void) {
+    return tls_current != NULL;
+}
+
+int moon_sched_workers(void) {
+    sched_init();
+    return g_sched.num_workers;
+}
+
+// ============================================================================
+// Parking
+// ============================================================================
+// A coroutine waiting on something another thread will finish (a resolver,
+// an I/O completion, a ready socket) parks instead of yielding in a loop:
+// its worker runs other work, or sleeps, until the other side wakes it.
+
+void* moon_coro_self(void) {
+    return tls_current;
+}
+
+void moon_coro_park(void) {
+    Coroutine* coro = tls_current;
+    if (!coro || coro->state != CORO_RUNNING) return;
+    // The wake beat us here: consume it and keep running
+    if (park_cas(&coro->park, PARK_WOKEN, PARK_NONE)) return;
+    coro->state = CORO_WAITING;
+#ifdef _WIN32
+    SwitchToFiber(coro->main_fiber);
+#else
+    if (coro->main_ctx) {
+        swapcontext(&coro->ctx, coro->main_ctx);
+    }
+#endif
+}
+
+void moon_coro_wake(void* handle) {
+    Coroutine* coro = (Coroutine*)handle;
+    if (!coro) return;
+    for (;;) {
+        long park = coro->park;
+        if (park == PARK_PARKED) {
+            if (park_cas(&coro->park, PARK_PARKED, PARK_NONE)) {
+                sched_requeue(coro);
+                return;
+            }
+        } else if (park == PARK_NONE) {
+            if (park_cas(&coro->park, PARK_NONE, PARK_WOKEN)) return;
+        } else {
+            return;     // Already woken
+        }
+    }
+}
+
+// ============================================================================
+// I/O Readiness (reactor)
+// ============================================================================
+// One reactor thread waits on epoll (Linux), kqueue (macOS/BSD) or poll
+// (Windows and the rest) for the sockets parked coroutines are waiting on,
+// and keeps their timeouts in a heap. Only the reactor fires a wait and
+// drops its registrations; the waiter reads the result under the same lock,
+// so a wait record on the coroutine's stack is never touched after it
+// returns.
+
+#ifdef __linux__
+#define IO_USE_EPOLL 1
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__) || defined(__DragonFly__)
+#define IO_USE_KQUEUE 1
+#else
+#define IO_USE_POLL 1
+#endif
+
+#define IO_WAIT_MAX_FDS     16
+#define IO_WAIT_PENDING     0
+#define IO_WAIT_READY       1
+#define IO_WAIT_TIMEOUT     2
+
+struct IoWait;
+
+typedef struct {
+    struct IoWait* wait;
+    int64_t fd;                 // Registered descriptor, -1 once dropped
+    bool dup;                   // fd is our dup() of the caller's (epoll)
+    int pollIndex;              // Slot in g_io.regs (poll backend)
+} IoWaitFd;
+
+typedef struct IoWait {
+    Coroutine* coro;
+    IoWaitFd fds[IO_WAIT_MAX_FDS];
+    int count;
+    bool write;
+    int fired;                  // IO_WAIT_*
+    int expireAs;               // Result when the deadline passes
+    int64_t deadline;           // ms, -1 = none
+    int heapIndex;              // Slot in the timer heap, -1 if not there
+} IoWait;
+
+static struct {
+    bool started;
+    bool failed;
+    int64_t sleepUntil;         // Deadline the reactor sleeps towards, 0 while awake
+    IoWait** heap;
+    int heapCount;
+    int heapCap;
+#ifdef _WIN32
+    SRWLOCK lock;
+    SOCKET wakeSock;            // UDP socket connected to itself
+#else
+    pthread_mutex_t lock;
+#endif
+#if defined(IO_USE_EPOLL)
+    int epfd;
+    int wakeFd;                 // eventfd
+#elif defined(IO_USE_KQUEUE)
+    int kq;
+    int wakePipe[2];
+#else
+    IoWaitFd** regs;
+    int regCount;
+    int regCap;
+#ifndef _WIN32
+    int wakePipe[2];
+#endif
+#endif
+} g_io;
+
+#ifdef _WIN32
+static INIT_ONCE g_io_once = INIT_ONCE_STATIC_INIT;
+static void io_lock(void) { AcquireSRWLockExclusive(&g_io.lock); }
+static void io_unlock(void) { ReleaseSRWLockExclusive(&g_io.lock); }
+#else
+static pthread_once_t g_io_once = PTHREAD_ONCE_INIT;
+static void io_lock(void) { pthread_mutex_lock(&g_io.lock); }
+static void io_unlock(void) { pthread_mutex_unlock(&g_io.lock); }
+#endif
+
+static int64_t io_now_ms(void) {
+#ifdef _WIN32
+    return (int64_t)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
+
+// Timer heap ordered by deadline
+
+static void io_heap_swap(int a, int b) {
+    IoWait* t = g_io.heap[a];
+    g_io.heap[a] = g_io.heap[b];
+    g_io.heap[b] = t;
+    g_io.heap[a]->heapIndex = a;
+    g_io.heap[b]->heapIndex = b;
+}
+
+static void io_heap_up(int i) {
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (g_io.heap[parent]->deadline <= g_io.heap[i]->deadline) break;
+        io_heap_swap(i, parent);
+        i = parent;
+    }
+}
+
+static void io_heap_down(int i) {
+    for (;;) {
+        int l = 2 * i + 1, r = l + 1, m = i;
+        if (l < g_io.heapCount && g_io.heap[l]->deadline < g_io.heap[m]->deadline) m = l;
+        if (r < g_io.heapCount && g_io.heap[r]->deadline < g_io.heap[m]->deadline) m = r;
+        if (m == i) break;
+        io_heap_swap(i, m);
+        i = m;
+    }
+}
+
+static bool io_heap_push(IoWait* w) {
+    if (g_io.heapCount == g_io.heapCap) {
+        int cap = g_io.heapCap ? g_io.heapCap * 2 : 64;
+        IoWait** heap = (IoWait**)realloc(g_io.heap, sizeof(IoWait*) * cap);
+        if (!heap) return false;
+        g_io.heap = heap;
+        g_io.heapCap = cap;
+    }
+    w->heapIndex = g_io.heapCount;
+    g_io.heap[g_io.heapCount++] = w;
+    io_heap_up(w->heapIndex);
+    return true;
+}
+
+static void io_heap_remove(IoWait* w) {
+    int i = w->heapIndex;
+    if (i < 0) return;
+    w->heapIndex = -1;
+    if (--g_io.heapCount == i) return;
+    g_io.heap[i] = g_io.heap[g_io.heapCount];
+    g_io.heap[i]->heapIndex = i;
+    io_heap_down(i);
+    io_heap_up(i);
+}
+
+// Interrupt the reactor's wait so it picks up a new registration or an
+// earlier deadline
+static void io_interrupt(void) {
+#if defined(IO_USE_EPOLL)
+    uint64_t one = 1;
+    ssize_t n = write(g_io.wakeFd, &one, sizeof(one));
+    (void)n;
+#elif defined(_WIN32)
+    char b = 0;
+    send(g_io.wakeSock, &b, 1, 0);
+#else
+    char b = 0;
+    ssize_t n = write(g_io.wakePipe[1], &b, 1);
+    (void)n;
+#endif
+}
+
+static void io_drain_wakeups(void) {
+#if defined(IO_USE_EPOLL)
+    uint64_t n;
+    ssize_t r = read(g_io.wakeFd, &n, sizeof(n));
+    (void)r;
+#elif defined(_WIN32)
+    char buf[64];
+    while (recv(g_io.wakeSock, buf, sizeof(buf), 0) > 0) {}
+#else
+    char buf[64];
+    while (read(g_io.wakePipe[0], buf, sizeof(buf)) > 0) {}
+#endif
+}
+
+// Register one descriptor. Returns false if it cannot be watched (e.g. a
+// regular file under epoll), in which case the caller treats it as ready.
+static bool io_register(IoWaitFd* f, bool write) {
+#if defined(IO_USE_EPOLL)
+    struct epoll_event ev;
+    ev.events = (write ? EPOLLOUT : EPOLLIN) | EPOLLONESHOT;
+    ev.data.ptr = f;
+    if (epoll_ctl(g_io.epfd, EPOLL_CTL_ADD, (int)f->fd, &ev) == 0) return true;
+    if (errno != EEXIST) return false;
+    // Another coroutine waits on the same descriptor: epoll keys on the
+    // descriptor number, so watch a duplicate
+    int d = dup((int)f->fd);
+    if (d < 0) return false;
+    if (epoll_ctl(g_io.epfd, EPOLL_CTL_ADD, d, &ev) != 0) {
+        close(d);
+        return false;
+    }
+    f->fd = d;
+    f->dup = true;
+    return true;
+#elif defined(IO_USE_KQUEUE)
+    struct kevent ev;
+    EV_SET(&ev, (uintptr_t)f->fd, write ? EVFILT_WRITE : EVFILT_READ, EV_ADD | EV_ONESHOT, 0, 0, f);
+    return kevent(g_io.kq, &ev, 1, NULL, 0, NULL) == 0;
+#else
+    if (g_io.regCount == g_io.regCap) {
+        int cap = g_io.regCap ? g_io.regCap * 2 : 64;
+        IoWaitFd** regs = (IoWaitFd**)realloc(g_io.regs, sizeof(IoWaitFd*) * cap);
+        if (!regs) return false;
+        g_io.regs = regs;
+        g_io.regCap = cap;
+    }
+    f->pollIndex = g_io.regCount;
+    g_io.regs[g_io.regCount++] = f;
+    (void)write;
+    return true;
+#endif
+}
+
+static void io_unregister(IoWaitFd* f) {
+    if (f->fd < 0) return;
+#if defined(IO_USE_EPOLL)
+    epoll_ctl(g_io.epfd, EPOLL_CTL_DEL, (int)f->fd, NULL);
+    if (f->dup) close((int)f->fd);
+#elif defined(IO_USE_KQUEUE)
+    struct kevent ev;
+    EV_SET(&ev, (uintptr_t)f->fd, f->wait->write ? EVFILT_WRITE : EVFILT_READ, EV_DELETE, 0, 0, NULL);
+    kevent(g_io.kq, &ev, 1, NULL, 0, NULL);     // ENOENT once the oneshot fired
+#else
+    int i = f->pollIndex;
+    g_io.regs[i] = g_io.regs[--g_io.regCount];
+    g_io.regs[i]->pollIndex = i;
+#endif
+    f->fd = -1;
+}
+
+// Finish a wait: drop everything that refers to it, then wake its
+// coroutine. Reactor thread only, lock held.
+static void io_fire(IoWait* w, int result) {
+    if (w->fired != IO_WAIT_PENDING) return;
+    w->fired = result;
+    for (int i = 0; i < w->count; i++) io_unregister(&w->fds[i]);
+    io_heap_remove(w);
+    moon_coro_wake(w->coro);
+}
+
+// Fire expired waits and return the poll timeout until the next deadline.
+// Lock held.
+static int io_expire(void) {
+    int64_t now = io_now_ms();
+    while (g_io.heapCount > 0 && g_io.heap[0]->deadline <= now) {
+        IoWait* w = g_io.heap[0];
+        io_fire(w, w->expireAs);
+    }
+    if (g_io.heapCount == 0) {
+        g_io.sleepUntil = INT64_MAX;
+        return -1;
+    }
+    g_io.sleepUntil = g_io.heap[0]->deadline;
+    int64_t wait = g_io.heap[0]->deadline - now;
+    return wait > INT32_MAX ? INT32_MAX : (int)wait;
+}
+
+#define IO_BATCH 64
+
+#ifdef _WIN32
+static unsigned __stdcall io_reactor(void* param) {
+#else
+static void* io_reactor(void* param) {
+#endif
+    (void)param;
+#if defined(IO_USE_EPOLL)
+    struct epoll_event events[IO_BATCH];
+    for (;;) {
+        io_lock();
+        int timeout = io_expire();
+        io_unlock();
+        int n = epoll_wait(g_io.epfd, events, IO_BATCH, timeout);
+        io_lock();
+        g_io.sleepUntil = 0;
+        for (int i = 0; i < n; i++) {
+            IoWaitFd* f = (IoWaitFd*)events[i].data.ptr;
+            if (!f) io_drain_wakeups();
+            else io_fire(f->wait, IO_WAIT_READY);
+        }
+        io_unlock();
+    }
+#elif defined(IO_USE_KQUEUE)
+    struct kevent events[IO_BATCH];
+    for (;;) {
+        io_lock();
+        int timeout = io_expire();
+        io_unlock();
+        struct timespec ts;
+        ts.tv_sec = timeout / 1000;
+        ts.tv_nsec = (long)(timeout % 1000) * 1000000;
+        int n = kevent(g_io.kq, NULL, 0, events, IO_BATCH, timeout < 0 ? NULL : &ts);
+        io_lock();
+        g_io.sleepUntil = 0;
+        for (int i = 0; i < n; i++) {
+            IoWaitFd* f = (IoWaitFd*)events[i].udata;
+            if (!f) io_drain_wakeups();
+            else if (f->fd >= 0) {
+                f->fd = -1;     // The oneshot is gone already
+                io_fire(f->wait, IO_WAIT_READY);
+            }
+        }
+        io_unlock();
+    }
+#else
+    // Rebuilt every round from the registrations; slot 0 is the wakeup
+#ifdef _WIN32
+    WSAPOLLFD* pfds = NULL;
+#else
+    struct pollfd* pfds = NULL;
+#endif
+    IoWaitFd** owners = NULL;
+    int cap = 0;
+    for (;;) {
+        io_lock();
+        int timeout = io_expire();
+        int n = g_io.regCount + 1;
+        if (n > cap) {
+            cap = n * 2;
+            pfds = (decltype(pfds))realloc(pfds, sizeof(*pfds) * cap);
+            owners = (IoWaitFd**)realloc(owners, sizeof(IoWaitFd*) * cap);
+        }
+#ifdef _WIN32
+        pfds[0].fd = g_io.wakeSock;
+#else
+        pfds[0].fd = g_io.wakePipe[0];
+#endif
+        pfds[0].events = POLLIN;
+        owners[0] = NULL;
+        for (int i = 1; i < n; i++) {
+            IoWaitFd* f = g_io.regs[i - 1];
+#ifdef _WIN32
+            pfds[i].fd = (SOCKET)f->fd;
+#else
+            pfds[i].fd = (int)f->fd;
+#endif
+            pfds[i].events = f->wait->write ? POLLOUT : POLLIN;
+            owners[i] = f;
+        }
+        for (int i = 0; i < n; i++) pfds[i].revents = 0;
+        io_unlock();
+#ifdef _WIN32
+        int ready = WSAPoll(pfds, (ULONG)n, timeout);
+#else
+        int ready = poll(pfds, (nfds_t)n, timeout);
+#endif
+        io_lock();
+        g_io.sleepUntil = 0;
+        if (ready > 0) {
+            if (pfds[0].revents) io_drain_wakeups();
+            // Only this thread drops registrations, so owners are still valid
+            for (int i = 1; i < n; i++) {
+                if (pfds[i].revents) io_fire(owners[i]->wait, IO_WAIT_READY);
+            }
+        }
+        io_unlock();
+    }
+#endif
+#ifdef _WIN32
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+static bool io_open(void) {
+#if defined(IO_USE_EPOLL)
+    g_io.epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (g_io.epfd < 0) return false;
+    g_io.wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (g_io.wakeFd < 0) return false;
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    return epoll_ctl(g_io.epfd, EPOLL_CTL_ADD, g_io.wakeFd, &ev) == 0;
+#elif defined(_WIN32)
+    // WSAPoll has no way to wake it but a socket: a UDP socket connected to
+    // itself on loopback
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+    g_io.wakeSock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (g_io.wakeSock == INVALID_SOCKET) return false;
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int len = sizeof(addr);
+    u_long nonBlocking = 1;
+    return bind(g_io.wakeSock, (struct sockaddr*)&addr, sizeof(addr)) == 0 &&
+           getsockname(g_io.wakeSock, (struct sockaddr*)&addr, &len) == 0 &&
+           connect(g_io.wakeSock, (struct sockaddr*)&addr, len) == 0 &&
+           ioctlsocket(g_io.wakeSock, FIONBIO, &nonBlocking) == 0;
+#else
+    if (pipe(g_io.wakePipe) != 0) return false;
+    for (int i = 0; i < 2; i++) {
+        fcntl(g_io.wakePipe[i], F_SETFL, fcntl(g_io.wakePipe[i], F_GETFL) | O_NONBLOCK);
+        fcntl(g_io.wakePipe[i], F_SETFD, FD_CLOEXEC);
+    }
+#if defined(IO_USE_KQUEUE)
+    g_io.kq = kqueue();
+    if (g_io.kq < 0) return false;
+    struct kevent ev;
+    EV_SET(&ev, (uintptr_t)g_io.wakePipe[0], EVFILT_READ, EV_ADD, 0, 0, NULL);
+    return kevent(g_io.kq, &ev, 1, NULL, 0, NULL) == 0;
+#else
+    return true;
+#endif
+#endif
+}
+
+#ifdef _WIN32
+static BOOL CALLBACK io_start_once(PINIT_ONCE once, PVOID param, PVOID* ctx) {
+    (void)once; (void)param; (void)ctx;
+    InitializeSRWLock(&g_io.lock);
+#else
+static void io_start_once(void) {
+    pthread_mutex_init(&g_io.lock, NULL);
+#endif
+    g_io.sleepUntil = INT64_MAX;
+    if (!io_open()) {
+        g_io.failed = true;
+    } else {
+#ifdef _WIN32
+        unsigned tid;
+        HANDLE h = (HANDLE)_beginthreadex(NULL, 64 * 1024, io_reactor, NULL, 0, &tid);
+        if (h) CloseHandle(h);
+        else g_io.failed = true;
+#else
+        pthread_t tid;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        pthread_attr_setstacksize(&attr, 64 * 1024);
+        if (pthread_create(&tid, &attr, io_reactor, NULL) != 0) g_io.failed = true;
+        pthread_attr_destroy(&attr);
+#endif
+    }
+    g_io.started = true;
+#ifdef _WIN32
+    return TRUE;
+#endif
+}
+
+static bool io_start(void) {
+#ifdef _WIN32
+    InitOnceExecuteOnce(&g_io_once, io_start_once, NULL, NULL);
+#else
+    pthread_once(&g_io_once, io_start_once);
+#endif
+    return !g_io.failed;
+}
+
+// Blocking poll for threads that are not coroutines (and the fallback if the
+// reactor cannot start)
+static int io_poll_fds(const int64_t* fds, int count, bool write, int timeout_ms) {
+#ifdef _WIN32
+    WSAPOLLFD pfds[IO_WAIT_MAX_FDS];
+#else
+    struct pollfd pfds[IO_WAIT_MAX_FDS];
+#endif
+    if (count > IO_WAIT_MAX_FDS) count = IO_WAIT_MAX_FDS;
+    for (int i = 0; i < count; i++) {
+#ifdef _WIN32
+        pfds[i].fd = (SOCKET)fds[i];
+#else
+        pfds[i].fd = (int)fds[i];
+#endif
+        pfds[i].events = write ? POLLOUT : POLLIN;
+        pfds[i].revents = 0;
+    }
+    for (;;) {
+#ifdef _WIN32
+        int n = WSAPoll(pfds, (ULONG)count, timeout_ms);
+#else
+        int n = poll(pfds, (nfds_t)count, timeout_ms);
+        if (n < 0 && errno == EINTR) continue;
+#endif
+        return n != 0 ? 1 : 0;  // Errors count as ready: the next syscall reports them
+    }
+}
+
+int moon_io_wait_fds(const int64_t* fds, int count, bool write, int timeout_ms) {
+    if (count <= 0) return 0;
+    if (!tls_current || tls_current->state != CORO_RUNNING || count > IO_WAIT_MAX_FDS || !io_start()) {
+        return io_poll_fds(fds, count, write, timeout_ms);
+    }
+
+    IoWait w;
+    w.coro = tls_current;
+    w.count = count;
+    w.write = write;
+    w.fired = IO_WAIT_PENDING;
+    w.expireAs = IO_WAIT_TIMEOUT;
+    w.deadline = timeout_ms >= 0 ? io_now_ms() + timeout_ms : -1;
+    w.heapIndex = -1;
+
+    io_lock();
+    bool interrupt = false;
+    for (int i = 0; i < count; i++) {
+        w.fds[i].wait = &w;
+        w.fds[i].fd = fds[i];
+        w.fds[i].dup = false;
+        w.fds[i].pollIndex = -1;
+        if (!io_register(&w.fds[i], write)) {
+            // Unwatchable: report it ready. The reactor fires the wait so
+            // that nothing it may already hold goes stale.
+            w.fds[i].fd = -1;
+            w.expireAs = IO_WAIT_READY;
+            w.deadline = 0;
+        }
+    }
+#ifdef IO_USE_POLL
+    interrupt = true;   // The poll set is rebuilt by the reactor
+#endif
+    if (w.deadline >= 0) {
+        if (!io_heap_push(&w)) w.deadline = -1;
+        else if (w.deadline < g_io.sleepUntil) interrupt = true;
+    }
+    if (interrupt && g_io.sleepUntil != 0) io_interrupt();
+    io_unlock();
+
+    for (;;) {
+        io_lock();
+        int fired = w.fired;
+        io_unlock();
+        if (fired != IO_WAIT_PENDING) return fired == IO_WAIT_READY ? 1 : 0;
+        moon_coro_park();
+    }
+}
+
+int moon_io_wait(int64_t fd, bool write, int timeout_ms) {
+    return moon_io_wait_fds(&fd, 1, write, timeout_ms);
+}
+
 // num_goroutines() - get active coroutine count
 MoonValue* moon_num_goroutines(void) {
     return moon_int(g_sched.active_count);
@@ -910,8 +1596,7 @@ MoonValue* moon_num_goroutines(void) {
 
 // num_cpu() - get worker thread count
 MoonValue* moon_num_cpu(void) {
-    sched_init();
-    return moon_int(g_sched.num_workers);
+    return moon_int(moon_sched_workers());
 }
 
 // wait_all() - wait for all coroutines to finish
@@ -929,13 +1614,10 @@ void moon_wait_all(void) {
 // Atomic Operations (for thread-safe counters)
 // ============================================================================
 
-// Check if MoonValue is in small integer cache (DO NOT modify these!)
-static bool is_small_int_cache(MoonValue* v) {
-    extern MoonValue g_small_ints[];
-    extern volatile bool g_small_ints_initialized;
-    if (!g_small_ints_initialized) return false;
-    // Check if pointer is within the small int cache array
-    return (v >= &g_small_ints[0] && v < &g_small_ints[MOON_SMALL_INT_COUNT]);
+// Check if MoonValue is shared and immortal: the small integer cache or a
+// literal constant (DO NOT modify these!)
+static bool is_immortal_int(MoonValue* v) {
+    return v->refcount == INT32_MAX;
 }
 
 // atomic_counter(initial) - Create a NEW MoonValue for atomic operations
@@ -944,12 +1626,9 @@ static bool is_small_int_cache(MoonValue* v) {
 MoonValue* moon_atomic_counter(MoonValue* initial) {
     int64_t val = initial ? moon_to_int(initial) : 0;
     
-    // Allocate with 16-byte alignment for atomic operations
-#ifdef _WIN32
-    MoonValue* v = (MoonValue*)_aligned_malloc(sizeof(MoonValue), 16);
-#else
-    MoonValue* v = (MoonValue*)aligned_alloc(16, sizeof(MoonValue));
-#endif
+    // Allocate from the value pool so moon_free_value can release it normally
+    // (heap blocks are at least 8-byte aligned, enough for 64-bit atomics)
+    MoonValue* v = moon_pool_alloc();
     if (!v) {
         return moon_int(val);  // Fallback
     }
@@ -976,9 +1655,9 @@ MoonValue* moon_atomic_add(MoonValue* ptr, MoonValue* delta) {
         return moon_int(0);
     }
     
-    // Safety check: warn if trying to modify small int cache
-    if (is_small_int_cache(ptr)) {
-        fprintf(stderr, "WARNING: atomic_add on small integer cache! Use atomic_counter() instead.\n");
+    // Safety check: warn if trying to modify a shared integer
+    if (is_immortal_int(ptr)) {
+        fprintf(stderr, "WARNING: atomic_add on a shared integer constant! Use atomic_counter() instead.\n");
         return moon_int(ptr->data.intVal);
     }
     
@@ -1020,6 +1699,10 @@ MoonValue* moon_atomic_set(MoonValue* ptr, MoonValue* value) {
     if (!ptr || ptr->type != MOON_INT) {
         return moon_int(0);
     }
+    if (is_immortal_int(ptr)) {
+        fprintf(stderr, "WARNING: atomic_set on a shared integer constant! Use atomic_counter() instead.\n");
+        return moon_int(ptr->data.intVal);
+    }
     int64_t newVal = moon_to_int(value);
 #ifdef _WIN32
     int64_t oldVal = InterlockedExchange64((volatile LONG64*)&ptr->data.intVal, newVal);
@@ -1037,6 +1720,10 @@ MoonValue* moon_atomic_cas(MoonValue* ptr, MoonValue* expected, MoonValue* desir
     if (!ptr || ptr->type != MOON_INT) {
         return moon_bool(false);
     }
+    if (is_immortal_int(ptr)) {
+        fprintf(stderr, "WARNING: atomic_cas on a shared integer constant! Use atomic_counter() instead.\n");
+        return moon_bool(false);
+    }
     int64_t exp = moon_to_int(expected);
     int64_t des = moon_to_int(desired);
 #ifdef _WIN32
@@ -27,9 +27,9 @@ static MoonBigInt* bigint_alloc(int32_t capacity) {
 static void bigint_free(MoonBigInt* bi) {
     if (bi) {
         if (bi->digits) {
-            free(bi->digits);
+            moon_free(bi->digits, sizeof(uint32_t) * bi->capacity);
         }
-        free(bi);
+        moon_free(bi, sizeof(MoonBigInt));
     }
 }
 
@@ -39,7 +39,7 @@ static void bigint_ensure_capacity(MoonBigInt* bi, int32_t needed) {
         uint32_t* new_digits = (uint32_t*)moon_alloc(sizeof(uint32_t) * new_cap);
         memcpy(new_digits, bi->digits, sizeof(uint32_t) * bi->length);
         memset(new_digits + bi->length, 0, sizeof(uint32_t) * (new_cap - bi->length));
-        free(bi->digits);
+        moon_free(bi->digits, sizeof(uint32_t) * bi->capacity);
         bi->digits = new_digits;
         bi->capacity = new_cap;
     }
@@ -149,9 +149,6 @@ bool moon_is_bigint(MoonValue* val) {
 
 MoonValue* moon_bigint_from_int(int64_t val) {
     MoonValue* result = moon_pool_alloc();
-    if (!result) {
-        result = (MoonValue*)moon_alloc(sizeof(MoonValue));
-    }
     result->type = MOON_BIGINT;
     result->refcount = 1;
     result->data.bigintVal = bigint_from_int64(val);
@@ -215,9 +212,6 @@ MoonValue* moon_bigint_from_string(const char* str) {
     bigint_normalize(bi);
     
     MoonValue* result = moon_pool_alloc();
-    if (!result) {
-        result = (MoonValue*)moon_alloc(sizeof(MoonValue));
-    }
     result->type = MOON_BIGINT;
     result->refcount = 1;
     result->data.bigintVal = bi;
@@ -304,9 +298,6 @@ MoonValue* moon_bigint_add(MoonValue* a, MoonValue* b) {
     if (free_b) bigint_free(bi_b);
     
     MoonValue* val = moon_pool_alloc();
-    if (!val) {
-        val = (MoonValue*)moon_alloc(sizeof(MoonValue));
-    }
     val->type = MOON_BIGINT;
     val->refcount = 1;
     val->data.bigintVal = result;
@@ -357,9 +348,6 @@ MoonValue* moon_bigint_sub(MoonValue* a, MoonValue* b) {
     if (free_b) bigint_free(bi_b);
     
     MoonValue* val = moon_pool_alloc();
-    if (!val) {
-        val = (MoonValue*)moon_alloc(sizeof(MoonValue));
-    }
     val->type = MOON_BIGINT;
     val->refcount = 1;
     val->data.bigintVal = result;
@@ -418,9 +406,6 @@ MoonValue* moon_bigint_mul(MoonValue* a, MoonValue* b) {
     if (free_b) bigint_free(bi_b);
     
     MoonValue* val = moon_pool_alloc();
-    if (!val) {
-        val = (MoonValue*)moon_alloc(sizeof(MoonValue));
-    }
     val->type = MOON_BIGINT;
     val->refcount = 1;
     val->data.bigintVal = result;
@@ -14,7 +14,7 @@ void moon_print(MoonValue** args, int argc) {
         if (i > 0) printf(" ");
         char* str = moon_to_string(args[i]);
         printf("%s", str);
-        free(str);
+        moon_free(str, 0);
     }
     printf("\n");
     fflush(stdout);
@@ -55,6 +55,7 @@ MoonValue* moon_type(MoonValue* val) {
         case MOON_FUNC: return moon_string("function");
         case MOON_OBJECT: return moon_string("object");
         case MOON_CLASS: return moon_string("class");
+        case MOON_BUFFER: return moon_string("buffer");
         default: return moon_string("unknown");
     }
 }
@@ -74,6 +75,7 @@ MoonValue* moon_len(MoonValue* val) {
         }
         case MOON_LIST: return moon_int(val->data.listVal->length);
         case MOON_DICT: return moon_int(val->data.dictVal->length);
+        case MOON_BUFFER: return moon_int((int64_t)val->data.bufferVal->length);
         default: return moon_int(0);
     }
 }
@@ -101,12 +103,12 @@ MoonValue* moon_format(MoonValue** args, int argc) {
                 size_t usedLen = dest - result;
                 if (usedLen + argLen + 1 >= bufSize) {
                     bufSize = (usedLen + argLen + 256) * 2;
-                    result = (char*)realloc(result, bufSize);
+                    result = (char*)moon_realloc(result, bufSize);
                     dest = result + usedLen;
                 }
                 memcpy(dest, argStr, argLen);
                 dest += argLen;
-                free(argStr);
+                moon_free(argStr, 0);
             }
             fmt += 2;
         } else {
@@ -171,7 +173,7 @@ MoonValue* moon_shell_output(MoonValue* cmd) {
         size_t len = strlen(buffer);
         if (totalSize + len >= bufferSize) {
             bufferSize *= 2;
-            result = (char*)realloc(result, bufferSize);
+            result = (char*)moon_realloc(result, bufferSize);
         }
         memcpy(result + totalSize, buffer, len + 1);
         totalSize += len;
@@ -200,7 +202,7 @@ void moon_set_env(MoonValue* name, MoonValue* value) {
 #else
     setenv(name->data.strVal, valStr, 1);
 #endif
-    free(valStr);
+    moon_free(valStr, 0);
 }
 
 void moon_exit(MoonValue* code) {
@@ -285,20 +287,94 @@ MoonValue* moon_exec(MoonValue* cmd) {
 // Memory Management Functions
 // ============================================================================
 
+// Sets key to val and drops our references to both, so a result polled in a
+// loop does not leak its fields
+static void mem_stats_put(MoonValue* dict, const char* key, MoonValue* val) {
+    MoonValue* k = moon_string(key);
+    moon_dict_set(dict, k, val);
+    moon_release(k);
+    moon_release(val);
+}
+
 MoonValue* moon_mem_stats(void) {
     size_t used = 0, peak = 0, total = 0;
     moon_heap_stats(&used, &peak, &total);
+#ifdef MOON_HAS_MEM_STATS
+    // Snapshot before building the result, which allocates
+    MoonMemKindStats kinds[MOON_MEM_KIND_COUNT];
+    moon_mem_kind_stats(kinds);
+#endif
     
     MoonValue* result = moon_dict_new();
-    moon_dict_set(result, moon_string("used"), moon_int((int64_t)used));
-    moon_dict_set(result, moon_string("peak"), moon_int((int64_t)peak));
-    moon_dict_set(result, moon_string("total"), moon_int((int64_t)total));
-    moon_dict_set(result, moon_string("free"), moon_int((int64_t)(total - used)));
+    mem_stats_put(result, "used", moon_int((int64_t)used));
+    mem_stats_put(result, "peak", moon_int((int64_t)peak));
+    mem_stats_put(result, "total", moon_int((int64_t)total));
+    mem_stats_put(result, "free", moon_int((int64_t)(total > used ? total - used : 0)));
     
 #ifdef MOON_USE_STATIC_HEAP
-    moon_dict_set(result, moon_string("type"), moon_string("static"));
+    mem_stats_put(result, "type", moon_string("static"));
+    
+    MoonHeapInfo info;
+    moon_heap_info(&info);
+    mem_stats_put(result, "free", moon_int((int64_t)info.free));
+    mem_stats_put(result, "largest_free", moon_int((int64_t)info.largestFree));
+    mem_stats_put(result, "fragmentation", moon_int(info.fragmentation));
+    mem_stats_put(result, "used_blocks", moon_int((int64_t)info.usedBlocks));
+    mem_stats_put(result, "free_blocks", moon_int((int64_t)info.freeBlocks));
+    mem_stats_put(result, "allocs", moon_int((int64_t)info.allocCount));
+    mem_stats_put(result, "frees", moon_int((int64_t)info.freeCount));
+    
+    // Live blocks per power-of-two size class, keyed by the class's lower bound
+    MoonValue* histogram = moon_dict_new();
+    for (int i = 0; i < MOON_HEAP_HIST_BUCKETS; i++) {
+        if (!info.histogram[i]) continue;
+        char key[24];
+        snprintf(key, sizeof(key), "%zu", (size_t)16 << i);
+        mem_stats_put(histogram, key, moon_int((int64_t)info.histogram[i]));
+    }
+    mem_stats_put(result, "histogram", histogram);
 #else
-    moon_dict_set(result, moon_string("type"), moon_string("dynamic"));
+    mem_stats_put(result, "type", moon_string("dynamic"));
+    
+    MoonHeapInfo info;
+    moon_heap_info(&info);
+    mem_stats_put(result, "used_blocks", moon_int((int64_t)info.usedBlocks));
+    mem_stats_put(result, "allocs", moon_int((int64_t)info.allocCount));
+    mem_stats_put(result, "frees", moon_int((int64_t)info.freeCount));
+#endif
+    
+#ifdef MOON_HAS_MEM_STATS
+    // Live/peak bytes per allocation kind, e.g. types.string.live
+    MoonValue* types = moon_dict_new();
+    for (int i = 0; i < MOON_MEM_KIND_COUNT; i++) {
+        MoonValue* kind = moon_dict_new();
+        mem_stats_put(kind, "live", moon_int(kinds[i].live));
+        mem_stats_put(kind, "count", moon_int(kinds[i].count));
+        mem_stats_put(kind, "peak", moon_int(kinds[i].peak));
+        mem_stats_put(kind, "allocs", moon_int(kinds[i].allocs));
+        mem_stats_put(types, moon_mem_kind_name((MoonMemKind)i), kind);
+    }
+    mem_stats_put(result, "types", types);
+#endif
+    
+#ifdef MOON_HAS_MEM_PROFILE
+    // Heaviest sampled allocation sites when MOON_MEM_SAMPLE is set
+    int64_t interval = moon_mem_sample_interval();
+    mem_stats_put(result, "sample_interval", moon_int(interval));
+    if (interval > 0) {
+        MoonMemSiteStats sites[16];
+        int count = moon_mem_sites(sites, 16);
+        MoonValue* siteList = moon_list_new();
+        for (int i = 0; i < count; i++) {
+            MoonValue* site = moon_dict_new();
+            mem_stats_put(site, "site", moon_string(sites[i].site));
+            mem_stats_put(site, "samples", moon_int(sites[i].samples));
+            mem_stats_put(site, "bytes", moon_int(sites[i].bytes));
+            moon_release(moon_list_append(siteList, site));
+            moon_release(site);
+        }
+        mem_stats_put(result, "sites", siteList);
+    }
 #endif
     
     return result;
@@ -5,6 +5,16 @@
 
 #include "moonrt_core.h"
 
+#ifndef MOON_USE_STATIC_HEAP
+#if defined(MOON_PLATFORM_MACOS)
+#include <malloc/malloc.h>
+#elif defined(MOON_PLATFORM_FREEBSD)
+#include <malloc_np.h>
+#else
+#include <malloc.h>
+#endif
+#endif
+
 // C++ containers for high-performance GC
 #include <unordered_set>
 #include <unordered_map>
@@ -127,126 +137,854 @@ static inline void intern_unlock() {
 // ============================================================================
 // Static Memory Allocator (for MCU targets without malloc)
 // ============================================================================
+//
+// TLSF (two-level segregated fit) over g_static_heap. Free blocks are kept in
+// size-class lists: the first level is the power of two of the block size,
+// the second level splits it into HEAP_SL_COUNT linear steps. One bitmap per
+// level marks the non-empty lists, so finding a fit and freeing are both O(1).
+// Blocks are split on allocation and merged with free neighbours on free.
+// Every block records its own size, so moon_free() ignores the size argument.
+
+struct HeapBlock {
+    struct HeapBlock* prevPhys;   // Block just below this one in the heap
+    size_t size;                  // Whole block incl. header, | HEAP_BLOCK_* flags
+    // Payload starts here; the links below only exist while the block is free
+    struct HeapBlock* nextFree;
+    struct HeapBlock* prevFree;
+};
+
+#define HEAP_BLOCK_FREE     ((size_t)1)
+#define HEAP_BLOCK_CACHED   ((size_t)2)   // Parked in the MoonValue cache
+#define HEAP_BLOCK_FLAGS    ((size_t)7)
+
+#define HEAP_ALIGN_LOG2     3
+#define HEAP_ALIGN          (1 << HEAP_ALIGN_LOG2)
+#define HEAP_SL_LOG2        4
+#define HEAP_SL_COUNT       (1 << HEAP_SL_LOG2)
+#define HEAP_FL_SHIFT       (HEAP_SL_LOG2 + HEAP_ALIGN_LOG2)
+#define HEAP_SMALL_BLOCK    (1 << HEAP_FL_SHIFT)   // Below this, fl = 0 and sl is linear
+
+#define HEAP_HEADER         offsetof(struct HeapBlock, nextFree)
+#define HEAP_MIN_BLOCK      sizeof(struct HeapBlock)
+
+static constexpr int heap_log2(size_t n) {
+    return n < 2 ? 0 : 1 + heap_log2(n / 2);
+}
+#define HEAP_FL_COUNT       (heap_log2(MOON_HEAP_SIZE) - HEAP_FL_SHIFT + 2)
+
+static_assert(HEAP_FL_COUNT <= 32, "MOON_HEAP_SIZE too large for the TLSF first-level bitmap");
+static_assert(HEAP_MIN_BLOCK % HEAP_ALIGN == 0, "heap block header must keep 8-byte alignment");
 
 static uint8_t g_static_heap[MOON_HEAP_SIZE] __attribute__((aligned(8)));
-static size_t g_heap_offset = 0;
+static bool g_heap_ready = false;
 
-struct FreeNode {
-    struct FreeNode* next;
-    size_t size;
-};
-static struct FreeNode* g_free_list = NULL;
+static uint32_t g_heap_fl_bitmap = 0;
+static uint32_t g_heap_sl_bitmap[HEAP_FL_COUNT];
+static struct HeapBlock* g_heap_free[HEAP_FL_COUNT][HEAP_SL_COUNT];
 
+static size_t g_heap_used = 0;    // Bytes in allocated blocks, headers included
 static size_t g_heap_peak = 0;
 static size_t g_alloc_count = 0;
 static size_t g_free_count = 0;
 
+// Freed MoonValue-sized blocks are parked here instead of being merged, so the
+// most common allocation skips the size-class search and split entirely.
+// MOON_HEAP_VALUE_CACHE is the number of blocks kept (0 disables the cache).
+#if MOON_HEAP_VALUE_CACHE > 0
+static struct HeapBlock* g_value_cache = NULL;
+static int g_value_cache_count = 0;
+#endif
+
 static inline size_t align_up(size_t size, size_t alignment) {
     return (size + alignment - 1) & ~(alignment - 1);
 }
 
-void* moon_alloc(size_t size) {
-    size = align_up(size, 8);
-    
-    struct FreeNode** prev = &g_free_list;
-    struct FreeNode* node = g_free_list;
-    while (node) {
-        if (node->size >= size) {
-            *prev = node->next;
-            memset(node, 0, size);
-            g_alloc_count++;
-            return node;
+static inline size_t heap_block_size(const struct HeapBlock* block) {
+    return block->size & ~HEAP_BLOCK_FLAGS;
+}
+
+static inline struct HeapBlock* heap_block_next(struct HeapBlock* block) {
+    return (struct HeapBlock*)((uint8_t*)block + heap_block_size(block));
+}
+
+static inline void* heap_block_payload(struct HeapBlock* block) {
+    return (uint8_t*)block + HEAP_HEADER;
+}
+
+static inline struct HeapBlock* heap_payload_block(void* ptr) {
+    return (struct HeapBlock*)((uint8_t*)ptr - HEAP_HEADER);
+}
+
+static inline int heap_fls(size_t size) {
+    return (int)(sizeof(unsigned long) * 8 - 1) - __builtin_clzl((unsigned long)size);
+}
+
+// Block size needed to hand out a payload of `size` bytes
+static inline size_t heap_request_size(size_t size) {
+    size = align_up(size + HEAP_HEADER, HEAP_ALIGN);
+    return size < HEAP_MIN_BLOCK ? HEAP_MIN_BLOCK : size;
+}
+
+static inline void heap_mapping(size_t size, int* fl, int* sl) {
+    if (size < HEAP_SMALL_BLOCK) {
+        *fl = 0;
+        *sl = (int)(size >> HEAP_ALIGN_LOG2);
+    } else {
+        int f = heap_fls(size);
+        *sl = (int)(size >> (f - HEAP_SL_LOG2)) ^ HEAP_SL_COUNT;
+        *fl = f - HEAP_FL_SHIFT + 1;
+    }
+}
+
+static void heap_insert(struct HeapBlock* block) {
+    int fl, sl;
+    heap_mapping(heap_block_size(block), &fl, &sl);
+    struct HeapBlock* head = g_heap_free[fl][sl];
+    block->nextFree = head;
+    block->prevFree = NULL;
+    if (head) head->prevFree = block;
+    g_heap_free[fl][sl] = block;
+    g_heap_fl_bitmap |= 1u << fl;
+    g_heap_sl_bitmap[fl] |= 1u << sl;
+}
+
+static void heap_remove(struct HeapBlock* block) {
+    int fl, sl;
+    heap_mapping(heap_block_size(block), &fl, &sl);
+    if (block->prevFree) {
+        block->prevFree->nextFree = block->nextFree;
+    } else {
+        g_heap_free[fl][sl] = block->nextFree;
+        if (!block->nextFree) {
+            g_heap_sl_bitmap[fl] &= ~(1u << sl);
+            if (!g_heap_sl_bitmap[fl]) g_heap_fl_bitmap &= ~(1u << fl);
         }
-        prev = &node->next;
-        node = node->next;
     }
+    if (block->nextFree) block->nextFree->prevFree = block->prevFree;
+}
+
+// Smallest free block that certainly fits `size`: round up to the next class
+// boundary first so any block in the class found is large enough
+static struct HeapBlock* heap_find(size_t size) {
+    if (size >= HEAP_SMALL_BLOCK) {
+        size += ((size_t)1 << (heap_fls(size) - HEAP_SL_LOG2)) - 1;
+    }
+    int fl, sl;
+    heap_mapping(size, &fl, &sl);
+    if (fl >= HEAP_FL_COUNT) return NULL;
+    
+    uint32_t slMap = g_heap_sl_bitmap[fl] & (~0u << sl);
+    if (!slMap) {
+        uint32_t flMap = fl + 1 < 32 ? g_heap_fl_bitmap & (~0u << (fl + 1)) : 0;
+        if (!flMap) return NULL;
+        fl = __builtin_ctz(flMap);
+        slMap = g_heap_sl_bitmap[fl];
+    }
+    sl = __builtin_ctz(slMap);
+    return g_heap_free[fl][sl];
+}
+
+// Lay out one free block over the whole heap, ended by a zero-size used
+// sentinel so walks and neighbour checks stop at the end
+static void heap_init(void) {
+    memset(g_heap_free, 0, sizeof(g_heap_free));
+    memset(g_heap_sl_bitmap, 0, sizeof(g_heap_sl_bitmap));
+    g_heap_fl_bitmap = 0;
+    
+    size_t span = (MOON_HEAP_SIZE & ~(size_t)(HEAP_ALIGN - 1)) - HEAP_HEADER;
+    struct HeapBlock* block = (struct HeapBlock*)g_static_heap;
+    block->prevPhys = NULL;
+    block->size = span | HEAP_BLOCK_FREE;
+    struct HeapBlock* sentinel = heap_block_next(block);
+    sentinel->prevPhys = block;
+    sentinel->size = 0;
+    heap_insert(block);
+    
+#if MOON_HEAP_VALUE_CACHE > 0
+    g_value_cache = NULL;
+    g_value_cache_count = 0;
+#endif
+    g_heap_ready = true;
+}
+
+// Give the tail of `block` beyond `size` back to the free lists
+static void heap_trim(struct HeapBlock* block, size_t size) {
+    size_t total = heap_block_size(block);
+    if (total - size < HEAP_MIN_BLOCK) return;
     
-    if (g_heap_offset + size > MOON_HEAP_SIZE) {
-#ifdef MOON_MCU_PANIC
-        MOON_MCU_PANIC("Out of memory");
-#else
-        fprintf(stderr, "Runtime Error: Static heap exhausted (%zu/%d bytes used)\n", 
-                g_heap_offset, MOON_HEAP_SIZE);
-        exit(1);
+    struct HeapBlock* rest = (struct HeapBlock*)((uint8_t*)block + size);
+    rest->prevPhys = block;
+    rest->size = (total - size) | HEAP_BLOCK_FREE;
+    block->size = size | (block->size & HEAP_BLOCK_FLAGS);
+    
+    struct HeapBlock* next = heap_block_next(rest);
+    if (next->size & HEAP_BLOCK_FREE) {
+        heap_remove(next);
+        rest->size += heap_block_size(next);
+        next = heap_block_next(rest);
+    }
+    next->prevPhys = rest;
+    heap_insert(rest);
+}
+
+static void heap_release(struct HeapBlock* block) {
+    block->size |= HEAP_BLOCK_FREE;
+    block->size &= ~HEAP_BLOCK_CACHED;
+    
+    struct HeapBlock* prev = block->prevPhys;
+    if (prev && (prev->size & HEAP_BLOCK_FREE)) {
+        heap_remove(prev);
+        prev->size += heap_block_size(block);
+        block = prev;
+    }
+    struct HeapBlock* next = heap_block_next(block);
+    if (next->size & HEAP_BLOCK_FREE) {
+        heap_remove(next);
+        block->size += heap_block_size(next);
+        next = heap_block_next(block);
+    }
+    next->prevPhys = block;
+    heap_insert(block);
+}
+
+#if MOON_HEAP_VALUE_CACHE > 0
+static void heap_flush_value_cache(void) {
+    while (g_value_cache) {
+        struct HeapBlock* block = g_value_cache;
+        g_value_cache = block->nextFree;
+        heap_release(block);
+    }
+    g_value_cache_count = 0;
+}
+#endif
+
+// heap_find() skips blocks in the request's own class that might be too
+// small; scan that one list before giving up so a block that fits exactly
+// is not missed when memory is tight
+static struct HeapBlock* heap_find_in_class(size_t size) {
+    int fl, sl;
+    heap_mapping(size, &fl, &sl);
+    if (fl >= HEAP_FL_COUNT) return NULL;
+    for (struct HeapBlock* block = g_heap_free[fl][sl]; block; block = block->nextFree) {
+        if (heap_block_size(block) >= size) return block;
+    }
+    return NULL;
+}
+
+static struct HeapBlock* heap_take(size_t need) {
+#if MOON_HEAP_VALUE_CACHE > 0
+    if (g_value_cache && need == heap_request_size(sizeof(MoonValue))) {
+        struct HeapBlock* block = g_value_cache;
+        g_value_cache = block->nextFree;
+        g_value_cache_count--;
+        block->size &= ~HEAP_BLOCK_CACHED;
+        return block;
+    }
 #endif
+    struct HeapBlock* block = heap_find(need);
+#if MOON_HEAP_VALUE_CACHE > 0
+    if (!block && g_value_cache) {
+        heap_flush_value_cache();
+        block = heap_find(need);
     }
+#endif
+    if (!block) block = heap_find_in_class(need);
+    if (!block) return NULL;
     
-    void* ptr = &g_static_heap[g_heap_offset];
-    g_heap_offset += size;
+    heap_remove(block);
+    block->size &= ~HEAP_BLOCK_FREE;
+    heap_trim(block, need);
+    return block;
+}
+
+static void heap_exhausted(size_t size) {
+#ifdef MOON_MCU_PANIC
+    (void)size;
+    MOON_MCU_PANIC("Out of memory");
+#else
+    MoonHeapInfo info;
+    moon_heap_info(&info);
+    fprintf(stderr, "Runtime Error: Static heap exhausted (%zu bytes requested, %zu/%d bytes used, "
+            "largest free block %zu)\n", size, info.used, MOON_HEAP_SIZE, info.largestFree);
+    exit(1);
+#endif
+}
+
+static inline bool heap_owns(void* ptr) {
+    return (uint8_t*)ptr >= g_static_heap && (uint8_t*)ptr < g_static_heap + MOON_HEAP_SIZE;
+}
+
+static void* mem_backend_alloc(size_t size, bool zero, size_t* bytes) {
+    if (!g_heap_ready) heap_init();
     
-    if (g_heap_offset > g_heap_peak) {
-        g_heap_peak = g_heap_offset;
+    struct HeapBlock* block = size <= MOON_HEAP_SIZE ? heap_take(heap_request_size(size)) : NULL;
+    if (!block) {
+        heap_exhausted(size);
+        return NULL;
     }
     
-    memset(ptr, 0, size);
+    *bytes = heap_block_size(block);
+    g_heap_used += *bytes;
+    if (g_heap_used > g_heap_peak) {
+        g_heap_peak = g_heap_used;
+    }
     g_alloc_count++;
+    
+    void* ptr = heap_block_payload(block);
+    if (zero) memset(ptr, 0, size);
     return ptr;
 }
 
-void moon_free(void* ptr, size_t size) {
-    if (!ptr) return;
+// Returns the bytes given back, 0 for memory from outside the heap (C
+// libraries, literals), which is not ours to free
+static size_t mem_backend_free(void* ptr) {
+    if (!heap_owns(ptr)) return 0;
     
-    size = align_up(size, 8);
-    if (size >= sizeof(struct FreeNode)) {
-        struct FreeNode* node = (struct FreeNode*)ptr;
-        node->size = size;
-        node->next = g_free_list;
-        g_free_list = node;
-    }
+    struct HeapBlock* block = heap_payload_block(ptr);
+    size_t bytes = heap_block_size(block);
+    g_heap_used -= bytes;
     g_free_count++;
+    
+#if MOON_HEAP_VALUE_CACHE > 0
+    if (g_value_cache_count < MOON_HEAP_VALUE_CACHE &&
+        bytes == heap_request_size(sizeof(MoonValue))) {
+        block->size |= HEAP_BLOCK_CACHED;
+        block->nextFree = g_value_cache;
+        g_value_cache = block;
+        g_value_cache_count++;
+        return bytes;
+    }
+#endif
+    heap_release(block);
+    return bytes;
+}
+
+static void* mem_backend_realloc(void* ptr, size_t size, size_t* oldBytes, size_t* newBytes) {
+    if (!heap_owns(ptr)) return NULL;  // Size unknown, cannot move it
+    
+    struct HeapBlock* block = heap_payload_block(ptr);
+    size_t have = heap_block_size(block);
+    size_t need = size <= MOON_HEAP_SIZE ? heap_request_size(size) : MOON_HEAP_SIZE + 1;
+    *oldBytes = have;
+    
+    // Grow into a free neighbour above when it is big enough
+    struct HeapBlock* next = heap_block_next(block);
+    if (need > have && (next->size & HEAP_BLOCK_FREE) && have + heap_block_size(next) >= need) {
+        heap_remove(next);
+        block->size += heap_block_size(next);
+        heap_block_next(block)->prevPhys = block;
+    }
+    
+    if (heap_block_size(block) >= need) {
+        heap_trim(block, need);
+        *newBytes = heap_block_size(block);
+        g_heap_used += *newBytes;
+        g_heap_used -= have;
+        if (g_heap_used > g_heap_peak) {
+            g_heap_peak = g_heap_used;
+        }
+        return ptr;
+    }
+    
+    void* grown = mem_backend_alloc(size, false, newBytes);
+    memcpy(grown, ptr, have - HEAP_HEADER);
+    mem_backend_free(ptr);
+    return grown;
 }
 
 void moon_heap_reset(void) {
-    g_heap_offset = 0;
-    g_free_list = NULL;
+    g_heap_used = 0;
     g_heap_peak = 0;
     g_alloc_count = 0;
     g_free_count = 0;
     memset(g_static_heap, 0, MOON_HEAP_SIZE);
+    heap_init();
 }
 
 void moon_heap_stats(size_t* used, size_t* peak, size_t* total) {
-    if (used) *used = g_heap_offset;
+    if (used) *used = g_heap_used;
     if (peak) *peak = g_heap_peak;
     if (total) *total = MOON_HEAP_SIZE;
 }
 
+// Walks every block, so it costs O(blocks); meant for mem_stats(), not hot paths
+void moon_heap_info(MoonHeapInfo* info) {
+    if (!g_heap_ready) heap_init();
+    memset(info, 0, sizeof(*info));
+    info->used = g_heap_used;
+    info->peak = g_heap_peak;
+    info->total = MOON_HEAP_SIZE;
+    info->allocCount = g_alloc_count;
+    info->freeCount = g_free_count;
+    
+    for (struct HeapBlock* block = (struct HeapBlock*)g_static_heap; block->size;
+         block = heap_block_next(block)) {
+        size_t size = heap_block_size(block);
+        if (block->size & (HEAP_BLOCK_FREE | HEAP_BLOCK_CACHED)) {
+            info->free += size;
+            info->freeBlocks++;
+            if (size > info->largestFree) info->largestFree = size;
+        } else {
+            int bucket = heap_fls(size) - 4;
+            if (bucket >= MOON_HEAP_HIST_BUCKETS) bucket = MOON_HEAP_HIST_BUCKETS - 1;
+            info->usedBlocks++;
+            info->histogram[bucket]++;
+        }
+    }
+    // Share of free memory that the largest block cannot serve, in percent
+    info->fragmentation = info->free ? (int)(100 - info->largestFree * 100 / info->free) : 0;
+}
+
 #else // !MOON_USE_STATIC_HEAP
 
 // ============================================================================
 // Dynamic Memory Allocator (default for desktop/server)
 // ============================================================================
 
-void* moon_alloc(size_t size) {
-    void* ptr = calloc(1, size);
-    if (!ptr) {
-        fprintf(stderr, "Runtime Error: Out of memory\n");
-        exit(1);
-    }
+// What malloc actually reserved for ptr; lets moon_free() account a block
+// without being told its size
+static inline size_t mem_usable_size(void* ptr) {
+#ifndef MOON_HAS_MEM_STATS
+    (void)ptr;
+    return 0;
+#elif defined(MOON_PLATFORM_WINDOWS)
+    return _msize(ptr);
+#elif defined(MOON_PLATFORM_MACOS)
+    return malloc_size(ptr);
+#else
+    return malloc_usable_size(ptr);
+#endif
+}
+
+static void mem_out_of_memory(size_t size) {
+    fprintf(stderr, "Runtime Error: Out of memory (%zu bytes requested)\n", size);
+    exit(1);
+}
+
+static void* mem_backend_alloc(size_t size, bool zero, size_t* bytes) {
+    void* ptr = zero ? calloc(1, size) : malloc(size);
+    if (!ptr) mem_out_of_memory(size);
+    *bytes = mem_usable_size(ptr);
     return ptr;
 }
 
-void moon_free(void* ptr, size_t size) {
-    (void)size;
+static size_t mem_backend_free(void* ptr) {
+    size_t bytes = mem_usable_size(ptr);
     free(ptr);
+    return bytes;
+}
+
+static void* mem_backend_realloc(void* ptr, size_t size, size_t* oldBytes, size_t* newBytes) {
+    *oldBytes = mem_usable_size(ptr);
+    void* grown = realloc(ptr, size);
+    if (!grown && size) mem_out_of_memory(size);
+    *newBytes = mem_usable_size(grown);
+    return grown;
 }
 
 void moon_heap_reset(void) {
     // No-op for dynamic allocation
 }
 
+#endif // MOON_USE_STATIC_HEAP
+
+// ============================================================================
+// Allocation Accounting
+// ============================================================================
+// Every runtime allocation goes through the functions below, which keep live,
+// peak and total counters per MoonMemKind on top of the heap backend. Sizes
+// come from the backend (TLSF block size or malloc's usable size), so frees
+// need no size from the caller. MOON_NO_MEM_STATS compiles the counters out.
+
+#ifdef MOON_HAS_MEM_STATS
+
+typedef struct {
+    volatile int64_t live;      // Bytes
+    volatile int64_t count;     // Blocks
+    volatile int64_t peak;
+    volatile int64_t allocs;    // Allocations ever made
+} MemCounter;
+
+static MemCounter g_mem_kinds[MOON_MEM_KIND_COUNT];
+static MemCounter g_mem_total;
+
+static const char* const g_mem_kind_names[MOON_MEM_KIND_COUNT] = {
+    "other", "value", "string", "list", "dict", "object", "closure", "coroutine_stack"
+};
+
+static inline int64_t mem_counter_add(volatile int64_t* counter, int64_t delta) {
+#if defined(MOON_USE_STATIC_HEAP)
+    return *counter += delta;   // The static heap is single-threaded
+#elif defined(MOON_PLATFORM_WINDOWS)
+    return InterlockedExchangeAdd64((volatile LONG64*)counter, delta) + delta;
+#else
+    return __atomic_add_fetch(counter, delta, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline void mem_counter_update(MemCounter* counter, int64_t bytes, int64_t blocks) {
+    int64_t live = mem_counter_add(&counter->live, bytes);
+    if (blocks) mem_counter_add(&counter->count, blocks);
+    if (blocks > 0) mem_counter_add(&counter->allocs, blocks);
+    // Racy max: a lost update under-reports the peak by one allocation
+    if (bytes > 0 && live > counter->peak) counter->peak = live;
+}
+
+static inline void mem_account(MoonMemKind kind, int64_t bytes, int64_t blocks) {
+    mem_counter_update(&g_mem_kinds[kind], bytes, blocks);
+    mem_counter_update(&g_mem_total, bytes, blocks);
+}
+
+#else
+#define mem_account(kind, bytes, blocks) ((void)0)
+#endif // MOON_HAS_MEM_STATS
+
+#ifdef MOON_HAS_MEM_PROFILE
+static void mem_sample(size_t size);
+static int64_t g_mem_sample_interval = 0;       // Bytes between samples, 0 = off
+static thread_local int64_t t_mem_sample_countdown = 0;
+
+// Sampling roughly every g_mem_sample_interval bytes per thread keeps the
+// cost to one subtraction on unsampled allocations
+#define mem_maybe_sample(size) \
+    do { \
+        if (g_mem_sample_interval && (t_mem_sample_countdown -= (int64_t)(size)) <= 0) \
+            mem_sample(size); \
+    } while (0)
+#else
+#define mem_maybe_sample(size) ((void)0)
+#endif
+
+void* moon_alloc(size_t size) {
+    size_t bytes = 0;
+    void* ptr = mem_backend_alloc(size, true, &bytes);
+    mem_account(MOON_MEM_OTHER, (int64_t)bytes, 1);
+    mem_maybe_sample(size);
+    return ptr;
+}
+
+void* moon_alloc_raw(size_t size) {
+    size_t bytes = 0;
+    void* ptr = mem_backend_alloc(size, false, &bytes);
+    mem_account(MOON_MEM_OTHER, (int64_t)bytes, 1);
+    mem_maybe_sample(size);
+    return ptr;
+}
+
+void* moon_alloc_typed(MoonMemKind kind, size_t size) {
+    size_t bytes = 0;
+    void* ptr = mem_backend_alloc(size, false, &bytes);
+    mem_account(kind, (int64_t)bytes, 1);
+    mem_maybe_sample(size);
+    return ptr;
+}
+
+void moon_free_typed(MoonMemKind kind, void* ptr) {
+    if (!ptr) return;
+    size_t bytes = mem_backend_free(ptr);
+    if (bytes) mem_account(kind, -(int64_t)bytes, -1);
+}
+
+void moon_free(void* ptr, size_t size) {
+    (void)size;
+    moon_free_typed(MOON_MEM_OTHER, ptr);
+}
+
+void* moon_realloc_typed(MoonMemKind kind, void* ptr, size_t size) {
+    if (!ptr) return moon_alloc_typed(kind, size);
+    size_t oldBytes = 0, newBytes = 0;
+    void* grown = mem_backend_realloc(ptr, size, &oldBytes, &newBytes);
+    if (grown) mem_account(kind, (int64_t)newBytes - (int64_t)oldBytes, 0);
+    return grown;
+}
+
+void* moon_realloc(void* ptr, size_t size) {
+    return moon_realloc_typed(MOON_MEM_OTHER, ptr, size);
+}
+
+void moon_mem_account(MoonMemKind kind, int64_t bytes) {
+#ifdef MOON_HAS_MEM_STATS
+    mem_counter_update(&g_mem_kinds[kind], bytes, bytes > 0 ? 1 : -1);
+#else
+    (void)kind; (void)bytes;
+#endif
+}
+
+void moon_mem_retag(void* ptr, MoonMemKind from, MoonMemKind to) {
+#if defined(MOON_HAS_MEM_STATS) && !defined(MOON_USE_STATIC_HEAP)
+    if (!ptr || from == to) return;
+    int64_t bytes = (int64_t)mem_usable_size(ptr);
+    mem_counter_update(&g_mem_kinds[from], -bytes, -1);
+    mem_counter_update(&g_mem_kinds[to], bytes, 1);
+    mem_counter_add(&g_mem_kinds[to].allocs, -1);
+#elif defined(MOON_HAS_MEM_STATS)
+    if (!ptr || from == to || !heap_owns(ptr)) return;
+    int64_t bytes = (int64_t)heap_block_size(heap_payload_block(ptr));
+    mem_counter_update(&g_mem_kinds[from], -bytes, -1);
+    mem_counter_update(&g_mem_kinds[to], bytes, 1);
+    mem_counter_add(&g_mem_kinds[to].allocs, -1);
+#else
+    (void)ptr; (void)from; (void)to;
+#endif
+}
+
+const char* moon_mem_kind_name(MoonMemKind kind) {
+#ifdef MOON_HAS_MEM_STATS
+    return kind >= 0 && kind < MOON_MEM_KIND_COUNT ? g_mem_kind_names[kind] : "unknown";
+#else
+    (void)kind;
+    return "unknown";
+#endif
+}
+
+void moon_mem_kind_stats(MoonMemKindStats stats[MOON_MEM_KIND_COUNT]) {
+    memset(stats, 0, sizeof(MoonMemKindStats) * MOON_MEM_KIND_COUNT);
+#ifdef MOON_HAS_MEM_STATS
+    for (int i = 0; i < MOON_MEM_KIND_COUNT; i++) {
+        stats[i].live = g_mem_kinds[i].live;
+        stats[i].count = g_mem_kinds[i].count;
+        stats[i].peak = g_mem_kinds[i].peak;
+        stats[i].allocs = g_mem_kinds[i].allocs;
+    }
+#endif
+}
+
+#ifndef MOON_USE_STATIC_HEAP
+
 void moon_heap_stats(size_t* used, size_t* peak, size_t* total) {
+#ifdef MOON_HAS_MEM_STATS
+    if (used) *used = g_mem_total.live > 0 ? (size_t)g_mem_total.live : 0;
+    if (peak) *peak = (size_t)g_mem_total.peak;
+#else
     if (used) *used = 0;
     if (peak) *peak = 0;
-    if (total) *total = 0;
+#endif
+    if (total) *total = 0;  // Bounded only by the system
 }
 
-#endif // MOON_USE_STATIC_HEAP
+void moon_heap_info(MoonHeapInfo* info) {
+    memset(info, 0, sizeof(*info));
+    moon_heap_stats(&info->used, &info->peak, &info->total);
+#ifdef MOON_HAS_MEM_STATS
+    info->usedBlocks = (size_t)g_mem_total.count;
+    info->allocCount = (size_t)g_mem_total.allocs;
+    info->freeCount = (size_t)(g_mem_total.allocs - g_mem_total.count);
+#endif
+}
+
+#endif // !MOON_USE_STATIC_HEAP
+
+// ============================================================================
+// Allocation Site Sampling and Periodic Dumps
+// ============================================================================
+// MOON_MEM_SAMPLE=<bytes> records the call stack of about one allocation per
+// that many bytes allocated; MOON_MEM_DUMP=<seconds> prints the counters and
+// the heaviest sampled sites to stderr at that interval and at exit.
+
+#ifdef MOON_HAS_MEM_PROFILE
+
+#ifdef MOON_PLATFORM_WINDOWS
+static SRWLOCK g_mem_site_lock = SRWLOCK_INIT;
+#define mem_site_lock() AcquireSRWLockExclusive(&g_mem_site_lock)
+#define mem_site_unlock() ReleaseSRWLockExclusive(&g_mem_site_lock)
+#else
+#include <execinfo.h>
+static pthread_mutex_t g_mem_site_lock = PTHREAD_MUTEX_INITIALIZER;
+#define mem_site_lock() pthread_mutex_lock(&g_mem_site_lock)
+#define mem_site_unlock() pthread_mutex_unlock(&g_mem_site_lock)
+#endif
+
+#define MEM_SITE_FRAMES 4       // Callers kept per site, innermost first
+#define MEM_SITE_SKIP 2         // mem_sample() and the moon_alloc* entry point
+#define MEM_SITE_SLOTS 1024
+
+typedef struct {
+    void* frames[MEM_SITE_FRAMES];
+    int64_t samples;
+    int64_t bytes;              // Sum of the sampled requests
+} MemSite;
+
+static MemSite g_mem_sites[MEM_SITE_SLOTS];
+static int64_t g_mem_sites_dropped = 0;    // Samples that found the table full
+static int g_mem_dump_interval = 0;        // Seconds, 0 = no periodic dump
+
+static MOON_NOINLINE void mem_sample(size_t size) {
+    t_mem_sample_countdown = g_mem_sample_interval;
+    
+    void* stack[MEM_SITE_FRAMES + MEM_SITE_SKIP];
+#ifdef MOON_PLATFORM_WINDOWS
+    int depth = (int)CaptureStackBackTrace(0, MEM_SITE_FRAMES + MEM_SITE_SKIP, stack, NULL);
+#else
+    int depth = backtrace(stack, MEM_SITE_FRAMES + MEM_SITE_SKIP);
+#endif
+    void* frames[MEM_SITE_FRAMES] = {0};
+    uint32_t hash = 2166136261u;
+    for (int i = MEM_SITE_SKIP; i < depth; i++) {
+        frames[i - MEM_SITE_SKIP] = stack[i];
+        hash = (hash ^ (uint32_t)((uintptr_t)stack[i] >> 4)) * 16777619u;
+    }
+    
+    mem_site_lock();
+    uint32_t idx = hash & (MEM_SITE_SLOTS - 1);
+    for (int probe = 0; probe < MEM_SITE_SLOTS; probe++) {
+        MemSite* site = &g_mem_sites[idx];
+        if (!site->samples) {
+            memcpy(site->frames, frames, sizeof(frames));
+        } else if (memcmp(site->frames, frames, sizeof(frames)) != 0) {
+            idx = (idx + 1) & (MEM_SITE_SLOTS - 1);
+            continue;
+        }
+        site->samples++;
+        site->bytes += (int64_t)size;
+        mem_site_unlock();
+        return;
+    }
+    g_mem_sites_dropped++;
+    mem_site_unlock();
+}
+
+// "symbol+0x1f" where the loader knows the symbol, else the raw address
+static int mem_format_frame(char* out, size_t cap, void* addr) {
+#ifndef MOON_PLATFORM_WINDOWS
+    Dl_info info;
+    if (dladdr(addr, &info) && info.dli_sname) {
+        return snprintf(out, cap, "%s+0x%zx", info.dli_sname,
+                        (size_t)((char*)addr - (char*)info.dli_saddr));
+    }
+#endif
+    return snprintf(out, cap, "%p", addr);
+}
+
+static int mem_site_compare(const void* a, const void* b) {
+    int64_t x = ((const MoonMemSiteStats*)a)->bytes;
+    int64_t y = ((const MoonMemSiteStats*)b)->bytes;
+    return x < y ? 1 : x > y ? -1 : 0;
+}
+
+int moon_mem_sites(MoonMemSiteStats* out, int max) {
+    if (!g_mem_sample_interval || max <= 0) return 0;
+    
+    // Copy under the lock, sort and symbolize outside it
+    std::vector<MemSite> sites;
+    mem_site_lock();
+    for (int i = 0; i < MEM_SITE_SLOTS; i++) {
+        if (g_mem_sites[i].samples) sites.push_back(g_mem_sites[i]);
+    }
+    mem_site_unlock();
+    
+    std::vector<MoonMemSiteStats> stats(sites.size());
+    for (size_t i = 0; i < sites.size(); i++) {
+        stats[i].samples = sites[i].samples;
+        stats[i].bytes = sites[i].bytes;
+        stats[i].site[0] = '\0';
+        size_t len = 0;
+        for (int f = 0; f < MEM_SITE_FRAMES && sites[i].frames[f]; f++) {
+            if (f > 0 && len + 3 < sizeof(stats[i].site)) {
+                memcpy(stats[i].site + len, " < ", 4);
+                len += 3;
+            }
+            if (len >= sizeof(stats[i].site) - 1) break;
+            int n = mem_format_frame(stats[i].site + len, sizeof(stats[i].site) - len, sites[i].frames[f]);
+            if (n < 0) break;
+            len += (size_t)n < sizeof(stats[i].site) - len ? (size_t)n : sizeof(stats[i].site) - len - 1;
+        }
+    }
+    if (!stats.empty()) {
+        qsort(stats.data(), stats.size(), sizeof(MoonMemSiteStats), mem_site_compare);
+    }
+    
+    int count = (int)stats.size() < max ? (int)stats.size() : max;
+    memcpy(out, stats.data(), sizeof(MoonMemSiteStats) * count);
+    return count;
+}
+
+int64_t moon_mem_sample_interval(void) {
+    return g_mem_sample_interval;
+}
+
+static void mem_dump(void) {
+    MoonMemKindStats kinds[MOON_MEM_KIND_COUNT];
+    moon_mem_kind_stats(kinds);
+    
+    fprintf(stderr, "[mem] live %lld bytes in %lld blocks, peak %lld\n",
+            (long long)g_mem_total.live, (long long)g_mem_total.count, (long long)g_mem_total.peak);
+    for (int i = 0; i < MOON_MEM_KIND_COUNT; i++) {
+        if (!kinds[i].allocs) continue;
+        fprintf(stderr, "[mem]   %-16s live %12lld  blocks %9lld  peak %12lld  allocs %lld\n",
+                g_mem_kind_names[i], (long long)kinds[i].live, (long long)kinds[i].count,
+                (long long)kinds[i].peak, (long long)kinds[i].allocs);
+    }
+    
+    MoonMemSiteStats sites[10];
+    int count = moon_mem_sites(sites, 10);
+    for (int i = 0; i < count; i++) {
+        fprintf(stderr, "[mem]   site %2d  %10lld bytes  %6lld samples  %s\n", i + 1,
+                (long long)sites[i].bytes, (long long)sites[i].samples, sites[i].site);
+    }
+    fflush(stderr);
+}
+
+#ifdef MOON_PLATFORM_WINDOWS
+static DWORD WINAPI mem_dump_thread(LPVOID arg) {
+    (void)arg;
+    for (;;) {
+        Sleep((DWORD)g_mem_dump_interval * 1000);
+        mem_dump();
+    }
+    return 0;
+}
+#else
+static void* mem_dump_thread(void* arg) {
+    (void)arg;
+    for (;;) {
+        sleep((unsigned)g_mem_dump_interval);
+        mem_dump();
+    }
+    return NULL;
+}
+#endif
+
+void moon_mem_profile_init(void) {
+    const char* sample = getenv("MOON_MEM_SAMPLE");
+    if (sample && atoll(sample) > 0) {
+        g_mem_sample_interval = atoll(sample);
+    }
+    
+    const char* dump = getenv("MOON_MEM_DUMP");
+    if (!dump || atoi(dump) <= 0) return;
+    g_mem_dump_interval = atoi(dump);
+    atexit(mem_dump);
+#ifdef MOON_PLATFORM_WINDOWS
+    HANDLE thread = CreateThread(NULL, 0, mem_dump_thread, NULL, 0, NULL);
+    if (thread) CloseHandle(thread);
+#else
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, mem_dump_thread, NULL) == 0) {
+        pthread_detach(thread);
+    }
+#endif
+}
+
+#else
+
+int moon_mem_sites(MoonMemSiteStats* out, int max) {
+    (void)out; (void)max;
+    return 0;
+}
+
+int64_t moon_mem_sample_interval(void) {
+    return 0;
+}
+
+void moon_mem_profile_init(void) {
+}
+
+#endif // MOON_HAS_MEM_PROFILE
 
 char* moon_strdup(const char* str) {
     if (!str) return NULL;
     size_t len = strlen(str);
-    char* dup = (char*)moon_alloc(len + 1);
+    char* dup = (char*)moon_alloc_raw(len + 1);
     memcpy(dup, str, len + 1);
     return dup;
 }
@@ -266,7 +1004,7 @@ MoonStrHeader* moon_str_get_header(const char* str) {
 
 char* moon_str_with_capacity_hash(const char* src, size_t len, size_t capacity, 
                                    uint32_t precomputedHash, bool hashKnown) {
-    MoonStrHeader* header = (MoonStrHeader*)moon_alloc(sizeof(MoonStrHeader) + capacity + 1);
+    MoonStrHeader* header = (MoonStrHeader*)moon_alloc_typed(MOON_MEM_STRING, sizeof(MoonStrHeader) + capacity + 1);
     header->magic = MOON_STR_MAGIC;
     header->capacity = capacity;
     header->length = len;
@@ -291,6 +1029,38 @@ char* moon_str_with_capacity(const char* src, size_t len, size_t capacity) {
     return moon_str_with_capacity_hash(src, len, capacity, 0, false);
 }
 
+char* moon_str_buffer(size_t capacity) {
+    return moon_str_with_capacity_hash(NULL, 0, capacity, 0, false);
+}
+
+char* moon_str_reserve(char* buf, size_t capacity) {
+    MoonStrHeader* header = moon_str_get_header(buf);
+    if (capacity <= header->capacity) return buf;
+    MoonStrHeader* grown = (MoonStrHeader*)moon_realloc_typed(MOON_MEM_STRING, header, sizeof(MoonStrHeader) + capacity + 1);
+    if (!grown) return NULL;
+    grown->capacity = capacity;
+    return (char*)(grown + 1);
+}
+
+MoonValue* moon_str_finish(char* buf, size_t len) {
+    MoonStrHeader* header = moon_str_get_header(buf);
+    if (len > header->capacity) len = header->capacity;
+    // Give back most of an oversized read buffer (e.g. 64KB asked, 200B read)
+    if (header->capacity > 4096 && len < header->capacity / 4) {
+        size_t newCapacity = len < 64 ? 64 : len;
+        MoonStrHeader* shrunk = (MoonStrHeader*)moon_realloc_typed(MOON_MEM_STRING, header, sizeof(MoonStrHeader) + newCapacity + 1);
+        if (shrunk) {
+            header = shrunk;
+            header->capacity = newCapacity;
+            buf = (char*)(header + 1);
+        }
+    }
+    header->length = len;
+    header->hashValid = false;
+    buf[len] = '\0';
+    return moon_string_owned(buf);
+}
+
 // ============================================================================
 // Hash Functions
 // ============================================================================
@@ -342,12 +1112,12 @@ uint32_t hash_string_cached(const char* str, MoonStrHeader* header) {
 
 MoonValue* moon_pool_alloc(void) {
     // Temporarily bypass pool - use direct allocation
-    return (MoonValue*)moon_alloc(sizeof(MoonValue));
+    return (MoonValue*)moon_alloc_typed(MOON_MEM_VALUE, sizeof(MoonValue));
 }
 
 void moon_pool_free(MoonValue* val) {
     // Temporarily bypass pool - use direct free
-    free(val);
+    moon_free_typed(MOON_MEM_VALUE, val);
 }
 
 // ============================================================================
@@ -368,7 +1138,7 @@ MoonValue* moon_get_cached_int_str(int64_t val) {
     if (!g_int_str_cache_initialized) moon_init_int_str_cache();
     
     if (!g_int_str_value_cache[val]) {
-        MoonValue* v = (MoonValue*)moon_alloc(sizeof(MoonValue));
+        MoonValue* v = moon_pool_alloc();
         v->type = MOON_STRING;
         v->refcount = INT32_MAX;
         
@@ -438,7 +1208,7 @@ MoonValue* moon_string_intern(const char* str, size_t len, uint32_t hash) {
     
     InternEntry* entry = &g_intern_table[idx];
     if (!entry->value) {
-        MoonValue* v = (MoonValue*)moon_alloc(sizeof(MoonValue));
+        MoonValue* v = moon_pool_alloc();
         v->type = MOON_STRING;
         v->refcount = INT32_MAX;
         v->data.strVal = moon_str_with_capacity_hash(str, len, len, hash, true);
@@ -463,7 +1233,7 @@ MoonValue* moon_string_intern(const char* str, size_t len, uint32_t hash) {
         entry = &g_intern_table[idx];
         
         if (!entry->value) {
-            MoonValue* v = (MoonValue*)moon_alloc(sizeof(MoonValue));
+            MoonValue* v = moon_pool_alloc();
             v->type = MOON_STRING;
             v->refcount = INT32_MAX;
             v->data.strVal = moon_str_with_capacity_hash(str, len, len, hash, true);
@@ -537,7 +1307,7 @@ MoonValue* moon_string(const char* str) {
     }
     
     // For longer strings, create normally
-    MoonValue* v = (MoonValue*)moon_alloc(sizeof(MoonValue));
+    MoonValue* v = moon_pool_alloc();
     v->type = MOON_STRING;
     v->refcount = 1;
     size_t capacity = len < 32 ? 32 : len;
@@ -546,22 +1316,53 @@ MoonValue* moon_string(const char* str) {
 }
 
 MoonValue* moon_string_owned(char* str) {
-    MoonValue* v = (MoonValue*)moon_alloc(sizeof(MoonValue));
+    // A plain moon_alloc() buffer becomes string memory from here on
+    if (str && !moon_str_get_header(str)) moon_mem_retag(str, MOON_MEM_OTHER, MOON_MEM_STRING);
+    MoonValue* v = moon_pool_alloc();
     v->type = MOON_STRING;
     v->refcount = 1;
     v->data.strVal = str;
     return v;
 }
 
+// Zero-copy view over bytes kept alive by owner (retained) or, for C memory,
+// freed by release(base) with the last reference
+MoonValue* moon_buffer_new(const char* data, size_t length, MoonValue* owner,
+                           void (*release)(void* base), void* base) {
+    MoonBuffer* buf = (MoonBuffer*)moon_alloc(sizeof(MoonBuffer));
+    buf->data = data;
+    buf->length = length;
+    buf->owner = owner;
+    buf->release = release;
+    buf->base = base;
+    buf->terminated = false;
+    if (owner) {
+        moon_retain(owner);
+        // String bytes always end in a NUL; a view reaching the end keeps it
+        size_t ownerLen;
+        const char* ownerData = moon_bytes_view(owner, &ownerLen);
+        if (ownerData && data + length == ownerData + ownerLen) {
+            buf->terminated = owner->type == MOON_STRING || owner->data.bufferVal->terminated;
+        }
+    }
+    
+    MoonValue* v = moon_pool_alloc();
+    v->type = MOON_BUFFER;
+    v->refcount = 1;
+    v->data.bufferVal = buf;
+    return v;
+}
+
 MoonValue* moon_list_new(void) {
-    MoonValue* v = (MoonValue*)moon_alloc(sizeof(MoonValue));
+    MoonValue* v = moon_pool_alloc();
     v->type = MOON_LIST;
     v->refcount = 1;
     
-    MoonList* list = (MoonList*)moon_alloc(sizeof(MoonList));
+    MoonList* list = (MoonList*)moon_alloc_typed(MOON_MEM_LIST, sizeof(MoonList));
     list->capacity = 8;
     list->length = 0;
-    list->items = (MoonValue**)moon_alloc(sizeof(MoonValue*) * list->capacity);
+    list->items = (MoonValue**)moon_alloc_typed(MOON_MEM_LIST, sizeof(MoonValue*) * list->capacity);
+    list->shared = false;
     v->data.listVal = list;
     
     gc_track(v);  // Track for cycle detection
@@ -569,23 +1370,78 @@ MoonValue* moon_list_new(void) {
 }
 
 MoonValue* moon_dict_new(void) {
-    MoonValue* v = (MoonValue*)moon_alloc(sizeof(MoonValue));
+    MoonValue* v = moon_pool_alloc();
     v->type = MOON_DICT;
     v->refcount = 1;
     
-    MoonDict* dict = (MoonDict*)moon_alloc(sizeof(MoonDict));
-    dict->capacity = 256;
+    MoonDict* dict = (MoonDict*)moon_alloc_typed(MOON_MEM_DICT, sizeof(MoonDict));
+    dict->capacity = MOON_DICT_INITIAL_CAPACITY;
     dict->length = 0;
-    dict->entries = (MoonDictEntry*)moon_alloc(sizeof(MoonDictEntry) * dict->capacity);
+    dict->entries = (MoonDictEntry*)moon_alloc_typed(MOON_MEM_DICT, sizeof(MoonDictEntry) * dict->capacity);
     memset(dict->entries, 0, sizeof(MoonDictEntry) * dict->capacity);
+    dict->shared = false;
     v->data.dictVal = dict;
     
     gc_track(v);  // Track for cycle detection
     return v;
 }
 
+// A list over the static item array of a constant literal (immortal values).
+// The array is copied by the first modification (moon_list_unshare).
+MoonValue* moon_list_const(MoonValue** items, int32_t count) {
+    MoonValue* v = moon_pool_alloc();
+    v->type = MOON_LIST;
+    v->refcount = 1;
+    
+    MoonList* list = (MoonList*)moon_alloc_typed(MOON_MEM_LIST, sizeof(MoonList));
+    list->capacity = count;
+    list->length = count;
+    list->items = items;
+    list->shared = true;
+    v->data.listVal = list;
+    
+    gc_track(v);
+    return v;
+}
+
+// A dict sharing the hash table of a constant literal. The table is built by
+// the first evaluation and kept in *table for good (one per literal).
+MoonValue* moon_dict_const(MoonValue** table, MoonValue** keys, MoonValue** values, int32_t count) {
+    MoonValue* source = *table;
+    if (!source) {
+        MoonValue* built = moon_dict_new();
+        for (int32_t i = 0; i < count; i++) {
+            moon_dict_set(built, keys[i], values[i]);
+        }
+#ifdef MOON_PLATFORM_WINDOWS
+        bool won = InterlockedCompareExchangePointer((PVOID volatile*)table, built, NULL) == NULL;
+#else
+        bool won = __sync_bool_compare_and_swap(table, (MoonValue*)NULL, built);
+#endif
+        if (won) {
+            gc_untrack(built);
+            built->refcount = INT32_MAX;
+        } else {
+            moon_release(built);  // Another thread built it first
+        }
+        source = *table;
+    }
+    
+    MoonValue* v = moon_pool_alloc();
+    v->type = MOON_DICT;
+    v->refcount = 1;
+    
+    MoonDict* dict = (MoonDict*)moon_alloc_typed(MOON_MEM_DICT, sizeof(MoonDict));
+    *dict = *source->data.dictVal;
+    dict->shared = true;
+    v->data.dictVal = dict;
+    
+    gc_track(v);
+    return v;
+}
+
 MoonValue* moon_func(MoonFunc fn) {
-    MoonValue* v = (MoonValue*)moon_alloc(sizeof(MoonValue));
+    MoonValue* v = moon_pool_alloc();
     v->type = MOON_FUNC;
     v->refcount = 1;
     v->data.funcVal = fn;
@@ -627,16 +1483,16 @@ static __thread int g_closure_capture_count = 0;
 #endif
 
 MoonValue* moon_closure_new(MoonFunc func, MoonValue** captures, int count) {
-    MoonValue* v = (MoonValue*)moon_alloc(sizeof(MoonValue));
+    MoonValue* v = moon_pool_alloc();
     v->type = MOON_CLOSURE;
     v->refcount = 1;
     
-    MoonClosure* closure = (MoonClosure*)moon_alloc(sizeof(MoonClosure));
+    MoonClosure* closure = (MoonClosure*)moon_alloc_typed(MOON_MEM_CLOSURE, sizeof(MoonClosure));
     closure->func = func;
     closure->capture_count = count;
     
     if (count > 0 && captures) {
-        closure->captures = (MoonValue**)moon_alloc(count * sizeof(MoonValue*));
+        closure->captures = (MoonValue**)moon_alloc_typed(MOON_MEM_CLOSURE, count * sizeof(MoonValue*));
         for (int i = 0; i < count; i++) {
             moon_retain(captures[i]);
             closure->captures[i] = captures[i];
@@ -713,33 +1569,37 @@ void moon_free_value(MoonValue* val) {
             if (val->data.strVal) {
                 MoonStrHeader* header = moon_str_get_header(val->data.strVal);
                 if (header) {
-                    free(header);
+                    moon_free_typed(MOON_MEM_STRING, header);
                 } else {
-                    free(val->data.strVal);
+                    moon_free_typed(MOON_MEM_STRING, val->data.strVal);
                 }
             }
             break;
             
         case MOON_LIST: {
             MoonList* list = val->data.listVal;
-            for (int32_t i = 0; i < list->length; i++) {
-                moon_release(list->items[i]);
+            if (!list->shared) {
+                for (int32_t i = 0; i < list->length; i++) {
+                    moon_release(list->items[i]);
+                }
+                moon_free_typed(MOON_MEM_LIST, list->items);
             }
-            free(list->items);
-            free(list);
+            moon_free_typed(MOON_MEM_LIST, list);
             break;
         }
         
         case MOON_DICT: {
             MoonDict* dict = val->data.dictVal;
-            for (int32_t i = 0; i < dict->capacity; i++) {
-                if (dict->entries[i].used) {
-                    free(dict->entries[i].key);
-                    moon_release(dict->entries[i].value);
+            if (!dict->shared) {
+                for (int32_t i = 0; i < dict->capacity; i++) {
+                    if (dict->entries[i].used) {
+                        moon_free(dict->entries[i].key, 0);
+                        moon_release(dict->entries[i].value);
+                    }
                 }
+                moon_free_typed(MOON_MEM_DICT, dict->entries);
             }
-            free(dict->entries);
-            free(dict);
+            moon_free_typed(MOON_MEM_DICT, dict);
             break;
         }
         
@@ -749,14 +1609,14 @@ void moon_free_value(MoonValue* val) {
                 MoonDict* dict = obj->fields;
                 for (int32_t i = 0; i < dict->capacity; i++) {
                     if (dict->entries[i].used) {
-                        free(dict->entries[i].key);
+                        moon_free(dict->entries[i].key, 0);
                         moon_release(dict->entries[i].value);
                     }
                 }
-                free(dict->entries);
-                free(dict);
+                moon_free_typed(MOON_MEM_OBJECT, dict->entries);
+                moon_free_typed(MOON_MEM_OBJECT, dict);
             }
-            free(obj);
+            moon_free_typed(MOON_MEM_OBJECT, obj);
             break;
         }
         
@@ -771,9 +1631,9 @@ void moon_free_value(MoonValue* val) {
                     moon_release(closure->captures[i]);
                 }
                 if (closure->captures) {
-                    free(closure->captures);
+                    moon_free_typed(MOON_MEM_CLOSURE, closure->captures);
                 }
-                free(closure);
+                moon_free_typed(MOON_MEM_CLOSURE, closure);
             }
             break;
         }
@@ -786,6 +1646,14 @@ void moon_free_value(MoonValue* val) {
             break;
         }
         
+        case MOON_BUFFER: {
+            MoonBuffer* buf = val->data.bufferVal;
+            if (buf->owner) moon_release(buf->owner);
+            if (buf->release) buf->release(buf->base);
+            moon_free(buf, sizeof(MoonBuffer));
+            break;
+        }
+        
         default:
             break;
     }
@@ -1108,7 +1976,9 @@ void gc_collect(void) {
         switch (val->type) {
             case MOON_LIST: {
                 MoonList* list = val->data.listVal;
-                if (list) {
+                if (list && list->shared) {
+                    moon_free_typed(MOON_MEM_LIST, list);
+                } else if (list) {
                     // Release items that are NOT garbage (live objects)
                     for (int32_t j = 0; j < list->length; j++) {
                         MoonValue* item = list->items[j];
@@ -1117,17 +1987,19 @@ void gc_collect(void) {
                             moon_release(item);
                         }
                     }
-                    free(list->items);
-                    free(list);
+                    moon_free_typed(MOON_MEM_LIST, list->items);
+                    moon_free_typed(MOON_MEM_LIST, list);
                 }
                 break;
             }
             case MOON_DICT: {
                 MoonDict* dict = val->data.dictVal;
-                if (dict) {
+                if (dict && dict->shared) {
+                    moon_free_typed(MOON_MEM_DICT, dict);
+                } else if (dict) {
                     for (int32_t j = 0; j < dict->capacity; j++) {
                         if (dict->entries[j].used) {
-                            free(dict->entries[j].key);
+                            moon_free(dict->entries[j].key, 0);
                             MoonValue* value = dict->entries[j].value;
                             // O(1) check if value is garbage
                             if (value && value->refcount != -1 && garbage_set.find(value) == garbage_set.end()) {
@@ -1135,8 +2007,8 @@ void gc_collect(void) {
                             }
                         }
                     }
-                    free(dict->entries);
-                    free(dict);
+                    moon_free_typed(MOON_MEM_DICT, dict->entries);
+                    moon_free_typed(MOON_MEM_DICT, dict);
                 }
                 break;
             }
@@ -1147,7 +2019,7 @@ void gc_collect(void) {
                         MoonDict* dict = obj->fields;
                         for (int32_t j = 0; j < dict->capacity; j++) {
                             if (dict->entries[j].used) {
-                                free(dict->entries[j].key);
+                                moon_free(dict->entries[j].key, 0);
                                 MoonValue* value = dict->entries[j].value;
                                 // O(1) check if value is garbage
                                 if (value && value->refcount != -1 && garbage_set.find(value) == garbage_set.end()) {
@@ -1155,10 +2027,10 @@ void gc_collect(void) {
                                 }
                             }
                         }
-                        free(dict->entries);
-                        free(dict);
+                        moon_free_typed(MOON_MEM_OBJECT, dict->entries);
+                        moon_free_typed(MOON_MEM_OBJECT, dict);
                     }
-                    free(obj);
+                    moon_free_typed(MOON_MEM_OBJECT, obj);
                 }
                 break;
             }
@@ -1174,9 +2046,9 @@ void gc_collect(void) {
                         }
                     }
                     if (closure->captures) {
-                        free(closure->captures);
+                        moon_free_typed(MOON_MEM_CLOSURE, closure->captures);
                     }
-                    free(closure);
+                    moon_free_typed(MOON_MEM_CLOSURE, closure);
                 }
                 break;
             }
@@ -1335,6 +2207,10 @@ bool moon_is_object(MoonValue* val) {
     return val && val->type == MOON_OBJECT;
 }
 
+bool moon_is_buffer(MoonValue* val) {
+    return val && val->type == MOON_BUFFER;
+}
+
 bool moon_is_truthy(MoonValue* val) {
     if (!val) return false;
     switch (val->type) {
@@ -1345,6 +2221,7 @@ bool moon_is_truthy(MoonValue* val) {
         case MOON_STRING: return val->data.strVal && val->data.strVal[0] != '\0';
         case MOON_LIST: return val->data.listVal->length > 0;
         case MOON_DICT: return val->data.dictVal->length > 0;
+        case MOON_BUFFER: return val->data.bufferVal->length > 0;
         default: return true;
     }
 }
@@ -1360,6 +2237,7 @@ int64_t moon_to_int(MoonValue* val) {
         case MOON_FLOAT: return (int64_t)val->data.floatVal;
         case MOON_BOOL: return val->data.boolVal ? 1 : 0;
         case MOON_STRING: return atoll(val->data.strVal);
+        case MOON_BUFFER: return (int64_t)(uintptr_t)val->data.bufferVal->data;  // Address for C
         default: return 0;
     }
 }
@@ -1400,6 +2278,13 @@ char* moon_to_string(MoonValue* val) {
             return moon_strdup(val->data.boolVal ? "true" : "false");
         case MOON_STRING:
             return moon_strdup(val->data.strVal);
+        case MOON_BUFFER: {
+            MoonBuffer* buf = val->data.bufferVal;
+            char* result = (char*)moon_alloc(buf->length + 1);
+            memcpy(result, buf->data, buf->length);
+            result[buf->length] = '\0';
+            return result;
+        }
         case MOON_LIST: {
             MoonList* list = val->data.listVal;
             size_t bufSize = 256;
@@ -1411,10 +2296,10 @@ char* moon_to_string(MoonValue* val) {
                 size_t needed = strlen(result) + strlen(item) + 10;
                 if (needed > bufSize) {
                     bufSize = needed * 2;
-                    result = (char*)realloc(result, bufSize);
+                    result = (char*)moon_realloc(result, bufSize);
                 }
                 strcat(result, item);
-                free(item);
+                moon_free(item, 0);
             }
             strcat(result, "]");
             return result;
@@ -1433,13 +2318,13 @@ char* moon_to_string(MoonValue* val) {
                 size_t needed = strlen(result) + strlen(dict->entries[i].key) + strlen(valStr) + 20;
                 if (needed > bufSize) {
                     bufSize = needed * 2;
-                    result = (char*)realloc(result, bufSize);
+                    result = (char*)moon_realloc(result, bufSize);
                 }
                 strcat(result, "\"");
                 strcat(result, dict->entries[i].key);
                 strcat(result, "\": ");
                 strcat(result, valStr);
-                free(valStr);
+                moon_free(valStr, 0);
             }
             strcat(result, "}");
             return result;
@@ -1457,6 +2342,21 @@ char* moon_to_string(MoonValue* val) {
     }
 }
 
+// Binary-safe bytes of a string or buffer without copying; NULL otherwise
+const char* moon_bytes_view(MoonValue* val, size_t* len) {
+    if (!val) return NULL;
+    if (val->type == MOON_STRING && val->data.strVal) {
+        MoonStrHeader* header = moon_str_get_header(val->data.strVal);
+        *len = header ? header->length : strlen(val->data.strVal);
+        return val->data.strVal;
+    }
+    if (val->type == MOON_BUFFER) {
+        *len = val->data.bufferVal->length;
+        return val->data.bufferVal->data;
+    }
+    return NULL;
+}
+
 MoonValue* moon_cast_int(MoonValue* val) {
     return moon_int(moon_to_int(val));
 }
@@ -1476,6 +2376,12 @@ MoonValue* moon_cast_string(MoonValue* val) {
         }
     }
     
+    if (val && val->type == MOON_BUFFER) {
+        // Binary-safe copy (may contain NULs)
+        MoonBuffer* buf = val->data.bufferVal;
+        return moon_string_owned(moon_str_with_capacity(buf->data, buf->length, buf->length));
+    }
+    
     char* str = moon_to_string(val);
     return moon_string_owned(str);
 }
@@ -1513,7 +2419,7 @@ MoonClass* moon_class_new(const char* name, MoonClass* parent) {
 
 void moon_class_add_method(MoonClass* klass, const char* name, MoonFunc func, bool isStatic) {
     klass->methodCount++;
-    klass->methods = (MoonMethod*)realloc(klass->methods, sizeof(MoonMethod) * klass->methodCount);
+    klass->methods = (MoonMethod*)moon_realloc(klass->methods, sizeof(MoonMethod) * klass->methodCount);
     MoonMethod* method = &klass->methods[klass->methodCount - 1];
     method->name = moon_strdup(name);
     method->func = func;
@@ -1521,18 +2427,19 @@ void moon_class_add_method(MoonClass* klass, const char* name, MoonFunc func, bo
 }
 
 MoonValue* moon_object_new(MoonClass* klass) {
-    MoonValue* v = (MoonValue*)moon_alloc(sizeof(MoonValue));
+    MoonValue* v = moon_pool_alloc();
     v->type = MOON_OBJECT;
     v->refcount = 1;
     
-    MoonObject* obj = (MoonObject*)moon_alloc(sizeof(MoonObject));
+    MoonObject* obj = (MoonObject*)moon_alloc_typed(MOON_MEM_OBJECT, sizeof(MoonObject));
     obj->klass = klass;
     
-    MoonDict* fields = (MoonDict*)moon_alloc(sizeof(MoonDict));
+    MoonDict* fields = (MoonDict*)moon_alloc_typed(MOON_MEM_OBJECT, sizeof(MoonDict));
     fields->capacity = 8;
     fields->length = 0;
-    fields->entries = (MoonDictEntry*)moon_alloc(sizeof(MoonDictEntry) * fields->capacity);
+    fields->entries = (MoonDictEntry*)moon_alloc_typed(MOON_MEM_OBJECT, sizeof(MoonDictEntry) * fields->capacity);
     memset(fields->entries, 0, sizeof(MoonDictEntry) * fields->capacity);
+    fields->shared = false;
     obj->fields = fields;
     
     v->data.objVal = obj;
@@ -1561,7 +2468,7 @@ void moon_object_set(MoonValue* obj, const char* field, MoonValue* val) {
     MoonDict* dict = o->fields;
     
     if (dict->length * 4 >= dict->capacity * 3) {
-        moon_dict_resize(dict);
+        moon_dict_resize(dict, MOON_MEM_OBJECT);
     }
     
     size_t fieldLen = strlen(field);
@@ -1615,7 +2522,7 @@ MoonValue* moon_object_call_method(MoonValue* obj, const char* method, MoonValue
     }
     
     MoonValue* result = m->func(newArgs, argc + 1);
-    free(newArgs);
+    moon_free(newArgs, 0);
     return result;
 }
 
@@ -1639,7 +2546,7 @@ MoonValue* moon_object_call_init(MoonValue* obj, MoonValue** args, int argc) {
     }
     
     MoonValue* result = m->func(newArgs, argc + 1);
-    free(newArgs);
+    moon_free(newArgs, 0);
     return result;
 }
 
@@ -1711,7 +2618,7 @@ MoonValue* moon_object_call_super_method(MoonValue* obj, const char* currentClas
     }
     
     MoonValue* result = m->func(newArgs, argc + 1);
-    free(newArgs);
+    moon_free(newArgs, 0);
     return result;
 }
 
@@ -1726,6 +2633,7 @@ void moon_runtime_init(int argc, char** argv) {
     g_argv = argv;
     g_initialized = true;
     
+    moon_mem_profile_init();
     moon_init_small_ints();
     
     srand((unsigned int)time(NULL));
@@ -1874,7 +2782,7 @@ extern "C" void moon_throw(MoonValue* value) {
         fprintf(stderr, "Function: %s\n", g_debug_ctx.current_function);
     }
     fprintf(stderr, "\n");
-    free(excStr);
+    moon_free(excStr, 0);
     
     // Cleanup and exit
     if (g_current_exception) {
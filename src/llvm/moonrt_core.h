@@ -35,20 +35,6 @@
 extern "C" {
 #endif
 
-// ============================================================================
-// String Capacity Header (for optimized concatenation)
-// ============================================================================
-
-#define MOON_STR_MAGIC 0x4D4F4F4E53545243ULL  // "MOONSTRC" in hex
-
-typedef struct MoonStrHeader {
-    uint64_t magic;
-    size_t capacity;
-    size_t length;
-    uint32_t cachedHash;  // Cached FNV-1a hash value
-    bool hashValid;       // Whether cachedHash is valid
-} MoonStrHeader;
-
 // ============================================================================
 // Internal Macros
 // ============================================================================
@@ -91,12 +77,86 @@ extern bool g_int_str_value_cache_initialized;
 // Internal Memory Functions
 // ============================================================================
 
-// Memory allocation (uses static or dynamic heap based on config)
+// Memory allocation (uses static or dynamic heap based on config).
+// moon_alloc() zeroes the block. The size given to moon_free() is advisory,
+// pass 0 when it is not known.
 void* moon_alloc(size_t size);
 void moon_free(void* ptr, size_t size);
 void moon_heap_reset(void);
 void moon_heap_stats(size_t* used, size_t* peak, size_t* total);
 
+// Resize a moon_alloc() block; bytes past the old size are not zeroed
+void* moon_realloc(void* ptr, size_t size);
+
+// Like moon_alloc() but not zeroed, for buffers written straight away
+void* moon_alloc_raw(size_t size);
+
+// Allocation kinds, counted separately for mem_stats()
+typedef enum {
+    MOON_MEM_OTHER = 0,         // Untyped runtime memory (moon_alloc)
+    MOON_MEM_VALUE,             // MoonValue boxes
+    MOON_MEM_STRING,            // String buffers
+    MOON_MEM_LIST,              // MoonList and its item array
+    MOON_MEM_DICT,              // MoonDict and its entry table
+    MOON_MEM_OBJECT,            // MoonObject and its field table
+    MOON_MEM_CLOSURE,           // MoonClosure and its captures
+    MOON_MEM_CORO_STACK,        // Coroutine stacks, reported by moon_mem_account()
+    MOON_MEM_KIND_COUNT
+} MoonMemKind;
+
+// Typed allocation, not zeroed: the caller initializes every field. Memory
+// must be freed or resized with the kind it was allocated as.
+void* moon_alloc_typed(MoonMemKind kind, size_t size);
+void* moon_realloc_typed(MoonMemKind kind, void* ptr, size_t size);
+void moon_free_typed(MoonMemKind kind, void* ptr);
+
+// Count memory the runtime maps itself (bytes < 0 when it is released). It
+// shows up under its kind but not in the heap totals.
+void moon_mem_account(MoonMemKind kind, int64_t bytes);
+
+// Move a moon_alloc() block to another kind, e.g. a buffer adopted as a string
+void moon_mem_retag(void* ptr, MoonMemKind from, MoonMemKind to);
+
+typedef struct {
+    int64_t live;               // Bytes
+    int64_t count;              // Blocks
+    int64_t peak;
+    int64_t allocs;             // Allocations ever made
+} MoonMemKindStats;
+
+void moon_mem_kind_stats(MoonMemKindStats stats[MOON_MEM_KIND_COUNT]);
+const char* moon_mem_kind_name(MoonMemKind kind);
+
+// Sampled allocation sites (MOON_MEM_SAMPLE=<bytes>), heaviest first.
+// Returns 0 when sampling is off.
+typedef struct {
+    char site[256];             // Innermost caller first, "a+0x10 < b+0x4c"
+    int64_t samples;
+    int64_t bytes;              // Sum of the sampled requests
+} MoonMemSiteStats;
+
+int moon_mem_sites(MoonMemSiteStats* sites, int max);
+int64_t moon_mem_sample_interval(void);
+
+// Reads MOON_MEM_SAMPLE and MOON_MEM_DUMP=<seconds>; called by moon_runtime_init()
+void moon_mem_profile_init(void);
+
+// Detailed heap state for mem_stats(). histogram[i] counts live blocks of
+// 16 << i up to 32 << i bytes; the last bucket takes everything larger.
+#define MOON_HEAP_HIST_BUCKETS 12
+
+typedef struct {
+    size_t used, peak, total;
+    size_t free;                // Bytes in free blocks
+    size_t largestFree;         // Biggest free block, header included
+    size_t usedBlocks, freeBlocks;
+    size_t allocCount, freeCount;
+    int fragmentation;          // Percent of free memory outside the largest block
+    size_t histogram[MOON_HEAP_HIST_BUCKETS];
+} MoonHeapInfo;
+
+void moon_heap_info(MoonHeapInfo* info);
+
 // String duplication
 char* moon_strdup(const char* str);
 
@@ -105,6 +165,16 @@ char* moon_str_with_capacity(const char* src, size_t len, size_t capacity);
 char* moon_str_with_capacity_hash(const char* src, size_t len, size_t capacity, 
                                    uint32_t precomputedHash, bool hashKnown);
 
+// Empty string with room for capacity bytes, for reading straight into.
+// moon_str_finish() sets the final length (shrinking a mostly unused
+// buffer) and wraps it in a MoonValue.
+char* moon_str_buffer(size_t capacity);
+char* moon_str_reserve(char* buf, size_t capacity);
+MoonValue* moon_str_finish(char* buf, size_t len);
+
+// Concatenation that may extend a's buffer in place; a must not be shared
+MoonValue* moon_str_append(MoonValue* a, MoonValue* b);
+
 // Get string header (returns NULL if no header)
 MoonStrHeader* moon_str_get_header(const char* str);
 
@@ -175,7 +245,12 @@ int moon_compare(MoonValue* a, MoonValue* b);
 int moon_dict_probe(MoonDict* dict, const char* key, uint16_t keyLen, uint32_t hash);
 
 // Resize hash table when load factor > 0.75
-void moon_dict_resize(MoonDict* dict);
+void moon_dict_resize(MoonDict* dict, MoonMemKind kind);  // kind: MOON_MEM_DICT or MOON_MEM_OBJECT
+
+// Copy-on-write for constant literals: give the list/dict its own items/entries
+// before modifying them (no-op unless shared)
+void moon_list_unshare(MoonList* list);
+void moon_dict_unshare(MoonDict* dict);
 
 // Find with pre-computed hash
 int moon_dict_find_with_hash(MoonDict* dict, const char* key, size_t keyLen, uint32_t hash);
@@ -210,6 +285,80 @@ void gc_untrack(MoonValue* val);
 void gc_lock(void);
 void gc_unlock(void);
 
+// ============================================================================
+// Async / Network Internal Functions
+// ============================================================================
+
+// True when called from inside a coroutine (moonrt_async.cpp)
+bool moon_in_coroutine(void);
+
+// Number of scheduler worker threads (starts the scheduler if needed)
+int moon_sched_workers(void);
+
+// Park the current coroutine until another thread calls moon_coro_wake()
+// with its handle. Returns at once outside a coroutine, and may return
+// early, so callers loop on their own condition. The waker must be done
+// with the handle before the waiter can see that condition: publish it and
+// wake under a lock the waiter also takes to check it.
+void* moon_coro_self(void);
+void moon_coro_park(void);
+void moon_coro_wake(void* coro);
+
+// Wait until fd (a socket or pipe) is readable, or writable, or timeout_ms
+// passes (-1 = no limit). A coroutine parks while the reactor thread
+// watches the descriptor; a plain thread blocks in poll(). Returns 1 when
+// ready (errors and hangups included), 0 on timeout.
+int moon_io_wait(int64_t fd, bool write, int timeout_ms);
+int moon_io_wait_fds(const int64_t* fds, int count, bool write, int timeout_ms);
+
+// Resolve host through the DNS cache and connect with happy eyeballs
+// (IPv6/IPv4 interleaved). Returns a blocking socket, or -1 on failure.
+int64_t moon_net_connect(const char* host, int port, int timeout_ms);
+
+// Coroutine-aware I/O (moonrt_uring.cpp). Inside a coroutine, operations
+// go through a shared io_uring (batched submission, the coroutine yields
+// until completion); otherwise they are plain syscalls. Results follow the
+// syscalls: bytes or fd, -1 with errno set on error.
+bool moon_io_uring_active(void);
+#ifndef _WIN32
+int64_t moon_io_pread(int fd, void* buf, size_t len, int64_t offset);
+int64_t moon_io_pwrite(int fd, const void* buf, size_t len, int64_t offset);
+#endif
+int64_t moon_io_recv(int64_t sock, void* buf, size_t len);
+int64_t moon_io_send(int64_t sock, const void* buf, size_t len);
+int64_t moon_io_accept(int64_t sock, void* addr, void* addrLen, int flags);
+
+// Wrap a byte source in a buffered reader handle (recv_exact/recv_until).
+// fn returns bytes read, 0 on EOF, < 0 on error.
+typedef int (*MoonReadFn)(void* src, char* buf, int len);
+MoonValue* moon_reader_wrap(MoonReadFn fn, void* src);
+
+// Raw I/O on a TLS connection handle for modules layered over TLS
+// (moonrt_tls.cpp). pending = bytes already decrypted and buffered.
+int moon_tls_conn_fd(void* conn);
+int moon_tls_conn_pending(void* conn);
+int moon_tls_conn_read(void* conn, char* buf, int len);
+int moon_tls_conn_write(void* conn, const char* buf, int len);
+
+// XOR a WebSocket payload with its mask key, starting at payload
+// position offset (moonrt_string.cpp)
+void moon_ws_mask(char* data, size_t len, const unsigned char key[4], size_t offset);
+
+// zlib resolved at run time (moonrt_zlib.cpp); NULL when not installed.
+// Stream arguments are z_stream* from <zlib.h>.
+typedef struct {
+    int (*inflateInit2_)(void* strm, int windowBits, const char* version, int streamSize);
+    int (*inflate)(void* strm, int flush);
+    int (*inflateReset)(void* strm);
+    int (*inflateEnd)(void* strm);
+    int (*deflateInit2_)(void* strm, int level, int method, int windowBits, int memLevel,
+                         int strategy, const char* version, int streamSize);
+    int (*deflate)(void* strm, int flush);
+    int (*deflateReset)(void* strm);
+    int (*deflateEnd)(void* strm);
+} MoonZlib;
+const MoonZlib* moon_zlib(void);
+
 #ifdef __cplusplus
 }
 #endif
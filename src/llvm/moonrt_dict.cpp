@@ -24,12 +24,12 @@ int moon_dict_probe(MoonDict* dict, const char* key, uint16_t keyLen, uint32_t h
     return idx;
 }
 
-void moon_dict_resize(MoonDict* dict) {
+void moon_dict_resize(MoonDict* dict, MoonMemKind kind) {
     int32_t oldCapacity = dict->capacity;
     MoonDictEntry* oldEntries = dict->entries;
     
     dict->capacity *= 4;
-    dict->entries = (MoonDictEntry*)moon_alloc(sizeof(MoonDictEntry) * dict->capacity);
+    dict->entries = (MoonDictEntry*)moon_alloc_typed(kind, sizeof(MoonDictEntry) * dict->capacity);
     memset(dict->entries, 0, sizeof(MoonDictEntry) * dict->capacity);
     dict->length = 0;
     
@@ -44,7 +44,22 @@ void moon_dict_resize(MoonDict* dict) {
             dict->length++;
         }
     }
-    free(oldEntries);
+    moon_free_typed(kind, oldEntries);
+}
+
+void moon_dict_unshare(MoonDict* dict) {
+    if (!dict->shared) return;
+    
+    MoonDictEntry* entries = (MoonDictEntry*)moon_alloc_typed(MOON_MEM_DICT, sizeof(MoonDictEntry) * dict->capacity);
+    for (int32_t i = 0; i < dict->capacity; i++) {
+        entries[i] = dict->entries[i];
+        if (entries[i].used) {
+            entries[i].key = moon_strdup(entries[i].key);
+            moon_retain(entries[i].value);
+        }
+    }
+    dict->entries = entries;
+    dict->shared = false;
 }
 
 int moon_dict_find_with_hash(MoonDict* dict, const char* key, size_t keyLen, uint32_t hash) {
@@ -92,7 +107,7 @@ MoonValue* moon_dict_get(MoonValue* dict, MoonValue* key, MoonValue* defaultVal)
         char* keyStr = moon_to_string(key);
         size_t keyLen = strlen(keyStr);
         idx = moon_dict_find(d, keyStr, keyLen);
-        free(keyStr);
+        moon_free(keyStr, 0);
     }
     
     if (idx < 0) {
@@ -111,9 +126,10 @@ void moon_dict_set(MoonValue* dict, MoonValue* key, MoonValue* val) {
     if (!moon_is_dict(dict)) return;
     
     MoonDict* d = dict->data.dictVal;
+    moon_dict_unshare(d);
     
     if (d->length * 4 >= d->capacity * 3) {
-        moon_dict_resize(d);
+        moon_dict_resize(d, MOON_MEM_DICT);
     }
     
     bool keyIsString = key && key->type == MOON_STRING && key->data.strVal;
@@ -140,10 +156,10 @@ void moon_dict_set(MoonValue* dict, MoonValue* key, MoonValue* val) {
         moon_release(d->entries[idx].value);
         moon_retain(val);
         d->entries[idx].value = val;
-        if (keyStr) free(keyStr);
+        if (keyStr) moon_free(keyStr, 0);
     } else {
         if (keyIsString) {
-            d->entries[idx].key = strdup(keyPtr);
+            d->entries[idx].key = moon_strdup(keyPtr);
         } else {
             d->entries[idx].key = keyStr;
         }
@@ -169,7 +185,7 @@ MoonValue* moon_dict_has_key(MoonValue* dict, MoonValue* key) {
         char* keyStr = moon_to_string(key);
         size_t keyLen = strlen(keyStr);
         idx = moon_dict_find(dict->data.dictVal, keyStr, keyLen);
-        free(keyStr);
+        moon_free(keyStr, 0);
     }
     
     return moon_bool(idx >= 0);
@@ -182,7 +198,9 @@ MoonValue* moon_dict_keys(MoonValue* dict) {
     MoonDict* d = dict->data.dictVal;
     for (int32_t i = 0; i < d->capacity; i++) {
         if (d->entries[i].used) {
-            moon_list_append(result, moon_string(d->entries[i].key));
+            MoonValue* key = moon_string(d->entries[i].key);
+            moon_release(moon_list_append(result, key));
+            moon_release(key);
         }
     }
     return result;
@@ -195,8 +213,7 @@ MoonValue* moon_dict_values(MoonValue* dict) {
     MoonDict* d = dict->data.dictVal;
     for (int32_t i = 0; i < d->capacity; i++) {
         if (d->entries[i].used) {
-            moon_retain(d->entries[i].value);
-            moon_list_append(result, d->entries[i].value);
+            moon_release(moon_list_append(result, d->entries[i].value));
         }
     }
     return result;
@@ -210,10 +227,12 @@ MoonValue* moon_dict_items(MoonValue* dict) {
     for (int32_t i = 0; i < d->capacity; i++) {
         if (d->entries[i].used) {
             MoonValue* pair = moon_list_new();
-            moon_list_append(pair, moon_string(d->entries[i].key));
-            moon_retain(d->entries[i].value);
-            moon_list_append(pair, d->entries[i].value);
-            moon_list_append(result, pair);
+            MoonValue* key = moon_string(d->entries[i].key);
+            moon_release(moon_list_append(pair, key));
+            moon_release(key);
+            moon_release(moon_list_append(pair, d->entries[i].value));
+            moon_release(moon_list_append(result, pair));
+            moon_release(pair);
         }
     }
     return result;
@@ -226,10 +245,11 @@ void moon_dict_delete(MoonValue* dict, MoonValue* key) {
     size_t keyLen = strlen(keyStr);
     MoonDict* d = dict->data.dictVal;
     int idx = moon_dict_find(d, keyStr, keyLen);
-    free(keyStr);
+    moon_free(keyStr, 0);
     
     if (idx >= 0) {
-        free(d->entries[idx].key);
+        moon_dict_unshare(d);
+        moon_free(d->entries[idx].key, 0);
         d->entries[idx].key = NULL;
         moon_release(d->entries[idx].value);
         d->entries[idx].value = NULL;
@@ -31,6 +31,32 @@ MoonValue* moon_dll_func(MoonValue* handle, MoonValue* name) {
     return moon_int((int64_t)(uintptr_t)proc);
 }
 
+// Look a symbol up in every module loaded into the process
+static void* dll_process_symbol(const char* name) {
+    typedef BOOL (WINAPI *EnumModulesFn)(HANDLE, HMODULE*, DWORD, LPDWORD);
+    static EnumModulesFn enumModules = (EnumModulesFn)GetProcAddress(
+        GetModuleHandleA("kernel32.dll"), "K32EnumProcessModules");
+    
+    FARPROC proc = GetProcAddress(GetModuleHandleA(NULL), name);
+    if (proc || !enumModules) return (void*)proc;
+    
+    HMODULE mods[512];
+    DWORD needed = 0;
+    if (!enumModules(GetCurrentProcess(), mods, sizeof(mods), &needed)) return NULL;
+    DWORD count = needed / sizeof(HMODULE);
+    if (count > 512) count = 512;
+    for (DWORD i = 0; i < count; i++) {
+        proc = GetProcAddress(mods[i], name);
+        if (proc) return (void*)proc;
+    }
+    return NULL;
+}
+
+static void* dll_lib_symbol(MoonValue* lib, const char* name) {
+    HMODULE h = (HMODULE)(uintptr_t)moon_to_int(lib);
+    return h ? (void*)GetProcAddress(h, name) : NULL;
+}
+
 typedef int64_t (*IntFunc)(...);
 typedef double (*DoubleFunc)(...);
 typedef char* (*StrFunc)(...);
@@ -179,6 +205,16 @@ MoonValue* moon_dll_func(MoonValue* handle, MoonValue* name) {
     return moon_int((int64_t)(uintptr_t)func);
 }
 
+// Look a symbol up in the executable and every library loaded so far
+static void* dll_process_symbol(const char* name) {
+    return dlsym(RTLD_DEFAULT, name);
+}
+
+static void* dll_lib_symbol(MoonValue* lib, const char* name) {
+    void* h = (void*)(uintptr_t)moon_to_int(lib);
+    return h ? dlsym(h, name) : NULL;
+}
+
 typedef int64_t (*IntFunc)(...);
 typedef double (*DoubleFunc)(...);
 typedef char* (*StrFunc)(...);
@@ -296,6 +332,37 @@ void moon_write_int32(MoonValue* addr, MoonValue* value) {
 
 #endif // _WIN32 or Linux
 
+// ============================================================================
+// Direct C Calls (ffi_cdef)
+// ============================================================================
+// Functions declared with a literal ffi_cdef are called through a per-function
+// slot holding the native address. ffi_cdef fills the slots; a call that finds
+// its slot empty resolves it from the process on first use.
+
+// Stand-in for functions that could not be resolved: returns 0 whatever the
+// declared signature (the caller owns the stack on every supported ABI)
+static int64_t dll_unresolved_stub(void) {
+    return 0;
+}
+
+void* moon_ffi_bind(void** slot, MoonValue* lib, const char* name) {
+    void* fn = lib ? dll_lib_symbol(lib, name) : dll_process_symbol(name);
+    *slot = fn;
+    return fn;
+}
+
+void* moon_ffi_resolve(void** slot, const char* name) {
+    void* fn = dll_process_symbol(name);
+    if (!fn) {
+        char msg[256];
+        snprintf(msg, sizeof(msg), "ffi: unresolved C function '%s'", name);
+        moon_error(msg);
+        fn = (void*)dll_unresolved_stub;
+    }
+    *slot = fn;
+    return fn;
+}
+
 #else // !MOON_HAS_DLL
 
 // Stub implementations when DLL support is disabled
@@ -314,4 +381,11 @@ MoonValue* moon_read_int32(MoonValue* addr) { return moon_int(0); }
 void moon_write_ptr(MoonValue* addr, MoonValue* value) { }
 void moon_write_int32(MoonValue* addr, MoonValue* value) { }
 
+static int64_t dll_unresolved_stub(void) { return 0; }
+void* moon_ffi_bind(void** slot, MoonValue* lib, const char* name) { *slot = NULL; return NULL; }
+void* moon_ffi_resolve(void** slot, const char* name) {
+    *slot = (void*)dll_unresolved_stub;
+    return *slot;
+}
+
 #endif // MOON_HAS_DLL
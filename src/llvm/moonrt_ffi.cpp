@@ -210,7 +210,7 @@ static void ffi_calculate_struct_layout(FFIType* type) {
 // Define a struct type: FFI.struct(name, fields)
 // fields is a list of [name, typeId] pairs
 MoonValue* moon_ffi_struct(MoonValue* name, MoonValue* fields) {
-    if (!moon_ffi_init, g_ffiInitialized) moon_ffi_init();
+    if (!g_ffiInitialized) moon_ffi_init();
     
     if (!moon_is_string(name) || !moon_is_list(fields)) {
         return moon_int(-1);
@@ -346,6 +346,31 @@ MoonValue* moon_ffi_pointer_type(MoonValue* targetType) {
     return moon_int(typeId);
 }
 
+// Register a callback signature under a name (NULL for an anonymous one)
+int ffi_register_callback_type(const char* name, const int* paramTypeIds, int paramCount, int returnTypeId) {
+    if (!g_ffiInitialized) moon_ffi_init();
+    
+    FFIType* type = (FFIType*)calloc(1, sizeof(FFIType));
+    if (!type) return -1;
+    
+    type->kind = FFI_CALLBACK;
+    type->name = strdup(name ? name : "callback");
+    type->paramTypeIds = (int*)calloc(paramCount > 0 ? paramCount : 1, sizeof(int));
+    type->paramCount = paramCount;
+    type->returnTypeId = returnTypeId;
+    type->size = sizeof(void*);
+    type->alignment = sizeof(void*);
+    if (paramCount > 0) memcpy(type->paramTypeIds, paramTypeIds, paramCount * sizeof(int));
+    
+    int typeId = ffi_add_type_to_registry(type);
+    if (typeId < 0) {
+        free(type->paramTypeIds);
+        free(type->name);
+        free(type);
+    }
+    return typeId;
+}
+
 // Define a callback type: FFI.callback(params, returnType)
 MoonValue* moon_ffi_callback_type(MoonValue* params, MoonValue* returnType) {
     if (!g_ffiInitialized) moon_ffi_init();
@@ -364,32 +389,23 @@ MoonValue* moon_ffi_callback_type(MoonValue* params, MoonValue* returnType) {
         return moon_int(-1);
     }
     
-    FFIType* type = (FFIType*)calloc(1, sizeof(FFIType));
-    if (!type) return moon_int(-1);
-    
-    type->kind = FFI_CALLBACK;
-    type->name = strdup("callback");  // Could generate a more descriptive name
-    type->paramTypeIds = (int*)calloc(paramCount, sizeof(int));
-    type->paramCount = paramCount;
-    type->returnTypeId = returnTypeId;
-    type->size = sizeof(void*);
-    type->alignment = sizeof(void*);
+    int* paramTypeIds = (int*)calloc(paramCount > 0 ? paramCount : 1, sizeof(int));
+    if (!paramTypeIds) return moon_int(-1);
     
     for (int i = 0; i < paramCount; i++) {
         MoonValue* param = paramList->items[i];
         if (moon_is_int(param)) {
-            type->paramTypeIds[i] = (int)moon_to_int(param);
+            paramTypeIds[i] = (int)moon_to_int(param);
         } else if (moon_is_string(param)) {
-            type->paramTypeIds[i] = ffi_get_type_id(param->data.strVal);
+            paramTypeIds[i] = ffi_get_type_id(param->data.strVal);
         } else {
-            free(type->paramTypeIds);
-            free(type->name);
-            free(type);
+            free(paramTypeIds);
             return moon_int(-1);
         }
     }
     
-    int typeId = ffi_add_type_to_registry(type);
+    int typeId = ffi_register_callback_type(NULL, paramTypeIds, paramCount, returnTypeId);
+    free(paramTypeIds);
     return moon_int(typeId);
 }
 
@@ -620,6 +636,182 @@ void moon_ffi_set(MoonValue* ptr, MoonValue* typeVal, MoonValue* field, MoonValu
     }
 }
 
+// ============================================================================
+// Field Accessors
+// ============================================================================
+// ffi_field resolves a field once into a handle that packs its kind and
+// offset; ffi_field_get/ffi_field_set then read and write at the fixed
+// offset without touching the type registry or comparing names.
+
+static FFIField* ffi_lookup_field(MoonValue* typeVal, MoonValue* field) {
+    int typeId;
+    if (moon_is_int(typeVal)) {
+        typeId = (int)moon_to_int(typeVal);
+    } else if (moon_is_string(typeVal)) {
+        typeId = ffi_get_type_id(typeVal->data.strVal);
+    } else {
+        return NULL;
+    }
+    
+    FFIType* type = ffi_get_type(typeId);
+    if (!type || type->kind != FFI_STRUCT || !moon_is_string(field)) return NULL;
+    
+    for (int i = 0; i < type->fieldCount; i++) {
+        if (strcmp(type->fields[i].name, field->data.strVal) == 0) {
+            return &type->fields[i];
+        }
+    }
+    return NULL;
+}
+
+static MoonValue* ffi_load(FFITypeKind kind, void* p) {
+    switch (kind) {
+        case FFI_INT8:   return moon_int(*(int8_t*)p);
+        case FFI_UINT8:  return moon_int(*(uint8_t*)p);
+        case FFI_INT16:  return moon_int(*(int16_t*)p);
+        case FFI_UINT16: return moon_int(*(uint16_t*)p);
+        case FFI_INT32:  return moon_int(*(int32_t*)p);
+        case FFI_UINT32: return moon_int(*(uint32_t*)p);
+        case FFI_INT64:
+        case FFI_UINT64: return moon_int(*(int64_t*)p);
+        case FFI_FLOAT:  return moon_float(*(float*)p);
+        case FFI_DOUBLE: return moon_float(*(double*)p);
+        case FFI_PTR:
+        case FFI_POINTER:
+            return moon_int((int64_t)(uintptr_t)*(void**)p);
+        case FFI_CSTR: {
+            char* str = *(char**)p;
+            return str ? moon_string(str) : moon_string("");
+        }
+        case FFI_STRUCT:
+        case FFI_ARRAY:
+            return moon_int((int64_t)(uintptr_t)p);
+        default:
+            return moon_null();
+    }
+}
+
+static void ffi_store(FFITypeKind kind, void* p, MoonValue* value) {
+    switch (kind) {
+        case FFI_INT8:   *(int8_t*)p = (int8_t)moon_to_int(value); break;
+        case FFI_UINT8:  *(uint8_t*)p = (uint8_t)moon_to_int(value); break;
+        case FFI_INT16:  *(int16_t*)p = (int16_t)moon_to_int(value); break;
+        case FFI_UINT16: *(uint16_t*)p = (uint16_t)moon_to_int(value); break;
+        case FFI_INT32:  *(int32_t*)p = (int32_t)moon_to_int(value); break;
+        case FFI_UINT32: *(uint32_t*)p = (uint32_t)moon_to_int(value); break;
+        case FFI_INT64:  *(int64_t*)p = moon_to_int(value); break;
+        case FFI_UINT64: *(uint64_t*)p = (uint64_t)moon_to_int(value); break;
+        case FFI_FLOAT:  *(float*)p = (float)moon_to_float(value); break;
+        case FFI_DOUBLE: *(double*)p = moon_to_float(value); break;
+        case FFI_PTR:
+        case FFI_POINTER:
+            *(void**)p = (void*)(uintptr_t)moon_to_int(value);
+            break;
+        case FFI_CSTR:
+            if (moon_is_string(value)) {
+                // Not copied, same as ffi_set
+                *(char**)p = value->data.strVal;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// Resolve a field accessor: ffi_field(type, field)
+MoonValue* moon_ffi_field(MoonValue* typeVal, MoonValue* field) {
+    if (!g_ffiInitialized) moon_ffi_init();
+    
+    FFIField* f = ffi_lookup_field(typeVal, field);
+    if (!f) return moon_null();
+    
+    FFIType* fieldType = ffi_get_type(f->typeId);
+    if (!fieldType) return moon_null();
+    
+    return moon_int(FFI_FIELD_HANDLE(fieldType->kind, f->offset));
+}
+
+// Read through an accessor: ffi_field_get(ptr, field)
+MoonValue* moon_ffi_field_get(MoonValue* ptr, MoonValue* field) {
+    void* p = (void*)(uintptr_t)moon_to_int(ptr);
+    int64_t h = moon_to_int(field);
+    if (!p || !FFI_FIELD_IS_HANDLE(h)) return moon_null();
+    
+    return ffi_load(FFI_FIELD_KIND(h), (char*)p + FFI_FIELD_OFFSET(h));
+}
+
+// Write through an accessor: ffi_field_set(ptr, field, value)
+void moon_ffi_field_set(MoonValue* ptr, MoonValue* field, MoonValue* value) {
+    void* p = (void*)(uintptr_t)moon_to_int(ptr);
+    int64_t h = moon_to_int(field);
+    if (!p || !FFI_FIELD_IS_HANDLE(h)) return;
+    
+    ffi_store(FFI_FIELD_KIND(h), (char*)p + FFI_FIELD_OFFSET(h), value);
+}
+
+// Read one field from each of count consecutive structs:
+// ffi_read_array(ptr, type, field, count), field is a name or an accessor
+MoonValue* moon_ffi_read_array(MoonValue* ptr, MoonValue* typeVal, MoonValue* field, MoonValue* count) {
+    if (!g_ffiInitialized) moon_ffi_init();
+    
+    char* p = (char*)(uintptr_t)moon_to_int(ptr);
+    int64_t n = moon_to_int(count);
+    if (!p || n < 0) return moon_list_new();
+    
+    int typeId = moon_is_string(typeVal) ? ffi_get_type_id(typeVal->data.strVal)
+                                         : (int)moon_to_int(typeVal);
+    FFIType* type = ffi_get_type(typeId);
+    if (!type || type->kind != FFI_STRUCT) return moon_list_new();
+    
+    FFITypeKind kind;
+    size_t offset;
+    if (moon_is_string(field)) {
+        FFIField* f = ffi_lookup_field(typeVal, field);
+        FFIType* fieldType = f ? ffi_get_type(f->typeId) : NULL;
+        if (!fieldType) return moon_list_new();
+        kind = fieldType->kind;
+        offset = f->offset;
+    } else {
+        int64_t h = moon_to_int(field);
+        if (!FFI_FIELD_IS_HANDLE(h)) return moon_list_new();
+        kind = FFI_FIELD_KIND(h);
+        offset = FFI_FIELD_OFFSET(h);
+    }
+    
+    MoonValue* result = moon_list_new();
+    if (n == 0) return result;
+    
+    MoonList* lst = result->data.listVal;
+    lst->items = (MoonValue**)moon_realloc_typed(MOON_MEM_LIST, lst->items, sizeof(MoonValue*) * n);
+    lst->capacity = (int32_t)n;
+    
+    // One switch for the whole column rather than one per element
+    p += offset;
+    size_t stride = type->size;
+    MoonValue** out = lst->items;
+    switch (kind) {
+        case FFI_INT32:
+            for (int64_t i = 0; i < n; i++, p += stride) out[i] = moon_int(*(int32_t*)p);
+            break;
+        case FFI_INT64:
+        case FFI_UINT64:
+            for (int64_t i = 0; i < n; i++, p += stride) out[i] = moon_int(*(int64_t*)p);
+            break;
+        case FFI_FLOAT:
+            for (int64_t i = 0; i < n; i++, p += stride) out[i] = moon_float(*(float*)p);
+            break;
+        case FFI_DOUBLE:
+            for (int64_t i = 0; i < n; i++, p += stride) out[i] = moon_float(*(double*)p);
+            break;
+        default:
+            for (int64_t i = 0; i < n; i++, p += stride) out[i] = ffi_load(kind, p);
+            break;
+    }
+    lst->length = (int32_t)n;
+    
+    return result;
+}
+
 // ============================================================================
 // Array Access
 // ============================================================================
@@ -1009,6 +1201,10 @@ MoonValue* moon_ffi_offsetof(MoonValue* typeVal, MoonValue* field) { return moon
 MoonValue* moon_ffi_alignof(MoonValue* typeVal) { return moon_int(0); }
 MoonValue* moon_ffi_get(MoonValue* ptr, MoonValue* typeVal, MoonValue* field) { return moon_null(); }
 void moon_ffi_set(MoonValue* ptr, MoonValue* typeVal, MoonValue* field, MoonValue* value) {}
+MoonValue* moon_ffi_field(MoonValue* typeVal, MoonValue* field) { return moon_null(); }
+MoonValue* moon_ffi_field_get(MoonValue* ptr, MoonValue* field) { return moon_null(); }
+void moon_ffi_field_set(MoonValue* ptr, MoonValue* field, MoonValue* value) {}
+MoonValue* moon_ffi_read_array(MoonValue* ptr, MoonValue* typeVal, MoonValue* field, MoonValue* count) { return moon_list_new(); }
 MoonValue* moon_ffi_array_get(MoonValue* ptr, MoonValue* typeVal, MoonValue* index) { return moon_null(); }
 void moon_ffi_array_set(MoonValue* ptr, MoonValue* typeVal, MoonValue* index, MoonValue* value) {}
 MoonValue* moon_ffi_cast(MoonValue* ptr, MoonValue* typeVal) { return ptr; }
@@ -78,6 +78,19 @@ typedef struct FFIType {
     int returnTypeId;   // Return type ID
 } FFIType;
 
+// ============================================================================
+// FFI Field Accessor (handle returned by ffi_field)
+// ============================================================================
+// Field kind and byte offset packed into one integer, so accesses through a
+// handle need no registry or name lookup. The compiler folds constant
+// ffi_field calls to the same value.
+
+#define FFI_FIELD_TAG              0x4646000000000000LL
+#define FFI_FIELD_HANDLE(kind, off) (FFI_FIELD_TAG | ((int64_t)(kind) << 40) | (int64_t)(off))
+#define FFI_FIELD_IS_HANDLE(h)     (((h) & (int64_t)0xFFFF000000000000ULL) == FFI_FIELD_TAG)
+#define FFI_FIELD_KIND(h)          ((FFITypeKind)(((h) >> 40) & 0xFF))
+#define FFI_FIELD_OFFSET(h)        ((size_t)((h) & 0xFFFFFFFFFFLL))
+
 // ============================================================================
 // FFI Instance (allocated struct/array instance)
 // ============================================================================
@@ -121,6 +134,9 @@ FFIType* ffi_get_type_by_name(const char* name);
 // Get type ID by name
 int ffi_get_type_id(const char* name);
 
+// Register a callback signature; a named one can be passed to ffi_callback by name
+int ffi_register_callback_type(const char* name, const int* paramTypeIds, int paramCount, int returnTypeId);
+
 // ============================================================================
 // MoonLang FFI Functions (exposed to MoonLang)
 // ============================================================================
@@ -161,6 +177,18 @@ MoonValue* moon_ffi_get(MoonValue* ptr, MoonValue* typeVal, MoonValue* field);
 // FFI.set(ptr, type, field, value) - Set field value
 void moon_ffi_set(MoonValue* ptr, MoonValue* typeVal, MoonValue* field, MoonValue* value);
 
+// FFI.field(type, field) - Resolve a field accessor handle
+MoonValue* moon_ffi_field(MoonValue* typeVal, MoonValue* field);
+
+// FFI.field_get(ptr, field) - Get field value through an accessor
+MoonValue* moon_ffi_field_get(MoonValue* ptr, MoonValue* field);
+
+// FFI.field_set(ptr, field, value) - Set field value through an accessor
+void moon_ffi_field_set(MoonValue* ptr, MoonValue* field, MoonValue* value);
+
+// FFI.read_array(ptr, type, field, count) - Read one field from count structs
+MoonValue* moon_ffi_read_array(MoonValue* ptr, MoonValue* typeVal, MoonValue* field, MoonValue* count);
+
 // Array access
 // FFI.array_get(ptr, type, index) - Get array element
 MoonValue* moon_ffi_array_get(MoonValue* ptr, MoonValue* typeVal, MoonValue* index);
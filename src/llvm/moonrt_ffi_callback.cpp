@@ -2,7 +2,10 @@
 // Copyright (c) 2026 greenteng.com
 //
 // Implements callback functions that allow C code to call MoonLang functions.
-// Uses platform-specific thunks to bridge the calling conventions.
+// Each callback gets a thunk generated for its signature: the thunk spills
+// the argument registers into a frame and calls the dispatcher with its own
+// callback entry, whose precomputed plan says where each argument lives and
+// how to box it. No registry lookup or type-table walk happens per call.
 
 #include "moonrt_core.h"
 #include "moonrt_ffi.h"
@@ -21,127 +24,231 @@
 // ============================================================================
 // Callback Registry
 // ============================================================================
+//
+// Entries live in chunks that double in size (64, 128, 256, ...) and are
+// never moved or freed, so an index or entry pointer stays valid for the
+// life of the process. Fresh slots come from an atomic counter; freed slots
+// go onto a lock-free stack and are reused together with their thunk memory.
 
-#define MAX_CALLBACKS 256
+#define CALLBACK_MAX_ARGS 16
+#define CALLBACK_THUNK_SIZE 128
+#define CALLBACK_FIRST_CHUNK_BITS 6
+#define CALLBACK_MAX_CHUNKS 25
 
 typedef struct {
     MoonValue* func;            // MoonLang function
+    MoonFunc direct;            // Native entry point when func is a plain function
     int typeId;                 // Callback type ID
-    void* thunk;                // Native thunk code
-    size_t thunkSize;           // Thunk code size
-    bool active;                // Is this slot in use?
+    int index;                  // Slot index
+    void* thunk;                // Native thunk code (owned by the chunk)
+    int argc;
+    uint8_t argKind[CALLBACK_MAX_ARGS];     // FFITypeKind of each parameter
+    int8_t argLoc[CALLBACK_MAX_ARGS];       // >= 0: frame slot, < 0: stack slot -(n+1)
+    uint8_t retKind;            // FFITypeKind of the return value
+    int nextFree;               // Next index on the free stack (-1 = end)
+    volatile int32_t active;    // Is this slot in use?
 } CallbackEntry;
 
-static CallbackEntry g_callbacks[MAX_CALLBACKS];
-static int g_callbackCount = 0;
-static bool g_callbacksInitialized = false;
+typedef struct {
+    CallbackEntry* entries;
+    uint8_t* code;
+    size_t codeSize;
+} CallbackChunk;
 
-// ============================================================================
-// Thunk Dispatcher
-// ============================================================================
+static CallbackChunk* volatile g_chunks[CALLBACK_MAX_CHUNKS];
+static volatile int32_t g_nextIndex = 0;
+static volatile int64_t g_freeHead = 0;     // (tag << 32) | (index + 1), 0 = empty
+static volatile int32_t g_callbackCount = 0;
+
+#ifdef _WIN32
+static bool cb_cas_ptr(void* volatile* target, void* expected, void* desired) {
+    return InterlockedCompareExchangePointer(target, desired, expected) == expected;
+}
+static bool cb_cas64(volatile int64_t* target, int64_t expected, int64_t desired) {
+    return InterlockedCompareExchange64((volatile LONG64*)target, desired, expected) == expected;
+}
+static int32_t cb_add32(volatile int32_t* target, int32_t delta) {
+    return InterlockedExchangeAdd((volatile long*)target, delta) + delta;
+}
+static int32_t cb_exchange32(volatile int32_t* target, int32_t value) {
+    return InterlockedExchange((volatile long*)target, value);
+}
+#else
+static bool cb_cas_ptr(void* volatile* target, void* expected, void* desired) {
+    return __atomic_compare_exchange_n(target, &expected, desired, false,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+static bool cb_cas64(volatile int64_t* target, int64_t expected, int64_t desired) {
+    return __atomic_compare_exchange_n(target, &expected, desired, false,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+static int32_t cb_add32(volatile int32_t* target, int32_t delta) {
+    return __atomic_add_fetch(target, delta, __ATOMIC_SEQ_CST);
+}
+static int32_t cb_exchange32(volatile int32_t* target, int32_t value) {
+    return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+#endif
 
-// This is the actual dispatcher function called by the thunk.
-// It receives the callback index and arguments, then calls the MoonLang function.
-extern "C" int64_t ffi_callback_dispatch(int callbackIndex, int64_t* args) {
-    if (callbackIndex < 0 || callbackIndex >= MAX_CALLBACKS) {
-        return 0;
+static void* allocExecutableMemory(size_t size);
+static void freeExecutableMemory(void* ptr, size_t size);
+
+// Chunk k holds 64 << k entries starting at index (64 << k) - 64
+static int chunkOf(int index, int* offset) {
+    uint32_t j = (uint32_t)index + (1u << CALLBACK_FIRST_CHUNK_BITS);
+    int k = 0;
+    while ((j >> (k + CALLBACK_FIRST_CHUNK_BITS + 1)) != 0) k++;
+    *offset = (int)(j - (1u << (k + CALLBACK_FIRST_CHUNK_BITS)));
+    return k;
+}
+
+static CallbackChunk* getChunk(int k, bool create) {
+    CallbackChunk* chunk = g_chunks[k];
+    if (chunk || !create) return chunk;
+
+    size_t count = (size_t)1 << (k + CALLBACK_FIRST_CHUNK_BITS);
+    chunk = (CallbackChunk*)calloc(1, sizeof(CallbackChunk));
+    if (!chunk) return NULL;
+    chunk->entries = (CallbackEntry*)calloc(count, sizeof(CallbackEntry));
+    chunk->codeSize = count * CALLBACK_THUNK_SIZE;
+    chunk->code = (uint8_t*)allocExecutableMemory(chunk->codeSize);
+    if (!chunk->entries || !chunk->code) {
+        if (chunk->code) freeExecutableMemory(chunk->code, chunk->codeSize);
+        free(chunk->entries);
+        free(chunk);
+        return NULL;
     }
-    
-    CallbackEntry* entry = &g_callbacks[callbackIndex];
-    if (!entry->active || !entry->func) {
-        return 0;
+    int base = (int)(count - (1u << CALLBACK_FIRST_CHUNK_BITS));
+    for (size_t i = 0; i < count; i++) {
+        chunk->entries[i].index = base + (int)i;
+        chunk->entries[i].thunk = chunk->code + i * CALLBACK_THUNK_SIZE;
     }
-    
-    // Get callback type info
-    FFIType* type = ffi_get_type(entry->typeId);
-    if (!type || type->kind != FFI_CALLBACK) {
-        return 0;
+
+    // Another thread may have installed the chunk first
+    if (!cb_cas_ptr((void* volatile*)&g_chunks[k], NULL, chunk)) {
+        freeExecutableMemory(chunk->code, chunk->codeSize);
+        free(chunk->entries);
+        free(chunk);
+        chunk = g_chunks[k];
     }
-    
-    // Convert C arguments to MoonValues
-    int argc = type->paramCount;
-    MoonValue** moonArgs = (MoonValue**)malloc(argc * sizeof(MoonValue*));
-    
-    for (int i = 0; i < argc && i < 8; i++) {
-        int paramTypeId = type->paramTypeIds[i];
-        FFIType* paramType = ffi_get_type(paramTypeId);
-        
-        if (!paramType) {
-            moonArgs[i] = moon_int(args[i]);
-            continue;
-        }
-        
-        switch (paramType->kind) {
-            case FFI_INT8:
-            case FFI_INT16:
-            case FFI_INT32:
-            case FFI_INT64:
-            case FFI_UINT8:
-            case FFI_UINT16:
-            case FFI_UINT32:
-            case FFI_UINT64:
-            case FFI_PTR:
-            case FFI_POINTER:
-                moonArgs[i] = moon_int(args[i]);
-                break;
-            case FFI_FLOAT:
-                // Float in integer register
-                moonArgs[i] = moon_float(*(float*)&args[i]);
+    return chunk;
+}
+
+static CallbackEntry* getEntry(int index) {
+    if (index < 0) return NULL;
+    int offset;
+    int k = chunkOf(index, &offset);
+    if (k >= CALLBACK_MAX_CHUNKS) return NULL;
+    CallbackChunk* chunk = getChunk(k, false);
+    return chunk ? &chunk->entries[offset] : NULL;
+}
+
+static CallbackEntry* acquireEntry() {
+    // Reuse a freed slot; the tag makes a concurrent pop/push cycle visible
+    for (;;) {
+        int64_t head = g_freeHead;
+        int index = (int)(head & 0xFFFFFFFF) - 1;
+        if (index < 0) break;
+        CallbackEntry* entry = getEntry(index);
+        uint64_t tag = ((uint64_t)head >> 32) + 1;
+        int64_t next = (int64_t)((tag << 32) | (uint32_t)(entry->nextFree + 1));
+        if (cb_cas64(&g_freeHead, head, next)) return entry;
+    }
+
+    int index = cb_add32(&g_nextIndex, 1) - 1;
+    if (index < 0) return NULL;
+    int offset;
+    int k = chunkOf(index, &offset);
+    if (k >= CALLBACK_MAX_CHUNKS) return NULL;
+    CallbackChunk* chunk = getChunk(k, true);
+    return chunk ? &chunk->entries[offset] : NULL;
+}
+
+static void releaseEntry(CallbackEntry* entry) {
+    for (;;) {
+        int64_t head = g_freeHead;
+        entry->nextFree = (int)(head & 0xFFFFFFFF) - 1;
+        uint64_t tag = ((uint64_t)head >> 32) + 1;
+        int64_t next = (int64_t)((tag << 32) | (uint32_t)(entry->index + 1));
+        if (cb_cas64(&g_freeHead, head, next)) return;
+    }
+}
+
+// ============================================================================
+// Thunk Dispatcher
+// ============================================================================
+
+// Called by every thunk with its own entry and the spilled argument frame.
+// Returns the result bits; the thunk moves them to XMM0 for float returns.
+static int64_t ffi_callback_invoke(CallbackEntry* entry, int64_t* frame, int64_t* stack) {
+    if (!entry->active) return 0;
+
+    int argc = entry->argc;
+    MoonValue* moonArgs[CALLBACK_MAX_ARGS];
+
+    for (int i = 0; i < argc; i++) {
+        int loc = entry->argLoc[i];
+        int64_t raw = loc >= 0 ? frame[loc] : stack[-loc - 1];
+
+        switch (entry->argKind[i]) {
+            case FFI_INT8:   moonArgs[i] = moon_int((int8_t)raw); break;
+            case FFI_UINT8:  moonArgs[i] = moon_int((uint8_t)raw); break;
+            case FFI_INT16:  moonArgs[i] = moon_int((int16_t)raw); break;
+            case FFI_UINT16: moonArgs[i] = moon_int((uint16_t)raw); break;
+            case FFI_INT32:  moonArgs[i] = moon_int((int32_t)raw); break;
+            case FFI_UINT32: moonArgs[i] = moon_int((uint32_t)raw); break;
+            case FFI_FLOAT: {
+                float f;
+                memcpy(&f, &raw, sizeof(f));
+                moonArgs[i] = moon_float(f);
                 break;
-            case FFI_DOUBLE:
-                moonArgs[i] = moon_float(*(double*)&args[i]);
+            }
+            case FFI_DOUBLE: {
+                double d;
+                memcpy(&d, &raw, sizeof(d));
+                moonArgs[i] = moon_float(d);
                 break;
+            }
             case FFI_CSTR:
-                moonArgs[i] = args[i] ? moon_string((char*)args[i]) : moon_string("");
+                moonArgs[i] = moon_string(raw ? (const char*)(intptr_t)raw : "");
                 break;
             default:
-                moonArgs[i] = moon_int(args[i]);
+                moonArgs[i] = moon_int(raw);
                 break;
         }
     }
-    
-    // Call the MoonLang function
-    MoonValue* result = moon_call_func(entry->func, moonArgs, argc);
-    
+
+    // Plain functions are called directly; closures need their captures set
+    MoonValue* result = entry->direct ? entry->direct(moonArgs, argc)
+                                      : moon_call_func(entry->func, moonArgs, argc);
+
+    for (int i = 0; i < argc; i++) {
+        moon_release(moonArgs[i]);
+    }
+
     // Convert result back to C
     int64_t retVal = 0;
     if (result) {
-        FFIType* retType = ffi_get_type(type->returnTypeId);
-        if (retType) {
-            switch (retType->kind) {
-                case FFI_INT8:
-                case FFI_INT16:
-                case FFI_INT32:
-                case FFI_INT64:
-                case FFI_UINT8:
-                case FFI_UINT16:
-                case FFI_UINT32:
-                case FFI_UINT64:
-                case FFI_PTR:
-                case FFI_POINTER:
-                    retVal = moon_to_int(result);
-                    break;
-                case FFI_FLOAT:
-                case FFI_DOUBLE:
-                    {
-                        double d = moon_to_float(result);
-                        retVal = *(int64_t*)&d;
-                    }
-                    break;
-                default:
-                    retVal = moon_to_int(result);
-                    break;
+        switch (entry->retKind) {
+            case FFI_VOID:
+                break;
+            case FFI_FLOAT: {
+                float f = (float)moon_to_float(result);
+                memcpy(&retVal, &f, sizeof(f));
+                break;
+            }
+            case FFI_DOUBLE: {
+                double d = moon_to_float(result);
+                memcpy(&retVal, &d, sizeof(d));
+                break;
             }
+            default:
+                retVal = moon_to_int(result);
+                break;
         }
         moon_release(result);
     }
-    
-    // Release MoonLang arguments
-    for (int i = 0; i < argc; i++) {
-        moon_release(moonArgs[i]);
-    }
-    free(moonArgs);
-    
+
     return retVal;
 }
 
@@ -149,11 +256,43 @@ extern "C" int64_t ffi_callback_dispatch(int callbackIndex, int64_t* args) {
 // Thunk Generation (Platform-Specific)
 // ============================================================================
 
+typedef struct {
+    uint8_t* p;
+} ThunkWriter;
+
+static void emit(ThunkWriter* w, const uint8_t* bytes, size_t n) {
+    memcpy(w->p, bytes, n);
+    w->p += n;
+}
+
+static void emit64(ThunkWriter* w, uint64_t value) {
+    memcpy(w->p, &value, sizeof(value));
+    w->p += sizeof(value);
+}
+
+// mov [rsp+disp], reg64
+static void emitStoreGpr(ThunkWriter* w, int reg, uint8_t disp) {
+    uint8_t code[] = { (uint8_t)(0x48 | (reg >= 8 ? 0x04 : 0)), 0x89,
+                       (uint8_t)(0x44 | ((reg & 7) << 3)), 0x24, disp };
+    emit(w, code, sizeof(code));
+}
+
+// movsd [rsp+disp], xmmN
+static void emitStoreXmm(ThunkWriter* w, int reg, uint8_t disp) {
+    uint8_t code[] = { 0xF2, 0x0F, 0x11, (uint8_t)(0x44 | (reg << 3)), 0x24, disp };
+    emit(w, code, sizeof(code));
+}
+
+static bool isFloatKind(int kind) {
+    return kind == FFI_FLOAT || kind == FFI_DOUBLE;
+}
+
 #ifdef _WIN32
 // Windows x64 thunk
 // Uses Microsoft x64 calling convention:
-// - First 4 args in RCX, RDX, R8, R9
-// - Return value in RAX
+// - Argument i < 4 in RCX, RDX, R8, R9 or XMM0-3 by position
+// - Further arguments on the stack above the 32-byte home area
+// - Return value in RAX or XMM0
 
 static void* allocExecutableMemory(size_t size) {
     return VirtualAlloc(NULL, size, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
@@ -163,73 +302,68 @@ static void freeExecutableMemory(void* ptr, size_t size) {
     VirtualFree(ptr, 0, MEM_RELEASE);
 }
 
-static void* createThunk(int callbackIndex) {
-    // Thunk code (Windows x64):
-    // Save arguments to stack buffer
-    // Load callback index into first arg (RCX)
-    // Load args array pointer into second arg (RDX)
-    // Call ffi_callback_dispatch
-    // Return
-    
-    // Simplified thunk that saves first 4 args and calls dispatcher
-    uint8_t code[] = {
-        // sub rsp, 88 (allocate stack space for args + alignment)
-        0x48, 0x83, 0xEC, 0x58,
-        
-        // Save incoming arguments to stack buffer
-        // mov [rsp+32], rcx
-        0x48, 0x89, 0x4C, 0x24, 0x20,
-        // mov [rsp+40], rdx
-        0x48, 0x89, 0x54, 0x24, 0x28,
-        // mov [rsp+48], r8
-        0x4C, 0x89, 0x44, 0x24, 0x30,
-        // mov [rsp+56], r9
-        0x4C, 0x89, 0x4C, 0x24, 0x38,
-        
-        // Load callback index into ecx (first arg)
-        // mov ecx, <index>
-        0xB9, 0x00, 0x00, 0x00, 0x00,
-        
-        // Load args array pointer into rdx (second arg)
-        // lea rdx, [rsp+32]
-        0x48, 0x8D, 0x54, 0x24, 0x20,
-        
-        // mov rax, <dispatcher address>
-        0x48, 0xB8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-        
-        // call rax
-        0xFF, 0xD0,
-        
-        // add rsp, 88
-        0x48, 0x83, 0xC4, 0x58,
-        
-        // ret
-        0xC3
-    };
-    
-    size_t codeSize = sizeof(code);
-    
-    // Patch callback index (offset 25)
-    *(int32_t*)(code + 25) = callbackIndex;
-    
-    // Patch dispatcher address (offset 35)
-    *(uint64_t*)(code + 35) = (uint64_t)&ffi_callback_dispatch;
-    
-    // Allocate executable memory
-    void* thunk = allocExecutableMemory(codeSize);
-    if (!thunk) return NULL;
-    
-    // Copy code
-    memcpy(thunk, code, codeSize);
-    
-    return thunk;
+// Frame: [0..3] integer registers, [4..7] XMM registers
+static void planArguments(CallbackEntry* entry) {
+    for (int i = 0; i < entry->argc; i++) {
+        if (i < 4) {
+            entry->argLoc[i] = (int8_t)(isFloatKind(entry->argKind[i]) ? 4 + i : i);
+        } else {
+            entry->argLoc[i] = (int8_t)(-(i - 4) - 1);
+        }
+    }
+}
+
+static bool writeThunk(CallbackEntry* entry) {
+    static const int gprs[4] = { 1, 2, 8, 9 };     // rcx, rdx, r8, r9
+    ThunkWriter w = { (uint8_t*)entry->thunk };
+
+    // push rbp; mov rbp, rsp; sub rsp, 112 (home area + 64-byte frame)
+    const uint8_t prologue[] = { 0x55, 0x48, 0x89, 0xE5, 0x48, 0x83, 0xEC, 0x70 };
+    emit(&w, prologue, sizeof(prologue));
+
+    // Spill only the registers this signature uses
+    for (int i = 0; i < entry->argc && i < 4; i++) {
+        if (isFloatKind(entry->argKind[i])) {
+            emitStoreXmm(&w, i, (uint8_t)(64 + i * 8));
+        } else {
+            emitStoreGpr(&w, gprs[i], (uint8_t)(32 + i * 8));
+        }
+    }
+
+    // mov rcx, entry; lea rdx, [rsp+32]; lea r8, [rbp+48]
+    const uint8_t movRcx[] = { 0x48, 0xB9 };
+    emit(&w, movRcx, sizeof(movRcx));
+    emit64(&w, (uint64_t)(uintptr_t)entry);
+    const uint8_t leaArgs[] = { 0x48, 0x8D, 0x54, 0x24, 0x20, 0x4C, 0x8D, 0x45, 0x30 };
+    emit(&w, leaArgs, sizeof(leaArgs));
+
+    // mov rax, ffi_callback_invoke; call rax
+    const uint8_t movRax[] = { 0x48, 0xB8 };
+    emit(&w, movRax, sizeof(movRax));
+    emit64(&w, (uint64_t)(uintptr_t)&ffi_callback_invoke);
+    const uint8_t callRax[] = { 0xFF, 0xD0 };
+    emit(&w, callRax, sizeof(callRax));
+
+    // movq xmm0, rax for float/double returns
+    if (isFloatKind(entry->retKind)) {
+        const uint8_t movq[] = { 0x66, 0x48, 0x0F, 0x6E, 0xC0 };
+        emit(&w, movq, sizeof(movq));
+    }
+
+    // leave; ret
+    const uint8_t epilogue[] = { 0xC9, 0xC3 };
+    emit(&w, epilogue, sizeof(epilogue));
+
+    FlushInstructionCache(GetCurrentProcess(), entry->thunk, CALLBACK_THUNK_SIZE);
+    return true;
 }
 
 #else
 // Linux/macOS x64 thunk
 // Uses System V AMD64 calling convention:
-// - First 6 integer args in RDI, RSI, RDX, RCX, R8, R9
-// - Return value in RAX
+// - Integer args in RDI, RSI, RDX, RCX, R8, R9; float args in XMM0-7
+// - Remaining args on the stack in order
+// - Return value in RAX or XMM0
 
 static void* allocExecutableMemory(size_t size) {
     void* ptr = mmap(NULL, size, PROT_READ | PROT_WRITE | PROT_EXEC,
@@ -241,74 +375,62 @@ static void freeExecutableMemory(void* ptr, size_t size) {
     munmap(ptr, size);
 }
 
-static void* createThunk(int callbackIndex) {
-    // Thunk code (Linux/macOS x64 System V ABI):
-    // Save arguments to stack buffer
-    // Load callback index into first arg (RDI)
-    // Load args array pointer into second arg (RSI)
-    // Call ffi_callback_dispatch
-    // Return
-    
-    uint8_t code[] = {
-        // push rbp
-        0x55,
-        // mov rbp, rsp
-        0x48, 0x89, 0xE5,
-        // sub rsp, 80 (allocate stack space for args + alignment)
-        0x48, 0x83, 0xEC, 0x50,
-        
-        // Save incoming arguments to stack buffer (first 6 args)
-        // mov [rsp], rdi
-        0x48, 0x89, 0x3C, 0x24,
-        // mov [rsp+8], rsi
-        0x48, 0x89, 0x74, 0x24, 0x08,
-        // mov [rsp+16], rdx
-        0x48, 0x89, 0x54, 0x24, 0x10,
-        // mov [rsp+24], rcx
-        0x48, 0x89, 0x4C, 0x24, 0x18,
-        // mov [rsp+32], r8
-        0x4C, 0x89, 0x44, 0x24, 0x20,
-        // mov [rsp+40], r9
-        0x4C, 0x89, 0x4C, 0x24, 0x28,
-        
-        // Load callback index into edi (first arg)
-        // mov edi, <index>
-        0xBF, 0x00, 0x00, 0x00, 0x00,
-        
-        // Load args array pointer into rsi (second arg)
-        // mov rsi, rsp
-        0x48, 0x89, 0xE6,
-        
-        // mov rax, <dispatcher address>
-        0x48, 0xB8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-        
-        // call rax
-        0xFF, 0xD0,
-        
-        // add rsp, 80
-        0x48, 0x83, 0xC4, 0x50,
-        // pop rbp
-        0x5D,
-        // ret
-        0xC3
-    };
-    
-    size_t codeSize = sizeof(code);
-    
-    // Patch callback index (offset 37)
-    *(int32_t*)(code + 37) = callbackIndex;
-    
-    // Patch dispatcher address (offset 45)
-    *(uint64_t*)(code + 45) = (uint64_t)&ffi_callback_dispatch;
-    
-    // Allocate executable memory
-    void* thunk = allocExecutableMemory(codeSize);
-    if (!thunk) return NULL;
-    
-    // Copy code
-    memcpy(thunk, code, codeSize);
-    
-    return thunk;
+// Frame: [0..5] integer registers, [6..13] XMM registers
+static void planArguments(CallbackEntry* entry) {
+    int gpr = 0, xmm = 0, stack = 0;
+    for (int i = 0; i < entry->argc; i++) {
+        if (isFloatKind(entry->argKind[i]) && xmm < 8) {
+            entry->argLoc[i] = (int8_t)(6 + xmm++);
+        } else if (!isFloatKind(entry->argKind[i]) && gpr < 6) {
+            entry->argLoc[i] = (int8_t)gpr++;
+        } else {
+            entry->argLoc[i] = (int8_t)(-stack++ - 1);
+        }
+    }
+}
+
+static bool writeThunk(CallbackEntry* entry) {
+    static const int gprs[6] = { 7, 6, 2, 1, 8, 9 };   // rdi, rsi, rdx, rcx, r8, r9
+    ThunkWriter w = { (uint8_t*)entry->thunk };
+
+    // push rbp; mov rbp, rsp; sub rsp, 112 (14-slot frame)
+    const uint8_t prologue[] = { 0x55, 0x48, 0x89, 0xE5, 0x48, 0x83, 0xEC, 0x70 };
+    emit(&w, prologue, sizeof(prologue));
+
+    // Spill only the registers this signature uses
+    for (int i = 0; i < entry->argc; i++) {
+        int loc = entry->argLoc[i];
+        if (loc >= 6) {
+            emitStoreXmm(&w, loc - 6, (uint8_t)(loc * 8));
+        } else if (loc >= 0) {
+            emitStoreGpr(&w, gprs[loc], (uint8_t)(loc * 8));
+        }
+    }
+
+    // mov rdi, entry; mov rsi, rsp; lea rdx, [rbp+16]
+    const uint8_t movRdi[] = { 0x48, 0xBF };
+    emit(&w, movRdi, sizeof(movRdi));
+    emit64(&w, (uint64_t)(uintptr_t)entry);
+    const uint8_t leaArgs[] = { 0x48, 0x89, 0xE6, 0x48, 0x8D, 0x55, 0x10 };
+    emit(&w, leaArgs, sizeof(leaArgs));
+
+    // mov rax, ffi_callback_invoke; call rax
+    const uint8_t movRax[] = { 0x48, 0xB8 };
+    emit(&w, movRax, sizeof(movRax));
+    emit64(&w, (uint64_t)(uintptr_t)&ffi_callback_invoke);
+    const uint8_t callRax[] = { 0xFF, 0xD0 };
+    emit(&w, callRax, sizeof(callRax));
+
+    // movq xmm0, rax for float/double returns
+    if (isFloatKind(entry->retKind)) {
+        const uint8_t movq[] = { 0x66, 0x48, 0x0F, 0x6E, 0xC0 };
+        emit(&w, movq, sizeof(movq));
+    }
+
+    // leave; ret
+    const uint8_t epilogue[] = { 0xC9, 0xC3 };
+    emit(&w, epilogue, sizeof(epilogue));
+    return true;
 }
 
 #endif // _WIN32
@@ -317,23 +439,12 @@ static void* createThunk(int callbackIndex) {
 // Callback Management
 // ============================================================================
 
-static void initCallbacks() {
-    if (g_callbacksInitialized) return;
-    
-    memset(g_callbacks, 0, sizeof(g_callbacks));
-    g_callbackCount = 0;
-    g_callbacksInitialized = true;
-}
-
 // Create a callback: FFI.callback_create(signature, func)
 MoonValue* moon_ffi_callback_create(MoonValue* signature, MoonValue* func) {
-    initCallbacks();
-    
-    if (g_callbackCount >= MAX_CALLBACKS) {
-        fprintf(stderr, "FFI: Maximum number of callbacks reached\n");
-        return moon_int(0);
-    }
-    
+#if !defined(__x86_64__) && !defined(_M_X64)
+    fprintf(stderr, "FFI: Callbacks are only supported on x86-64\n");
+    return moon_int(0);
+#else
     int typeId;
     if (moon_is_int(signature)) {
         typeId = (int)moon_to_int(signature);
@@ -342,66 +453,68 @@ MoonValue* moon_ffi_callback_create(MoonValue* signature, MoonValue* func) {
     } else {
         return moon_int(0);
     }
-    
+
     FFIType* type = ffi_get_type(typeId);
     if (!type || type->kind != FFI_CALLBACK) {
         fprintf(stderr, "FFI: Invalid callback type\n");
         return moon_int(0);
     }
-    
-    // Find a free slot
-    int index = -1;
-    for (int i = 0; i < MAX_CALLBACKS; i++) {
-        if (!g_callbacks[i].active) {
-            index = i;
-            break;
-        }
+    if (type->paramCount > CALLBACK_MAX_ARGS) {
+        fprintf(stderr, "FFI: Callbacks take at most %d parameters\n", CALLBACK_MAX_ARGS);
+        return moon_int(0);
     }
-    
-    if (index < 0) {
-        fprintf(stderr, "FFI: No free callback slots\n");
+    if (!func || (func->type != MOON_FUNC && func->type != MOON_CLOSURE)) {
+        fprintf(stderr, "FFI: Callback target is not a function\n");
         return moon_int(0);
     }
-    
-    // Create the thunk
-    void* thunk = createThunk(index);
-    if (!thunk) {
-        fprintf(stderr, "FFI: Failed to create callback thunk\n");
+
+    CallbackEntry* entry = acquireEntry();
+    if (!entry) {
+        fprintf(stderr, "FFI: Failed to allocate callback\n");
         return moon_int(0);
     }
-    
-    // Store the callback
-    g_callbacks[index].func = func;
-    g_callbacks[index].typeId = typeId;
-    g_callbacks[index].thunk = thunk;
-    g_callbacks[index].thunkSize = 128;  // Approximate
-    g_callbacks[index].active = true;
-    
+
+    // Resolve the signature once; calls only read this plan
+    entry->argc = type->paramCount;
+    for (int i = 0; i < type->paramCount; i++) {
+        FFIType* paramType = ffi_get_type(type->paramTypeIds[i]);
+        entry->argKind[i] = (uint8_t)(paramType ? paramType->kind : FFI_INT64);
+    }
+    FFIType* retType = ffi_get_type(type->returnTypeId);
+    entry->retKind = (uint8_t)(retType ? retType->kind : FFI_INT64);
+    planArguments(entry);
+
     moon_retain(func);
-    g_callbackCount++;
-    
+    entry->func = func;
+    entry->direct = func->type == MOON_FUNC ? func->data.funcVal : NULL;
+    entry->typeId = typeId;
+    writeThunk(entry);
+    cb_exchange32(&entry->active, 1);
+    cb_add32(&g_callbackCount, 1);
+
     // Return a dict with index and pointer
     MoonValue* result = moon_dict_new();
     MoonValue* keyPtr = moon_string("ptr");
     MoonValue* keyIdx = moon_string("index");
-    MoonValue* valPtr = moon_int((int64_t)(uintptr_t)thunk);
-    MoonValue* valIdx = moon_int(index);
-    
+    MoonValue* valPtr = moon_int((int64_t)(uintptr_t)entry->thunk);
+    MoonValue* valIdx = moon_int(entry->index);
+
     moon_dict_set(result, keyPtr, valPtr);
     moon_dict_set(result, keyIdx, valIdx);
-    
+
     moon_release(keyPtr);
     moon_release(keyIdx);
     moon_release(valPtr);
     moon_release(valIdx);
-    
+
     return result;
+#endif
 }
 
 // Free a callback: FFI.callback_free(callback)
 void moon_ffi_callback_free(MoonValue* callback) {
     int index = -1;
-    
+
     if (moon_is_int(callback)) {
         index = (int)moon_to_int(callback);
     } else if (moon_is_dict(callback)) {
@@ -411,47 +524,41 @@ void moon_ffi_callback_free(MoonValue* callback) {
         moon_release(key);
         moon_release(idxVal);
     }
-    
-    if (index < 0 || index >= MAX_CALLBACKS) {
-        return;
-    }
-    
-    CallbackEntry* entry = &g_callbacks[index];
-    if (!entry->active) {
+
+    CallbackEntry* entry = getEntry(index);
+    if (!entry || !cb_exchange32(&entry->active, 0)) {
         return;
     }
-    
-    // Free the thunk
-    if (entry->thunk) {
-        freeExecutableMemory(entry->thunk, entry->thunkSize);
-    }
-    
-    // Release the function
-    if (entry->func) {
-        moon_release(entry->func);
-    }
-    
-    // Clear the slot
-    memset(entry, 0, sizeof(CallbackEntry));
-    g_callbackCount--;
+
+    // The thunk memory stays with the slot for its next use
+    MoonValue* func = entry->func;
+    entry->func = NULL;
+    entry->direct = NULL;
+    moon_release(func);
+
+    cb_add32(&g_callbackCount, -1);
+    releaseEntry(entry);
 }
 
 // Cleanup all callbacks
 void ffi_callbacks_cleanup() {
-    for (int i = 0; i < MAX_CALLBACKS; i++) {
-        if (g_callbacks[i].active) {
-            CallbackEntry* entry = &g_callbacks[i];
-            if (entry->thunk) {
-                freeExecutableMemory(entry->thunk, entry->thunkSize);
-            }
-            if (entry->func) {
-                moon_release(entry->func);
+    for (int k = 0; k < CALLBACK_MAX_CHUNKS; k++) {
+        CallbackChunk* chunk = g_chunks[k];
+        if (!chunk) continue;
+        size_t count = (size_t)1 << (k + CALLBACK_FIRST_CHUNK_BITS);
+        for (size_t i = 0; i < count; i++) {
+            if (chunk->entries[i].active && chunk->entries[i].func) {
+                moon_release(chunk->entries[i].func);
             }
         }
+        freeExecutableMemory(chunk->code, chunk->codeSize);
+        free(chunk->entries);
+        free(chunk);
+        g_chunks[k] = NULL;
     }
-    memset(g_callbacks, 0, sizeof(g_callbacks));
+    g_nextIndex = 0;
+    g_freeHead = 0;
     g_callbackCount = 0;
-    g_callbacksInitialized = false;
 }
 
 #else // !MOON_HAS_FFI
@@ -260,6 +260,11 @@ private:
             moon_release(result);
         }
         
+        // typedef <ret> (*name)(<params>);
+        if (current.kind == TOK_LPAREN) {
+            return parseCallbackTypedef(baseTypeId);
+        }
+        
         // Get typedef name
         if (current.kind != TOK_IDENT) {
             lastError = "Expected identifier after typedef";
@@ -275,6 +280,53 @@ private:
         return true;
     }
     
+    bool parseCallbackTypedef(int returnTypeId) {
+        advance();  // consume '('
+        if (!expect(TOK_STAR)) return false;
+        if (current.kind != TOK_IDENT) {
+            lastError = "Expected callback type name";
+            return false;
+        }
+        std::string name = current.value;
+        advance();
+        if (!expect(TOK_RPAREN)) return false;
+        if (!expect(TOK_LPAREN)) return false;
+        
+        // Parameters are passed by value: pointers stay raw addresses,
+        // except char* which arrives as a string
+        std::vector<int> params;
+        while (current.kind != TOK_RPAREN && current.kind != TOK_EOF) {
+            int paramTypeId = parseType();
+            if (paramTypeId < 0) return false;
+            int stars = 0;
+            while (current.kind == TOK_STAR) {
+                stars++;
+                advance();
+            }
+            if (stars == 1 && (paramTypeId == FFI_INT8 || paramTypeId == FFI_UINT8)) {
+                paramTypeId = FFI_CSTR;
+            } else if (stars > 0) {
+                paramTypeId = FFI_PTR;
+            }
+            if (current.kind == TOK_IDENT) advance();  // Parameter name
+            
+            // (void) declares no parameters
+            if (!(paramTypeId == FFI_VOID && params.empty() && current.kind == TOK_RPAREN)) {
+                params.push_back(paramTypeId);
+            }
+            if (current.kind != TOK_COMMA) break;
+            advance();
+        }
+        if (!expect(TOK_RPAREN)) return false;
+        if (!expect(TOK_SEMICOLON)) return false;
+        
+        FFIType* retType = ffi_get_type(returnTypeId);
+        if (retType && retType->kind == FFI_POINTER) returnTypeId = FFI_PTR;
+        
+        return ffi_register_callback_type(name.c_str(), params.data(), (int)params.size(),
+                                          returnTypeId) >= 0;
+    }
+    
     bool parseStructTypedef() {
         advance();  // consume 'struct'
         
@@ -298,44 +350,52 @@ private:
         
         while (current.kind != TOK_RBRACE && current.kind != TOK_EOF) {
             // Parse field type
-            int fieldTypeId = parseType();
-            if (fieldTypeId < 0) return false;
+            int baseTypeId = parseType();
+            if (baseTypeId < 0) return false;
             
-            // Handle pointer types
-            while (current.kind == TOK_STAR) {
-                advance();
-                MoonValue* result = moon_ffi_pointer_type(moon_int(fieldTypeId));
-                fieldTypeId = (int)moon_to_int(result);
-                moon_release(result);
-            }
-            
-            // Field name
-            if (current.kind != TOK_IDENT) {
-                lastError = "Expected field name";
-                return false;
-            }
-            std::string fieldName = current.value;
-            advance();
-            
-            // Array dimension?
-            if (current.kind == TOK_LBRACKET) {
-                advance();
-                if (current.kind != TOK_NUMBER) {
-                    lastError = "Expected array size";
+            // One or more declarators: int x, *p, buf[4];
+            for (;;) {
+                int fieldTypeId = baseTypeId;
+                
+                // Handle pointer types
+                while (current.kind == TOK_STAR) {
+                    advance();
+                    MoonValue* result = moon_ffi_pointer_type(moon_int(fieldTypeId));
+                    fieldTypeId = (int)moon_to_int(result);
+                    moon_release(result);
+                }
+                
+                // Field name
+                if (current.kind != TOK_IDENT) {
+                    lastError = "Expected field name";
                     return false;
                 }
-                int arraySize = atoi(current.value.c_str());
+                std::string fieldName = current.value;
                 advance();
-                if (!expect(TOK_RBRACKET)) return false;
                 
-                // Create array type
-                MoonValue* result = moon_ffi_array_type(moon_int(fieldTypeId), moon_int(arraySize));
-                fieldTypeId = (int)moon_to_int(result);
-                moon_release(result);
+                // Array dimension?
+                if (current.kind == TOK_LBRACKET) {
+                    advance();
+                    if (current.kind != TOK_NUMBER) {
+                        lastError = "Expected array size";
+                        return false;
+                    }
+                    int arraySize = atoi(current.value.c_str());
+                    advance();
+                    if (!expect(TOK_RBRACKET)) return false;
+                    
+                    // Create array type
+                    MoonValue* result = moon_ffi_array_type(moon_int(fieldTypeId), moon_int(arraySize));
+                    fieldTypeId = (int)moon_to_int(result);
+                    moon_release(result);
+                }
+                
+                fields.push_back({fieldName, fieldTypeId});
+                
+                if (current.kind != TOK_COMMA) break;
+                advance();
             }
             
-            fields.push_back({fieldName, fieldTypeId});
-            
             if (!expect(TOK_SEMICOLON)) return false;
         }
         
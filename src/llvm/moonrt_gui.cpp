@@ -66,6 +66,8 @@ struct MoonWindow {
     // Callbacks
     MoonValue* messageCallback;
     MoonValue* closeCallback;
+    MoonValue* binaryCallback;           // gui_on_binary
+    bool asyncHandlers;                  // Run message handlers as coroutines
     
     // Exposed functions (callable from JS)
     std::unordered_map<std::string, MoonValue*> exposedFuncs;
@@ -83,6 +85,7 @@ struct MoonWindow {
         frameless(false), transparent(false), topmost(false),
         resizable(true), clickThrough(false), devtools(false), alpha(255),
         messageCallback(nullptr), closeCallback(nullptr),
+        binaryCallback(nullptr), asyncHandlers(false),
         pendingHtml(nullptr), pendingUrl(nullptr),
         parentId(0), modal(false), inSizeMove(false) {}
     
@@ -91,6 +94,7 @@ struct MoonWindow {
         if (pendingUrl) free(pendingUrl);
         if (messageCallback) moon_release(messageCallback);
         if (closeCallback) moon_release(closeCallback);
+        if (binaryCallback) moon_release(binaryCallback);
         for (auto& pair : exposedFuncs) {
             if (pair.second) moon_release(pair.second);
         }
@@ -125,7 +129,18 @@ static int g_dpi = 96;
 // Virtual file system for moon:// protocol
 static std::unordered_map<std::wstring, std::string> g_virtualFiles;
 
+// Scripts queued by gui_post_message/gui_post_binary, flushed on the UI thread
+struct MoonOutbox {
+    std::wstring script;
+    bool scheduled;
+    HWND hwnd;
+    MoonOutbox() : scheduled(false), hwnd(NULL) {}
+};
+static SRWLOCK g_outboxLock = SRWLOCK_INIT;
+static std::map<int, MoonOutbox> g_outbox;
+
 #define WM_TRAYICON (WM_USER + 1)
+#define WM_MOON_FLUSH (WM_USER + 2)
 #define IDM_TRAY_BASE 1000
 
 // ============================================================================
@@ -290,15 +305,167 @@ static void UpdateWebViewBounds(MoonWindow* win) {
     win->controller->NotifyParentWindowPositionChanged();
 }
 
+// ============================================================================
+// Message Bridge
+// ============================================================================
+// MoonGUI.queue() batches page messages into one "__batch__:" post per frame
+// (messages joined by '\n', with '\\' and '\n' escaped) and sendBinary()
+// posts "__bin__:" + base64. In the other direction gui_post_message and
+// gui_post_binary append to a per-window outbox that the window procedure
+// runs as a single script; they may be called from any thread.
+
+static void InvokeHandler(MoonWindow* win, MoonValue* callback, MoonValue** args, int argc) {
+    if (win->asyncHandlers) {
+        // The coroutine retains its arguments; the UI thread moves on
+        moon_async(callback, args, argc);
+    } else {
+        MoonValue* result = moon_call_func(callback, args, argc);
+        if (result) moon_release(result);
+    }
+    for (int i = 0; i < argc; i++) moon_release(args[i]);
+}
+
+static void DeliverBatch(MoonWindow* win, const char* batch) {
+    std::string msg;
+    for (const char* p = batch; ; p++) {
+        if (*p == '\n' || *p == '\0') {
+            MoonValue* args[2] = { moon_string(msg.c_str()), NULL };
+            InvokeHandler(win, win->messageCallback, args, 1);
+            msg.clear();
+            if (*p == '\0') break;
+        } else if (*p == '\\' && p[1]) {
+            p++;
+            msg += *p == 'n' ? '\n' : *p;
+        } else {
+            msg += *p;
+        }
+    }
+}
+
+static int Base64Value(wchar_t c) {
+    if (c >= L'A' && c <= L'Z') return c - L'A';
+    if (c >= L'a' && c <= L'z') return c - L'a' + 26;
+    if (c >= L'0' && c <= L'9') return c - L'0' + 52;
+    if (c == L'+') return 62;
+    if (c == L'/') return 63;
+    return -1;
+}
+
+// Decode into a buffer that owns the bytes
+static MoonValue* DecodeBase64Buffer(const wchar_t* src) {
+    size_t len = wcslen(src);
+    char* data = (char*)malloc(len / 4 * 3 + 3);
+    size_t n = 0;
+    uint32_t acc = 0;
+    int bits = 0;
+    for (size_t i = 0; i < len; i++) {
+        int v = Base64Value(src[i]);
+        if (v < 0) continue;
+        acc = (acc << 6) | (uint32_t)v;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            data[n++] = (char)((acc >> bits) & 0xFF);
+        }
+    }
+    return moon_buffer_new(data, n, NULL, free, data);
+}
+
+static void AppendBase64(std::string& out, const unsigned char* data, size_t len) {
+    static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    out.reserve(out.size() + (len + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 2 < len; i += 3) {
+        uint32_t v = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+        out += chars[v >> 18];
+        out += chars[(v >> 12) & 63];
+        out += chars[(v >> 6) & 63];
+        out += chars[v & 63];
+    }
+    if (i < len) {
+        uint32_t v = data[i] << 16;
+        if (i + 1 < len) v |= data[i + 1] << 8;
+        out += chars[v >> 18];
+        out += chars[(v >> 12) & 63];
+        out += i + 1 < len ? chars[(v >> 6) & 63] : '=';
+        out += '=';
+    }
+}
+
+static void FlushOutbox(MoonWindow* win) {
+    std::wstring script;
+    AcquireSRWLockExclusive(&g_outboxLock);
+    auto it = g_outbox.find(win->id);
+    if (it != g_outbox.end()) {
+        script.swap(it->second.script);
+        it->second.scheduled = false;
+    }
+    ReleaseSRWLockExclusive(&g_outboxLock);
+    
+    if (!script.empty() && win->webview) {
+        win->webview->ExecuteScript(script.c_str(), nullptr);
+    }
+}
+
+static void QueueScript(int winId, const std::wstring& script) {
+    HWND notify = NULL;
+    AcquireSRWLockExclusive(&g_outboxLock);
+    auto it = g_outbox.find(winId);
+    if (it != g_outbox.end()) {
+        it->second.script += script;
+        if (!it->second.scheduled) {
+            it->second.scheduled = true;
+            notify = it->second.hwnd;
+        }
+    }
+    ReleaseSRWLockExclusive(&g_outboxLock);
+    
+    if (notify) PostMessageW(notify, WM_MOON_FLUSH, 0, 0);
+}
+
 // ============================================================================
 // WebView2 Initialization (Per-Window)
 // ============================================================================
 
+// Pages shown with NavigateToString cannot fetch moon:// URLs, so references
+// to embedded assets (moon://localhost/<key>) are expanded to data: URIs
+static std::string ExpandAssetUrls(const char* html) {
+    static const char prefix[] = "moon://localhost/";
+    std::string out;
+    const char* p = html;
+    while (const char* hit = strstr(p, prefix)) {
+        out.append(p, hit - p);
+        const char* keyStart = hit + sizeof(prefix) - 1;
+        const char* keyEnd = keyStart;
+        while (*keyEnd && !strchr("\"')?# \t\r\n>", *keyEnd)) keyEnd++;
+        
+        std::string key(keyStart, keyEnd - keyStart);
+        size_t len = 0;
+        const char* data = moon_asset_data(key.c_str(), &len);
+        if (data) {
+            out += "data:";
+            for (const wchar_t* m = GetMimeType(utf8_to_wstring(key)); *m; m++) out += (char)*m;
+            out += ";base64,";
+            AppendBase64(out, (const unsigned char*)data, len);
+        } else {
+            out.append(hit, keyEnd - hit);
+        }
+        p = keyEnd;
+    }
+    out += p;
+    return out;
+}
+
 static void LoadPendingContentForWindow(MoonWindow* win) {
     if (!win || !win->webview) return;
     
     if (win->pendingHtml) {
         // Use NavigateToString for now (moon:// protocol needs more debugging)
+        if (strstr(win->pendingHtml, "moon://localhost/")) {
+            std::string expanded = ExpandAssetUrls(win->pendingHtml);
+            free(win->pendingHtml);
+            win->pendingHtml = strdup(expanded.c_str());
+        }
         wchar_t* whtml = utf8_to_wchar(win->pendingHtml);
         win->webview->NavigateToString(whtml);
         free(whtml);
@@ -372,18 +539,30 @@ static void InitializeWebView2ForWindow(MoonWindow* win) {
                                         c = towlower(c);
                                     }
                                     
-                                    // Look up in virtual file system
+                                    // Look up in virtual file system, then in the embedded assets
+                                    const char* body = NULL;
+                                    size_t bodyLen = 0;
                                     auto it = g_virtualFiles.find(path);
                                     if (it != g_virtualFiles.end()) {
+                                        body = it->second.data();
+                                        bodyLen = it->second.size();
+                                    } else {
+                                        path = path.substr(0, path.find_first_of(L"?#"));
+                                        char* upath = wchar_to_utf8(path.c_str());
+                                        if (upath) {
+                                            body = moon_asset_data(upath, &bodyLen);
+                                            free(upath);
+                                        }
+                                    }
+                                    if (body) {
                                         // Use global environment
                                         ComPtr<ICoreWebView2Environment> env = g_webviewEnv;
                                         
                                         // Create IStream from content
-                                        const std::string& content = it->second;
-                                        HGLOBAL hMem = GlobalAlloc(GMEM_MOVEABLE, content.size());
+                                        HGLOBAL hMem = GlobalAlloc(GMEM_MOVEABLE, bodyLen ? bodyLen : 1);
                                         if (hMem) {
                                             void* pMem = GlobalLock(hMem);
-                                            memcpy(pMem, content.data(), content.size());
+                                            memcpy(pMem, body, bodyLen);
                                             GlobalUnlock(hMem);
                                             
                                             IStream* stream = nullptr;
@@ -505,13 +684,23 @@ static void InitializeWebView2ForWindow(MoonWindow* win) {
                                         js += L");";
                                         win->webview->ExecuteScript(js.c_str(), nullptr);
                                     }
+                                } else if (msg.rfind(L"__batch__:", 0) == 0) {
+                                    if (win->messageCallback) {
+                                        char* utf8Msg = wchar_to_utf8(msg.c_str() + 10);
+                                        DeliverBatch(win, utf8Msg);
+                                        free(utf8Msg);
+                                    }
+                                } else if (msg.rfind(L"__bin__:", 0) == 0) {
+                                    if (win->binaryCallback) {
+                                        MoonValue* binArgs[2] = { moon_int(win->id), DecodeBase64Buffer(msg.c_str() + 8) };
+                                        InvokeHandler(win, win->binaryCallback, binArgs, 2);
+                                    }
                                 } else if (win->messageCallback) {
                                     char* utf8Msg = wchar_to_utf8(message);
                                     MoonValue* msgArgs[2];
                                     msgArgs[0] = moon_string(utf8Msg);
                                     msgArgs[1] = NULL;
-                                    moon_call_func(win->messageCallback, msgArgs, 1);
-                                    moon_release(msgArgs[0]);
+                                    InvokeHandler(win, win->messageCallback, msgArgs, 1);
                                     free(utf8Msg);
                                 }
                             }
@@ -545,6 +734,37 @@ static void InitializeWebView2ForWindow(MoonWindow* win) {
                     L"window.MoonGUI = {"
                     L"  windowId: %d,"
                     L"  send: function(msg) { window.chrome.webview.postMessage(msg); },"
+                    L"  _q: [],"
+                    L"  _queued: false,"
+                    L"  queue: function(msg) {"
+                    L"    var B = String.fromCharCode(92), N = String.fromCharCode(10), self = this;"
+                    L"    self._q.push(String(msg).split(B).join(B + B).split(N).join(B + 'n'));"
+                    L"    if (self._queued) return;"
+                    L"    self._queued = true;"
+                    L"    var flush = function() {"
+                    L"      if (!self._queued) return;"
+                    L"      self._queued = false;"
+                    L"      var batch = self._q;"
+                    L"      self._q = [];"
+                    L"      window.chrome.webview.postMessage('__batch__:' + batch.join(N));"
+                    L"    };"
+                    L"    requestAnimationFrame(flush);"
+                    L"    setTimeout(flush, 100);"
+                    L"  },"
+                    L"  sendBinary: function(data) {"
+                    L"    var bytes = data instanceof ArrayBuffer ? new Uint8Array(data)"
+                    L"              : new Uint8Array(data.buffer, data.byteOffset, data.byteLength);"
+                    L"    var s = '';"
+                    L"    for (var i = 0; i < bytes.length; i += 0x8000) {"
+                    L"      s += String.fromCharCode.apply(null, bytes.subarray(i, i + 0x8000));"
+                    L"    }"
+                    L"    window.chrome.webview.postMessage('__bin__:' + btoa(s));"
+                    L"  },"
+                    L"  _fromBase64: function(s) {"
+                    L"    var bin = atob(s), bytes = new Uint8Array(bin.length);"
+                    L"    for (var i = 0; i < bin.length; i++) bytes[i] = bin.charCodeAt(i);"
+                    L"    return bytes;"
+                    L"  },"
                     L"  close: function() { window.chrome.webview.postMessage('__close__'); },"
                     L"  minimize: function() { window.chrome.webview.postMessage('__minimize__'); },"
                     L"  maximize: function() { window.chrome.webview.postMessage('__maximize__'); },"
@@ -701,6 +921,10 @@ static LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPara
         case WM_CREATE:
             InitializeWebView2ForWindow(win);
             return 0;
+        
+        case WM_MOON_FLUSH:
+            FlushOutbox(win);
+            return 0;
 
         case WM_ERASEBKGND:
             if (win->transparent) {
@@ -877,6 +1101,9 @@ static LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPara
             
             // Remove from registry
             g_windows.erase(win->id);
+            AcquireSRWLockExclusive(&g_outboxLock);
+            g_outbox.erase(win->id);
+            ReleaseSRWLockExclusive(&g_outboxLock);
             
             // Update tray owner if needed
             if (g_trayOwnerWindow == hwnd) {
@@ -1167,6 +1394,9 @@ MoonValue* moon_gui_create_advanced(MoonValue* title, MoonValue* width, MoonValu
     
     // Register window
     g_windows[win->id] = win;
+    AcquireSRWLockExclusive(&g_outboxLock);
+    g_outbox[win->id].hwnd = hwnd;
+    ReleaseSRWLockExclusive(&g_outboxLock);
     
     // Set as tray owner if first window
     if (!g_trayOwnerWindow) {
@@ -1406,6 +1636,7 @@ MoonValue* moon_gui_eval_win(MoonValue* winId, MoonValue* js) {
     MoonWindow* win = GetWindowById((int)moon_to_int(winId));
     if (!win || !win->webview) return moon_null();
     
+    FlushOutbox(win);  // Keep order with queued messages
     wchar_t* wjs = utf8_to_wchar(js->data.strVal);
     win->webview->ExecuteScript(wjs, nullptr);
     free(wjs);
@@ -1416,15 +1647,45 @@ MoonValue* moon_gui_eval_win(MoonValue* winId, MoonValue* js) {
 void moon_gui_post_message_win(MoonValue* winId, MoonValue* msg) {
     if (!moon_is_int(winId) || !moon_is_string(msg)) return;
     
-    MoonWindow* win = GetWindowById((int)moon_to_int(winId));
-    if (!win || !win->webview) return;
-    
-    // Use ExecuteScript to dispatch moonmessage event (consistent with interpreter)
+    // Dispatch moonmessage event (consistent with interpreter), coalesced
+    // with other posts until the window procedure flushes the outbox
     std::string msgStr = msg->data.strVal;
     std::wstring js = L"window.dispatchEvent(new CustomEvent('moonmessage', {detail: ";
     js += utf8_to_wstring(msgStr);
     js += L"}));";
-    win->webview->ExecuteScript(js.c_str(), nullptr);
+    QueueScript((int)moon_to_int(winId), js);
+}
+
+// gui_post_binary(winId, data) - string or buffer, arrives as a Uint8Array
+void moon_gui_post_binary_win(MoonValue* winId, MoonValue* data) {
+    size_t len;
+    const char* bytes = moon_bytes_view(data, &len);
+    if (!moon_is_int(winId) || !bytes) return;
+    
+    std::string b64;
+    AppendBase64(b64, (const unsigned char*)bytes, len);
+    std::wstring js = L"if(window.onMoonBinary&&window.MoonGUI) window.onMoonBinary(MoonGUI._fromBase64(\"";
+    js += utf8_to_wstring(b64);
+    js += L"\"));";
+    QueueScript((int)moon_to_int(winId), js);
+}
+
+void moon_gui_on_binary_win(MoonValue* winId, MoonValue* callback) {
+    MoonWindow* win = GetWindowById((int)moon_to_int(winId));
+    if (!win) return;
+    
+    if (win->binaryCallback) moon_release(win->binaryCallback);
+    win->binaryCallback = nullptr;
+    if (callback && callback->type == MOON_FUNC) {
+        moon_retain(callback);
+        win->binaryCallback = callback;
+    }
+}
+
+// gui_async_handlers(winId, enabled) - run message handlers as coroutines
+void moon_gui_async_handlers_win(MoonValue* winId, MoonValue* enabled) {
+    MoonWindow* win = GetWindowById((int)moon_to_int(winId));
+    if (win) win->asyncHandlers = moon_to_bool(enabled);
 }
 
 // ============================================================================
@@ -1717,6 +1978,9 @@ void moon_gui_on_message_win(MoonValue* winId, MoonValue* callback) {}
 void moon_gui_on_close_win(MoonValue* winId, MoonValue* callback) {}
 MoonValue* moon_gui_eval_win(MoonValue* winId, MoonValue* js) { return moon_null(); }
 void moon_gui_post_message_win(MoonValue* winId, MoonValue* msg) {}
+void moon_gui_post_binary_win(MoonValue* winId, MoonValue* data) {}
+void moon_gui_on_binary_win(MoonValue* winId, MoonValue* callback) {}
+void moon_gui_async_handlers_win(MoonValue* winId, MoonValue* enabled) {}
 void moon_gui_expose(MoonValue* name, MoonValue* callback) {}
 void moon_gui_expose_win(MoonValue* winId, MoonValue* name, MoonValue* callback) {}
 
@@ -0,0 +1,162 @@
+// MoonLang Runtime - WebView Message Bridge
+// Copyright (c) 2026 greenteng.com
+//
+// The toolkit-independent half of the GUI message bridge, shared by the GTK
+// (moonrt_gui_linux.cpp) and Cocoa (moonrt_gui_macos.mm) backends and by the
+// headless driver in scripts/bench/gui_bridge_bench.cpp.
+//
+// Page -> native: MoonGUI.queue() batches messages into one "__batch__:" post
+// per frame (messages joined by '\n', with '\\' and '\n' escaped) and
+// sendBinary() posts "__bin__:" + base64. BridgeDispatch() routes a posted
+// string to the message or binary handler.
+//
+// Native -> page: gui_post_message and gui_post_binary build a script with
+// BridgeMessageScript()/BridgeBinaryScript() and append it to a BridgeOutbox;
+// the UI thread runs everything pending for a window as a single script.
+
+#ifndef MOONRT_GUI_BRIDGE_H
+#define MOONRT_GUI_BRIDGE_H
+
+#include "moonrt.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <mutex>
+#include <string>
+
+// Call deliver(const char* msg) for each message of a "__batch__:" payload
+template <typename Deliver>
+static void BridgeSplitBatch(const char* batch, Deliver deliver) {
+    std::string msg;
+    for (const char* p = batch; ; p++) {
+        if (*p == '\n' || *p == '\0') {
+            deliver(msg.c_str());
+            msg.clear();
+            if (*p == '\0') break;
+        } else if (*p == '\\' && p[1]) {
+            p++;
+            msg += *p == 'n' ? '\n' : *p;
+        } else {
+            msg += *p;
+        }
+    }
+}
+
+static inline int BridgeBase64Value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+// Decode into a buffer that owns the bytes
+static inline MoonValue* BridgeDecodeBase64(const char* src) {
+    size_t len = strlen(src);
+    char* data = (char*)malloc(len / 4 * 3 + 3);
+    size_t n = 0;
+    uint32_t acc = 0;
+    int bits = 0;
+    for (size_t i = 0; i < len; i++) {
+        int v = BridgeBase64Value(src[i]);
+        if (v < 0) continue;
+        acc = (acc << 6) | (uint32_t)v;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            data[n++] = (char)((acc >> bits) & 0xFF);
+        }
+    }
+    return moon_buffer_new(data, n, NULL, free, data);
+}
+
+static inline void BridgeAppendBase64(std::string& out, const unsigned char* data, size_t len) {
+    static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    out.reserve(out.size() + (len + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 2 < len; i += 3) {
+        uint32_t v = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+        out += chars[v >> 18];
+        out += chars[(v >> 12) & 63];
+        out += chars[(v >> 6) & 63];
+        out += chars[v & 63];
+    }
+    if (i < len) {
+        uint32_t v = data[i] << 16;
+        if (i + 1 < len) v |= data[i + 1] << 8;
+        out += chars[v >> 18];
+        out += chars[(v >> 12) & 63];
+        out += i + 1 < len ? chars[(v >> 6) & 63] : '=';
+        out += '=';
+    }
+}
+
+// Route a string posted by the page. onMessage(MoonValue*) and
+// onBinary(MoonValue*) take ownership of the payload; a handler that is not
+// wanted (no callback registered) is skipped when its flag is false.
+template <typename OnMessage, typename OnBinary>
+static void BridgeDispatch(const char* message, bool wantMessage, bool wantBinary,
+                           OnMessage onMessage, OnBinary onBinary) {
+    if (strncmp(message, "__batch__:", 10) == 0) {
+        if (wantMessage) {
+            BridgeSplitBatch(message + 10, [&](const char* msg) { onMessage(moon_string(msg)); });
+        }
+    } else if (strncmp(message, "__bin__:", 8) == 0) {
+        if (wantBinary) onBinary(BridgeDecodeBase64(message + 8));
+    } else if (wantMessage) {
+        onMessage(moon_string(message));
+    }
+}
+
+// Script that hands msg to window.onMoonMessage
+static inline std::string BridgeMessageScript(const char* msg) {
+    std::string script = "if(window.onMoonMessage) window.onMoonMessage(\"";
+    for (const char* p = msg; *p; p++) {
+        if (*p == '"') script += "\\\"";
+        else if (*p == '\\') script += "\\\\";
+        else if (*p == '\n') script += "\\n";
+        else if (*p == '\r') script += "\\r";
+        else if (*p == '\t') script += "\\t";
+        else script += *p;
+    }
+    script += "\");";
+    return script;
+}
+
+// Script that hands the bytes to window.onMoonBinary as a Uint8Array
+static inline std::string BridgeBinaryScript(const char* bytes, size_t len) {
+    std::string script = "if(window.onMoonBinary&&window.MoonGUI) window.onMoonBinary(MoonGUI._fromBase64(\"";
+    BridgeAppendBase64(script, (const unsigned char*)bytes, len);
+    script += "\"));";
+    return script;
+}
+
+// Scripts waiting for the UI thread, per window id. Any thread may queue;
+// queue() returns true when the caller has to schedule a flush, which then
+// takes everything pending at once.
+class BridgeOutbox {
+public:
+    bool queue(int winId, const std::string& script) {
+        std::lock_guard<std::mutex> guard(lock);
+        pending[winId] += script;
+        bool schedule = !scheduled;
+        scheduled = true;
+        return schedule;
+    }
+
+    void take(std::map<int, std::string>& out) {
+        std::lock_guard<std::mutex> guard(lock);
+        out.swap(pending);
+        pending.clear();
+        scheduled = false;
+    }
+
+private:
+    std::mutex lock;
+    std::map<int, std::string> pending;
+    bool scheduled = false;
+};
+
+#endif // MOONRT_GUI_BRIDGE_H
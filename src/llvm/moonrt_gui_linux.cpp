@@ -16,6 +16,7 @@
 #include <gtk/gtk.h>
 #include <webkit2/webkit2.h>
 #include <gdk/gdk.h>
+#include "moonrt_gui_bridge.h"
 #include <map>
 #include <string>
 #include <unordered_map>
@@ -66,6 +67,8 @@ struct MoonWindow {
     // Callbacks
     MoonValue* messageCallback;
     MoonValue* closeCallback;
+    MoonValue* binaryCallback;           // gui_on_binary
+    bool asyncHandlers;                  // Run message handlers as coroutines
     
     // Exposed functions (callable from JS)
     std::unordered_map<std::string, MoonValue*> exposedFuncs;
@@ -82,6 +85,7 @@ struct MoonWindow {
         showPending(false), frameless(false), transparent(false), topmost(false),
         resizable(true), clickThrough(false), devtools(false), alpha(255),
         messageCallback(nullptr), closeCallback(nullptr),
+        binaryCallback(nullptr), asyncHandlers(false),
         pendingHtml(nullptr), pendingUrl(nullptr),
         parentId(0), modal(false) {}
     
@@ -90,6 +94,7 @@ struct MoonWindow {
         if (pendingUrl) free(pendingUrl);
         if (messageCallback) moon_release(messageCallback);
         if (closeCallback) moon_release(closeCallback);
+        if (binaryCallback) moon_release(binaryCallback);
         for (auto& pair : exposedFuncs) {
             if (pair.second) moon_release(pair.second);
         }
@@ -115,6 +120,9 @@ static MoonValue* g_trayCallback = NULL;
 // Virtual file system for moon:// protocol
 static std::unordered_map<std::string, std::string> g_virtualFiles;
 
+// Scripts queued by gui_post_message/gui_post_binary, per window id
+static BridgeOutbox g_outbox;
+
 // ============================================================================
 // Helper Functions
 // ============================================================================
@@ -176,6 +184,39 @@ window.MoonGUI = {
     postMessage: function(msg) {
         window.webkit.messageHandlers.moonMessage.postMessage(JSON.stringify(msg));
     },
+    // Like postMessage, but delivered in one batch per animation frame
+    _queue: [],
+    _queued: false,
+    queue: function(msg) {
+        var B = String.fromCharCode(92), self = this;
+        self._queue.push(JSON.stringify(msg).split(B).join(B + B).split('\n').join(B + 'n'));
+        if (self._queued) return;
+        self._queued = true;
+        var flush = function() {
+            if (!self._queued) return;
+            self._queued = false;
+            var batch = self._queue;
+            self._queue = [];
+            window.webkit.messageHandlers.moonMessage.postMessage('__batch__:' + batch.join('\n'));
+        };
+        requestAnimationFrame(flush);
+        setTimeout(flush, 100);  // Hidden pages get no animation frames
+    },
+    // ArrayBuffer or typed array; arrives in gui_on_binary as a buffer
+    sendBinary: function(data) {
+        var bytes = data instanceof ArrayBuffer ? new Uint8Array(data)
+                  : new Uint8Array(data.buffer, data.byteOffset, data.byteLength);
+        var s = '';
+        for (var i = 0; i < bytes.length; i += 0x8000) {
+            s += String.fromCharCode.apply(null, bytes.subarray(i, i + 0x8000));
+        }
+        window.webkit.messageHandlers.moonMessage.postMessage('__bin__:' + btoa(s));
+    },
+    _fromBase64: function(s) {
+        var bin = atob(s), bytes = new Uint8Array(bin.length);
+        for (var i = 0; i < bin.length; i++) bytes[i] = bin.charCodeAt(i);
+        return bytes;
+    },
     call: function(funcName, ...args) {
         return new Promise((resolve, reject) => {
             const callId = Date.now() + '_' + Math.random();
@@ -246,6 +287,43 @@ static void on_webview_load_changed(WebKitWebView* webview, WebKitLoadEvent even
     }
 }
 
+// ============================================================================
+// Message Bridge
+// ============================================================================
+// Encoding, dispatch and the outbox live in moonrt_gui_bridge.h. Outbox
+// scripts are sent as a single script per main loop iteration; gui_post_message
+// and gui_post_binary may be called from any thread.
+
+static void InvokeHandler(MoonWindow* win, MoonValue* callback, MoonValue* payload) {
+    MoonValue* args[2] = { moon_int(win->id), payload };
+    if (win->asyncHandlers) {
+        // The coroutine retains its arguments; the UI thread moves on
+        moon_async(callback, args, 2);
+    } else {
+        MoonValue* result = moon_call_func(callback, args, 2);
+        if (result) moon_release(result);
+    }
+    moon_release(args[0]);
+    moon_release(args[1]);
+}
+
+static gboolean FlushOutbox(gpointer data) {
+    std::map<int, std::string> pending;
+    g_outbox.take(pending);
+    
+    for (auto& entry : pending) {
+        MoonWindow* win = GetWindowById(entry.first);
+        if (win && win->webview) {
+            moon_webkit_run_javascript(WEBKIT_WEB_VIEW(win->webview), entry.second.c_str(), NULL, NULL);
+        }
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static void QueueScript(int winId, const std::string& script) {
+    if (g_outbox.queue(winId, script)) g_idle_add(FlushOutbox, NULL);
+}
+
 // Handle messages from JavaScript
 static void on_script_message(WebKitUserContentManager* manager,
                               WebKitJavascriptResult* result,
@@ -256,13 +334,9 @@ static void on_script_message(WebKitUserContentManager* manager,
     if (jsc_value_is_string(value)) {
         char* message = jsc_value_to_string(value);
         
-        if (win->messageCallback) {
-            MoonValue* args[2] = { moon_int(win->id), moon_string(message) };
-            MoonValue* result = moon_call_func(win->messageCallback, args, 2);
-            if (result) moon_release(result);
-            moon_release(args[0]);
-            moon_release(args[1]);
-        }
+        BridgeDispatch(message, win->messageCallback != nullptr, win->binaryCallback != nullptr,
+            [win](MoonValue* msg) { InvokeHandler(win, win->messageCallback, msg); },
+            [win](MoonValue* buf) { InvokeHandler(win, win->binaryCallback, buf); });
         
         g_free(message);
     }
@@ -291,7 +365,9 @@ static void on_uri_scheme_request(WebKitURISchemeRequest* request, gpointer data
         c = tolower(c);
     }
     
-    // Look up in virtual file system
+    // Look up in virtual file system, then in the embedded assets
+    std::string assetPath = path.substr(0, path.find_first_of("?#"));
+    size_t assetLen = 0;
     auto it = g_virtualFiles.find(path);
     if (it != g_virtualFiles.end()) {
         const std::string& content = it->second;
@@ -304,6 +380,15 @@ static void on_uri_scheme_request(WebKitURISchemeRequest* request, gpointer data
         const char* mimeType = GetMimeType(path);
         webkit_uri_scheme_request_finish(request, stream, content.size(), mimeType);
         g_object_unref(stream);
+    } else if (const char* asset = moon_asset_data(assetPath.c_str(), &assetLen)) {
+        // Embedded by moonc; the bytes live as long as the process
+        GBytes* bytes = g_bytes_new_static(asset, assetLen);
+        GInputStream* stream = g_memory_input_stream_new_from_bytes(bytes);
+        g_bytes_unref(bytes);
+        
+        const char* mimeType = GetMimeType(assetPath);
+        webkit_uri_scheme_request_finish(request, stream, (gint64)assetLen, mimeType);
+        g_object_unref(stream);
     } else {
         // File not found
         GError* error = g_error_new(G_IO_ERROR, G_IO_ERROR_NOT_FOUND, "File not found: %s", path.c_str());
@@ -764,6 +849,7 @@ MoonValue* moon_gui_eval_js(MoonValue* js) {
     MoonWindow* window = GetFirstWindow();
     if (!window || !moon_is_string(js)) return moon_null();
     
+    FlushOutbox(NULL);  // Keep order with queued messages
     moon_webkit_run_javascript(WEBKIT_WEB_VIEW(window->webview), 
                                js->data.strVal, on_js_finished, NULL);
     return moon_null();
@@ -773,30 +859,44 @@ MoonValue* moon_gui_eval_win(MoonValue* winId, MoonValue* js) {
     MoonWindow* window = GetWindowById((int)moon_to_int(winId));
     if (!window || !moon_is_string(js)) return moon_null();
     
+    FlushOutbox(NULL);  // Keep order with queued messages
     moon_webkit_run_javascript(WEBKIT_WEB_VIEW(window->webview), 
                                js->data.strVal, on_js_finished, NULL);
     return moon_null();
 }
 
 void moon_gui_post_message_win(MoonValue* winId, MoonValue* msg) {
+    if (!moon_is_string(msg)) return;
+    
+    // Coalesced with other posts until the main loop is idle
+    QueueScript((int)moon_to_int(winId), BridgeMessageScript(msg->data.strVal));
+}
+
+// gui_post_binary(winId, data) - string or buffer, arrives as a Uint8Array
+void moon_gui_post_binary_win(MoonValue* winId, MoonValue* data) {
+    size_t len;
+    const char* bytes = moon_bytes_view(data, &len);
+    if (!bytes) return;
+    
+    QueueScript((int)moon_to_int(winId), BridgeBinaryScript(bytes, len));
+}
+
+void moon_gui_on_binary_win(MoonValue* winId, MoonValue* callback) {
     MoonWindow* window = GetWindowById((int)moon_to_int(winId));
-    if (!window || !moon_is_string(msg)) return;
-    
-    // Escape the message for JavaScript
-    const char* msgStr = msg->data.strVal;
-    std::string escaped;
-    for (const char* p = msgStr; *p; p++) {
-        if (*p == '"') escaped += "\\\"";
-        else if (*p == '\\') escaped += "\\\\";
-        else if (*p == '\n') escaped += "\\n";
-        else if (*p == '\r') escaped += "\\r";
-        else if (*p == '\t') escaped += "\\t";
-        else escaped += *p;
-    }
+    if (!window) return;
     
-    std::string script = "if(window.onMoonMessage) window.onMoonMessage(\"" + escaped + "\");";
-    moon_webkit_run_javascript(WEBKIT_WEB_VIEW(window->webview), 
-                               script.c_str(), NULL, NULL);
+    if (window->binaryCallback) moon_release(window->binaryCallback);
+    window->binaryCallback = nullptr;
+    if (callback && callback->type == MOON_FUNC) {
+        moon_retain(callback);
+        window->binaryCallback = callback;
+    }
+}
+
+// gui_async_handlers(winId, enabled) - run message handlers as coroutines
+void moon_gui_async_handlers_win(MoonValue* winId, MoonValue* enabled) {
+    MoonWindow* window = GetWindowById((int)moon_to_int(winId));
+    if (window) window->asyncHandlers = moon_to_bool(enabled);
 }
 
 // Expose function to JavaScript (callable from JS)
@@ -1068,6 +1168,9 @@ void moon_gui_expose_win(MoonValue* winId, MoonValue* name, MoonValue* callback)
 
 // Message handling
 void moon_gui_on_message(MoonValue* callback) {}
+void moon_gui_post_binary_win(MoonValue* winId, MoonValue* data) {}
+void moon_gui_on_binary_win(MoonValue* winId, MoonValue* callback) {}
+void moon_gui_async_handlers_win(MoonValue* winId, MoonValue* enabled) {}
 
 // Message loop
 void moon_gui_run(void) {}
@@ -15,6 +15,7 @@
 
 #import <Cocoa/Cocoa.h>
 #import <WebKit/WebKit.h>
+#include "moonrt_gui_bridge.h"
 #include <map>
 #include <string>
 #include <unordered_map>
@@ -51,6 +52,8 @@ struct MoonWindow {
     // Callbacks
     MoonValue* messageCallback;
     MoonValue* closeCallback;
+    MoonValue* binaryCallback;           // gui_on_binary
+    bool asyncHandlers;                  // Run message handlers as coroutines
     
     // Exposed functions (callable from JS)
     std::unordered_map<std::string, MoonValue*> exposedFuncs;
@@ -67,6 +70,7 @@ struct MoonWindow {
         webviewReady(false), showPending(false), frameless(false), transparent(false),
         topmost(false), resizable(true), clickThrough(false), devtools(false), alpha(255),
         messageCallback(nullptr), closeCallback(nullptr),
+        binaryCallback(nullptr), asyncHandlers(false),
         pendingHtml(nullptr), pendingUrl(nullptr),
         parentId(0), modal(false) {}
     
@@ -75,6 +79,7 @@ struct MoonWindow {
         if (pendingUrl) free(pendingUrl);
         if (messageCallback) moon_release(messageCallback);
         if (closeCallback) moon_release(closeCallback);
+        if (binaryCallback) moon_release(binaryCallback);
         for (auto& pair : exposedFuncs) {
             if (pair.second) moon_release(pair.second);
         }
@@ -98,6 +103,9 @@ static MoonValue* g_trayCallback = nullptr;
 // Virtual file system for moon:// protocol
 static std::unordered_map<std::string, std::string> g_virtualFiles;
 
+// Scripts queued by gui_post_message/gui_post_binary, per window id
+static BridgeOutbox g_outbox;
+
 // ============================================================================
 // Helper Functions
 // ============================================================================
@@ -115,6 +123,49 @@ static NSString* UTF8ToNSString(const char* str) {
     return str ? [NSString stringWithUTF8String:str] : @"";
 }
 
+// ============================================================================
+// Message Bridge
+// ============================================================================
+// Encoding, dispatch and the outbox live in moonrt_gui_bridge.h. Outbox
+// scripts are sent as a single script per main queue turn; gui_post_message
+// and gui_post_binary may be called from any thread.
+
+static void InvokeHandler(MoonWindow* win, MoonValue* callback, MoonValue* payload) {
+    MoonValue* args[2] = { moon_int(win->id), payload };
+    if (win->asyncHandlers) {
+        // The coroutine retains its arguments; the UI thread moves on
+        moon_async(callback, args, 2);
+    } else {
+        MoonValue* result = moon_call_func(callback, args, 2);
+        if (result) moon_release(result);
+    }
+    moon_release(args[0]);
+    moon_release(args[1]);
+}
+
+static void FlushOutbox() {
+    std::map<int, std::string> pending;
+    g_outbox.take(pending);
+    
+    for (auto& entry : pending) {
+        MoonWindow* win = GetWindowById(entry.first);
+        if (win && win->webview) {
+            [win->webview evaluateJavaScript:UTF8ToNSString(entry.second.c_str())
+                           completionHandler:nil];
+        }
+    }
+}
+
+static void QueueScript(int winId, const std::string& script) {
+    if (g_outbox.queue(winId, script)) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            @autoreleasepool {
+                FlushOutbox();
+            }
+        });
+    }
+}
+
 // ============================================================================
 // MoonWebViewMessageHandler - Handle JS messages
 // ============================================================================
@@ -152,14 +203,11 @@ static NSString* UTF8ToNSString(const char* str) {
             return;
         }
         
-        // Regular message callback
-        if (self.moonWindow->messageCallback) {
-            MoonValue* args[2] = { moon_int(self.moonWindow->id), moon_string(utf8) };
-            MoonValue* result = moon_call_func(self.moonWindow->messageCallback, args, 2);
-            if (result) moon_release(result);
-            moon_release(args[0]);
-            moon_release(args[1]);
-        }
+        // Regular, batched (MoonGUI.queue) and binary (sendBinary) messages
+        MoonWindow* win = self.moonWindow;
+        BridgeDispatch(utf8, win->messageCallback != nullptr, win->binaryCallback != nullptr,
+            [win](MoonValue* msg) { InvokeHandler(win, win->messageCallback, msg); },
+            [win](MoonValue* buf) { InvokeHandler(win, win->binaryCallback, buf); });
     }
 }
 
@@ -230,7 +278,38 @@ static NSString* UTF8ToNSString(const char* str) {
         "  close: function() { window.webkit.messageHandlers.moonMessage.postMessage('__close__'); },"
         "  minimize: function() { window.webkit.messageHandlers.moonMessage.postMessage('__minimize__'); },"
         "  maximize: function() { window.webkit.messageHandlers.moonMessage.postMessage('__maximize__'); },"
-        "  drag: function() { window.webkit.messageHandlers.moonMessage.postMessage('__drag__'); }"
+        "  drag: function() { window.webkit.messageHandlers.moonMessage.postMessage('__drag__'); },"
+        "  _q: [],"
+        "  _queued: false,"
+        "  queue: function(msg) {"
+        "    var B = String.fromCharCode(92), N = String.fromCharCode(10), self = this;"
+        "    self._q.push(String(msg).split(B).join(B + B).split(N).join(B + 'n'));"
+        "    if (self._queued) return;"
+        "    self._queued = true;"
+        "    var flush = function() {"
+        "      if (!self._queued) return;"
+        "      self._queued = false;"
+        "      var batch = self._q;"
+        "      self._q = [];"
+        "      window.webkit.messageHandlers.moonMessage.postMessage('__batch__:' + batch.join(N));"
+        "    };"
+        "    requestAnimationFrame(flush);"
+        "    setTimeout(flush, 100);"
+        "  },"
+        "  sendBinary: function(data) {"
+        "    var bytes = data instanceof ArrayBuffer ? new Uint8Array(data)"
+        "              : new Uint8Array(data.buffer, data.byteOffset, data.byteLength);"
+        "    var s = '';"
+        "    for (var i = 0; i < bytes.length; i += 0x8000) {"
+        "      s += String.fromCharCode.apply(null, bytes.subarray(i, i + 0x8000));"
+        "    }"
+        "    window.webkit.messageHandlers.moonMessage.postMessage('__bin__:' + btoa(s));"
+        "  },"
+        "  _fromBase64: function(s) {"
+        "    var bin = atob(s), bytes = new Uint8Array(bin.length);"
+        "    for (var i = 0; i < bin.length; i++) bytes[i] = bin.charCodeAt(i);"
+        "    return bytes;"
+        "  }"
         "};"
         "window.chrome = window.chrome || {};"
         "window.chrome.webview = window.chrome.webview || {"
@@ -267,12 +346,19 @@ static NSString* UTF8ToNSString(const char* str) {
     }
     std::string pathStr = [path.lowercaseString UTF8String];
     
-    // Look up in virtual file system
+    // Look up in virtual file system, then in the embedded assets
+    NSData* data = nil;
+    size_t assetLen = 0;
     auto it = g_virtualFiles.find(pathStr);
     if (it != g_virtualFiles.end()) {
         const std::string& content = it->second;
-        NSData* data = [NSData dataWithBytes:content.data() length:content.size()];
-        
+        data = [NSData dataWithBytes:content.data() length:content.size()];
+    } else if (const char* asset = moon_asset_data(pathStr.c_str(), &assetLen)) {
+        // Embedded by moonc; the bytes live as long as the process
+        data = [NSData dataWithBytesNoCopy:(void*)asset length:assetLen freeWhenDone:NO];
+    }
+    
+    if (data) {
         // Determine MIME type
         NSString* mimeType = @"application/octet-stream";
         if ([path hasSuffix:@".html"] || [path hasSuffix:@".htm"]) mimeType = @"text/html";
@@ -806,6 +892,7 @@ MoonValue* moon_gui_eval_js(MoonValue* js) {
         MoonWindow* window = GetFirstWindow();
         if (!window || !moon_is_string(js)) return moon_null();
         
+        FlushOutbox();  // Keep order with queued messages
         [window->webview evaluateJavaScript:UTF8ToNSString(js->data.strVal)
                           completionHandler:nil];
         return moon_null();
@@ -817,6 +904,7 @@ MoonValue* moon_gui_eval_win(MoonValue* winId, MoonValue* js) {
         MoonWindow* window = GetWindowById((int)moon_to_int(winId));
         if (!window || !moon_is_string(js)) return moon_null();
         
+        FlushOutbox();  // Keep order with queued messages
         [window->webview evaluateJavaScript:UTF8ToNSString(js->data.strVal)
                           completionHandler:nil];
         return moon_null();
@@ -824,28 +912,39 @@ MoonValue* moon_gui_eval_win(MoonValue* winId, MoonValue* js) {
 }
 
 void moon_gui_post_message_win(MoonValue* winId, MoonValue* msg) {
-    @autoreleasepool {
-        MoonWindow* window = GetWindowById((int)moon_to_int(winId));
-        if (!window || !moon_is_string(msg)) return;
-        
-        // Escape the message for JavaScript
-        const char* msgStr = msg->data.strVal;
-        NSMutableString* escaped = [NSMutableString string];
-        for (const char* p = msgStr; *p; p++) {
-            if (*p == '"') [escaped appendString:@"\\\""];
-            else if (*p == '\\') [escaped appendString:@"\\\\"];
-            else if (*p == '\n') [escaped appendString:@"\\n"];
-            else if (*p == '\r') [escaped appendString:@"\\r"];
-            else if (*p == '\t') [escaped appendString:@"\\t"];
-            else [escaped appendFormat:@"%c", *p];
-        }
-        
-        NSString* script = [NSString stringWithFormat:
-            @"if(window.onMoonMessage) window.onMoonMessage(\"%@\");", escaped];
-        [window->webview evaluateJavaScript:script completionHandler:nil];
+    if (!moon_is_string(msg)) return;
+    
+    // Coalesced with other posts until the main queue runs the flush
+    QueueScript((int)moon_to_int(winId), BridgeMessageScript(msg->data.strVal));
+}
+
+// gui_post_binary(winId, data) - string or buffer, arrives as a Uint8Array
+void moon_gui_post_binary_win(MoonValue* winId, MoonValue* data) {
+    size_t len;
+    const char* bytes = moon_bytes_view(data, &len);
+    if (!bytes) return;
+    
+    QueueScript((int)moon_to_int(winId), BridgeBinaryScript(bytes, len));
+}
+
+void moon_gui_on_binary_win(MoonValue* winId, MoonValue* callback) {
+    MoonWindow* window = GetWindowById((int)moon_to_int(winId));
+    if (!window) return;
+    
+    if (window->binaryCallback) moon_release(window->binaryCallback);
+    window->binaryCallback = nullptr;
+    if (callback && callback->type == MOON_FUNC) {
+        moon_retain(callback);
+        window->binaryCallback = callback;
     }
 }
 
+// gui_async_handlers(winId, enabled) - run message handlers as coroutines
+void moon_gui_async_handlers_win(MoonValue* winId, MoonValue* enabled) {
+    MoonWindow* window = GetWindowById((int)moon_to_int(winId));
+    if (window) window->asyncHandlers = moon_to_bool(enabled);
+}
+
 void moon_gui_expose(MoonValue* name, MoonValue* callback) {
     MoonWindow* window = GetFirstWindow();
     if (!window || !moon_is_string(name)) return;
@@ -1134,6 +1233,9 @@ void moon_gui_load_html_win(MoonValue* winId, MoonValue* html) {}
 MoonValue* moon_gui_eval_js(MoonValue* js) { return moon_null(); }
 MoonValue* moon_gui_eval_win(MoonValue* winId, MoonValue* js) { return moon_null(); }
 void moon_gui_post_message_win(MoonValue* winId, MoonValue* msg) {}
+void moon_gui_post_binary_win(MoonValue* winId, MoonValue* data) {}
+void moon_gui_on_binary_win(MoonValue* winId, MoonValue* callback) {}
+void moon_gui_async_handlers_win(MoonValue* winId, MoonValue* enabled) {}
 void moon_gui_expose(MoonValue* name, MoonValue* callback) {}
 void moon_gui_expose_win(MoonValue* winId, MoonValue* name, MoonValue* callback) {}
 
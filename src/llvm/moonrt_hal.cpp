@@ -136,14 +136,14 @@ MoonValue* moon_i2c_write(MoonValue* addr, MoonValue* data) {
     if (moon_is_list(data)) {
         MoonList* list = data->data.listVal;
         len = list->length;
-        buf = (uint8_t*)malloc(len);
+        buf = (uint8_t*)moon_alloc(len);
         for (int i = 0; i < len; i++) {
             buf[i] = (uint8_t)moon_to_int(list->items[i]);
         }
     } else if (moon_is_string(data)) {
         const char* str = data->data.strVal;
         len = strlen(str);
-        buf = (uint8_t*)malloc(len);
+        buf = (uint8_t*)moon_alloc(len);
         memcpy(buf, str, len);
     } else {
         return moon_int(-1);
@@ -151,7 +151,7 @@ MoonValue* moon_i2c_write(MoonValue* addr, MoonValue* data) {
     
     // Use bus 0 by default (future: allow specifying bus)
     int result = moon_hal_i2c_write(0, a, buf, len);
-    free(buf);
+    moon_free(buf, 0);
     
     return moon_int(result);
 }
@@ -164,13 +164,13 @@ MoonValue* moon_i2c_read(MoonValue* addr, MoonValue* length) {
         return moon_null();
     }
     
-    uint8_t* buf = (uint8_t*)malloc(len);
+    uint8_t* buf = (uint8_t*)moon_alloc(len);
     
     // Use bus 0 by default
     int result = moon_hal_i2c_read(0, a, buf, len);
     
     if (result < 0) {
-        free(buf);
+        moon_free(buf, 0);
         return moon_null();
     }
     
@@ -180,7 +180,7 @@ MoonValue* moon_i2c_read(MoonValue* addr, MoonValue* length) {
         moon_list_append(list, moon_int(buf[i]));
     }
     
-    free(buf);
+    moon_free(buf, 0);
     return list;
 }
 
@@ -211,28 +211,28 @@ MoonValue* moon_spi_transfer(MoonValue* data) {
     if (moon_is_list(data)) {
         MoonList* list = data->data.listVal;
         len = list->length;
-        txBuf = (uint8_t*)malloc(len);
+        txBuf = (uint8_t*)moon_alloc(len);
         for (int i = 0; i < len; i++) {
             txBuf[i] = (uint8_t)moon_to_int(list->items[i]);
         }
     } else if (moon_is_string(data)) {
         const char* str = data->data.strVal;
         len = strlen(str);
-        txBuf = (uint8_t*)malloc(len);
+        txBuf = (uint8_t*)moon_alloc(len);
         memcpy(txBuf, str, len);
     } else {
         return moon_null();
     }
     
-    uint8_t* rxBuf = (uint8_t*)malloc(len);
+    uint8_t* rxBuf = (uint8_t*)moon_alloc(len);
     
     // Use bus 0 by default
     int result = moon_hal_spi_transfer(0, txBuf, rxBuf, len);
     
-    free(txBuf);
+    moon_free(txBuf, 0);
     
     if (result < 0) {
-        free(rxBuf);
+        moon_free(rxBuf, 0);
         return moon_null();
     }
     
@@ -242,7 +242,7 @@ MoonValue* moon_spi_transfer(MoonValue* data) {
         moon_list_append(list, moon_int(rxBuf[i]));
     }
     
-    free(rxBuf);
+    moon_free(rxBuf, 0);
     return list;
 }
 
@@ -279,13 +279,13 @@ MoonValue* moon_uart_write(MoonValue* data) {
     } else if (moon_is_list(data)) {
         MoonList* list = data->data.listVal;
         len = list->length;
-        buf = (uint8_t*)malloc(len);
+        buf = (uint8_t*)moon_alloc(len);
         for (int i = 0; i < len; i++) {
             buf[i] = (uint8_t)moon_to_int(list->items[i]);
         }
         
         int result = moon_hal_uart_write(0, buf, len);
-        free(buf);
+        moon_free(buf, 0);
         return moon_int(result);
     }
     
@@ -299,19 +299,19 @@ MoonValue* moon_uart_read(MoonValue* length) {
         return moon_string("");
     }
     
-    uint8_t* buf = (uint8_t*)malloc(len + 1);
+    uint8_t* buf = (uint8_t*)moon_alloc(len + 1);
     
     // Use UART 0 by default
     int result = moon_hal_uart_read(0, buf, len);
     
     if (result <= 0) {
-        free(buf);
+        moon_free(buf, 0);
         return moon_string("");
     }
     
     buf[result] = '\0';
     MoonValue* str = moon_string((char*)buf);
-    free(buf);
+    moon_free(buf, 0);
     
     return str;
 }
@@ -372,6 +372,6 @@ void moon_hal_debug_print(MoonValue* msg) {
     } else {
         char* str = moon_to_string(msg);
         moon_hal_debug(str);
-        free(str);
+        moon_free(str, 0);
     }
 }
@@ -0,0 +1,1268 @@
+// MoonLang Runtime - HTTP/1.1 Server Module
+// Copyright (c) 2026 greenteng.com
+//
+// Native HTTP/1.1 server (conditionally compiled with the network module).
+// - Incremental request parser producing header views into the receive
+//   buffer (no per-line strings); SSE2 scan for the end of the head
+// - Keep-alive and pipelining: every complete request in the buffer is
+//   answered in order and the responses go out in one write
+// - Chunked request bodies and chunked responses
+// - Router dispatching to MoonLang handlers on the coroutine scheduler
+//
+// One event loop thread (epoll on Linux, poll elsewhere) waits for idle
+// connections; a readable connection is handed to a coroutine which reads,
+// parses, runs handlers and writes, then re-arms the connection.
+//
+// Included from moonrt.cpp after moonrt_network.cpp and shares its helpers.
+
+#include "moonrt_core.h"
+
+#ifdef MOON_HAS_NETWORK
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HTTP_USE_SSE2 1
+#endif
+
+#define HTTP_MAX_HEADERS 64
+#define HTTP_MAX_HEAD_BYTES (64 * 1024)
+#define HTTP_DEFAULT_MAX_BODY (8 * 1024 * 1024)
+#define HTTP_DEFAULT_IDLE_MS 30000
+#define HTTP_READ_CHUNK 16384
+#define HTTP_DIRECT_SEND 16384      // bodies this large skip the output buffer
+#define HTTP_LOOP_TICK_MS 100
+
+// ============================================================================
+// Request Parser
+// ============================================================================
+
+typedef struct {
+    const char* name;
+    size_t name_len;
+    const char* value;
+    size_t value_len;
+} HttpHeaderView;
+
+typedef struct {
+    const char* method;
+    size_t method_len;
+    const char* target;
+    size_t target_len;
+    int minor_version;              // HTTP/1.<minor>
+    HttpHeaderView headers[HTTP_MAX_HEADERS];
+    int header_count;
+    size_t head_len;                // bytes up to and including CRLFCRLF
+    int64_t content_length;         // -1 when absent
+    bool chunked;
+    bool keep_alive;
+} HttpRequestView;
+
+static bool http_ieq(const char* a, size_t alen, const char* b) {
+    size_t blen = strlen(b);
+    if (alen != blen) return false;
+    for (size_t i = 0; i < alen; i++) {
+        if (tolower((unsigned char)a[i]) != b[i]) return false;
+    }
+    return true;
+}
+
+// RFC 9110 5.6.2 tchar: the bytes allowed in a header field name
+static bool http_is_tchar(unsigned char c) {
+    if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) return true;
+    return c != 0 && strchr("!#$%&'*+-.^_`|~", c) != NULL;
+}
+
+// Does the comma-separated header value contain token (case-insensitive)?
+static bool http_has_token(const char* v, size_t len, const char* token) {
+    size_t i = 0;
+    while (i < len) {
+        while (i < len && (v[i] == ' ' || v[i] == '\t' || v[i] == ',')) i++;
+        size_t start = i;
+        while (i < len && v[i] != ',') i++;
+        size_t end = i;
+        while (end > start && (v[end - 1] == ' ' || v[end - 1] == '\t')) end--;
+        if (http_ieq(v + start, end - start, token)) return true;
+    }
+    return false;
+}
+
+// True when the last element of a comma-separated list is token, e.g. the
+// final transfer coding of "gzip, chunked"
+static bool http_last_token_is(const char* v, size_t len, const char* token) {
+    size_t end = len;
+    while (end > 0 && (v[end - 1] == ' ' || v[end - 1] == '\t' || v[end - 1] == ',')) end--;
+    size_t start = end;
+    while (start > 0 && v[start - 1] != ',') start--;
+    while (start < end && (v[start] == ' ' || v[start] == '\t')) start++;
+    return http_ieq(v + start, end - start, token);
+}
+
+// Offset just past "\r\n\r\n", or 0 if the head is not complete yet.
+// from lets repeated calls skip bytes that were already scanned.
+static size_t http_find_head_end(const char* buf, size_t len, size_t from) {
+    size_t i = from;
+#ifdef HTTP_USE_SSE2
+    const __m128i cr = _mm_set1_epi8('\r');
+    while (i + 16 <= len) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(buf + i));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, cr));
+        while (mask) {
+#if defined(_MSC_VER)
+            unsigned long bit;
+            _BitScanForward(&bit, mask);
+#else
+            unsigned bit = (unsigned)__builtin_ctz(mask);
+#endif
+            size_t p = i + bit;
+            if (p + 4 <= len && buf[p + 1] == '\n' && buf[p + 2] == '\r' && buf[p + 3] == '\n') {
+                return p + 4;
+            }
+            mask &= mask - 1;
+        }
+        i += 16;
+    }
+#endif
+    for (; i + 4 <= len; i++) {
+        if (buf[i] == '\r' && buf[i + 1] == '\n' && buf[i + 2] == '\r' && buf[i + 3] == '\n') {
+            return i + 4;
+        }
+    }
+    return 0;
+}
+
+// Parse the request line and headers of a complete head. Views point into
+// buf. Returns false on a malformed request.
+static bool http_parse_head(const char* buf, size_t head_len, HttpRequestView* req) {
+    const char* p = buf;
+    const char* end = buf + head_len - 2;   // stop before the final blank line
+
+    // Tolerate stray CRLFs between pipelined requests (RFC 9112 2.2)
+    while (p < end && (*p == '\r' || *p == '\n')) p++;
+
+    const char* sp = (const char*)memchr(p, ' ', end - p);
+    if (!sp || sp == p) return false;
+    req->method = p;
+    req->method_len = sp - p;
+
+    p = sp + 1;
+    sp = (const char*)memchr(p, ' ', end - p);
+    if (!sp || sp == p) return false;
+    req->target = p;
+    req->target_len = sp - p;
+
+    p = sp + 1;
+    if (end - p < 10 || memcmp(p, "HTTP/1.", 7) != 0 || p[8] != '\r' || p[9] != '\n') return false;
+    req->minor_version = p[7] - '0';
+    if (req->minor_version < 0 || req->minor_version > 1) return false;
+    p += 10;
+
+    req->header_count = 0;
+    req->head_len = head_len;
+    req->content_length = -1;
+    req->chunked = false;
+    req->keep_alive = req->minor_version == 1;
+    bool has_te = false;
+
+    while (p < end) {
+        const char* eol = (const char*)memchr(p, '\r', end - p + 1);
+        if (!eol || eol[1] != '\n') return false;
+        const char* colon = (const char*)memchr(p, ':', eol - p);
+        if (!colon || colon == p) return false;
+        if (req->header_count >= HTTP_MAX_HEADERS) return false;
+        // "Content-Length : 5" must not slip past as an unknown header
+        for (const char* n = p; n < colon; n++) {
+            if (!http_is_tchar((unsigned char)*n)) return false;
+        }
+
+        const char* v = colon + 1;
+        while (v < eol && (*v == ' ' || *v == '\t')) v++;
+        const char* ve = eol;
+        while (ve > v && (ve[-1] == ' ' || ve[-1] == '\t')) ve--;
+
+        HttpHeaderView* h = &req->headers[req->header_count++];
+        h->name = p;
+        h->name_len = colon - p;
+        h->value = v;
+        h->value_len = ve - v;
+
+        if (http_ieq(h->name, h->name_len, "content-length")) {
+            int64_t n = 0;
+            if (h->value_len == 0) return false;
+            for (size_t i = 0; i < h->value_len; i++) {
+                if (h->value[i] < '0' || h->value[i] > '9') return false;
+                n = n * 10 + (h->value[i] - '0');
+                if (n > ((int64_t)1 << 40)) return false;
+            }
+            if (req->content_length >= 0 && req->content_length != n) return false;
+            req->content_length = n;
+        } else if (http_ieq(h->name, h->name_len, "transfer-encoding")) {
+            // A repeated header or a final coding other than chunked leaves
+            // the body length undefined (RFC 9112 6.3); refuse to guess
+            if (has_te || !http_last_token_is(h->value, h->value_len, "chunked")) return false;
+            has_te = true;
+            req->chunked = true;
+        } else if (http_ieq(h->name, h->name_len, "connection")) {
+            if (http_has_token(h->value, h->value_len, "close")) req->keep_alive = false;
+            else if (http_has_token(h->value, h->value_len, "keep-alive")) req->keep_alive = true;
+        }
+        p = eol + 2;
+    }
+
+    // Transfer-Encoding together with Content-Length is a smuggling vector
+    // (RFC 9112 6.1): reject rather than pick one framing
+    if (req->chunked && req->content_length >= 0) return false;
+    return true;
+}
+
+// Measure a chunked body starting at buf. Returns bytes consumed (including
+// trailers) and stores the decoded size, 0 if incomplete, -1 if malformed.
+static int64_t http_chunked_size(const char* buf, size_t len, size_t* decoded) {
+    size_t pos = 0;
+    size_t total = 0;
+    for (;;) {
+        const char* eol = (const char*)memchr(buf + pos, '\n', len - pos);
+        if (!eol) return 0;
+        if (eol == buf + pos || eol[-1] != '\r') return -1;
+        const char* c = buf + pos;
+        const char* cr = eol - 1;
+        size_t size = 0;
+        int digits = 0;
+        for (; c < cr; c++) {
+            int d;
+            if (*c >= '0' && *c <= '9') d = *c - '0';
+            else if (*c >= 'a' && *c <= 'f') d = *c - 'a' + 10;
+            else if (*c >= 'A' && *c <= 'F') d = *c - 'A' + 10;
+            else break;
+            if (++digits > 15) return -1;
+            size = size * 16 + d;
+        }
+        if (size > ((size_t)1 << 40)) return -1;   // Same cap as Content-Length
+        if (digits == 0) return -1;
+        // Only chunk extensions may follow the size: BWS ";" ...
+        while (c < cr && (*c == ' ' || *c == '\t')) c++;
+        if (c < cr && *c != ';') return -1;
+        for (; c < cr; c++) {
+            if (*c == '\r' || *c == '\0') return -1;
+        }
+        pos = (eol - buf) + 1;
+
+        if (size == 0) {
+            // Trailer section ends with an empty line
+            for (;;) {
+                const char* tl = (const char*)memchr(buf + pos, '\n', len - pos);
+                if (!tl) return 0;
+                size_t lineLen = (tl - buf) - pos;
+                pos = (tl - buf) + 1;
+                if (lineLen == 0 || buf[pos - 2] != '\r') return -1;
+                if (lineLen == 1) {
+                    *decoded = total;
+                    return (int64_t)pos;
+                }
+            }
+        }
+        if (len - pos < size + 2) return 0;
+        total += size;
+        pos += size;
+        if (buf[pos] != '\r' || buf[pos + 1] != '\n') return -1;
+        pos += 2;
+    }
+}
+
+// Second pass over a complete chunked body: copy the payload into out
+static void http_chunked_copy(const char* buf, char* out) {
+    size_t pos = 0;
+    for (;;) {
+        size_t size = 0;
+        for (;; pos++) {
+            char c = buf[pos];
+            int d;
+            if (c >= '0' && c <= '9') d = c - '0';
+            else if (c >= 'a' && c <= 'f') d = c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') d = c - 'A' + 10;
+            else break;
+            size = size * 16 + d;
+        }
+        while (buf[pos] != '\n') pos++;     // validated by http_chunked_size
+        pos++;
+        if (size == 0) return;
+        memcpy(out, buf + pos, size);
+        out += size;
+        pos += size + 2;
+    }
+}
+
+// ============================================================================
+// Server and Connection State
+// ============================================================================
+
+typedef struct HttpRoute {
+    char* method;           // "" matches any method
+    char* path;
+    size_t path_len;
+    bool prefix;            // path registered as "/static/*"
+    MoonValue* handler;
+    struct HttpRoute* next;
+} HttpRoute;
+
+typedef struct HttpServer HttpServer;
+
+enum { HTTP_CONN_IDLE = 0, HTTP_CONN_BUSY = 1, HTTP_CONN_CLOSED = 2 };
+
+typedef struct HttpConn {
+    HttpServer* server;
+    MOON_SOCKET sock;
+    volatile long state;
+    int64_t last_active;
+
+    char* in;               // receive buffer
+    size_t in_cap;
+    size_t in_len;
+    size_t scan;            // head-end search resumes here
+
+    char* out;              // pending response bytes (pipelined batch)
+    size_t out_cap;
+    size_t out_len;
+
+    struct HttpConn* prev;
+    struct HttpConn* next;
+} HttpConn;
+
+struct HttpServer {
+    HttpRoute* routes;
+    MOON_SOCKET listener;
+    volatile bool running;
+    size_t max_body;
+    int idle_timeout_ms;
+
+    HttpConn* conns;        // every open connection
+#ifdef __linux__
+    int epfd;
+#endif
+#ifdef _WIN32
+    SRWLOCK lock;
+#else
+    pthread_mutex_t lock;
+#endif
+
+    volatile long active_conns;
+    volatile long total_conns;
+    volatile long total_requests;
+};
+
+static void http_lock(HttpServer* s) {
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&s->lock);
+#else
+    pthread_mutex_lock(&s->lock);
+#endif
+}
+
+static void http_unlock(HttpServer* s) {
+#ifdef _WIN32
+    ReleaseSRWLockExclusive(&s->lock);
+#else
+    pthread_mutex_unlock(&s->lock);
+#endif
+}
+
+static bool http_cas(volatile long* p, long expected, long desired) {
+#ifdef _WIN32
+    return InterlockedCompareExchange(p, desired, expected) == expected;
+#else
+    return __sync_bool_compare_and_swap(p, expected, desired);
+#endif
+}
+
+static void http_count(volatile long* p, long delta) {
+#ifdef _WIN32
+    InterlockedExchangeAdd(p, delta);
+#else
+    __sync_add_and_fetch(p, delta);
+#endif
+}
+
+static HttpServer* http_get_server(MoonValue* v) {
+    return (HttpServer*)(uintptr_t)moon_to_int(v);
+}
+
+// Caller holds the server lock
+static void http_conn_unlink(HttpConn* c) {
+    HttpServer* s = c->server;
+    if (c->prev) c->prev->next = c->next;
+    else s->conns = c->next;
+    if (c->next) c->next->prev = c->prev;
+    c->prev = c->next = NULL;
+}
+
+// Close and release a connection that is no longer on the list
+static void http_conn_destroy(HttpConn* c) {
+    HttpServer* s = c->server;
+#ifdef __linux__
+    epoll_ctl(s->epfd, EPOLL_CTL_DEL, c->sock, NULL);
+#endif
+    closesocket(c->sock);
+    http_count(&s->active_conns, -1);
+    free(c->in);
+    free(c->out);
+    free(c);
+}
+
+static void http_conn_free(HttpConn* c) {
+    http_lock(c->server);
+    http_conn_unlink(c);
+    http_unlock(c->server);
+    http_conn_destroy(c);
+}
+
+// Park the connection until it is readable again. IDLE is published under
+// the lock and the lock is held until epoll_ctl is done: the sweep claims
+// connections under it, and http_conn_free takes it before freeing, so c
+// stays valid here even once the event has fired on another worker.
+static void http_conn_arm(HttpConn* c) {
+    HttpServer* s = c->server;
+    http_lock(s);
+    c->last_active = net_now_ms();
+    c->state = HTTP_CONN_IDLE;
+#ifdef __linux__
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    ev.data.ptr = c;
+    epoll_ctl(s->epfd, EPOLL_CTL_MOD, c->sock, &ev);
+#endif
+    http_unlock(s);
+}
+
+// ============================================================================
+// Response Output
+// ============================================================================
+
+static bool http_out_reserve(HttpConn* c, size_t extra) {
+    if (c->out_len + extra <= c->out_cap) return true;
+    size_t cap = c->out_cap ? c->out_cap : 4096;
+    while (cap < c->out_len + extra) cap *= 2;
+    char* grown = (char*)realloc(c->out, cap);
+    if (!grown) return false;
+    c->out = grown;
+    c->out_cap = cap;
+    return true;
+}
+
+static void http_out_append(HttpConn* c, const char* data, size_t len) {
+    if (!http_out_reserve(c, len)) return;
+    memcpy(c->out + c->out_len, data, len);
+    c->out_len += len;
+}
+
+static void http_out_str(HttpConn* c, const char* s) {
+    http_out_append(c, s, strlen(s));
+}
+
+// Blocking-style send on a non-blocking socket: while the socket buffer is
+// full, park until it drains (or poll when not in a coroutine).
+static bool http_send_all(HttpConn* c, const char* data, size_t len) {
+    int64_t deadline = net_now_ms() + c->server->idle_timeout_ms;
+    while (len > 0) {
+#ifdef _WIN32
+        int n = send(c->sock, data, (int)(len > INT_MAX ? INT_MAX : len), 0);
+        bool wouldBlock = n < 0 && WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+        ssize_t n = send(c->sock, data, len, MSG_NOSIGNAL);
+        bool wouldBlock = n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+#endif
+        if (n > 0) {
+            data += n;
+            len -= (size_t)n;
+            continue;
+        }
+        if (!wouldBlock || net_now_ms() > deadline) return false;
+
+#ifdef _WIN32
+        WSAPOLLFD pfd;
+        pfd.fd = c->sock;
+        pfd.events = POLLOUT;
+        pfd.revents = 0;
+        if (moon_in_coroutine()) {
+            moon_io_wait((int64_t)c->sock, true, (int)(deadline - net_now_ms() + 1));
+        } else {
+            WSAPoll(&pfd, 1, HTTP_LOOP_TICK_MS);
+        }
+#else
+        struct pollfd pfd;
+        pfd.fd = c->sock;
+        pfd.events = POLLOUT;
+        pfd.revents = 0;
+        if (moon_in_coroutine()) {
+            moon_io_wait((int64_t)c->sock, true, (int)(deadline - net_now_ms() + 1));
+        } else {
+            poll(&pfd, 1, HTTP_LOOP_TICK_MS);
+        }
+#endif
+    }
+    return true;
+}
+
+static bool http_flush(HttpConn* c) {
+    if (c->out_len == 0) return true;
+    bool ok = http_send_all(c, c->out, c->out_len);
+    c->out_len = 0;
+    return ok;
+}
+
+static const char* http_status_text(int status) {
+    switch (status) {
+        case 100: return "Continue";
+        case 200: return "OK";
+        case 201: return "Created";
+        case 202: return "Accepted";
+        case 204: return "No Content";
+        case 206: return "Partial Content";
+        case 301: return "Moved Permanently";
+        case 302: return "Found";
+        case 303: return "See Other";
+        case 304: return "Not Modified";
+        case 307: return "Temporary Redirect";
+        case 308: return "Permanent Redirect";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 408: return "Request Timeout";
+        case 409: return "Conflict";
+        case 413: return "Content Too Large";
+        case 415: return "Unsupported Media Type";
+        case 429: return "Too Many Requests";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 502: return "Bad Gateway";
+        case 503: return "Service Unavailable";
+        default:  return "Unknown";
+    }
+}
+
+// Date header value, formatted at most once per second per thread
+static const char* http_date(void) {
+#ifdef _WIN32
+    static __declspec(thread) char buf[40];
+    static __declspec(thread) time_t cached = 0;
+#else
+    static __thread char buf[40];
+    static __thread time_t cached = 0;
+#endif
+    time_t now = time(NULL);
+    if (now != cached) {
+        struct tm tmv;
+#ifdef _WIN32
+        gmtime_s(&tmv, &now);
+#else
+        gmtime_r(&now, &tmv);
+#endif
+        strftime(buf, sizeof(buf), "%a, %d %b %Y %H:%M:%S GMT", &tmv);
+        cached = now;
+    }
+    return buf;
+}
+
+static void http_out_status_line(HttpConn* c, int status, int minor) {
+    char line[96];
+    snprintf(line, sizeof(line), "HTTP/1.%d %d %s\r\nDate: %s\r\n",
+             minor, status, http_status_text(status), http_date());
+    http_out_str(c, line);
+}
+
+static void http_out_connection(HttpConn* c, int minor, bool keep_alive) {
+    if (!keep_alive) http_out_str(c, "Connection: close\r\n");
+    else if (minor == 0) http_out_str(c, "Connection: keep-alive\r\n");
+}
+
+// Plain-text error response generated by the server itself
+static void http_out_error(HttpConn* c, int status, int minor, bool keep_alive) {
+    const char* text = http_status_text(status);
+    char hdr[96];
+    http_out_status_line(c, status, minor);
+    snprintf(hdr, sizeof(hdr), "Content-Type: text/plain\r\nContent-Length: %zu\r\n", strlen(text));
+    http_out_str(c, hdr);
+    http_out_connection(c, minor, keep_alive);
+    http_out_str(c, "\r\n");
+    http_out_str(c, text);
+}
+
+// Append the body, sending large ones directly instead of copying them
+static bool http_out_body(HttpConn* c, const char* body, size_t len) {
+    if (len >= HTTP_DIRECT_SEND) {
+        return http_flush(c) && http_send_all(c, body, len);
+    }
+    http_out_append(c, body, len);
+    return true;
+}
+
+// A handler-supplied header is written only if the name is a token and the
+// value has no CR or LF
+static bool http_header_safe(const char* name, const char* value) {
+    if (!*name) return false;
+    for (const char* p = name; *p; p++) {
+        if (!http_is_tchar((unsigned char)*p)) return false;
+    }
+    return strpbrk(value, "\r\n") == NULL;
+}
+
+// Serialize a handler result:
+//   string               -> 200 text/plain
+//   dict/list (no status) -> 200 application/json
+//   {status, headers, body} or {status, headers, chunks: [...]}
+//   null                 -> 204
+static bool http_out_response(HttpConn* c, MoonValue* res, int minor, bool keep_alive, bool head_only) {
+    int status = 200;
+    MoonValue* headers = NULL;
+    MoonValue* body = NULL;
+    MoonValue* chunks = NULL;
+    const char* defaultType = "text/plain; charset=utf-8";
+    bool ownBody = false;
+
+    if (!res || res->type == MOON_NULL) {
+        status = 204;
+    } else if (res->type == MOON_STRING || res->type == MOON_BUFFER) {
+        body = res;
+    } else if (res->type == MOON_DICT) {
+        MoonValue* st = net_option(res, "status");
+        if (st->type == MOON_NULL) {
+            // A plain dict is a JSON payload
+            moon_release(st);
+            body = moon_json_encode(res);
+            ownBody = true;
+            defaultType = "application/json";
+        } else {
+            status = (int)moon_to_int(st);
+            moon_release(st);
+            headers = net_option(res, "headers");
+            body = net_option(res, "body");
+            chunks = net_option(res, "chunks");
+            ownBody = true;
+            if (body->type == MOON_DICT || body->type == MOON_LIST) {
+                MoonValue* json = moon_json_encode(body);
+                moon_release(body);
+                body = json;
+                defaultType = "application/json";
+            }
+        }
+    } else if (res->type == MOON_LIST) {
+        body = moon_json_encode(res);
+        ownBody = true;
+        defaultType = "application/json";
+    } else {
+        body = moon_string_owned(moon_to_string(res));
+        ownBody = true;
+    }
+
+    http_out_status_line(c, status, minor);
+
+    bool hasType = false;
+    if (headers && headers->type == MOON_DICT) {
+        MoonValue* keys = moon_dict_keys(headers);
+        MoonList* kl = keys->data.listVal;
+        for (int i = 0; i < kl->length; i++) {
+            MoonValue* k = kl->items[i];
+            MoonValue* v = moon_dict_get(headers, k, moon_null());
+            char* ks = moon_to_string(k);
+            char* vs = moon_to_string(v);
+            // A header that could split the response (CR/LF, non-token
+            // name) is dropped; framing headers are always computed here
+            bool safe = http_header_safe(ks, vs);
+            if (safe && http_ieq(ks, strlen(ks), "content-type")) hasType = true;
+            if (safe &&
+                !http_ieq(ks, strlen(ks), "content-length") &&
+                !http_ieq(ks, strlen(ks), "transfer-encoding") &&
+                !http_ieq(ks, strlen(ks), "connection")) {
+                http_out_str(c, ks);
+                http_out_str(c, ": ");
+                http_out_str(c, vs);
+                http_out_str(c, "\r\n");
+            }
+            moon_free(ks, 0);
+            moon_free(vs, 0);
+            moon_release(v);
+        }
+        moon_release(keys);
+    }
+
+    bool ok = true;
+    bool bodyAllowed = status >= 200 && status != 204 && status != 304;
+    if (bodyAllowed && !hasType) {
+        http_out_str(c, "Content-Type: ");
+        http_out_str(c, defaultType);
+        http_out_str(c, "\r\n");
+    }
+    http_out_connection(c, minor, keep_alive);
+
+    if (bodyAllowed && chunks && moon_is_list(chunks) && minor == 1) {
+        http_out_str(c, "Transfer-Encoding: chunked\r\n\r\n");
+        if (!head_only) {
+            MoonList* cl = chunks->data.listVal;
+            for (int i = 0; i < cl->length && ok; i++) {
+                size_t len;
+                char* toFree;
+                const char* p = net_bytes(cl->items[i], &len, &toFree);
+                if (len > 0) {
+                    char size[24];
+                    snprintf(size, sizeof(size), "%zx\r\n", len);
+                    http_out_str(c, size);
+                    ok = http_out_body(c, p, len);
+                    http_out_str(c, "\r\n");
+                }
+                moon_free(toFree, 0);
+            }
+            http_out_str(c, "0\r\n\r\n");
+        }
+    } else if (bodyAllowed) {
+        size_t len = 0;
+        char* toFree = NULL;
+        const char* p = "";
+        if (chunks && moon_is_list(chunks)) {
+            // HTTP/1.0 peer: no chunked encoding, join the pieces instead
+            MoonList* cl = chunks->data.listVal;
+            for (int i = 0; i < cl->length; i++) {
+                size_t n;
+                char* tf;
+                net_bytes(cl->items[i], &n, &tf);
+                len += n;
+                moon_free(tf, 0);
+            }
+            toFree = (char*)malloc(len + 1);
+            size_t off = 0;
+            for (int i = 0; i < cl->length && toFree; i++) {
+                size_t n;
+                char* tf;
+                const char* piece = net_bytes(cl->items[i], &n, &tf);
+                memcpy(toFree + off, piece, n);
+                off += n;
+                moon_free(tf, 0);
+            }
+            p = toFree ? toFree : "";
+            if (!toFree) len = 0;
+        } else if (body && body->type != MOON_NULL) {
+            p = net_bytes(body, &len, &toFree);
+        }
+        char cl[48];
+        snprintf(cl, sizeof(cl), "Content-Length: %zu\r\n\r\n", len);
+        http_out_str(c, cl);
+        if (!head_only) ok = http_out_body(c, p, len);
+        moon_free(toFree, 0);
+    } else {
+        http_out_str(c, "\r\n");
+    }
+
+    if (ownBody && body) moon_release(body);
+    if (headers) moon_release(headers);
+    if (chunks) moon_release(chunks);
+    return ok;
+}
+
+// ============================================================================
+// Request Dispatch
+// ============================================================================
+
+static HttpRoute* http_match(HttpServer* s, HttpRequestView* req, size_t path_len) {
+    HttpRoute* best = NULL;
+    for (HttpRoute* r = s->routes; r; r = r->next) {
+        if (r->method[0] && !(strlen(r->method) == req->method_len &&
+                              memcmp(r->method, req->method, req->method_len) == 0)) {
+            continue;
+        }
+        if (r->prefix) {
+            // Longest matching prefix wins
+            if (path_len >= r->path_len && memcmp(req->target, r->path, r->path_len) == 0 &&
+                (!best || (best->prefix && r->path_len > best->path_len))) {
+                best = r;
+            }
+        } else if (path_len == r->path_len && memcmp(req->target, r->path, path_len) == 0) {
+            return r;   // Exact match beats any prefix
+        }
+    }
+    return best;
+}
+
+static void http_dict_put(MoonValue* dict, const char* key, MoonValue* val) {
+    MoonValue* k = moon_string(key);
+    moon_dict_set(dict, k, val);
+    moon_release(k);
+    moon_release(val);
+}
+
+static MoonValue* http_string_n(const char* s, size_t len) {
+    return moon_string_owned(moon_str_with_capacity(s, len, len));
+}
+
+// Materialize the request for a MoonLang handler:
+//   {method, path, query, version, headers: {lowercased name: value}, body}
+static MoonValue* http_request_value(HttpRequestView* req, size_t path_len, MoonValue* body) {
+    MoonValue* r = moon_dict_new();
+    http_dict_put(r, "method", http_string_n(req->method, req->method_len));
+    http_dict_put(r, "path", http_string_n(req->target, path_len));
+    if (path_len < req->target_len) {
+        http_dict_put(r, "query", http_string_n(req->target + path_len + 1, req->target_len - path_len - 1));
+    } else {
+        http_dict_put(r, "query", moon_string(""));
+    }
+    http_dict_put(r, "version", moon_string(req->minor_version == 1 ? "HTTP/1.1" : "HTTP/1.0"));
+
+    MoonValue* headers = moon_dict_new();
+    char name[256];
+    for (int i = 0; i < req->header_count; i++) {
+        HttpHeaderView* h = &req->headers[i];
+        size_t n = h->name_len < sizeof(name) - 1 ? h->name_len : sizeof(name) - 1;
+        for (size_t j = 0; j < n; j++) name[j] = (char)tolower((unsigned char)h->name[j]);
+        name[n] = '\0';
+        http_dict_put(headers, name, http_string_n(h->value, h->value_len));
+    }
+    http_dict_put(r, "headers", headers);
+    moon_retain(body);
+    http_dict_put(r, "body", body);
+    return r;
+}
+
+// Handle every complete request in the input buffer. Returns false when
+// the connection must be closed after flushing.
+static bool http_process(HttpConn* c) {
+    HttpServer* s = c->server;
+    size_t pos = 0;
+    bool keep = true;
+
+    while (keep && s->running) {
+        const char* buf = c->in + pos;
+        size_t avail = c->in_len - pos;
+        if (avail == 0) break;
+
+        size_t head = http_find_head_end(buf, avail, c->scan > pos ? c->scan - pos : 0);
+        if (head == 0) {
+            if (avail > HTTP_MAX_HEAD_BYTES) {
+                http_out_error(c, 431, 1, false);
+                return false;
+            }
+            c->scan = c->in_len >= 3 ? c->in_len - 3 : 0;
+            break;
+        }
+
+        HttpRequestView req;
+        if (!http_parse_head(buf, head, &req)) {
+            http_out_error(c, 400, 1, false);
+            return false;
+        }
+
+        // Body
+        MoonValue* body;
+        size_t consumed = head;
+        if (req.chunked) {
+            size_t decoded = 0;
+            int64_t n = http_chunked_size(buf + head, avail - head, &decoded);
+            if (n < 0) {
+                http_out_error(c, 400, req.minor_version, false);
+                return false;
+            }
+            if (n == 0) {
+                if (avail - head > s->max_body + 4096) {
+                    http_out_error(c, 413, req.minor_version, false);
+                    return false;
+                }
+                break;  // Need more data
+            }
+            if (decoded > s->max_body) {
+                http_out_error(c, 413, req.minor_version, false);
+                return false;
+            }
+            char* b = moon_str_buffer(decoded);
+            http_chunked_copy(buf + head, b);
+            body = moon_str_finish(b, decoded);
+            consumed += (size_t)n;
+        } else if (req.content_length > 0) {
+            if ((size_t)req.content_length > s->max_body) {
+                http_out_error(c, 413, req.minor_version, false);
+                return false;
+            }
+            if (avail - head < (size_t)req.content_length) break;  // Need more data
+            body = http_string_n(buf + head, (size_t)req.content_length);
+            consumed += (size_t)req.content_length;
+        } else {
+            body = moon_string("");
+        }
+
+        keep = req.keep_alive;
+        size_t path_len = req.target_len;
+        const char* q = (const char*)memchr(req.target, '?', req.target_len);
+        if (q) path_len = q - req.target;
+        bool head_only = req.method_len == 4 && memcmp(req.method, "HEAD", 4) == 0;
+
+        http_count(&s->total_requests, 1);
+        HttpRoute* route = http_match(s, &req, path_len);
+        if (!route && head_only) {
+            // HEAD falls back to the GET route
+            req.method = "GET";
+            req.method_len = 3;
+            route = http_match(s, &req, path_len);
+            req.method = "HEAD";
+            req.method_len = 4;
+        }
+
+        bool ok;
+        if (route) {
+            MoonValue* reqVal = http_request_value(&req, path_len, body);
+            MoonValue* args[1] = { reqVal };
+            MoonValue* res = moon_call_func(route->handler, args, 1);
+            ok = http_out_response(c, res, req.minor_version, keep, head_only);
+            if (res) moon_release(res);
+            moon_release(reqVal);
+        } else {
+            http_out_error(c, 404, req.minor_version, keep);
+            ok = true;
+        }
+        moon_release(body);
+        if (!ok) return false;
+
+        pos += consumed;
+        c->scan = pos;
+    }
+
+    // Drop consumed requests, keep any partial one
+    if (pos > 0) {
+        memmove(c->in, c->in + pos, c->in_len - pos);
+        c->in_len -= pos;
+        c->scan = c->scan > pos ? c->scan - pos : 0;
+    }
+    return keep && s->running;
+}
+
+// Coroutine body: drain the socket, answer complete requests, re-arm.
+static MoonValue* http_conn_service(MoonValue** args, int argc) {
+    (void)argc;
+    HttpConn* c = (HttpConn*)(uintptr_t)moon_to_int(args[0]);
+    HttpServer* s = c->server;
+    bool open = true;
+    bool eof = false;
+
+    for (;;) {
+        if (c->in_cap - c->in_len < HTTP_READ_CHUNK) {
+            size_t limit = HTTP_MAX_HEAD_BYTES + s->max_body + 4096;
+            size_t cap = c->in_cap ? c->in_cap * 2 : HTTP_READ_CHUNK * 2;
+            if (cap > limit) cap = limit;
+            if (cap <= c->in_cap) break;    // Full: let the parser reject it
+            char* grown = (char*)realloc(c->in, cap);
+            if (!grown) {
+                open = false;
+                break;
+            }
+            c->in = grown;
+            c->in_cap = cap;
+        }
+        int n = recv(c->sock, c->in + c->in_len, (int)(c->in_cap - c->in_len), 0);
+        if (n > 0) {
+            c->in_len += (size_t)n;
+            continue;
+        }
+        if (n == 0) {
+            eof = true;     // Peer closed or half-closed: still answer what it sent
+        } else {
+#ifdef _WIN32
+            if (WSAGetLastError() != WSAEWOULDBLOCK) open = false;
+#else
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) open = false;
+#endif
+        }
+        break;
+    }
+
+    if (open && c->in_len > 0) {
+        open = http_process(c);
+    }
+    if (!http_flush(c)) open = false;
+
+    if (open && !eof && s->running) {
+        http_conn_arm(c);
+    } else {
+        c->state = HTTP_CONN_CLOSED;
+        http_conn_free(c);
+    }
+    return moon_null();
+}
+
+static void http_dispatch(HttpConn* c) {
+    if (!http_cas(&c->state, HTTP_CONN_IDLE, HTTP_CONN_BUSY)) return;
+    MoonValue* arg = moon_int((int64_t)(uintptr_t)c);
+    MoonValue* args[1] = { arg };
+    moon_async_call(http_conn_service, args, 1);
+    moon_release(arg);
+}
+
+// ============================================================================
+// Event Loop
+// ============================================================================
+
+static void http_accept_ready(HttpServer* s) {
+    for (;;) {
+        struct sockaddr_storage addr;
+        MOON_SOCKET sock = tcp_accept_socket(s->listener, &addr, true, false);
+        if (sock == INVALID_SOCKET) return;
+
+        HttpConn* c = (HttpConn*)calloc(1, sizeof(HttpConn));
+        if (!c) {
+            closesocket(sock);
+            continue;
+        }
+        c->server = s;
+        c->sock = sock;
+        c->state = HTTP_CONN_IDLE;
+        c->last_active = net_now_ms();
+
+        http_lock(s);
+        c->next = s->conns;
+        if (s->conns) s->conns->prev = c;
+        s->conns = c;
+        http_unlock(s);
+        http_count(&s->active_conns, 1);
+        http_count(&s->total_conns, 1);
+
+#ifdef __linux__
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        ev.data.ptr = c;
+        epoll_ctl(s->epfd, EPOLL_CTL_ADD, sock, &ev);
+#endif
+    }
+}
+
+// Close connections that have been idle longer than idle_timeout_ms
+static void http_sweep_idle(HttpServer* s, bool all) {
+    int64_t now = net_now_ms();
+    std::vector<HttpConn*> expired;
+
+    // Claim and unlink under the lock; close the sockets after dropping it
+    http_lock(s);
+    for (HttpConn* c = s->conns; c; ) {
+        HttpConn* next = c->next;
+        if ((all || now - c->last_active > s->idle_timeout_ms) &&
+            http_cas(&c->state, HTTP_CONN_IDLE, HTTP_CONN_CLOSED)) {
+            http_conn_unlink(c);
+            expired.push_back(c);
+        }
+        c = next;
+    }
+    http_unlock(s);
+
+    for (HttpConn* c : expired) http_conn_destroy(c);
+}
+
+static void http_event_loop(HttpServer* s) {
+    int64_t lastSweep = net_now_ms();
+
+#ifdef __linux__
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;     // NULL marks the listener
+    epoll_ctl(s->epfd, EPOLL_CTL_ADD, s->listener, &ev);
+
+    struct epoll_event events[256];
+    while (s->running) {
+        int n = epoll_wait(s->epfd, events, 256, HTTP_LOOP_TICK_MS);
+        for (int i = 0; i < n; i++) {
+            if (!events[i].data.ptr) http_accept_ready(s);
+            else http_dispatch((HttpConn*)events[i].data.ptr);
+        }
+        if (net_now_ms() - lastSweep >= 1000) {
+            http_sweep_idle(s, false);
+            lastSweep = net_now_ms();
+        }
+    }
+#else
+    // Portable fallback: poll the listener plus every idle connection
+    int cap = 256;
+#ifdef _WIN32
+    WSAPOLLFD* pfds = (WSAPOLLFD*)malloc(sizeof(WSAPOLLFD) * cap);
+#else
+    struct pollfd* pfds = (struct pollfd*)malloc(sizeof(struct pollfd) * cap);
+#endif
+    HttpConn** owners = (HttpConn**)malloc(sizeof(HttpConn*) * cap);
+
+    while (s->running && pfds && owners) {
+        int n = 0;
+        pfds[n].fd = s->listener;
+        pfds[n].events = POLLIN;
+        pfds[n].revents = 0;
+        owners[n++] = NULL;
+
+        http_lock(s);
+        for (HttpConn* c = s->conns; c; c = c->next) {
+            if (c->state != HTTP_CONN_IDLE) continue;
+            if (n == cap) {
+                cap *= 2;
+                pfds = (decltype(pfds))realloc(pfds, sizeof(*pfds) * cap);
+                owners = (HttpConn**)realloc(owners, sizeof(HttpConn*) * cap);
+                if (!pfds || !owners) break;
+            }
+            pfds[n].fd = c->sock;
+            pfds[n].events = POLLIN;
+            pfds[n].revents = 0;
+            owners[n++] = c;
+        }
+        http_unlock(s);
+        if (!pfds || !owners) break;
+
+        // Short timeout: connections re-armed by workers join the next round
+#ifdef _WIN32
+        int ready = WSAPoll(pfds, n, 10);
+#else
+        int ready = poll(pfds, n, 10);
+#endif
+        for (int i = 0; ready > 0 && i < n; i++) {
+            if (!pfds[i].revents) continue;
+            if (!owners[i]) http_accept_ready(s);
+            else http_dispatch(owners[i]);
+        }
+        if (net_now_ms() - lastSweep >= 1000) {
+            http_sweep_idle(s, false);
+            lastSweep = net_now_ms();
+        }
+    }
+    free(pfds);
+    free(owners);
+#endif
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+// http_server() - create a server; add routes, then http_serve()
+MoonValue* moon_http_server(void) {
+    HttpServer* s = (HttpServer*)calloc(1, sizeof(HttpServer));
+    if (!s) return moon_null();
+    s->listener = INVALID_SOCKET;
+    s->max_body = HTTP_DEFAULT_MAX_BODY;
+    s->idle_timeout_ms = HTTP_DEFAULT_IDLE_MS;
+#ifdef _WIN32
+    InitializeSRWLock(&s->lock);
+#else
+    pthread_mutex_init(&s->lock, NULL);
+#endif
+    return moon_int((int64_t)(uintptr_t)s);
+}
+
+// http_route(server, method, path, handler) - method "" or "*" matches any;
+// a path ending in "*" matches by prefix. handler(request) returns a
+// string, a dict/list (sent as JSON), or {status, headers, body|chunks}.
+MoonValue* moon_http_route(MoonValue* server, MoonValue* method, MoonValue* path, MoonValue* handler) {
+    HttpServer* s = http_get_server(server);
+    if (!s || !moon_is_string(path) || !handler ||
+        (handler->type != MOON_FUNC && handler->type != MOON_CLOSURE)) {
+        return moon_bool(false);
+    }
+
+    HttpRoute* r = (HttpRoute*)calloc(1, sizeof(HttpRoute));
+    if (!r) return moon_bool(false);
+    const char* m = moon_is_string(method) ? method->data.strVal : "";
+    r->method = strdup(strcmp(m, "*") == 0 ? "" : m);
+    for (char* p = r->method; *p; p++) *p = (char)toupper((unsigned char)*p);
+    r->path = strdup(path->data.strVal);
+    r->path_len = strlen(r->path);
+    if (r->path_len > 0 && r->path[r->path_len - 1] == '*') {
+        r->prefix = true;
+        r->path[--r->path_len] = '\0';
+    }
+    moon_retain(handler);
+    r->handler = handler;
+
+    // Append so earlier registrations win ties
+    http_lock(s);
+    HttpRoute** tail = &s->routes;
+    while (*tail) tail = &(*tail)->next;
+    *tail = r;
+    http_unlock(s);
+    return moon_bool(true);
+}
+
+// http_serve(server, port[, options]) - run the server on the calling
+// thread until http_stop(). options: tcp_listen options plus
+// max_body (bytes) and idle_timeout (ms). Returns false if the port
+// can't be bound.
+MoonValue* moon_http_serve(MoonValue* server, MoonValue* port, MoonValue* options) {
+    HttpServer* s = http_get_server(server);
+    if (!s || s->running) return moon_bool(false);
+    init_wsa();
+
+    TcpListenOptions opts;
+    tcp_parse_listen_options(options, &opts);
+    if (options && options->type == MOON_DICT) {
+        MoonValue* v = net_option(options, "max_body");
+        if (v->type != MOON_NULL && moon_to_int(v) > 0) s->max_body = (size_t)moon_to_int(v);
+        moon_release(v);
+        v = net_option(options, "idle_timeout");
+        if (v->type != MOON_NULL && moon_to_int(v) > 0) s->idle_timeout_ms = (int)moon_to_int(v);
+        moon_release(v);
+        v = net_option(options, "nodelay");
+        if (v->type == MOON_NULL) opts.nodelay = true;
+        moon_release(v);
+    } else {
+        opts.nodelay = true;    // Small responses should not wait for Nagle
+    }
+
+    s->listener = tcp_open_listener((int)moon_to_int(port), &opts);
+    if (s->listener == INVALID_SOCKET) return moon_bool(false);
+    net_set_blocking(s->listener, false);
+
+#ifdef __linux__
+    s->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (s->epfd < 0) {
+        closesocket(s->listener);
+        s->listener = INVALID_SOCKET;
+        return moon_bool(false);
+    }
+#endif
+
+    s->running = true;
+    http_event_loop(s);
+
+    // Shutdown: stop accepting, close idle connections; busy ones close
+    // themselves once their handler returns
+    closesocket(s->listener);
+    s->listener = INVALID_SOCKET;
+    while (s->active_conns > 0) {
+        http_sweep_idle(s, true);
+        if (s->active_conns > 0) {
+#ifdef _WIN32
+            Sleep(1);
+#else
+            usleep(1000);
+#endif
+        }
+    }
+#ifdef __linux__
+    close(s->epfd);
+    s->epfd = -1;
+#endif
+    return moon_bool(true);
+}
+
+// http_stop(server) - make http_serve() return (callable from a handler)
+void moon_http_stop(MoonValue* server) {
+    HttpServer* s = http_get_server(server);
+    if (s) s->running = false;
+}
+
+// http_server_stats(server) - {connections, active, requests}
+MoonValue* moon_http_server_stats(MoonValue* server) {
+    HttpServer* s = http_get_server(server);
+    MoonValue* d = moon_dict_new();
+    if (!s) return d;
+    http_dict_put(d, "connections", moon_int(s->total_conns));
+    http_dict_put(d, "active", moon_int(s->active_conns));
+    http_dict_put(d, "requests", moon_int(s->total_requests));
+    return d;
+}
+
+#else // !MOON_HAS_NETWORK
+
+MoonValue* moon_http_server(void) { return moon_null(); }
+MoonValue* moon_http_route(MoonValue* server, MoonValue* method, MoonValue* path, MoonValue* handler) { return moon_bool(false); }
+MoonValue* moon_http_serve(MoonValue* server, MoonValue* port, MoonValue* options) { return moon_bool(false); }
+void moon_http_stop(MoonValue* server) { }
+MoonValue* moon_http_server_stats(MoonValue* server) { return moon_dict_new(); }
+
+#endif // MOON_HAS_NETWORK
@@ -0,0 +1,967 @@
+// MoonLang Runtime - HTTP Client Module
+// Copyright (c) 2026 greenteng.com
+//
+// HTTP/1.1 client: http_get / http_post / http_request.
+// - Keep-alive pool per host:port (plain TCP here, https through the
+//   TLS connection pool with session resumption)
+// - Content-Length, chunked and read-to-close bodies, optionally streamed
+//   with http_read()
+// - gzip/deflate decoding when zlib is available at run time
+// - Inside a coroutine every wait parks on the async reactor, so many
+//   concurrent requests share the worker threads
+
+#include "moonrt_core.h"
+#include "moonrt_tls.h"
+
+#ifdef MOON_HAS_NETWORK
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#define MOON_SOCKET SOCKET
+#define HC_INVALID_SOCKET INVALID_SOCKET
+#define hc_closesocket closesocket
+#define strncasecmp _strnicmp
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/time.h>
+#define MOON_SOCKET int
+#define HC_INVALID_SOCKET -1
+#define hc_closesocket close
+#endif
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<zlib.h>)
+#include <zlib.h>
+#define HC_HAS_ZLIB 1
+#endif
+#endif
+
+#define HC_TIMEOUT_MS 30000
+#define HC_POOL_MAX_IDLE 8              // Per host
+#define HC_POOL_IDLE_MS 30000
+#define HC_MAX_HEAD (64 * 1024)
+#define HC_MAX_SIZE (64 * 1024 * 1024)  // Default limit for buffered bodies
+#define HC_IO_CHUNK 16384
+#define HC_MAX_CHUNK ((int64_t)1 << 40)  // Larger chunk sizes fail the request
+
+#ifdef HC_HAS_ZLIB
+static const MoonZlib* g_hc_zlib = NULL;
+
+static bool hc_zlib_available() {
+    if (!g_hc_zlib) g_hc_zlib = moon_zlib();
+    return g_hc_zlib != NULL;
+}
+#endif
+
+// ============================================================================
+// Keep-Alive Pool (plain TCP)
+// ============================================================================
+
+typedef struct {
+    MOON_SOCKET sock;
+    int64_t idle_since;
+} HcIdleConn;
+
+static std::unordered_map<std::string, std::vector<HcIdleConn>> g_hc_pool;
+
+#ifdef _WIN32
+static SRWLOCK g_hc_lock = SRWLOCK_INIT;
+static void hc_lock() { AcquireSRWLockExclusive(&g_hc_lock); }
+static void hc_unlock() { ReleaseSRWLockExclusive(&g_hc_lock); }
+#else
+static pthread_mutex_t g_hc_lock = PTHREAD_MUTEX_INITIALIZER;
+static void hc_lock() { pthread_mutex_lock(&g_hc_lock); }
+static void hc_unlock() { pthread_mutex_unlock(&g_hc_lock); }
+#endif
+
+static int64_t hc_now_ms() {
+#ifdef _WIN32
+    return (int64_t)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
+
+static int hc_poll(MOON_SOCKET sock, short events, int timeout_ms) {
+#ifdef _WIN32
+    WSAPOLLFD pfd;
+    pfd.fd = sock;
+    pfd.events = events;
+    pfd.revents = 0;
+    return WSAPoll(&pfd, 1, timeout_ms);
+#else
+    struct pollfd pfd;
+    pfd.fd = sock;
+    pfd.events = events;
+    pfd.revents = 0;
+    int n;
+    do {
+        n = poll(&pfd, 1, timeout_ms);
+    } while (n < 0 && errno == EINTR);
+    return n;
+#endif
+}
+
+// Wait for the socket to become ready. Inside a coroutine the wait parks
+// on the reactor; elsewhere it blocks in poll(). False on timeout.
+static bool hc_wait(MOON_SOCKET sock, short events, int64_t deadline) {
+    int64_t left = deadline - hc_now_ms();
+    if (left <= 0) return false;
+    if (moon_in_coroutine()) {
+        return moon_io_wait((int64_t)sock, (events & POLLOUT) != 0, (int)left) != 0;
+    }
+    return hc_poll(sock, events, (int)left) != 0;   // Ready, or an error recv/send will report
+}
+
+// An idle keep-alive connection is reusable only if nothing is readable:
+// readable means the server closed it (or sent something unexpected)
+static bool hc_idle_alive(MOON_SOCKET sock) {
+    return hc_poll(sock, POLLIN, 0) == 0;
+}
+
+static MOON_SOCKET hc_pool_take(const std::string& key) {
+    int64_t now = hc_now_ms();
+    for (;;) {
+        HcIdleConn c;
+        hc_lock();
+        auto it = g_hc_pool.find(key);
+        if (it == g_hc_pool.end() || it->second.empty()) {
+            hc_unlock();
+            return HC_INVALID_SOCKET;
+        }
+        c = it->second.back();   // Most recently used first
+        it->second.pop_back();
+        hc_unlock();
+
+        if (now - c.idle_since <= HC_POOL_IDLE_MS && hc_idle_alive(c.sock)) return c.sock;
+        hc_closesocket(c.sock);
+    }
+}
+
+static void hc_pool_put(const std::string& key, MOON_SOCKET sock) {
+    HcIdleConn c;
+    c.sock = sock;
+    c.idle_since = hc_now_ms();
+    MOON_SOCKET evicted = HC_INVALID_SOCKET;
+
+    hc_lock();
+    std::vector<HcIdleConn>& idle = g_hc_pool[key];
+    if ((int)idle.size() >= HC_POOL_MAX_IDLE) {
+        evicted = idle.front().sock;
+        idle.erase(idle.begin());
+    }
+    idle.push_back(c);
+    hc_unlock();
+
+    if (evicted != HC_INVALID_SOCKET) hc_closesocket(evicted);
+}
+
+// ============================================================================
+// Response Stream
+// ============================================================================
+
+enum { HC_BODY_NONE, HC_BODY_LENGTH, HC_BODY_CHUNKED, HC_BODY_CLOSE };
+enum { HC_CHUNK_SIZE, HC_CHUNK_DATA, HC_CHUNK_CRLF, HC_CHUNK_TRAILER };
+
+typedef struct {
+    MOON_SOCKET sock;
+    void* tls;              // TLS connection for https, NULL for plain TCP
+    std::string* pool_key;  // host:port for the plain pool
+    int timeout_ms;         // Inactivity timeout for each wait
+
+    char* buf;              // Bytes received but not consumed yet
+    size_t cap;
+    size_t start;
+    size_t end;
+    bool got_data;          // Anything received on this request
+
+    int mode;
+    int64_t remaining;      // LENGTH: bytes left; CHUNKED: left in this chunk
+    int chunk_state;
+    bool keep_alive;
+    bool done;
+    bool failed;
+
+#ifdef HC_HAS_ZLIB
+    z_stream* z;
+    char* zin;
+    size_t zin_len;         // Size of the first compressed block (raw retry)
+    bool zraw_tried;
+    bool zdone;
+#endif
+} HcStream;
+
+static int hc_recv(HcStream* s, char* buf, int len) {
+    if (!(s->tls && moon_tls_conn_pending(s->tls) > 0)) {
+        if (!hc_wait(s->sock, POLLIN, hc_now_ms() + s->timeout_ms)) return -1;
+    }
+    int n = s->tls ? moon_tls_conn_read(s->tls, buf, len) : (int)recv(s->sock, buf, len, 0);
+    if (n > 0) s->got_data = true;
+    return n;
+}
+
+static bool hc_send(HcStream* s, const char* data, size_t len) {
+    if (s->tls) return moon_tls_conn_write(s->tls, data, (int)len) == (int)len;
+    while (len > 0) {
+#ifdef _WIN32
+        int n = send(s->sock, data, (int)len, 0);
+#else
+        ssize_t n = send(s->sock, data, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+#endif
+        if (n <= 0) return false;
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+// Read more bytes into the stream buffer. Returns bytes read, <= 0 on EOF/error.
+static int hc_fill(HcStream* s) {
+    if (s->start == s->end) {
+        s->start = s->end = 0;
+    } else if (s->end == s->cap && s->start > 0) {
+        memmove(s->buf, s->buf + s->start, s->end - s->start);
+        s->end -= s->start;
+        s->start = 0;
+    }
+    if (s->end == s->cap) {
+        if (s->cap >= HC_MAX_HEAD + HC_IO_CHUNK) return -1;
+        char* grown = (char*)realloc(s->buf, s->cap * 2);
+        if (!grown) return -1;
+        s->buf = grown;
+        s->cap *= 2;
+    }
+    int n = hc_recv(s, s->buf + s->end, (int)(s->cap - s->end));
+    if (n > 0) s->end += (size_t)n;
+    return n;
+}
+
+// Next line in the buffer (without CRLF), reading more as needed
+static const char* hc_line(HcStream* s, size_t* len) {
+    size_t scanned = s->start;
+    for (;;) {
+        const char* nl = (const char*)memchr(s->buf + scanned, '\n', s->end - scanned);
+        if (nl) {
+            const char* line = s->buf + s->start;
+            size_t n = nl - line;
+            s->start += n + 1;
+            if (n > 0 && line[n - 1] == '\r') n--;
+            *len = n;
+            return line;
+        }
+        if (s->end - s->start > 8192) return NULL;
+        size_t offset = s->end - s->start;
+        if (hc_fill(s) <= 0) return NULL;
+        scanned = s->start + offset;
+    }
+}
+
+// Transfer-decoded body bytes. Returns > 0 bytes, 0 at the end, -1 on error.
+static int hc_body_raw(HcStream* s, char* out, int cap) {
+    for (;;) {
+        if (s->done) return 0;
+        if (s->failed) return -1;
+
+        switch (s->mode) {
+        case HC_BODY_NONE:
+            s->done = true;
+            return 0;
+
+        case HC_BODY_CHUNKED:
+            if (s->chunk_state == HC_CHUNK_SIZE) {
+                size_t len;
+                const char* line = hc_line(s, &len);
+                if (!line) break;
+                int64_t size = 0;
+                size_t i = 0;
+                for (; i < len; i++) {
+                    char c = line[i];
+                    int d;
+                    if (c >= '0' && c <= '9') d = c - '0';
+                    else if (c >= 'a' && c <= 'f') d = c - 'a' + 10;
+                    else if (c >= 'A' && c <= 'F') d = c - 'A' + 10;
+                    else break;
+                    if (i == 15) {          // 15 hex digits cannot overflow int64
+                        size = -1;
+                        break;
+                    }
+                    size = size * 16 + d;
+                }
+                if (i == 0 || size < 0 || size > HC_MAX_CHUNK) break;
+                // Only a chunk extension may follow the size: BWS ";" ...
+                while (i < len && (line[i] == ' ' || line[i] == '\t')) i++;
+                if (i < len && line[i] != ';') break;
+                s->remaining = size;
+                s->chunk_state = size == 0 ? HC_CHUNK_TRAILER : HC_CHUNK_DATA;
+                continue;
+            }
+            if (s->chunk_state == HC_CHUNK_CRLF) {
+                size_t len;
+                const char* line = hc_line(s, &len);
+                if (!line || len != 0) break;
+                s->chunk_state = HC_CHUNK_SIZE;
+                continue;
+            }
+            if (s->chunk_state == HC_CHUNK_TRAILER) {
+                size_t len;
+                const char* line = hc_line(s, &len);
+                if (!line) break;
+                if (len == 0) s->done = true;
+                continue;
+            }
+            // HC_CHUNK_DATA: same as a Content-Length body
+            /* fall through */
+        case HC_BODY_LENGTH: {
+            if (s->remaining < 0) break;
+            if (s->remaining == 0) {
+                if (s->mode == HC_BODY_CHUNKED) s->chunk_state = HC_CHUNK_CRLF;
+                else s->done = true;
+                continue;
+            }
+            int want = s->remaining < cap ? (int)s->remaining : cap;
+            int n;
+            if (s->start < s->end) {
+                n = (int)(s->end - s->start) < want ? (int)(s->end - s->start) : want;
+                memcpy(out, s->buf + s->start, n);
+                s->start += n;
+            } else {
+                // Nothing buffered: read straight into the caller's buffer
+                n = hc_recv(s, out, want);
+                if (n <= 0) break;
+            }
+            s->remaining -= n;
+            return n;
+        }
+
+        case HC_BODY_CLOSE: {
+            if (s->start < s->end) {
+                int n = (int)(s->end - s->start) < cap ? (int)(s->end - s->start) : cap;
+                memcpy(out, s->buf + s->start, n);
+                s->start += n;
+                return n;
+            }
+            int n = hc_recv(s, out, cap);
+            if (n == 0) {
+                s->done = true;
+                return 0;
+            }
+            if (n < 0) break;
+            return n;
+        }
+        }
+
+        s->failed = true;
+        return -1;
+    }
+}
+
+// Body bytes after content decoding
+static int hc_body_read(HcStream* s, char* out, int cap) {
+#ifdef HC_HAS_ZLIB
+    z_stream* z = s->z;
+    if (z) {
+        for (;;) {
+            if (s->zdone) {
+                // Consume anything after the compressed stream so the
+                // connection can be reused
+                char sink[512];
+                int n;
+                while ((n = hc_body_raw(s, sink, sizeof(sink))) > 0) {}
+                return n;
+            }
+            if (z->avail_in == 0) {
+                int n = hc_body_raw(s, s->zin, HC_IO_CHUNK);
+                if (n <= 0) return n;
+                if (!s->zin_len) s->zin_len = (size_t)n;
+                z->next_in = (Bytef*)s->zin;
+                z->avail_in = (uInt)n;
+            }
+            z->next_out = (Bytef*)out;
+            z->avail_out = (uInt)cap;
+            int r = g_hc_zlib->inflate(z, Z_NO_FLUSH);
+            if (r == Z_DATA_ERROR && z->total_out == 0 && !s->zraw_tried) {
+                // Some servers send raw deflate for "deflate"
+                s->zraw_tried = true;
+                g_hc_zlib->inflateEnd(z);
+                memset(z, 0, sizeof(z_stream));
+                if (g_hc_zlib->inflateInit2_(z, -MAX_WBITS, ZLIB_VERSION, (int)sizeof(z_stream)) != Z_OK) return -1;
+                z->next_in = (Bytef*)s->zin;
+                z->avail_in = (uInt)s->zin_len;
+                continue;
+            }
+            if (r == Z_STREAM_END) s->zdone = true;
+            else if (r != Z_OK && r != Z_BUF_ERROR) {
+                s->failed = true;
+                return -1;
+            }
+            int produced = cap - (int)z->avail_out;
+            if (produced > 0) return produced;
+        }
+    }
+#endif
+    return hc_body_raw(s, out, cap);
+}
+
+static void hc_stream_free(HcStream* s) {
+#ifdef HC_HAS_ZLIB
+    if (s->z) {
+        g_hc_zlib->inflateEnd(s->z);
+        free(s->z);
+    }
+    free(s->zin);
+#endif
+    free(s->buf);
+    delete s->pool_key;
+    free(s);
+}
+
+// Return the connection to its pool when the response was read completely
+// and the server allows reuse; close it otherwise.
+static void hc_stream_finish(HcStream* s) {
+    bool reuse = s->done && !s->failed && s->keep_alive && s->start == s->end;
+    if (s->tls) {
+        MoonValue* conn = moon_int((int64_t)(uintptr_t)s->tls);
+        if (reuse) moon_release(moon_tls_pool_put(conn));
+        else moon_tls_close(conn);
+        moon_release(conn);
+    } else if (s->sock != HC_INVALID_SOCKET) {
+        if (reuse) hc_pool_put(*s->pool_key, s->sock);
+        else hc_closesocket(s->sock);
+    }
+    hc_stream_free(s);
+}
+
+// ============================================================================
+// Request
+// ============================================================================
+
+typedef struct {
+    bool https;
+    std::string host;       // Without brackets
+    int port;
+    std::string target;     // Path and query
+    std::string host_header;
+} HcUrl;
+
+static bool hc_parse_url(const char* url, HcUrl* u) {
+    const char* p = url;
+    u->https = false;
+    if (strncasecmp(p, "https://", 8) == 0) {
+        u->https = true;
+        p += 8;
+    } else if (strncasecmp(p, "http://", 7) == 0) {
+        p += 7;
+    }
+    u->port = u->https ? 443 : 80;
+
+    const char* hostEnd;
+    if (*p == '[') {
+        hostEnd = strchr(p, ']');
+        if (!hostEnd) return false;
+        u->host.assign(p + 1, hostEnd - p - 1);
+        hostEnd++;
+    } else {
+        hostEnd = p + strcspn(p, ":/?#");
+        u->host.assign(p, hostEnd - p);
+    }
+    if (u->host.empty()) return false;
+
+    const char* rest = hostEnd;
+    if (*rest == ':') {
+        u->port = atoi(rest + 1);
+        if (u->port <= 0 || u->port > 65535) return false;
+        rest += 1 + strspn(rest + 1, "0123456789");
+    }
+    u->host_header.assign(p, rest - p);
+
+    size_t targetLen = strcspn(rest, "#");
+    u->target.assign(rest, targetLen);
+    if (u->target.empty() || u->target[0] != '/') u->target.insert(0, "/");
+    return true;
+}
+
+static void hc_dict_put(MoonValue* dict, const char* key, MoonValue* val) {
+    MoonValue* k = moon_string(key);
+    moon_dict_set(dict, k, val);
+    moon_release(k);
+    moon_release(val);
+}
+
+static MoonValue* hc_option(MoonValue* options, const char* name) {
+    if (!options || options->type != MOON_DICT) return moon_null();
+    MoonValue* key = moon_string(name);
+    MoonValue* val = moon_dict_get(options, key, moon_null());
+    moon_release(key);
+    return val;
+}
+
+static bool hc_ieq(const char* a, size_t alen, const char* b) {
+    size_t blen = strlen(b);
+    if (alen != blen) return false;
+    for (size_t i = 0; i < alen; i++) {
+        if (tolower((unsigned char)a[i]) != b[i]) return false;
+    }
+    return true;
+}
+
+// Does the comma-separated header value contain token (case-insensitive)?
+static bool hc_has_token(const char* v, size_t len, const char* token) {
+    size_t i = 0;
+    while (i < len) {
+        while (i < len && (v[i] == ' ' || v[i] == '\t' || v[i] == ',')) i++;
+        size_t start = i;
+        while (i < len && v[i] != ',') i++;
+        size_t end = i;
+        while (end > start && (v[end - 1] == ' ' || v[end - 1] == '\t')) end--;
+        if (hc_ieq(v + start, end - start, token)) return true;
+    }
+    return false;
+}
+
+static const char* hc_bytes(MoonValue* v, size_t* len, char** toFree) {
+    *toFree = NULL;
+    const char* bytes = moon_bytes_view(v, len);
+    if (bytes) return bytes;
+    *toFree = moon_to_string(v);
+    *len = strlen(*toFree);
+    return *toFree;
+}
+
+// Open (or reuse) a connection for the URL
+static bool hc_connect(HcStream* s, HcUrl* u, bool* reused) {
+    *reused = false;
+    if (u->https) {
+        MoonValue* host = moon_string(u->host.c_str());
+        MoonValue* port = moon_int(u->port);
+        MoonValue* conn = moon_tls_pool_get(host, port);
+        moon_release(host);
+        moon_release(port);
+        s->tls = (void*)(uintptr_t)moon_to_int(conn);
+        moon_release(conn);
+        if (!s->tls) return false;
+        s->sock = (MOON_SOCKET)moon_tls_conn_fd(s->tls);
+        *reused = true;     // Pool may have handed out an idle connection
+        return true;
+    }
+
+    char port[16];
+    snprintf(port, sizeof(port), ":%d", u->port);
+    s->pool_key = new std::string(u->host + port);
+    s->sock = hc_pool_take(*s->pool_key);
+    if (s->sock != HC_INVALID_SOCKET) {
+        *reused = true;
+        return true;
+    }
+
+    int64_t fd = moon_net_connect(u->host.c_str(), u->port, s->timeout_ms);
+    if (fd < 0) return false;
+    s->sock = (MOON_SOCKET)fd;
+    int one = 1;
+    setsockopt(s->sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&one, sizeof(one));
+    return true;
+}
+
+// Parse the status line and headers into result; sets body framing.
+// Returns false on a malformed or missing response.
+static bool hc_read_head(HcStream* s, MoonValue* result, bool headRequest) {
+    for (;;) {
+        size_t len;
+        const char* line = hc_line(s, &len);
+        if (!line) return false;
+        if (len == 0) continue;     // Tolerate a stray CRLF before the status line
+        if (len < 12 || memcmp(line, "HTTP/1.", 7) != 0) return false;
+
+        int minor = line[7] - '0';
+        int status = atoi(line + 9);
+        std::string reason = len > 13 ? std::string(line + 13, len - 13) : std::string();
+
+        MoonValue* headers = moon_dict_new();
+        int64_t contentLength = -1;
+        bool chunked = false;
+        bool keepAlive = minor >= 1;
+        const char* encoding = NULL;
+        size_t headBytes = 0;
+        char name[256];
+
+        for (;;) {
+            line = hc_line(s, &len);
+            if (!line) {
+                moon_release(headers);
+                return false;
+            }
+            if (len == 0) break;
+            headBytes += len;
+            if (headBytes > HC_MAX_HEAD) {
+                moon_release(headers);
+                return false;
+            }
+            const char* colon = (const char*)memchr(line, ':', len);
+            if (!colon) continue;
+            size_t nlen = colon - line;
+            if (nlen >= sizeof(name)) nlen = sizeof(name) - 1;
+            for (size_t i = 0; i < nlen; i++) name[i] = (char)tolower((unsigned char)line[i]);
+            name[nlen] = '\0';
+            const char* v = colon + 1;
+            const char* ve = line + len;
+            while (v < ve && (*v == ' ' || *v == '\t')) v++;
+            while (ve > v && (ve[-1] == ' ' || ve[-1] == '\t')) ve--;
+
+            if (strcmp(name, "content-length") == 0) {
+                contentLength = strtoll(v, NULL, 10);
+            } else if (strcmp(name, "transfer-encoding") == 0) {
+                chunked = hc_has_token(v, ve - v, "chunked");
+            } else if (strcmp(name, "connection") == 0) {
+                if (hc_has_token(v, ve - v, "close")) keepAlive = false;
+                else if (hc_has_token(v, ve - v, "keep-alive")) keepAlive = true;
+            } else if (strcmp(name, "content-encoding") == 0) {
+                if (hc_has_token(v, ve - v, "gzip")) encoding = "gzip";
+                else if (hc_has_token(v, ve - v, "deflate")) encoding = "deflate";
+            }
+
+            // Repeated headers are joined as in RFC 9110 5.3
+            MoonValue* key = moon_string(name);
+            MoonValue* prev = moon_dict_get(headers, key, moon_null());
+            MoonValue* val;
+            if (moon_is_string(prev)) {
+                std::string joined = std::string(prev->data.strVal) + ", " + std::string(v, ve - v);
+                val = moon_string(joined.c_str());
+            } else {
+                val = moon_string_owned(moon_str_with_capacity(v, ve - v, ve - v));
+            }
+            moon_release(prev);
+            moon_dict_set(headers, key, val);
+            moon_release(key);
+            moon_release(val);
+        }
+
+        // Interim responses (100 Continue, 103 Early Hints) precede the real one
+        if (status >= 100 && status < 200 && status != 101) {
+            moon_release(headers);
+            continue;
+        }
+
+        hc_dict_put(result, "status", moon_int(status));
+        hc_dict_put(result, "reason", moon_string(reason.c_str()));
+        hc_dict_put(result, "headers", headers);
+
+        s->keep_alive = keepAlive;
+        if (headRequest || status == 204 || status == 304 || status == 101) {
+            s->mode = HC_BODY_NONE;
+        } else if (chunked) {
+            s->mode = HC_BODY_CHUNKED;
+            s->chunk_state = HC_CHUNK_SIZE;
+        } else if (contentLength >= 0) {
+            s->mode = HC_BODY_LENGTH;
+            s->remaining = contentLength;
+        } else {
+            s->mode = HC_BODY_CLOSE;
+            s->keep_alive = false;
+        }
+
+#ifdef HC_HAS_ZLIB
+        if (encoding && s->mode != HC_BODY_NONE && hc_zlib_available()) {
+            s->z = (z_stream*)calloc(1, sizeof(z_stream));
+            s->zin = (char*)malloc(HC_IO_CHUNK);
+            // 15 + 32: accept both zlib and gzip wrappers
+            if (!s->z || !s->zin ||
+                g_hc_zlib->inflateInit2_(s->z, MAX_WBITS + 32, ZLIB_VERSION, (int)sizeof(z_stream)) != Z_OK) {
+                free(s->z);
+                s->z = NULL;
+                return false;
+            }
+        }
+#else
+        (void)encoding;
+#endif
+        return true;
+    }
+}
+
+// Send the request and read the response head. Returns the result dict
+// (status, reason, headers) with the stream positioned at the body, or
+// NULL on failure.
+static MoonValue* hc_perform(const char* method, MoonValue* urlVal, MoonValue* body,
+                             MoonValue* options, HcStream** out) {
+    *out = NULL;
+    if (!moon_is_string(urlVal)) return NULL;
+    HcUrl u;
+    if (!hc_parse_url(urlVal->data.strVal, &u)) return NULL;
+    moon_tls_init();
+
+    int timeout = HC_TIMEOUT_MS;
+    bool keepAlive = true;
+    bool decompress = true;
+    MoonValue* headers = NULL;
+    if (options && options->type == MOON_DICT) {
+        MoonValue* v = hc_option(options, "timeout");
+        if (v->type != MOON_NULL && moon_to_int(v) > 0) timeout = (int)moon_to_int(v);
+        moon_release(v);
+        v = hc_option(options, "keep_alive");
+        if (v->type != MOON_NULL) keepAlive = moon_to_bool(v);
+        moon_release(v);
+        v = hc_option(options, "decompress");
+        if (v->type != MOON_NULL) decompress = moon_to_bool(v);
+        moon_release(v);
+        headers = hc_option(options, "headers");
+        if (!body) body = hc_option(options, "body");
+        else moon_retain(body);
+    } else if (body) {
+        moon_retain(body);
+    }
+
+    // Body: strings go as-is, dicts and lists as JSON
+    size_t bodyLen = 0;
+    char* bodyFree = NULL;
+    const char* bodyData = NULL;
+    MoonValue* json = NULL;
+    bool isJson = false;
+    if (body && body->type != MOON_NULL) {
+        if (body->type == MOON_DICT || body->type == MOON_LIST) {
+            json = moon_json_encode(body);
+            bodyData = hc_bytes(json, &bodyLen, &bodyFree);
+            isJson = true;
+        } else {
+            bodyData = hc_bytes(body, &bodyLen, &bodyFree);
+        }
+    }
+
+    // Request head
+    std::string req;
+    req.reserve(256 + (bodyLen < HC_IO_CHUNK ? bodyLen : 0));
+    req += method;
+    req += ' ';
+    req += u.target;
+    req += " HTTP/1.1\r\n";
+    bool hasHost = false, hasAgent = false, hasType = false, hasAccept = false, hasEncoding = false;
+    if (headers && headers->type == MOON_DICT) {
+        MoonValue* keys = moon_dict_keys(headers);
+        MoonList* kl = keys->data.listVal;
+        for (int i = 0; i < kl->length; i++) {
+            MoonValue* v = moon_dict_get(headers, kl->items[i], moon_null());
+            char* ks = moon_to_string(kl->items[i]);
+            char* vs = moon_to_string(v);
+            size_t klen = strlen(ks);
+            if (hc_ieq(ks, klen, "host")) hasHost = true;
+            else if (hc_ieq(ks, klen, "user-agent")) hasAgent = true;
+            else if (hc_ieq(ks, klen, "content-type")) hasType = true;
+            else if (hc_ieq(ks, klen, "accept")) hasAccept = true;
+            else if (hc_ieq(ks, klen, "accept-encoding")) hasEncoding = true;
+            // Framing is computed here
+            if (!hc_ieq(ks, klen, "content-length") && !hc_ieq(ks, klen, "connection") &&
+                !hc_ieq(ks, klen, "transfer-encoding")) {
+                req += ks;
+                req += ": ";
+                req += vs;
+                req += "\r\n";
+            }
+            moon_free(ks, 0);
+            moon_free(vs, 0);
+            moon_release(v);
+        }
+        moon_release(keys);
+    }
+    if (!hasHost) req += "Host: " + u.host_header + "\r\n";
+    if (!hasAgent) req += "User-Agent: MoonLang\r\n";
+    if (!hasAccept) req += "Accept: */*\r\n";
+#ifdef HC_HAS_ZLIB
+    if (!hasEncoding && decompress && hc_zlib_available()) req += "Accept-Encoding: gzip, deflate\r\n";
+#else
+    (void)hasEncoding;
+#endif
+    if (isJson && !hasType) req += "Content-Type: application/json\r\n";
+    if (bodyData || strcmp(method, "POST") == 0 || strcmp(method, "PUT") == 0 ||
+        strcmp(method, "PATCH") == 0) {
+        char cl[48];
+        snprintf(cl, sizeof(cl), "Content-Length: %zu\r\n", bodyLen);
+        req += cl;
+    }
+    if (!keepAlive) req += "Connection: close\r\n";
+    req += "\r\n";
+    bool inlineBody = bodyData && bodyLen < HC_IO_CHUNK;
+    if (inlineBody) req.append(bodyData, bodyLen);
+
+    bool headRequest = strcmp(method, "HEAD") == 0;
+    MoonValue* result = NULL;
+
+    // A reused connection may have been closed by the server while idle;
+    // retry once on a fresh one if nothing came back
+    for (int attempt = 0; attempt < 2 && !result; attempt++) {
+        HcStream* s = (HcStream*)calloc(1, sizeof(HcStream));
+        if (!s) break;
+        s->sock = HC_INVALID_SOCKET;
+        s->timeout_ms = timeout;
+        s->cap = HC_IO_CHUNK;
+        s->buf = (char*)malloc(s->cap);
+
+        bool reused = false;
+        if (!s->buf || !hc_connect(s, &u, &reused)) {
+            hc_stream_free(s);
+            break;
+        }
+        bool ok = hc_send(s, req.data(), req.size()) &&
+                  (inlineBody || !bodyData || hc_send(s, bodyData, bodyLen));
+        if (ok) {
+            result = moon_dict_new();
+            if (!hc_read_head(s, result, headRequest)) {
+                moon_release(result);
+                result = NULL;
+            }
+        }
+        if (result) {
+#ifdef HC_HAS_ZLIB
+            if (!decompress && s->z) {
+                g_hc_zlib->inflateEnd(s->z);
+                free(s->z);
+                s->z = NULL;
+            }
+#endif
+            *out = s;
+            break;
+        }
+
+        bool retry = reused && !s->got_data;
+        s->failed = true;
+        hc_stream_finish(s);
+        if (!retry) break;
+    }
+
+    moon_free(bodyFree, 0);
+    if (json) moon_release(json);
+    if (body) moon_release(body);
+    if (headers) moon_release(headers);
+    return result;
+}
+
+// Read the whole body into result["body"] and release the connection
+static MoonValue* hc_complete(MoonValue* result, HcStream* s, MoonValue* options) {
+    int64_t maxSize = HC_MAX_SIZE;
+    MoonValue* v = hc_option(options, "max_size");
+    if (v->type != MOON_NULL && moon_to_int(v) > 0) maxSize = moon_to_int(v);
+    moon_release(v);
+
+    v = hc_option(options, "stream");
+    bool stream = moon_to_bool(v);
+    moon_release(v);
+    if (stream) {
+        // Caller pulls the body with http_read()
+        hc_dict_put(result, "stream", moon_int((int64_t)(uintptr_t)s));
+        return result;
+    }
+
+    size_t cap = (s->mode == HC_BODY_LENGTH && s->remaining > 0 && s->remaining <= maxSize)
+               ? (size_t)s->remaining : HC_IO_CHUNK;
+#ifdef HC_HAS_ZLIB
+    if (s->z && cap < HC_IO_CHUNK * 4) cap = HC_IO_CHUNK * 4;
+#endif
+    char* body = moon_str_buffer(cap);
+    size_t len = 0;
+    for (;;) {
+        if (len == cap) {
+            if ((int64_t)cap >= maxSize) {
+                s->failed = true;
+                break;
+            }
+            size_t grown = cap * 2;
+            if ((int64_t)grown > maxSize) grown = (size_t)maxSize;
+            body = moon_str_reserve(body, grown);
+            cap = grown;
+        }
+        int n = hc_body_read(s, body + len, (int)(cap - len > INT32_MAX ? INT32_MAX : cap - len));
+        if (n <= 0) break;
+        len += (size_t)n;
+    }
+    bool failed = s->failed;
+    hc_stream_finish(s);
+
+    if (failed) {
+        moon_release(moon_str_finish(body, 0));
+        moon_release(result);
+        return moon_null();
+    }
+    hc_dict_put(result, "body", moon_str_finish(body, len));
+    return result;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+// http_request(method, url[, options]) - options: headers (dict), body,
+// timeout (ms, default 30000), keep_alive, decompress, max_size, stream.
+// Returns {status, reason, headers, body} (or stream instead of body),
+// null on connection or protocol failure.
+MoonValue* moon_http_request(MoonValue* method, MoonValue* url, MoonValue* options) {
+    char* m = moon_to_string(method);
+    for (char* p = m; *p; p++) *p = (char)toupper((unsigned char)*p);
+    HcStream* s;
+    MoonValue* result = hc_perform(m, url, NULL, options, &s);
+    moon_free(m, 0);
+    if (!result) return moon_null();
+    return hc_complete(result, s, options);
+}
+
+// http_get(url[, options])
+MoonValue* moon_http_get(MoonValue* url, MoonValue* options) {
+    HcStream* s;
+    MoonValue* result = hc_perform("GET", url, NULL, options, &s);
+    if (!result) return moon_null();
+    return hc_complete(result, s, options);
+}
+
+// http_post(url, body[, options]) - dict/list bodies are sent as JSON
+MoonValue* moon_http_post(MoonValue* url, MoonValue* body, MoonValue* options) {
+    HcStream* s;
+    MoonValue* result = hc_perform("POST", url, body ? body : moon_null(), options, &s);
+    if (!result) return moon_null();
+    return hc_complete(result, s, options);
+}
+
+// http_read(stream[, max]) - next piece of a streamed body (up to max
+// bytes, default 16KB); null at the end, after which the connection is
+// back in the pool and the stream handle is gone.
+MoonValue* moon_http_read(MoonValue* stream, MoonValue* max) {
+    HcStream* s = (HcStream*)(uintptr_t)moon_to_int(stream);
+    if (!s) return moon_null();
+    int cap = (max && max->type != MOON_NULL && moon_to_int(max) > 0) ? (int)moon_to_int(max) : HC_IO_CHUNK;
+
+    char* out = moon_str_buffer((size_t)cap);
+    int n = hc_body_read(s, out, cap);
+    if (n <= 0) {
+        moon_release(moon_str_finish(out, 0));
+        hc_stream_finish(s);
+        return moon_null();
+    }
+    return moon_str_finish(out, (size_t)n);
+}
+
+// http_close(stream) - abandon a streamed body (the connection is closed)
+void moon_http_close(MoonValue* stream) {
+    HcStream* s = (HcStream*)(uintptr_t)moon_to_int(stream);
+    if (!s) return;
+    s->failed = true;
+    hc_stream_finish(s);
+}
+
+#else // !MOON_HAS_NETWORK
+
+MoonValue* moon_http_request(MoonValue* method, MoonValue* url, MoonValue* options) { return moon_null(); }
+MoonValue* moon_http_get(MoonValue* url, MoonValue* options) { return moon_null(); }
+MoonValue* moon_http_post(MoonValue* url, MoonValue* body, MoonValue* options) { return moon_null(); }
+MoonValue* moon_http_read(MoonValue* stream, MoonValue* max) { return moon_null(); }
+void moon_http_close(MoonValue* stream) { }
+
+#endif // MOON_HAS_NETWORK
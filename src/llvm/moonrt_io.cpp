@@ -14,6 +14,8 @@
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 // ============================================================================
@@ -23,6 +25,7 @@
 MoonValue* moon_read_file(MoonValue* path) {
     if (!moon_is_string(path)) return moon_null();
     
+#ifdef MOON_PLATFORM_WINDOWS
     FILE* file = fopen(path->data.strVal, "rb");
     if (!file) return moon_null();
     
@@ -43,76 +46,86 @@ MoonValue* moon_read_file(MoonValue* path) {
     }
     
     return moon_string_owned(content);
-}
-
-MoonValue* moon_write_file(MoonValue* path, MoonValue* content) {
-    if (!moon_is_string(path)) return moon_bool(false);
-    
-    FILE* file = fopen(path->data.strVal, "wb");
-    if (!file) return moon_bool(false);
+#else
+    // Read straight into the result string; inside a coroutine the reads
+    // go through the io_uring engine instead of blocking the worker
+    int fd = open(path->data.strVal, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return moon_null();
     
-    // For string type use its actual length (supports binary data)
+    struct stat st;
+    bool regular = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    size_t cap = (regular && st.st_size > 0) ? (size_t)st.st_size : 4096;
+    char* content = moon_str_buffer(cap);
     size_t len = 0;
-    const char* str = NULL;
-    char* toFree = NULL;
-    
-    if (content && content->type == MOON_STRING && content->data.strVal) {
-        str = content->data.strVal;
-        MoonStrHeader* header = moon_str_get_header(content->data.strVal);
-        if (header) {
-            len = header->length;
-        } else {
-            len = strlen(str);
+    for (;;) {
+        if (len == cap) {
+            if (regular && st.st_size > 0) break;   // Whole file read
+            cap *= 2;
+            content = moon_str_reserve(content, cap);
         }
-    } else {
-        toFree = moon_to_string(content);
-        str = toFree;
-        len = strlen(str);
+        int64_t n = moon_io_pread(fd, content + len, cap - len, regular ? (int64_t)len : -1);
+        if (n <= 0) break;
+        len += (size_t)n;
     }
-    
-    size_t written = fwrite(str, 1, len, file);
-    
-    if (toFree) {
-        free(toFree);
-    }
-    fclose(file);
-    
-    return moon_bool(written == len);
+    close(fd);
+    return moon_str_finish(content, len);
+#endif
 }
 
-MoonValue* moon_append_file(MoonValue* path, MoonValue* content) {
+// Binary-safe bytes of content; non-strings are converted and must be
+// released with moon_free(*toFree, 0)
+static const char* io_content_bytes(MoonValue* content, size_t* len, char** toFree) {
+    *toFree = NULL;
+    const char* bytes = moon_bytes_view(content, len);
+    if (bytes) return bytes;
+    *toFree = moon_to_string(content);
+    *len = strlen(*toFree);
+    return *toFree;
+}
+
+// Write content to path, truncating or appending
+static MoonValue* io_write_content(MoonValue* path, MoonValue* content, bool append) {
     if (!moon_is_string(path)) return moon_bool(false);
     
-    FILE* file = fopen(path->data.strVal, "ab");
+#ifdef MOON_PLATFORM_WINDOWS
+    FILE* file = fopen(path->data.strVal, append ? "ab" : "wb");
     if (!file) return moon_bool(false);
     
-    // For string type use its actual length (supports binary data)
-    size_t len = 0;
-    const char* str = NULL;
-    char* toFree = NULL;
-    
-    if (content && content->type == MOON_STRING && content->data.strVal) {
-        str = content->data.strVal;
-        MoonStrHeader* header = moon_str_get_header(content->data.strVal);
-        if (header) {
-            len = header->length;
-        } else {
-            len = strlen(str);
-        }
-    } else {
-        toFree = moon_to_string(content);
-        str = toFree;
-        len = strlen(str);
-    }
-    
+    size_t len;
+    char* toFree;
+    const char* str = io_content_bytes(content, &len, &toFree);
     size_t written = fwrite(str, 1, len, file);
+    moon_free(toFree, 0);
+    fclose(file);
     
-    if (toFree) {
-        free(toFree);
+    return moon_bool(written == len);
+#else
+    int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC);
+    int fd = open(path->data.strVal, flags, 0666);
+    if (fd < 0) return moon_bool(false);
+    
+    size_t len;
+    char* toFree;
+    const char* str = io_content_bytes(content, &len, &toFree);
+    size_t written = 0;
+    while (written < len) {
+        int64_t n = moon_io_pwrite(fd, str + written, len - written, -1);
+        if (n <= 0) break;
+        written += (size_t)n;
     }
-    fclose(file);
+    moon_free(toFree, 0);
+    close(fd);
     
     return moon_bool(written == len);
+#endif
+}
+
+MoonValue* moon_write_file(MoonValue* path, MoonValue* content) {
+    return io_write_content(path, content, false);
+}
+
+MoonValue* moon_append_file(MoonValue* path, MoonValue* content) {
+    return io_write_content(path, content, true);
 }
 
 // Helper: Convert UTF-8 to wide string (Windows only)
@@ -59,10 +59,10 @@ static char* json_encode_value(MoonValue* val) {
                 size_t needed = strlen(result) + strlen(item) + 10;
                 if (needed > bufSize) {
                     bufSize = needed * 2;
-                    result = (char*)realloc(result, bufSize);
+                    result = (char*)moon_realloc(result, bufSize);
                 }
                 strcat(result, item);
-                free(item);
+                moon_free(item, 0);
             }
             strcat(result, "]");
             return result;
@@ -82,13 +82,13 @@ static char* json_encode_value(MoonValue* val) {
                 size_t needed = strlen(result) + strlen(keyStr) + strlen(valStr) + 10;
                 if (needed > bufSize) {
                     bufSize = needed * 2;
-                    result = (char*)realloc(result, bufSize);
+                    result = (char*)moon_realloc(result, bufSize);
                 }
                 strcat(result, keyStr);
                 strcat(result, ": ");
                 strcat(result, valStr);
-                free(keyStr);
-                free(valStr);
+                moon_free(keyStr, 0);
+                moon_free(valStr, 0);
             }
             strcat(result, "}");
             return result;
@@ -101,7 +101,7 @@ static char* json_encode_value(MoonValue* val) {
 MoonValue* moon_json_encode(MoonValue* val) {
     char* str = json_encode_value(val);
     MoonValue* result = moon_string(str);
-    free(str);
+    moon_free(str, 0);
     return result;
 }
 
@@ -136,13 +136,13 @@ static MoonValue* json_parse_string(const char** pp) {
             }
             if (len + 1 >= bufSize) {
                 bufSize *= 2;
-                buf = (char*)realloc(buf, bufSize);
+                buf = (char*)moon_realloc(buf, bufSize);
             }
             buf[len++] = c;
         } else {
             if (len + 1 >= bufSize) {
                 bufSize *= 2;
-                buf = (char*)realloc(buf, bufSize);
+                buf = (char*)moon_realloc(buf, bufSize);
             }
             buf[len++] = *p;
         }
@@ -199,7 +199,8 @@ static MoonValue* json_parse_array(const char** pp) {
     while (*p) {
         p = json_skip_whitespace(p);
         MoonValue* item = json_parse_value(&p);
-        moon_list_append(result, item);
+        moon_release(moon_list_append(result, item));
+        moon_release(item);
         
         p = json_skip_whitespace(p);
         if (*p == ']') {
@@ -287,8 +288,21 @@ static MoonValue* json_parse_value(const char** pp) {
 }
 
 MoonValue* moon_json_decode(MoonValue* str) {
-    if (!moon_is_string(str)) return moon_null();
-    const char* p = str->data.strVal;
+    if (moon_is_buffer(str) && !str->data.bufferVal->terminated) {
+        // The parser stops at a NUL; views into C memory need one appended
+        MoonBuffer* buf = str->data.bufferVal;
+        char* text = (char*)malloc(buf->length + 1);
+        if (!text) return moon_null();
+        memcpy(text, buf->data, buf->length);
+        text[buf->length] = '\0';
+        const char* p = text;
+        MoonValue* result = json_parse_value(&p);
+        free(text);
+        return result;
+    }
+    size_t len;
+    const char* p = moon_bytes_view(str, &len);
+    if (!p) return moon_null();
     return json_parse_value(&p);
 }
 
@@ -5,6 +5,22 @@
 
 #include "moonrt_core.h"
 
+// ============================================================================
+// List Internal Functions
+// ============================================================================
+
+void moon_list_unshare(MoonList* lst) {
+    if (!lst->shared) return;
+    
+    // Items of a constant literal are immortal, so copying the pointers is enough
+    int32_t capacity = lst->length < 8 ? 8 : lst->length * 2;
+    MoonValue** items = (MoonValue**)moon_alloc_typed(MOON_MEM_LIST, sizeof(MoonValue*) * capacity);
+    memcpy(items, lst->items, sizeof(MoonValue*) * lst->length);
+    lst->items = items;
+    lst->capacity = capacity;
+    lst->shared = false;
+}
+
 // ============================================================================
 // List Operations
 // ============================================================================
@@ -99,6 +115,7 @@ void moon_list_set(MoonValue* list, MoonValue* index, MoonValue* val) {
         return;
     }
     
+    moon_list_unshare(lst);
     moon_release(lst->items[idx]);
     moon_retain(val);
     lst->items[idx] = val;
@@ -116,6 +133,7 @@ void moon_list_set_idx(MoonValue* list, int64_t idx, MoonValue* val) {
         return;
     }
     
+    moon_list_unshare(lst);
     moon_release(lst->items[idx]);
     moon_retain(val);
     lst->items[idx] = val;
@@ -125,9 +143,10 @@ MoonValue* moon_list_append(MoonValue* list, MoonValue* val) {
     if (!moon_is_list(list)) return moon_null();
     
     MoonList* lst = list->data.listVal;
+    moon_list_unshare(lst);
     if (lst->length >= lst->capacity) {
         lst->capacity *= 2;
-        lst->items = (MoonValue**)realloc(lst->items, sizeof(MoonValue*) * lst->capacity);
+        lst->items = (MoonValue**)moon_realloc_typed(MOON_MEM_LIST, lst->items, sizeof(MoonValue*) * lst->capacity);
     }
     
     moon_retain(val);
@@ -276,9 +295,10 @@ MoonValue* moon_list_insert(MoonValue* list, MoonValue* index, MoonValue* val) {
     if (idx < 0) idx = 0;
     if (idx > lst->length) idx = lst->length;
     
+    moon_list_unshare(lst);
     if (lst->length >= lst->capacity) {
         lst->capacity *= 2;
-        lst->items = (MoonValue**)realloc(lst->items, sizeof(MoonValue*) * lst->capacity);
+        lst->items = (MoonValue**)moon_realloc_typed(MOON_MEM_LIST, lst->items, sizeof(MoonValue*) * lst->capacity);
     }
     
     for (int32_t i = lst->length; i > idx; i--) {
@@ -302,6 +322,7 @@ MoonValue* moon_list_remove(MoonValue* list, MoonValue* item) {
         bool isEqual = eq->data.boolVal;
         moon_release(eq);
         if (isEqual) {
+            moon_list_unshare(lst);
             moon_release(lst->items[i]);
             for (int32_t j = i; j < lst->length - 1; j++) {
                 lst->items[j] = lst->items[j + 1];
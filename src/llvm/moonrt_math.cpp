@@ -9,6 +9,23 @@
 // Arithmetic Operations
 // ============================================================================
 
+static inline bool add_overflows(int64_t av, int64_t bv) {
+    return (bv > 0 && av > INT64_MAX - bv) || (bv < 0 && av < INT64_MIN - bv);
+}
+
+static inline bool sub_overflows(int64_t av, int64_t bv) {
+    return (bv < 0 && av > INT64_MAX + bv) || (bv > 0 && av < INT64_MIN + bv);
+}
+
+// Safe multiplication check
+static inline bool mul_overflows(int64_t av, int64_t bv) {
+    if (av == 0 || bv == 0) return false;
+    if (av > 0) {
+        return bv > 0 ? av > INT64_MAX / bv : bv < INT64_MIN / av;
+    }
+    return bv > 0 ? av < INT64_MIN / bv : bv < INT64_MAX / av;
+}
+
 MoonValue* moon_add(MoonValue* a, MoonValue* b) {
     if (!a || !b) return moon_null();
     
@@ -23,7 +40,7 @@ MoonValue* moon_add(MoonValue* a, MoonValue* b) {
         int64_t bv = b->data.intVal;
         
         // Check for overflow before adding
-        if ((bv > 0 && av > INT64_MAX - bv) || (bv < 0 && av < INT64_MIN - bv)) {
+        if (add_overflows(av, bv)) {
             // Overflow! Use BigInt
             MoonValue* bigA = moon_bigint_from_int(av);
             MoonValue* bigB = moon_bigint_from_int(bv);
@@ -76,6 +93,15 @@ MoonValue* moon_add(MoonValue* a, MoonValue* b) {
     return moon_int(moon_to_int(a) + moon_to_int(b));
 }
 
+// slot = a + b, where a was loaded (and retained) from slot: when nothing else references
+// a string a, the result can reuse its buffer since the caller overwrites slot with it
+MoonValue* moon_add_assign(MoonValue** slot, MoonValue* a, MoonValue* b) {
+    if (a && b && a->type == MOON_STRING && *slot == a && a->refcount == 2) {
+        return moon_str_append(a, b);
+    }
+    return moon_add(a, b);
+}
+
 MoonValue* moon_sub(MoonValue* a, MoonValue* b) {
     if (!a || !b) return moon_null();
     
@@ -90,7 +116,7 @@ MoonValue* moon_sub(MoonValue* a, MoonValue* b) {
         int64_t bv = b->data.intVal;
         
         // Check for overflow
-        if ((bv < 0 && av > INT64_MAX + bv) || (bv > 0 && av < INT64_MIN + bv)) {
+        if (sub_overflows(av, bv)) {
             // Overflow! Use BigInt
             MoonValue* bigA = moon_bigint_from_int(av);
             MoonValue* bigB = moon_bigint_from_int(bv);
@@ -135,25 +161,7 @@ MoonValue* moon_mul(MoonValue* a, MoonValue* b) {
         int64_t av = a->data.intVal;
         int64_t bv = b->data.intVal;
         
-        // Check for overflow (safe multiplication check)
-        bool overflow = false;
-        if (av != 0 && bv != 0) {
-            if (av > 0) {
-                if (bv > 0) {
-                    overflow = av > INT64_MAX / bv;
-                } else {
-                    overflow = bv < INT64_MIN / av;
-                }
-            } else {
-                if (bv > 0) {
-                    overflow = av < INT64_MIN / bv;
-                } else {
-                    overflow = av != 0 && bv < INT64_MAX / av;
-                }
-            }
-        }
-        
-        if (overflow) {
+        if (mul_overflows(av, bv)) {
             // Overflow! Use BigInt
             MoonValue* bigA = moon_bigint_from_int(av);
             MoonValue* bigB = moon_bigint_from_int(bv);
@@ -266,6 +274,92 @@ MoonValue* moon_neg(MoonValue* val) {
     return moon_int(-moon_to_int(val));
 }
 
+// ============================================================================
+// Arithmetic Into Caller Storage
+// ============================================================================
+// For results that only feed another operation (`a + b < c`), the code generator passes a
+// MoonValue-sized stack slot. A number result is built in the slot with the immortal
+// refcount, so the caller's release is a no-op; anything else (BigInt on overflow, strings,
+// lists, errors) comes from the regular entry point on the heap.
+
+static inline MoonValue* temp_int(MoonValue* out, int64_t val) {
+    out->type = MOON_INT;
+    out->refcount = INT32_MAX;
+    out->data.intVal = val;
+    return out;
+}
+
+static inline MoonValue* temp_float(MoonValue* out, double val) {
+    out->type = MOON_FLOAT;
+    out->refcount = INT32_MAX;
+    out->data.floatVal = val;
+    return out;
+}
+
+// Two numbers of which at least one is a float, converted to double
+static inline bool float_operands(MoonValue* a, MoonValue* b, double* x, double* y) {
+    if (!a || !b) return false;
+    if (a->type != MOON_FLOAT && b->type != MOON_FLOAT) return false;
+    if ((a->type != MOON_FLOAT && a->type != MOON_INT) || (b->type != MOON_FLOAT && b->type != MOON_INT)) return false;
+    *x = a->type == MOON_FLOAT ? a->data.floatVal : (double)a->data.intVal;
+    *y = b->type == MOON_FLOAT ? b->data.floatVal : (double)b->data.intVal;
+    return true;
+}
+
+static inline bool int_operands(MoonValue* a, MoonValue* b) {
+    return a && b && a->type == MOON_INT && b->type == MOON_INT;
+}
+
+MoonValue* moon_add_at(MoonValue* out, MoonValue* a, MoonValue* b) {
+    double x, y;
+    if (int_operands(a, b)) {
+        int64_t av = a->data.intVal, bv = b->data.intVal;
+        if (!add_overflows(av, bv)) return temp_int(out, av + bv);
+    } else if (float_operands(a, b, &x, &y)) {
+        return temp_float(out, x + y);
+    }
+    return moon_add(a, b);
+}
+
+MoonValue* moon_sub_at(MoonValue* out, MoonValue* a, MoonValue* b) {
+    double x, y;
+    if (int_operands(a, b)) {
+        int64_t av = a->data.intVal, bv = b->data.intVal;
+        if (!sub_overflows(av, bv)) return temp_int(out, av - bv);
+    } else if (float_operands(a, b, &x, &y)) {
+        return temp_float(out, x - y);
+    }
+    return moon_sub(a, b);
+}
+
+MoonValue* moon_mul_at(MoonValue* out, MoonValue* a, MoonValue* b) {
+    double x, y;
+    if (int_operands(a, b)) {
+        int64_t av = a->data.intVal, bv = b->data.intVal;
+        if (!mul_overflows(av, bv)) return temp_int(out, av * bv);
+    } else if (float_operands(a, b, &x, &y)) {
+        return temp_float(out, x * y);
+    }
+    return moon_mul(a, b);
+}
+
+MoonValue* moon_div_at(MoonValue* out, MoonValue* a, MoonValue* b) {
+    double x, y;
+    if (int_operands(a, b)) {
+        if (b->data.intVal != 0) return temp_int(out, a->data.intVal / b->data.intVal);
+    } else if (float_operands(a, b, &x, &y)) {
+        if (y != 0.0) return temp_float(out, x / y);
+    }
+    return moon_div(a, b);
+}
+
+MoonValue* moon_mod_at(MoonValue* out, MoonValue* a, MoonValue* b) {
+    if (int_operands(a, b) && b->data.intVal != 0) {
+        return temp_int(out, a->data.intVal % b->data.intVal);
+    }
+    return moon_mod(a, b);
+}
+
 // ============================================================================
 // Comparison Operations
 // ============================================================================
@@ -632,7 +726,7 @@ MoonValue* moon_median(MoonValue* list) {
     } else {
         result = values[lst->length / 2];
     }
-    free(values);
+    moon_free(values, sizeof(double) * lst->length);
     return moon_float(result);
 }
 
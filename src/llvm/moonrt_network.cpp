@@ -9,6 +9,10 @@
 
 #ifdef MOON_HAS_NETWORK
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #ifdef _WIN32
 #include <winsock2.h>
 #include <ws2tcpip.h>
@@ -50,7 +54,17 @@ static void init_wsa() {
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <netinet/tcp.h>
 #include <sys/select.h>
+#include <pthread.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+#include <sys/uio.h>
 
 #ifdef __linux__
 #include <sys/epoll.h>
@@ -69,77 +83,627 @@ static void init_wsa() {}
 #endif
 
 // ============================================================================
-// TCP Functions
+// DNS Resolver
 // ============================================================================
+// getaddrinfo() results are cached per host name with a positive and a
+// negative TTL. getaddrinfo does not expose record TTLs, so both are fixed
+// and tunable with dns_config(). Lookups issued from a coroutine run on a
+// small resolver thread pool while the coroutine yields, so a slow DNS
+// server never pins a scheduler worker.
 
-MoonValue* moon_tcp_connect(MoonValue* host, MoonValue* port) {
-    init_wsa();
-    if (!moon_is_string(host)) return moon_int(-1);
+#define DNS_MAX_ADDRS 16
+#define DNS_CACHE_MAX 4096
+#define DNS_POOL_THREADS 4
+#define NET_CONNECT_TIMEOUT_MS 30000
+#define NET_ATTEMPT_DELAY_MS 250     // RFC 8305 "Connection Attempt Delay"
+
+typedef struct {
+    struct sockaddr_storage addrs[DNS_MAX_ADDRS];
+    socklen_t lens[DNS_MAX_ADDRS];
+    int count;
+    int error;          // getaddrinfo() error code, 0 on success
+    int64_t expires;    // ms timestamp
+} DnsResult;
+
+typedef struct DnsJob {
+    char* host;
+    DnsResult result;
+    volatile long done;
+    void* waiter;       // Parked coroutine, woken by the resolver thread
+    struct DnsJob* next;
+} DnsJob;
+
+static std::unordered_map<std::string, DnsResult>* g_dns_cache = NULL;
+static int64_t g_dns_ttl_ms = 60000;
+static int64_t g_dns_negative_ttl_ms = 5000;
+static DnsJob* g_dns_queue_head = NULL;
+static DnsJob* g_dns_queue_tail = NULL;
+static bool g_dns_pool_started = false;
+
+#ifdef _WIN32
+static SRWLOCK g_dns_lock = SRWLOCK_INIT;
+static CONDITION_VARIABLE g_dns_cond = CONDITION_VARIABLE_INIT;
+static void dns_lock() { AcquireSRWLockExclusive(&g_dns_lock); }
+static void dns_unlock() { ReleaseSRWLockExclusive(&g_dns_lock); }
+#else
+static pthread_mutex_t g_dns_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_dns_cond = PTHREAD_COND_INITIALIZER;
+static void dns_lock() { pthread_mutex_lock(&g_dns_lock); }
+static void dns_unlock() { pthread_mutex_unlock(&g_dns_lock); }
+#endif
+
+static int64_t net_now_ms() {
+#ifdef _WIN32
+    return (int64_t)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
+
+// Run getaddrinfo and order the answers for happy eyeballs: alternate
+// address families, starting with whichever the system prefers.
+static void dns_getaddrinfo(const char* host, DnsResult* out) {
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_ADDRCONFIG;
+    
+    struct addrinfo* res = NULL;
+    out->count = 0;
+    out->error = getaddrinfo(host, NULL, &hints, &res);
+    if (out->error != 0) return;
+    
+    struct addrinfo* byFamily[2][DNS_MAX_ADDRS];
+    int n[2] = {0, 0};
+    int firstFamily = res ? res->ai_family : AF_INET;
+    for (struct addrinfo* ai = res; ai; ai = ai->ai_next) {
+        if (ai->ai_family != AF_INET && ai->ai_family != AF_INET6) continue;
+        int slot = (ai->ai_family == firstFamily) ? 0 : 1;
+        if (n[slot] < DNS_MAX_ADDRS) byFamily[slot][n[slot]++] = ai;
+    }
     
-    MOON_SOCKET sock = socket(AF_INET, SOCK_STREAM, 0);
-    if (sock == INVALID_SOCKET) return moon_int(-1);
+    for (int i = 0; out->count < DNS_MAX_ADDRS && (i < n[0] || i < n[1]); i++) {
+        for (int slot = 0; slot < 2 && out->count < DNS_MAX_ADDRS; slot++) {
+            if (i >= n[slot]) continue;
+            memcpy(&out->addrs[out->count], byFamily[slot][i]->ai_addr, byFamily[slot][i]->ai_addrlen);
+            out->lens[out->count] = (socklen_t)byFamily[slot][i]->ai_addrlen;
+            out->count++;
+        }
+    }
+    freeaddrinfo(res);
+    if (out->count == 0) out->error = EAI_NONAME;
+}
+
+// Publish the result and wake the waiter under g_dns_lock: the waiter
+// frees the job (and may finish) as soon as it sees done
+static void dns_job_finish(DnsJob* job) {
+    dns_lock();
+    job->done = 1;
+    moon_coro_wake(job->waiter);
+    dns_unlock();
+}
+
+static bool dns_job_done(DnsJob* job) {
+    dns_lock();
+    bool done = job->done != 0;
+    dns_unlock();
+    return done;
+}
+
+// Option lookup shared by the dns_* and tcp_listen* option dicts
+static MoonValue* net_option(MoonValue* options, const char* name) {
+    MoonValue* key = moon_string(name);
+    MoonValue* val = moon_dict_get(options, key, moon_null());
+    moon_release(key);
+    return val;
+}
+
+#ifdef _WIN32
+static DWORD WINAPI dns_worker(LPVOID param) {
+#else
+static void* dns_worker(void* param) {
+#endif
+    (void)param;
+    for (;;) {
+        dns_lock();
+        while (!g_dns_queue_head) {
+#ifdef _WIN32
+            SleepConditionVariableSRW(&g_dns_cond, &g_dns_lock, INFINITE, 0);
+#else
+            pthread_cond_wait(&g_dns_cond, &g_dns_lock);
+#endif
+        }
+        DnsJob* job = g_dns_queue_head;
+        g_dns_queue_head = job->next;
+        if (!g_dns_queue_head) g_dns_queue_tail = NULL;
+        dns_unlock();
+        
+        dns_getaddrinfo(job->host, &job->result);
+        dns_job_finish(job);
+    }
+#ifdef _WIN32
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+// Called with g_dns_lock held
+static void dns_start_pool() {
+    if (g_dns_pool_started) return;
+    g_dns_pool_started = true;
+    for (int i = 0; i < DNS_POOL_THREADS; i++) {
+#ifdef _WIN32
+        HANDLE h = CreateThread(NULL, 64 * 1024, dns_worker, NULL, 0, NULL);
+        if (h) CloseHandle(h);
+#else
+        pthread_t tid;
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        pthread_attr_setstacksize(&attr, 64 * 1024);
+        pthread_create(&tid, &attr, dns_worker, NULL);
+        pthread_attr_destroy(&attr);
+#endif
+    }
+}
+
+// Look up host, consulting the cache first. Returns true if at least one
+// address was found; out is filled either way.
+static bool dns_lookup(const char* host, DnsResult* out) {
+    memset(out, 0, sizeof(*out));
+    
+    // Numeric addresses never touch the cache or the pool
+    struct sockaddr_in* a4 = (struct sockaddr_in*)&out->addrs[0];
+    struct sockaddr_in6* a6 = (struct sockaddr_in6*)&out->addrs[0];
+    if (inet_pton(AF_INET, host, &a4->sin_addr) == 1) {
+        a4->sin_family = AF_INET;
+        out->lens[0] = sizeof(struct sockaddr_in);
+        out->count = 1;
+        return true;
+    }
+    if (inet_pton(AF_INET6, host, &a6->sin6_addr) == 1) {
+        a6->sin6_family = AF_INET6;
+        out->lens[0] = sizeof(struct sockaddr_in6);
+        out->count = 1;
+        return true;
+    }
     
-    struct sockaddr_in addr;
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons((unsigned short)moon_to_int(port));
+    std::string key(host);
+    int64_t now = net_now_ms();
+    
+    dns_lock();
+    if (g_dns_cache) {
+        auto it = g_dns_cache->find(key);
+        if (it != g_dns_cache->end()) {
+            if (it->second.expires > now) {
+                *out = it->second;
+                dns_unlock();
+                return out->count > 0;
+            }
+            g_dns_cache->erase(it);
+        }
+    }
+    dns_unlock();
+    
+    if (moon_in_coroutine()) {
+        // Hand the blocking call to the resolver pool and park until done
+        DnsJob* job = (DnsJob*)calloc(1, sizeof(DnsJob));
+        if (!job) return false;
+        job->host = strdup(host);
+        job->waiter = moon_coro_self();
+        
+        dns_lock();
+        dns_start_pool();
+        if (g_dns_queue_tail) g_dns_queue_tail->next = job;
+        else g_dns_queue_head = job;
+        g_dns_queue_tail = job;
+#ifdef _WIN32
+        WakeConditionVariable(&g_dns_cond);
+#else
+        pthread_cond_signal(&g_dns_cond);
+#endif
+        dns_unlock();
+        
+        while (!dns_job_done(job)) {
+            moon_coro_park();
+        }
+        *out = job->result;
+        free(job->host);
+        free(job);
+    } else {
+        dns_getaddrinfo(host, out);
+    }
     
-    struct hostent* he = gethostbyname(host->data.strVal);
-    if (!he) {
-        closesocket(sock);
-        return moon_int(-1);
+    out->expires = net_now_ms() + (out->count > 0 ? g_dns_ttl_ms : g_dns_negative_ttl_ms);
+    
+    // EAI_AGAIN is a transient failure (resolver unreachable); don't pin it
+    if (out->error != EAI_AGAIN) {
+        dns_lock();
+        if (!g_dns_cache) g_dns_cache = new std::unordered_map<std::string, DnsResult>();
+        if (g_dns_cache->size() >= DNS_CACHE_MAX) {
+            now = net_now_ms();
+            for (auto it = g_dns_cache->begin(); it != g_dns_cache->end(); ) {
+                if (it->second.expires <= now) it = g_dns_cache->erase(it);
+                else ++it;
+            }
+            if (g_dns_cache->size() >= DNS_CACHE_MAX) g_dns_cache->clear();
+        }
+        (*g_dns_cache)[key] = *out;
+        dns_unlock();
     }
-    memcpy(&addr.sin_addr, he->h_addr, he->h_length);
     
-    if (connect(sock, (struct sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR) {
-        closesocket(sock);
-        return moon_int(-1);
+    return out->count > 0;
+}
+
+static void net_set_port(struct sockaddr_storage* ss, int port) {
+    if (ss->ss_family == AF_INET6) {
+        ((struct sockaddr_in6*)ss)->sin6_port = htons((unsigned short)port);
+    } else {
+        ((struct sockaddr_in*)ss)->sin_port = htons((unsigned short)port);
     }
+}
+
+static void net_set_blocking(MOON_SOCKET sock, bool blocking) {
+#ifdef _WIN32
+    u_long mode = blocking ? 0 : 1;
+    ioctlsocket(sock, FIONBIO, &mode);
+#else
+    int flags = fcntl(sock, F_GETFL, 0);
+    fcntl(sock, F_SETFL, blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK));
+#endif
+}
+
+static bool net_connect_in_progress() {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EINPROGRESS;
+#endif
+}
+
+static bool net_would_block() {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+// Happy eyeballs (RFC 8305): start a connect to the first address, and
+// every NET_ATTEMPT_DELAY_MS (or as soon as an attempt fails) start the
+// next one. The first socket to complete wins; the rest are closed.
+int64_t moon_net_connect(const char* host, int port, int timeout_ms) {
+    init_wsa();
     
-    return moon_int((int64_t)sock);
+    DnsResult dns;
+    if (!host || !dns_lookup(host, &dns)) return -1;
+    if (timeout_ms <= 0) timeout_ms = NET_CONNECT_TIMEOUT_MS;
+    
+#ifdef _WIN32
+    WSAPOLLFD pfds[DNS_MAX_ADDRS];
+#else
+    struct pollfd pfds[DNS_MAX_ADDRS];
+#endif
+    int pending = 0;
+    int next = 0;
+    MOON_SOCKET winner = INVALID_SOCKET;
+    int64_t deadline = net_now_ms() + timeout_ms;
+    
+    while (winner == INVALID_SOCKET) {
+        // Start the next attempt
+        if (next < dns.count) {
+            struct sockaddr_storage* ss = &dns.addrs[next];
+            socklen_t len = dns.lens[next];
+            next++;
+            net_set_port(ss, port);
+            
+            MOON_SOCKET sock = socket(ss->ss_family, SOCK_STREAM, 0);
+            if (sock != INVALID_SOCKET) {
+                net_set_blocking(sock, false);
+                if (connect(sock, (struct sockaddr*)ss, len) == 0) {
+                    winner = sock;
+                    break;
+                } else if (net_connect_in_progress()) {
+                    pfds[pending].fd = sock;
+                    pfds[pending].events = POLLOUT;
+                    pfds[pending].revents = 0;
+                    pending++;
+                } else {
+                    closesocket(sock);
+                    continue;  // Failed immediately: try the next address now
+                }
+            }
+        }
+        
+        if (pending == 0) {
+            if (next >= dns.count) break;
+            continue;
+        }
+        
+        int64_t now = net_now_ms();
+        if (now >= deadline) break;
+        int wait = (int)(deadline - now);
+        if (next < dns.count && wait > NET_ATTEMPT_DELAY_MS) wait = NET_ATTEMPT_DELAY_MS;
+        
+        // Inside a coroutine, park until an attempt completes (the reactor
+        // watches the sockets) and then collect which ones did
+        int ready;
+        if (moon_in_coroutine()) {
+            int64_t fds[DNS_MAX_ADDRS];
+            for (int i = 0; i < pending; i++) fds[i] = (int64_t)pfds[i].fd;
+            ready = moon_io_wait_fds(fds, pending, true, wait);
+            if (ready > 0) {
+#ifdef _WIN32
+                ready = WSAPoll(pfds, pending, 0);
+#else
+                ready = poll(pfds, pending, 0);
+#endif
+            }
+        } else {
+#ifdef _WIN32
+            ready = WSAPoll(pfds, pending, wait);
+#else
+            ready = poll(pfds, pending, wait);
+#endif
+        }
+        if (ready <= 0) continue;  // Attempt delay elapsed: start the next one
+        
+        for (int i = 0; i < pending; i++) {
+            if (!pfds[i].revents) continue;
+            int err = 0;
+            socklen_t errLen = sizeof(err);
+            getsockopt(pfds[i].fd, SOL_SOCKET, SO_ERROR, (char*)&err, &errLen);
+            if (err == 0 && (pfds[i].revents & POLLOUT)) {
+                winner = pfds[i].fd;
+                pfds[i] = pfds[--pending];
+                break;
+            }
+            // Attempt failed: drop it, which lets the next one start right away
+            closesocket(pfds[i].fd);
+            pfds[i] = pfds[--pending];
+            i--;
+        }
+    }
+    
+    for (int i = 0; i < pending; i++) closesocket(pfds[i].fd);
+    if (winner == INVALID_SOCKET) return -1;
+    
+    net_set_blocking(winner, true);
+    return (int64_t)winner;
 }
 
-MoonValue* moon_tcp_listen(MoonValue* port) {
+// dns_resolve(host) - list of address strings, IPv4 and IPv6 interleaved
+// in connect order. Empty list when the name does not resolve.
+MoonValue* moon_dns_resolve(MoonValue* host) {
     init_wsa();
+    MoonValue* result = moon_list_new();
+    if (!moon_is_string(host)) return result;
+    
+    DnsResult dns;
+    dns_lookup(host->data.strVal, &dns);
+    for (int i = 0; i < dns.count; i++) {
+        char addrBuf[INET6_ADDRSTRLEN];
+        if (dns.addrs[i].ss_family == AF_INET6) {
+            inet_ntop(AF_INET6, &((struct sockaddr_in6*)&dns.addrs[i])->sin6_addr, addrBuf, sizeof(addrBuf));
+        } else {
+            inet_ntop(AF_INET, &((struct sockaddr_in*)&dns.addrs[i])->sin_addr, addrBuf, sizeof(addrBuf));
+        }
+        MoonValue* v = moon_string(addrBuf);
+        moon_list_append(result, v);
+        moon_release(v);
+    }
+    return result;
+}
+
+// dns_config({ttl, negative_ttl}) - cache lifetimes in seconds
+void moon_dns_config(MoonValue* options) {
+    if (!options || options->type != MOON_DICT) return;
+    MoonValue* v = net_option(options, "ttl");
+    if (v->type != MOON_NULL) g_dns_ttl_ms = moon_to_int(v) * 1000;
+    moon_release(v);
+    v = net_option(options, "negative_ttl");
+    if (v->type != MOON_NULL) g_dns_negative_ttl_ms = moon_to_int(v) * 1000;
+    moon_release(v);
+}
+
+// dns_clear() - drop all cached answers
+void moon_dns_clear(void) {
+    dns_lock();
+    if (g_dns_cache) g_dns_cache->clear();
+    dns_unlock();
+}
+
+// ============================================================================
+// TCP Functions
+// ============================================================================
+
+MoonValue* moon_tcp_connect(MoonValue* host, MoonValue* port) {
+    if (!moon_is_string(host)) return moon_int(-1);
+    return moon_int(moon_net_connect(host->data.strVal, (int)moon_to_int(port), 0));
+}
+
+// Listener options read from the optional tcp_listen() dict
+typedef struct {
+    int backlog;
+    bool reuseport;
+    bool ipv6;
+    bool nodelay;
+    int defer_accept;   // seconds (Linux TCP_DEFER_ACCEPT), 0 = off
+} TcpListenOptions;
+
+static void tcp_parse_listen_options(MoonValue* options, TcpListenOptions* opts) {
+    opts->backlog = SOMAXCONN;
+    opts->reuseport = false;
+    opts->ipv6 = false;
+    opts->nodelay = false;
+    opts->defer_accept = 0;
+    if (!options || options->type != MOON_DICT) return;
+    
+    MoonValue* v = net_option(options, "backlog");
+    if (v->type != MOON_NULL && moon_to_int(v) > 0) opts->backlog = (int)moon_to_int(v);
+    moon_release(v);
+    
+    v = net_option(options, "reuseport");
+    opts->reuseport = moon_to_bool(v);
+    moon_release(v);
+    
+    v = net_option(options, "ipv6");
+    opts->ipv6 = moon_to_bool(v);
+    moon_release(v);
+    
+    v = net_option(options, "nodelay");
+    opts->nodelay = moon_to_bool(v);
+    moon_release(v);
+    
+    // defer_accept: true (1s) or a number of seconds
+    v = net_option(options, "defer_accept");
+    if (v->type == MOON_BOOL) opts->defer_accept = moon_to_bool(v) ? 1 : 0;
+    else if (v->type != MOON_NULL) opts->defer_accept = (int)moon_to_int(v);
+    moon_release(v);
+}
+
+static MOON_SOCKET tcp_open_listener(int port, const TcpListenOptions* opts) {
+    int family = opts->ipv6 ? AF_INET6 : AF_INET;
+    MOON_SOCKET sock = socket(family, SOCK_STREAM, 0);
+    if (sock == INVALID_SOCKET) return INVALID_SOCKET;
     
-    MOON_SOCKET sock = socket(AF_INET, SOCK_STREAM, 0);
-    if (sock == INVALID_SOCKET) return moon_int(-1);
+#ifndef _WIN32
+    fcntl(sock, F_SETFD, FD_CLOEXEC);
+#endif
     
     int opt = 1;
     setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, (const char*)&opt, sizeof(opt));
     
-    struct sockaddr_in addr;
-    addr.sin_family = AF_INET;
-    addr.sin_addr.s_addr = INADDR_ANY;
-    addr.sin_port = htons((unsigned short)moon_to_int(port));
+    if (opts->reuseport) {
+#ifdef SO_REUSEPORT
+        // Each listener gets its own accept queue; the kernel load-balances
+        // incoming connections across every socket bound to the port.
+        if (setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, (const char*)&opt, sizeof(opt)) != 0) {
+            closesocket(sock);
+            return INVALID_SOCKET;
+        }
+#endif
+    }
     
-    if (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR) {
-        closesocket(sock);
-        return moon_int(-1);
+    if (opts->nodelay) {
+        // Inherited by accepted sockets on Linux; applied again in accept elsewhere
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&opt, sizeof(opt));
+    }
+    
+#ifdef TCP_DEFER_ACCEPT
+    if (opts->defer_accept > 0) {
+        // Only wake accept() once the client has sent data
+        int secs = opts->defer_accept;
+        setsockopt(sock, IPPROTO_TCP, TCP_DEFER_ACCEPT, (const char*)&secs, sizeof(secs));
+    }
+#endif
+    
+    int bound;
+    if (family == AF_INET6) {
+        // Dual-stack: also accept IPv4 clients as v4-mapped addresses
+        int off = 0;
+        setsockopt(sock, IPPROTO_IPV6, IPV6_V6ONLY, (const char*)&off, sizeof(off));
+        
+        struct sockaddr_in6 addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin6_family = AF_INET6;
+        addr.sin6_addr = in6addr_any;
+        addr.sin6_port = htons((unsigned short)port);
+        bound = bind(sock, (struct sockaddr*)&addr, sizeof(addr));
+    } else {
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = INADDR_ANY;
+        addr.sin_port = htons((unsigned short)port);
+        bound = bind(sock, (struct sockaddr*)&addr, sizeof(addr));
     }
     
-    if (listen(sock, 10) == SOCKET_ERROR) {
+    if (bound == SOCKET_ERROR || listen(sock, opts->backlog) == SOCKET_ERROR) {
         closesocket(sock);
-        return moon_int(-1);
+        return INVALID_SOCKET;
     }
     
+    return sock;
+}
+
+// tcp_listen(port) or tcp_listen(port, {backlog, reuseport, ipv6, nodelay, defer_accept})
+MoonValue* moon_tcp_listen(MoonValue* port, MoonValue* options) {
+    init_wsa();
+    
+    TcpListenOptions opts;
+    tcp_parse_listen_options(options, &opts);
+    
+    MOON_SOCKET sock = tcp_open_listener((int)moon_to_int(port), &opts);
+    if (sock == INVALID_SOCKET) return moon_int(-1);
     return moon_int((int64_t)sock);
 }
 
-MoonValue* moon_tcp_accept(MoonValue* server) {
-    MOON_SOCKET serverSock = (MOON_SOCKET)moon_to_int(server);
-    struct sockaddr_in clientAddr;
-    socklen_t addrLen = sizeof(clientAddr);
+// tcp_listen_group(port, options) - one SO_REUSEPORT listener per scheduler
+// worker (or options.count), so each worker accepts from its own queue.
+// Returns a list of listener sockets, or an empty list on failure.
+MoonValue* moon_tcp_listen_group(MoonValue* port, MoonValue* options) {
+    init_wsa();
     
-    MOON_SOCKET clientSock = accept(serverSock, (struct sockaddr*)&clientAddr, &addrLen);
-    if (clientSock == INVALID_SOCKET) return moon_int(-1);
+    TcpListenOptions opts;
+    tcp_parse_listen_options(options, &opts);
+    opts.reuseport = true;
     
-    // Use thread-safe inet_ntop instead of inet_ntoa
-    char addrBuf[INET_ADDRSTRLEN];
-#ifdef _WIN32
-    inet_ntop(AF_INET, &clientAddr.sin_addr, addrBuf, sizeof(addrBuf));
-#else
-    inet_ntop(AF_INET, &clientAddr.sin_addr, addrBuf, sizeof(addrBuf));
+    int count = 0;
+    if (options && options->type == MOON_DICT) {
+        MoonValue* v = net_option(options, "count");
+        count = (int)moon_to_int(v);
+        moon_release(v);
+    }
+    if (count <= 0) count = moon_sched_workers();  // One listener per worker
+#ifndef SO_REUSEPORT
+    count = 1;  // No kernel load balancing: a single shared listener
 #endif
+    if (count < 1) count = 1;
+    
+    MoonValue* result = moon_list_new();
+    for (int i = 0; i < count; i++) {
+        MOON_SOCKET sock = tcp_open_listener((int)moon_to_int(port), &opts);
+        if (sock == INVALID_SOCKET) {
+            // All-or-nothing: don't hand out a partially bound group
+            MoonList* list = result->data.listVal;
+            for (int j = 0; j < list->length; j++) {
+                closesocket((MOON_SOCKET)moon_to_int(list->items[j]));
+            }
+            moon_release(result);
+            return moon_list_new();
+        }
+        MoonValue* v = moon_int((int64_t)sock);
+        moon_release(moon_list_append(result, v));
+        moon_release(v);
+    }
+    return result;
+}
+
+// Build the {socket, address, port} dict returned by the accept family.
+// IPv4 clients on a dual-stack listener are reported in plain dotted form.
+static MoonValue* tcp_accept_result(MOON_SOCKET clientSock, struct sockaddr_storage* ss) {
+    char addrBuf[INET6_ADDRSTRLEN];
+    int clientPort = 0;
+    addrBuf[0] = '\0';
+    
+    if (ss->ss_family == AF_INET6) {
+        struct sockaddr_in6* a6 = (struct sockaddr_in6*)ss;
+        if (IN6_IS_ADDR_V4MAPPED(&a6->sin6_addr)) {
+            inet_ntop(AF_INET, &a6->sin6_addr.s6_addr[12], addrBuf, sizeof(addrBuf));
+        } else {
+            inet_ntop(AF_INET6, &a6->sin6_addr, addrBuf, sizeof(addrBuf));
+        }
+        clientPort = ntohs(a6->sin6_port);
+    } else {
+        struct sockaddr_in* a4 = (struct sockaddr_in*)ss;
+        inet_ntop(AF_INET, &a4->sin_addr, addrBuf, sizeof(addrBuf));
+        clientPort = ntohs(a4->sin_port);
+    }
     
     MoonValue* result = moon_dict_new();
     MoonValue* sockKey = moon_string("socket");
@@ -147,7 +711,7 @@ MoonValue* moon_tcp_accept(MoonValue* server) {
     MoonValue* addrKey = moon_string("address");
     MoonValue* addrVal = moon_string(addrBuf);
     MoonValue* portKey = moon_string("port");
-    MoonValue* portVal = moon_int(ntohs(clientAddr.sin_port));
+    MoonValue* portVal = moon_int(clientPort);
     
     moon_dict_set(result, sockKey, sockVal);
     moon_dict_set(result, addrKey, addrVal);
@@ -163,56 +727,429 @@ MoonValue* moon_tcp_accept(MoonValue* server) {
     return result;
 }
 
-MoonValue* moon_tcp_send(MoonValue* socket, MoonValue* data) {
-    MOON_SOCKET sock = (MOON_SOCKET)moon_to_int(socket);
-    
-    // For string type, use its actual length (supports binary data)
-    int len = 0;
-    const char* str = NULL;
-    char* toFree = NULL;
-    
-    if (data && data->type == MOON_STRING && data->data.strVal) {
-        str = data->data.strVal;
-        MoonStrHeader* header = moon_str_get_header(data->data.strVal);
-        if (header) {
-            len = (int)header->length;
+// accept() with close-on-exec (and optionally non-blocking) set atomically
+// where accept4 exists. Linux accepted sockets inherit TCP_NODELAY from the
+// listener; elsewhere it is copied over explicitly. With wait, an empty queue
+// on a non-blocking listener (another worker took the connection) is waited
+// out with moon_io_wait, so a coroutine parks instead of blocking its worker;
+// without wait, INVALID_SOCKET is returned straight away.
+static MOON_SOCKET tcp_accept_socket(MOON_SOCKET serverSock, struct sockaddr_storage* ss,
+                                     bool nonblocking, bool wait) {
+    MOON_SOCKET clientSock;
+    for (;;) {
+        socklen_t addrLen = sizeof(*ss);
+#ifdef __linux__
+        int flags = SOCK_CLOEXEC | (nonblocking ? SOCK_NONBLOCK : 0);
+        if (wait) {
+            clientSock = (MOON_SOCKET)moon_io_accept((int64_t)serverSock, ss, &addrLen, flags);
+        } else {
+            do {
+                clientSock = accept4(serverSock, (struct sockaddr*)ss, &addrLen, flags);
+            } while (clientSock == INVALID_SOCKET && errno == EINTR);
+        }
+#else
+        if (wait) {
+            clientSock = (MOON_SOCKET)moon_io_accept((int64_t)serverSock, ss, &addrLen, 0);
+        } else {
+            clientSock = accept(serverSock, (struct sockaddr*)ss, &addrLen);
+        }
+#endif
+        if (clientSock != INVALID_SOCKET || !wait || !net_would_block()) break;
+        moon_io_wait((int64_t)serverSock, false, -1);
+    }
+#ifndef __linux__
+    if (clientSock == INVALID_SOCKET) return INVALID_SOCKET;
+#ifdef _WIN32
+    if (nonblocking) {
+        u_long mode = 1;
+        ioctlsocket(clientSock, FIONBIO, &mode);
+    }
+#else
+    fcntl(clientSock, F_SETFD, FD_CLOEXEC);
+    if (nonblocking) fcntl(clientSock, F_SETFL, fcntl(clientSock, F_GETFL, 0) | O_NONBLOCK);
+#endif
+    int nodelay = 0;
+    socklen_t optLen = sizeof(nodelay);
+    if (getsockopt(serverSock, IPPROTO_TCP, TCP_NODELAY, (char*)&nodelay, &optLen) == 0 && nodelay) {
+        setsockopt(clientSock, IPPROTO_TCP, TCP_NODELAY, (const char*)&nodelay, sizeof(nodelay));
+    }
+#endif
+    return clientSock;
+}
+
+MoonValue* moon_tcp_accept(MoonValue* server) {
+    MOON_SOCKET serverSock = (MOON_SOCKET)moon_to_int(server);
+    struct sockaddr_storage clientAddr;
+    
+    MOON_SOCKET clientSock = tcp_accept_socket(serverSock, &clientAddr, false, true);
+    if (clientSock == INVALID_SOCKET) return moon_int(-1);
+    
+    return tcp_accept_result(clientSock, &clientAddr);
+}
+
+// tcp_accept_batch(server, max) - wait for the first connection, then drain
+// up to max-1 more that are already queued. The listener is switched to
+// non-blocking so a connection another worker takes first ends the drain (or,
+// for the first one, parks the coroutine) instead of blocking in accept().
+// Accepted sockets are non-blocking, ready for tcp_select /
+// tcp_recv_nonblocking loops.
+MoonValue* moon_tcp_accept_batch(MoonValue* server, MoonValue* max) {
+    MOON_SOCKET serverSock = (MOON_SOCKET)moon_to_int(server);
+    int limit = (int)moon_to_int(max);
+    if (limit <= 0) limit = 64;
+    net_set_blocking(serverSock, false);
+    
+    MoonValue* result = moon_list_new();
+    for (int i = 0; i < limit; i++) {
+        struct sockaddr_storage clientAddr;
+        MOON_SOCKET clientSock = tcp_accept_socket(serverSock, &clientAddr, true, i == 0);
+        if (clientSock == INVALID_SOCKET) break;
+        
+        MoonValue* entry = tcp_accept_result(clientSock, &clientAddr);
+        moon_release(moon_list_append(result, entry));
+        moon_release(entry);
+    }
+    return result;
+}
+
+MoonValue* moon_tcp_send(MoonValue* socket, MoonValue* data) {
+    MOON_SOCKET sock = (MOON_SOCKET)moon_to_int(socket);
+    
+    // Strings and buffers are sent as-is (binary-safe)
+    size_t len = 0;
+    char* toFree = NULL;
+    const char* str = moon_bytes_view(data, &len);
+    if (!str) {
+        toFree = moon_to_string(data);
+        str = toFree;
+        len = strlen(str);
+    }
+    
+    int sent = (int)moon_io_send((int64_t)sock, str, len);
+    
+    if (toFree) {
+        moon_free(toFree, 0);
+    }
+    
+    return moon_int(sent);
+}
+
+// Binary-safe view of a value's bytes. Non-strings are converted with
+// moon_to_string and must be released with moon_free(*toFree, 0).
+static const char* net_bytes(MoonValue* data, size_t* len, char** toFree) {
+    *toFree = NULL;
+    const char* bytes = moon_bytes_view(data, len);
+    if (bytes) return bytes;
+    *toFree = moon_to_string(data);
+    *len = strlen(*toFree);
+    return *toFree;
+}
+
+#define NET_IOV_BATCH 64
+
+// tcp_sendv(sock, parts) - send a list of strings with gathered writes
+// (writev / WSASend) instead of one send() per string. Partial writes are
+// resumed; returns total bytes sent, or -1 if nothing could be sent.
+MoonValue* moon_tcp_sendv(MoonValue* socket, MoonValue* parts) {
+    MOON_SOCKET sock = (MOON_SOCKET)moon_to_int(socket);
+    if (!moon_is_list(parts)) return moon_tcp_send(socket, parts);
+    
+    MoonList* list = parts->data.listVal;
+    int64_t total = 0;
+    int idx = 0;          // next list item to queue
+    size_t skip = 0;      // bytes of list item idx already sent
+    
+    while (idx < list->length) {
+#ifdef _WIN32
+        WSABUF iov[NET_IOV_BATCH];
+#else
+        struct iovec iov[NET_IOV_BATCH];
+#endif
+        char* toFree[NET_IOV_BATCH];
+        int n = 0;
+        for (int i = idx; i < list->length && n < NET_IOV_BATCH; i++) {
+            size_t len;
+            const char* p = net_bytes(list->items[i], &len, &toFree[n]);
+            if (i == idx) {
+                p += skip;
+                len -= skip;
+            }
+#ifdef _WIN32
+            iov[n].buf = (char*)p;
+            iov[n].len = (ULONG)len;
+#else
+            iov[n].iov_base = (void*)p;
+            iov[n].iov_len = len;
+#endif
+            n++;
+        }
+        
+#ifdef _WIN32
+        DWORD sentBytes = 0;
+        int64_t sent = WSASend(sock, iov, (DWORD)n, &sentBytes, 0, NULL, NULL) == 0 ? (int64_t)sentBytes : -1;
+#else
+        int64_t sent;
+        do {
+            sent = writev(sock, iov, n);
+        } while (sent < 0 && errno == EINTR);
+#endif
+        for (int i = 0; i < n; i++) moon_free(toFree[i], 0);
+        if (sent < 0) return moon_int(total > 0 ? total : -1);
+        total += sent;
+        
+        // Advance past fully sent items; remember the offset into a partial one
+        size_t left = (size_t)sent;
+        for (int i = 0; i < n; i++) {
+#ifdef _WIN32
+            size_t len = iov[i].len;
+#else
+            size_t len = iov[i].iov_len;
+#endif
+            if (left >= len) {
+                left -= len;
+                idx++;
+                skip = 0;
+            } else {
+                skip += left;
+                break;
+            }
+        }
+        if (sent == 0) break;
+    }
+    return moon_int(total);
+}
+
+// tcp_recv(sock) or tcp_recv(sock, max) - one recv() of up to max bytes
+// (default 4096) directly into the result string. Binary safe.
+MoonValue* moon_tcp_recv(MoonValue* socket, MoonValue* max) {
+    MOON_SOCKET sock = (MOON_SOCKET)moon_to_int(socket);
+    int cap = (max && max->type != MOON_NULL) ? (int)moon_to_int(max) : 4096;
+    if (cap <= 0) cap = 4096;
+    
+    char* buffer = moon_str_buffer((size_t)cap);
+    int64_t received = moon_io_recv((int64_t)sock, buffer, (size_t)cap);
+    return moon_str_finish(buffer, received > 0 ? (size_t)received : 0);
+}
+
+void moon_tcp_close(MoonValue* socket) {
+    MOON_SOCKET sock = (MOON_SOCKET)moon_to_int(socket);
+    closesocket(sock);
+}
+
+// ============================================================================
+// Buffered Reader (recv_exact / recv_until)
+// ============================================================================
+// One reader per connection. Small reads are served from an internal
+// buffer; large recv_exact() requests read straight into the result string.
+
+#define READER_BUF_SIZE 16384
+#define READER_UNTIL_MAX (1024 * 1024)
+
+typedef struct {
+    MoonReadFn read;
+    void* src;
+    char* buf;
+    int cap;
+    int start;      // first unread byte
+    int end;        // one past the last buffered byte
+} MoonReader;
+
+static int tcp_read_fn(void* src, char* buf, int len) {
+    return (int)moon_io_recv((int64_t)(intptr_t)src, buf, (size_t)len);
+}
+
+MoonValue* moon_reader_wrap(MoonReadFn fn, void* src) {
+    MoonReader* r = (MoonReader*)calloc(1, sizeof(MoonReader));
+    if (!r) return moon_null();
+    r->buf = (char*)malloc(READER_BUF_SIZE);
+    if (!r->buf) {
+        free(r);
+        return moon_null();
+    }
+    r->read = fn;
+    r->src = src;
+    r->cap = READER_BUF_SIZE;
+    return moon_int((int64_t)(uintptr_t)r);
+}
+
+// tcp_reader(sock) - buffered reader over a TCP socket
+MoonValue* moon_tcp_reader(MoonValue* socket) {
+    return moon_reader_wrap(tcp_read_fn, (void*)(intptr_t)moon_to_int(socket));
+}
+
+// Read more data into the buffer, compacting or growing it first so that
+// at least one byte of space is free. Returns bytes read, <= 0 on EOF/error.
+static int reader_fill(MoonReader* r, int maxCap) {
+    if (r->start > 0 && r->end == r->cap) {
+        memmove(r->buf, r->buf + r->start, r->end - r->start);
+        r->end -= r->start;
+        r->start = 0;
+    }
+    if (r->end == r->cap) {
+        if (r->cap >= maxCap) return -1;
+        int newCap = r->cap * 2 > maxCap ? maxCap : r->cap * 2;
+        char* grown = (char*)realloc(r->buf, newCap);
+        if (!grown) return -1;
+        r->buf = grown;
+        r->cap = newCap;
+    }
+    int n = r->read(r->src, r->buf + r->end, r->cap - r->end);
+    if (n > 0) r->end += n;
+    return n;
+}
+
+// recv_exact(reader, n) - exactly n bytes, or null if the peer closes first.
+// Bytes read before the failure are lost.
+MoonValue* moon_recv_exact(MoonValue* reader, MoonValue* count) {
+    MoonReader* r = (MoonReader*)(uintptr_t)moon_to_int(reader);
+    int64_t n = moon_to_int(count);
+    if (!r || n < 0) return moon_null();
+    
+    char* out = moon_str_buffer((size_t)n);
+    int64_t got = r->end - r->start;
+    if (got > n) got = n;
+    memcpy(out, r->buf + r->start, (size_t)got);
+    r->start += (int)got;
+    
+    while (got < n) {
+        int64_t want = n - got;
+        int rd;
+        if (want >= r->cap) {
+            // Bulk transfer: skip the intermediate buffer entirely
+            rd = r->read(r->src, out + got, want > INT32_MAX ? INT32_MAX : (int)want);
+            if (rd > 0) got += rd;
         } else {
-            len = (int)strlen(str);
+            r->start = r->end = 0;
+            rd = reader_fill(r, r->cap);
+            if (rd > 0) {
+                int take = rd < want ? rd : (int)want;
+                memcpy(out + got, r->buf, take);
+                r->start = take;
+                got += take;
+            }
+        }
+        if (rd <= 0) {
+            moon_release(moon_str_finish(out, 0));
+            return moon_null();
         }
-    } else {
-        toFree = moon_to_string(data);
-        str = toFree;
-        len = (int)strlen(str);
-    }
-    
-    int sent = send(sock, str, len, 0);
-    
-    if (toFree) {
-        free(toFree);
     }
-    
-    return moon_int(sent);
+    return moon_str_finish(out, (size_t)n);
 }
 
-MoonValue* moon_tcp_recv(MoonValue* socket) {
-    MOON_SOCKET sock = (MOON_SOCKET)moon_to_int(socket);
-    char buffer[4096];
-    int received = recv(sock, buffer, sizeof(buffer) - 1, 0);
-    if (received <= 0) return moon_string("");
-    buffer[received] = '\0';
-    
-    // Create string with explicit length (supports binary data including \\0)
-    char* result = moon_str_with_capacity(buffer, received, received);
-    MoonStrHeader* header = moon_str_get_header(result);
-    if (header) {
-        header->length = received;
+// recv_until(reader, delim[, max]) - data up to (not including) delim, which
+// is consumed. Returns null on EOF, or if max bytes (default 1MB) arrive
+// without a delimiter; buffered data is kept for the next call.
+MoonValue* moon_recv_until(MoonValue* reader, MoonValue* delim, MoonValue* max) {
+    MoonReader* r = (MoonReader*)(uintptr_t)moon_to_int(reader);
+    if (!r || !moon_is_string(delim)) return moon_null();
+    
+    const char* d = delim->data.strVal;
+    MoonStrHeader* dh = moon_str_get_header(d);
+    int dlen = dh ? (int)dh->length : (int)strlen(d);
+    if (dlen == 0) return moon_null();
+    
+    int limit = (max && max->type != MOON_NULL) ? (int)moon_to_int(max) : READER_UNTIL_MAX;
+    if (limit <= 0) limit = READER_UNTIL_MAX;
+    
+    int scanned = r->start;  // no match starts before this offset
+    for (;;) {
+        const char* hit = NULL;
+        for (int i = scanned; i + dlen <= r->end; i++) {
+            if (r->buf[i] == d[0] && memcmp(r->buf + i, d, dlen) == 0) {
+                hit = r->buf + i;
+                break;
+            }
+        }
+        if (hit) {
+            int len = (int)(hit - (r->buf + r->start));
+            char* out = moon_str_with_capacity(r->buf + r->start, len, len);
+            r->start += len + dlen;
+            if (r->start == r->end) r->start = r->end = 0;
+            return moon_string_owned(out);
+        }
+        
+        int pending = r->end - r->start;
+        if (pending >= limit) return moon_null();
+        scanned = r->end - dlen + 1;
+        if (scanned < r->start) scanned = r->start;
+        
+        int oldStart = r->start;
+        if (reader_fill(r, limit + dlen) <= 0) return moon_null();
+        scanned -= oldStart - r->start;  // buffer may have been compacted
     }
-    return moon_string_owned(result);
 }
 
-void moon_tcp_close(MoonValue* socket) {
+// reader_close(reader) - free the reader (the socket stays open)
+void moon_reader_close(MoonValue* reader) {
+    MoonReader* r = (MoonReader*)(uintptr_t)moon_to_int(reader);
+    if (!r) return;
+    free(r->buf);
+    free(r);
+}
+
+// ============================================================================
+// File Transfer
+// ============================================================================
+
+// tcp_send_file(sock, path) - stream a file to a socket without copying it
+// through user space (sendfile on Linux/macOS, TransmitFile on Windows).
+// Returns bytes sent, or -1 if the file can't be opened.
+MoonValue* moon_tcp_send_file(MoonValue* socket, MoonValue* path) {
     MOON_SOCKET sock = (MOON_SOCKET)moon_to_int(socket);
-    closesocket(sock);
+    if (!moon_is_string(path)) return moon_int(-1);
+    
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path->data.strVal, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return moon_int(-1);
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return moon_int(-1);
+    }
+    BOOL ok = TransmitFile(sock, file, 0, 0, NULL, NULL, TF_USE_KERNEL_APC);
+    CloseHandle(file);
+    return moon_int(ok ? (int64_t)size.QuadPart : -1);
+#else
+    int fd = open(path->data.strVal, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return moon_int(-1);
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return moon_int(-1);
+    }
+    
+    int64_t total = 0;
+    int64_t size = (int64_t)st.st_size;
+    while (total < size) {
+#if defined(__linux__)
+        off_t off = (off_t)total;
+        ssize_t n = sendfile(sock, fd, &off, (size_t)(size - total));
+#elif defined(__APPLE__)
+        off_t len = (off_t)(size - total);
+        int rc = sendfile(fd, sock, (off_t)total, &len, NULL, 0);
+        ssize_t n = (rc == 0 || len > 0) ? (ssize_t)len : -1;
+#else
+        char chunk[65536];
+        ssize_t n = pread(fd, chunk, sizeof(chunk), (off_t)total);
+        if (n > 0) n = send(sock, chunk, (size_t)n, 0);
+#endif
+        if (n > 0) {
+            total += n;
+        } else if (n < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Non-blocking socket with a full send buffer: wait until writable
+            struct pollfd pfd;
+            pfd.fd = sock;
+            pfd.events = POLLOUT;
+            pfd.revents = 0;
+            if (errno != EINTR && poll(&pfd, 1, NET_CONNECT_TIMEOUT_MS) <= 0) break;
+        } else {
+            break;
+        }
+    }
+    close(fd);
+    return moon_int(total);
+#endif
 }
 
 // ============================================================================
@@ -678,20 +1615,433 @@ MoonValue* moon_tcp_recv_nonblocking(MoonValue* socket) {
     return moon_string_owned(result);
 }
 
-// IOCP stubs for Linux (IOCP is Windows-only, use epoll directly on Linux)
+#endif // _WIN32 or Linux
+
+// ============================================================================
+// Persistent Poller
+// ============================================================================
+// A poller keeps its interest set in the kernel (epoll on Linux, kqueue on
+// macOS), so each wait costs O(ready) instead of rebuilding the whole set
+// the way tcp_select does. Elsewhere a pollfd array is maintained
+// incrementally. Every wait returns a new list of ready events, so threads
+// waiting on the same poller never share one; each entry is a per-fd dict
+// reused across waits: {fd, data, read, write, error}.
+
+#define POLLER_READ     0x01
+#define POLLER_WRITE    0x02
+#define POLLER_EDGE     0x04    // Edge-triggered (epoll/kqueue only)
+#define POLLER_ONESHOT  0x08    // Disarm after one event until poller_mod
+#define POLLER_MAX_EVENTS 1024
+
+typedef struct {
+    MOON_SOCKET fd;
+    int events;
+    MoonValue* event;           // Reused {fd, data, read, write, error} dict
+    int index;                  // Slot in pfds (poll fallback)
+} PollerEntry;
+
+typedef struct {
+#if defined(__linux__)
+    int epfd;
+#elif defined(__APPLE__)
+    int kq;
+#else
+    std::vector<struct pollfd> pfds;
+#endif
+    std::unordered_map<int64_t, PollerEntry*> entries;
+#ifdef _WIN32
+    SRWLOCK lock;
+#else
+    pthread_mutex_t lock;
+#endif
+} MoonPoller;
+
+static MoonValue* g_key_fd = NULL;
+static MoonValue* g_key_data = NULL;
+static MoonValue* g_key_read = NULL;
+static MoonValue* g_key_write = NULL;
+static MoonValue* g_key_error = NULL;
+
+static void poller_lock(MoonPoller* p) {
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&p->lock);
+#else
+    pthread_mutex_lock(&p->lock);
+#endif
+}
+
+static void poller_unlock(MoonPoller* p) {
+#ifdef _WIN32
+    ReleaseSRWLockExclusive(&p->lock);
+#else
+    pthread_mutex_unlock(&p->lock);
+#endif
+}
+
+static MoonPoller* poller_get(MoonValue* v) {
+    return (MoonPoller*)(uintptr_t)moon_to_int(v);
+}
+
+// "read", "write" or "both", optionally with "edge" / "oneshot"
+// (e.g. "read edge"); an integer is taken as POLLER_* flags
+static int poller_parse_events(MoonValue* events) {
+    if (!moon_is_string(events)) {
+        int flags = events && events->type == MOON_INT ? (int)moon_to_int(events) : POLLER_READ;
+        return flags ? flags : POLLER_READ;
+    }
+    const char* s = events->data.strVal;
+    int flags = 0;
+    if (strstr(s, "read")) flags |= POLLER_READ;
+    if (strstr(s, "write")) flags |= POLLER_WRITE;
+    if (strstr(s, "both")) flags |= POLLER_READ | POLLER_WRITE;
+    if (strstr(s, "edge")) flags |= POLLER_EDGE;
+    if (strstr(s, "oneshot")) flags |= POLLER_ONESHOT;
+    if (!(flags & (POLLER_READ | POLLER_WRITE))) flags |= POLLER_READ;
+    return flags;
+}
+
+// Register, change or remove (events == 0 with op 'd') interest in the kernel
+static bool poller_ctl(MoonPoller* p, PollerEntry* e, char op) {
+#if defined(__linux__)
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    if (e->events & POLLER_READ) ev.events |= EPOLLIN | EPOLLRDHUP;
+    if (e->events & POLLER_WRITE) ev.events |= EPOLLOUT;
+    if (e->events & POLLER_EDGE) ev.events |= EPOLLET;
+    if (e->events & POLLER_ONESHOT) ev.events |= EPOLLONESHOT;
+    ev.data.fd = e->fd;
+    int ctl = op == 'a' ? EPOLL_CTL_ADD : op == 'm' ? EPOLL_CTL_MOD : EPOLL_CTL_DEL;
+    return epoll_ctl(p->epfd, ctl, e->fd, &ev) == 0;
+#elif defined(__APPLE__)
+    struct kevent changes[2];
+    int n = 0;
+    unsigned short extra = (e->events & POLLER_EDGE ? EV_CLEAR : 0) | (e->events & POLLER_ONESHOT ? EV_ONESHOT : 0);
+    void* udata = (void*)(intptr_t)e->fd;
+    if (op == 'd') {
+        EV_SET(&changes[n++], e->fd, EVFILT_READ, EV_DELETE, 0, 0, udata);
+        EV_SET(&changes[n++], e->fd, EVFILT_WRITE, EV_DELETE, 0, 0, udata);
+        // Either filter may be absent; errors are reported per change and ignored
+        struct kevent results[2];
+        kevent(p->kq, changes, n, results, 2, NULL);
+        return true;
+    }
+    EV_SET(&changes[n++], e->fd, EVFILT_READ, (e->events & POLLER_READ ? EV_ADD | EV_ENABLE | extra : EV_ADD | EV_DISABLE), 0, 0, udata);
+    EV_SET(&changes[n++], e->fd, EVFILT_WRITE, (e->events & POLLER_WRITE ? EV_ADD | EV_ENABLE | extra : EV_ADD | EV_DISABLE), 0, 0, udata);
+    return kevent(p->kq, changes, n, NULL, 0, NULL) == 0;
+#else
+    if (op == 'a') {
+        struct pollfd pfd;
+        pfd.fd = e->fd;
+        pfd.revents = 0;
+        e->index = (int)p->pfds.size();
+        p->pfds.push_back(pfd);
+    } else if (op == 'd') {
+        // Swap-remove, fixing the moved entry's slot
+        struct pollfd last = p->pfds.back();
+        p->pfds[e->index] = last;
+        p->pfds.pop_back();
+        auto it = p->entries.find((int64_t)last.fd);
+        if (it != p->entries.end() && it->second != e) it->second->index = e->index;
+        return true;
+    }
+    short ev = 0;
+    if (e->events & POLLER_READ) ev |= POLLIN;
+    if (e->events & POLLER_WRITE) ev |= POLLOUT;
+    p->pfds[e->index].events = ev;
+    return true;
+#endif
+}
+
+// poller_new() - create a persistent poller, returns a handle (0 on failure)
+MoonValue* moon_poller_new(void) {
+    init_wsa();
+    MoonPoller* p = new MoonPoller();
+#if defined(__linux__)
+    p->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (p->epfd < 0) {
+        delete p;
+        return moon_int(0);
+    }
+#elif defined(__APPLE__)
+    p->kq = kqueue();
+    if (p->kq < 0) {
+        delete p;
+        return moon_int(0);
+    }
+#endif
+#ifdef _WIN32
+    InitializeSRWLock(&p->lock);
+#else
+    pthread_mutex_init(&p->lock, NULL);
+#endif
+    if (!g_key_fd) {
+        g_key_fd = moon_string("fd");
+        g_key_data = moon_string("data");
+        g_key_read = moon_string("read");
+        g_key_write = moon_string("write");
+        g_key_error = moon_string("error");
+    }
+    return moon_int((int64_t)(uintptr_t)p);
+}
+
+// poller_add(poller, fd, events[, data]) - events: "read", "write", "both",
+// plus "edge" / "oneshot". data is handed back with every event.
+MoonValue* moon_poller_add(MoonValue* poller, MoonValue* fd, MoonValue* events, MoonValue* data) {
+    MoonPoller* p = poller_get(poller);
+    if (!p) return moon_bool(false);
+    int64_t key = moon_to_int(fd);
+    if (key < 0) return moon_bool(false);
+
+    poller_lock(p);
+    if (p->entries.count(key)) {
+        poller_unlock(p);
+        return moon_bool(false);
+    }
+    PollerEntry* e = (PollerEntry*)calloc(1, sizeof(PollerEntry));
+    e->fd = (MOON_SOCKET)key;
+    e->events = poller_parse_events(events);
+    p->entries[key] = e;
+    bool ok = poller_ctl(p, e, 'a');
+    if (!ok) {
+        p->entries.erase(key);
+        free(e);
+        poller_unlock(p);
+        return moon_bool(false);
+    }
+    e->event = moon_dict_new();
+    moon_dict_set(e->event, g_key_fd, fd);
+    moon_dict_set(e->event, g_key_data, data ? data : moon_null());
+    moon_dict_set(e->event, g_key_read, moon_bool(false));
+    moon_dict_set(e->event, g_key_write, moon_bool(false));
+    moon_dict_set(e->event, g_key_error, moon_bool(false));
+    poller_unlock(p);
+    return moon_bool(true);
+}
+
+// poller_mod(poller, fd, events[, data]) - change interest (re-arms oneshot)
+MoonValue* moon_poller_mod(MoonValue* poller, MoonValue* fd, MoonValue* events, MoonValue* data) {
+    MoonPoller* p = poller_get(poller);
+    if (!p) return moon_bool(false);
+    poller_lock(p);
+    auto it = p->entries.find(moon_to_int(fd));
+    if (it == p->entries.end()) {
+        poller_unlock(p);
+        return moon_bool(false);
+    }
+    PollerEntry* e = it->second;
+    e->events = poller_parse_events(events);
+    bool ok = poller_ctl(p, e, 'm');
+    if (data && data->type != MOON_NULL) moon_dict_set(e->event, g_key_data, data);
+    poller_unlock(p);
+    return moon_bool(ok);
+}
+
+// poller_del(poller, fd) - stop watching fd (call before closing it)
+MoonValue* moon_poller_del(MoonValue* poller, MoonValue* fd) {
+    MoonPoller* p = poller_get(poller);
+    if (!p) return moon_bool(false);
+    poller_lock(p);
+    auto it = p->entries.find(moon_to_int(fd));
+    if (it == p->entries.end()) {
+        poller_unlock(p);
+        return moon_bool(false);
+    }
+    PollerEntry* e = it->second;
+    poller_ctl(p, e, 'd');
+    p->entries.erase(it);
+    poller_unlock(p);
+    moon_release(e->event);
+    free(e);
+    return moon_bool(true);
+}
+
+// Add one ready fd to the caller's result list (poller lock held)
+static void poller_report(MoonPoller* p, MoonValue* ready, int64_t fd, bool rd, bool wr, bool err) {
+    auto it = p->entries.find(fd);
+    if (it == p->entries.end()) return;     // Removed by another thread
+    PollerEntry* e = it->second;
+    moon_dict_set(e->event, g_key_read, moon_bool(rd));
+    moon_dict_set(e->event, g_key_write, moon_bool(wr));
+    moon_dict_set(e->event, g_key_error, moon_bool(err));
+    moon_release(moon_list_append(ready, e->event));
+#if !defined(__linux__) && !defined(__APPLE__)
+    if (e->events & POLLER_ONESHOT) p->pfds[e->index].events = 0;
+#endif
+}
+
+// Collect up to max events into ready, waiting at most timeout ms; returns
+// how many were found
+static int poller_collect(MoonPoller* p, MoonValue* ready, int max, int timeout) {
+#if defined(__linux__)
+    struct epoll_event events[POLLER_MAX_EVENTS];
+    int n;
+    do {
+        n = epoll_wait(p->epfd, events, max, timeout);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) return 0;
+    poller_lock(p);
+    for (int i = 0; i < n; i++) {
+        uint32_t ev = events[i].events;
+        poller_report(p, ready, events[i].data.fd, (ev & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) != 0,
+                      (ev & EPOLLOUT) != 0, (ev & (EPOLLERR | EPOLLHUP)) != 0);
+    }
+    poller_unlock(p);
+    return n;
+#elif defined(__APPLE__)
+    struct kevent events[POLLER_MAX_EVENTS];
+    struct timespec ts;
+    struct timespec* tsp = NULL;
+    if (timeout >= 0) {
+        ts.tv_sec = timeout / 1000;
+        ts.tv_nsec = (timeout % 1000) * 1000000;
+        tsp = &ts;
+    }
+    int n = kevent(p->kq, NULL, 0, events, max, tsp);
+    if (n <= 0) return 0;
+    poller_lock(p);
+    for (int i = 0; i < n; i++) {
+        bool err = (events[i].flags & (EV_EOF | EV_ERROR)) != 0;
+        poller_report(p, ready, (int64_t)events[i].ident, events[i].filter == EVFILT_READ,
+                      events[i].filter == EVFILT_WRITE, err);
+    }
+    poller_unlock(p);
+    return n;
+#else
+    // Poll a snapshot so other threads may add/del while we wait
+    poller_lock(p);
+    std::vector<struct pollfd> snapshot(p->pfds);
+    poller_unlock(p);
+    if (snapshot.empty()) {
+#ifdef _WIN32
+        if (timeout > 0) Sleep(timeout);
+#else
+        if (timeout > 0) usleep((useconds_t)timeout * 1000);
+#endif
+        return 0;
+    }
+#ifdef _WIN32
+    int n = WSAPoll(snapshot.data(), (ULONG)snapshot.size(), timeout);
+#else
+    int n;
+    do {
+        n = poll(snapshot.data(), (nfds_t)snapshot.size(), timeout);
+    } while (n < 0 && errno == EINTR);
+#endif
+    if (n <= 0) return 0;
+    int found = 0;
+    poller_lock(p);
+    for (size_t i = 0; i < snapshot.size() && found < max; i++) {
+        short rev = snapshot[i].revents;
+        if (!rev) continue;
+        poller_report(p, ready, (int64_t)snapshot[i].fd, (rev & (POLLIN | POLLHUP)) != 0,
+                      (rev & POLLOUT) != 0, (rev & (POLLERR | POLLHUP | POLLNVAL)) != 0);
+        found++;
+    }
+    poller_unlock(p);
+    return found;
+#endif
+}
+
+// poller_wait(poller, timeout_ms[, max]) - wait for readiness and return the
+// ready events in a new list. Inside a coroutine the wait parks until the
+// poller's own descriptor becomes readable.
+MoonValue* moon_poller_wait(MoonValue* poller, MoonValue* timeout_ms, MoonValue* max) {
+    MoonPoller* p = poller_get(poller);
+    if (!p) return moon_list_new();
+
+    MoonValue* ready = moon_list_new();
+    int limit = (max && max->type != MOON_NULL) ? (int)moon_to_int(max) : POLLER_MAX_EVENTS;
+    if (limit <= 0 || limit > POLLER_MAX_EVENTS) limit = POLLER_MAX_EVENTS;
+    int64_t ms = (timeout_ms && timeout_ms->type != MOON_NULL) ? moon_to_int(timeout_ms) : -1;
+
+    if (moon_in_coroutine()) {
+        int64_t deadline = ms < 0 ? -1 : net_now_ms() + ms;
+        while (poller_collect(p, ready, limit, 0) == 0) {
+            int remaining = -1;
+            if (deadline >= 0) {
+                int64_t left = deadline - net_now_ms();
+                if (left <= 0) break;
+                remaining = (int)left;
+            }
+#if defined(__linux__)
+            moon_io_wait(p->epfd, false, remaining);
+#elif defined(__APPLE__)
+            moon_io_wait(p->kq, false, remaining);
+#else
+            // No single descriptor to wait on: poll in short slices so the
+            // worker is not pinned while nothing is ready
+            if (poller_collect(p, ready, limit, remaining < 0 || remaining > 10 ? 10 : remaining) > 0) break;
+            moon_yield();
+#endif
+        }
+    } else {
+        poller_collect(p, ready, limit, ms < 0 ? -1 : (int)ms);
+    }
+
+    return ready;
+}
+
+// poller_close(poller) - release the poller (watched sockets stay open)
+void moon_poller_close(MoonValue* poller) {
+    MoonPoller* p = poller_get(poller);
+    if (!p) return;
+    for (auto& it : p->entries) {
+        moon_release(it.second->event);
+        free(it.second);
+    }
+#if defined(__linux__)
+    close(p->epfd);
+#elif defined(__APPLE__)
+    close(p->kq);
+#endif
+#ifndef _WIN32
+    pthread_mutex_destroy(&p->lock);
+#endif
+    delete p;
+}
+
+#ifndef _WIN32
+// iocp_register / iocp_wait: completion ports are Windows-only; elsewhere
+// they are readiness-based on a shared process-wide poller
+static MoonValue* g_iocp_poller = NULL;
+static pthread_once_t g_iocp_once = PTHREAD_ONCE_INIT;
+
+static void iocp_poller_init() {
+    g_iocp_poller = moon_poller_new();
+}
+
 MoonValue* moon_iocp_register(MoonValue* socket) {
-    (void)socket;
-    // On Linux, use epoll directly via tcp_select which already uses epoll
-    return moon_bool(true);  // Always "succeed" as Linux doesn't need explicit registration
+    pthread_once(&g_iocp_once, iocp_poller_init);
+    MoonValue* events = moon_string("read");
+    MoonValue* ok = moon_poller_add(g_iocp_poller, socket, events, moon_null());
+    moon_release(events);
+    return ok;
 }
 
+// Returns [{socket, bytes}] for ready sockets; bytes is 0 since data has
+// not been read yet
 MoonValue* moon_iocp_wait(MoonValue* timeout_ms) {
-    (void)timeout_ms;
-    // On Linux, use tcp_select with epoll instead
-    return moon_list_new();
+    pthread_once(&g_iocp_once, iocp_poller_init);
+    MoonValue* ready = moon_poller_wait(g_iocp_poller, timeout_ms, moon_null());
+    MoonValue* results = moon_list_new();
+    MoonValue* sockKey = moon_string("socket");
+    MoonValue* bytesKey = moon_string("bytes");
+    MoonList* list = ready->data.listVal;
+    for (int i = 0; i < list->length; i++) {
+        MoonValue* fd = moon_dict_get(list->items[i], g_key_fd, moon_null());
+        MoonValue* event = moon_dict_new();
+        moon_dict_set(event, sockKey, fd);
+        moon_dict_set(event, bytesKey, moon_int(0));
+        moon_release(moon_list_append(results, event));
+        moon_release(event);
+        moon_release(fd);
+    }
+    moon_release(sockKey);
+    moon_release(bytesKey);
+    moon_release(ready);
+    return results;
 }
-
-#endif // _WIN32 or Linux
+#endif
 
 // ============================================================================
 // UDP Functions
@@ -717,24 +2067,30 @@ MoonValue* moon_udp_bind(MoonValue* socket, MoonValue* port) {
     return moon_bool(true);
 }
 
+// Resolve host:port to the IPv4 address used by udp_socket() sockets
+static bool udp_resolve(MoonValue* host, MoonValue* port, struct sockaddr_in* addr) {
+    if (!moon_is_string(host)) return false;
+    DnsResult dns;
+    dns_lookup(host->data.strVal, &dns);
+    for (int i = 0; i < dns.count; i++) {
+        if (dns.addrs[i].ss_family == AF_INET) {
+            memcpy(addr, &dns.addrs[i], sizeof(*addr));
+            addr->sin_port = htons((unsigned short)moon_to_int(port));
+            return true;
+        }
+    }
+    return false;
+}
+
 MoonValue* moon_udp_send(MoonValue* socket, MoonValue* host, MoonValue* port, MoonValue* data) {
     MOON_SOCKET sock = (MOON_SOCKET)moon_to_int(socket);
     
     struct sockaddr_in addr;
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons((unsigned short)moon_to_int(port));
-    
-    if (moon_is_string(host)) {
-        struct hostent* he = gethostbyname(host->data.strVal);
-        if (!he) return moon_int(-1);
-        memcpy(&addr.sin_addr, he->h_addr, he->h_length);
-    } else {
-        return moon_int(-1);
-    }
+    if (!udp_resolve(host, port, &addr)) return moon_int(-1);
     
     char* str = moon_to_string(data);
     int sent = sendto(sock, str, (int)strlen(str), 0, (struct sockaddr*)&addr, sizeof(addr));
-    free(str);
+    moon_free(str, 0);
     return moon_int(sent);
 }
 
@@ -759,6 +2115,306 @@ MoonValue* moon_udp_recv(MoonValue* socket) {
     return result;
 }
 
+// ============================================================================
+// Batched UDP (sendmmsg / recvmmsg, optional GSO / GRO on Linux)
+// ============================================================================
+
+#define UDP_BATCH_MAX 1024
+#define UDP_GSO_MAX_SEGMENTS 64
+#define UDP_GSO_MAX_BYTES 65000
+
+#ifdef __linux__
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#endif
+
+#ifdef __linux__
+// Send count packets as one UDP_SEGMENT super-datagram. Every packet
+// but the last must be the same size. Returns false if the kernel or NIC
+// refuses GSO, so the caller can fall back to sendmmsg.
+static bool udp_send_gso(MOON_SOCKET sock, struct sockaddr_in* addr, struct iovec* iov, int count) {
+    char control[CMSG_SPACE(sizeof(uint16_t))];
+    memset(control, 0, sizeof(control));
+    
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = addr;
+    msg.msg_namelen = sizeof(*addr);
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    
+    struct cmsghdr* cm = CMSG_FIRSTHDR(&msg);
+    cm->cmsg_level = SOL_UDP;
+    cm->cmsg_type = UDP_SEGMENT;
+    cm->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    uint16_t segSize = (uint16_t)iov[0].iov_len;
+    memcpy(CMSG_DATA(cm), &segSize, sizeof(segSize));
+    
+    return sendmsg(sock, &msg, 0) >= 0;
+}
+#endif
+
+// udp_send_batch(sock, host, port, packets[, gso]) - send a list of
+// datagrams to one destination with sendmmsg (one syscall per 64 packets).
+// With gso=true, runs of equal-sized packets go out as UDP_SEGMENT
+// super-datagrams. Returns the number of packets sent.
+MoonValue* moon_udp_send_batch(MoonValue* socket, MoonValue* host, MoonValue* port,
+                               MoonValue* packets, MoonValue* gso) {
+    MOON_SOCKET sock = (MOON_SOCKET)moon_to_int(socket);
+    if (!moon_is_list(packets)) return moon_int(0);
+    
+    struct sockaddr_in addr;
+    if (!udp_resolve(host, port, &addr)) return moon_int(-1);
+    
+    MoonList* list = packets->data.listVal;
+    bool useGso = gso && moon_to_bool(gso);
+    int sentCount = 0;
+    int idx = 0;
+    
+    while (idx < list->length) {
+        int n = list->length - idx;
+        if (n > NET_IOV_BATCH) n = NET_IOV_BATCH;
+        
+        char* toFree[NET_IOV_BATCH];
+        size_t lens[NET_IOV_BATCH];
+        const char* bufs[NET_IOV_BATCH];
+        for (int i = 0; i < n; i++) {
+            bufs[i] = net_bytes(list->items[idx + i], &lens[i], &toFree[i]);
+        }
+        
+        int done = 0;
+#ifdef __linux__
+        struct iovec iov[NET_IOV_BATCH];
+        for (int i = 0; i < n; i++) {
+            iov[i].iov_base = (void*)bufs[i];
+            iov[i].iov_len = lens[i];
+        }
+        
+        while (useGso && done < n) {
+            // Longest run of equal-sized packets (the last may be shorter)
+            size_t seg = lens[done];
+            size_t bytes = 0;
+            int run = 0;
+            while (done + run < n && run < UDP_GSO_MAX_SEGMENTS && seg > 0 &&
+                   bytes + lens[done + run] <= UDP_GSO_MAX_BYTES && lens[done + run] <= seg) {
+                bytes += lens[done + run];
+                run++;
+                if (lens[done + run - 1] < seg) break;
+            }
+            if (run < 2) break;
+            if (!udp_send_gso(sock, &addr, &iov[done], run)) {
+                useGso = false;  // No GSO here: plain sendmmsg from now on
+                break;
+            }
+            done += run;
+            sentCount += run;
+        }
+        
+        struct mmsghdr msgs[NET_IOV_BATCH];
+        int base = done;
+        memset(msgs, 0, sizeof(msgs));
+        for (int i = base; i < n; i++) {
+            struct msghdr* m = &msgs[i - base].msg_hdr;
+            m->msg_name = &addr;
+            m->msg_namelen = sizeof(addr);
+            m->msg_iov = &iov[i];
+            m->msg_iovlen = 1;
+        }
+        while (done < n) {
+            int r = sendmmsg(sock, &msgs[done - base], n - done, 0);
+            if (r < 0 && errno == EINTR) continue;
+            if (r <= 0) break;
+            done += r;
+            sentCount += r;
+        }
+#else
+        for (; done < n; done++) {
+            if (sendto(sock, bufs[done], (int)lens[done], 0, (struct sockaddr*)&addr, sizeof(addr)) < 0) break;
+            sentCount++;
+        }
+#endif
+        for (int i = 0; i < n; i++) moon_free(toFree[i], 0);
+        if (done < n) break;
+        idx += n;
+    }
+    return moon_int(sentCount);
+}
+
+#ifdef _WIN32
+static __declspec(thread) char* t_udp_scratch = NULL;
+static __declspec(thread) size_t t_udp_scratch_size = 0;
+#else
+static __thread char* t_udp_scratch = NULL;
+static __thread size_t t_udp_scratch_size = 0;
+#endif
+
+static char* udp_scratch(size_t size) {
+    if (size > t_udp_scratch_size) {
+        char* grown = (char*)realloc(t_udp_scratch, size);
+        if (!grown) return NULL;
+        t_udp_scratch = grown;
+        t_udp_scratch_size = size;
+    }
+    return t_udp_scratch;
+}
+
+// Append a source address, reusing the previous string when consecutive
+// packets come from the same peer (the common telemetry case)
+static void udp_batch_add_source(MoonValue* addrs, MoonValue* ports, struct sockaddr_in* from,
+                                 struct sockaddr_in* last, MoonValue** lastAddr) {
+    if (!*lastAddr || from->sin_addr.s_addr != last->sin_addr.s_addr) {
+        char addrBuf[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &from->sin_addr, addrBuf, sizeof(addrBuf));
+        if (*lastAddr) moon_release(*lastAddr);
+        *lastAddr = moon_string(addrBuf);
+        *last = *from;
+    }
+    moon_list_append(addrs, *lastAddr);
+    MoonValue* p = moon_int(ntohs(from->sin_port));
+    moon_list_append(ports, p);
+    moon_release(p);
+}
+
+// udp_recv_batch(sock, max_packets[, gro]) - block for the first datagram,
+// then take whatever else is queued (up to max_packets) in one recvmmsg.
+// Returns a packed result instead of a dict per packet:
+//   {"data": all payloads concatenated, "sizes": [len...],
+//    "addresses": [ip...], "ports": [port...]}
+// With gro=true, UDP_GRO is enabled and coalesced segments are split back
+// into individual sizes.
+MoonValue* moon_udp_recv_batch(MoonValue* socket, MoonValue* max_packets, MoonValue* gro) {
+    MOON_SOCKET sock = (MOON_SOCKET)moon_to_int(socket);
+    int maxPackets = (int)moon_to_int(max_packets);
+    if (maxPackets <= 0) maxPackets = 64;
+    if (maxPackets > UDP_BATCH_MAX) maxPackets = UDP_BATCH_MAX;
+    bool useGro = gro && moon_to_bool(gro);
+    
+    // Receive into per-thread scratch slots, compact in place, and copy only
+    // the bytes actually received into the result string
+    size_t slot = useGro ? 65536 : 4096;
+    char* data = udp_scratch(slot * maxPackets);
+    if (!data) return moon_dict_new();
+    size_t packed = 0;
+    
+    MoonValue* sizes = moon_list_new();
+    MoonValue* addrs = moon_list_new();
+    MoonValue* ports = moon_list_new();
+    MoonValue* lastAddr = NULL;
+    struct sockaddr_in last;
+    memset(&last, 0, sizeof(last));
+    
+#ifdef __linux__
+    if (useGro) {
+        int on = 1;
+        setsockopt(sock, SOL_UDP, UDP_GRO, &on, sizeof(on));
+    }
+    
+    struct mmsghdr* msgs = (struct mmsghdr*)calloc(maxPackets, sizeof(struct mmsghdr));
+    struct iovec* iov = (struct iovec*)calloc(maxPackets, sizeof(struct iovec));
+    struct sockaddr_in* from = (struct sockaddr_in*)calloc(maxPackets, sizeof(struct sockaddr_in));
+    size_t ctrlSize = CMSG_SPACE(sizeof(int));
+    char* control = useGro ? (char*)calloc(maxPackets, ctrlSize) : NULL;
+    
+    for (int i = 0; i < maxPackets; i++) {
+        iov[i].iov_base = data + slot * i;
+        iov[i].iov_len = slot;
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_name = &from[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(from[i]);
+        if (control) {
+            msgs[i].msg_hdr.msg_control = control + ctrlSize * i;
+            msgs[i].msg_hdr.msg_controllen = ctrlSize;
+        }
+    }
+    
+    int got;
+    do {
+        got = recvmmsg(sock, msgs, maxPackets, MSG_WAITFORONE, NULL);
+    } while (got < 0 && errno == EINTR);
+    
+    for (int i = 0; i < got; i++) {
+        size_t len = msgs[i].msg_len;
+        int segSize = 0;
+        if (control) {
+            for (struct cmsghdr* cm = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cm; cm = CMSG_NXTHDR(&msgs[i].msg_hdr, cm)) {
+                if (cm->cmsg_level == SOL_UDP && cm->cmsg_type == UDP_GRO) {
+                    memcpy(&segSize, CMSG_DATA(cm), sizeof(segSize));
+                }
+            }
+        }
+        if (packed != slot * i) memmove(data + packed, data + slot * i, len);
+        packed += len;
+        
+        // A GRO super-datagram carries several equal-sized segments
+        size_t seg = segSize > 0 ? (size_t)segSize : len;
+        for (size_t off = 0; off < len || (len == 0 && off == 0); off += seg) {
+            size_t piece = len - off < seg ? len - off : seg;
+            MoonValue* s = moon_int((int64_t)piece);
+            moon_list_append(sizes, s);
+            moon_release(s);
+            udp_batch_add_source(addrs, ports, &from[i], &last, &lastAddr);
+            if (seg == 0) break;
+        }
+    }
+    
+    free(msgs);
+    free(iov);
+    free(from);
+    free(control);
+#else
+    for (int i = 0; i < maxPackets; i++) {
+        if (i > 0) {
+            // Only take datagrams that are already queued
+#ifdef _WIN32
+            WSAPOLLFD pfd;
+            pfd.fd = sock;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if (WSAPoll(&pfd, 1, 0) <= 0) break;
+#else
+            struct pollfd pfd;
+            pfd.fd = sock;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if (poll(&pfd, 1, 0) <= 0) break;
+#endif
+        }
+        struct sockaddr_in from;
+        socklen_t fromLen = sizeof(from);
+        int len = recvfrom(sock, data + packed, (int)slot, 0, (struct sockaddr*)&from, &fromLen);
+        if (len < 0) break;
+        packed += len;
+        MoonValue* s = moon_int(len);
+        moon_list_append(sizes, s);
+        moon_release(s);
+        udp_batch_add_source(addrs, ports, &from, &last, &lastAddr);
+    }
+#endif
+    if (lastAddr) moon_release(lastAddr);
+    
+    MoonValue* result = moon_dict_new();
+    MoonValue* keys[4] = {moon_string("data"), moon_string("sizes"), moon_string("addresses"), moon_string("ports")};
+    char* packedStr = moon_str_buffer(packed);
+    memcpy(packedStr, data, packed);
+    MoonValue* vals[4] = {moon_str_finish(packedStr, packed), sizes, addrs, ports};
+    for (int i = 0; i < 4; i++) {
+        moon_dict_set(result, keys[i], vals[i]);
+        moon_release(keys[i]);
+        moon_release(vals[i]);
+    }
+    return result;
+}
+
 void moon_udp_close(MoonValue* socket) {
     MOON_SOCKET sock = (MOON_SOCKET)moon_to_int(socket);
     closesocket(sock);
@@ -768,10 +2424,13 @@ void moon_udp_close(MoonValue* socket) {
 
 // Stub implementations when network is disabled
 MoonValue* moon_tcp_connect(MoonValue* host, MoonValue* port) { return moon_int(-1); }
-MoonValue* moon_tcp_listen(MoonValue* port) { return moon_int(-1); }
+MoonValue* moon_tcp_listen(MoonValue* port, MoonValue* options) { return moon_int(-1); }
+MoonValue* moon_tcp_listen_group(MoonValue* port, MoonValue* options) { return moon_list_new(); }
 MoonValue* moon_tcp_accept(MoonValue* server) { return moon_int(-1); }
+MoonValue* moon_tcp_accept_batch(MoonValue* server, MoonValue* max) { return moon_list_new(); }
 MoonValue* moon_tcp_send(MoonValue* socket, MoonValue* data) { return moon_int(-1); }
-MoonValue* moon_tcp_recv(MoonValue* socket) { return moon_string(""); }
+MoonValue* moon_tcp_sendv(MoonValue* socket, MoonValue* parts) { return moon_int(-1); }
+MoonValue* moon_tcp_recv(MoonValue* socket, MoonValue* max) { return moon_string(""); }
 void moon_tcp_close(MoonValue* socket) { }
 MoonValue* moon_tcp_set_nonblocking(MoonValue* socket, MoonValue* nb) { return moon_bool(false); }
 MoonValue* moon_tcp_has_data(MoonValue* socket) { return moon_bool(false); }
@@ -780,10 +2439,28 @@ MoonValue* moon_tcp_accept_nonblocking(MoonValue* server) { return moon_null();
 MoonValue* moon_tcp_recv_nonblocking(MoonValue* socket) { return moon_string(""); }
 MoonValue* moon_iocp_register(MoonValue* socket) { return moon_bool(false); }
 MoonValue* moon_iocp_wait(MoonValue* timeout_ms) { return moon_list_new(); }
+MoonValue* moon_poller_new(void) { return moon_int(0); }
+MoonValue* moon_poller_add(MoonValue* poller, MoonValue* fd, MoonValue* events, MoonValue* data) { return moon_bool(false); }
+MoonValue* moon_poller_mod(MoonValue* poller, MoonValue* fd, MoonValue* events, MoonValue* data) { return moon_bool(false); }
+MoonValue* moon_poller_del(MoonValue* poller, MoonValue* fd) { return moon_bool(false); }
+MoonValue* moon_poller_wait(MoonValue* poller, MoonValue* timeout_ms, MoonValue* max) { return moon_list_new(); }
+void moon_poller_close(MoonValue* poller) { }
 MoonValue* moon_udp_socket(void) { return moon_int(-1); }
 MoonValue* moon_udp_bind(MoonValue* socket, MoonValue* port) { return moon_bool(false); }
 MoonValue* moon_udp_send(MoonValue* sock, MoonValue* host, MoonValue* port, MoonValue* data) { return moon_int(-1); }
 MoonValue* moon_udp_recv(MoonValue* socket) { return moon_dict_new(); }
+MoonValue* moon_udp_send_batch(MoonValue* socket, MoonValue* host, MoonValue* port, MoonValue* packets, MoonValue* gso) { return moon_int(-1); }
+MoonValue* moon_udp_recv_batch(MoonValue* socket, MoonValue* max_packets, MoonValue* gro) { return moon_dict_new(); }
 void moon_udp_close(MoonValue* socket) { }
+MoonValue* moon_dns_resolve(MoonValue* host) { return moon_list_new(); }
+void moon_dns_config(MoonValue* options) { }
+void moon_dns_clear(void) { }
+int64_t moon_net_connect(const char* host, int port, int timeout_ms) { return -1; }
+MoonValue* moon_reader_wrap(MoonReadFn fn, void* src) { return moon_null(); }
+MoonValue* moon_tcp_reader(MoonValue* socket) { return moon_null(); }
+MoonValue* moon_recv_exact(MoonValue* reader, MoonValue* count) { return moon_null(); }
+MoonValue* moon_recv_until(MoonValue* reader, MoonValue* delim, MoonValue* max) { return moon_null(); }
+void moon_reader_close(MoonValue* reader) { }
+MoonValue* moon_tcp_send_file(MoonValue* socket, MoonValue* path) { return moon_int(-1); }
 
 #endif // MOON_HAS_NETWORK
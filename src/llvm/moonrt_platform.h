@@ -294,6 +294,16 @@
     #define MOON_HAS_FFI 1
 #endif
 
+// Allocation accounting (per-kind live/peak counters for mem_stats)
+#ifndef MOON_NO_MEM_STATS
+    #define MOON_HAS_MEM_STATS 1
+#endif
+
+// Allocation site sampling and periodic dumps (MOON_MEM_SAMPLE / MOON_MEM_DUMP)
+#if defined(MOON_HAS_MEM_STATS) && !defined(MOON_TARGET_MCU)
+    #define MOON_HAS_MEM_PROFILE 1
+#endif
+
 // ============================================================================
 // MCU/embedded memory config
 // ============================================================================
@@ -318,6 +328,9 @@
     #ifndef MOON_INT_STR_CACHE_SIZE
         #define MOON_INT_STR_CACHE_SIZE 1000  // Small int string cache
     #endif
+    #ifndef MOON_DICT_INITIAL_CAPACITY
+        #define MOON_DICT_INITIAL_CAPACITY 16  // Slots in a new dict (power of 2)
+    #endif
 #else
     // Defaults for standard mode
     #ifndef MOON_POOL_SIZE
@@ -332,6 +345,9 @@
     #ifndef MOON_INT_STR_CACHE_SIZE
         #define MOON_INT_STR_CACHE_SIZE 100000
     #endif
+    #ifndef MOON_DICT_INITIAL_CAPACITY
+        #define MOON_DICT_INITIAL_CAPACITY 256
+    #endif
 #endif
 
 // Small-int cache count
@@ -344,6 +360,9 @@
 #ifdef MOON_STATIC_ALLOC
     // Use statically allocated heap (no malloc)
     #define MOON_USE_STATIC_HEAP 1
+    #ifndef MOON_HEAP_VALUE_CACHE
+        #define MOON_HEAP_VALUE_CACHE 32  // Freed MoonValue blocks kept for reuse (0 = off)
+    #endif
 #endif
 
 #endif // MOONRT_PLATFORM_H
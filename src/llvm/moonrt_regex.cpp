@@ -53,6 +53,11 @@ static const char* get_string(MoonValue* val) {
     return val->data.strVal;
 }
 
+// Helper: Get the subject bytes of a string or buffer (binary-safe length)
+static const char* get_subject(MoonValue* val, size_t* len) {
+    return moon_bytes_view(val, len);
+}
+
 // Helper: Compile a regex pattern
 static pcre2_code* compile_pattern(const char* pattern, int* errorcode, PCRE2_SIZE* erroroffset) {
     uint32_t options = PCRE2_UTF | PCRE2_UCP;
@@ -73,7 +78,8 @@ static pcre2_code* compile_pattern(const char* pattern, int* errorcode, PCRE2_SI
 extern "C" MoonValue* moon_regex_match(MoonValue* str, MoonValue* pattern) {
     clear_regex_error();
     
-    const char* s = get_string(str);
+    size_t slen = 0;
+    const char* s = get_subject(str, &slen);
     const char* p = get_string(pattern);
     
     if (!s || !p) {
@@ -93,13 +99,13 @@ extern "C" MoonValue* moon_regex_match(MoonValue* str, MoonValue* pattern) {
     pcre2_match_data* match_data = pcre2_match_data_create_from_pattern(re, NULL);
     
     // Use PCRE2_ANCHORED to match from start, and check if we matched the whole string
-    int rc = pcre2_match(re, (PCRE2_SPTR)s, strlen(s), 0, PCRE2_ANCHORED, match_data, NULL);
+    int rc = pcre2_match(re, (PCRE2_SPTR)s, slen, 0, PCRE2_ANCHORED, match_data, NULL);
     
     bool result = false;
     if (rc >= 0) {
         // Check if the match covers the entire string
         PCRE2_SIZE* ovector = pcre2_get_ovector_pointer(match_data);
-        result = (ovector[0] == 0 && ovector[1] == strlen(s));
+        result = (ovector[0] == 0 && ovector[1] == slen);
     }
     
     pcre2_match_data_free(match_data);
@@ -111,7 +117,8 @@ extern "C" MoonValue* moon_regex_match(MoonValue* str, MoonValue* pattern) {
 extern "C" MoonValue* moon_regex_search(MoonValue* str, MoonValue* pattern) {
     clear_regex_error();
     
-    const char* s = get_string(str);
+    size_t slen = 0;
+    const char* s = get_subject(str, &slen);
     const char* p = get_string(pattern);
     
     if (!s || !p) {
@@ -129,7 +136,7 @@ extern "C" MoonValue* moon_regex_search(MoonValue* str, MoonValue* pattern) {
     }
     
     pcre2_match_data* match_data = pcre2_match_data_create_from_pattern(re, NULL);
-    int rc = pcre2_match(re, (PCRE2_SPTR)s, strlen(s), 0, 0, match_data, NULL);
+    int rc = pcre2_match(re, (PCRE2_SPTR)s, slen, 0, 0, match_data, NULL);
     
     MoonValue* result = moon_null();
     if (rc >= 0) {
@@ -151,7 +158,8 @@ extern "C" MoonValue* moon_regex_search(MoonValue* str, MoonValue* pattern) {
 extern "C" MoonValue* moon_regex_test(MoonValue* str, MoonValue* pattern) {
     clear_regex_error();
     
-    const char* s = get_string(str);
+    size_t slen = 0;
+    const char* s = get_subject(str, &slen);
     const char* p = get_string(pattern);
     
     if (!s || !p) {
@@ -169,7 +177,7 @@ extern "C" MoonValue* moon_regex_test(MoonValue* str, MoonValue* pattern) {
     }
     
     pcre2_match_data* match_data = pcre2_match_data_create_from_pattern(re, NULL);
-    int rc = pcre2_match(re, (PCRE2_SPTR)s, strlen(s), 0, 0, match_data, NULL);
+    int rc = pcre2_match(re, (PCRE2_SPTR)s, slen, 0, 0, match_data, NULL);
     
     bool result = (rc >= 0);
     
@@ -186,7 +194,8 @@ extern "C" MoonValue* moon_regex_test(MoonValue* str, MoonValue* pattern) {
 extern "C" MoonValue* moon_regex_groups(MoonValue* str, MoonValue* pattern) {
     clear_regex_error();
     
-    const char* s = get_string(str);
+    size_t slen = 0;
+    const char* s = get_subject(str, &slen);
     const char* p = get_string(pattern);
     
     if (!s || !p) {
@@ -204,7 +213,7 @@ extern "C" MoonValue* moon_regex_groups(MoonValue* str, MoonValue* pattern) {
     }
     
     pcre2_match_data* match_data = pcre2_match_data_create_from_pattern(re, NULL);
-    int rc = pcre2_match(re, (PCRE2_SPTR)s, strlen(s), 0, 0, match_data, NULL);
+    int rc = pcre2_match(re, (PCRE2_SPTR)s, slen, 0, 0, match_data, NULL);
     
     MoonValue* result = moon_list_new();
     
@@ -239,7 +248,8 @@ extern "C" MoonValue* moon_regex_groups(MoonValue* str, MoonValue* pattern) {
 extern "C" MoonValue* moon_regex_named(MoonValue* str, MoonValue* pattern) {
     clear_regex_error();
     
-    const char* s = get_string(str);
+    size_t slen = 0;
+    const char* s = get_subject(str, &slen);
     const char* p = get_string(pattern);
     
     if (!s || !p) {
@@ -257,7 +267,7 @@ extern "C" MoonValue* moon_regex_named(MoonValue* str, MoonValue* pattern) {
     }
     
     pcre2_match_data* match_data = pcre2_match_data_create_from_pattern(re, NULL);
-    int rc = pcre2_match(re, (PCRE2_SPTR)s, strlen(s), 0, 0, match_data, NULL);
+    int rc = pcre2_match(re, (PCRE2_SPTR)s, slen, 0, 0, match_data, NULL);
     
     MoonValue* result = moon_dict_new();
     
@@ -340,7 +350,8 @@ extern "C" MoonValue* moon_regex_named(MoonValue* str, MoonValue* pattern) {
 extern "C" MoonValue* moon_regex_find_all(MoonValue* str, MoonValue* pattern) {
     clear_regex_error();
     
-    const char* s = get_string(str);
+    size_t slen = 0;
+    const char* s = get_subject(str, &slen);
     const char* p = get_string(pattern);
     
     if (!s || !p) {
@@ -360,7 +371,7 @@ extern "C" MoonValue* moon_regex_find_all(MoonValue* str, MoonValue* pattern) {
     MoonValue* result = moon_list_new();
     pcre2_match_data* match_data = pcre2_match_data_create_from_pattern(re, NULL);
     
-    PCRE2_SIZE subject_length = strlen(s);
+    PCRE2_SIZE subject_length = slen;
     PCRE2_SIZE offset = 0;
     
     while (offset < subject_length) {
@@ -395,7 +406,8 @@ extern "C" MoonValue* moon_regex_find_all(MoonValue* str, MoonValue* pattern) {
 extern "C" MoonValue* moon_regex_find_all_groups(MoonValue* str, MoonValue* pattern) {
     clear_regex_error();
     
-    const char* s = get_string(str);
+    size_t slen = 0;
+    const char* s = get_subject(str, &slen);
     const char* p = get_string(pattern);
     
     if (!s || !p) {
@@ -415,7 +427,7 @@ extern "C" MoonValue* moon_regex_find_all_groups(MoonValue* str, MoonValue* patt
     MoonValue* result = moon_list_new();
     pcre2_match_data* match_data = pcre2_match_data_create_from_pattern(re, NULL);
     
-    PCRE2_SIZE subject_length = strlen(s);
+    PCRE2_SIZE subject_length = slen;
     PCRE2_SIZE offset = 0;
     
     while (offset < subject_length) {
@@ -465,7 +477,8 @@ extern "C" MoonValue* moon_regex_find_all_groups(MoonValue* str, MoonValue* patt
 extern "C" MoonValue* moon_regex_replace(MoonValue* str, MoonValue* pattern, MoonValue* replacement) {
     clear_regex_error();
     
-    const char* s = get_string(str);
+    size_t slen = 0;
+    const char* s = get_subject(str, &slen);
     const char* p = get_string(pattern);
     const char* r = get_string(replacement);
     
@@ -485,13 +498,13 @@ extern "C" MoonValue* moon_regex_replace(MoonValue* str, MoonValue* pattern, Moo
     }
     
     // Use pcre2_substitute for replacement
-    PCRE2_SIZE outlength = strlen(s) * 2 + strlen(r) + 1;
+    PCRE2_SIZE outlength = slen * 2 + strlen(r) + 1;
     PCRE2_UCHAR* output = (PCRE2_UCHAR*)malloc(outlength);
     
     int rc = pcre2_substitute(
         re,
         (PCRE2_SPTR)s,
-        PCRE2_ZERO_TERMINATED,
+        slen,
         0,
         PCRE2_SUBSTITUTE_OVERFLOW_LENGTH,  // First match only
         NULL,
@@ -508,7 +521,7 @@ extern "C" MoonValue* moon_regex_replace(MoonValue* str, MoonValue* pattern, Moo
         rc = pcre2_substitute(
             re,
             (PCRE2_SPTR)s,
-            PCRE2_ZERO_TERMINATED,
+            slen,
             0,
             0,
             NULL,
@@ -537,7 +550,8 @@ extern "C" MoonValue* moon_regex_replace(MoonValue* str, MoonValue* pattern, Moo
 extern "C" MoonValue* moon_regex_replace_all(MoonValue* str, MoonValue* pattern, MoonValue* replacement) {
     clear_regex_error();
     
-    const char* s = get_string(str);
+    size_t slen = 0;
+    const char* s = get_subject(str, &slen);
     const char* p = get_string(pattern);
     const char* r = get_string(replacement);
     
@@ -556,13 +570,13 @@ extern "C" MoonValue* moon_regex_replace_all(MoonValue* str, MoonValue* pattern,
         return str;
     }
     
-    PCRE2_SIZE outlength = strlen(s) * 2 + strlen(r) * 10 + 1;
+    PCRE2_SIZE outlength = slen * 2 + strlen(r) * 10 + 1;
     PCRE2_UCHAR* output = (PCRE2_UCHAR*)malloc(outlength);
     
     int rc = pcre2_substitute(
         re,
         (PCRE2_SPTR)s,
-        PCRE2_ZERO_TERMINATED,
+        slen,
         0,
         PCRE2_SUBSTITUTE_GLOBAL | PCRE2_SUBSTITUTE_OVERFLOW_LENGTH,
         NULL,
@@ -579,7 +593,7 @@ extern "C" MoonValue* moon_regex_replace_all(MoonValue* str, MoonValue* pattern,
         rc = pcre2_substitute(
             re,
             (PCRE2_SPTR)s,
-            PCRE2_ZERO_TERMINATED,
+            slen,
             0,
             PCRE2_SUBSTITUTE_GLOBAL,
             NULL,
@@ -612,7 +626,8 @@ extern "C" MoonValue* moon_regex_replace_all(MoonValue* str, MoonValue* pattern,
 extern "C" MoonValue* moon_regex_split(MoonValue* str, MoonValue* pattern) {
     clear_regex_error();
     
-    const char* s = get_string(str);
+    size_t slen = 0;
+    const char* s = get_subject(str, &slen);
     const char* p = get_string(pattern);
     
     if (!s || !p) {
@@ -632,7 +647,7 @@ extern "C" MoonValue* moon_regex_split(MoonValue* str, MoonValue* pattern) {
     MoonValue* result = moon_list_new();
     pcre2_match_data* match_data = pcre2_match_data_create_from_pattern(re, NULL);
     
-    PCRE2_SIZE subject_length = strlen(s);
+    PCRE2_SIZE subject_length = slen;
     PCRE2_SIZE last_end = 0;
     PCRE2_SIZE offset = 0;
     
@@ -685,7 +700,8 @@ extern "C" MoonValue* moon_regex_split_n(MoonValue* str, MoonValue* pattern, Moo
     
     clear_regex_error();
     
-    const char* s = get_string(str);
+    size_t slen = 0;
+    const char* s = get_subject(str, &slen);
     const char* p = get_string(pattern);
     
     if (!s || !p) {
@@ -705,7 +721,7 @@ extern "C" MoonValue* moon_regex_split_n(MoonValue* str, MoonValue* pattern, Moo
     MoonValue* result = moon_list_new();
     pcre2_match_data* match_data = pcre2_match_data_create_from_pattern(re, NULL);
     
-    PCRE2_SIZE subject_length = strlen(s);
+    PCRE2_SIZE subject_length = slen;
     PCRE2_SIZE last_end = 0;
     PCRE2_SIZE offset = 0;
     int64_t count = 0;
@@ -805,7 +821,8 @@ extern "C" MoonValue* moon_regex_match_compiled(MoonValue* compiled, MoonValue*
     clear_regex_error();
     
     CompiledRegex* cr = get_compiled_regex(compiled);
-    const char* s = get_string(str);
+    size_t slen = 0;
+    const char* s = get_subject(str, &slen);
     
     if (!cr || !s) {
         set_regex_error("Invalid arguments");
@@ -813,12 +830,12 @@ extern "C" MoonValue* moon_regex_match_compiled(MoonValue* compiled, MoonValue*
     }
     
     pcre2_match_data* match_data = pcre2_match_data_create_from_pattern(cr->re, NULL);
-    int rc = pcre2_match(cr->re, (PCRE2_SPTR)s, strlen(s), 0, PCRE2_ANCHORED, match_data, NULL);
+    int rc = pcre2_match(cr->re, (PCRE2_SPTR)s, slen, 0, PCRE2_ANCHORED, match_data, NULL);
     
     bool result = false;
     if (rc >= 0) {
         PCRE2_SIZE* ovector = pcre2_get_ovector_pointer(match_data);
-        result = (ovector[0] == 0 && ovector[1] == strlen(s));
+        result = (ovector[0] == 0 && ovector[1] == slen);
     }
     
     pcre2_match_data_free(match_data);
@@ -829,7 +846,8 @@ extern "C" MoonValue* moon_regex_search_compiled(MoonValue* compiled, MoonValue*
     clear_regex_error();
     
     CompiledRegex* cr = get_compiled_regex(compiled);
-    const char* s = get_string(str);
+    size_t slen = 0;
+    const char* s = get_subject(str, &slen);
     
     if (!cr || !s) {
         set_regex_error("Invalid arguments");
@@ -837,7 +855,7 @@ extern "C" MoonValue* moon_regex_search_compiled(MoonValue* compiled, MoonValue*
     }
     
     pcre2_match_data* match_data = pcre2_match_data_create_from_pattern(cr->re, NULL);
-    int rc = pcre2_match(cr->re, (PCRE2_SPTR)s, strlen(s), 0, 0, match_data, NULL);
+    int rc = pcre2_match(cr->re, (PCRE2_SPTR)s, slen, 0, 0, match_data, NULL);
     
     MoonValue* result = moon_null();
     if (rc >= 0) {
@@ -858,7 +876,8 @@ extern "C" MoonValue* moon_regex_find_all_compiled(MoonValue* compiled, MoonValu
     clear_regex_error();
     
     CompiledRegex* cr = get_compiled_regex(compiled);
-    const char* s = get_string(str);
+    size_t slen = 0;
+    const char* s = get_subject(str, &slen);
     
     if (!cr || !s) {
         set_regex_error("Invalid arguments");
@@ -868,7 +887,7 @@ extern "C" MoonValue* moon_regex_find_all_compiled(MoonValue* compiled, MoonValu
     MoonValue* result = moon_list_new();
     pcre2_match_data* match_data = pcre2_match_data_create_from_pattern(cr->re, NULL);
     
-    PCRE2_SIZE subject_length = strlen(s);
+    PCRE2_SIZE subject_length = slen;
     PCRE2_SIZE offset = 0;
     
     while (offset < subject_length) {
@@ -901,7 +920,8 @@ extern "C" MoonValue* moon_regex_replace_compiled(MoonValue* compiled, MoonValue
     clear_regex_error();
     
     CompiledRegex* cr = get_compiled_regex(compiled);
-    const char* s = get_string(str);
+    size_t slen = 0;
+    const char* s = get_subject(str, &slen);
     const char* r = get_string(replacement);
     
     if (!cr || !s || !r) {
@@ -909,13 +929,13 @@ extern "C" MoonValue* moon_regex_replace_compiled(MoonValue* compiled, MoonValue
         return str ? (moon_retain(str), str) : moon_string("");
     }
     
-    PCRE2_SIZE outlength = strlen(s) * 2 + strlen(r) * 10 + 1;
+    PCRE2_SIZE outlength = slen * 2 + strlen(r) * 10 + 1;
     PCRE2_UCHAR* output = (PCRE2_UCHAR*)malloc(outlength);
     
     int rc = pcre2_substitute(
         cr->re,
         (PCRE2_SPTR)s,
-        PCRE2_ZERO_TERMINATED,
+        slen,
         0,
         PCRE2_SUBSTITUTE_GLOBAL | PCRE2_SUBSTITUTE_OVERFLOW_LENGTH,
         NULL,
@@ -932,7 +952,7 @@ extern "C" MoonValue* moon_regex_replace_compiled(MoonValue* compiled, MoonValue
         rc = pcre2_substitute(
             cr->re,
             (PCRE2_SPTR)s,
-            PCRE2_ZERO_TERMINATED,
+            slen,
             0,
             PCRE2_SUBSTITUTE_GLOBAL,
             NULL,
@@ -970,22 +990,22 @@ extern "C" void moon_regex_free(MoonValue* compiled) {
 // ============================================================================
 
 extern "C" MoonValue* moon_regex_escape(MoonValue* str) {
-    const char* s = get_string(str);
+    size_t slen = 0;
+    const char* s = get_subject(str, &slen);
     if (!s) {
         return moon_string("");
     }
     
     std::string result;
-    result.reserve(strlen(s) * 2);
+    result.reserve(slen * 2);
     
     const char* special = "\\^$.|?*+()[]{}";
     
-    while (*s) {
-        if (strchr(special, *s)) {
+    for (size_t i = 0; i < slen; i++) {
+        if (s[i] && strchr(special, s[i])) {
             result += '\\';
         }
-        result += *s;
-        ++s;
+        result += s[i];
     }
     
     return moon_string(result.c_str());
@@ -1022,6 +1042,9 @@ static void clear_regex_error() {
 }
 
 static const char* get_string(MoonValue* val) {
+    if (val && val->type == MOON_BUFFER && val->data.bufferVal->terminated) {
+        return val->data.bufferVal->data;
+    }
     if (!val || val->type != MOON_STRING) return nullptr;
     return val->data.strVal;
 }
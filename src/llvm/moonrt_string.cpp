@@ -5,11 +5,19 @@
 
 #include "moonrt_core.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
 // ============================================================================
 // String Operations
 // ============================================================================
 
-MoonValue* moon_str_concat(MoonValue* a, MoonValue* b) {
+// extendA: the caller owns the only other reference to 'a' and replaces it with the
+// result, so a's buffer may be extended in place (see moon_add_assign)
+static MoonValue* str_concat(MoonValue* a, MoonValue* b, bool extendA) {
     const char* strA;
     const char* strB;
     bool freeA = false, freeB = false;
@@ -46,7 +54,7 @@ MoonValue* moon_str_concat(MoonValue* a, MoonValue* b) {
     
     // Super fast path: empty string concatenation
     if (lenA == 0) {
-        if (freeA) free((void*)strA);
+        if (freeA) moon_free((void*)strA, 0);
         if (b && b->type == MOON_STRING) {
             if (freeB) {
                 return moon_string_owned((char*)strB);
@@ -57,7 +65,7 @@ MoonValue* moon_str_concat(MoonValue* a, MoonValue* b) {
         return moon_string_owned((char*)strB);
     }
     if (lenB == 0) {
-        if (freeB) free((void*)strB);
+        if (freeB) moon_free((void*)strB, 0);
         if (a && a->type == MOON_STRING) {
             if (freeA) {
                 return moon_string_owned((char*)strA);
@@ -68,27 +76,21 @@ MoonValue* moon_str_concat(MoonValue* a, MoonValue* b) {
         return moon_string_owned((char*)strA);
     }
     
-    // Optimization: if 'a' is a string with capacity that we can modify, extend in place
-    // Allow refcount <= 2 because in "s = s + x" pattern:
-    //   - refcount 1: the variable storage (global/local alloca)
-    //   - refcount 2: the temporary from loadVariable (which will be released after assignment)
-    // This is safe because the caller is about to overwrite the storage with the result.
-    // We DON'T modify interned strings (refcount == INT32_MAX) or strings shared by closures (refcount > 2)
-    if (a && a->type == MOON_STRING && a->refcount <= 2 && a->refcount > 0 && 
-        a->data.strVal && headerA) {
+    // s = s + x: append to a's buffer, growing it geometrically so repeated appends stay linear
+    if (extendA && a && a->type == MOON_STRING && a->data.strVal && headerA) {
         if (totalLen <= headerA->capacity) {
             memcpy(a->data.strVal + lenA, strB, lenB + 1);
             headerA->length = totalLen;
             headerA->hashValid = false;
-            if (freeA) free((void*)strA);
-            if (freeB) free((void*)strB);
+            if (freeA) moon_free((void*)strA, 0);
+            if (freeB) moon_free((void*)strB, 0);
             moon_retain(a);
             return a;
         }
         
         // Need more capacity - grow the string
         size_t newCapacity = totalLen < 64 ? 128 : totalLen * 2;
-        MoonStrHeader* newHeader = (MoonStrHeader*)realloc(headerA, sizeof(MoonStrHeader) + newCapacity + 1);
+        MoonStrHeader* newHeader = (MoonStrHeader*)moon_realloc_typed(MOON_MEM_STRING, headerA, sizeof(MoonStrHeader) + newCapacity + 1);
         if (newHeader) {
             newHeader->capacity = newCapacity;
             newHeader->length = totalLen;
@@ -96,7 +98,7 @@ MoonValue* moon_str_concat(MoonValue* a, MoonValue* b) {
             char* newStr = (char*)(newHeader + 1);
             memcpy(newStr + lenA, strB, lenB + 1);
             a->data.strVal = newStr;
-            if (freeB) free((void*)strB);
+            if (freeB) moon_free((void*)strB, 0);
             moon_retain(a);
             return a;
         }
@@ -113,8 +115,8 @@ MoonValue* moon_str_concat(MoonValue* a, MoonValue* b) {
         
         MoonValue* interned = moon_string_intern(tempBuf, totalLen, hash);
         if (interned) {
-            if (freeA) free((void*)strA);
-            if (freeB) free((void*)strB);
+            if (freeA) moon_free((void*)strA, 0);
+            if (freeB) moon_free((void*)strB, 0);
             return interned;
         }
     }
@@ -140,11 +142,19 @@ MoonValue* moon_str_concat(MoonValue* a, MoonValue* b) {
     MoonStrHeader* newHeader = moon_str_get_header(result);
     if (newHeader) newHeader->length = totalLen;
     
-    if (freeA) free((void*)strA);
-    if (freeB) free((void*)strB);
+    if (freeA) moon_free((void*)strA, 0);
+    if (freeB) moon_free((void*)strB, 0);
     return moon_string_owned(result);
 }
 
+MoonValue* moon_str_concat(MoonValue* a, MoonValue* b) {
+    return str_concat(a, b, false);
+}
+
+MoonValue* moon_str_append(MoonValue* a, MoonValue* b) {
+    return str_concat(a, b, true);
+}
+
 MoonValue* moon_str_len(MoonValue* str) {
     if (!moon_is_string(str)) return moon_int(0);
     MoonStrHeader* header = moon_str_get_header(str->data.strVal);
@@ -197,7 +207,7 @@ MoonValue* moon_str_split(MoonValue* str, MoonValue* delim) {
         
         MoonList* lst = result->data.listVal;
         lst->capacity = (int32_t)slen;
-        lst->items = (MoonValue**)realloc(lst->items, sizeof(MoonValue*) * slen);
+        lst->items = (MoonValue**)moon_realloc_typed(MOON_MEM_LIST, lst->items, sizeof(MoonValue*) * slen);
         
         for (size_t i = 0; i < slen; i++) {
             char c[2] = {s[i], '\0'};
@@ -223,7 +233,7 @@ MoonValue* moon_str_split(MoonValue* str, MoonValue* delim) {
         MoonList* lst = result->data.listVal;
         if (count > lst->capacity) {
             lst->capacity = count;
-            lst->items = (MoonValue**)realloc(lst->items, sizeof(MoonValue*) * count);
+            lst->items = (MoonValue**)moon_realloc_typed(MOON_MEM_LIST, lst->items, sizeof(MoonValue*) * count);
         }
         
         // Process each part - use string interning for short strings
@@ -242,7 +252,7 @@ MoonValue* moon_str_split(MoonValue* str, MoonValue* delim) {
             
             if (!part) {
                 // Create new string
-                MoonValue* v = (MoonValue*)moon_alloc(sizeof(MoonValue));
+                MoonValue* v = moon_pool_alloc();
                 v->type = MOON_STRING;
                 v->refcount = 1;
                 v->data.strVal = moon_str_with_capacity(start, len, len);
@@ -262,7 +272,7 @@ MoonValue* moon_str_split(MoonValue* str, MoonValue* delim) {
         }
         
         if (!lastPart) {
-            MoonValue* v = (MoonValue*)moon_alloc(sizeof(MoonValue));
+            MoonValue* v = moon_pool_alloc();
             v->type = MOON_STRING;
             v->refcount = 1;
             v->data.strVal = moon_str_with_capacity(start, lastLen, lastLen);
@@ -285,7 +295,7 @@ MoonValue* moon_str_split(MoonValue* str, MoonValue* delim) {
     MoonValue* result = moon_list_new();
     MoonList* lst = result->data.listVal;
     lst->capacity = count;
-    lst->items = (MoonValue**)realloc(lst->items, sizeof(MoonValue*) * count);
+    lst->items = (MoonValue**)moon_realloc_typed(MOON_MEM_LIST, lst->items, sizeof(MoonValue*) * count);
     
     const char* start = s;
     const char* found;
@@ -326,9 +336,9 @@ MoonValue* moon_str_join(MoonValue* list, MoonValue* delim) {
     for (int32_t i = 0; i < lst->length; i++) {
         if (i > 0) strcat(result, d);
         strcat(result, parts[i]);
-        free(parts[i]);
+        moon_free(parts[i], 0);
     }
-    free(parts);
+    moon_free(parts, 0);
     
     return moon_string_owned(result);
 }
@@ -467,7 +477,7 @@ MoonValue* moon_chr(MoonValue* code) {
     if (c < 0 || c > 255) c = 0;
     
     // Allocate header + string memory directly
-    MoonStrHeader* header = (MoonStrHeader*)moon_alloc(sizeof(MoonStrHeader) + 2);
+    MoonStrHeader* header = (MoonStrHeader*)moon_alloc_typed(MOON_MEM_STRING, sizeof(MoonStrHeader) + 2);
     header->magic = MOON_STR_MAGIC;
     header->capacity = 1;
     header->length = 1;  // Always 1 even if char is \\0
@@ -668,7 +678,7 @@ MoonValue* moon_bytes_to_string(MoonValue* list) {
     if (len == 0) return moon_string("");
     
     // Allocate header + string memory directly
-    MoonStrHeader* header = (MoonStrHeader*)moon_alloc(sizeof(MoonStrHeader) + len + 1);
+    MoonStrHeader* header = (MoonStrHeader*)moon_alloc_typed(MOON_MEM_STRING, sizeof(MoonStrHeader) + len + 1);
     header->magic = MOON_STR_MAGIC;
     header->capacity = len;
     header->length = len;
@@ -687,6 +697,121 @@ MoonValue* moon_bytes_to_string(MoonValue* list) {
     return moon_string_owned(buf);
 }
 
+// ============================================================================
+// Buffers (zero-copy byte views)
+// ============================================================================
+// A buffer shares bytes with a string, a parent buffer or C memory. Runtime
+// functions that take binary data read it through moon_bytes_view, so a
+// buffer can be passed wherever a string's bytes are consumed.
+
+static void buffer_free_libc(void* base) {
+    free(base);
+}
+
+// buffer_from_ptr(ptr, len, release): release is null/false (memory stays
+// owned by C), true (free() it) or the address of a C void fn(void*)
+MoonValue* moon_buffer_from_ptr(MoonValue* ptr, MoonValue* len, MoonValue* release) {
+    char* data = (char*)(uintptr_t)moon_to_int(ptr);
+    int64_t n = moon_to_int(len);
+    if (!data || n < 0) return moon_null();
+    
+    void (*releaseFn)(void*) = NULL;
+    if (release && release->type == MOON_BOOL) {
+        releaseFn = release->data.boolVal ? buffer_free_libc : NULL;
+    } else if (moon_is_int(release) && release->data.intVal) {
+        releaseFn = (void (*)(void*))(uintptr_t)release->data.intVal;
+    }
+    return moon_buffer_new(data, (size_t)n, NULL, releaseFn, data);
+}
+
+MoonValue* moon_buffer_from_str(MoonValue* str) {
+    if (moon_is_buffer(str)) {
+        moon_retain(str);
+        return str;
+    }
+    size_t len;
+    const char* data = moon_bytes_view(str, &len);
+    if (!data) return moon_null();
+    return moon_buffer_new(data, len, str, NULL, NULL);
+}
+
+// buffer_slice(buf, start, len?): view of len bytes (default: to the end)
+MoonValue* moon_buffer_slice(MoonValue* buf, MoonValue* start, MoonValue* len) {
+    size_t total;
+    const char* data = moon_bytes_view(buf, &total);
+    if (!data) return moon_null();
+    
+    int64_t from = moon_to_int(start);
+    if (from < 0) from += (int64_t)total;
+    if (from < 0) from = 0;
+    if ((size_t)from > total) from = (int64_t)total;
+    
+    size_t n = total - (size_t)from;
+    if (len && !moon_is_null(len)) {
+        int64_t want = moon_to_int(len);
+        if (want < 0) want = 0;
+        if ((size_t)want < n) n = (size_t)want;
+    }
+    
+    // Slices of slices point straight at the bytes' owner
+    MoonValue* owner = buf;
+    if (buf->type == MOON_BUFFER && buf->data.bufferVal->owner) {
+        owner = buf->data.bufferVal->owner;
+    }
+    return moon_buffer_new(data + from, n, owner, NULL, NULL);
+}
+
+MoonValue* moon_buffer_ptr(MoonValue* buf) {
+    size_t len;
+    const char* data = moon_bytes_view(buf, &len);
+    return moon_int((int64_t)(uintptr_t)data);
+}
+
+MoonValue* moon_buffer_to_str(MoonValue* buf) {
+    size_t len;
+    const char* data = moon_bytes_view(buf, &len);
+    if (!data) return moon_string("");
+    return moon_string_owned(moon_str_with_capacity(data, len, len));
+}
+
+// ============================================================================
+// WebSocket masking
+// ============================================================================
+
+// XOR data with the 4-byte mask key, starting at payload position offset
+// (so a payload can be unmasked in pieces). 32/16 bytes per step with
+// AVX2/SSE2, 8 with a plain word otherwise.
+void moon_ws_mask(char* data, size_t len, const unsigned char key[4], size_t offset) {
+    unsigned char k[4];
+    for (int i = 0; i < 4; i++) k[i] = key[(offset + i) & 3];
+    uint32_t k32;
+    memcpy(&k32, k, 4);
+    uint64_t k64 = ((uint64_t)k32 << 32) | k32;
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    __m256i vk = _mm256_set1_epi32((int)k32);
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+        _mm256_storeu_si256((__m256i*)(data + i), _mm256_xor_si256(v, vk));
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    __m128i vk16 = _mm_set1_epi32((int)k32);
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+        _mm_storeu_si128((__m128i*)(data + i), _mm_xor_si128(v, vk16));
+    }
+#endif
+    for (; i + 8 <= len; i += 8) {
+        uint64_t w;
+        memcpy(&w, data + i, 8);
+        w ^= k64;
+        memcpy(data + i, &w, 8);
+    }
+    for (; i < len; i++) data[i] ^= (char)k[i & 3];
+}
+
 // ============================================================================
 // WebSocket frame parse (efficient C++ impl, avoids many temporaries)
 // ============================================================================
@@ -738,7 +863,7 @@ MoonValue* moon_ws_parse_frame(MoonValue* data) {
     if (dataLen < totalFrameLen) return moon_null();
     
     // Decode payload
-    MoonStrHeader* payloadHeader = (MoonStrHeader*)moon_alloc(sizeof(MoonStrHeader) + payloadLen + 1);
+    MoonStrHeader* payloadHeader = (MoonStrHeader*)moon_alloc_typed(MOON_MEM_STRING, sizeof(MoonStrHeader) + payloadLen + 1);
     payloadHeader->magic = MOON_STR_MAGIC;
     payloadHeader->capacity = payloadLen;
     payloadHeader->length = payloadLen;
@@ -746,12 +871,9 @@ MoonValue* moon_ws_parse_frame(MoonValue* data) {
     payloadHeader->hashValid = false;
     
     char* payloadBuf = (char*)(payloadHeader + 1);
-    for (size_t i = 0; i < payloadLen; i++) {
-        unsigned char b = (unsigned char)buf[offset + i];
-        if (masked) {
-            b ^= maskKey[i % 4];
-        }
-        payloadBuf[i] = (char)b;
+    memcpy(payloadBuf, buf + offset, payloadLen);
+    if (masked) {
+        moon_ws_mask(payloadBuf, payloadLen, maskKey, 0);
     }
     payloadBuf[payloadLen] = '\0';
     
@@ -791,7 +913,7 @@ MoonValue* moon_ws_create_frame(MoonValue* data, MoonValue* opcodeVal, MoonValue
     }
     
     // Allocate frame buffer
-    MoonStrHeader* frameHeader = (MoonStrHeader*)moon_alloc(sizeof(MoonStrHeader) + frameSize + 1);
+    MoonStrHeader* frameHeader = (MoonStrHeader*)moon_alloc_typed(MOON_MEM_STRING, sizeof(MoonStrHeader) + frameSize + 1);
     frameHeader->magic = MOON_STR_MAGIC;
     frameHeader->capacity = frameSize;
     frameHeader->length = frameSize;
@@ -826,13 +948,10 @@ MoonValue* moon_ws_create_frame(MoonValue* data, MoonValue* opcodeVal, MoonValue
             maskKey[i] = (unsigned char)(rand() & 0xFF);
             frame[offset++] = (char)maskKey[i];
         }
-        for (size_t i = 0; i < payloadLen; i++) {
-            frame[offset++] = (char)((unsigned char)payload[i] ^ maskKey[i % 4]);
-        }
+        memcpy(frame + offset, payload, payloadLen);
+        moon_ws_mask(frame + offset, payloadLen, maskKey, 0);
     } else {
-        for (size_t i = 0; i < payloadLen; i++) {
-            frame[offset++] = payload[i];
-        }
+        memcpy(frame + offset, payload, payloadLen);
     }
     
     frame[frameSize] = '\0';
@@ -31,6 +31,7 @@
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <unistd.h>
+#include <fcntl.h>
 #define MOON_SOCKET int
 #define INVALID_SOCKET_VAL -1
 #define closesocket_impl close
@@ -38,6 +39,8 @@
 
 #include <string.h>
 #include <stdlib.h>
+#include <string>
+#include <unordered_map>
 
 // ============================================================================
 // Global State
@@ -45,6 +48,36 @@
 
 static bool g_tls_initialized = false;
 
+// Shared client SSL_CTX: trust roots are loaded once and every outbound
+// connection takes a reference instead of building its own context.
+static SSL_CTX* g_tls_client_ctx = NULL;
+
+// Client session cache for resumption (host:port -> latest session/ticket)
+#define TLS_SESSION_CACHE_MAX 1024
+static std::unordered_map<std::string, SSL_SESSION*> g_tls_sessions;
+
+// Keep-alive pool (host:port -> idle connections linked through pool_next)
+static std::unordered_map<std::string, MoonTlsContext*> g_tls_pool;
+static int g_tls_pool_max_idle = 8;             // Per host
+static int64_t g_tls_pool_idle_timeout = 30000; // ms
+
+// Statistics (reported by tls_pool_stats)
+static int64_t g_tls_stat_handshakes = 0;
+static int64_t g_tls_stat_resumed = 0;
+static int64_t g_tls_stat_pool_hits = 0;
+static int64_t g_tls_stat_pool_misses = 0;
+
+// Lock for the shared context, session cache and pool
+#ifdef _WIN32
+static SRWLOCK g_tls_lock = SRWLOCK_INIT;
+#define tls_lock() AcquireSRWLockExclusive(&g_tls_lock)
+#define tls_unlock() ReleaseSRWLockExclusive(&g_tls_lock)
+#else
+static pthread_mutex_t g_tls_lock = PTHREAD_MUTEX_INITIALIZER;
+#define tls_lock() pthread_mutex_lock(&g_tls_lock)
+#define tls_unlock() pthread_mutex_unlock(&g_tls_lock)
+#endif
+
 // ============================================================================
 // TLS Initialization/Cleanup
 // ============================================================================
@@ -69,6 +102,15 @@ void moon_tls_init(void) {
 void moon_tls_cleanup(void) {
     if (!g_tls_initialized) return;
     
+    moon_tls_pool_clear();
+    
+    tls_lock();
+    if (g_tls_client_ctx) {
+        SSL_CTX_free(g_tls_client_ctx);
+        g_tls_client_ctx = NULL;
+    }
+    tls_unlock();
+    
     // Cleanup OpenSSL
     EVP_cleanup();
     ERR_free_strings();
@@ -120,94 +162,137 @@ static const char* get_ssl_error_string(void) {
     return ERR_error_string(err, NULL);
 }
 
-// ============================================================================
-// TLS Client Connection
-// ============================================================================
+static int64_t tls_now_ms(void) {
+#ifdef _WIN32
+    return (int64_t)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
 
-MoonValue* moon_tls_connect(MoonValue* host, MoonValue* port) {
-    moon_tls_init();
-    
-    if (!moon_is_string(host)) {
-        return moon_null();
+static std::string tls_host_key(const char* hostname, int port) {
+    std::string key(hostname);
+    key += ':';
+    key += std::to_string(port);
+    return key;
+}
+
+static void tls_dict_set_int(MoonValue* dict, const char* key, int64_t value) {
+    MoonValue* k = moon_string(key);
+    MoonValue* v = moon_int(value);
+    moon_dict_set(dict, k, v);
+    moon_release(k);
+    moon_release(v);
+}
+
+// Load the platform trust store into a client context
+static void tls_load_system_roots(SSL_CTX* sslctx) {
+#ifdef _WIN32
+    X509_STORE* store = SSL_CTX_get_cert_store(sslctx);
+    if (store) {
+        HCERTSTORE hStore = CertOpenSystemStoreA(0, "ROOT");
+        if (hStore) {
+            PCCERT_CONTEXT pContext = NULL;
+            while ((pContext = CertEnumCertificatesInStore(hStore, pContext)) != NULL) {
+                X509* x509 = d2i_X509(NULL, (const unsigned char**)&pContext->pbCertEncoded, 
+                                       pContext->cbCertEncoded);
+                if (x509) {
+                    X509_STORE_add_cert(store, x509);
+                    X509_free(x509);
+                }
+            }
+            CertCloseStore(hStore, 0);
+        }
     }
-    
-    const char* hostname = host->data.strVal;
-    int portnum = (int)moon_to_int(port);
-    
-    // Create socket
-    MOON_SOCKET sock = socket(AF_INET, SOCK_STREAM, 0);
-    if (sock == INVALID_SOCKET_VAL) {
-        return moon_null();
+#endif
+    SSL_CTX_set_default_verify_paths(sslctx);
+}
+
+// Called by OpenSSL whenever the server issues a session (TLS 1.2 session ID
+// or TLS 1.3 ticket). The newest session per host:port is kept for resumption.
+static int tls_new_session_cb(SSL* ssl, SSL_SESSION* sess) {
+    MoonTlsContext* ctx = (MoonTlsContext*)SSL_get_app_data(ssl);
+    if (!ctx || !ctx->hostname) return 0;
+    
+    std::string key = tls_host_key(ctx->hostname, ctx->port);
+    
+    tls_lock();
+    auto it = g_tls_sessions.find(key);
+    if (it != g_tls_sessions.end()) {
+        SSL_SESSION_free(it->second);
+        it->second = sess;
+    } else {
+        if (g_tls_sessions.size() >= TLS_SESSION_CACHE_MAX) {
+            auto victim = g_tls_sessions.begin();
+            SSL_SESSION_free(victim->second);
+            g_tls_sessions.erase(victim);
+        }
+        g_tls_sessions[key] = sess;
     }
+    tls_unlock();
     
-    // Resolve hostname
-    struct hostent* he = gethostbyname(hostname);
-    if (!he) {
-        closesocket_impl(sock);
-        return moon_null();
+    return 1;  // We keep the reference
+}
+
+// Get a reference to the shared client context (created on first use)
+static SSL_CTX* tls_client_ctx(void) {
+    tls_lock();
+    if (!g_tls_client_ctx) {
+        SSL_CTX* sslctx = SSL_CTX_new(TLS_client_method());
+        if (sslctx) {
+            tls_load_system_roots(sslctx);
+            SSL_CTX_set_verify(sslctx, SSL_VERIFY_PEER, NULL);
+            // External session cache keyed by host:port (see tls_new_session_cb)
+            SSL_CTX_set_session_cache_mode(sslctx,
+                SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+            SSL_CTX_sess_set_new_cb(sslctx, tls_new_session_cb);
+        }
+        g_tls_client_ctx = sslctx;
     }
-    
-    // Connect
-    struct sockaddr_in addr;
-    memset(&addr, 0, sizeof(addr));
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons((unsigned short)portnum);
-    memcpy(&addr.sin_addr, he->h_addr, he->h_length);
-    
-    if (connect(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
-        closesocket_impl(sock);
-        return moon_null();
+    SSL_CTX* sslctx = g_tls_client_ctx;
+    if (sslctx) SSL_CTX_up_ref(sslctx);
+    tls_unlock();
+    return sslctx;
+}
+
+// Connect to host:port and perform a client handshake, resuming a cached
+// session when one is available. Returns NULL on failure.
+static MoonTlsContext* tls_client_connect(const char* hostname, int portnum) {
+    // Resolve (cached) and connect, racing IPv6/IPv4 addresses
+    int64_t fd = moon_net_connect(hostname, portnum, 0);
+    if (fd < 0) {
+        return NULL;
     }
+    MOON_SOCKET sock = (MOON_SOCKET)fd;
     
     // Create TLS context
     MoonTlsContext* ctx = create_tls_context();
     if (!ctx) {
         closesocket_impl(sock);
-        return moon_null();
+        return NULL;
     }
     
     ctx->socket_fd = (int)sock;
     ctx->is_server = false;
     ctx->hostname = strdup(hostname);
+    ctx->port = portnum;
     
-    // Create SSL context with TLS client method
-    ctx->ctx = SSL_CTX_new(TLS_client_method());
+    // Shared client context (verifies peer by default)
+    ctx->ctx = tls_client_ctx();
     if (!ctx->ctx) {
         free_tls_context(ctx);
-        return moon_null();
+        return NULL;
     }
     
-    // Load Windows certificate store for verification
-#ifdef _WIN32
-    // Try to load from Windows certificate store
-    X509_STORE* store = SSL_CTX_get_cert_store(ctx->ctx);
-    if (store) {
-        HCERTSTORE hStore = CertOpenSystemStoreA(0, "ROOT");
-        if (hStore) {
-            PCCERT_CONTEXT pContext = NULL;
-            while ((pContext = CertEnumCertificatesInStore(hStore, pContext)) != NULL) {
-                X509* x509 = d2i_X509(NULL, (const unsigned char**)&pContext->pbCertEncoded, 
-                                       pContext->cbCertEncoded);
-                if (x509) {
-                    X509_STORE_add_cert(store, x509);
-                    X509_free(x509);
-                }
-            }
-            CertCloseStore(hStore, 0);
-        }
-    }
-#endif
-    
-    // Set reasonable defaults - verify peer certificate
-    SSL_CTX_set_verify(ctx->ctx, SSL_VERIFY_PEER, NULL);
-    SSL_CTX_set_default_verify_paths(ctx->ctx);
-    
     // Create SSL connection
     ctx->ssl = SSL_new(ctx->ctx);
     if (!ctx->ssl) {
         free_tls_context(ctx);
-        return moon_null();
+        return NULL;
     }
+    SSL_set_app_data(ctx->ssl, ctx);
     
     // Set SNI hostname
     SSL_set_tlsext_host_name(ctx->ssl, hostname);
@@ -218,20 +303,60 @@ MoonValue* moon_tls_connect(MoonValue* host, MoonValue* port) {
     // Attach socket
     SSL_set_fd(ctx->ssl, (int)sock);
     
+    // Offer the cached session for an abbreviated handshake
+    std::string key = tls_host_key(hostname, portnum);
+    tls_lock();
+    auto it = g_tls_sessions.find(key);
+    if (it != g_tls_sessions.end()) {
+        SSL_set_session(ctx->ssl, it->second);
+    }
+    tls_unlock();
+    
     // Perform TLS handshake
     int ret = SSL_connect(ctx->ssl);
     if (ret != 1) {
-        int err = SSL_get_error(ctx->ssl, ret);
-        // For debugging: fprintf(stderr, "TLS handshake failed: %d - %s\n", err, get_ssl_error_string());
+        // For debugging: fprintf(stderr, "TLS handshake failed: %s\n", get_ssl_error_string());
+        // Forget the session in case it is what the server rejected
+        tls_lock();
+        it = g_tls_sessions.find(key);
+        if (it != g_tls_sessions.end()) {
+            SSL_SESSION_free(it->second);
+            g_tls_sessions.erase(it);
+        }
+        tls_unlock();
         free_tls_context(ctx);
-        return moon_null();
+        return NULL;
     }
     
     ctx->connected = true;
     
+    tls_lock();
+    g_tls_stat_handshakes++;
+    if (SSL_session_reused(ctx->ssl)) g_tls_stat_resumed++;
+    tls_unlock();
+    
     // Get peer certificate
     ctx->peer_cert = SSL_get_peer_certificate(ctx->ssl);
     
+    return ctx;
+}
+
+// ============================================================================
+// TLS Client Connection
+// ============================================================================
+
+MoonValue* moon_tls_connect(MoonValue* host, MoonValue* port) {
+    moon_tls_init();
+    
+    if (!moon_is_string(host)) {
+        return moon_null();
+    }
+    
+    MoonTlsContext* ctx = tls_client_connect(host->data.strVal, (int)moon_to_int(port));
+    if (!ctx) {
+        return moon_null();
+    }
+    
     // Return as integer (pointer value)
     return moon_int((int64_t)(uintptr_t)ctx);
 }
@@ -396,29 +521,20 @@ MoonValue* moon_tls_send(MoonValue* conn, MoonValue* data) {
         return moon_int(-1);
     }
     
-    // For string type, use its actual length (supports binary data)
-    int len = 0;
-    const char* str = NULL;
+    // Strings and buffers are sent as-is (binary-safe)
+    size_t len = 0;
     char* toFree = NULL;
-    
-    if (data && data->type == MOON_STRING && data->data.strVal) {
-        str = data->data.strVal;
-        MoonStrHeader* header = moon_str_get_header(data->data.strVal);
-        if (header) {
-            len = (int)header->length;
-        } else {
-            len = (int)strlen(str);
-        }
-    } else {
+    const char* str = moon_bytes_view(data, &len);
+    if (!str) {
         toFree = moon_to_string(data);
         str = toFree;
-        len = (int)strlen(str);
+        len = strlen(str);
     }
     
-    int sent = SSL_write(ctx->ssl, str, len);
+    int sent = SSL_write(ctx->ssl, str, (int)len);
     
     if (toFree) {
-        free(toFree);
+        moon_free(toFree, 0);
     }
     
     if (sent <= 0) {
@@ -428,14 +544,19 @@ MoonValue* moon_tls_send(MoonValue* conn, MoonValue* data) {
     return moon_int(sent);
 }
 
-MoonValue* moon_tls_recv(MoonValue* conn) {
+// tls_recv(conn) or tls_recv(conn, max) - one SSL_read of up to max bytes
+// (default 16KB, one TLS record) directly into the result string
+MoonValue* moon_tls_recv(MoonValue* conn, MoonValue* max) {
     MoonTlsContext* ctx = (MoonTlsContext*)(uintptr_t)moon_to_int(conn);
     if (!ctx || !ctx->ssl || !ctx->connected) {
         return moon_string("");
     }
     
-    char buffer[8192];
-    int received = SSL_read(ctx->ssl, buffer, sizeof(buffer) - 1);
+    int cap = (max && max->type != MOON_NULL) ? (int)moon_to_int(max) : 16384;
+    if (cap <= 0) cap = 16384;
+    
+    char* buffer = moon_str_buffer((size_t)cap);
+    int received = SSL_read(ctx->ssl, buffer, cap);
     
     if (received <= 0) {
         int err = SSL_get_error(ctx->ssl, received);
@@ -443,11 +564,10 @@ MoonValue* moon_tls_recv(MoonValue* conn) {
             // Connection closed cleanly
             ctx->connected = false;
         }
-        return moon_string("");
+        received = 0;
     }
     
-    buffer[received] = '\0';
-    return moon_string(buffer);
+    return moon_str_finish(buffer, (size_t)received);
 }
 
 MoonValue* moon_tls_recv_all(MoonValue* conn, MoonValue* max_size) {
@@ -459,12 +579,21 @@ MoonValue* moon_tls_recv_all(MoonValue* conn, MoonValue* max_size) {
     int max_bytes = (int)moon_to_int(max_size);
     if (max_bytes <= 0) max_bytes = 1024 * 1024; // 1MB default
     
-    char* buffer = (char*)malloc(max_bytes + 1);
-    if (!buffer) return moon_string("");
+    // Start at one TLS record and grow geometrically, rather than reserving
+    // max_bytes up front for what is usually a small response
+    size_t cap = max_bytes < 16384 ? (size_t)max_bytes : 16384;
+    char* buffer = moon_str_buffer(cap);
     
     int total = 0;
     while (total < max_bytes) {
-        int received = SSL_read(ctx->ssl, buffer + total, max_bytes - total);
+        if ((size_t)total == cap) {
+            size_t grow = cap * 2 > (size_t)max_bytes ? (size_t)max_bytes : cap * 2;
+            char* grown = moon_str_reserve(buffer, grow);
+            if (!grown) break;
+            buffer = grown;
+            cap = grow;
+        }
+        int received = SSL_read(ctx->ssl, buffer + total, (int)(cap - total));
         if (received <= 0) break;
         total += received;
         
@@ -473,11 +602,52 @@ MoonValue* moon_tls_recv_all(MoonValue* conn, MoonValue* max_size) {
         if (pending <= 0) break;
     }
     
-    buffer[total] = '\0';
-    MoonValue* result = moon_string(buffer);
-    free(buffer);
-    
-    return result;
+    return moon_str_finish(buffer, (size_t)total);
+}
+
+static int tls_read_fn(void* src, char* buf, int len) {
+    MoonTlsContext* ctx = (MoonTlsContext*)src;
+    if (!ctx->ssl || !ctx->connected) return -1;
+    int n = SSL_read(ctx->ssl, buf, len);
+    if (n <= 0 && SSL_get_error(ctx->ssl, n) == SSL_ERROR_ZERO_RETURN) {
+        ctx->connected = false;
+        return 0;
+    }
+    return n;
+}
+
+int moon_tls_conn_fd(void* conn) {
+    MoonTlsContext* ctx = (MoonTlsContext*)conn;
+    return ctx ? ctx->socket_fd : -1;
+}
+
+int moon_tls_conn_pending(void* conn) {
+    MoonTlsContext* ctx = (MoonTlsContext*)conn;
+    return (ctx && ctx->ssl) ? SSL_pending(ctx->ssl) : 0;
+}
+
+int moon_tls_conn_read(void* conn, char* buf, int len) {
+    return tls_read_fn(conn, buf, len);
+}
+
+// Write all of buf; returns len, or -1 on error
+int moon_tls_conn_write(void* conn, const char* buf, int len) {
+    MoonTlsContext* ctx = (MoonTlsContext*)conn;
+    if (!ctx || !ctx->ssl || !ctx->connected) return -1;
+    int done = 0;
+    while (done < len) {
+        int n = SSL_write(ctx->ssl, buf + done, len - done);
+        if (n <= 0) return -1;
+        done += n;
+    }
+    return len;
+}
+
+// tls_reader(conn) - buffered reader for recv_exact / recv_until
+MoonValue* moon_tls_reader(MoonValue* conn) {
+    MoonTlsContext* ctx = (MoonTlsContext*)(uintptr_t)moon_to_int(conn);
+    if (!ctx || !ctx->ssl) return moon_null();
+    return moon_reader_wrap(tls_read_fn, ctx);
 }
 
 // ============================================================================
@@ -511,7 +681,12 @@ MoonValue* moon_tls_set_verify(MoonValue* conn, MoonValue* mode) {
         }
     }
     
-    SSL_CTX_set_verify(ctx->ctx, verify_mode, NULL);
+    // Client connections share one SSL_CTX, so configure the connection itself
+    if (ctx->ssl) {
+        SSL_set_verify(ctx->ssl, verify_mode, NULL);
+    } else {
+        SSL_CTX_set_verify(ctx->ctx, verify_mode, NULL);
+    }
     ctx->verify_mode = (strcmp(mode_str, "required") == 0) ? MOON_TLS_VERIFY_REQUIRED :
                        (strcmp(mode_str, "peer") == 0) ? MOON_TLS_VERIFY_PEER : 
                        MOON_TLS_VERIFY_NONE;
@@ -673,15 +848,16 @@ MoonValue* moon_tls_load_ca(MoonValue* path) {
         return moon_bool(false);
     }
     
-    // This would need to be applied to a specific SSL_CTX
-    // For now, just verify the file exists and is readable
-    FILE* fp = fopen(path->data.strVal, "r");
-    if (!fp) {
+    // Add the CA bundle to the shared client context used by tls_connect
+    SSL_CTX* sslctx = tls_client_ctx();
+    if (!sslctx) {
         return moon_bool(false);
     }
-    fclose(fp);
     
-    return moon_bool(true);
+    int ok = SSL_CTX_load_verify_locations(sslctx, path->data.strVal, NULL);
+    SSL_CTX_free(sslctx);
+    
+    return moon_bool(ok == 1);
 }
 
 MoonValue* moon_tls_cert_info(MoonValue* cert) {
@@ -725,14 +901,12 @@ MoonValue* moon_tls_wrap_client(MoonValue* socket) {
     ctx->socket_fd = sock;
     ctx->is_server = false;
     
-    ctx->ctx = SSL_CTX_new(TLS_client_method());
+    ctx->ctx = tls_client_ctx();
     if (!ctx->ctx) {
         free(ctx);  // Don't close socket - it was passed in
         return moon_null();
     }
     
-    SSL_CTX_set_default_verify_paths(ctx->ctx);
-    
     ctx->ssl = SSL_new(ctx->ctx);
     if (!ctx->ssl) {
         SSL_CTX_free(ctx->ctx);
@@ -740,6 +914,8 @@ MoonValue* moon_tls_wrap_client(MoonValue* socket) {
         return moon_null();
     }
     
+    // Wrapped sockets have no hostname to check, so keep verification off
+    SSL_set_verify(ctx->ssl, SSL_VERIFY_NONE, NULL);
     SSL_set_fd(ctx->ssl, sock);
     
     if (SSL_connect(ctx->ssl) != 1) {
@@ -809,6 +985,207 @@ MoonValue* moon_tls_wrap_server(MoonValue* socket, MoonValue* cert_path, MoonVal
     return moon_int((int64_t)(uintptr_t)ctx);
 }
 
+// ============================================================================
+// Keep-Alive Connection Pool
+// ============================================================================
+
+// An idle connection is reusable if the peer has not closed it. TLS 1.3
+// servers may still have session tickets in flight, so peek through SSL in
+// non-blocking mode instead of looking at the raw socket.
+static bool tls_conn_alive(MoonTlsContext* ctx) {
+    if (!ctx->connected || !ctx->ssl) return false;
+    if (SSL_pending(ctx->ssl) > 0) return false;  // Unread response data
+    
+#ifdef _WIN32
+    u_long nb = 1;
+    ioctlsocket((SOCKET)ctx->socket_fd, FIONBIO, &nb);
+#else
+    int flags = fcntl(ctx->socket_fd, F_GETFL, 0);
+    fcntl(ctx->socket_fd, F_SETFL, flags | O_NONBLOCK);
+#endif
+    
+    char c;
+    int n = SSL_peek(ctx->ssl, &c, 1);
+    int err = (n > 0) ? SSL_ERROR_NONE : SSL_get_error(ctx->ssl, n);
+    
+#ifdef _WIN32
+    nb = 0;
+    ioctlsocket((SOCKET)ctx->socket_fd, FIONBIO, &nb);
+#else
+    fcntl(ctx->socket_fd, F_SETFL, flags);
+#endif
+    ERR_clear_error();
+    
+    return n <= 0 && (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE);
+}
+
+static void free_tls_context_list(MoonTlsContext* ctx) {
+    while (ctx) {
+        MoonTlsContext* next = ctx->pool_next;
+        free_tls_context(ctx);
+        ctx = next;
+    }
+}
+
+MoonValue* moon_tls_pool_config(MoonValue* max_idle, MoonValue* idle_timeout_ms) {
+    tls_lock();
+    if (!moon_is_null(max_idle)) {
+        int64_t n = moon_to_int(max_idle);
+        g_tls_pool_max_idle = n < 0 ? 0 : (int)n;
+    }
+    if (!moon_is_null(idle_timeout_ms)) {
+        int64_t ms = moon_to_int(idle_timeout_ms);
+        g_tls_pool_idle_timeout = ms < 0 ? 0 : ms;
+    }
+    tls_unlock();
+    return moon_bool(true);
+}
+
+MoonValue* moon_tls_pool_get(MoonValue* host, MoonValue* port) {
+    moon_tls_init();
+    
+    if (!moon_is_string(host)) {
+        return moon_null();
+    }
+    
+    const char* hostname = host->data.strVal;
+    int portnum = (int)moon_to_int(port);
+    std::string key = tls_host_key(hostname, portnum);
+    int64_t now = tls_now_ms();
+    
+    // Most recently parked connections are tried first
+    for (;;) {
+        MoonTlsContext* ctx = NULL;
+        int64_t timeout;
+        
+        tls_lock();
+        auto it = g_tls_pool.find(key);
+        if (it != g_tls_pool.end() && it->second) {
+            ctx = it->second;
+            it->second = ctx->pool_next;
+            ctx->pool_next = NULL;
+        }
+        timeout = g_tls_pool_idle_timeout;
+        tls_unlock();
+        
+        if (!ctx) break;
+        
+        if (now - ctx->idle_since <= timeout && tls_conn_alive(ctx)) {
+            tls_lock();
+            g_tls_stat_pool_hits++;
+            tls_unlock();
+            return moon_int((int64_t)(uintptr_t)ctx);
+        }
+        free_tls_context(ctx);
+    }
+    
+    tls_lock();
+    g_tls_stat_pool_misses++;
+    tls_unlock();
+    
+    MoonTlsContext* ctx = tls_client_connect(hostname, portnum);
+    if (!ctx) {
+        return moon_null();
+    }
+    return moon_int((int64_t)(uintptr_t)ctx);
+}
+
+MoonValue* moon_tls_pool_put(MoonValue* conn) {
+    MoonTlsContext* ctx = (MoonTlsContext*)(uintptr_t)moon_to_int(conn);
+    if (!ctx) {
+        return moon_bool(false);
+    }
+    
+    // Only healthy client connections with a known host can be reused
+    if (ctx->is_server || !ctx->hostname || !ctx->connected || !ctx->ssl ||
+        SSL_pending(ctx->ssl) > 0) {
+        free_tls_context(ctx);
+        return moon_bool(false);
+    }
+    
+    ctx->idle_since = tls_now_ms();
+    std::string key = tls_host_key(ctx->hostname, ctx->port);
+    MoonTlsContext* evicted = NULL;
+    bool pooled = false;
+    
+    tls_lock();
+    if (g_tls_pool_max_idle > 0) {
+        MoonTlsContext*& head = g_tls_pool[key];
+        ctx->pool_next = head;
+        head = ctx;
+        pooled = true;
+        
+        // Trim connections that expired or exceed the per-host limit
+        int kept = 0;
+        MoonTlsContext** pp = &head;
+        while (*pp) {
+            MoonTlsContext* c = *pp;
+            if (kept >= g_tls_pool_max_idle ||
+                ctx->idle_since - c->idle_since > g_tls_pool_idle_timeout) {
+                *pp = c->pool_next;
+                c->pool_next = evicted;
+                evicted = c;
+            } else {
+                kept++;
+                pp = &c->pool_next;
+            }
+        }
+    }
+    tls_unlock();
+    
+    if (!pooled) {
+        free_tls_context(ctx);
+    }
+    free_tls_context_list(evicted);
+    
+    return moon_bool(pooled);
+}
+
+void moon_tls_pool_clear(void) {
+    MoonTlsContext* idle = NULL;
+    
+    tls_lock();
+    for (auto& entry : g_tls_pool) {
+        MoonTlsContext* c = entry.second;
+        while (c) {
+            MoonTlsContext* next = c->pool_next;
+            c->pool_next = idle;
+            idle = c;
+            c = next;
+        }
+    }
+    g_tls_pool.clear();
+    
+    for (auto& entry : g_tls_sessions) {
+        SSL_SESSION_free(entry.second);
+    }
+    g_tls_sessions.clear();
+    tls_unlock();
+    
+    free_tls_context_list(idle);
+}
+
+MoonValue* moon_tls_pool_stats(void) {
+    int64_t idle = 0;
+    MoonValue* result = moon_dict_new();
+    
+    tls_lock();
+    for (auto& entry : g_tls_pool) {
+        for (MoonTlsContext* c = entry.second; c; c = c->pool_next) idle++;
+    }
+    tls_dict_set_int(result, "idle", idle);
+    tls_dict_set_int(result, "max_idle", g_tls_pool_max_idle);
+    tls_dict_set_int(result, "idle_timeout", g_tls_pool_idle_timeout);
+    tls_dict_set_int(result, "sessions", (int64_t)g_tls_sessions.size());
+    tls_dict_set_int(result, "handshakes", g_tls_stat_handshakes);
+    tls_dict_set_int(result, "resumed", g_tls_stat_resumed);
+    tls_dict_set_int(result, "pool_hits", g_tls_stat_pool_hits);
+    tls_dict_set_int(result, "pool_misses", g_tls_stat_pool_misses);
+    tls_unlock();
+    
+    return result;
+}
+
 #else // !MOON_HAS_TLS
 
 // ============================================================================
@@ -838,11 +1215,16 @@ MoonValue* moon_tls_send(MoonValue* conn, MoonValue* data) {
     return moon_int(-1);
 }
 
-MoonValue* moon_tls_recv(MoonValue* conn) {
-    (void)conn;
+MoonValue* moon_tls_recv(MoonValue* conn, MoonValue* max) {
+    (void)conn; (void)max;
     return moon_string("");
 }
 
+MoonValue* moon_tls_reader(MoonValue* conn) {
+    (void)conn;
+    return moon_null();
+}
+
 MoonValue* moon_tls_recv_all(MoonValue* conn, MoonValue* max) {
     (void)conn; (void)max;
     return moon_string("");
@@ -907,4 +1289,30 @@ MoonValue* moon_tls_wrap_server(MoonValue* socket, MoonValue* cert, MoonValue* k
     return moon_null();
 }
 
+MoonValue* moon_tls_pool_config(MoonValue* max_idle, MoonValue* idle_timeout_ms) {
+    (void)max_idle; (void)idle_timeout_ms;
+    return moon_bool(false);
+}
+
+MoonValue* moon_tls_pool_get(MoonValue* host, MoonValue* port) {
+    (void)host; (void)port;
+    return moon_null();
+}
+
+MoonValue* moon_tls_pool_put(MoonValue* conn) {
+    (void)conn;
+    return moon_bool(false);
+}
+
+void moon_tls_pool_clear(void) {}
+
+int moon_tls_conn_fd(void* conn) { return -1; }
+int moon_tls_conn_pending(void* conn) { return 0; }
+int moon_tls_conn_read(void* conn, char* buf, int len) { return -1; }
+int moon_tls_conn_write(void* conn, const char* buf, int len) { return -1; }
+
+MoonValue* moon_tls_pool_stats(void) {
+    return moon_dict_new();
+}
+
 #endif // MOON_HAS_TLS
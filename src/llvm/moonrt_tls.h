@@ -33,6 +33,9 @@ typedef struct MoonTlsContext {
     bool connected;         // Connection established
     char* hostname;         // SNI hostname (client only)
     int verify_mode;        // Certificate verification mode
+    int port;               // Remote port (client only, session/pool key)
+    int64_t idle_since;     // When the connection was parked in the pool (ms)
+    struct MoonTlsContext* pool_next;  // Next idle connection for the same host
 } MoonTlsContext;
 
 // Verification modes
@@ -55,8 +58,9 @@ MoonValue* moon_tls_accept(MoonValue* server);
 
 // Data transfer
 MoonValue* moon_tls_send(MoonValue* conn, MoonValue* data);
-MoonValue* moon_tls_recv(MoonValue* conn);
+MoonValue* moon_tls_recv(MoonValue* conn, MoonValue* max);
 MoonValue* moon_tls_recv_all(MoonValue* conn, MoonValue* max_size);
+MoonValue* moon_tls_reader(MoonValue* conn);
 
 // Connection management
 void moon_tls_close(MoonValue* conn);
@@ -96,6 +100,25 @@ MoonValue* moon_tls_cert_info(MoonValue* cert);
 MoonValue* moon_tls_wrap_client(MoonValue* socket);
 MoonValue* moon_tls_wrap_server(MoonValue* socket, MoonValue* cert_path, MoonValue* key_path);
 
+// ============================================================================
+// Keep-Alive Connection Pool (client)
+// ============================================================================
+
+// Configure pool limits: idle connections kept per host and idle timeout (ms)
+MoonValue* moon_tls_pool_config(MoonValue* max_idle, MoonValue* idle_timeout_ms);
+
+// Take an idle connection to host:port from the pool, or connect a new one
+MoonValue* moon_tls_pool_get(MoonValue* host, MoonValue* port);
+
+// Return a connection to the pool (closed instead if the pool is full)
+MoonValue* moon_tls_pool_put(MoonValue* conn);
+
+// Close all idle connections and forget cached sessions
+void moon_tls_pool_clear(void);
+
+// Pool and handshake statistics
+MoonValue* moon_tls_pool_stats(void);
+
 // ============================================================================
 // TLS Initialization/Cleanup
 // ============================================================================
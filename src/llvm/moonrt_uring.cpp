@@ -0,0 +1,413 @@
+// MoonLang Runtime - io_uring Engine
+// Copyright (c) 2026 greenteng.com
+//
+// Coroutine-aware file and socket I/O (moon_io_*).
+// - On Linux, operations issued from coroutines are queued on one shared
+//   io_uring. The issuing coroutine submits everything queued with a single
+//   io_uring_enter and parks; a reaper thread blocks in io_uring_enter for
+//   completions and wakes the owners. A slow read no longer stalls the
+//   scheduler worker it runs on, and an idle ring costs no CPU.
+// - Without io_uring (other platforms, old kernels, a sandbox that forbids
+//   it, or MOON_NO_URING=1 in the environment), or while the ring is
+//   saturated, sockets park on the readiness reactor and files use plain
+//   syscalls.
+// - Outside coroutines these are always plain syscalls: a single blocking
+//   call is cheaper than a round trip through the ring.
+
+#include "moonrt_core.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/socket.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(SYS_io_uring_setup) && defined(SYS_io_uring_enter) && defined(SYS_io_uring_register)
+#define MOON_HAS_URING 1
+#endif
+#endif
+#endif
+
+#ifdef MOON_HAS_URING
+
+#define URING_ENTRIES 512
+
+// One in-flight operation; lives on the waiting coroutine's stack
+typedef struct {
+    int done;                   // Guarded by the ring lock
+    int res;
+    void* waiter;               // Coroutine to wake on completion
+} UringOp;
+
+typedef struct {
+    int fd;
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    struct io_uring_sqe* sqes;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+    unsigned cq_entries;
+    unsigned queued;            // Prepared SQEs not yet submitted
+    unsigned inflight;          // Submitted or queued, not yet reaped
+    bool unsupported[IORING_OP_LAST];   // From IORING_REGISTER_PROBE
+    pthread_mutex_t lock;
+} MoonUring;
+
+static MoonUring* g_uring = NULL;
+static pthread_once_t g_uring_once = PTHREAD_ONCE_INIT;
+
+static void uring_flush(MoonUring* u);
+static void* uring_reaper(void* arg);
+
+static void uring_init() {
+    const char* off = getenv("MOON_NO_URING");
+    if (off && *off && *off != '0') return;
+
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    int fd = (int)syscall(SYS_io_uring_setup, URING_ENTRIES, &p);
+    if (fd < 0) return;
+    if (!(p.features & IORING_FEAT_SINGLE_MMAP) || !(p.features & IORING_FEAT_NODROP)) {
+        close(fd);      // Pre-5.5 kernels: not worth the extra mapping code
+        return;
+    }
+
+    size_t sqSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    size_t cqSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    size_t ringSize = sqSize > cqSize ? sqSize : cqSize;
+    char* ring = (char*)mmap(NULL, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             fd, IORING_OFF_SQ_RING);
+    if (ring == MAP_FAILED) {
+        close(fd);
+        return;
+    }
+    struct io_uring_sqe* sqes = (struct io_uring_sqe*)mmap(NULL, p.sq_entries * sizeof(struct io_uring_sqe),
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        munmap(ring, ringSize);
+        close(fd);
+        return;
+    }
+
+    // Ask which opcodes this kernel supports (5.6+; older kernels lack
+    // IORING_OP_READ/SEND/RECV anyway, so the ring is not used there)
+    size_t probeSize = sizeof(struct io_uring_probe) + IORING_OP_LAST * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe* probe = (struct io_uring_probe*)calloc(1, probeSize);
+    if (!probe || syscall(SYS_io_uring_register, fd, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) < 0) {
+        free(probe);
+        munmap(sqes, p.sq_entries * sizeof(struct io_uring_sqe));
+        munmap(ring, ringSize);
+        close(fd);
+        return;
+    }
+
+    MoonUring* u = (MoonUring*)calloc(1, sizeof(MoonUring));
+    for (int op = 0; op < IORING_OP_LAST; op++) {
+        u->unsupported[op] = op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    }
+    free(probe);
+    u->fd = fd;
+    u->sq_head = (unsigned*)(ring + p.sq_off.head);
+    u->sq_tail = (unsigned*)(ring + p.sq_off.tail);
+    u->sq_mask = (unsigned*)(ring + p.sq_off.ring_mask);
+    u->sq_array = (unsigned*)(ring + p.sq_off.array);
+    u->sqes = sqes;
+    u->cq_head = (unsigned*)(ring + p.cq_off.head);
+    u->cq_tail = (unsigned*)(ring + p.cq_off.tail);
+    u->cq_mask = (unsigned*)(ring + p.cq_off.ring_mask);
+    u->cqes = (struct io_uring_cqe*)(ring + p.cq_off.cqes);
+    u->cq_entries = p.cq_entries;
+    pthread_mutex_init(&u->lock, NULL);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pthread_attr_setstacksize(&attr, 64 * 1024);
+    pthread_t reaper;
+    int rc = pthread_create(&reaper, &attr, uring_reaper, u);
+    pthread_attr_destroy(&attr);
+    if (rc != 0) {
+        pthread_mutex_destroy(&u->lock);
+        free(u);
+        munmap(sqes, p.sq_entries * sizeof(struct io_uring_sqe));
+        munmap(ring, ringSize);
+        close(fd);
+        return;
+    }
+    g_uring = u;
+}
+
+static MoonUring* uring_get() {
+    pthread_once(&g_uring_once, uring_init);
+    return g_uring;
+}
+
+// Submit queued SQEs and hand out completions, waking each owner. Caller
+// holds the lock; the owner only reads done under it, so its op is never
+// touched after it returns.
+static void uring_flush(MoonUring* u) {
+    if (u->queued > 0) {
+        int n;
+        do {
+            n = (int)syscall(SYS_io_uring_enter, u->fd, u->queued, 0, 0, NULL, 0);
+        } while (n < 0 && errno == EINTR);
+        if (n > 0) u->queued -= (unsigned)n;
+    }
+    unsigned head = *u->cq_head;
+    unsigned tail = __atomic_load_n(u->cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        struct io_uring_cqe* cqe = &u->cqes[head & *u->cq_mask];
+        UringOp* op = (UringOp*)(uintptr_t)cqe->user_data;
+        op->res = cqe->res;
+        op->done = 1;
+        moon_coro_wake(op->waiter);
+        u->inflight--;
+        head++;
+    }
+    __atomic_store_n(u->cq_head, head, __ATOMIC_RELEASE);
+}
+
+// Block for completions and hand them out, so waiters can park instead of
+// polling the CQ ring
+static void* uring_reaper(void* arg) {
+    MoonUring* u = (MoonUring*)arg;
+    for (;;) {
+        int n = (int)syscall(SYS_io_uring_enter, u->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (n < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            // Unexpected failure: back off rather than spin
+            struct timespec ts = {0, 1000000};
+            nanosleep(&ts, NULL);
+        }
+        pthread_mutex_lock(&u->lock);
+        uring_flush(u);
+        pthread_mutex_unlock(&u->lock);
+    }
+    return NULL;
+}
+
+// Run one operation through the ring, parking until it completes.
+// Returns false if the opcode is unsupported or the ring is saturated
+// (caller falls back).
+static bool uring_run(MoonUring* u, int opcode, int fd, uint64_t addr, unsigned len,
+                      uint64_t offset, unsigned flags, int64_t* result) {
+    UringOp op;
+    op.done = 0;
+    op.res = 0;
+    op.waiter = moon_coro_self();
+
+    if (u->unsupported[opcode]) return false;
+
+    pthread_mutex_lock(&u->lock);
+    // Keep in-flight work within the CQ ring so completions never overflow,
+    // and never write an SQE the kernel has not consumed yet
+    unsigned tail = *u->sq_tail;
+    if (u->inflight >= u->cq_entries ||
+        tail - __atomic_load_n(u->sq_head, __ATOMIC_ACQUIRE) > *u->sq_mask) {
+        uring_flush(u);
+        tail = *u->sq_tail;
+        if (u->inflight >= u->cq_entries ||
+            tail - __atomic_load_n(u->sq_head, __ATOMIC_ACQUIRE) > *u->sq_mask) {
+            pthread_mutex_unlock(&u->lock);
+            return false;
+        }
+    }
+    unsigned idx = tail & *u->sq_mask;
+    struct io_uring_sqe* sqe = &u->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = (uint8_t)opcode;
+    sqe->fd = fd;
+    sqe->addr = addr;
+    sqe->len = len;
+    sqe->off = offset;
+    sqe->rw_flags = (int)flags;
+    sqe->user_data = (uint64_t)(uintptr_t)&op;
+    u->sq_array[idx] = idx;
+    __atomic_store_n(u->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    u->queued++;
+    u->inflight++;
+    pthread_mutex_unlock(&u->lock);
+
+    // Let other coroutines queue their operations, then submit the batch
+    // (unless an earlier flush already took ours) and park
+    moon_yield();
+    pthread_mutex_lock(&u->lock);
+    if (u->queued > 0) uring_flush(u);
+    for (;;) {
+        bool done = op.done != 0;
+        pthread_mutex_unlock(&u->lock);
+        if (done) break;
+        moon_coro_park();
+        pthread_mutex_lock(&u->lock);
+    }
+
+    if (op.res < 0) {
+        errno = -op.res;
+        *result = -1;
+    } else {
+        *result = op.res;
+    }
+    return true;
+}
+
+static unsigned uring_len(size_t len) {
+    return len > 0x7FFFF000 ? 0x7FFFF000 : (unsigned)len;
+}
+
+#endif // MOON_HAS_URING
+
+// ============================================================================
+// Fallback Waits
+// ============================================================================
+
+#ifdef MOON_HAS_NETWORK
+// Park the coroutine until sock is ready (or has an error the syscall
+// will report)
+static void io_wait_socket(int64_t sock, bool write) {
+    moon_io_wait(sock, write, -1);
+}
+#endif
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+bool moon_io_uring_active(void) {
+#ifdef MOON_HAS_URING
+    return uring_get() != NULL;
+#else
+    return false;
+#endif
+}
+
+#ifndef _WIN32
+// Read from fd at offset (offset < 0: at the current file position)
+int64_t moon_io_pread(int fd, void* buf, size_t len, int64_t offset) {
+#ifdef MOON_HAS_URING
+    MoonUring* u;
+    int64_t res;
+    if (moon_in_coroutine() && (u = uring_get()) &&
+        uring_run(u, IORING_OP_READ, fd, (uint64_t)(uintptr_t)buf, uring_len(len),
+                  (uint64_t)offset, 0, &res)) {
+        return res;
+    }
+#endif
+    ssize_t n;
+    do {
+        n = offset < 0 ? read(fd, buf, len) : pread(fd, buf, len, (off_t)offset);
+    } while (n < 0 && errno == EINTR);
+    return n;
+}
+
+// Write to fd at offset (offset < 0: at the current file position)
+int64_t moon_io_pwrite(int fd, const void* buf, size_t len, int64_t offset) {
+#ifdef MOON_HAS_URING
+    MoonUring* u;
+    int64_t res;
+    if (moon_in_coroutine() && (u = uring_get()) &&
+        uring_run(u, IORING_OP_WRITE, fd, (uint64_t)(uintptr_t)buf, uring_len(len),
+                  (uint64_t)offset, 0, &res)) {
+        return res;
+    }
+#endif
+    ssize_t n;
+    do {
+        n = offset < 0 ? write(fd, buf, len) : pwrite(fd, buf, len, (off_t)offset);
+    } while (n < 0 && errno == EINTR);
+    return n;
+}
+#endif
+
+#ifdef MOON_HAS_NETWORK
+
+int64_t moon_io_recv(int64_t sock, void* buf, size_t len) {
+    if (moon_in_coroutine()) {
+#ifdef MOON_HAS_URING
+        MoonUring* u = uring_get();
+        int64_t res;
+        if (u && uring_run(u, IORING_OP_RECV, (int)sock, (uint64_t)(uintptr_t)buf, uring_len(len),
+                           0, 0, &res)) {
+            return res;
+        }
+#endif
+        io_wait_socket(sock, false);
+    }
+#ifdef _WIN32
+    return recv((SOCKET)sock, (char*)buf, (int)(len > INT32_MAX ? INT32_MAX : len), 0);
+#else
+    ssize_t n;
+    do {
+        n = recv((int)sock, buf, len, 0);
+    } while (n < 0 && errno == EINTR);
+    return n;
+#endif
+}
+
+int64_t moon_io_send(int64_t sock, const void* buf, size_t len) {
+    if (moon_in_coroutine()) {
+#ifdef MOON_HAS_URING
+        MoonUring* u = uring_get();
+        int64_t res;
+        if (u && uring_run(u, IORING_OP_SEND, (int)sock, (uint64_t)(uintptr_t)buf, uring_len(len),
+                           0, MSG_NOSIGNAL, &res)) {
+            return res;
+        }
+#endif
+        io_wait_socket(sock, true);
+    }
+#ifdef _WIN32
+    return send((SOCKET)sock, (const char*)buf, (int)(len > INT32_MAX ? INT32_MAX : len), 0);
+#else
+    ssize_t n;
+    do {
+        n = send((int)sock, buf, len, MSG_NOSIGNAL);
+    } while (n < 0 && errno == EINTR);
+    return n;
+#endif
+}
+
+// accept() into addr/addrLen (a socklen_t*); flags are accept4 flags
+// (SOCK_CLOEXEC, SOCK_NONBLOCK) and are ignored where accept4 is missing
+int64_t moon_io_accept(int64_t sock, void* addr, void* addrLen, int flags) {
+    if (moon_in_coroutine()) {
+#ifdef MOON_HAS_URING
+        MoonUring* u = uring_get();
+        int64_t res;
+        // accept: addr2 carries the length pointer, rw_flags the accept4 flags
+        if (u && uring_run(u, IORING_OP_ACCEPT, (int)sock, (uint64_t)(uintptr_t)addr, 0,
+                           (uint64_t)(uintptr_t)addrLen, (unsigned)flags, &res)) {
+            return res;
+        }
+#endif
+        io_wait_socket(sock, false);
+    }
+#ifdef _WIN32
+    (void)flags;
+    SOCKET s = accept((SOCKET)sock, (struct sockaddr*)addr, (int*)addrLen);
+    return s == INVALID_SOCKET ? -1 : (int64_t)s;
+#elif defined(__linux__)
+    int fd;
+    do {
+        fd = accept4((int)sock, (struct sockaddr*)addr, (socklen_t*)addrLen, flags);
+    } while (fd < 0 && errno == EINTR);
+    return fd;
+#else
+    (void)flags;
+    return accept((int)sock, (struct sockaddr*)addr, (socklen_t*)addrLen);
+#endif
+}
+
+#endif // MOON_HAS_NETWORK
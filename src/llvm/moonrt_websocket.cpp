@@ -0,0 +1,1292 @@
+// MoonLang Runtime - WebSocket Module
+// Copyright (c) 2026 greenteng.com
+//
+// Stateful WebSocket connections (RFC 6455) for servers and clients.
+// - Frames are parsed incrementally as socket bytes arrive; payloads are
+//   unmasked in place (moon_ws_mask, SIMD) and assembled straight into
+//   the message string, so a message costs one allocation
+// - Fragmentation, ping/pong and the close handshake are handled here
+// - permessage-deflate (RFC 7692) when zlib is available at run time
+// - ws_broadcast encodes a frame once and writes it to many connections
+// - Inside a coroutine, waits park on the async reactor
+
+#include "moonrt_core.h"
+#include "moonrt_tls.h"
+
+#ifdef MOON_HAS_NETWORK
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#define MOON_SOCKET SOCKET
+#define WS_INVALID_SOCKET INVALID_SOCKET
+#define ws_closesocket closesocket
+#define strncasecmp _strnicmp
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#define MOON_SOCKET int
+#define WS_INVALID_SOCKET -1
+#define ws_closesocket close
+#endif
+
+#include <string>
+
+#if defined(__has_include)
+#if __has_include(<zlib.h>)
+#include <zlib.h>
+#define WS_HAS_ZLIB 1
+#endif
+#endif
+
+#define WS_MAX_MESSAGE (16 * 1024 * 1024)
+#define WS_MAX_HEAD (16 * 1024)
+#define WS_READ_CHUNK 16384
+#define WS_HANDSHAKE_TIMEOUT_MS 30000
+#define WS_DEFLATE_MIN 64           // Smaller messages are sent uncompressed
+
+#define WS_GUID "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+enum {
+    WS_OP_CONT = 0x0,
+    WS_OP_TEXT = 0x1,
+    WS_OP_BINARY = 0x2,
+    WS_OP_CLOSE = 0x8,
+    WS_OP_PING = 0x9,
+    WS_OP_PONG = 0xA
+};
+
+typedef struct {
+    MOON_SOCKET sock;
+    void* tls;                  // TLS connection (wss://), NULL for plain TCP
+    bool client;                // Client frames are masked
+#ifdef _WIN32
+    SRWLOCK write_lock;
+#else
+    pthread_mutex_t write_lock;
+#endif
+
+    // Receive buffer
+    char* in;
+    size_t in_cap;
+    size_t in_start;
+    size_t in_end;
+
+    // Frame being received
+    bool in_frame;
+    int frame_op;
+    bool frame_fin;
+    bool frame_masked;
+    unsigned char frame_key[4];
+    uint64_t frame_left;
+    uint64_t frame_pos;
+    char ctrl[125];             // Control frame payload
+
+    // Message being assembled (a moon string buffer)
+    char* msg;
+    size_t msg_len;
+    size_t msg_cap;
+    int msg_op;                 // 0 = no message in progress
+    bool msg_compressed;
+    bool last_binary;
+
+    bool closed;
+    bool close_sent;
+    int close_code;
+    std::string* close_reason;
+    std::string* protocol;
+    std::string* path;
+    size_t max_message;
+
+    // permessage-deflate
+    bool deflate;
+    bool tx_no_context;         // Reset our compressor after every message
+    int tx_window_bits;
+#ifdef WS_HAS_ZLIB
+    z_stream* tx_z;
+    z_stream* rx_z;
+#endif
+
+    int64_t messages_in;
+    int64_t messages_out;
+} MoonWs;
+
+static MoonWs* ws_get(MoonValue* v) {
+    return (MoonWs*)(uintptr_t)moon_to_int(v);
+}
+
+static void ws_lock(MoonWs* ws) {
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&ws->write_lock);
+#else
+    pthread_mutex_lock(&ws->write_lock);
+#endif
+}
+
+static void ws_unlock(MoonWs* ws) {
+#ifdef _WIN32
+    ReleaseSRWLockExclusive(&ws->write_lock);
+#else
+    pthread_mutex_unlock(&ws->write_lock);
+#endif
+}
+
+static int64_t ws_now_ms() {
+#ifdef _WIN32
+    return (int64_t)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+#endif
+}
+
+// Random bytes for mask keys and handshake nonces (not cryptographic;
+// RFC 6455 only needs them to be unpredictable to intermediaries)
+static void ws_random(unsigned char* out, size_t len) {
+#ifdef _WIN32
+    static __declspec(thread) uint64_t state = 0;
+#else
+    static __thread uint64_t state = 0;
+#endif
+    if (!state) state = ((uint64_t)time(NULL) << 20) ^ (uint64_t)(uintptr_t)&state ^ (uint64_t)ws_now_ms();
+    for (size_t i = 0; i < len; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        out[i] = (unsigned char)(state >> 24);
+    }
+}
+
+// ============================================================================
+// Handshake Helpers (SHA-1, base64)
+// ============================================================================
+
+static void ws_sha1(const unsigned char* data, size_t len, unsigned char out[20]) {
+    uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    size_t total = ((len + 8) / 64 + 1) * 64;
+    unsigned char* msg = (unsigned char*)calloc(1, total);
+    if (!msg) return;
+    memcpy(msg, data, len);
+    msg[len] = 0x80;
+    uint64_t bits = (uint64_t)len * 8;
+    for (int i = 0; i < 8; i++) msg[total - 1 - i] = (unsigned char)(bits >> (i * 8));
+
+    for (size_t off = 0; off < total; off += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; i++) {
+            const unsigned char* p = msg + off + i * 4;
+            w[i] = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+        }
+        for (int i = 16; i < 80; i++) {
+            uint32_t x = w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16];
+            w[i] = (x << 1) | (x >> 31);
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20)      { f = (b & c) | (~b & d);          k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else             { f = b ^ c ^ d;                   k = 0xCA62C1D6; }
+            uint32_t t = ((a << 5) | (a >> 27)) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = (b << 30) | (b >> 2);
+            b = a;
+            a = t;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+    free(msg);
+    for (int i = 0; i < 5; i++) {
+        out[i * 4] = (unsigned char)(h[i] >> 24);
+        out[i * 4 + 1] = (unsigned char)(h[i] >> 16);
+        out[i * 4 + 2] = (unsigned char)(h[i] >> 8);
+        out[i * 4 + 3] = (unsigned char)h[i];
+    }
+}
+
+static std::string ws_base64(const unsigned char* data, size_t len) {
+    static const char tbl[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)data[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)data[i + 1] << 8;
+        if (i + 2 < len) v |= data[i + 2];
+        out += tbl[(v >> 18) & 63];
+        out += tbl[(v >> 12) & 63];
+        out += i + 1 < len ? tbl[(v >> 6) & 63] : '=';
+        out += i + 2 < len ? tbl[v & 63] : '=';
+    }
+    return out;
+}
+
+// Sec-WebSocket-Accept for a Sec-WebSocket-Key
+static std::string ws_accept_key(const std::string& key) {
+    std::string s = key + WS_GUID;
+    unsigned char digest[20];
+    ws_sha1((const unsigned char*)s.data(), s.size(), digest);
+    return ws_base64(digest, 20);
+}
+
+static bool ws_ieq(const char* a, size_t alen, const char* b) {
+    size_t blen = strlen(b);
+    if (alen != blen) return false;
+    for (size_t i = 0; i < alen; i++) {
+        if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i])) return false;
+    }
+    return true;
+}
+
+// Does the comma-separated header value contain token (case-insensitive)?
+static bool ws_has_token(const std::string& v, const char* token) {
+    size_t i = 0;
+    while (i < v.size()) {
+        while (i < v.size() && (v[i] == ' ' || v[i] == '\t' || v[i] == ',')) i++;
+        size_t start = i;
+        while (i < v.size() && v[i] != ',') i++;
+        size_t end = i;
+        while (end > start && (v[end - 1] == ' ' || v[end - 1] == '\t')) end--;
+        if (ws_ieq(v.data() + start, end - start, token)) return true;
+    }
+    return false;
+}
+
+// ============================================================================
+// Socket I/O
+// ============================================================================
+
+static int ws_poll(MOON_SOCKET sock, int timeout_ms) {
+#ifdef _WIN32
+    WSAPOLLFD pfd;
+    pfd.fd = sock;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return WSAPoll(&pfd, 1, timeout_ms);
+#else
+    struct pollfd pfd;
+    pfd.fd = sock;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    int n;
+    do {
+        n = poll(&pfd, 1, timeout_ms);
+    } while (n < 0 && errno == EINTR);
+    return n;
+#endif
+}
+
+// Wait until the connection is readable; deadline < 0 waits forever.
+// Inside a coroutine the wait parks on the reactor.
+static bool ws_wait(MoonWs* ws, int64_t deadline) {
+    if (ws->tls && moon_tls_conn_pending(ws->tls) > 0) return true;
+    int timeout = -1;
+    if (deadline >= 0) {
+        int64_t left = deadline - ws_now_ms();
+        if (left <= 0) return false;
+        timeout = (int)left;
+    }
+    if (moon_in_coroutine()) return moon_io_wait((int64_t)ws->sock, false, timeout) != 0;
+    return ws_poll(ws->sock, timeout) != 0;    // Ready, or an error recv will report
+}
+
+static int ws_read(MoonWs* ws, char* buf, size_t len) {
+    int n = len > INT32_MAX ? INT32_MAX : (int)len;
+    if (ws->tls) return moon_tls_conn_read(ws->tls, buf, n);
+    return (int)recv(ws->sock, buf, n, 0);
+}
+
+// Write all bytes; caller holds the write lock
+static bool ws_write(MoonWs* ws, const char* data, size_t len) {
+    if (ws->tls) return moon_tls_conn_write(ws->tls, data, (int)len) == (int)len;
+    while (len > 0) {
+#ifdef _WIN32
+        int n = send(ws->sock, data, (int)(len > INT32_MAX ? INT32_MAX : len), 0);
+#else
+        ssize_t n = send(ws->sock, data, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+#endif
+        if (n <= 0) return false;
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+// ============================================================================
+// Frame Encoding
+// ============================================================================
+
+// Header for a frame; returns its size (at most 14 bytes)
+static size_t ws_frame_header(unsigned char* h, int opcode, bool rsv1, uint64_t len,
+                              const unsigned char* key) {
+    size_t n = 0;
+    h[n++] = (unsigned char)(0x80 | (rsv1 ? 0x40 : 0) | (opcode & 0x0F));
+    unsigned char maskBit = key ? 0x80 : 0x00;
+    if (len < 126) {
+        h[n++] = (unsigned char)(maskBit | len);
+    } else if (len < 65536) {
+        h[n++] = (unsigned char)(maskBit | 126);
+        h[n++] = (unsigned char)(len >> 8);
+        h[n++] = (unsigned char)len;
+    } else {
+        h[n++] = (unsigned char)(maskBit | 127);
+        for (int i = 7; i >= 0; i--) h[n++] = (unsigned char)(len >> (i * 8));
+    }
+    if (key) {
+        memcpy(h + n, key, 4);
+        n += 4;
+    }
+    return n;
+}
+
+// Encode and send one frame (masked on the client side)
+static bool ws_send_frame(MoonWs* ws, int opcode, const char* data, size_t len, bool rsv1) {
+    unsigned char key[4];
+    if (ws->client) ws_random(key, 4);
+
+    unsigned char h[14];
+    size_t hlen = ws_frame_header(h, opcode, rsv1, len, ws->client ? key : NULL);
+    char* frame = (char*)malloc(hlen + len);
+    if (!frame) return false;
+    memcpy(frame, h, hlen);
+    memcpy(frame + hlen, data, len);
+    if (ws->client) moon_ws_mask(frame + hlen, len, key, 0);
+
+    ws_lock(ws);
+    bool ok = !ws->close_sent && ws_write(ws, frame, hlen + len);
+    if (opcode == WS_OP_CLOSE) ws->close_sent = true;
+    ws_unlock(ws);
+    free(frame);
+    return ok;
+}
+
+#ifdef WS_HAS_ZLIB
+// Compress one message (RFC 7692 7.2.1: sync flush, drop the 00 00 ff ff
+// tail). Returns a malloc'd buffer or NULL.
+static char* ws_compress(MoonWs* ws, const char* data, size_t len, size_t* outLen) {
+    const MoonZlib* zl = moon_zlib();
+    if (!ws->tx_z) {
+        ws->tx_z = (z_stream*)calloc(1, sizeof(z_stream));
+        if (!ws->tx_z) return NULL;
+        if (zl->deflateInit2_(ws->tx_z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -ws->tx_window_bits, 8,
+                              Z_DEFAULT_STRATEGY, ZLIB_VERSION, (int)sizeof(z_stream)) != Z_OK) {
+            free(ws->tx_z);
+            ws->tx_z = NULL;
+            return NULL;
+        }
+    }
+    z_stream* z = ws->tx_z;
+    size_t cap = len + len / 8 + 64;
+    char* out = (char*)malloc(cap);
+    if (!out) return NULL;
+
+    z->next_in = (Bytef*)data;
+    z->avail_in = (uInt)len;
+    size_t produced = 0;
+    for (;;) {
+        z->next_out = (Bytef*)(out + produced);
+        z->avail_out = (uInt)(cap - produced);
+        int r = zl->deflate(z, Z_SYNC_FLUSH);
+        produced = cap - z->avail_out;
+        if (r != Z_OK && r != Z_BUF_ERROR) {
+            free(out);
+            return NULL;
+        }
+        if (z->avail_out > 0 && z->avail_in == 0) break;
+        cap *= 2;
+        char* grown = (char*)realloc(out, cap);
+        if (!grown) {
+            free(out);
+            return NULL;
+        }
+        out = grown;
+    }
+    if (produced >= 4) produced -= 4;
+    if (ws->tx_no_context) zl->deflateReset(z);
+    *outLen = produced;
+    return out;
+}
+
+// Decompress a complete message into a new string, null on error
+static MoonValue* ws_decompress(MoonWs* ws, const char* data, size_t len) {
+    const MoonZlib* zl = moon_zlib();
+    if (!zl) return NULL;
+    if (!ws->rx_z) {
+        ws->rx_z = (z_stream*)calloc(1, sizeof(z_stream));
+        if (!ws->rx_z) return NULL;
+        if (zl->inflateInit2_(ws->rx_z, -MAX_WBITS, ZLIB_VERSION, (int)sizeof(z_stream)) != Z_OK) {
+            free(ws->rx_z);
+            ws->rx_z = NULL;
+            return NULL;
+        }
+    }
+    static const unsigned char tail[4] = { 0x00, 0x00, 0xff, 0xff };
+    z_stream* z = ws->rx_z;
+    size_t cap = len * 3 + 64;
+    if (cap > ws->max_message) cap = ws->max_message;
+    char* out = moon_str_buffer(cap);
+    size_t produced = 0;
+
+    for (int part = 0; part < 2; part++) {
+        z->next_in = (Bytef*)(part == 0 ? data : (const char*)tail);
+        z->avail_in = (uInt)(part == 0 ? len : 4);
+        while (z->avail_in > 0) {
+            if (produced == cap) {
+                if (cap >= ws->max_message) {
+                    moon_release(moon_str_finish(out, 0));
+                    return NULL;
+                }
+                size_t grown = cap * 2 > ws->max_message ? ws->max_message : cap * 2;
+                out = moon_str_reserve(out, grown);
+                cap = grown;
+            }
+            z->next_out = (Bytef*)(out + produced);
+            z->avail_out = (uInt)(cap - produced);
+            int r = zl->inflate(z, Z_SYNC_FLUSH);
+            produced = cap - z->avail_out;
+            if (r != Z_OK && r != Z_BUF_ERROR && r != Z_STREAM_END) {
+                moon_release(moon_str_finish(out, 0));
+                return NULL;
+            }
+            if (r == Z_BUF_ERROR && z->avail_out > 0) break;
+        }
+    }
+    return moon_str_finish(out, produced);
+}
+#endif
+
+// Send a data message, compressing it when negotiated and worthwhile
+static bool ws_send_message(MoonWs* ws, int opcode, const char* data, size_t len) {
+    bool ok;
+#ifdef WS_HAS_ZLIB
+    if (ws->deflate && len >= WS_DEFLATE_MIN) {
+        // Compression state is per connection: serialize whole messages
+        size_t clen;
+        ws_lock(ws);
+        char* c = ws_compress(ws, data, len, &clen);
+        ws_unlock(ws);
+        if (c) {
+            ok = ws_send_frame(ws, opcode, c, clen, true);
+            free(c);
+            if (ok) ws->messages_out++;
+            return ok;
+        }
+    }
+#endif
+    ok = ws_send_frame(ws, opcode, data, len, false);
+    if (ok) ws->messages_out++;
+    return ok;
+}
+
+// ============================================================================
+// Frame Decoding
+// ============================================================================
+
+static void ws_fail(MoonWs* ws, int code) {
+    if (!ws->close_sent) {
+        unsigned char payload[2] = { (unsigned char)(code >> 8), (unsigned char)code };
+        ws_send_frame(ws, WS_OP_CLOSE, (const char*)payload, 2, false);
+    }
+    ws->closed = true;
+    if (!ws->close_code) ws->close_code = code;
+}
+
+// Parse the next frame header from the buffer. Returns 1 when parsed,
+// 0 if more bytes are needed, -1 on a protocol error.
+static int ws_parse_header(MoonWs* ws) {
+    size_t avail = ws->in_end - ws->in_start;
+    if (avail < 2) return 0;
+    const unsigned char* p = (const unsigned char*)ws->in + ws->in_start;
+
+    bool fin = (p[0] & 0x80) != 0;
+    bool rsv1 = (p[0] & 0x40) != 0;
+    int op = p[0] & 0x0F;
+    bool masked = (p[1] & 0x80) != 0;
+    uint64_t len = p[1] & 0x7F;
+    size_t need = 2 + (len == 126 ? 2 : len == 127 ? 8 : 0) + (masked ? 4 : 0);
+    if (avail < need) return 0;
+
+    size_t off = 2;
+    if (len == 126) {
+        len = ((uint64_t)p[2] << 8) | p[3];
+        off = 4;
+    } else if (len == 127) {
+        len = 0;
+        for (int i = 0; i < 8; i++) len = (len << 8) | p[2 + i];
+        off = 10;
+        if (len >> 63) {
+            ws_fail(ws, 1002);  // The most significant bit must be 0 (RFC 6455 5.2)
+            return -1;
+        }
+    }
+
+    if ((p[0] & 0x30) || (rsv1 && (!ws->deflate || op == WS_OP_CONT || op >= WS_OP_CLOSE))) {
+        ws_fail(ws, 1002);  // Reserved bits without a negotiated extension
+        return -1;
+    }
+    if (op >= WS_OP_CLOSE) {
+        if (op > WS_OP_PONG || !fin || len > 125) {
+            ws_fail(ws, 1002);
+            return -1;
+        }
+    } else if (op > WS_OP_BINARY) {
+        ws_fail(ws, 1002);
+        return -1;
+    } else if ((op == WS_OP_CONT) != (ws->msg_op != 0)) {
+        ws_fail(ws, 1002);  // Continuation without a message, or interleaved message
+        return -1;
+    }
+    if (!ws->client && !masked) {
+        ws_fail(ws, 1002);  // Client frames must be masked
+        return -1;
+    }
+    if (op < WS_OP_CLOSE && len > ws->max_message - ws->msg_len) {
+        ws_fail(ws, 1009);
+        return -1;
+    }
+
+    ws->frame_fin = fin;
+    ws->frame_op = op;
+    ws->frame_masked = masked;
+    if (masked) memcpy(ws->frame_key, p + off, 4);
+    ws->frame_left = len;
+    ws->frame_pos = 0;
+    ws->in_frame = true;
+    ws->in_start += need;
+
+    if (op == WS_OP_TEXT || op == WS_OP_BINARY) {
+        ws->msg_op = op;
+        ws->msg_compressed = rsv1;
+        ws->msg_len = 0;
+    }
+    if (op < WS_OP_CLOSE && (!ws->msg || ws->msg_len + len > ws->msg_cap)) {
+        size_t cap = ws->msg_cap ? ws->msg_cap : 256;
+        while (cap < ws->msg_len + len) cap *= 2;
+        if (cap > ws->max_message) cap = ws->max_message;
+        ws->msg = ws->msg ? moon_str_reserve(ws->msg, cap) : moon_str_buffer(cap);
+        ws->msg_cap = cap;
+    }
+    return 1;
+}
+
+// Handle a complete control frame. Returns false once the connection closed.
+static bool ws_control(MoonWs* ws, int op, size_t len) {
+    if (op == WS_OP_PING) {
+        ws_send_frame(ws, WS_OP_PONG, ws->ctrl, len, false);
+        return true;
+    }
+    if (op == WS_OP_PONG) return true;
+
+    // Close: echo the code back and stop
+    if (len >= 2) {
+        ws->close_code = ((unsigned char)ws->ctrl[0] << 8) | (unsigned char)ws->ctrl[1];
+        ws->close_reason->assign(ws->ctrl + 2, len - 2);
+    } else {
+        ws->close_code = 1005;
+    }
+    if (!ws->close_sent) {
+        ws_send_frame(ws, WS_OP_CLOSE, ws->ctrl, len >= 2 ? 2 : 0, false);
+    }
+    ws->closed = true;
+    return false;
+}
+
+// Consume buffered bytes. Returns 1 when a message is complete, 0 when
+// more bytes are needed, -1 once the connection is closed.
+static int ws_process(MoonWs* ws) {
+    for (;;) {
+        if (ws->closed) return -1;
+        if (!ws->in_frame) {
+            int r = ws_parse_header(ws);
+            if (r <= 0) return r;
+        }
+
+        size_t avail = ws->in_end - ws->in_start;
+        size_t take = ws->frame_left < avail ? (size_t)ws->frame_left : avail;
+        if (take > 0 || ws->frame_left == 0) {
+            char* dst = ws->frame_op >= WS_OP_CLOSE ? ws->ctrl + ws->frame_pos : ws->msg + ws->msg_len;
+            memcpy(dst, ws->in + ws->in_start, take);
+            if (ws->frame_masked) moon_ws_mask(dst, take, ws->frame_key, (size_t)ws->frame_pos);
+            ws->in_start += take;
+            ws->frame_pos += take;
+            ws->frame_left -= take;
+            if (ws->frame_op < WS_OP_CLOSE) ws->msg_len += take;
+        }
+        if (ws->frame_left > 0) return 0;
+
+        // Frame complete
+        ws->in_frame = false;
+        if (ws->frame_op >= WS_OP_CLOSE) {
+            if (!ws_control(ws, ws->frame_op, (size_t)ws->frame_pos)) return -1;
+            continue;
+        }
+        if (ws->frame_fin) return 1;
+    }
+}
+
+// Read into the receive buffer, or straight into the message when a large
+// payload is pending and nothing is buffered
+static int ws_fill(MoonWs* ws) {
+    if (ws->in_start == ws->in_end) {
+        ws->in_start = ws->in_end = 0;
+        if (ws->in_frame && ws->frame_op < WS_OP_CLOSE && ws->frame_left >= WS_READ_CHUNK) {
+            char* dst = ws->msg + ws->msg_len;
+            int n = ws_read(ws, dst, (size_t)ws->frame_left);
+            if (n > 0) {
+                if (ws->frame_masked) moon_ws_mask(dst, (size_t)n, ws->frame_key, (size_t)ws->frame_pos);
+                ws->frame_pos += n;
+                ws->frame_left -= n;
+                ws->msg_len += n;
+            }
+            return n;
+        }
+    } else if (ws->in_start > 0) {
+        memmove(ws->in, ws->in + ws->in_start, ws->in_end - ws->in_start);
+        ws->in_end -= ws->in_start;
+        ws->in_start = 0;
+    }
+    if (ws->in_end == ws->in_cap) return -1;
+    int n = ws_read(ws, ws->in + ws->in_end, ws->in_cap - ws->in_end);
+    if (n > 0) ws->in_end += n;
+    return n;
+}
+
+// ============================================================================
+// Connection Setup
+// ============================================================================
+
+static MoonWs* ws_new(MOON_SOCKET sock, void* tls, bool client) {
+    MoonWs* ws = (MoonWs*)calloc(1, sizeof(MoonWs));
+    if (!ws) return NULL;
+    ws->in = (char*)malloc(WS_READ_CHUNK);
+    if (!ws->in) {
+        free(ws);
+        return NULL;
+    }
+    ws->in_cap = WS_READ_CHUNK;
+    ws->sock = sock;
+    ws->tls = tls;
+    ws->client = client;
+    ws->max_message = WS_MAX_MESSAGE;
+    ws->tx_window_bits = 15;
+    ws->close_reason = new std::string();
+    ws->protocol = new std::string();
+    ws->path = new std::string();
+#ifdef _WIN32
+    InitializeSRWLock(&ws->write_lock);
+#else
+    pthread_mutex_init(&ws->write_lock, NULL);
+#endif
+    return ws;
+}
+
+static void ws_free(MoonWs* ws) {
+    if (ws->tls) {
+        MoonValue* conn = moon_int((int64_t)(uintptr_t)ws->tls);
+        moon_tls_close(conn);
+        moon_release(conn);
+    } else if (ws->sock != WS_INVALID_SOCKET) {
+        ws_closesocket(ws->sock);
+    }
+#ifdef WS_HAS_ZLIB
+    const MoonZlib* zl = moon_zlib();
+    if (ws->tx_z) {
+        zl->deflateEnd(ws->tx_z);
+        free(ws->tx_z);
+    }
+    if (ws->rx_z) {
+        zl->inflateEnd(ws->rx_z);
+        free(ws->rx_z);
+    }
+#endif
+    if (ws->msg) moon_release(moon_str_finish(ws->msg, 0));
+#ifndef _WIN32
+    pthread_mutex_destroy(&ws->write_lock);
+#endif
+    delete ws->close_reason;
+    delete ws->protocol;
+    delete ws->path;
+    free(ws->in);
+    free(ws);
+}
+
+static void ws_read_options(MoonWs* ws, MoonValue* options, bool* deflate) {
+    *deflate = true;
+    if (!options || options->type != MOON_DICT) return;
+    MoonValue* key = moon_string("deflate");
+    MoonValue* v = moon_dict_get(options, key, moon_null());
+    if (v->type != MOON_NULL) *deflate = moon_to_bool(v);
+    moon_release(v);
+    moon_release(key);
+    key = moon_string("max_message");
+    v = moon_dict_get(options, key, moon_null());
+    if (v->type != MOON_NULL && moon_to_int(v) > 0) ws->max_message = (size_t)moon_to_int(v);
+    moon_release(v);
+    moon_release(key);
+}
+
+// Read an HTTP head (up to CRLFCRLF) into ws->in. Returns its length;
+// bytes after it stay buffered as the first WebSocket data.
+static size_t ws_read_head(MoonWs* ws) {
+    int64_t deadline = ws_now_ms() + WS_HANDSHAKE_TIMEOUT_MS;
+    for (;;) {
+        for (size_t i = ws->in_start; i + 4 <= ws->in_end; i++) {
+            if (memcmp(ws->in + i, "\r\n\r\n", 4) == 0) return i + 4;
+        }
+        if (ws->in_end >= WS_MAX_HEAD || !ws_wait(ws, deadline)) return 0;
+        int n = ws_read(ws, ws->in + ws->in_end, ws->in_cap - ws->in_end);
+        if (n <= 0) return 0;
+        ws->in_end += n;
+    }
+}
+
+// Split an HTTP head into its first line and lowercased header map
+// entries, calling fn(name, value) for each header
+template <typename Fn>
+static std::string ws_parse_head(const char* head, size_t len, Fn fn) {
+    const char* end = head + len;
+    const char* eol = (const char*)memchr(head, '\r', len);
+    std::string first(head, eol ? eol - head : len);
+    const char* p = eol ? eol + 2 : end;
+    while (p < end) {
+        const char* e = (const char*)memchr(p, '\r', end - p);
+        if (!e || e == p) break;
+        const char* colon = (const char*)memchr(p, ':', e - p);
+        if (colon) {
+            std::string name(p, colon - p);
+            for (auto& c : name) c = (char)tolower((unsigned char)c);
+            const char* v = colon + 1;
+            while (v < e && (*v == ' ' || *v == '\t')) v++;
+            const char* ve = e;
+            while (ve > v && (ve[-1] == ' ' || ve[-1] == '\t')) ve--;
+            fn(name, std::string(v, ve - v));
+        }
+        p = e + 2;
+    }
+    return first;
+}
+
+// Parameters of one permessage-deflate offer or response
+typedef struct {
+    bool present;
+    bool server_no_context;
+    bool client_no_context;
+    int server_max_bits;        // 0 = not given
+    int client_max_bits;        // 0 = absent, -1 = given without a value
+} WsDeflateParams;
+
+static WsDeflateParams ws_parse_deflate(const std::string& header) {
+    WsDeflateParams d;
+    memset(&d, 0, sizeof(d));
+    size_t pos = 0;
+    // Extensions are comma separated; parameters follow ';'
+    while (pos < header.size() && !d.present) {
+        size_t end = header.find(',', pos);
+        if (end == std::string::npos) end = header.size();
+        std::string ext = header.substr(pos, end - pos);
+        pos = end + 1;
+
+        size_t semi = 0;
+        bool first = true;
+        WsDeflateParams cur;
+        memset(&cur, 0, sizeof(cur));
+        while (semi <= ext.size()) {
+            size_t next = ext.find(';', semi);
+            if (next == std::string::npos) next = ext.size();
+            std::string param = ext.substr(semi, next - semi);
+            semi = next + 1;
+            size_t a = param.find_first_not_of(" \t");
+            size_t b = param.find_last_not_of(" \t");
+            param = a == std::string::npos ? "" : param.substr(a, b - a + 1);
+            std::string value;
+            size_t eq = param.find('=');
+            if (eq != std::string::npos) {
+                value = param.substr(eq + 1);
+                param = param.substr(0, eq);
+                if (!value.empty() && value[0] == '"') value = value.substr(1, value.size() - 2);
+            }
+            if (first) {
+                if (!ws_ieq(param.data(), param.size(), "permessage-deflate")) break;
+                cur.present = true;
+                first = false;
+            } else if (ws_ieq(param.data(), param.size(), "server_no_context_takeover")) {
+                cur.server_no_context = true;
+            } else if (ws_ieq(param.data(), param.size(), "client_no_context_takeover")) {
+                cur.client_no_context = true;
+            } else if (ws_ieq(param.data(), param.size(), "server_max_window_bits")) {
+                cur.server_max_bits = atoi(value.c_str());
+            } else if (ws_ieq(param.data(), param.size(), "client_max_window_bits")) {
+                cur.client_max_bits = value.empty() ? -1 : atoi(value.c_str());
+            }
+        }
+        if (cur.present) d = cur;
+    }
+    return d;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+// ws_upgrade(sock[, options]) - server handshake on an accepted TCP socket
+// (or the tcp_accept result dict). options: deflate (default true),
+// max_message (bytes), protocols (list). Returns a WebSocket handle, or
+// null (a 400 response is sent) if the request is not a valid upgrade.
+MoonValue* moon_ws_upgrade(MoonValue* socket, MoonValue* options) {
+    int64_t fd = moon_to_int(socket);
+    if (socket && socket->type == MOON_DICT) {
+        MoonValue* key = moon_string("socket");
+        MoonValue* v = moon_dict_get(socket, key, moon_null());
+        fd = moon_to_int(v);
+        moon_release(v);
+        moon_release(key);
+    }
+    if (fd < 0) return moon_null();
+    MoonWs* ws = ws_new((MOON_SOCKET)fd, NULL, false);
+    if (!ws) return moon_null();
+    bool wantDeflate;
+    ws_read_options(ws, options, &wantDeflate);
+
+    size_t headLen = ws_read_head(ws);
+    if (headLen == 0) {
+        ws->sock = WS_INVALID_SOCKET;   // Caller still owns the socket
+        ws_free(ws);
+        return moon_null();
+    }
+
+    std::string key, upgrade, connection, version, extensions, protocols;
+    std::string first = ws_parse_head(ws->in, headLen, [&](const std::string& n, const std::string& v) {
+        if (n == "sec-websocket-key") key = v;
+        else if (n == "upgrade") upgrade = v;
+        else if (n == "connection") connection = v;
+        else if (n == "sec-websocket-version") version = v;
+        else if (n == "sec-websocket-extensions") extensions += (extensions.empty() ? "" : ", ") + v;
+        else if (n == "sec-websocket-protocol") protocols += (protocols.empty() ? "" : ", ") + v;
+    });
+    ws->in_start = headLen;
+
+    if (first.compare(0, 4, "GET ") != 0 || key.empty() || version != "13" ||
+        !ws_has_token(upgrade, "websocket") || !ws_has_token(connection, "upgrade")) {
+        static const char bad[] =
+            "HTTP/1.1 400 Bad Request\r\nSec-WebSocket-Version: 13\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        ws_write(ws, bad, sizeof(bad) - 1);
+        ws->sock = WS_INVALID_SOCKET;
+        ws_free(ws);
+        return moon_null();
+    }
+    size_t sp = first.find(' ', 4);
+    ws->path->assign(first, 4, sp == std::string::npos ? std::string::npos : sp - 4);
+
+    std::string resp = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n";
+    resp += "Sec-WebSocket-Accept: " + ws_accept_key(key) + "\r\n";
+
+    // Sub-protocol: first one the client offers that we support
+    MoonValue* pkey = moon_string("protocols");
+    MoonValue* ours = (options && options->type == MOON_DICT) ? moon_dict_get(options, pkey, moon_null()) : moon_null();
+    moon_release(pkey);
+    if (moon_is_list(ours) && !protocols.empty()) {
+        MoonList* pl = ours->data.listVal;
+        size_t pos = 0;
+        while (pos < protocols.size() && ws->protocol->empty()) {
+            size_t end = protocols.find(',', pos);
+            if (end == std::string::npos) end = protocols.size();
+            std::string offer = protocols.substr(pos, end - pos);
+            size_t a = offer.find_first_not_of(" \t");
+            size_t b = offer.find_last_not_of(" \t");
+            if (a != std::string::npos) offer = offer.substr(a, b - a + 1);
+            for (int i = 0; i < pl->length; i++) {
+                if (moon_is_string(pl->items[i]) && offer == pl->items[i]->data.strVal) {
+                    *ws->protocol = offer;
+                    break;
+                }
+            }
+            pos = end + 1;
+        }
+        if (!ws->protocol->empty()) resp += "Sec-WebSocket-Protocol: " + *ws->protocol + "\r\n";
+    }
+    moon_release(ours);
+
+#ifdef WS_HAS_ZLIB
+    if (wantDeflate && moon_zlib()) {
+        WsDeflateParams d = ws_parse_deflate(extensions);
+        // zlib cannot produce an 8-bit window; decline such offers
+        if (d.present && (d.server_max_bits == 0 || (d.server_max_bits >= 9 && d.server_max_bits <= 15))) {
+            ws->deflate = true;
+            ws->tx_no_context = d.server_no_context;
+            if (d.server_max_bits) ws->tx_window_bits = d.server_max_bits;
+            resp += "Sec-WebSocket-Extensions: permessage-deflate";
+            if (d.server_no_context) resp += "; server_no_context_takeover";
+            if (d.client_no_context) resp += "; client_no_context_takeover";
+            if (d.server_max_bits) resp += "; server_max_window_bits=" + std::to_string(d.server_max_bits);
+            resp += "\r\n";
+        }
+    }
+#else
+    (void)wantDeflate;
+#endif
+    resp += "\r\n";
+
+    if (!ws_write(ws, resp.data(), resp.size())) {
+        ws->sock = WS_INVALID_SOCKET;
+        ws_free(ws);
+        return moon_null();
+    }
+    int one = 1;
+    setsockopt(ws->sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&one, sizeof(one));
+    return moon_int((int64_t)(uintptr_t)ws);
+}
+
+// ws_connect(url[, options]) - client handshake to ws:// or wss://.
+// options: headers (dict), protocols (list), deflate, max_message.
+MoonValue* moon_ws_connect(MoonValue* url, MoonValue* options) {
+    if (!moon_is_string(url)) return moon_null();
+    const char* p = url->data.strVal;
+    bool secure = false;
+    if (strncasecmp(p, "wss://", 6) == 0) {
+        secure = true;
+        p += 6;
+    } else if (strncasecmp(p, "ws://", 5) == 0) {
+        p += 5;
+    } else {
+        return moon_null();
+    }
+
+    std::string host;
+    const char* hostEnd;
+    if (*p == '[') {
+        hostEnd = strchr(p, ']');
+        if (!hostEnd) return moon_null();
+        host.assign(p + 1, hostEnd - p - 1);
+        hostEnd++;
+    } else {
+        hostEnd = p + strcspn(p, ":/?#");
+        host.assign(p, hostEnd - p);
+    }
+    int port = secure ? 443 : 80;
+    const char* rest = hostEnd;
+    if (*rest == ':') {
+        port = atoi(rest + 1);
+        rest += 1 + strspn(rest + 1, "0123456789");
+    }
+    std::string hostHeader(p, rest - p);
+    std::string target(rest, strcspn(rest, "#"));
+    if (target.empty() || target[0] != '/') target.insert(0, "/");
+    if (host.empty() || port <= 0 || port > 65535) return moon_null();
+
+    // Connect
+    MOON_SOCKET sock;
+    void* tls = NULL;
+    if (secure) {
+        MoonValue* h = moon_string(host.c_str());
+        MoonValue* pt = moon_int(port);
+        MoonValue* conn = moon_tls_connect(h, pt);
+        moon_release(h);
+        moon_release(pt);
+        tls = (void*)(uintptr_t)moon_to_int(conn);
+        moon_release(conn);
+        if (!tls) return moon_null();
+        sock = (MOON_SOCKET)moon_tls_conn_fd(tls);
+    } else {
+        int64_t fd = moon_net_connect(host.c_str(), port, WS_HANDSHAKE_TIMEOUT_MS);
+        if (fd < 0) return moon_null();
+        sock = (MOON_SOCKET)fd;
+    }
+    int one = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&one, sizeof(one));
+
+    MoonWs* ws = ws_new(sock, tls, true);
+    if (!ws) {
+        if (tls) {
+            MoonValue* conn = moon_int((int64_t)(uintptr_t)tls);
+            moon_tls_close(conn);
+            moon_release(conn);
+        } else {
+            ws_closesocket(sock);
+        }
+        return moon_null();
+    }
+    bool wantDeflate;
+    ws_read_options(ws, options, &wantDeflate);
+    *ws->path = target;
+
+    unsigned char nonce[16];
+    ws_random(nonce, sizeof(nonce));
+    std::string key = ws_base64(nonce, sizeof(nonce));
+
+    std::string req = "GET " + target + " HTTP/1.1\r\nHost: " + hostHeader +
+                      "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Key: " + key +
+                      "\r\nSec-WebSocket-Version: 13\r\n";
+#ifdef WS_HAS_ZLIB
+    if (wantDeflate && moon_zlib()) {
+        req += "Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits\r\n";
+    }
+#endif
+    if (options && options->type == MOON_DICT) {
+        MoonValue* k = moon_string("protocols");
+        MoonValue* protos = moon_dict_get(options, k, moon_null());
+        moon_release(k);
+        if (moon_is_list(protos) && protos->data.listVal->length > 0) {
+            req += "Sec-WebSocket-Protocol: ";
+            MoonList* pl = protos->data.listVal;
+            for (int i = 0; i < pl->length; i++) {
+                char* s = moon_to_string(pl->items[i]);
+                req += (i ? ", " : "");
+                req += s;
+                moon_free(s, 0);
+            }
+            req += "\r\n";
+        }
+        moon_release(protos);
+
+        k = moon_string("headers");
+        MoonValue* headers = moon_dict_get(options, k, moon_null());
+        moon_release(k);
+        if (headers->type == MOON_DICT) {
+            MoonValue* keys = moon_dict_keys(headers);
+            MoonList* kl = keys->data.listVal;
+            for (int i = 0; i < kl->length; i++) {
+                MoonValue* v = moon_dict_get(headers, kl->items[i], moon_null());
+                char* ks = moon_to_string(kl->items[i]);
+                char* vs = moon_to_string(v);
+                req += std::string(ks) + ": " + vs + "\r\n";
+                moon_free(ks, 0);
+                moon_free(vs, 0);
+                moon_release(v);
+            }
+            moon_release(keys);
+        }
+        moon_release(headers);
+    }
+    req += "\r\n";
+
+    size_t headLen = 0;
+    if (ws_write(ws, req.data(), req.size())) headLen = ws_read_head(ws);
+    if (headLen == 0) {
+        ws_free(ws);
+        return moon_null();
+    }
+
+    std::string accept, upgrade, extensions, protocol;
+    std::string first = ws_parse_head(ws->in, headLen, [&](const std::string& n, const std::string& v) {
+        if (n == "sec-websocket-accept") accept = v;
+        else if (n == "upgrade") upgrade = v;
+        else if (n == "sec-websocket-extensions") extensions = v;
+        else if (n == "sec-websocket-protocol") protocol = v;
+    });
+    ws->in_start = headLen;
+
+    if (first.compare(0, 12, "HTTP/1.1 101") != 0 || accept != ws_accept_key(key) ||
+        !ws_has_token(upgrade, "websocket")) {
+        ws_free(ws);
+        return moon_null();
+    }
+    *ws->protocol = protocol;
+
+    WsDeflateParams d = ws_parse_deflate(extensions);
+    if (d.present) {
+#ifdef WS_HAS_ZLIB
+        if (!moon_zlib() || (d.client_max_bits > 0 && d.client_max_bits < 9)) {
+            ws_free(ws);    // Server accepted something we cannot honour
+            return moon_null();
+        }
+        ws->deflate = true;
+        ws->tx_no_context = d.client_no_context;
+        if (d.client_max_bits > 0) ws->tx_window_bits = d.client_max_bits;
+#else
+        ws_free(ws);
+        return moon_null();
+#endif
+    }
+    return moon_int((int64_t)(uintptr_t)ws);
+}
+
+// ws_recv(ws[, timeout_ms]) - next text or binary message. Pings are
+// answered automatically. Returns null when the connection closes (see
+// ws_info for the close code) or when timeout_ms passes first.
+MoonValue* moon_ws_recv(MoonValue* wsVal, MoonValue* timeout) {
+    MoonWs* ws = ws_get(wsVal);
+    if (!ws) return moon_null();
+    int64_t deadline = -1;
+    if (timeout && timeout->type != MOON_NULL && moon_to_int(timeout) >= 0) {
+        deadline = ws_now_ms() + moon_to_int(timeout);
+    }
+
+    for (;;) {
+        int r = ws_process(ws);
+        if (r < 0) return moon_null();
+        if (r > 0) {
+            char* data = ws->msg;
+            size_t len = ws->msg_len;
+            bool compressed = ws->msg_compressed;
+            ws->last_binary = ws->msg_op == WS_OP_BINARY;
+            ws->msg = NULL;
+            ws->msg_cap = 0;
+            ws->msg_len = 0;
+            ws->msg_op = 0;
+            ws->messages_in++;
+
+            if (!compressed) return moon_str_finish(data, len);
+#ifdef WS_HAS_ZLIB
+            MoonValue* out = ws_decompress(ws, data, len);
+            moon_release(moon_str_finish(data, 0));
+            if (out) return out;
+#else
+            moon_release(moon_str_finish(data, 0));
+#endif
+            ws_fail(ws, 1007);
+            return moon_null();
+        }
+
+        if (!ws_wait(ws, deadline)) return moon_null();
+        if (ws_fill(ws) <= 0) {
+            ws->closed = true;
+            if (!ws->close_code) ws->close_code = 1006;     // Closed without a close frame
+            return moon_null();
+        }
+    }
+}
+
+// ws_send(ws, data[, binary]) - send one text (default) or binary message
+MoonValue* moon_ws_send(MoonValue* wsVal, MoonValue* data, MoonValue* binary) {
+    MoonWs* ws = ws_get(wsVal);
+    if (!ws || ws->closed) return moon_bool(false);
+    size_t len;
+    char* toFree = NULL;
+    const char* p = moon_bytes_view(data, &len);
+    if (!p) {
+        toFree = moon_to_string(data);
+        p = toFree;
+        len = strlen(p);
+    }
+    bool ok = ws_send_message(ws, moon_to_bool(binary) ? WS_OP_BINARY : WS_OP_TEXT, p, len);
+    moon_free(toFree, 0);
+    return moon_bool(ok);
+}
+
+// ws_ping(ws[, data]) - send a ping (payload up to 125 bytes)
+MoonValue* moon_ws_ping(MoonValue* wsVal, MoonValue* data) {
+    MoonWs* ws = ws_get(wsVal);
+    if (!ws || ws->closed) return moon_bool(false);
+    const char* p = moon_is_string(data) ? data->data.strVal : "";
+    size_t len = strlen(p);
+    if (len > 125) len = 125;
+    return moon_bool(ws_send_frame(ws, WS_OP_PING, p, len, false));
+}
+
+// ws_broadcast(list, data[, binary]) - send one message to many
+// connections. The frame is encoded once (uncompressed, unmasked) and the
+// same bytes are written to every server-side connection. Returns the
+// number of connections it was delivered to.
+MoonValue* moon_ws_broadcast(MoonValue* conns, MoonValue* data, MoonValue* binary) {
+    if (!moon_is_list(conns)) return moon_int(0);
+    size_t len;
+    char* toFree = NULL;
+    const char* p;
+    if (moon_is_string(data)) {
+        MoonStrHeader* h = moon_str_get_header(data->data.strVal);
+        p = data->data.strVal;
+        len = h ? h->length : strlen(p);
+    } else {
+        toFree = moon_to_string(data);
+        p = toFree;
+        len = strlen(p);
+    }
+    int opcode = moon_to_bool(binary) ? WS_OP_BINARY : WS_OP_TEXT;
+
+    unsigned char h[14];
+    size_t hlen = ws_frame_header(h, opcode, false, len, NULL);
+    char* frame = (char*)malloc(hlen + len);
+    int64_t delivered = 0;
+    if (frame) {
+        memcpy(frame, h, hlen);
+        memcpy(frame + hlen, p, len);
+        MoonList* list = conns->data.listVal;
+        for (int i = 0; i < list->length; i++) {
+            MoonWs* ws = ws_get(list->items[i]);
+            if (!ws || ws->closed) continue;
+            bool ok;
+            if (ws->client) {
+                ok = ws_send_frame(ws, opcode, p, len, false);     // Needs its own mask
+            } else {
+                ws_lock(ws);
+                ok = !ws->close_sent && ws_write(ws, frame, hlen + len);
+                ws_unlock(ws);
+            }
+            if (ok) {
+                ws->messages_out++;
+                delivered++;
+            }
+        }
+        free(frame);
+    }
+    moon_free(toFree, 0);
+    return moon_int(delivered);
+}
+
+// ws_close(ws[, code[, reason]]) - send a close frame (default 1000) and
+// release the connection
+void moon_ws_close(MoonValue* wsVal, MoonValue* code, MoonValue* reason) {
+    MoonWs* ws = ws_get(wsVal);
+    if (!ws) return;
+    if (!ws->close_sent) {
+        int c = (code && code->type != MOON_NULL) ? (int)moon_to_int(code) : 1000;
+        char payload[125];
+        payload[0] = (char)(c >> 8);
+        payload[1] = (char)c;
+        size_t len = 2;
+        if (moon_is_string(reason)) {
+            size_t rlen = strlen(reason->data.strVal);
+            if (rlen > 123) rlen = 123;
+            memcpy(payload + 2, reason->data.strVal, rlen);
+            len += rlen;
+        }
+        ws_send_frame(ws, WS_OP_CLOSE, payload, len, false);
+    }
+    ws_free(ws);
+}
+
+// ws_info(ws) - {closed, close_code, close_reason, binary (last message),
+// deflate, protocol, path, messages_in, messages_out}
+MoonValue* moon_ws_info(MoonValue* wsVal) {
+    MoonWs* ws = ws_get(wsVal);
+    MoonValue* d = moon_dict_new();
+    if (!ws) return d;
+    struct { const char* k; MoonValue* v; } items[] = {
+        { "closed", moon_bool(ws->closed) },
+        { "close_code", moon_int(ws->close_code) },
+        { "close_reason", moon_string(ws->close_reason->c_str()) },
+        { "binary", moon_bool(ws->last_binary) },
+        { "deflate", moon_bool(ws->deflate) },
+        { "protocol", moon_string(ws->protocol->c_str()) },
+        { "path", moon_string(ws->path->c_str()) },
+        { "messages_in", moon_int(ws->messages_in) },
+        { "messages_out", moon_int(ws->messages_out) },
+    };
+    for (auto& it : items) {
+        MoonValue* k = moon_string(it.k);
+        moon_dict_set(d, k, it.v);
+        moon_release(k);
+        moon_release(it.v);
+    }
+    return d;
+}
+
+#else // !MOON_HAS_NETWORK
+
+MoonValue* moon_ws_upgrade(MoonValue* socket, MoonValue* options) { return moon_null(); }
+MoonValue* moon_ws_connect(MoonValue* url, MoonValue* options) { return moon_null(); }
+MoonValue* moon_ws_recv(MoonValue* ws, MoonValue* timeout) { return moon_null(); }
+MoonValue* moon_ws_send(MoonValue* ws, MoonValue* data, MoonValue* binary) { return moon_bool(false); }
+MoonValue* moon_ws_ping(MoonValue* ws, MoonValue* data) { return moon_bool(false); }
+MoonValue* moon_ws_broadcast(MoonValue* conns, MoonValue* data, MoonValue* binary) { return moon_int(0); }
+void moon_ws_close(MoonValue* ws, MoonValue* code, MoonValue* reason) { }
+MoonValue* moon_ws_info(MoonValue* ws) { return moon_dict_new(); }
+
+#endif // MOON_HAS_NETWORK
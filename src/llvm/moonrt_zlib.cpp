@@ -0,0 +1,45 @@
+// MoonLang Runtime - zlib Loader
+// Copyright (c) 2026 greenteng.com
+//
+// Resolves zlib at run time so compression support (HTTP content coding,
+// WebSocket permessage-deflate) adds no link dependency. Callers include
+// <zlib.h> for z_stream and the constants when it is available.
+
+#include "moonrt_core.h"
+
+static MoonZlib zlib_load(void) {
+    MoonZlib z;
+    memset(&z, 0, sizeof(z));
+
+#if defined(_WIN32)
+    const char* names[] = { "zlib1.dll", "zlib.dll", NULL };
+#elif defined(__APPLE__)
+    const char* names[] = { "libz.1.dylib", "libz.dylib", NULL };
+#else
+    const char* names[] = { "libz.so.1", "libz.so", NULL };
+#endif
+    MOON_DLL_HANDLE lib = NULL;
+    for (int i = 0; names[i] && !lib; i++) lib = moon_platform_dll_open(names[i]);
+    if (!lib) return z;
+
+    z.inflateInit2_ = (int (*)(void*, int, const char*, int))moon_platform_dll_symbol(lib, "inflateInit2_");
+    z.inflate = (int (*)(void*, int))moon_platform_dll_symbol(lib, "inflate");
+    z.inflateReset = (int (*)(void*))moon_platform_dll_symbol(lib, "inflateReset");
+    z.inflateEnd = (int (*)(void*))moon_platform_dll_symbol(lib, "inflateEnd");
+    z.deflateInit2_ = (int (*)(void*, int, int, int, int, int, const char*, int))
+        moon_platform_dll_symbol(lib, "deflateInit2_");
+    z.deflate = (int (*)(void*, int))moon_platform_dll_symbol(lib, "deflate");
+    z.deflateReset = (int (*)(void*))moon_platform_dll_symbol(lib, "deflateReset");
+    z.deflateEnd = (int (*)(void*))moon_platform_dll_symbol(lib, "deflateEnd");
+
+    if (!z.inflateInit2_ || !z.inflate || !z.inflateReset || !z.inflateEnd ||
+        !z.deflateInit2_ || !z.deflate || !z.deflateReset || !z.deflateEnd) {
+        memset(&z, 0, sizeof(z));
+    }
+    return z;
+}
+
+const MoonZlib* moon_zlib(void) {
+    static MoonZlib z = zlib_load();    // Loaded once, thread-safe
+    return z.inflate ? &z : NULL;
+}